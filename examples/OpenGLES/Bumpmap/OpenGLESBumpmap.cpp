@@ -73,6 +73,9 @@ class OpenGLESBumpmap : public pvr::Shell
 		// UIRenderer used to display text
 		pvr::ui::UIRenderer uiRenderer;
 
+		// Captures the frames requested on the command line, created on first use
+		std::unique_ptr<pvr::utils::FrameCapture> frameCapture;
+
 		DeviceResources()
 		{
 			program = 0;
@@ -96,6 +99,7 @@ class OpenGLESBumpmap : public pvr::Shell
 			if (onScreenFbo) { gl::DeleteFramebuffers(1, &onScreenFbo); }
 
 			uiRenderer.release();
+			frameCapture.reset(); // Needs the context to delete its buffers
 			context.reset();
 		}
 	};
@@ -296,7 +300,16 @@ pvr::Result OpenGLESBumpmap::renderFrame()
 	_deviceResources->uiRenderer.getSdkLogo()->render();
 	_deviceResources->uiRenderer.endRendering();
 
-	if (this->shouldTakeScreenshot()) { pvr::utils::takeScreenshot(this->getScreenshotFileName(), this->getWidth(), this->getHeight()); }
+	// The capture is read back asynchronously and written in the background, so capturing a range of frames does not stall the render thread.
+	if (this->shouldTakeScreenshot())
+	{
+		if (!_deviceResources->frameCapture)
+		{
+			_deviceResources->frameCapture = std::make_unique<pvr::utils::FrameCapture>(this->getWidth(), this->getHeight(),
+				_deviceResources->context->getApiVersion() == pvr::Api::OpenGLES2, getBackBufferColorspace(), pvr::CaptureFileFormat::TGA, getCaptureFrameScale());
+		}
+		_deviceResources->frameCapture->capture(this->getScreenshotFileName());
+	}
 
 	_deviceResources->context->swapBuffers();
 
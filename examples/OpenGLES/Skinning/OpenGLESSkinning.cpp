@@ -343,6 +343,8 @@ pvr::Result OpenGLESSkinning::renderFrame()
 	}
 
 	animInst.updateAnimation(_currentFrame);
+	// Compute the world matrices of the animated nodes once, so that the bone matrices do not each walk the hierarchy.
+	_scene->updateWorldMatrices();
 	// Setting up the "view projection" matrix only once - it doesn't change with the object
 	// Technically the camera projection stats COULD be animated, but we don't check for that
 	// and we assume the camera projection parameters are static - hence we set it up just once,
@@ -74,6 +74,9 @@ class VulkanBumpmap : public pvr::Shell
 		// UIRenderer used to display text
 		pvr::ui::UIRenderer uiRenderer;
 
+		// Captures the frames requested on the command line, created on first use
+		std::unique_ptr<pvr::utils::FrameCapture> frameCapture;
+
 		~DeviceResources()
 		{
 			if (device) { device->waitIdle(); }
@@ -529,10 +532,17 @@ pvr::Result VulkanBumpmap::renderFrame()
 
 	pvr::utils::endQueueDebugLabel(_deviceResources->queue);
 
-	if (this->shouldTakeScreenshot())
+	// The capture is submitted after the frame and the present waits for it, so capturing a range of frames does not stall the render thread.
+	const pvrvk::Semaphore* presentWaitSemaphore = &_deviceResources->presentationSemaphores[_frameId];
+	if (this->shouldTakeScreenshot() && _deviceResources->swapchain->supportsUsage(pvrvk::ImageUsageFlags::e_TRANSFER_SRC_BIT))
 	{
-		pvr::utils::takeScreenshot(_deviceResources->queue, _deviceResources->commandPool, _deviceResources->swapchain, swapchainIndex, this->getScreenshotFileName(),
-			_deviceResources->vmaAllocator, _deviceResources->vmaAllocator);
+		if (!_deviceResources->frameCapture)
+		{
+			_deviceResources->frameCapture = std::make_unique<pvr::utils::FrameCapture>(_deviceResources->device, _deviceResources->swapchain, _deviceResources->commandPool,
+				_deviceResources->vmaAllocator, _deviceResources->vmaAllocator, pvr::CaptureFileFormat::TGA, getCaptureFrameScale());
+		}
+		presentWaitSemaphore =
+			&_deviceResources->frameCapture->capture(_deviceResources->queue, swapchainIndex, this->getScreenshotFileName(), _deviceResources->presentationSemaphores[_frameId]);
 	}
 
 	//---------------
@@ -542,7 +552,7 @@ pvr::Result VulkanBumpmap::renderFrame()
 	pvrvk::PresentInfo presentInfo;
 	presentInfo.swapchains = &_deviceResources->swapchain;
 	presentInfo.numSwapchains = 1;
-	presentInfo.waitSemaphores = &_deviceResources->presentationSemaphores[_frameId];
+	presentInfo.waitSemaphores = presentWaitSemaphore;
 	presentInfo.numWaitSemaphores = 1;
 	presentInfo.imageIndices = &swapchainIndex;
 	_deviceResources->queue->present(presentInfo);
@@ -320,6 +320,8 @@ pvr::Result VulkanSkinning::renderFrame()
 		}
 	}
 	_scene->getAnimationInstance(0).updateAnimation(_currentFrame);
+	// Compute the world matrices of the animated nodes once, so that the bone matrices read by the render manager do not walk the hierarchy.
+	_scene->updateWorldMatrices();
 
 	// Set the _scene animation to the current frame
 	_deviceResources->mgr.updateAutomaticSemantics(swapchainIndex);
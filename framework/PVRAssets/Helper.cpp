@@ -8,6 +8,7 @@
 //!\cond NO_DOXYGEN
 
 #include "PVRAssets/Helper.h"
+#include "PVRAssets/fileio/BakedModelReader.h"
 #include "PVRAssets/fileio/PODReader.h"
 #include "PVRAssets/fileio/GltfReader.h"
 namespace pvr {
@@ -168,7 +169,8 @@ pvr::assets::ModelFileFormat getModelFormatFromFilename(const std::string& model
 		std::string s = file.substr(period + 1);
 		std::transform(s.begin(), s.end(), s.begin(), [](char c) { return static_cast<char>(tolower(c)); });
 		if (!s.compare("pod")) { return pvr::assets::ModelFileFormat::POD; }
-		if (!s.compare("gltf")) { return pvr::assets::ModelFileFormat::GLTF; }
+		if (!s.compare("gltf") || !s.compare("glb")) { return pvr::assets::ModelFileFormat::GLTF; }
+		if (!s.compare("pvrmodel")) { return pvr::assets::ModelFileFormat::BAKED; }
 	}
 	return pvr::assets::ModelFileFormat::UNKNOWN;
 }
@@ -206,10 +208,28 @@ ModelHandle loadModel(const IAssetProvider& app, const std::string& modelFile)
 	{
 	case pvr::assets::ModelFileFormat::POD: pvr::assets::readPOD(*assetStream, *handle); return handle;
 	case pvr::assets::ModelFileFormat::GLTF: pvr::assets::readGLTF(*assetStream, app, *handle); return handle;
+	case pvr::assets::ModelFileFormat::BAKED: pvr::assets::readBakedModel(*assetStream, *handle); return handle;
 	default: throw InvalidArgumentError("type", "Unknown model file format passed");
 	}
 }
 
+std::shared_ptr<const Model> loadModel(const IAssetProvider& app, const std::string& modelFile, AssetCache& cache)
+{
+	return cache.getOrLoad<Model>(
+		app, modelFile, [&]() { return loadModel(app, modelFile); },
+		[](const Model& model) {
+			// Only the vertex and index data are accounted for: they dominate the size of any model worth caching.
+			size_t size = sizeof(Model);
+			for (uint32_t i = 0; i < model.getNumMeshes(); ++i)
+			{
+				const Mesh& mesh = model.getMesh(i);
+				for (uint32_t j = 0; j < mesh.getNumDataElements(); ++j) { size += mesh.getDataSize(j); }
+				size += mesh.getFaces().getDataSize();
+			}
+			return size;
+		});
+}
+
 ModelHandle loadModel(const IAssetProvider& app, const pvr::Stream& modelFile)
 {
 	pvr::assets::ModelFileFormat sceneFormat = pvr::assets::helper::getModelFormatFromFilename(modelFile.getFileName());
@@ -219,6 +239,7 @@ ModelHandle loadModel(const IAssetProvider& app, const pvr::Stream& modelFile)
 	{
 	case pvr::assets::ModelFileFormat::POD: pvr::assets::readPOD(modelFile, *handle); return handle;
 	case pvr::assets::ModelFileFormat::GLTF: pvr::assets::readGLTF(modelFile, app, *handle); return handle;
+	case pvr::assets::ModelFileFormat::BAKED: pvr::assets::readBakedModel(modelFile, *handle); return handle;
 	default: throw InvalidArgumentError("type", "Unknown model file format passed");
 	}
 }
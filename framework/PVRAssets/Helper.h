@@ -9,6 +9,7 @@
 #include "PVRAssets/model/Mesh.h"
 #include "PVRAssets/Model.h"
 #include "PVRCore/IAssetProvider.h"
+#include "PVRCore/AssetCache.h"
 
 namespace pvr {
 namespace assets {
@@ -47,5 +48,15 @@ pvr::assets::ModelHandle loadModel(const IAssetProvider& app, const std::string&
 /// <param name="modelFile"></param>
 /// <returns>Returns a successfully created pvr::assets::ModelHandle object otherwise will throw</returns>
 pvr::assets::ModelHandle loadModel(const IAssetProvider& app, const pvr::Stream& model);
+
+/// <summary>Load a model file through an asset cache: if the model has already been loaded from the same file (and the file has not been modified
+/// since), the cached model is returned instead of loading it again. Models returned by this function are shared by every user of the cache and are
+/// therefore immutable. A user that needs per-instance state (for example the current animation frame or the world matrices) must copy the model,
+/// e.g. std::make_shared<Model>(*cachedModel), which is still cheaper than reading and parsing the file again.</summary>
+/// <param name="app">An asset provider used to find and load the model file</param>
+/// <param name="modelFile">The name of the model file</param>
+/// <param name="cache">The asset cache</param>
+/// <returns>Returns the model, shared with the cache, otherwise will throw</returns>
+std::shared_ptr<const Model> loadModel(const IAssetProvider& app, const std::string& modelFile, AssetCache& cache);
 } // namespace assets
 } // namespace pvr
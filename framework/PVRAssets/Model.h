@@ -47,6 +47,7 @@ enum class ModelFileFormat
 	UNKNOWN = 0,
 	POD,
 	GLTF,
+	BAKED, //!< Baked model (.pvrmodel), see writeBakedModel
 };
 
 /// <summary>The Model class represents an entire Scene, or Model. It is mainly a Node structure, allowing various
@@ -103,6 +104,8 @@ public:
 
 			bool hasAnimation; //!< Has animation data
 
+			uint32_t transformVersion; //!< Incremented whenever the transformation of the node changes (see Node::setTransformDirty)
+
 			/// <summary>Get current frame scale animation</summary>
 			/// <returns>Returns scale</returns>
 			glm::vec3& getFrameScaleAnimation() { return *(glm::vec3*)frameTransform; }
@@ -153,10 +156,11 @@ public:
 
 			/// <summary>Default constructor</summary>
 			InternalData()
-				: objectIndex(static_cast<uint32_t>(-1)), materialIndex(static_cast<uint32_t>(-1)), parentIndex(static_cast<uint32_t>(-1)), scale(1.0f), translation(0.0f)
+				: objectIndex(static_cast<uint32_t>(-1)), materialIndex(static_cast<uint32_t>(-1)), parentIndex(static_cast<uint32_t>(-1)), scale(1.0f), translation(0.0f), skin(-1)
 			{
 				transformFlags = TransformFlags::Identity;
 				hasAnimation = false;
+				transformVersion = 0;
 
 				getFrameScaleAnimation() = scale;
 				getFrameRotationAnimation() = glm::quat();
@@ -205,7 +209,16 @@ public:
 
 		/// <summary>Set the parent of this node.</summary>
 		/// <param name="parentID">the ID of this node's parent</param>
-		void setParentID(uint32_t parentID) { _data.parentIndex = parentID; }
+		void setParentID(uint32_t parentID)
+		{
+			_data.parentIndex = parentID;
+			setTransformDirty();
+		}
+
+		/// <summary>Mark the transformation of this node as modified, so that the world matrices the Model caches for this node and its descendants
+		/// are recomputed. Required after modifying the transformation through getInternalData, once Model::updateWorldMatrices has been called:
+		/// the cached matrices are stale until then. AnimationInstance::updateAnimation and setParentID call it automatically.</summary>
+		void setTransformDirty() { ++_data.transformVersion; }
 
 		/// <summary>Set the user data of this node. A bit copy of the data will be made.</summary>
 		/// <param name="size">The size, in bytes, of the data</param>
@@ -903,10 +916,24 @@ public:
 	};
 
 private:
-	std::vector<float> cachedFrame; //!< Cache indicating the frames at which the matrix cache was filled
-	std::vector<glm::mat4x4> worldMatrixFrameN; //!< Cache of world matrices for the frame described in fCachedFrame
-	std::vector<glm::mat4x4> worldMatrixFrameZero; //!< Cache of frame 0 matrices
+	/// <summary>The world matrices of the nodes, as of the last call to updateWorldMatrices.</summary>
+	struct WorldMatrixCache
+	{
+		std::vector<glm::mat4x4> matrices; //!< The world matrix of each node
+		std::vector<uint32_t> order; //!< The node indices, sorted so that every node comes after its parent
+		std::vector<uint32_t> parents; //!< The parent of each node when the order was computed
+		std::vector<uint32_t> versions; //!< The transform version of each node when its matrix was computed
+		std::vector<uint8_t> updated; //!< Set for the nodes whose matrix was recomputed by the last update
+	};
+
+	WorldMatrixCache _worldMatrixCache; //!< Only written by updateWorldMatrices, so that the const getters can be called concurrently
 	InternalData _data; //!< A set of internal data relating to the model
+
+	/// <summary>Check if the cached world matrix of a node is current, i.e. neither the node nor its parents changed since it was computed.</summary>
+	/// <param name="nodeId">The node to check</param>
+	/// <returns>True if the cached world matrix of the node can be used</returns>
+	bool isWorldMatrixCached(uint32_t nodeId) const;
+
 public:
 	/// <summary>Return the value of a Model-wide semantic as a FreeValue, null if it does not exist.</summary>
 	/// <param name="semantic">The semantic name to retrieve</param>
@@ -997,14 +1024,31 @@ public:
 		return _data.animationInstances.size() - 1;
 	}
 
-	/// <summary>Return the model-to-world matrix of a node. Corresponds to the Model's current frame of animation. This
-	/// version will store a copy of the matrix in an internal cache so that repeated calls for it will use the cached
-	/// copy of it. Will also store the cached versions of all parents of this node, or use cached versions of them if
-	/// they exist. Use this if you have long hierarchies and/or repeated calls per frame.</summary>
+	/// <summary>Compute and cache the model-to-world matrices of all nodes for the Model's current frame of animation, parents before children. Only
+	/// the nodes changed since the last call (e.g. by AnimationInstance::updateAnimation, see Node::setTransformDirty) and their descendants are
+	/// recomputed. Call it once per frame, after updating the animation and before reading the world matrices. The cache is opt-in: no loader calls
+	/// this function, and getWorldMatrix does not use a cache until it has been called.</summary>
+	/// <remarks>This is the only function writing the cache: it must not run concurrently with the getters of the world matrices of this Model, which
+	/// can otherwise be called from any number of threads.
+	///
+	/// Once this function has been called, the cache only sees transformations changed by AnimationInstance::updateAnimation or
+	/// Node::setParentID. Code modifying the transformation of a node through Node::getInternalData must then call Node::setTransformDirty,
+	/// otherwise getWorldMatrix keeps returning the matrix cached before the modification.</remarks>
+	void updateWorldMatrices();
+
+	/// <summary>Return the model-to-world matrix of a node. Corresponds to the Model's current frame of animation. Returns the matrix cached by
+	/// updateWorldMatrices if neither the node nor its parents were marked as changed since (see Node::setTransformDirty), otherwise computes it as
+	/// getWorldMatrixNoCache does. Never writes the cache, so it can be called concurrently. If updateWorldMatrices has never been called, it is
+	/// always computed, as getWorldMatrixNoCache does; otherwise see the remarks of updateWorldMatrices about nodes modified directly.</summary>
 	/// <param name="nodeId">The node for which to return the world matrix.</param>
 	/// <returns>Return The world matrix of (nodeId).</returns>
 	glm::mat4x4 getWorldMatrix(uint32_t nodeId) const;
 
+	/// <summary>Return the model-to-world matrices of all nodes, as computed by the last call to updateWorldMatrices. Unlike getWorldMatrix, does
+	/// not check whether the nodes changed since.</summary>
+	/// <returns>A contiguous array of getNumNodes() world matrices, indexed by node id. Valid until the next call to updateWorldMatrices.</returns>
+	const glm::mat4x4* getWorldMatrices() const;
+
 	/// <summary>Return the model-to-world matrix of a node. Corresponds to the Model's current frame of animation. This
 	/// version will not use caching and will recalculate the matrix. Faster if the matrix is only used a few times.</summary>
 	/// <param name="nodeId">The node for which to return the world matrix</param>
@@ -1356,7 +1400,12 @@ public:
 	/// <summary>Get a reference to the internal data of this Model. Handle with care.</summary>
 	/// <returns>Return internal data</returns>
 	InternalData& getInternalData() { return _data; }
+
+	/// <summary>Get a const reference to the internal data of this Model.</summary>
+	/// <returns>Return internal data</returns>
+	const InternalData& getInternalData() const { return _data; }
 	CustomData& getFormattedUserData() { return _data.formattedUserData; }
+	const CustomData& getFormattedUserData() const { return _data.formattedUserData; }
 
 	/// <summary>Get the properties of a camera. This is additional info on the class (remarks or documentation).</summary>
 	/// <param name="cameraIdx">The index of the camera.</param>
@@ -8,6 +8,8 @@
 #include "PVRAssets/Model.h"
 #include "PVRAssets/fileio/PODReader.h"
 #include "PVRAssets/fileio/GltfReader.h"
+#include "PVRAssets/fileio/BakedModelReader.h"
+#include "PVRAssets/fileio/BakedModelWriter.h"
 #include "PVRAssets/BoundingBox.h"
 #include "PVRAssets/Geometry.h"
 #include "PVRAssets/Helper.h"
@@ -5,12 +5,22 @@
 \copyright Copyright (c) Imagination Technologies Limited.
 */
 //!\cond NO_DOXYGEN
+#include <algorithm>
 #include <cstring>
 
 #include "PVRAssets/ShadowVolume.h"
 #include "PVRAssets/Helper.h"
 
+#include "PVRCore/JobSystem.h"
 #include "PVRCore/Log.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PVR_SHADOW_VOLUME_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define PVR_SHADOW_VOLUME_NEON 1
+#include <arm_neon.h>
+#endif
 using std::pair;
 using std::map;
 
@@ -26,6 +36,102 @@ const static unsigned short c_linesHyperCube[64] = {
 
 const static glm::vec3 c_rect0(-1, -1, 1), c_rect1(-1, 1, 1), c_rect2(1, -1, 1), c_rect3(1, 1, 1);
 namespace pvr {
+namespace {
+// The minimum number of triangles worth a job when finding the silhouette on a job system. A projection waits for the workers three times, so a band
+// must amortize three hand-offs: at a few nanoseconds per triangle, 64K triangles take a few hundred microseconds. Smaller meshes run on the calling thread.
+const uint32_t MinTrianglesPerBand = 65536;
+
+// Finds which of the triangles [begin, end) are in the light. A triangle is in the light if the dot product of its normal with the light direction (for a
+// directional light) or with the vector from the light to the triangle (for a point light) is positive or zero. begin must be a multiple of 4, and the
+// triangles are classified in groups of 4, so the planes and isLit must be padded to a multiple of 4 triangles.
+void classifyTriangles(const float* normalX, const float* normalY, const float* normalZ, const float* pointX, const float* pointY, const float* pointZ, uint32_t begin,
+	uint32_t end, const glm::vec3& lightModel, bool isPointLight, uint8_t* isLit)
+{
+#if defined(PVR_SHADOW_VOLUME_SSE2)
+	const __m128 lightX = _mm_set1_ps(lightModel.x), lightY = _mm_set1_ps(lightModel.y), lightZ = _mm_set1_ps(lightModel.z);
+	const __m128 zero = _mm_setzero_ps();
+	for (uint32_t i = begin; i < end; i += 4)
+	{
+		const __m128 nx = _mm_loadu_ps(normalX + i), ny = _mm_loadu_ps(normalY + i), nz = _mm_loadu_ps(normalZ + i);
+		__m128 f;
+		if (isPointLight)
+		{
+			const __m128 vx = _mm_sub_ps(_mm_loadu_ps(pointX + i), lightX);
+			const __m128 vy = _mm_sub_ps(_mm_loadu_ps(pointY + i), lightY);
+			const __m128 vz = _mm_sub_ps(_mm_loadu_ps(pointZ + i), lightZ);
+			f = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, vx), _mm_mul_ps(ny, vy)), _mm_mul_ps(nz, vz));
+		}
+		else
+		{
+			f = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, lightX), _mm_mul_ps(ny, lightY)), _mm_mul_ps(nz, lightZ));
+		}
+		const int mask = _mm_movemask_ps(_mm_cmpge_ps(f, zero));
+		isLit[i + 0] = static_cast<uint8_t>(mask & 1);
+		isLit[i + 1] = static_cast<uint8_t>((mask >> 1) & 1);
+		isLit[i + 2] = static_cast<uint8_t>((mask >> 2) & 1);
+		isLit[i + 3] = static_cast<uint8_t>((mask >> 3) & 1);
+	}
+#elif defined(PVR_SHADOW_VOLUME_NEON)
+	const float32x4_t lightX = vdupq_n_f32(lightModel.x), lightY = vdupq_n_f32(lightModel.y), lightZ = vdupq_n_f32(lightModel.z);
+	const float32x4_t zero = vdupq_n_f32(0.f);
+	for (uint32_t i = begin; i < end; i += 4)
+	{
+		const float32x4_t nx = vld1q_f32(normalX + i), ny = vld1q_f32(normalY + i), nz = vld1q_f32(normalZ + i);
+		float32x4_t f;
+		if (isPointLight)
+		{
+			const float32x4_t vx = vsubq_f32(vld1q_f32(pointX + i), lightX);
+			const float32x4_t vy = vsubq_f32(vld1q_f32(pointY + i), lightY);
+			const float32x4_t vz = vsubq_f32(vld1q_f32(pointZ + i), lightZ);
+			f = vaddq_f32(vaddq_f32(vmulq_f32(nx, vx), vmulq_f32(ny, vy)), vmulq_f32(nz, vz));
+		}
+		else
+		{
+			f = vaddq_f32(vaddq_f32(vmulq_f32(nx, lightX), vmulq_f32(ny, lightY)), vmulq_f32(nz, lightZ));
+		}
+		uint32_t mask[4];
+		vst1q_u32(mask, vcgeq_f32(f, zero));
+		isLit[i + 0] = static_cast<uint8_t>(mask[0] & 1);
+		isLit[i + 1] = static_cast<uint8_t>(mask[1] & 1);
+		isLit[i + 2] = static_cast<uint8_t>(mask[2] & 1);
+		isLit[i + 3] = static_cast<uint8_t>(mask[3] & 1);
+	}
+#else
+	for (uint32_t i = begin; i < end; ++i)
+	{
+		float f;
+		if (isPointLight) { f = normalX[i] * (pointX[i] - lightModel.x) + normalY[i] * (pointY[i] - lightModel.y) + normalZ[i] * (pointZ[i] - lightModel.z); }
+		else
+		{
+			f = normalX[i] * lightModel.x + normalY[i] * lightModel.y + normalZ[i] * lightModel.z;
+		}
+		isLit[i] = f >= 0 ? 1 : 0;
+	}
+#endif
+}
+
+// Gets the visibility flags an edge gets from one of its triangles, given as an element of Volume::_edgeTriangles: 0x01 if the triangle is in the light,
+// otherwise 0x02, with 0x04 set if the winding order needs reversing.
+inline uint32_t getVisibilityFlags(const uint8_t* isTriangleLit, uint32_t edgeTriangle) { return isTriangleLit[edgeTriangle >> 1] ? 0x01 : 0x02 | (edgeTriangle & 0x01) << 2; }
+
+// Calls func(band) for each band, in parallel if there is a job system. The bands must not write to overlapping memory.
+template<typename Func>
+void forEachBand(async::JobSystem* jobSystem, uint32_t numBands, const Func& func)
+{
+	if (jobSystem == nullptr || numBands <= 1)
+	{
+		for (uint32_t band = 0; band < numBands; ++band) { func(band); }
+		return;
+	}
+	jobSystem->parallelFor(
+		0, numBands,
+		[&func](uint32_t firstBand, uint32_t lastBand) {
+			for (uint32_t band = firstBand; band < lastBand; ++band) { func(band); }
+		},
+		1);
+}
+} // namespace
+
 ShadowVolume::~ShadowVolume()
 {
 	std::map<uint32_t, ShadowVolumeData>::iterator walk = _shadowVolumes.begin();
@@ -84,132 +190,158 @@ char* ShadowVolume::getIndices(uint32_t volumeID)
 	return found->second.indexData;
 }
 
-bool ShadowVolume::projectSilhouette(uint32_t volumeID, uint32_t flags, const glm::vec3& lightModel, bool isPointLight, char** externalIndexBuffer)
+bool ShadowVolume::projectSilhouette(
+	uint32_t volumeID, uint32_t flags, const glm::vec3& lightModel, bool isPointLight, char** externalIndexBuffer, async::JobSystem* jobSystem)
 {
-	if (_volumeMesh.needs32BitIndices) { return project<uint32_t>(volumeID, flags, lightModel, isPointLight, reinterpret_cast<uint32_t**>(externalIndexBuffer)); }
+	if (_volumeMesh.needs32BitIndices) { return project<uint32_t>(volumeID, flags, lightModel, isPointLight, reinterpret_cast<uint32_t**>(externalIndexBuffer), jobSystem); }
 	else
 	{
-		return project<uint16_t>(volumeID, flags, lightModel, isPointLight, reinterpret_cast<uint16_t**>(externalIndexBuffer));
+		return project<uint16_t>(volumeID, flags, lightModel, isPointLight, reinterpret_cast<uint16_t**>(externalIndexBuffer), jobSystem);
 	}
 }
 
 template<typename INDEXTYPE>
-bool ShadowVolume::project(uint32_t volumeID, uint32_t flags, const glm::vec3& lightModel, bool isPointLight, INDEXTYPE** externalIndexBuffer)
+bool ShadowVolume::project(uint32_t volumeID, uint32_t flags, const glm::vec3& lightModel, bool isPointLight, INDEXTYPE** externalIndexBuffer, async::JobSystem* jobSystem)
 {
 	ShadowVolumeMapType::iterator found = _shadowVolumes.find(volumeID);
 	assertion(found != _shadowVolumes.end());
 
-	if (found != _shadowVolumes.end()) { return false; }
+	if (found == _shadowVolumes.end()) { return false; }
 
 	ShadowVolumeData& volume = found->second;
 	INDEXTYPE* indices = externalIndexBuffer ? *externalIndexBuffer : reinterpret_cast<INDEXTYPE*>(volume.indexData);
 
 	if (indices == NULL) { return false; }
 
-	float f;
 	volume.numIndices = 0;
 
-	// Run through triangles, testing which face the From point
-	for (uint32_t i = 0; i < _volumeMesh.numTriangles; ++i)
-	{
-		VolumeEdge *edge0, *edge1, *edge2;
-		edge0 = &_volumeMesh.edges[_volumeMesh.triangles[i].edgeIndices[0]];
-		edge1 = &_volumeMesh.edges[_volumeMesh.triangles[i].edgeIndices[1]];
-		edge2 = &_volumeMesh.edges[_volumeMesh.triangles[i].edgeIndices[2]];
-
-		if (isPointLight)
-		{
-			glm::vec3 v;
-			v.x = _volumeMesh.vertices[edge0->vertexIndices[0]].x - lightModel.x;
-			v.y = _volumeMesh.vertices[edge0->vertexIndices[0]].y - lightModel.y;
-			v.z = _volumeMesh.vertices[edge0->vertexIndices[0]].z - lightModel.z;
+	/*
+	  The triangles and the edges are split into the same number of bands, each processed by one job: first the triangles of each band are tested against
+	  the light, then the edges of each band are tested for the silhouette, and finally each band writes its indices at an offset found from the numbers
+	  of indices of the bands before it. The indices are therefore the same, and in the same order, whatever the number of bands.
+	*/
+	const uint32_t numTriangles = _volumeMesh.numTriangles;
+	const uint32_t numEdges = _volumeMesh.numEdges;
+	uint32_t numBands = 1;
+	if (jobSystem != nullptr) { numBands = std::max(1u, std::min(jobSystem->getNumWorkers() + 1, numTriangles / MinTrianglesPerBand)); }
+	// Triangles are tested in groups of 4, so the bands of triangles start at a multiple of 4
+	const uint32_t trianglesPerBand = ((numTriangles + numBands - 1) / numBands + 3) & ~3u;
+	const uint32_t edgesPerBand = (numEdges + numBands - 1) / numBands;
+
+	_isTriangleLit.resize(_trianglePlanes.normalX.size());
+	_silhouetteEdges.resize(numEdges);
+	_bandIndexOffsets.assign(2 * numBands + 1, 0);
 
-			// Dot product
-			f = _volumeMesh.triangles[i].normal.x * v.x + _volumeMesh.triangles[i].normal.y * v.y + _volumeMesh.triangles[i].normal.z * v.z;
-		}
-		else
-		{
-			f = _volumeMesh.triangles[i].normal.x * lightModel.x + _volumeMesh.triangles[i].normal.y * lightModel.y + _volumeMesh.triangles[i].normal.z * lightModel.z;
-		}
+	// Run through triangles, testing which face the From point
+	forEachBand(jobSystem, numBands, [&](uint32_t band) {
+		const uint32_t begin = std::min(band * trianglesPerBand, numTriangles);
+		const uint32_t end = std::min(begin + trianglesPerBand, numTriangles);
+		classifyTriangles(_trianglePlanes.normalX.data(), _trianglePlanes.normalY.data(), _trianglePlanes.normalZ.data(), _trianglePlanes.pointX.data(),
+			_trianglePlanes.pointY.data(), _trianglePlanes.pointZ.data(), begin, end, lightModel, isPointLight, _isTriangleLit.data());
+
+		uint32_t numLit = 0;
+		for (uint32_t i = begin; i < end; ++i) { numLit += _isTriangleLit[i]; }
+		// The triangles in the light are added to the front cap, un-extruded, and the triangles in shade to the back cap, extruded.
+		_bandIndexOffsets[band + 1] = ((flags & Cap_front) ? 3 * numLit : 0) + ((flags & Cap_back) ? 3 * (end - begin - numLit) : 0);
+	});
 
-		if (f >= 0)
+	// Run through edges, testing which are silhouette edges
+	forEachBand(jobSystem, numBands, [&](uint32_t band) {
+		const uint32_t begin = std::min(band * edgesPerBand, numEdges);
+		const uint32_t end = std::min(begin + edgesPerBand, numEdges);
+		const uint32_t* edgeTriangleOffsets = _edgeTriangleOffsets.data();
+		const uint32_t* edgeTriangles = _edgeTriangles.data();
+		const uint8_t* isTriangleLit = _isTriangleLit.data();
+		uint32_t* silhouetteEdges = _silhouetteEdges.data() + begin;
+		uint32_t numSilhouetteEdges = 0;
+		for (uint32_t i = begin; i < end; ++i)
 		{
-			// Triangle is in the light
-			edge0->visibilityFlags |= 0x01;
-			edge1->visibilityFlags |= 0x01;
-			edge2->visibilityFlags |= 0x01;
-
-			if (flags & Cap_front)
+			uint32_t visibilityFlags;
+			if (_isClosed)
 			{
-				// Add the triangle to the volume, un-extruded.
-				indices[volume.numIndices++] = static_cast<INDEXTYPE>(_volumeMesh.triangles[i].vertexIndices[0]);
-				indices[volume.numIndices++] = static_cast<INDEXTYPE>(_volumeMesh.triangles[i].vertexIndices[1]);
-				indices[volume.numIndices++] = static_cast<INDEXTYPE>(_volumeMesh.triangles[i].vertexIndices[2]);
+				// Every edge of a closed volume has exactly two triangles
+				visibilityFlags = getVisibilityFlags(isTriangleLit, edgeTriangles[2 * i]) | getVisibilityFlags(isTriangleLit, edgeTriangles[2 * i + 1]);
 			}
-		}
-		else
-		{
-			// Triangle is in shade; set Bit3 if the winding order needs reversing
-			edge0->visibilityFlags |= 0x02 | (_volumeMesh.triangles[i].winding & 0x01) << 2;
-			edge1->visibilityFlags |= 0x02 | (_volumeMesh.triangles[i].winding & 0x02) << 1;
-			edge2->visibilityFlags |= 0x02 | (_volumeMesh.triangles[i].winding & 0x04);
-
-			if (flags & Cap_back)
+			else
 			{
-				// Add the triangle to the volume, extruded.
-				// numVertices is used as an offset so that the new index refers to the
-				// corresponding position in the second array of vertices (which are extruded)
-				indices[volume.numIndices++] = static_cast<INDEXTYPE>(_volumeMesh.triangles[i].vertexIndices[0] + _volumeMesh.numVertices);
-				indices[volume.numIndices++] = static_cast<INDEXTYPE>(_volumeMesh.triangles[i].vertexIndices[1] + _volumeMesh.numVertices);
-				indices[volume.numIndices++] = static_cast<INDEXTYPE>(_volumeMesh.triangles[i].vertexIndices[2] + _volumeMesh.numVertices);
+				visibilityFlags = 0;
+				for (uint32_t reference = edgeTriangleOffsets[i]; reference < edgeTriangleOffsets[i + 1]; ++reference)
+				{ visibilityFlags |= getVisibilityFlags(isTriangleLit, edgeTriangles[reference]); }
 			}
-		}
-	}
 
-#ifdef DEBUG // Sanity checks
-	assertion(volume.numIndices * sizeof(INDEXTYPE) <= getIndexDataSize()); // Have we accessed memory we shouldn't have?
+			/*
+			  The edge is both visible and hidden, so it is along the silhouette of the model (See header notes for more info)
+			*/
+			if ((visibilityFlags & 0x03) == 0x03) { silhouetteEdges[numSilhouetteEdges++] = i * 2 + ((visibilityFlags & 0x04) ? 0 : 1); }
+		}
+		_bandIndexOffsets[numBands + band + 1] = 6 * numSilhouetteEdges;
+	});
 
-	for (uint32_t i = 0; i < volume.numIndices; ++i) { assertion(indices[i] < _volumeMesh.numVertices * 2); }
-#endif
+	for (uint32_t band = 0; band < 2 * numBands; ++band) { _bandIndexOffsets[band + 1] += _bandIndexOffsets[band]; }
+	volume.numIndices = _bandIndexOffsets[2 * numBands];
 
-	// Run through edges, testing which are silhouette edges
-	for (uint32_t i = 0; i < _volumeMesh.numEdges; ++i)
+	// Have we got enough memory? The size of an external buffer is unknown.
+	assertion(externalIndexBuffer || volume.numIndices * sizeof(INDEXTYPE) <= getIndexDataSize());
+	if (!externalIndexBuffer && volume.numIndices * sizeof(INDEXTYPE) > getIndexDataSize())
 	{
-		if ((_volumeMesh.edges[i].visibilityFlags & 0x03) == 0x03)
+		volume.numIndices = 0;
+		return false;
+	}
+
+	forEachBand(jobSystem, 2 * numBands, [&](uint32_t band) {
+		if (_bandIndexOffsets[band] == _bandIndexOffsets[band + 1]) { return; }
+		INDEXTYPE* bandIndices = indices + _bandIndexOffsets[band];
+		if (band < numBands)
 		{
-			/*
-			  Silhouette edge found!
-			  The edge is both visible and hidden, so it is along the silhouette of the model (See header notes for more info)
-			*/
-			if (_volumeMesh.edges[i].visibilityFlags & 0x04)
+			const uint32_t begin = std::min(band * trianglesPerBand, numTriangles);
+			const uint32_t end = std::min(begin + trianglesPerBand, numTriangles);
+			for (uint32_t i = begin; i < end; ++i)
 			{
-				indices[volume.numIndices++] = static_cast<INDEXTYPE>(_volumeMesh.edges[i].vertexIndices[0]);
-				indices[volume.numIndices++] = static_cast<INDEXTYPE>(_volumeMesh.edges[i].vertexIndices[1]);
-				indices[volume.numIndices++] = static_cast<INDEXTYPE>(_volumeMesh.edges[i].vertexIndices[0] + _volumeMesh.numVertices);
-
-				indices[volume.numIndices++] = static_cast<INDEXTYPE>(_volumeMesh.edges[i].vertexIndices[0] + _volumeMesh.numVertices);
-				indices[volume.numIndices++] = static_cast<INDEXTYPE>(_volumeMesh.edges[i].vertexIndices[1]);
-				indices[volume.numIndices++] = static_cast<INDEXTYPE>(_volumeMesh.edges[i].vertexIndices[1] + _volumeMesh.numVertices);
+				const uint32_t* vertexIndices = _volumeMesh.triangles[i].vertexIndices;
+				if (_isTriangleLit[i])
+				{
+					if (flags & Cap_front)
+					{
+						// Add the triangle to the volume, un-extruded.
+						*bandIndices++ = static_cast<INDEXTYPE>(vertexIndices[0]);
+						*bandIndices++ = static_cast<INDEXTYPE>(vertexIndices[1]);
+						*bandIndices++ = static_cast<INDEXTYPE>(vertexIndices[2]);
+					}
+				}
+				else if (flags & Cap_back)
+				{
+					// Add the triangle to the volume, extruded.
+					// numVertices is used as an offset so that the new index refers to the
+					// corresponding position in the second array of vertices (which are extruded)
+					*bandIndices++ = static_cast<INDEXTYPE>(vertexIndices[0] + _volumeMesh.numVertices);
+					*bandIndices++ = static_cast<INDEXTYPE>(vertexIndices[1] + _volumeMesh.numVertices);
+					*bandIndices++ = static_cast<INDEXTYPE>(vertexIndices[2] + _volumeMesh.numVertices);
+				}
 			}
-			else
+		}
+		else
+		{
+			const uint32_t* silhouetteEdges = _silhouetteEdges.data() + std::min((band - numBands) * edgesPerBand, numEdges);
+			const uint32_t numSilhouetteEdges = (_bandIndexOffsets[band + 1] - _bandIndexOffsets[band]) / 6;
+			for (uint32_t i = 0; i < numSilhouetteEdges; ++i)
 			{
-				indices[volume.numIndices++] = static_cast<INDEXTYPE>(_volumeMesh.edges[i].vertexIndices[1]);
-				indices[volume.numIndices++] = static_cast<INDEXTYPE>(_volumeMesh.edges[i].vertexIndices[0]);
-				indices[volume.numIndices++] = static_cast<INDEXTYPE>(_volumeMesh.edges[i].vertexIndices[1] + _volumeMesh.numVertices);
-
-				indices[volume.numIndices++] = static_cast<INDEXTYPE>(_volumeMesh.edges[i].vertexIndices[1] + _volumeMesh.numVertices);
-				indices[volume.numIndices++] = static_cast<INDEXTYPE>(_volumeMesh.edges[i].vertexIndices[0]);
-				indices[volume.numIndices++] = static_cast<INDEXTYPE>(_volumeMesh.edges[i].vertexIndices[0] + _volumeMesh.numVertices);
+				// Silhouette edge found! Extrude it into a quad, wound according to the triangle in shade.
+				const VolumeEdge& edge = _volumeMesh.edges[silhouetteEdges[i] >> 1];
+				const uint32_t reversed = silhouetteEdges[i] & 0x01;
+				const uint32_t vertex0 = edge.vertexIndices[reversed];
+				const uint32_t vertex1 = edge.vertexIndices[reversed ^ 1];
+				*bandIndices++ = static_cast<INDEXTYPE>(vertex0);
+				*bandIndices++ = static_cast<INDEXTYPE>(vertex1);
+				*bandIndices++ = static_cast<INDEXTYPE>(vertex0 + _volumeMesh.numVertices);
+
+				*bandIndices++ = static_cast<INDEXTYPE>(vertex0 + _volumeMesh.numVertices);
+				*bandIndices++ = static_cast<INDEXTYPE>(vertex1);
+				*bandIndices++ = static_cast<INDEXTYPE>(vertex1 + _volumeMesh.numVertices);
 			}
 		}
-
-		// Zero for next render
-		_volumeMesh.edges[i].visibilityFlags = 0;
-	}
+	});
 
 #ifdef DEBUG // Sanity checks
-	assertion(volume.numIndices * sizeof(INDEXTYPE) <= getIndexDataSize()); // Have we accessed memory we shouldn't have?
-
 	for (uint32_t i = 0; i < volume.numIndices; ++i) { assertion(indices[i] < _volumeMesh.numVertices * 2); }
 #endif
 
@@ -10,6 +10,9 @@
 #include "PVRAssets/Volume.h"
 
 namespace pvr {
+namespace async {
+class JobSystem;
+}
 
 /// <summary>Represents data for handling Shadow volumes of a single Mesh.</summary>
 class ShadowVolume : public Volume
@@ -67,8 +70,11 @@ public:
 	/// <param name="lightModel">The Model-space light. Either point-light(or spot) or directional light supported</param>
 	/// <param name="isPointLight">Pass true for point (or spot) light, false for directional</param>
 	/// <param name="externalIndexBuffer">An external buffer that contains custom, user provided index data.</param>
+	/// <param name="jobSystem">Optional. A job system to find the silhouette on in parallel. Only used for meshes of at least 128K triangles, smaller
+	/// ones are processed on the calling thread. The indices are the same, and in the same order, with or without it.</param>
 	/// <returns>True if successful, otherwise false</returns>
-	bool projectSilhouette(uint32_t volumeID, uint32_t flags, const glm::vec3& lightModel, bool isPointLight, char** externalIndexBuffer = NULL);
+	bool projectSilhouette(
+		uint32_t volumeID, uint32_t flags, const glm::vec3& lightModel, bool isPointLight, char** externalIndexBuffer = NULL, async::JobSystem* jobSystem = nullptr);
 
 private:
 	// A silhouette?
@@ -78,14 +84,18 @@ private:
 		uint32_t numIndices; // If the index count is greater than 0 and indexData is NULL then the data is handled externally
 
 		ShadowVolumeData() : indexData(NULL), numIndices(0) {}
-		~ShadowVolumeData() { delete indexData; }
 	};
 
 	// Extrude
 	template<typename INDEXTYPE>
-	bool project(uint32_t volumeID, uint32_t flags, const glm::vec3& lightModel, bool isPointLight, INDEXTYPE** externalIndexBuffer);
+	bool project(uint32_t volumeID, uint32_t flags, const glm::vec3& lightModel, bool isPointLight, INDEXTYPE** externalIndexBuffer, async::JobSystem* jobSystem);
 
 	typedef std::map<uint32_t, ShadowVolumeData> ShadowVolumeMapType;
 	std::map<uint32_t, ShadowVolumeData> _shadowVolumes;
+
+	// Scratch memory of project, kept to avoid reallocating it for every light
+	std::vector<uint8_t> _isTriangleLit; // Per triangle, padded to a multiple of 4: 1 if the triangle is in the light
+	std::vector<uint32_t> _silhouetteEdges; // Per band of edges, from its first edge: 2 * the index of each silhouette edge + 1 if its quad is reversed
+	std::vector<uint32_t> _bandIndexOffsets; // Per band of triangles then per band of edges: the number of indices, then their offset in the index buffer
 };
 } // namespace pvr
@@ -5,6 +5,7 @@
 \copyright Copyright (c) Imagination Technologies Limited.
 */
 //!\cond NO_DOXYGEN
+#include <algorithm>
 #include <cstring>
 
 #include "PVRAssets/Volume.h"
@@ -15,6 +16,45 @@ using std::pair;
 using std::map;
 
 namespace pvr {
+namespace {
+const uint32_t EmptySlot = 0xFFFFFFFFu;
+
+// The finalizer of MurmurHash3, which spreads every bit of its input over the whole hash.
+inline uint32_t mixBits(uint32_t h)
+{
+	h ^= h >> 16;
+	h *= 0x85EBCA6Bu;
+	h ^= h >> 13;
+	h *= 0xC2B2AE35u;
+	h ^= h >> 16;
+	return h;
+}
+
+inline uint32_t hashCombine(uint32_t seed, uint32_t value) { return mixBits(seed ^ (value + 0x9E3779B9u + (seed << 6) + (seed >> 2))); }
+
+inline uint32_t floatBits(float f)
+{
+	f += 0.f; // -0 and +0 compare equal, so must be the same vertex
+	uint32_t bits;
+	memcpy(&bits, &f, sizeof(bits));
+	return bits;
+}
+
+// Vertices are welded when their coordinates are exactly equal, which is when their bits are equal once the zeroes are normalized. Comparing the bits rather
+// than the values also welds NaNs, so that there are never more vertices than in the source data.
+inline bool isSameVertex(const glm::vec3& a, const glm::vec3& b) { return floatBits(a.x) == floatBits(b.x) && floatBits(a.y) == floatBits(b.y) && floatBits(a.z) == floatBits(b.z); }
+
+inline uint32_t hashVertex(const glm::vec3& v) { return hashCombine(hashCombine(mixBits(floatBits(v.x)), floatBits(v.y)), floatBits(v.z)); }
+
+// Sizes an open addressing table to a power of two, with a load factor of at most one half once it holds maxEntries.
+void resetHashTable(std::vector<uint32_t>& table, uint32_t maxEntries)
+{
+	size_t size = 16;
+	while (size < 2 * static_cast<size_t>(maxEntries)) { size *= 2; }
+	table.assign(size, EmptySlot);
+}
+} // namespace
+
 Volume::~Volume()
 {
 	delete[] _volumeMesh.vertices;
@@ -26,13 +66,15 @@ Volume::~Volume()
 uint32_t Volume::findOrCreateVertex(const glm::vec3& vertex, bool& existed)
 {
 	// First check whether we already have a vertex here
-	for (uint32_t i = 0; i < _volumeMesh.numVertices; ++i)
+	const size_t mask = _vertexHashTable.size() - 1;
+	size_t slot = hashVertex(vertex) & mask;
+	for (; _vertexHashTable[slot] != EmptySlot; slot = (slot + 1) & mask)
 	{
-		if (_volumeMesh.vertices[i].x == vertex.x && _volumeMesh.vertices[i].y == vertex.y && _volumeMesh.vertices[i].z == vertex.z)
+		if (isSameVertex(_volumeMesh.vertices[_vertexHashTable[slot]], vertex))
 		{
 			// Don't do anything more if the vertex already exists
 			existed = true;
-			return i;
+			return _vertexHashTable[slot];
 		}
 	}
 
@@ -54,6 +96,7 @@ uint32_t Volume::findOrCreateVertex(const glm::vec3& vertex, bool& existed)
 
 	// Add the vertex
 	memcpy(&_volumeMesh.vertices[_volumeMesh.numVertices], &vertex, sizeof(vertex));
+	_vertexHashTable[slot] = _volumeMesh.numVertices;
 	existed = false;
 	return _volumeMesh.numVertices++;
 }
@@ -65,24 +108,25 @@ uint32_t Volume::findOrCreateEdge(const glm::vec3& v0, const glm::vec3& v1, bool
 	vertexIndices[0] = findOrCreateVertex(v0, alreadyExisted[0]);
 	vertexIndices[1] = findOrCreateVertex(v1, alreadyExisted[1]);
 
-	if (alreadyExisted[0] && alreadyExisted[1])
+	// Check whether we already have an edge here, in either direction. Edges are hashed on their ordered vertex pair.
+	const size_t mask = _edgeHashTable.size() - 1;
+	size_t slot = hashCombine(mixBits(std::min(vertexIndices[0], vertexIndices[1])), std::max(vertexIndices[0], vertexIndices[1])) & mask;
+	for (; _edgeHashTable[slot] != EmptySlot; slot = (slot + 1) & mask)
 	{
-		// Check whether we already have an edge here
-		for (uint32_t i = 0; i < _volumeMesh.numEdges; ++i)
+		const VolumeEdge& edge = _volumeMesh.edges[_edgeHashTable[slot]];
+		if ((edge.vertexIndices[0] == vertexIndices[0] && edge.vertexIndices[1] == vertexIndices[1]) ||
+			(edge.vertexIndices[0] == vertexIndices[1] && edge.vertexIndices[1] == vertexIndices[0]))
 		{
-			if ((_volumeMesh.edges[i].vertexIndices[0] == vertexIndices[0] && _volumeMesh.edges[i].vertexIndices[1] == vertexIndices[1]) ||
-				(_volumeMesh.edges[i].vertexIndices[0] == vertexIndices[1] && _volumeMesh.edges[i].vertexIndices[1] == vertexIndices[0]))
-			{
-				// Don't do anything more if the edge already exists
-				existed = true;
-				return i;
-			}
+			// Don't do anything more if the edge already exists
+			existed = true;
+			return _edgeHashTable[slot];
 		}
 	}
 
 	// Add the edge
 	_volumeMesh.edges[_volumeMesh.numEdges].vertexIndices[0] = vertexIndices[0];
 	_volumeMesh.edges[_volumeMesh.numEdges].vertexIndices[1] = vertexIndices[1];
+	_edgeHashTable[slot] = _volumeMesh.numEdges;
 	existed = false;
 	return _volumeMesh.numEdges++;
 }
@@ -103,22 +147,25 @@ void Volume::findOrCreateTriangle(const glm::vec3& v0, const glm::vec3& v1, cons
 		return;
 	}
 
-	// First check whether we already have a triangle here
-	if (alreadyExisted[0] && alreadyExisted[1] && alreadyExisted[2])
+	// First check whether we already have a triangle here. Triangles are hashed on their sorted edges, so that any winding of the same edges matches.
+	uint32_t sortedEdges[3] = { edgeIndex0, edgeIndex1, edgeIndex2 };
+	std::sort(sortedEdges, sortedEdges + 3);
+	const size_t mask = _triangleHashTable.size() - 1;
+	size_t slot = hashCombine(hashCombine(mixBits(sortedEdges[0]), sortedEdges[1]), sortedEdges[2]) & mask;
+	for (; _triangleHashTable[slot] != EmptySlot; slot = (slot + 1) & mask)
 	{
-		for (uint32_t i = 0; i < _volumeMesh.numTriangles; ++i)
+		const VolumeTriangle& triangle = _volumeMesh.triangles[_triangleHashTable[slot]];
+		if ((triangle.edgeIndices[0] == edgeIndex0 || triangle.edgeIndices[0] == edgeIndex1 || triangle.edgeIndices[0] == edgeIndex2) &&
+			(triangle.edgeIndices[1] == edgeIndex0 || triangle.edgeIndices[1] == edgeIndex1 || triangle.edgeIndices[1] == edgeIndex2) &&
+			(triangle.edgeIndices[2] == edgeIndex0 || triangle.edgeIndices[2] == edgeIndex1 || triangle.edgeIndices[2] == edgeIndex2))
 		{
-			if ((_volumeMesh.triangles[i].edgeIndices[0] == edgeIndex0 || _volumeMesh.triangles[i].edgeIndices[0] == edgeIndex1 || _volumeMesh.triangles[i].edgeIndices[0] == edgeIndex2) &&
-				(_volumeMesh.triangles[i].edgeIndices[1] == edgeIndex0 || _volumeMesh.triangles[i].edgeIndices[1] == edgeIndex1 || _volumeMesh.triangles[i].edgeIndices[1] == edgeIndex2) &&
-				(_volumeMesh.triangles[i].edgeIndices[2] == edgeIndex0 || _volumeMesh.triangles[i].edgeIndices[2] == edgeIndex1 || _volumeMesh.triangles[i].edgeIndices[2] == edgeIndex2))
-			{
-				// Don't do anything more if the triangle already exists
-				return;
-			}
+			// Don't do anything more if the triangle already exists
+			return;
 		}
 	}
 
 	// Add the triangle then
+	_triangleHashTable[slot] = _volumeMesh.numTriangles;
 	_volumeMesh.triangles[_volumeMesh.numTriangles].edgeIndices[0] = edgeIndex0;
 	_volumeMesh.triangles[_volumeMesh.numTriangles].edgeIndices[1] = edgeIndex1;
 	_volumeMesh.triangles[_volumeMesh.numTriangles].edgeIndices[2] = edgeIndex2;
@@ -194,11 +241,15 @@ bool Volume::init(const uint8_t* const data, uint32_t numVertices, uint32_t vert
 	_volumeMesh.numTriangles = 0;
 
 	_volumeMesh.vertices = new glm::vec3[numVertices];
+	_isClosed = true;
+	resetHashTable(_vertexHashTable, numVertices);
 
 	if (faceData)
 	{
 		_volumeMesh.edges = new VolumeEdge[3 * numFaces];
 		_volumeMesh.triangles = new VolumeTriangle[3 * numFaces];
+		resetHashTable(_edgeHashTable, 3 * numFaces);
+		resetHashTable(_triangleHashTable, numFaces);
 
 		uint32_t indexStride = indexTypeSizeInBytes(indexType);
 
@@ -224,8 +275,11 @@ bool Volume::init(const uint8_t* const data, uint32_t numVertices, uint32_t vert
 	}
 	else // Non-index
 	{
-		_volumeMesh.edges = new VolumeEdge[numVertices / 3];
+		// Each triangle may create up to three edges
+		_volumeMesh.edges = new VolumeEdge[numVertices];
 		_volumeMesh.triangles = new VolumeTriangle[numVertices / 3];
+		resetHashTable(_edgeHashTable, numVertices);
+		resetHashTable(_triangleHashTable, numVertices / 3);
 
 		for (uint32_t i = 0; i < numVertices; i += 3)
 		{
@@ -238,28 +292,62 @@ bool Volume::init(const uint8_t* const data, uint32_t numVertices, uint32_t vert
 		}
 	}
 
-#ifdef DEBUG
-	// Check the data is valid
-	for (uint32_t edge = 0; edge < _volumeMesh.numEdges; ++edge)
+	// The lookup tables are only needed while creating the volume
+	std::vector<uint32_t>().swap(_vertexHashTable);
+	std::vector<uint32_t>().swap(_edgeHashTable);
+	std::vector<uint32_t>().swap(_triangleHashTable);
+
+	// Find the triangles adjacent to each edge, and check the data is valid
 	{
-		uint32_t count = 0;
+		_edgeTriangleOffsets.assign(_volumeMesh.numEdges + 1, 0);
 		for (uint32_t triangle = 0; triangle < _volumeMesh.numTriangles; ++triangle)
 		{
-			if (_volumeMesh.triangles[triangle].edgeIndices[0] == edge) { ++count; }
-
-			if (_volumeMesh.triangles[triangle].edgeIndices[1] == edge) { ++count; }
-
-			if (_volumeMesh.triangles[triangle].edgeIndices[2] == edge) { ++count; }
+			++_edgeTriangleOffsets[_volumeMesh.triangles[triangle].edgeIndices[0] + 1];
+			++_edgeTriangleOffsets[_volumeMesh.triangles[triangle].edgeIndices[1] + 1];
+			++_edgeTriangleOffsets[_volumeMesh.triangles[triangle].edgeIndices[2] + 1];
 		}
 
 		/*
 			Every edge should be referenced exactly twice.
 			If they aren't then the mesh isn't closed which will cause problems when rendering.
 		*/
-		if (count != 2) { _isClosed = false; }
+		for (uint32_t edge = 0; edge < _volumeMesh.numEdges; ++edge)
+		{
+			if (_edgeTriangleOffsets[edge + 1] != 2) { _isClosed = false; }
+			_edgeTriangleOffsets[edge + 1] += _edgeTriangleOffsets[edge];
+		}
+
+		_edgeTriangles.resize(_edgeTriangleOffsets[_volumeMesh.numEdges]);
+		std::vector<uint32_t> nextReference(_edgeTriangleOffsets.begin(), _edgeTriangleOffsets.end() - 1);
+		for (uint32_t triangle = 0; triangle < _volumeMesh.numTriangles; ++triangle)
+		{
+			const VolumeTriangle& data = _volumeMesh.triangles[triangle];
+			for (uint32_t i = 0; i < 3; ++i) { _edgeTriangles[nextReference[data.edgeIndices[i]]++] = triangle * 2 + ((data.winding >> i) & 0x01); }
+		}
 	}
 
-#endif
+	// Copy the planes of the triangles to a structure of arrays
+	{
+		const size_t numPlanes = (_volumeMesh.numTriangles + 3) & ~3u;
+		_trianglePlanes.normalX.assign(numPlanes, 0.f);
+		_trianglePlanes.normalY.assign(numPlanes, 0.f);
+		_trianglePlanes.normalZ.assign(numPlanes, 0.f);
+		_trianglePlanes.pointX.assign(numPlanes, 0.f);
+		_trianglePlanes.pointY.assign(numPlanes, 0.f);
+		_trianglePlanes.pointZ.assign(numPlanes, 0.f);
+		for (uint32_t triangle = 0; triangle < _volumeMesh.numTriangles; ++triangle)
+		{
+			const VolumeTriangle& data = _volumeMesh.triangles[triangle];
+			// The side of the triangle the light is on is tested against the first vertex of its first edge
+			const glm::vec3& point = _volumeMesh.vertices[_volumeMesh.edges[data.edgeIndices[0]].vertexIndices[0]];
+			_trianglePlanes.normalX[triangle] = data.normal.x;
+			_trianglePlanes.normalY[triangle] = data.normal.y;
+			_trianglePlanes.normalZ[triangle] = data.normal.z;
+			_trianglePlanes.pointX[triangle] = point.x;
+			_trianglePlanes.pointY[triangle] = point.y;
+			_trianglePlanes.pointZ[triangle] = point.z;
+		}
+	}
 
 	// Create the real mesh
 	{
@@ -156,5 +156,31 @@ protected:
 	VolumeMesh _volumeMesh; ///< The internal data of the mesh
 
 	bool _isClosed; ///< Is the mesh closed
+
+	/// <summary>The triangles of the volume as a structure of arrays, for vectorized tests of which side of the triangles a light is on: the normal of
+	/// each triangle, and the vertex of the triangle the light is tested against. Padded with zeroes to a multiple of 4 triangles.</summary>
+	struct TrianglePlanes
+	{
+		std::vector<float> normalX; ///< The x coordinates of the normals
+		std::vector<float> normalY; ///< The y coordinates of the normals
+		std::vector<float> normalZ; ///< The z coordinates of the normals
+		std::vector<float> pointX; ///< The x coordinates of the vertices
+		std::vector<float> pointY; ///< The y coordinates of the vertices
+		std::vector<float> pointZ; ///< The z coordinates of the vertices
+	};
+
+	TrianglePlanes _trianglePlanes; ///< The triangles of the volume as a structure of arrays
+
+	/// <summary>The triangles adjacent to each edge, as (2 * triangle index + 1 if the winding of the triangle goes along the edge from its first vertex to
+	/// its second, otherwise + 0). Those of edge i are the elements _edgeTriangleOffsets[i] to _edgeTriangleOffsets[i + 1] - 1.</summary>
+	std::vector<uint32_t> _edgeTriangles;
+	std::vector<uint32_t> _edgeTriangleOffsets; ///< The first element of _edgeTriangles of each edge, followed by the total number of elements
+
+private:
+	// Open addressing hash tables of the indices of the vertices, edges and triangles created so far, which make init linear in the number of triangles.
+	// Only used during init.
+	std::vector<uint32_t> _vertexHashTable;
+	std::vector<uint32_t> _edgeHashTable;
+	std::vector<uint32_t> _triangleHashTable;
 };
 } // namespace pvr
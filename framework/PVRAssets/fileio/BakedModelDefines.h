@@ -0,0 +1,250 @@
+/*!
+\brief Contains the layout of baked model files: load-ready caches of a pvr::assets::Model, written by writeBakedModel and read by readBakedModel.
+\file PVRAssets/fileio/BakedModelDefines.h
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+#pragma once
+#include <cstdint>
+
+namespace pvr {
+namespace baked {
+
+// A baked model file is a FileHeader, followed by the vertex and index data of every mesh, followed by the metadata: arrays of the fixed size records
+// below, strings and the remaining (small) arrays. Every Range starts at a multiple of c_sectionAlignment. The vertex data is stored exactly as the
+// meshes hold it (interleaved, in the byte order of the machine that baked the file), so that a reader can reference it in place in a memory mapped
+// file. The file is not portable between machines of different byte order: readers reject it, and it must be baked again from the source model.
+//
+// Formatted user data (CustomData) is serialised as a tree of values, each a uint32_t CustomData::Type followed by: nothing for NONE, a double for
+// NUMBER, an int32_t for INT, a uint32_t for BOOL, a uint32_t size and the bytes for STRING and BINARY, a uint32_t count and the values for ARRAY, and a
+// uint32_t count and, for each member, a uint32_t key size, the key and the value for OBJECT. Values are not aligned.
+
+/// <summary>The identifier at the start of every baked model file.</summary>
+static const char c_identifier[8] = { 'P', 'V', 'R', 'B', 'A', 'K', 'E', 'D' };
+/// <summary>The version of the layout. Files of any other version are rejected.</summary>
+static const uint32_t c_formatVersion = 1;
+/// <summary>Written in the byte order of the machine that baked the file.</summary>
+static const uint32_t c_byteOrderMark = 0x01020304;
+/// <summary>The alignment, in bytes, of every Range in the file.</summary>
+static const uint32_t c_sectionAlignment = 16;
+
+/// <summary>A contiguous part of the file, e.g. an array of records or the characters of a string (not null terminated).</summary>
+struct Range
+{
+	uint64_t offset; //!< The offset of the first byte from the start of the file
+	uint64_t size; //!< The size in bytes
+};
+
+/// <summary>The header of the file. Each Range is an array of the corresponding record.</summary>
+struct FileHeader
+{
+	char identifier[8]; //!< c_identifier
+	uint32_t version; //!< c_formatVersion
+	uint32_t byteOrderMark; //!< c_byteOrderMark
+	uint64_t fileSize; //!< The size of the whole file
+	uint64_t reserved; //!< Zero
+	Range scene; //!< Exactly one SceneRecord
+	Range meshes; //!< MeshRecords
+	Range nodes; //!< NodeRecords
+	Range textures; //!< TextureRecords
+	Range materials; //!< MaterialRecords
+	Range cameras; //!< CameraRecords
+	Range lights; //!< LightRecords
+	Range skeletons; //!< SkeletonRecords
+	Range animationsData; //!< AnimationDataRecords
+	Range animationInstances; //!< AnimationInstanceRecords
+};
+
+/// <summary>A semantic value (FreeValue) of a model, mesh or material.</summary>
+struct SemanticRecord
+{
+	Range name; //!< The characters of the semantic
+	uint32_t dataType; //!< The GpuDatatypes of the value
+	uint32_t reserved; //!< Zero
+	uint8_t value[64]; //!< The raw value
+};
+
+/// <summary>The model-wide data.</summary>
+struct SceneRecord
+{
+	float clearColor[3]; //!< Background color
+	float ambientColor[3]; //!< Ambient color
+	uint32_t numMeshNodes; //!< Number of nodes which are meshes
+	uint32_t numLightNodes; //!< Number of nodes which are lights
+	uint32_t numCameraNodes; //!< Number of nodes which are cameras
+	uint32_t numFrames; //!< Number of frames of animation
+	float currentFrame; //!< Current frame in the animation
+	float FPS; //!< The frames per second the animation should be played at
+	float units; //!< Unit scaling
+	uint32_t flags; //!< Flags
+	Range semantics; //!< SemanticRecords
+	Range userData; //!< Raw user data
+	Range formattedUserData; //!< Serialised CustomData. Empty if there is none.
+};
+
+/// <summary>A vertex attribute of a mesh.</summary>
+struct VertexAttributeRecord
+{
+	Range semantic; //!< The characters of the semantic
+	uint32_t dataType; //!< The DataType of the attribute
+	uint32_t width; //!< The number of values per vertex
+	uint32_t offset; //!< The offset of the attribute in its vertex block
+	uint32_t dataIndex; //!< The vertex block of the attribute
+};
+
+/// <summary>A block of (usually interleaved) vertex data of a mesh.</summary>
+struct VertexBlockRecord
+{
+	Range data; //!< The vertex data
+	uint32_t stride; //!< The stride of the vertices
+	uint32_t reserved; //!< Zero
+};
+
+/// <summary>A mesh.</summary>
+struct MeshRecord
+{
+	Range semantics; //!< SemanticRecords
+	Range vertexAttributes; //!< VertexAttributeRecords, in the order of their indices
+	Range vertexBlocks; //!< VertexBlockRecords
+	Range faceData; //!< The index data
+	Range stripLengths; //!< uint32_t triangle strip lengths
+	uint32_t indexType; //!< The IndexType of the index data
+	uint32_t numVertices; //!< Number of vertices
+	uint32_t numFaces; //!< Number of faces
+	uint32_t numPatchSubdivisions; //!< Number of patch subdivisions
+	uint32_t numPatches; //!< Number of patches
+	uint32_t numControlPointsPerPatch; //!< Number of control points per patch
+	float units; //!< Scaling of the units
+	uint32_t primitiveType; //!< The PrimitiveTopology
+	uint32_t isIndexed; //!< 1 if the mesh is indexed, otherwise 0
+	uint32_t isSkinned; //!< 1 if the mesh is skinned, otherwise 0
+	float min[3]; //!< The minimum vertex
+	float max[3]; //!< The maximum vertex
+	uint32_t numBones; //!< Number of bones
+	int32_t skeleton; //!< Skeleton index, -1 if none
+	float unpackMatrix[16]; //!< The unpack matrix
+};
+
+/// <summary>A node of the hierarchy.</summary>
+struct NodeRecord
+{
+	Range name; //!< The characters of the name
+	Range userData; //!< Raw user data
+	Range formattedUserData; //!< Serialised CustomData. Empty if there is none.
+	uint32_t objectIndex; //!< Index of the mesh, light or camera
+	uint32_t materialIndex; //!< Index of the material
+	uint32_t parentIndex; //!< Index of the parent node, 0xFFFFFFFF if none
+	uint32_t transformFlags; //!< Node::InternalData::TransformFlags
+	int32_t skin; //!< Skin index
+	uint32_t hasAnimation; //!< 1 if the node is animated, otherwise 0
+	float frameTransform[16]; //!< The current frame transformation
+	float scale[3]; //!< Local space scale
+	float rotation[4]; //!< Local space rotation, in the memory layout of glm::quat
+	float translation[3]; //!< Local space translation
+};
+
+/// <summary>A texture.</summary>
+struct TextureRecord
+{
+	Range name; //!< The characters of the name
+};
+
+/// <summary>A texture referenced by a material.</summary>
+struct TextureIndexRecord
+{
+	Range semantic; //!< The characters of the semantic
+	uint32_t textureIndex; //!< Index of the texture
+	uint32_t reserved; //!< Zero
+};
+
+/// <summary>A material.</summary>
+struct MaterialRecord
+{
+	Range semantics; //!< SemanticRecords
+	Range textureIndices; //!< TextureIndexRecords
+	Range name; //!< The characters of the name
+	Range effectFile; //!< The characters of the effect file name
+	Range effectName; //!< The characters of the effect name
+	Range userData; //!< Raw user data
+	Range formattedUserData; //!< Serialised CustomData. Empty if there is none.
+};
+
+/// <summary>A camera.</summary>
+struct CameraRecord
+{
+	int32_t targetNodeIndex; //!< Index of the target node, -1 if none
+	float farClip; //!< Far clip plane
+	float nearClip; //!< Near clip plane
+	uint32_t reserved; //!< Zero
+	Range fovs; //!< Pairs of floats: frame time in seconds and field of view
+	Range formattedUserData; //!< Serialised CustomData. Empty if there is none.
+};
+
+/// <summary>A light.</summary>
+struct LightRecord
+{
+	int32_t spotTargetNodeIndex; //!< Index of the target node, -1 if none
+	float color[3]; //!< Light color
+	uint32_t type; //!< The Light::LightType
+	float constantAttenuation; //!< Constant attenuation
+	float linearAttenuation; //!< Linear attenuation
+	float quadraticAttenuation; //!< Quadratic attenuation
+	float falloffAngle; //!< Falloff angle, in radians
+	float falloffExponent; //!< Falloff exponent
+};
+
+/// <summary>A skeleton.</summary>
+struct SkeletonRecord
+{
+	Range name; //!< The characters of the name
+	Range bones; //!< uint32_t node indices of the bones
+	Range invBindMatrices; //!< 16 floats per bone
+};
+
+/// <summary>The key frames of one animation channel.</summary>
+struct KeyFrameRecord
+{
+	Range timeInSeconds; //!< floats
+	Range scale; //!< 3 floats per key frame
+	Range rotate; //!< 4 floats per key frame, in the memory layout of glm::quat
+	Range translation; //!< 3 floats per key frame
+	Range mat4; //!< 16 floats per key frame
+	uint32_t interpolation; //!< The KeyFrameData::InterpolationType
+	uint32_t reserved; //!< Zero
+};
+
+/// <summary>An animation.</summary>
+struct AnimationDataRecord
+{
+	Range name; //!< The characters of the name
+	Range positionIndices; //!< uint32_t
+	Range rotationIndices; //!< uint32_t
+	Range scaleIndices; //!< uint32_t
+	Range matrixIndices; //!< uint32_t
+	Range timeInSeconds; //!< floats
+	Range keyFrames; //!< KeyFrameRecords
+	Range formattedUserData; //!< Serialised CustomData. Empty if there is none.
+	uint32_t flags; //!< Flags
+	uint32_t numFrames; //!< Number of frames
+	float startTime; //!< Time at the first key frame, in seconds
+	float endTime; //!< Time at the last key frame, in seconds
+};
+
+/// <summary>The nodes animated by one key frame channel of an animation instance.</summary>
+struct KeyframeChannelRecord
+{
+	Range nodes; //!< uint32_t node indices
+	uint32_t keyFrame; //!< Index of the key frames in the animation
+	uint32_t reserved; //!< Zero
+};
+
+/// <summary>An instance of an animation.</summary>
+struct AnimationInstanceRecord
+{
+	Range keyframeChannels; //!< KeyframeChannelRecords
+	uint32_t animationData; //!< Index of the animation
+	uint32_t reserved; //!< Zero
+};
+
+} // namespace baked
+} // namespace pvr
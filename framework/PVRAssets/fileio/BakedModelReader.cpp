@@ -0,0 +1,489 @@
+/*!
+\brief Implementation of the baked model reader.
+\file PVRAssets/fileio/BakedModelReader.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+#include "PVRAssets/fileio/BakedModelReader.h"
+#include "PVRAssets/fileio/BakedModelDefines.h"
+#include "PVRCore/Errors.h"
+#include "PVRCore/strings/StringFunctions.h"
+#include <cstring>
+
+namespace pvr {
+namespace assets {
+namespace {
+// Protects the recursive reader of formatted user data against stack exhaustion on malicious input.
+const uint32_t MaxCustomDataDepth = 512;
+
+inline uint32_t swapBytes(uint32_t value) { return (value >> 24) | ((value >> 8) & 0xFF00) | ((value << 8) & 0xFF0000) | (value << 24); }
+
+void throwCorrupted(const char* what) { throw InvalidDataError(strings::createFormatted("[readBakedModel]: The file is corrupted: %s", what)); }
+
+// Reads a serialised CustomData (see BakedModelDefines.h).
+class CustomDataReader
+{
+public:
+	CustomDataReader(const uint8_t* data, size_t size) : _data(data), _size(size), _position(0) {}
+
+	CustomData readValue(uint32_t depth)
+	{
+		if (depth >= MaxCustomDataDepth) { throwCorrupted("formatted user data nested too deeply"); }
+		switch (static_cast<CustomData::Type>(read<uint32_t>()))
+		{
+		case CustomData::Type::NONE: return CustomData();
+		case CustomData::Type::NUMBER: return CustomData(read<double>());
+		case CustomData::Type::INT: return CustomData(static_cast<int>(read<int32_t>()));
+		case CustomData::Type::BOOL: return CustomData(read<uint32_t>() != 0);
+		case CustomData::Type::STRING: return CustomData(readString());
+		case CustomData::Type::BINARY:
+		{
+			const uint32_t size = read<uint32_t>();
+			return CustomData(readBytes(size), size);
+		}
+		case CustomData::Type::ARRAY:
+		{
+			const uint32_t count = read<uint32_t>();
+			CustomData::Array array;
+			for (uint32_t i = 0; i < count; ++i) { array.push_back(readValue(depth + 1)); }
+			return CustomData(array);
+		}
+		case CustomData::Type::OBJECT:
+		{
+			const uint32_t count = read<uint32_t>();
+			CustomData::Object object;
+			for (uint32_t i = 0; i < count; ++i)
+			{
+				const std::string key = readString();
+				object[key] = readValue(depth + 1);
+			}
+			return CustomData(object);
+		}
+		default: throwCorrupted("unknown formatted user data type"); return CustomData();
+		}
+	}
+
+	bool isAtEnd() const { return _position == _size; }
+
+private:
+	const uint8_t* readBytes(size_t size)
+	{
+		if (size > _size - _position) { throwCorrupted("formatted user data out of bounds"); }
+		const uint8_t* bytes = _data + _position;
+		_position += size;
+		return bytes;
+	}
+
+	template<typename T>
+	T read()
+	{
+		T value;
+		memcpy(&value, readBytes(sizeof(T)), sizeof(T));
+		return value;
+	}
+
+	std::string readString()
+	{
+		const uint32_t size = read<uint32_t>();
+		return std::string(reinterpret_cast<const char*>(readBytes(size)), size);
+	}
+
+	const uint8_t* _data;
+	size_t _size;
+	size_t _position;
+};
+
+// The data of a baked model file. Resolves the Ranges of the file into pointers, checking that they are within the file and aligned.
+class BakedFile
+{
+public:
+	BakedFile(std::shared_ptr<const uint8_t> data, uint64_t size) : _data(std::move(data)), _size(size) {}
+
+	template<typename T>
+	const T* getArray(const baked::Range& range, size_t& count) const
+	{
+		checkRange(range, alignof(T));
+		if (range.size % sizeof(T)) { throwCorrupted("array of incorrect size"); }
+		count = static_cast<size_t>(range.size / sizeof(T));
+		return reinterpret_cast<const T*>(_data.get() + range.offset);
+	}
+
+	template<typename T>
+	void getVector(const baked::Range& range, std::vector<T>& out) const
+	{
+		size_t count;
+		const T* items = getArray<T>(range, count);
+		out.assign(items, items + count);
+	}
+
+	std::string getString(const baked::Range& range) const
+	{
+		checkRange(range, 1);
+		return std::string(reinterpret_cast<const char*>(_data.get() + range.offset), static_cast<size_t>(range.size));
+	}
+
+	// References the data in place, sharing ownership of the whole file.
+	std::shared_ptr<const uint8_t> getSharedData(const baked::Range& range) const
+	{
+		checkRange(range, 1);
+		return std::shared_ptr<const uint8_t>(_data, _data.get() + range.offset);
+	}
+
+	CustomData getCustomData(const baked::Range& range) const
+	{
+		if (!range.size) { return CustomData(); }
+		checkRange(range, 1);
+		CustomDataReader reader(_data.get() + range.offset, static_cast<size_t>(range.size));
+		CustomData data = reader.readValue(0);
+		if (!reader.isAtEnd()) { throwCorrupted("trailing formatted user data"); }
+		return data;
+	}
+
+	void getSemantics(const baked::Range& range, std::map<StringHash, FreeValue>& semantics) const
+	{
+		size_t count;
+		const baked::SemanticRecord* records = getArray<baked::SemanticRecord>(range, count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			FreeValue& value = semantics[StringHash(getString(records[i].name))];
+			value.setDataType(static_cast<GpuDatatypes>(records[i].dataType));
+			memcpy(&value.interpretValueAs<uint8_t>(), records[i].value, sizeof(records[i].value));
+		}
+	}
+
+private:
+	void checkRange(const baked::Range& range, size_t alignment) const
+	{
+		if (range.offset > _size || range.size > _size - range.offset) { throwCorrupted("data out of bounds"); }
+		if (reinterpret_cast<uintptr_t>(_data.get() + range.offset) % alignment) { throwCorrupted("misaligned data"); }
+	}
+
+	std::shared_ptr<const uint8_t> _data;
+	uint64_t _size;
+};
+
+// Checks an index into an array of count elements read from the file. If allowNone is true, the index may also be -1.
+void checkIndex(uint32_t index, size_t count, bool allowNone, const char* what)
+{
+	if (index >= count && !(allowNone && index == static_cast<uint32_t>(-1))) { throwCorrupted(what); }
+}
+
+uint32_t getDataSize(const baked::Range& range)
+{
+	if (range.size > static_cast<uint32_t>(-1)) { throwCorrupted("mesh data larger than 4GB"); }
+	return static_cast<uint32_t>(range.size);
+}
+
+// The arrays of the model are sized before any of its objects are read, so that the indices of the objects can be checked against them.
+void readMesh(const BakedFile& file, const baked::MeshRecord& record, const Model::InternalData& modelData, Mesh& mesh)
+{
+	Mesh::InternalData& meshData = mesh.getInternalData();
+	file.getSemantics(record.semantics, meshData.semantics);
+
+	size_t numBlocks;
+	const baked::VertexBlockRecord* blocks = file.getArray<baked::VertexBlockRecord>(record.vertexBlocks, numBlocks);
+	for (size_t i = 0; i < numBlocks; ++i)
+	{
+		const uint32_t size = getDataSize(blocks[i].data);
+		if (size) { mesh.addExternalData(file.getSharedData(blocks[i].data), size, blocks[i].stride); }
+		else
+		{
+			mesh.addData(nullptr, 0, blocks[i].stride);
+		}
+	}
+
+	size_t count;
+	const baked::VertexAttributeRecord* attributes = file.getArray<baked::VertexAttributeRecord>(record.vertexAttributes, count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		const baked::VertexAttributeRecord& attribute = attributes[i];
+		checkIndex(attribute.dataIndex, numBlocks, false, "vertex data index out of range");
+		mesh.addVertexAttribute(StringHash(file.getString(attribute.semantic)), static_cast<DataType>(attribute.dataType), attribute.width, attribute.offset, attribute.dataIndex);
+	}
+
+	const uint32_t faceDataSize = getDataSize(record.faceData);
+	mesh.addExternalFaces(faceDataSize ? file.getSharedData(record.faceData) : nullptr, faceDataSize, static_cast<IndexType>(record.indexType));
+
+	// After the faces, which set the number of faces assuming a triangle list.
+	Mesh::MeshInfo& info = meshData.primitiveData;
+	file.getVector(record.stripLengths, info.stripLengths);
+	info.numVertices = record.numVertices;
+	info.numFaces = record.numFaces;
+	info.numPatchSubdivisions = record.numPatchSubdivisions;
+	info.numPatches = record.numPatches;
+	info.numControlPointsPerPatch = record.numControlPointsPerPatch;
+	info.units = record.units;
+	info.primitiveType = static_cast<PrimitiveTopology>(record.primitiveType);
+	info.isIndexed = record.isIndexed != 0;
+	info.isSkinned = record.isSkinned != 0;
+	memcpy(&info.min, record.min, sizeof(record.min));
+	memcpy(&info.max, record.max, sizeof(record.max));
+	meshData.numBones = record.numBones;
+	checkIndex(static_cast<uint32_t>(record.skeleton), modelData.skeletons.size(), true, "skeleton index out of range");
+	meshData.skeleton = record.skeleton;
+	memcpy(&meshData.unpackMatrix, record.unpackMatrix, sizeof(record.unpackMatrix));
+}
+
+void readNode(const BakedFile& file, const baked::NodeRecord& record, uint32_t nodeIndex, const Model::InternalData& modelData, Node& node)
+{
+	// The mesh nodes come first, then the light nodes, then the camera nodes. The index of any other node's object is not used.
+	const uint32_t firstLightNode = modelData.numMeshNodes;
+	const uint32_t firstCameraNode = firstLightNode + modelData.numLightNodes;
+	if (nodeIndex < firstLightNode) { checkIndex(record.objectIndex, modelData.meshes.size(), false, "mesh index out of range"); }
+	else if (nodeIndex < firstCameraNode)
+	{
+		checkIndex(record.objectIndex, modelData.lights.size(), false, "light index out of range");
+	}
+	else if (nodeIndex < firstCameraNode + modelData.numCameraNodes)
+	{
+		checkIndex(record.objectIndex, modelData.cameras.size(), false, "camera index out of range");
+	}
+	checkIndex(record.materialIndex, modelData.materials.size(), true, "material index out of range");
+	checkIndex(record.parentIndex, modelData.nodes.size(), true, "parent node index out of range");
+	if (record.parentIndex == nodeIndex) { throwCorrupted("node is its own parent"); }
+
+	Node::InternalData& nodeData = node.getInternalData();
+	nodeData.name = StringHash(file.getString(record.name));
+	file.getVector(record.userData, nodeData.userData);
+	nodeData.formattedUserData = file.getCustomData(record.formattedUserData);
+	nodeData.objectIndex = record.objectIndex;
+	nodeData.materialIndex = record.materialIndex;
+	nodeData.parentIndex = record.parentIndex;
+	nodeData.transformFlags = record.transformFlags;
+	nodeData.skin = record.skin;
+	nodeData.hasAnimation = record.hasAnimation != 0;
+	memcpy(nodeData.frameTransform, record.frameTransform, sizeof(record.frameTransform));
+	memcpy(&nodeData.scale, record.scale, sizeof(record.scale));
+	memcpy(&nodeData.rotation, record.rotation, sizeof(record.rotation));
+	memcpy(&nodeData.translation, record.translation, sizeof(record.translation));
+}
+
+// The transforms of the nodes are concatenated by walking up their parents, so the hierarchy must not contain a cycle.
+void checkNodeHierarchy(const std::vector<Node>& nodes)
+{
+	// 0: not visited yet, 1: on the path being walked, 2: leads to a root
+	std::vector<uint8_t> states(nodes.size(), 0);
+	for (size_t i = 0; i < nodes.size(); ++i)
+	{
+		uint32_t node = static_cast<uint32_t>(i);
+		while (node != static_cast<uint32_t>(-1) && states[node] == 0)
+		{
+			states[node] = 1;
+			node = nodes[node].getParentID();
+		}
+		if (node != static_cast<uint32_t>(-1) && states[node] == 1) { throwCorrupted("cycle in the node hierarchy"); }
+		for (node = static_cast<uint32_t>(i); node != static_cast<uint32_t>(-1) && states[node] == 1; node = nodes[node].getParentID()) { states[node] = 2; }
+	}
+}
+
+void readMaterial(const BakedFile& file, const baked::MaterialRecord& record, size_t numTextures, Model::Material& material)
+{
+	Model::Material::InternalData& materialData = material.getInternalData();
+	file.getSemantics(record.semantics, materialData.materialSemantics);
+
+	size_t count;
+	const baked::TextureIndexRecord* textureIndices = file.getArray<baked::TextureIndexRecord>(record.textureIndices, count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		checkIndex(textureIndices[i].textureIndex, numTextures, false, "texture index out of range");
+		materialData.textureIndices[StringHash(file.getString(textureIndices[i].semantic))] = textureIndices[i].textureIndex;
+	}
+
+	materialData.name = StringHash(file.getString(record.name));
+	materialData.effectFile = StringHash(file.getString(record.effectFile));
+	materialData.effectName = StringHash(file.getString(record.effectName));
+	file.getVector(record.userData, materialData.userData);
+	materialData.formattedUserData = file.getCustomData(record.formattedUserData);
+}
+
+void readAnimationData(const BakedFile& file, const baked::AnimationDataRecord& record, AnimationData& animation)
+{
+	AnimationData::InternalData& animationData = animation.getInternalData();
+
+	size_t count;
+	const baked::KeyFrameRecord* keyFrames = file.getArray<baked::KeyFrameRecord>(record.keyFrames, count);
+	animationData.keyFrames.resize(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		KeyFrameData& keyFrame = animationData.keyFrames[i];
+		file.getVector(keyFrames[i].timeInSeconds, keyFrame.timeInSeconds);
+		file.getVector(keyFrames[i].scale, keyFrame.scale);
+		file.getVector(keyFrames[i].rotate, keyFrame.rotate);
+		file.getVector(keyFrames[i].translation, keyFrame.translation);
+		file.getVector(keyFrames[i].mat4, keyFrame.mat4);
+		keyFrame.interpolation = static_cast<KeyFrameData::InterpolationType>(keyFrames[i].interpolation);
+	}
+
+	animationData.animationName = file.getString(record.name);
+	file.getVector(record.positionIndices, animationData.positionIndices);
+	file.getVector(record.rotationIndices, animationData.rotationIndices);
+	file.getVector(record.scaleIndices, animationData.scaleIndices);
+	file.getVector(record.matrixIndices, animationData.matrixIndices);
+	file.getVector(record.timeInSeconds, animationData.timeInSeconds);
+	animationData.formattedUserData = file.getCustomData(record.formattedUserData);
+	animationData.flags = record.flags;
+	animationData.numFrames = record.numFrames;
+	animationData.startTime = record.startTime;
+	animationData.endTime = record.endTime;
+}
+
+// The animation instances reference the animations and nodes of the model by pointer, so they are read last.
+void readAnimationInstance(const BakedFile& file, const baked::AnimationInstanceRecord& record, Model::InternalData& modelData, AnimationInstance& instance)
+{
+	if (record.animationData >= modelData.animationsData.size()) { throwCorrupted("animation index out of range"); }
+	instance.animationData = &modelData.animationsData[record.animationData];
+
+	size_t count;
+	const baked::KeyframeChannelRecord* channels = file.getArray<baked::KeyframeChannelRecord>(record.keyframeChannels, count);
+	instance.keyframeChannels.resize(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		AnimationInstance::KeyframeChannel& channel = instance.keyframeChannels[i];
+		if (channels[i].keyFrame >= instance.animationData->getNumKeyFrames()) { throwCorrupted("key frame index out of range"); }
+		channel.keyFrame = channels[i].keyFrame;
+
+		size_t numNodes;
+		const uint32_t* nodes = file.getArray<uint32_t>(channels[i].nodes, numNodes);
+		channel.nodes.reserve(numNodes);
+		for (size_t j = 0; j < numNodes; ++j)
+		{
+			if (nodes[j] >= modelData.nodes.size()) { throwCorrupted("node index out of range"); }
+			channel.nodes.push_back(&modelData.nodes[nodes[j]]);
+		}
+	}
+}
+} // namespace
+
+void readBakedModel(const ::pvr::Stream& stream, Model& model)
+{
+	const uint64_t fileSize = stream.getSize64() - stream.getPosition64();
+	if (fileSize < sizeof(baked::FileHeader)) { throw InvalidDataError("[readBakedModel]: Not a baked model file"); }
+
+	// The records are used in place, so the data must be at least as aligned as they are. That is always the case for a memory mapped file, but not for
+	// other directly addressable streams whose position is not at the start of their data.
+	std::shared_ptr<const unsigned char> fileData = stream.getSharedDataPointer();
+	if (!fileData || reinterpret_cast<uintptr_t>(fileData.get()) % alignof(baked::FileHeader))
+	{
+		auto data = std::make_shared<std::vector<unsigned char>>(stream.readToEnd<unsigned char>());
+		fileData = std::shared_ptr<const unsigned char>(data, data->data());
+	}
+
+	const baked::FileHeader& header = *reinterpret_cast<const baked::FileHeader*>(fileData.get());
+	if (memcmp(header.identifier, baked::c_identifier, sizeof(header.identifier)) != 0) { throw InvalidDataError("[readBakedModel]: Not a baked model file"); }
+	if (header.byteOrderMark == swapBytes(baked::c_byteOrderMark))
+	{ throw InvalidDataError("[readBakedModel]: The file was baked on a machine of different byte order. Bake it again from the source model."); }
+	if (header.byteOrderMark != baked::c_byteOrderMark) { throwCorrupted("invalid byte order mark"); }
+	if (header.version != baked::c_formatVersion)
+	{ throw InvalidDataError(strings::createFormatted("[readBakedModel]: Unsupported version %u. Bake the file again from the source model.", header.version)); }
+	if (header.fileSize > fileSize) { throwCorrupted("truncated"); }
+
+	const BakedFile file(fileData, header.fileSize);
+	Model::InternalData& modelData = model.getInternalData();
+	size_t count;
+
+	const baked::SceneRecord* scene = file.getArray<baked::SceneRecord>(header.scene, count);
+	if (count != 1) { throwCorrupted("missing scene"); }
+	memcpy(modelData.clearColor, scene->clearColor, sizeof(scene->clearColor));
+	memcpy(modelData.ambientColor, scene->ambientColor, sizeof(scene->ambientColor));
+	modelData.numMeshNodes = scene->numMeshNodes;
+	modelData.numLightNodes = scene->numLightNodes;
+	modelData.numCameraNodes = scene->numCameraNodes;
+	modelData.numFrames = scene->numFrames;
+	modelData.currentFrame = scene->currentFrame;
+	modelData.FPS = scene->FPS;
+	modelData.units = scene->units;
+	modelData.flags = scene->flags;
+	file.getSemantics(scene->semantics, modelData.semantics);
+	file.getVector(scene->userData, modelData.userData);
+	modelData.formattedUserData = file.getCustomData(scene->formattedUserData);
+
+	size_t numMeshes, numNodes, numTextures, numMaterials, numCameras, numLights, numSkeletons;
+	const baked::MeshRecord* meshes = file.getArray<baked::MeshRecord>(header.meshes, numMeshes);
+	const baked::NodeRecord* nodes = file.getArray<baked::NodeRecord>(header.nodes, numNodes);
+	const baked::TextureRecord* textures = file.getArray<baked::TextureRecord>(header.textures, numTextures);
+	const baked::MaterialRecord* materials = file.getArray<baked::MaterialRecord>(header.materials, numMaterials);
+	const baked::CameraRecord* cameras = file.getArray<baked::CameraRecord>(header.cameras, numCameras);
+	const baked::LightRecord* lights = file.getArray<baked::LightRecord>(header.lights, numLights);
+	const baked::SkeletonRecord* skeletons = file.getArray<baked::SkeletonRecord>(header.skeletons, numSkeletons);
+	if (static_cast<uint64_t>(modelData.numMeshNodes) + modelData.numLightNodes + modelData.numCameraNodes > numNodes) { throwCorrupted("too few nodes"); }
+	modelData.meshes.resize(numMeshes);
+	modelData.nodes.resize(numNodes);
+	modelData.textures.resize(numTextures);
+	modelData.materials.resize(numMaterials);
+	modelData.cameras.resize(numCameras);
+	modelData.lights.resize(numLights);
+	modelData.skeletons.resize(numSkeletons);
+
+	for (size_t i = 0; i < numMeshes; ++i) { readMesh(file, meshes[i], modelData, modelData.meshes[i]); }
+
+	for (size_t i = 0; i < numNodes; ++i) { readNode(file, nodes[i], static_cast<uint32_t>(i), modelData, modelData.nodes[i]); }
+	checkNodeHierarchy(modelData.nodes);
+
+	for (size_t i = 0; i < numTextures; ++i) { modelData.textures[i].setName(StringHash(file.getString(textures[i].name))); }
+
+	for (size_t i = 0; i < numMaterials; ++i) { readMaterial(file, materials[i], numTextures, modelData.materials[i]); }
+
+	for (size_t i = 0; i < numCameras; ++i)
+	{
+		Camera& camera = modelData.cameras[i];
+		checkIndex(static_cast<uint32_t>(cameras[i].targetNodeIndex), numNodes, true, "camera target node index out of range");
+		camera.setTargetNodeIndex(cameras[i].targetNodeIndex);
+		camera.getInternalData().farClip = cameras[i].farClip;
+		camera.getInternalData().nearClip = cameras[i].nearClip;
+		file.getVector(cameras[i].fovs, camera.getInternalData().fovs);
+		camera.getFormattedUserData() = file.getCustomData(cameras[i].formattedUserData);
+	}
+
+	for (size_t i = 0; i < numLights; ++i)
+	{
+		Light::InternalData& lightData = modelData.lights[i].getInternalData();
+		checkIndex(static_cast<uint32_t>(lights[i].spotTargetNodeIndex), numNodes, true, "light target node index out of range");
+		lightData.spotTargetNodeIdx = lights[i].spotTargetNodeIndex;
+		memcpy(&lightData.color, lights[i].color, sizeof(lights[i].color));
+		lightData.type = static_cast<Light::LightType>(lights[i].type);
+		lightData.constantAttenuation = lights[i].constantAttenuation;
+		lightData.linearAttenuation = lights[i].linearAttenuation;
+		lightData.quadraticAttenuation = lights[i].quadraticAttenuation;
+		lightData.falloffAngle = lights[i].falloffAngle;
+		lightData.falloffExponent = lights[i].falloffExponent;
+	}
+
+	for (size_t i = 0; i < numSkeletons; ++i)
+	{
+		Skeleton& skeleton = modelData.skeletons[i];
+		skeleton.name = file.getString(skeletons[i].name);
+		file.getVector(skeletons[i].bones, skeleton.bones);
+		file.getVector(skeletons[i].invBindMatrices, skeleton.invBindMatrices);
+		for (uint32_t bone : skeleton.bones) { checkIndex(bone, numNodes, false, "bone node index out of range"); }
+		if (skeleton.invBindMatrices.size() < skeleton.bones.size()) { throwCorrupted("missing inverse bind matrices"); }
+	}
+
+	const baked::AnimationDataRecord* animationsData = file.getArray<baked::AnimationDataRecord>(header.animationsData, count);
+	modelData.animationsData.resize(count);
+	for (size_t i = 0; i < count; ++i) { readAnimationData(file, animationsData[i], modelData.animationsData[i]); }
+
+	const baked::AnimationInstanceRecord* animationInstances = file.getArray<baked::AnimationInstanceRecord>(header.animationInstances, count);
+	modelData.animationInstances.resize(count);
+	for (size_t i = 0; i < count; ++i) { readAnimationInstance(file, animationInstances[i], modelData, modelData.animationInstances[i]); }
+}
+
+Model readBakedModel(const ::pvr::Stream& stream)
+{
+	Model model;
+	readBakedModel(stream, model);
+	return model;
+}
+
+bool isBakedModel(const ::pvr::Stream& stream)
+{
+	if (!stream.isReadable()) { return false; }
+	baked::FileHeader header;
+	size_t dataRead;
+	stream.read(sizeof(header), 1, &header, dataRead);
+	return dataRead == 1 && memcmp(header.identifier, baked::c_identifier, sizeof(header.identifier)) == 0 && header.byteOrderMark == baked::c_byteOrderMark &&
+		header.version == baked::c_formatVersion;
+}
+} // namespace assets
+} // namespace pvr
+//!\endcond
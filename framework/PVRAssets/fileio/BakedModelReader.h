@@ -0,0 +1,37 @@
+/*!
+\brief Reads baked model files (see writeBakedModel) and creates pvr::assets::Model objects out of them.
+\file PVRAssets/fileio/BakedModelReader.h
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+#pragma once
+
+#include "PVRAssets/Model.h"
+#include "PVRCore/stream/Stream.h"
+
+namespace pvr {
+namespace assets {
+
+/// <summary>Read a baked model file, written by writeBakedModel, into a Model. Nothing is parsed or converted: the records of the file are copied into
+/// the model and the node pointers of its animations are fixed up. The indices by which the objects of the file reference each other (nodes, meshes,
+/// materials, skeletons...) are checked, so that a corrupted file throws instead of producing a model which crashes when used. If the stream supports
+/// direct access to its data (e.g. a MappedFileStream, as returned by Shell::getAssetStream for .pvrmodel files, see Stream::getSharedDataPointer), the vertex and index
+/// data of the meshes reference the file in place instead of being copied, so loading is independent of the amount of vertex data. Otherwise the file
+/// is read into memory once and the meshes reference that copy.</summary>
+/// <param name="stream">The stream to read from</param>
+/// <param name="model">The model to read into. Must be empty.</param>
+/// <remarks>Throws InvalidDataError if the stream is not a valid baked model file, or was baked on a machine of different byte order.</remarks>
+void readBakedModel(const ::pvr::Stream& stream, ::pvr::assets::Model& model);
+
+/// <summary>Read a baked model file, written by writeBakedModel, into a new Model.</summary>
+/// <param name="stream">The stream to read from</param>
+/// <returns>The model</returns>
+::pvr::assets::Model readBakedModel(const ::pvr::Stream& stream);
+
+/// <summary>Check if a stream is a baked model file that can be read on this machine. Reads the header of the stream.</summary>
+/// <param name="stream">The stream to check</param>
+/// <returns>True if the stream starts with the header of a baked model file of the current version and of this machine's byte order</returns>
+bool isBakedModel(const ::pvr::Stream& stream);
+
+} // namespace assets
+} // namespace pvr
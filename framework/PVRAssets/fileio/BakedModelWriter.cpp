@@ -0,0 +1,455 @@
+/*!
+\brief Implementation of the baked model writer.
+\file PVRAssets/fileio/BakedModelWriter.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+#include "PVRAssets/fileio/BakedModelWriter.h"
+#include "PVRAssets/fileio/BakedModelDefines.h"
+#include "PVRCore/Errors.h"
+#include <cstring>
+
+namespace pvr {
+namespace assets {
+namespace {
+static_assert(sizeof(glm::vec3) == 3 * sizeof(float) && sizeof(glm::quat) == 4 * sizeof(float) && sizeof(glm::mat4) == 16 * sizeof(float),
+	"The baked model layout requires tightly packed glm types");
+
+inline uint64_t alignOffset(uint64_t offset) { return (offset + baked::c_sectionAlignment - 1) & ~static_cast<uint64_t>(baked::c_sectionAlignment - 1); }
+
+template<typename T>
+void append(std::vector<uint8_t>& out, const T& value)
+{
+	const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+	out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+void appendBytes(std::vector<uint8_t>& out, const void* data, size_t size)
+{
+	append(out, static_cast<uint32_t>(size));
+	out.insert(out.end(), static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + size);
+}
+
+void serializeCustomData(const CustomData& data, std::vector<uint8_t>& out)
+{
+	append(out, static_cast<uint32_t>(data.GetType()));
+	switch (data.GetType())
+	{
+	case CustomData::Type::NUMBER: append(out, data.GetDouble()); break;
+	case CustomData::Type::INT: append(out, static_cast<int32_t>(data.GetInt())); break;
+	case CustomData::Type::BOOL: append(out, static_cast<uint32_t>(data.GetBool())); break;
+	case CustomData::Type::STRING: appendBytes(out, data.GetString().data(), data.GetString().size()); break;
+	case CustomData::Type::BINARY: appendBytes(out, data.GetBinary().data(), data.GetBinary().size()); break;
+	case CustomData::Type::ARRAY:
+		append(out, static_cast<uint32_t>(data.ArrayLen()));
+		for (const CustomData& element : data.GetArray()) { serializeCustomData(element, out); }
+		break;
+	case CustomData::Type::OBJECT:
+	{
+		const std::vector<std::string> keys = data.Keys();
+		append(out, static_cast<uint32_t>(keys.size()));
+		for (const std::string& key : keys)
+		{
+			appendBytes(out, key.data(), key.size());
+			serializeCustomData(data.Get(key), out);
+		}
+		break;
+	}
+	default: break;
+	}
+}
+
+// Lays out the metadata of the file (records, strings and small arrays), which starts at baseOffset. Records are added after the data they reference,
+// so that all the records of a kind form a single array.
+class MetadataBuilder
+{
+public:
+	explicit MetadataBuilder(uint64_t baseOffset) : _baseOffset(baseOffset) {}
+
+	baked::Range add(const void* data, size_t size)
+	{
+		_data.resize(static_cast<size_t>(alignOffset(_data.size())));
+		baked::Range range;
+		range.offset = _baseOffset + _data.size();
+		range.size = size;
+		if (size) { _data.insert(_data.end(), static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + size); }
+		return range;
+	}
+
+	template<typename T>
+	baked::Range add(const std::vector<T>& items)
+	{
+		return add(items.data(), items.size() * sizeof(T));
+	}
+
+	baked::Range add(const std::string& str) { return add(str.data(), str.size()); }
+
+	baked::Range add(const StringHash& str) { return add(str.str()); }
+
+	baked::Range addCustomData(const CustomData& data)
+	{
+		if (data.GetType() == CustomData::Type::NONE) { return add(nullptr, 0); }
+		std::vector<uint8_t> serialized;
+		serializeCustomData(data, serialized);
+		return add(serialized);
+	}
+
+	baked::Range addSemantics(const std::map<StringHash, FreeValue>& semantics)
+	{
+		std::vector<baked::SemanticRecord> records;
+		records.reserve(semantics.size());
+		for (const auto& semantic : semantics)
+		{
+			baked::SemanticRecord record = {};
+			record.name = add(semantic.first);
+			record.dataType = static_cast<uint32_t>(semantic.second.dataType());
+			memcpy(record.value, &semantic.second.interpretValueAs<uint8_t>(), sizeof(record.value));
+			records.push_back(record);
+		}
+		return add(records);
+	}
+
+	const std::vector<uint8_t>& getData() const { return _data; }
+
+private:
+	uint64_t _baseOffset;
+	std::vector<uint8_t> _data;
+};
+
+// A block of vertex or index data, written between the header and the metadata.
+struct BulkData
+{
+	const void* data;
+	size_t size;
+	uint64_t offset;
+};
+
+void writePadding(Stream& stream, uint64_t& position, uint64_t alignedPosition)
+{
+	static const uint8_t zeroes[baked::c_sectionAlignment] = {};
+	if (alignedPosition > position) { stream.writeExact(1, static_cast<size_t>(alignedPosition - position), zeroes); }
+	position = alignedPosition;
+}
+
+uint32_t getNodeIndex(const Model::InternalData& modelData, const void* node)
+{
+	const Node* nodes = modelData.nodes.data();
+	const Node* found = static_cast<const Node*>(node);
+	if (found < nodes || found >= nodes + modelData.nodes.size()) { throw InvalidDataError("[writeBakedModel]: An animation channel references a node that is not part of the model"); }
+	return static_cast<uint32_t>(found - nodes);
+}
+
+baked::MeshRecord createMeshRecord(const Mesh& mesh, MetadataBuilder& builder)
+{
+	const Mesh::InternalData& meshData = mesh.getInternalData();
+	const Mesh::MeshInfo& info = meshData.primitiveData;
+
+	baked::MeshRecord record = {};
+	record.semantics = builder.addSemantics(meshData.semantics);
+
+	std::vector<baked::VertexAttributeRecord> attributes;
+	attributes.reserve(mesh.getVertexAttributesSize());
+	for (uint32_t i = 0; i < mesh.getVertexAttributesSize(); ++i)
+	{
+		const Mesh::VertexAttributeData* attribute = mesh.getVertexAttribute(static_cast<int32_t>(i));
+		baked::VertexAttributeRecord attributeRecord = {};
+		attributeRecord.semantic = builder.add(attribute->getSemantic());
+		attributeRecord.dataType = static_cast<uint32_t>(attribute->getVertexLayout().dataType);
+		attributeRecord.width = attribute->getN();
+		attributeRecord.offset = attribute->getOffset();
+		attributeRecord.dataIndex = attribute->getDataIndex();
+		attributes.push_back(attributeRecord);
+	}
+	record.vertexAttributes = builder.add(attributes);
+
+	record.stripLengths = builder.add(info.stripLengths);
+	record.indexType = static_cast<uint32_t>(mesh.getFaces().getDataType());
+	record.numVertices = info.numVertices;
+	record.numFaces = info.numFaces;
+	record.numPatchSubdivisions = info.numPatchSubdivisions;
+	record.numPatches = info.numPatches;
+	record.numControlPointsPerPatch = info.numControlPointsPerPatch;
+	record.units = info.units;
+	record.primitiveType = static_cast<uint32_t>(info.primitiveType);
+	record.isIndexed = info.isIndexed ? 1 : 0;
+	record.isSkinned = info.isSkinned ? 1 : 0;
+	memcpy(record.min, &info.min, sizeof(record.min));
+	memcpy(record.max, &info.max, sizeof(record.max));
+	record.numBones = meshData.numBones;
+	record.skeleton = meshData.skeleton;
+	memcpy(record.unpackMatrix, &meshData.unpackMatrix, sizeof(record.unpackMatrix));
+	return record;
+}
+
+baked::NodeRecord createNodeRecord(const Node& node, MetadataBuilder& builder)
+{
+	const Node::InternalData& nodeData = node.getInternalData();
+
+	baked::NodeRecord record = {};
+	record.name = builder.add(nodeData.name);
+	record.userData = builder.add(nodeData.userData);
+	record.formattedUserData = builder.addCustomData(nodeData.formattedUserData);
+	record.objectIndex = nodeData.objectIndex;
+	record.materialIndex = nodeData.materialIndex;
+	record.parentIndex = nodeData.parentIndex;
+	record.transformFlags = nodeData.transformFlags;
+	record.skin = nodeData.skin;
+	record.hasAnimation = nodeData.hasAnimation ? 1 : 0;
+	memcpy(record.frameTransform, nodeData.frameTransform, sizeof(record.frameTransform));
+	memcpy(record.scale, &nodeData.scale, sizeof(record.scale));
+	memcpy(record.rotation, &nodeData.rotation, sizeof(record.rotation));
+	memcpy(record.translation, &nodeData.translation, sizeof(record.translation));
+	return record;
+}
+
+baked::MaterialRecord createMaterialRecord(const Model::Material& material, MetadataBuilder& builder)
+{
+	const Model::Material::InternalData& materialData = material.getInternalData();
+
+	baked::MaterialRecord record = {};
+	record.semantics = builder.addSemantics(materialData.materialSemantics);
+
+	std::vector<baked::TextureIndexRecord> textureIndices;
+	textureIndices.reserve(materialData.textureIndices.size());
+	for (const auto& textureIndex : materialData.textureIndices)
+	{
+		baked::TextureIndexRecord textureIndexRecord = {};
+		textureIndexRecord.semantic = builder.add(textureIndex.first);
+		textureIndexRecord.textureIndex = textureIndex.second;
+		textureIndices.push_back(textureIndexRecord);
+	}
+	record.textureIndices = builder.add(textureIndices);
+
+	record.name = builder.add(materialData.name);
+	record.effectFile = builder.add(materialData.effectFile);
+	record.effectName = builder.add(materialData.effectName);
+	record.userData = builder.add(materialData.userData);
+	record.formattedUserData = builder.addCustomData(materialData.formattedUserData);
+	return record;
+}
+
+baked::AnimationDataRecord createAnimationDataRecord(const AnimationData& animation, MetadataBuilder& builder)
+{
+	const AnimationData::InternalData& animationData = animation.getInternalData();
+
+	baked::AnimationDataRecord record = {};
+	std::vector<baked::KeyFrameRecord> keyFrames;
+	keyFrames.reserve(animationData.keyFrames.size());
+	for (const KeyFrameData& keyFrame : animationData.keyFrames)
+	{
+		baked::KeyFrameRecord keyFrameRecord = {};
+		keyFrameRecord.timeInSeconds = builder.add(keyFrame.timeInSeconds);
+		keyFrameRecord.scale = builder.add(keyFrame.scale);
+		keyFrameRecord.rotate = builder.add(keyFrame.rotate);
+		keyFrameRecord.translation = builder.add(keyFrame.translation);
+		keyFrameRecord.mat4 = builder.add(keyFrame.mat4);
+		keyFrameRecord.interpolation = static_cast<uint32_t>(keyFrame.interpolation);
+		keyFrames.push_back(keyFrameRecord);
+	}
+	record.keyFrames = builder.add(keyFrames);
+
+	record.name = builder.add(animationData.animationName);
+	record.positionIndices = builder.add(animationData.positionIndices);
+	record.rotationIndices = builder.add(animationData.rotationIndices);
+	record.scaleIndices = builder.add(animationData.scaleIndices);
+	record.matrixIndices = builder.add(animationData.matrixIndices);
+	record.timeInSeconds = builder.add(animationData.timeInSeconds);
+	record.formattedUserData = builder.addCustomData(animationData.formattedUserData);
+	record.flags = animationData.flags;
+	record.numFrames = animationData.numFrames;
+	record.startTime = animationData.startTime;
+	record.endTime = animationData.endTime;
+	return record;
+}
+
+baked::AnimationInstanceRecord createAnimationInstanceRecord(const Model::InternalData& modelData, const AnimationInstance& instance, MetadataBuilder& builder)
+{
+	const AnimationData* animations = modelData.animationsData.data();
+	if (instance.animationData < animations || instance.animationData >= animations + modelData.animationsData.size())
+	{ throw InvalidDataError("[writeBakedModel]: An animation instance references an animation that is not part of the model"); }
+
+	baked::AnimationInstanceRecord record = {};
+	record.animationData = static_cast<uint32_t>(instance.animationData - animations);
+
+	std::vector<baked::KeyframeChannelRecord> channels;
+	channels.reserve(instance.keyframeChannels.size());
+	std::vector<uint32_t> nodes;
+	for (const AnimationInstance::KeyframeChannel& channel : instance.keyframeChannels)
+	{
+		nodes.clear();
+		for (const void* node : channel.nodes) { nodes.push_back(getNodeIndex(modelData, node)); }
+		baked::KeyframeChannelRecord channelRecord = {};
+		channelRecord.nodes = builder.add(nodes);
+		channelRecord.keyFrame = channel.keyFrame;
+		channels.push_back(channelRecord);
+	}
+	record.keyframeChannels = builder.add(channels);
+	return record;
+}
+} // namespace
+
+void writeBakedModel(const Model& model, Stream& stream)
+{
+	const Model::InternalData& modelData = model.getInternalData();
+
+	// The vertex and index data come first, so that their offsets are known when the metadata referencing them is laid out.
+	std::vector<BulkData> bulkData;
+	std::vector<std::vector<baked::VertexBlockRecord>> vertexBlocks(modelData.meshes.size());
+	std::vector<baked::Range> faceData(modelData.meshes.size());
+	uint64_t offset = sizeof(baked::FileHeader);
+	auto addBulkData = [&](const void* data, size_t size) {
+		BulkData bulk;
+		bulk.data = data;
+		bulk.size = size;
+		bulk.offset = alignOffset(offset);
+		bulkData.push_back(bulk);
+		offset = bulk.offset + size;
+		baked::Range range;
+		range.offset = bulk.offset;
+		range.size = size;
+		return range;
+	};
+	for (size_t i = 0; i < modelData.meshes.size(); ++i)
+	{
+		const Mesh& mesh = modelData.meshes[i];
+		for (uint32_t j = 0; j < mesh.getNumDataElements(); ++j)
+		{
+			baked::VertexBlockRecord block = {};
+			block.data = addBulkData(mesh.getData(j), mesh.getDataSize(j));
+			block.stride = mesh.getStride(j);
+			vertexBlocks[i].push_back(block);
+		}
+		faceData[i] = addBulkData(mesh.getFaces().getData(), mesh.getFaces().getDataSize());
+	}
+	const uint64_t metadataOffset = alignOffset(offset);
+	MetadataBuilder builder(metadataOffset);
+
+	baked::FileHeader header = {};
+	memcpy(header.identifier, baked::c_identifier, sizeof(header.identifier));
+	header.version = baked::c_formatVersion;
+	header.byteOrderMark = baked::c_byteOrderMark;
+
+	baked::SceneRecord scene = {};
+	memcpy(scene.clearColor, modelData.clearColor, sizeof(scene.clearColor));
+	memcpy(scene.ambientColor, modelData.ambientColor, sizeof(scene.ambientColor));
+	scene.numMeshNodes = modelData.numMeshNodes;
+	scene.numLightNodes = modelData.numLightNodes;
+	scene.numCameraNodes = modelData.numCameraNodes;
+	scene.numFrames = modelData.numFrames;
+	scene.currentFrame = modelData.currentFrame;
+	scene.FPS = modelData.FPS;
+	scene.units = modelData.units;
+	scene.flags = modelData.flags;
+	scene.semantics = builder.addSemantics(modelData.semantics);
+	scene.userData = builder.add(modelData.userData);
+	scene.formattedUserData = builder.addCustomData(modelData.formattedUserData);
+	header.scene = builder.add(&scene, sizeof(scene));
+
+	std::vector<baked::MeshRecord> meshes;
+	meshes.reserve(modelData.meshes.size());
+	for (size_t i = 0; i < modelData.meshes.size(); ++i)
+	{
+		baked::MeshRecord record = createMeshRecord(modelData.meshes[i], builder);
+		record.vertexBlocks = builder.add(vertexBlocks[i]);
+		record.faceData = faceData[i];
+		meshes.push_back(record);
+	}
+	header.meshes = builder.add(meshes);
+
+	std::vector<baked::NodeRecord> nodes;
+	nodes.reserve(modelData.nodes.size());
+	for (const Node& node : modelData.nodes) { nodes.push_back(createNodeRecord(node, builder)); }
+	header.nodes = builder.add(nodes);
+
+	std::vector<baked::TextureRecord> textures;
+	textures.reserve(modelData.textures.size());
+	for (const Model::Texture& texture : modelData.textures)
+	{
+		baked::TextureRecord record = {};
+		record.name = builder.add(texture.getName());
+		textures.push_back(record);
+	}
+	header.textures = builder.add(textures);
+
+	std::vector<baked::MaterialRecord> materials;
+	materials.reserve(modelData.materials.size());
+	for (const Model::Material& material : modelData.materials) { materials.push_back(createMaterialRecord(material, builder)); }
+	header.materials = builder.add(materials);
+
+	std::vector<baked::CameraRecord> cameras;
+	cameras.reserve(modelData.cameras.size());
+	for (const Camera& camera : modelData.cameras)
+	{
+		baked::CameraRecord record = {};
+		record.targetNodeIndex = camera.getTargetNodeIndex();
+		record.farClip = camera.getFar();
+		record.nearClip = camera.getNear();
+		record.fovs = builder.add(camera.getInternalData().fovs);
+		record.formattedUserData = builder.addCustomData(camera.getFormattedUserData());
+		cameras.push_back(record);
+	}
+	header.cameras = builder.add(cameras);
+
+	std::vector<baked::LightRecord> lights;
+	lights.reserve(modelData.lights.size());
+	for (const Light& light : modelData.lights)
+	{
+		baked::LightRecord record = {};
+		record.spotTargetNodeIndex = light.getTargetIdx();
+		memcpy(record.color, &light.getColor(), sizeof(record.color));
+		record.type = static_cast<uint32_t>(light.getType());
+		record.constantAttenuation = light.getConstantAttenuation();
+		record.linearAttenuation = light.getLinearAttenuation();
+		record.quadraticAttenuation = light.getQuadraticAttenuation();
+		record.falloffAngle = light.getFalloffAngle();
+		record.falloffExponent = light.getFalloffExponent();
+		lights.push_back(record);
+	}
+	header.lights = builder.add(lights);
+
+	std::vector<baked::SkeletonRecord> skeletons;
+	skeletons.reserve(modelData.skeletons.size());
+	for (const Skeleton& skeleton : modelData.skeletons)
+	{
+		baked::SkeletonRecord record = {};
+		record.name = builder.add(skeleton.name);
+		record.bones = builder.add(skeleton.bones);
+		record.invBindMatrices = builder.add(skeleton.invBindMatrices);
+		skeletons.push_back(record);
+	}
+	header.skeletons = builder.add(skeletons);
+
+	std::vector<baked::AnimationDataRecord> animationsData;
+	animationsData.reserve(modelData.animationsData.size());
+	for (const AnimationData& animation : modelData.animationsData) { animationsData.push_back(createAnimationDataRecord(animation, builder)); }
+	header.animationsData = builder.add(animationsData);
+
+	std::vector<baked::AnimationInstanceRecord> animationInstances;
+	animationInstances.reserve(modelData.animationInstances.size());
+	for (const AnimationInstance& instance : modelData.animationInstances) { animationInstances.push_back(createAnimationInstanceRecord(modelData, instance, builder)); }
+	header.animationInstances = builder.add(animationInstances);
+
+	header.fileSize = metadataOffset + builder.getData().size();
+
+	uint64_t position = 0;
+	stream.writeExact(sizeof(header), 1, &header);
+	position += sizeof(header);
+	for (const BulkData& bulk : bulkData)
+	{
+		writePadding(stream, position, bulk.offset);
+		if (bulk.size) { stream.writeExact(1, bulk.size, bulk.data); }
+		position += bulk.size;
+	}
+	writePadding(stream, position, metadataOffset);
+	if (builder.getData().size()) { stream.writeExact(1, builder.getData().size(), builder.getData().data()); }
+}
+
+void writeBakedModel(const Model& model, Stream&& stream)
+{
+	Stream& str = stream;
+	writeBakedModel(model, str);
+}
+} // namespace assets
+} // namespace pvr
+//!\endcond
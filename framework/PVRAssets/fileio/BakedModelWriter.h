@@ -0,0 +1,31 @@
+/*!
+\brief Writes pvr::assets::Model objects into baked model files, load-ready caches of a model that can be read back with readBakedModel.
+\file PVRAssets/fileio/BakedModelWriter.h
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+#pragma once
+
+#include "PVRAssets/Model.h"
+#include "PVRCore/stream/Stream.h"
+
+namespace pvr {
+namespace assets {
+
+/// <summary>Write a model (for example, one loaded from a POD or glTF file) into a baked model file. A baked model stores the vertex and index data
+/// exactly as the model holds it, already interleaved and in the byte order of this machine, followed by the rest of the model (nodes, materials,
+/// animations, etc.) as arrays of fixed size records, so that readBakedModel can load it without parsing or converting anything. See
+/// BakedModelDefines.h for the layout.</summary>
+/// <param name="model">The model to write. Its user data pointers (getUserDataPtr) are not written.</param>
+/// <param name="stream">The stream to write to</param>
+/// <remarks>The file can only be read on machines of the same byte order as this one. Throws InvalidDataError if the model is inconsistent, e.g. an
+/// animation references a node of another model.</remarks>
+void writeBakedModel(const ::pvr::assets::Model& model, ::pvr::Stream& stream);
+
+/// <summary>Write a model into a baked model file.</summary>
+/// <param name="model">The model to write</param>
+/// <param name="stream">The stream to write to</param>
+void writeBakedModel(const ::pvr::assets::Model& model, ::pvr::Stream&& stream);
+
+} // namespace assets
+} // namespace pvr
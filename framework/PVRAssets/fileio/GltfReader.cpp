@@ -1,5 +1,6 @@
 #include "GltfReader.h"
 #include "PVRAssets/Model.h"
+#include "PVRAssets/fileio/JsonDocument.h"
 #include "PVRCore/stream/FilePath.h"
 #define TINYGLTF_IMPLEMENTATION
 #define TINYGLTF_NO_STB_IMAGE
@@ -52,6 +53,18 @@ pvr::IndexType tinyGltf_getIndexType(uint32_t tinyComponent)
 	return pvr::IndexType(uint32_t(-1));
 }
 
+// Rename the TEXCOORD semantics to UV (for compatibility with POD)
+std::string tinyGltf_getSemantic(const std::string& tinySemantic)
+{
+	if (pvr::strings::startsWith(tinySemantic, "TEXCOORD_"))
+	{
+		uint32_t index = 0;
+		const int r = sscanf(tinySemantic.c_str(), "TEXCOORD_%d", &index);
+		if (r == 1) { return pvr::strings::createFormatted("UV%d", index); }
+	}
+	return tinySemantic;
+}
+
 pvr::PrimitiveTopology tinyGltf_primitiveTopology(uint32_t primitiveTopology)
 {
 	if (primitiveTopology == TINYGLTF_MODE_POINTS) { return pvr::PrimitiveTopology::PointList; }
@@ -79,6 +92,35 @@ struct NodeMapping
 	NodeMapping() : node(nullptr) {}
 };
 
+// A glTF document: its structure, and the data of its buffers, which outlives the document if the meshes reference it.
+struct GltfDocument
+{
+	tinygltf::Model model;
+	// The data of each buffer. The data loaded by tinygltf is moved here out of the model, while readGlbDocument references the binary chunk of the file in place.
+	std::vector<std::shared_ptr<const unsigned char>> buffers;
+	// If true, the meshes reference the vertex and index data in the buffers instead of copying it.
+	bool referenceBuffers;
+
+	GltfDocument() : referenceBuffers(false) {}
+
+	const unsigned char* getBufferData(int buffer) const { return buffers[static_cast<size_t>(buffer)].get(); }
+
+	std::shared_ptr<const uint8_t> getSharedBufferData(int buffer, size_t offset) const
+	{
+		return std::shared_ptr<const uint8_t>(buffers[static_cast<size_t>(buffer)], buffers[static_cast<size_t>(buffer)].get() + offset);
+	}
+
+	void takeBuffersFromModel()
+	{
+		buffers.clear();
+		for (tinygltf::Buffer& tinyBuffer : model.buffers)
+		{
+			auto data = std::make_shared<std::vector<unsigned char>>(std::move(tinyBuffer.data));
+			buffers.emplace_back(data, data->data());
+		}
+	}
+};
+
 pvr::assets::CustomData gltfExtraToCustomData(const tinygltf::Value& value)
 {
 	switch (value.Type())
@@ -168,8 +210,9 @@ inline float normalizedSignedShortToFloat(signed short c) { return std::max(stat
 
 inline float normalizedUnSignedShortToFloat(unsigned short c) { return static_cast<float>(c) / 65535.f; }
 
-void parseAllAnimation(const tinygltf::Model& tinyModel, pvr::assets::Model& model, std::vector<NodeMapping>& nodeMapping)
+void parseAllAnimation(const GltfDocument& document, pvr::assets::Model& model, std::vector<NodeMapping>& nodeMapping)
 {
+	const tinygltf::Model& tinyModel = document.model;
 	model.allocateAnimationsData(static_cast<uint32_t>(tinyModel.animations.size()));
 	model.allocateAnimationInstances(static_cast<uint32_t>(tinyModel.animations.size()));
 
@@ -210,11 +253,11 @@ void parseAllAnimation(const tinygltf::Model& tinyModel, pvr::assets::Model& mod
 
 				// time in seconds
 				const tinygltf::BufferView& tinyInBufferView = tinyModel.bufferViews[static_cast<uint32_t>(tinyInAccessor.bufferView)];
-				const tinygltf::Buffer& tinyInBuffer = tinyModel.buffers[static_cast<uint32_t>(tinyInBufferView.buffer)];
+				const unsigned char* tinyInBufferData = document.getBufferData(tinyInBufferView.buffer);
 
 				// S/R/T
 				const tinygltf::BufferView& tinyOutBufferView = tinyModel.bufferViews[static_cast<uint32_t>(tinyOutAccessor.bufferView)];
-				const tinygltf::Buffer& tinyOutBuffer = tinyModel.buffers[static_cast<uint32_t>(tinyOutBufferView.buffer)];
+				const unsigned char* tinyOutBufferData = document.getBufferData(tinyOutBufferView.buffer);
 
 				if (tinyAnimSampler.interpolation == "LINEAR") { keyFrameData.interpolation = KeyFrameData::InterpolationType::Linear; }
 				else if (tinyAnimSampler.interpolation == "STEP")
@@ -231,7 +274,7 @@ void parseAllAnimation(const tinygltf::Model& tinyModel, pvr::assets::Model& mod
 				{
 					keyFrameData.timeInSeconds.resize(tinyInAccessor.count);
 
-					memcpy(&keyFrameData.timeInSeconds[0], tinyInBuffer.data.data() + tinyInAccessor.byteOffset + tinyInBufferView.byteOffset, sizeof(float) * tinyInAccessor.count);
+					memcpy(&keyFrameData.timeInSeconds[0], tinyInBufferData + tinyInAccessor.byteOffset + tinyInBufferView.byteOffset, sizeof(float) * tinyInAccessor.count);
 					durationTime = glm::max(durationTime, keyFrameData.timeInSeconds.back());
 				}
 
@@ -243,7 +286,7 @@ void parseAllAnimation(const tinygltf::Model& tinyModel, pvr::assets::Model& mod
 					keyFrameData.scale.resize(tinyOutAccessor.count);
 					animData.getInternalData().numFrames = std::max(animData.getNumFrames(), static_cast<uint32_t>(tinyOutAccessor.count));
 					// copy the data
-					memcpy(&keyFrameData.scale[0], tinyOutBuffer.data.data() + tinyOutAccessor.byteOffset + tinyOutBufferView.byteOffset, sizeof(float) * 3 * tinyOutAccessor.count);
+					memcpy(&keyFrameData.scale[0], tinyOutBufferData + tinyOutAccessor.byteOffset + tinyOutBufferView.byteOffset, sizeof(float) * 3 * tinyOutAccessor.count);
 				}
 				else if (targetPath == "rotation")
 				{
@@ -263,7 +306,7 @@ void parseAllAnimation(const tinygltf::Model& tinyModel, pvr::assets::Model& mod
 						for (uint32_t q = 0; q < tinyOutAccessor.count; ++q)
 						{
 							const std::size_t stride = tinyGltf_getTypeNumComponents(tinyOutAccessor.type) * tinyGltf_getComponentTypeToDataType(tinyOutAccessor.componentType).second;
-							const float* data = (const float*)(tinyOutBuffer.data.data() + tinyOutAccessor.byteOffset + tinyOutBufferView.byteOffset + (q * stride));
+							const float* data = (const float*)(tinyOutBufferData + tinyOutAccessor.byteOffset + tinyOutBufferView.byteOffset + (q * stride));
 
 							keyFrameData.rotate[q] = glm::quat(data[3], data[0], data[1], data[2]); // wxyz
 							keyFrameData.rotate[q] = glm::normalize(keyFrameData.rotate[q]);
@@ -274,7 +317,7 @@ void parseAllAnimation(const tinygltf::Model& tinyModel, pvr::assets::Model& mod
 						for (size_t q = 0; q < tinyOutAccessor.count; ++q)
 						{
 							const char* data =
-								(const char*)((tinyOutBuffer.data.data() + tinyOutAccessor.byteOffset + tinyOutBufferView.byteOffset + (q * tinyOutBufferView.byteStride)));
+								(const char*)((tinyOutBufferData + tinyOutAccessor.byteOffset + tinyOutBufferView.byteOffset + (q * tinyOutBufferView.byteStride)));
 
 							keyFrameData.rotate[q] = glm::quat(normalizedSignedByteToFloat(data[3]), normalizedSignedByteToFloat(data[0]), normalizedSignedByteToFloat(data[1]),
 								normalizedSignedByteToFloat(data[2]));
@@ -288,7 +331,7 @@ void parseAllAnimation(const tinygltf::Model& tinyModel, pvr::assets::Model& mod
 						for (size_t q = 0; q < tinyOutAccessor.count; ++q)
 						{
 							const char* data =
-								(const char*)(tinyOutBuffer.data.data() + tinyOutAccessor.byteOffset + tinyOutBufferView.byteOffset + (q * tinyOutBufferView.byteStride));
+								(const char*)(tinyOutBufferData + tinyOutAccessor.byteOffset + tinyOutBufferView.byteOffset + (q * tinyOutBufferView.byteStride));
 
 							keyFrameData.rotate[q] = glm::quat(normalizedUnSignedByteToFloat(data[3]), normalizedUnSignedByteToFloat(data[0]),
 								normalizedUnSignedByteToFloat(data[1]), normalizedUnSignedByteToFloat(data[2]));
@@ -301,7 +344,7 @@ void parseAllAnimation(const tinygltf::Model& tinyModel, pvr::assets::Model& mod
 						for (size_t q = 0; q < tinyOutAccessor.count; ++q)
 						{
 							const int16_t* data =
-								(const int16_t*)((tinyOutBuffer.data.data() + tinyOutAccessor.byteOffset + tinyOutBufferView.byteOffset + (q * tinyOutBufferView.byteStride)));
+								(const int16_t*)((tinyOutBufferData + tinyOutAccessor.byteOffset + tinyOutBufferView.byteOffset + (q * tinyOutBufferView.byteStride)));
 
 							keyFrameData.rotate[q] = glm::quat(normalizedSignedShortToFloat(data[3]), normalizedSignedShortToFloat(data[0]), normalizedSignedShortToFloat(data[1]),
 								normalizedSignedShortToFloat(data[2]));
@@ -314,7 +357,7 @@ void parseAllAnimation(const tinygltf::Model& tinyModel, pvr::assets::Model& mod
 						for (size_t q = 0; q < tinyOutAccessor.count; ++q)
 						{
 							const uint16_t* data =
-								(const uint16_t*)(tinyOutBuffer.data.data() + tinyOutAccessor.byteOffset + tinyOutBufferView.byteOffset + (q * tinyOutBufferView.byteStride));
+								(const uint16_t*)(tinyOutBufferData + tinyOutAccessor.byteOffset + tinyOutBufferView.byteOffset + (q * tinyOutBufferView.byteStride));
 
 							keyFrameData.rotate[q] = glm::quat(normalizedUnSignedShortToFloat(data[3]), normalizedUnSignedShortToFloat(data[0]),
 								normalizedUnSignedShortToFloat(data[1]), normalizedUnSignedShortToFloat(data[2]));
@@ -333,7 +376,7 @@ void parseAllAnimation(const tinygltf::Model& tinyModel, pvr::assets::Model& mod
 					keyFrameData.translation.resize(tinyOutAccessor.count);
 					animData.getInternalData().numFrames = std::max(animData.getNumFrames(), static_cast<uint32_t>(tinyOutAccessor.count));
 
-					memcpy(&keyFrameData.translation[0], tinyOutBuffer.data.data() + tinyOutAccessor.byteOffset + tinyOutBufferView.byteOffset, sizeof(float) * 3 * tinyOutAccessor.count);
+					memcpy(&keyFrameData.translation[0], tinyOutBufferData + tinyOutAccessor.byteOffset + tinyOutBufferView.byteOffset, sizeof(float) * 3 * tinyOutAccessor.count);
 				}
 				processedKeyFrame[static_cast<uint32_t>(tinyAnimChannel.sampler)] = true; // mark as processed
 			}
@@ -536,8 +579,9 @@ void parseAllTextureAndMaterials(const tinygltf::Model& tinyModel, pvr::assets::
 	}
 }
 
-void parseAllSkins(const tinygltf::Model& tinyModel, pvr::assets::Model& outModel, std::vector<NodeMapping>& nodeMapping)
+void parseAllSkins(const GltfDocument& document, pvr::assets::Model& outModel, std::vector<NodeMapping>& nodeMapping)
 {
+	const tinygltf::Model& tinyModel = document.model;
 	const size_t numSkins = tinyModel.skins.size();
 	if (numSkins == 0) { return; }
 
@@ -561,8 +605,7 @@ void parseAllSkins(const tinygltf::Model& tinyModel, pvr::assets::Model& outMode
 
 		const tinygltf::Accessor& tinyAccessor = tinyModel.accessors[tinySkin.inverseBindMatrices];
 		const tinygltf::BufferView& tinyView = tinyModel.bufferViews[tinyAccessor.bufferView];
-		const tinygltf::Buffer& tinyBuffer = tinyModel.buffers[tinyView.buffer];
-		const unsigned char* invBindMatData = tinyBuffer.data.data() + tinyAccessor.byteOffset + tinyView.byteOffset;
+		const unsigned char* invBindMatData = document.getBufferData(tinyView.buffer) + tinyAccessor.byteOffset + tinyView.byteOffset;
 		debug_assertion(tinySkin.joints.size() == tinyAccessor.count, "Number of joints must be equal to the number of inverseBindMatrices");
 
 		skeleton.invBindMatrices.resize(tinySkin.joints.size());
@@ -583,8 +626,89 @@ enum class VertexAttributeIndex
 	Count,
 };
 
-void parseAllMesh(const tinygltf::Model& tinyModel, pvr::assets::Model& asset, std::vector<MeshprimitivesIterator>& meshPrimitives)
+// Makes a mesh reference the vertex and index data of a primitive in place in the buffers of the document, instead of interleaving it into a copy. The
+// attributes sharing an interleaved buffer view share a data block, and each attribute of a tightly packed buffer view gets a block of its own.
+void referencePrimitiveData(const GltfDocument& document, const tinygltf::Primitive& tinyPrimitive, pvr::assets::Mesh& mesh)
 {
+	const tinygltf::Model& tinyModel = document.model;
+	auto& meshInfo = mesh.getMeshInfo();
+	meshInfo.min = glm::vec3(std::numeric_limits<float>::max());
+	meshInfo.max = glm::vec3(std::numeric_limits<float>::lowest());
+
+	struct DataBlock
+	{
+		int bufferView;
+		size_t offset;
+		size_t stride;
+		int32_t index;
+	};
+	std::vector<DataBlock> dataBlocks;
+	uint32_t numVertices = 0;
+
+	for (const auto& attrib : tinyPrimitive.attributes)
+	{
+		const tinygltf::Accessor& tinyAccessor = tinyModel.accessors[attrib.second];
+		const tinygltf::BufferView& tinyBufferView = tinyModel.bufferViews[tinyAccessor.bufferView];
+
+		// bounding box
+		if (attrib.first == "POSITION" && tinyAccessor.minValues.size() >= 3 && tinyAccessor.maxValues.size() >= 3)
+		{
+			meshInfo.min = glm::min(glm::vec3(tinyAccessor.minValues[0], tinyAccessor.minValues[1], tinyAccessor.minValues[2]), meshInfo.min);
+			meshInfo.max = glm::max(glm::vec3(tinyAccessor.maxValues[0], tinyAccessor.maxValues[1], tinyAccessor.maxValues[2]), meshInfo.max);
+		}
+
+		const std::pair<pvr::DataType, size_t> dataType = tinyGltf_getComponentTypeToDataType(tinyAccessor.componentType);
+		const uint32_t numComponents = tinyGltf_getTypeNumComponents(tinyAccessor.type);
+		const size_t stride = tinyBufferView.byteStride ? tinyBufferView.byteStride : numComponents * dataType.second;
+		// In an interleaved view the block starts at the vertex containing the attribute, so that all the attributes of the vertex share it.
+		const size_t blockOffset = tinyBufferView.byteStride ? tinyAccessor.byteOffset - tinyAccessor.byteOffset % stride : tinyAccessor.byteOffset;
+
+		auto block = std::find_if(dataBlocks.begin(), dataBlocks.end(),
+			[&](const DataBlock& b) { return b.bufferView == tinyAccessor.bufferView && b.offset == blockOffset && b.stride == stride; });
+		if (block == dataBlocks.end())
+		{
+			const size_t size = std::min(tinyAccessor.count * stride, tinyBufferView.byteLength - blockOffset);
+			const int32_t index = mesh.addExternalData(
+				document.getSharedBufferData(tinyBufferView.buffer, tinyBufferView.byteOffset + blockOffset), static_cast<uint32_t>(size), static_cast<uint32_t>(stride));
+			block = dataBlocks.insert(dataBlocks.end(), DataBlock{ tinyAccessor.bufferView, blockOffset, stride, index });
+		}
+
+		pvr::assets::VertexAttributeData attribData;
+		attribData.setN(static_cast<uint8_t>(numComponents));
+		attribData.setDataType(dataType.first);
+		attribData.setDataIndex(static_cast<uint16_t>(block->index));
+		attribData.setOffset(static_cast<uint32_t>(tinyAccessor.byteOffset - blockOffset));
+		attribData.setSemantic(tinyGltf_getSemantic(attrib.first));
+		mesh.addVertexAttribute(attribData);
+		numVertices = static_cast<uint32_t>(tinyAccessor.count);
+	}
+	mesh.setNumVertices(numVertices);
+
+	if (tinyPrimitive.indices != -1)
+	{
+		const tinygltf::Accessor& tinyAccessor = tinyModel.accessors[tinyPrimitive.indices];
+		const tinygltf::BufferView& tinyBufferView = tinyModel.bufferViews[tinyAccessor.bufferView];
+		const size_t offset = tinyBufferView.byteOffset + tinyAccessor.byteOffset;
+
+		if (tinyAccessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE)
+		{
+			// 8 bit indices are not supported by the framework, so they are widened to 16 bit.
+			const unsigned char* indices = document.getBufferData(tinyBufferView.buffer) + offset;
+			std::vector<uint16_t> wideIndices(indices, indices + tinyAccessor.count);
+			mesh.addFaces(reinterpret_cast<const uint8_t*>(wideIndices.data()), static_cast<uint32_t>(wideIndices.size() * sizeof(uint16_t)), pvr::IndexType::IndexType16Bit);
+		}
+		else
+		{
+			const pvr::IndexType indexType = tinyGltf_getIndexType(tinyAccessor.componentType);
+			mesh.addExternalFaces(document.getSharedBufferData(tinyBufferView.buffer, offset),
+				static_cast<uint32_t>((indexType == pvr::IndexType::IndexType16Bit ? sizeof(uint16_t) : sizeof(uint32_t)) * tinyAccessor.count), indexType);
+		}
+	}
+}
+
+void parseAllMesh(const GltfDocument& document, pvr::assets::Model& asset, std::vector<MeshprimitivesIterator>& meshPrimitives)
+{
+	const tinygltf::Model& tinyModel = document.model;
 	uint32_t meshIndex = 0;
 	const auto& tinyAccessors = tinyModel.accessors;
 
@@ -617,6 +741,13 @@ void parseAllMesh(const tinygltf::Model& tinyModel, pvr::assets::Model& asset, s
 			const tinygltf::Primitive& tinyPrimitive = tinyMesh.primitives[p];
 			mesh.setPrimitiveType(tinyGltf_primitiveTopology(static_cast<int32_t>(tinyPrimitive.mode)));
 
+			if (document.referenceBuffers)
+			{
+				referencePrimitiveData(document, tinyPrimitive, mesh);
+				++meshIndex; // next mesh
+				continue;
+			}
+
 			// VERTEX ATTRIBUTES
 			uint32_t numvertices = 0;
 
@@ -634,7 +765,6 @@ void parseAllMesh(const tinygltf::Model& tinyModel, pvr::assets::Model& asset, s
 			{
 				const tinygltf::Accessor& tinyAccessor = tinyAccessors[attrib.second];
 				const tinygltf::BufferView& tinyBufferView = tinyModel.bufferViews[tinyAccessor.bufferView];
-				const tinygltf::Buffer& tinyBuffer = tinyModel.buffers[tinyBufferView.buffer];
 
 				// bounding box
 				if (attrib.first == "POSITION")
@@ -644,7 +774,7 @@ void parseAllMesh(const tinygltf::Model& tinyModel, pvr::assets::Model& asset, s
 				}
 
 				gltfAttributes.push_back(GltfAttribute());
-				gltfAttributes.back().data = tinyBuffer.data.data() + tinyBufferView.byteOffset + tinyAccessor.byteOffset;
+				gltfAttributes.back().data = document.getBufferData(tinyBufferView.buffer) + tinyBufferView.byteOffset + tinyAccessor.byteOffset;
 				gltfAttributes.back().strideInBytes = tinyBufferView.byteStride
 					? static_cast<uint32_t>(tinyBufferView.byteStride)
 					: tinyGltf_getTypeNumComponents(tinyAccessor.type) * tinyGltf_getComponentTypeToDataType(tinyAccessor.componentType).second;
@@ -684,16 +814,7 @@ void parseAllMesh(const tinygltf::Model& tinyModel, pvr::assets::Model& asset, s
 								attribData.setDataType(tinyAttrib.dataType.first);
 								attribData.setDataIndex(0);
 								attribData.setOffset(bufferOffset);
-
-								std::string semantic = tinyAttrib.semantic;
-								// Rename the TEXCOORD semantic to UV (for compatibility with POD)
-								if (pvr::strings::startsWith(semantic, "TEXCOORD_"))
-								{
-									uint32_t index = 0;
-									const int r = sscanf(semantic.c_str(), "TEXCOORD_%d", &index);
-									if (r == 1) { semantic = pvr::strings::createFormatted("UV%d", index); }
-								}
-								attribData.setSemantic(semantic);
+								attribData.setSemantic(tinyGltf_getSemantic(tinyAttrib.semantic));
 								mesh.addVertexAttribute(attribData);
 							}
 
@@ -710,10 +831,9 @@ void parseAllMesh(const tinygltf::Model& tinyModel, pvr::assets::Model& asset, s
 			{
 				const tinygltf::Accessor& tinyAccessor = tinyAccessors[tinyPrimitive.indices];
 				const tinygltf::BufferView& tinyBufferView = tinyModel.bufferViews[tinyAccessor.bufferView];
-				const tinygltf::Buffer& tinyBuffer = tinyModel.buffers[tinyBufferView.buffer];
 
 				pvr::IndexType indexType = tinyGltf_getIndexType(tinyAccessor.componentType);
-				mesh.addFaces(tinyBuffer.data.data() + tinyBufferView.byteOffset + tinyAccessor.byteOffset,
+				mesh.addFaces(document.getBufferData(tinyBufferView.buffer) + tinyBufferView.byteOffset + tinyAccessor.byteOffset,
 					(indexType == pvr::IndexType::IndexType16Bit ? sizeof(uint16_t) : sizeof(uint32_t)) * static_cast<uint32_t>(tinyAccessor.count), indexType);
 			}
 
@@ -775,6 +895,471 @@ public:
 private:
 	const pvr::IAssetProvider* assetProvider;
 };
+
+// Binary glTF (.glb) documents are read without tinygltf. Their JSON chunk is parsed in place by a JsonDocument, and only the parts of the tinygltf model
+// used by the conversion above are filled, with the same semantics as tinygltf. The members below are read with their defaults if they are missing.
+int getMemberInt(const JsonDocument& json, uint32_t object, const char* key, int defaultValue)
+{
+	const uint32_t value = json.findMember(object, key);
+	if (value == JsonDocument::InvalidToken || json.getType(value) != JsonDocument::Type::Number) { return defaultValue; }
+	const double number = json.getNumber(value);
+	if (!(number >= static_cast<double>(std::numeric_limits<int>::min()) && number <= static_cast<double>(std::numeric_limits<int>::max())))
+	{ throw InvalidDataError(std::string("[GltfReader::readGlbDocument]: Invalid value of ") + key); }
+	return static_cast<int>(number);
+}
+
+size_t getMemberSize(const JsonDocument& json, uint32_t object, const char* key, size_t defaultValue)
+{
+	const uint32_t value = json.findMember(object, key);
+	if (value == JsonDocument::InvalidToken || json.getType(value) != JsonDocument::Type::Number) { return defaultValue; }
+	const double number = json.getNumber(value);
+	if (!(number >= 0. && number <= static_cast<double>(std::numeric_limits<uint32_t>::max())))
+	{ throw InvalidDataError(std::string("[GltfReader::readGlbDocument]: Invalid value of ") + key); }
+	return static_cast<size_t>(number);
+}
+
+double getMemberDouble(const JsonDocument& json, uint32_t object, const char* key, double defaultValue)
+{
+	const uint32_t value = json.findMember(object, key);
+	return value != JsonDocument::InvalidToken && json.getType(value) == JsonDocument::Type::Number ? json.getNumber(value) : defaultValue;
+}
+
+bool getMemberBool(const JsonDocument& json, uint32_t object, const char* key, bool defaultValue)
+{
+	const uint32_t value = json.findMember(object, key);
+	return value != JsonDocument::InvalidToken && json.getType(value) == JsonDocument::Type::Bool ? json.getBool(value) : defaultValue;
+}
+
+std::string getMemberString(const JsonDocument& json, uint32_t object, const char* key, const char* defaultValue = "")
+{
+	const uint32_t value = json.findMember(object, key);
+	return value != JsonDocument::InvalidToken && json.getType(value) == JsonDocument::Type::String ? json.getString(value) : std::string(defaultValue);
+}
+
+// The first element of an array member of an object, to iterate over with getNextSibling, or InvalidToken if there is no such array.
+uint32_t getFirstElement(const JsonDocument& json, uint32_t object, const char* key)
+{
+	const uint32_t value = json.findMember(object, key);
+	return value != JsonDocument::InvalidToken && json.getType(value) == JsonDocument::Type::Array ? json.getFirstChild(value) : JsonDocument::InvalidToken;
+}
+
+void getMemberNumbers(const JsonDocument& json, uint32_t object, const char* key, std::vector<double>& numbers)
+{
+	numbers.clear();
+	for (uint32_t element = getFirstElement(json, object, key); element != JsonDocument::InvalidToken; element = json.getNextSibling(element))
+	{
+		if (json.getType(element) != JsonDocument::Type::Number) { throw InvalidDataError(std::string("[GltfReader::readGlbDocument]: Expected an array of numbers in ") + key); }
+		numbers.push_back(json.getNumber(element));
+	}
+}
+
+void getMemberIndices(const JsonDocument& json, uint32_t object, const char* key, size_t numItems, std::vector<int>& indices)
+{
+	indices.clear();
+	for (uint32_t element = getFirstElement(json, object, key); element != JsonDocument::InvalidToken; element = json.getNextSibling(element))
+	{
+		const double number = json.getType(element) == JsonDocument::Type::Number ? json.getNumber(element) : -1.;
+		if (!(number >= 0. && number < static_cast<double>(numItems))) { throw InvalidDataError(std::string("[GltfReader::readGlbDocument]: Invalid index in ") + key); }
+		indices.push_back(static_cast<int>(number));
+	}
+}
+
+// Checks an optional index (-1 if missing) into an array of the document.
+int checkIndex(int index, size_t numItems, const char* key)
+{
+	if (index < -1 || index >= static_cast<int>(numItems)) { throw InvalidDataError(std::string("[GltfReader::readGlbDocument]: Invalid index in ") + key); }
+	return index;
+}
+
+tinygltf::Value jsonToValue(const JsonDocument& json, uint32_t token)
+{
+	switch (json.getType(token))
+	{
+	case JsonDocument::Type::Bool: return tinygltf::Value(json.getBool(token));
+	case JsonDocument::Type::Number: {
+		const double number = json.getNumber(token);
+		if (json.isInteger(token) && number >= static_cast<double>(std::numeric_limits<int>::min()) && number <= static_cast<double>(std::numeric_limits<int>::max()))
+		{ return tinygltf::Value(static_cast<int>(number)); }
+		return tinygltf::Value(number);
+	}
+	case JsonDocument::Type::String: return tinygltf::Value(json.getString(token));
+	case JsonDocument::Type::Object: {
+		tinygltf::Value::Object object;
+		for (uint32_t key = json.getFirstChild(token); key != JsonDocument::InvalidToken; key = json.getNextSibling(key))
+		{
+			if (json.getType(key + 1) != JsonDocument::Type::Null) { object[json.getString(key)] = jsonToValue(json, key + 1); }
+		}
+		return tinygltf::Value(object);
+	}
+	case JsonDocument::Type::Array: {
+		// As in tinygltf, the numbers of arrays are always doubles, and nested arrays, booleans and nulls are null values.
+		tinygltf::Value::Array array;
+		for (uint32_t element = json.getFirstChild(token); element != JsonDocument::InvalidToken; element = json.getNextSibling(element))
+		{
+			const JsonDocument::Type type = json.getType(element);
+			if (type == JsonDocument::Type::Number) { array.push_back(tinygltf::Value(json.getNumber(element))); }
+			else if (type == JsonDocument::Type::String || type == JsonDocument::Type::Object)
+			{
+				array.push_back(jsonToValue(json, element));
+			}
+			else
+			{
+				array.push_back(tinygltf::Value());
+			}
+		}
+		return tinygltf::Value(array);
+	}
+	default: return tinygltf::Value();
+	}
+}
+
+void getMemberExtras(const JsonDocument& json, uint32_t object, tinygltf::Value& extras)
+{
+	const uint32_t value = json.findMember(object, "extras");
+	if (value != JsonDocument::InvalidToken && json.getType(value) == JsonDocument::Type::Object) { extras = jsonToValue(json, value); }
+}
+
+bool jsonToParameter(const JsonDocument& json, uint32_t token, tinygltf::Parameter& parameter)
+{
+	switch (json.getType(token))
+	{
+	case JsonDocument::Type::Bool: parameter.bool_value = json.getBool(token); return true;
+	case JsonDocument::Type::Number:
+		parameter.number_value = json.getNumber(token);
+		parameter.has_number_value = true;
+		return true;
+	case JsonDocument::Type::String: parameter.string_value = json.getString(token); return true;
+	case JsonDocument::Type::Array:
+		for (uint32_t element = json.getFirstChild(token); element != JsonDocument::InvalidToken; element = json.getNextSibling(element))
+		{
+			if (json.getType(element) != JsonDocument::Type::Number) { return false; }
+			parameter.number_array.push_back(json.getNumber(element));
+		}
+		return true;
+	case JsonDocument::Type::Object:
+		// e.g. texture infos, of which only the numeric members are kept.
+		for (uint32_t key = json.getFirstChild(token); key != JsonDocument::InvalidToken; key = json.getNextSibling(key))
+		{
+			if (json.getType(key + 1) == JsonDocument::Type::Number) { parameter.json_double_value[json.getString(key)] = json.getNumber(key + 1); }
+		}
+		return true;
+	default: return false;
+	}
+}
+
+void getMemberParameters(const JsonDocument& json, uint32_t object, tinygltf::ParameterMap& parameters)
+{
+	if (object == JsonDocument::InvalidToken || json.getType(object) != JsonDocument::Type::Object) { return; }
+	for (uint32_t key = json.getFirstChild(object); key != JsonDocument::InvalidToken; key = json.getNextSibling(key))
+	{
+		tinygltf::Parameter parameter{};
+		if (jsonToParameter(json, key + 1, parameter)) { parameters[json.getString(key)] = parameter; }
+	}
+}
+
+int jsonToAccessorType(const std::string& type)
+{
+	if (type == "SCALAR") { return TINYGLTF_TYPE_SCALAR; }
+	if (type == "VEC2") { return TINYGLTF_TYPE_VEC2; }
+	if (type == "VEC3") { return TINYGLTF_TYPE_VEC3; }
+	if (type == "VEC4") { return TINYGLTF_TYPE_VEC4; }
+	if (type == "MAT2") { return TINYGLTF_TYPE_MAT2; }
+	if (type == "MAT3") { return TINYGLTF_TYPE_MAT3; }
+	if (type == "MAT4") { return TINYGLTF_TYPE_MAT4; }
+	throw InvalidDataError("[GltfReader::readGlbDocument]: Invalid accessor type " + type);
+}
+
+uint32_t readLittleEndian32(const unsigned char* data) { return data[0] | (data[1] << 8) | (data[2] << 16) | (static_cast<uint32_t>(data[3]) << 24); }
+
+// Reads a binary glTF file into a document whose meshes reference the binary chunk of the file in place, rather than copying it like tinygltf does. The
+// accessors and buffer views are validated against their buffers, so that the meshes cannot reference memory outside them. Returns false, leaving the
+// document empty, for the buffers embedded in data URIs, which are rare in binary files and are left to tinygltf.
+bool readGlbDocument(const std::shared_ptr<const unsigned char>& fileData, size_t fileSize, const std::string& dir, GltfFileLoader& fileLoader, GltfDocument& document)
+{
+	// Header (magic, version, length), followed by chunks (length, type, data): the JSON chunk first, then the optional binary chunk.
+	const unsigned char* file = fileData.get();
+	if (readLittleEndian32(file + 4) != 2) { throw InvalidDataError("[GltfReader::readGlbDocument]: Unsupported binary glTF version"); }
+	const size_t length = readLittleEndian32(file + 8);
+	if (length > fileSize || length < 20) { throw InvalidDataError("[GltfReader::readGlbDocument]: Truncated binary glTF file"); }
+	const size_t jsonLength = readLittleEndian32(file + 12);
+	if (readLittleEndian32(file + 16) != 0x4E4F534A || jsonLength > length - 20) { throw InvalidDataError("[GltfReader::readGlbDocument]: Invalid JSON chunk"); }
+
+	std::shared_ptr<const unsigned char> binaryChunk;
+	size_t binaryChunkLength = 0;
+	const size_t binaryChunkHeader = 20 + ((jsonLength + 3) & ~static_cast<size_t>(3));
+	if (binaryChunkHeader + 8 <= length && readLittleEndian32(file + binaryChunkHeader + 4) == 0x004E4942)
+	{
+		binaryChunkLength = readLittleEndian32(file + binaryChunkHeader);
+		if (binaryChunkLength > length - binaryChunkHeader - 8) { throw InvalidDataError("[GltfReader::readGlbDocument]: Truncated binary chunk"); }
+		binaryChunk = std::shared_ptr<const unsigned char>(fileData, file + binaryChunkHeader + 8);
+	}
+
+	const JsonDocument json(reinterpret_cast<const char*>(file + 20), jsonLength);
+	const uint32_t root = json.getRoot();
+	if (json.getType(root) != JsonDocument::Type::Object) { throw InvalidDataError("[GltfReader::readGlbDocument]: The JSON chunk is not an object"); }
+	tinygltf::Model& model = document.model;
+
+	// BUFFERS. The first one, without a URI, is the binary chunk.
+	std::vector<size_t> bufferSizes;
+	for (uint32_t o = getFirstElement(json, root, "buffers"); o != JsonDocument::InvalidToken; o = json.getNextSibling(o))
+	{
+		const uint32_t uri = json.findMember(o, "uri");
+		if (uri == JsonDocument::InvalidToken)
+		{
+			const size_t byteLength = getMemberSize(json, o, "byteLength", 0);
+			if (!binaryChunk || byteLength > binaryChunkLength) { throw InvalidDataError("[GltfReader::readGlbDocument]: Invalid binary chunk buffer"); }
+			document.buffers.push_back(binaryChunk);
+			bufferSizes.push_back(byteLength);
+		}
+		else
+		{
+			const std::string uriString = json.getString(uri);
+			if (pvr::strings::startsWith(uriString, "data:"))
+			{
+				document = GltfDocument();
+				return false;
+			}
+			std::vector<unsigned char> data;
+			std::string err;
+			if (!fileLoader.loadExternalFile(&data, &err, uriString, dir, 0, false)) { throw pvr::FileNotFoundError(uriString); }
+			auto sharedData = std::make_shared<std::vector<unsigned char>>(std::move(data));
+			document.buffers.emplace_back(sharedData, sharedData->data());
+			bufferSizes.push_back(sharedData->size());
+		}
+	}
+	// The data is in document.buffers: the buffers of the model are only kept so that they can be counted.
+	model.buffers.resize(document.buffers.size());
+
+	// BUFFER VIEWS
+	for (uint32_t o = getFirstElement(json, root, "bufferViews"); o != JsonDocument::InvalidToken; o = json.getNextSibling(o))
+	{
+		tinygltf::BufferView view;
+		view.buffer = getMemberInt(json, o, "buffer", -1);
+		view.byteOffset = getMemberSize(json, o, "byteOffset", 0);
+		view.byteLength = getMemberSize(json, o, "byteLength", 0);
+		view.byteStride = getMemberSize(json, o, "byteStride", 0);
+		view.target = getMemberInt(json, o, "target", 0);
+		if (view.buffer < 0 || view.buffer >= static_cast<int>(bufferSizes.size()) || view.byteOffset + view.byteLength > bufferSizes[static_cast<size_t>(view.buffer)])
+		{ throw InvalidDataError("[GltfReader::readGlbDocument]: Buffer view out of the bounds of its buffer"); }
+		model.bufferViews.push_back(view);
+	}
+
+	// ACCESSORS. Sparse accessors, and accessors without a buffer view, are not supported (as in tinygltf).
+	for (uint32_t o = getFirstElement(json, root, "accessors"); o != JsonDocument::InvalidToken; o = json.getNextSibling(o))
+	{
+		tinygltf::Accessor accessor;
+		accessor.bufferView = getMemberInt(json, o, "bufferView", -1);
+		accessor.byteOffset = getMemberSize(json, o, "byteOffset", 0);
+		accessor.normalized = getMemberBool(json, o, "normalized", false);
+		accessor.componentType = getMemberInt(json, o, "componentType", 0);
+		accessor.count = getMemberSize(json, o, "count", 0);
+		accessor.type = jsonToAccessorType(getMemberString(json, o, "type"));
+		getMemberNumbers(json, o, "min", accessor.minValues);
+		getMemberNumbers(json, o, "max", accessor.maxValues);
+		getMemberExtras(json, o, accessor.extras);
+
+		if (accessor.bufferView < 0 || accessor.bufferView >= static_cast<int>(model.bufferViews.size()))
+		{ throw InvalidDataError("[GltfReader::readGlbDocument]: Accessors without a buffer view are not supported"); }
+		if (accessor.componentType < TINYGLTF_COMPONENT_TYPE_BYTE || accessor.componentType > TINYGLTF_COMPONENT_TYPE_FLOAT)
+		{ throw InvalidDataError("[GltfReader::readGlbDocument]: Invalid accessor component type"); }
+		const tinygltf::BufferView& view = model.bufferViews[static_cast<size_t>(accessor.bufferView)];
+		const size_t elementSize = tinyGltf_getTypeNumComponents(accessor.type) * tinyGltf_getComponentTypeToDataType(accessor.componentType).second;
+		const size_t stride = view.byteStride ? view.byteStride : elementSize;
+		if (accessor.byteOffset > view.byteLength || (accessor.count && uint64_t(accessor.count - 1) * stride + elementSize > view.byteLength - accessor.byteOffset))
+		{ throw InvalidDataError("[GltfReader::readGlbDocument]: Accessor out of the bounds of its buffer view"); }
+		model.accessors.push_back(accessor);
+	}
+	const size_t numAccessors = model.accessors.size();
+	const uint32_t nodes = json.findMember(root, "nodes");
+	const size_t numNodes = nodes != JsonDocument::InvalidToken && json.getType(nodes) == JsonDocument::Type::Array ? json.getNumChildren(nodes) : 0;
+
+	// MESHES
+	for (uint32_t o = getFirstElement(json, root, "meshes"); o != JsonDocument::InvalidToken; o = json.getNextSibling(o))
+	{
+		tinygltf::Mesh mesh;
+		mesh.name = getMemberString(json, o, "name");
+		for (uint32_t p = getFirstElement(json, o, "primitives"); p != JsonDocument::InvalidToken; p = json.getNextSibling(p))
+		{
+			const uint32_t attributes = json.findMember(p, "attributes");
+			if (attributes == JsonDocument::InvalidToken || json.getType(attributes) != JsonDocument::Type::Object) { continue; }
+
+			tinygltf::Primitive primitive;
+			primitive.material = getMemberInt(json, p, "material", -1);
+			primitive.indices = checkIndex(getMemberInt(json, p, "indices", -1), numAccessors, "indices");
+			primitive.mode = getMemberInt(json, p, "mode", TINYGLTF_MODE_TRIANGLES);
+			for (uint32_t key = json.getFirstChild(attributes); key != JsonDocument::InvalidToken; key = json.getNextSibling(key))
+			{
+				const double accessor = json.getType(key + 1) == JsonDocument::Type::Number ? json.getNumber(key + 1) : -1.;
+				if (!(accessor >= 0. && accessor < static_cast<double>(numAccessors))) { throw InvalidDataError("[GltfReader::readGlbDocument]: Invalid index in attributes"); }
+				primitive.attributes[json.getString(key)] = static_cast<int>(accessor);
+			}
+			if (primitive.indices != -1)
+			{
+				const int componentType = model.accessors[static_cast<size_t>(primitive.indices)].componentType;
+				if (componentType != TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE && componentType != TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT &&
+					componentType != TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT)
+				{ throw InvalidDataError("[GltfReader::readGlbDocument]: Invalid index component type"); }
+			}
+			getMemberExtras(json, p, primitive.extras);
+			mesh.primitives.push_back(primitive);
+		}
+		getMemberExtras(json, o, mesh.extras);
+		model.meshes.push_back(mesh);
+	}
+
+	// CAMERAS
+	for (uint32_t o = getFirstElement(json, root, "cameras"); o != JsonDocument::InvalidToken; o = json.getNextSibling(o))
+	{
+		tinygltf::Camera camera;
+		camera.type = getMemberString(json, o, "type");
+		camera.name = getMemberString(json, o, "name");
+		const uint32_t perspective = json.findMember(o, "perspective");
+		if (perspective != JsonDocument::InvalidToken)
+		{
+			camera.perspective.aspectRatio = static_cast<float>(getMemberDouble(json, perspective, "aspectRatio", 0.));
+			camera.perspective.yfov = static_cast<float>(getMemberDouble(json, perspective, "yfov", 0.));
+			camera.perspective.zfar = static_cast<float>(getMemberDouble(json, perspective, "zfar", 0.));
+			camera.perspective.znear = static_cast<float>(getMemberDouble(json, perspective, "znear", 0.));
+			getMemberExtras(json, perspective, camera.perspective.extras);
+		}
+		const uint32_t orthographic = json.findMember(o, "orthographic");
+		if (orthographic != JsonDocument::InvalidToken)
+		{
+			camera.orthographic.xmag = static_cast<float>(getMemberDouble(json, orthographic, "xmag", 0.));
+			camera.orthographic.ymag = static_cast<float>(getMemberDouble(json, orthographic, "ymag", 0.));
+			camera.orthographic.zfar = static_cast<float>(getMemberDouble(json, orthographic, "zfar", 0.));
+			camera.orthographic.znear = static_cast<float>(getMemberDouble(json, orthographic, "znear", 0.));
+			getMemberExtras(json, orthographic, camera.orthographic.extras);
+		}
+		getMemberExtras(json, o, camera.extras);
+		model.cameras.push_back(camera);
+	}
+
+	// SKINS
+	for (uint32_t o = getFirstElement(json, root, "skins"); o != JsonDocument::InvalidToken; o = json.getNextSibling(o))
+	{
+		tinygltf::Skin skin;
+		skin.name = getMemberString(json, o, "name");
+		skin.skeleton = getMemberInt(json, o, "skeleton", -1);
+		skin.inverseBindMatrices = checkIndex(getMemberInt(json, o, "inverseBindMatrices", -1), numAccessors, "inverseBindMatrices");
+		getMemberIndices(json, o, "joints", numNodes, skin.joints);
+		if (skin.inverseBindMatrices == -1) { throw InvalidDataError("[GltfReader::readGlbDocument]: Skins without inverse bind matrices are not supported"); }
+		const tinygltf::Accessor& accessor = model.accessors[static_cast<size_t>(skin.inverseBindMatrices)];
+		if (accessor.type != TINYGLTF_TYPE_MAT4 || accessor.componentType != TINYGLTF_COMPONENT_TYPE_FLOAT || accessor.count != skin.joints.size())
+		{ throw InvalidDataError("[GltfReader::readGlbDocument]: The inverse bind matrices of a skin must be one float 4x4 matrix per joint"); }
+		model.skins.push_back(skin);
+	}
+
+	// NODES
+	for (uint32_t o = getFirstElement(json, root, "nodes"); o != JsonDocument::InvalidToken; o = json.getNextSibling(o))
+	{
+		tinygltf::Node node;
+		node.name = getMemberString(json, o, "name");
+		node.camera = checkIndex(getMemberInt(json, o, "camera", -1), model.cameras.size(), "camera");
+		node.mesh = checkIndex(getMemberInt(json, o, "mesh", -1), model.meshes.size(), "mesh");
+		node.skin = checkIndex(getMemberInt(json, o, "skin", -1), model.skins.size(), "skin");
+		getMemberIndices(json, o, "children", numNodes, node.children);
+		getMemberNumbers(json, o, "matrix", node.matrix);
+		getMemberNumbers(json, o, "rotation", node.rotation);
+		getMemberNumbers(json, o, "scale", node.scale);
+		getMemberNumbers(json, o, "translation", node.translation);
+		getMemberNumbers(json, o, "weights", node.weights);
+		if ((!node.matrix.empty() && node.matrix.size() != 16) || (!node.rotation.empty() && node.rotation.size() != 4) || (!node.scale.empty() && node.scale.size() != 3) ||
+			(!node.translation.empty() && node.translation.size() != 3))
+		{ throw InvalidDataError("[GltfReader::readGlbDocument]: Invalid node transformation"); }
+		getMemberExtras(json, o, node.extras);
+		getMemberParameters(json, json.findMember(json.findMember(o, "extensions"), "KHR_lights_cmn"), node.extLightsValues);
+		model.nodes.push_back(node);
+	}
+
+	// SCENES
+	for (uint32_t o = getFirstElement(json, root, "scenes"); o != JsonDocument::InvalidToken; o = json.getNextSibling(o))
+	{
+		tinygltf::Scene scene;
+		scene.name = getMemberString(json, o, "name");
+		getMemberIndices(json, o, "nodes", numNodes, scene.nodes);
+		getMemberExtras(json, o, scene.extras);
+		model.scenes.push_back(scene);
+	}
+
+	// ANIMATIONS
+	for (uint32_t o = getFirstElement(json, root, "animations"); o != JsonDocument::InvalidToken; o = json.getNextSibling(o))
+	{
+		tinygltf::Animation animation;
+		animation.name = getMemberString(json, o, "name");
+		for (uint32_t s = getFirstElement(json, o, "samplers"); s != JsonDocument::InvalidToken; s = json.getNextSibling(s))
+		{
+			tinygltf::AnimationSampler sampler;
+			sampler.input = checkIndex(getMemberInt(json, s, "input", -1), numAccessors, "input");
+			sampler.output = checkIndex(getMemberInt(json, s, "output", -1), numAccessors, "output");
+			sampler.interpolation = getMemberString(json, s, "interpolation", "LINEAR");
+			if (sampler.input == -1 || sampler.output == -1) { throw InvalidDataError("[GltfReader::readGlbDocument]: Animation sampler without input or output"); }
+			animation.samplers.push_back(sampler);
+		}
+		for (uint32_t c = getFirstElement(json, o, "channels"); c != JsonDocument::InvalidToken; c = json.getNextSibling(c))
+		{
+			tinygltf::AnimationChannel channel;
+			channel.sampler = checkIndex(getMemberInt(json, c, "sampler", -1), animation.samplers.size(), "sampler");
+			const uint32_t target = json.findMember(c, "target");
+			channel.target_node = checkIndex(getMemberInt(json, target, "node", -1), numNodes, "node");
+			channel.target_path = getMemberString(json, target, "path");
+			getMemberExtras(json, c, channel.extras);
+			if (channel.sampler == -1) { throw InvalidDataError("[GltfReader::readGlbDocument]: Animation channel without a sampler"); }
+			// As in tinygltf, the channels without a target node (which may be animated by extensions) are ignored.
+			if (channel.target_node != -1) { animation.channels.push_back(channel); }
+		}
+		getMemberExtras(json, o, animation.extras);
+		model.animations.push_back(animation);
+	}
+
+	// IMAGES AND TEXTURES. Images embedded in buffer views are not loaded, and have no URI.
+	for (uint32_t o = getFirstElement(json, root, "images"); o != JsonDocument::InvalidToken; o = json.getNextSibling(o))
+	{
+		tinygltf::Image image;
+		image.name = getMemberString(json, o, "name");
+		image.uri = getMemberString(json, o, "uri");
+		image.mimeType = getMemberString(json, o, "mimeType");
+		image.bufferView = checkIndex(getMemberInt(json, o, "bufferView", -1), model.bufferViews.size(), "bufferView");
+		getMemberExtras(json, o, image.extras);
+		model.images.push_back(image);
+	}
+	for (uint32_t o = getFirstElement(json, root, "textures"); o != JsonDocument::InvalidToken; o = json.getNextSibling(o))
+	{
+		tinygltf::Texture texture;
+		texture.sampler = getMemberInt(json, o, "sampler", -1);
+		texture.source = checkIndex(getMemberInt(json, o, "source", -1), model.images.size(), "source");
+		getMemberExtras(json, o, texture.extras);
+		model.textures.push_back(texture);
+	}
+
+	// MATERIALS. The members of the PBR metallic roughness object go to the values, the members of the extensions to the extension values, and the other
+	// members to the additional values. Unlike tinygltf, which only reads the first extension, the members of all the extensions are read.
+	for (uint32_t o = getFirstElement(json, root, "materials"); o != JsonDocument::InvalidToken; o = json.getNextSibling(o))
+	{
+		tinygltf::Material material;
+		material.name = getMemberString(json, o, "name");
+		for (uint32_t key = json.getType(o) == JsonDocument::Type::Object ? json.getFirstChild(o) : JsonDocument::InvalidToken; key != JsonDocument::InvalidToken; key = json.getNextSibling(key))
+		{
+			if (json.equals(key, "pbrMetallicRoughness")) { getMemberParameters(json, key + 1, material.values); }
+			else if (json.equals(key, "extensions"))
+			{
+				if (json.getType(key + 1) != JsonDocument::Type::Object) { continue; }
+				for (uint32_t extension = json.getFirstChild(key + 1); extension != JsonDocument::InvalidToken; extension = json.getNextSibling(extension))
+				{ getMemberParameters(json, extension + 1, material.extPBRValues); }
+			}
+			else
+			{
+				tinygltf::Parameter parameter{};
+				if (jsonToParameter(json, key + 1, parameter)) { material.additionalValues[json.getString(key)] = parameter; }
+			}
+		}
+		getMemberExtras(json, o, material.extras);
+		model.materials.push_back(material);
+	}
+
+	document.referenceBuffers = true;
+	return true;
+}
 } // namespace
 Model readGLTF(const ::pvr::Stream& stream, const IAssetProvider& assetProvider)
 {
@@ -787,27 +1372,46 @@ void readGLTF(const ::pvr::Stream& stream, const IAssetProvider& assetProvider,
 	/// IMPLEMENTATION NOTES
 	// Mesh: GLTF has number of primitives in a mesh and each of those can have different properties, like materials, primitive topology.
 	//       Each of the primitives are considered as mesh in the framework.
+	// Binary: .glb files are read by readGlbDocument, and their meshes reference the binary chunk of the file (memory mapped if the stream allows it)
+	//       instead of copying it. Other files are read by tinygltf, and their vertex data is interleaved into a copy.
 	//
-	tinygltf::Model tinyModel;
-	tinygltf::TinyGLTF tinyLoader;
-	std::string err;
-	std::vector<char> data = stream.readToEnd<char>();
-	uint32_t findIndex = static_cast<uint32_t>(stream.getFileName().find_last_of("."));
-	std::string ext = stream.getFileName().substr(findIndex, std::string::npos);
 	std::string dir;
 	pvr::strings::getFileDirectory(stream.getFileName(), dir);
 
 	GltfFileLoader gltfStreamProvider(assetProvider);
 
-	if (!tinyLoader.LoadASCIIFromString(
-			gltfStreamProvider, &tinyModel, &err, static_cast<const char*>(data.data()), static_cast<uint32_t>(data.size()), dir, tinygltf::SectionCheck::NO_REQUIRE))
+	const size_t fileSize = static_cast<size_t>(stream.getSize() - stream.getPosition());
+	std::shared_ptr<const unsigned char> fileData = stream.getSharedDataPointer();
+	if (!fileData)
+	{
+		auto data = std::make_shared<std::vector<unsigned char>>(stream.readToEnd<unsigned char>());
+		fileData = std::shared_ptr<const unsigned char>(data, data->data());
+	}
+
+	GltfDocument document;
+	const bool isBinary = fileSize >= 20 && memcmp(fileData.get(), "glTF", 4) == 0;
+	if (!isBinary || !readGlbDocument(fileData, fileSize, dir, gltfStreamProvider, document))
 	{
-		Log("%s", err.c_str());
-		throw pvr::FileNotFoundError(err);
+		tinygltf::TinyGLTF tinyLoader;
+		std::string err;
+		const bool loaded = isBinary
+			? tinyLoader.LoadBinaryFromMemory(gltfStreamProvider, &document.model, &err, fileData.get(), static_cast<uint32_t>(fileSize), dir, tinygltf::SectionCheck::NO_REQUIRE)
+			: tinyLoader.LoadASCIIFromString(gltfStreamProvider, &document.model, &err, reinterpret_cast<const char*>(fileData.get()), static_cast<uint32_t>(fileSize), dir,
+				  tinygltf::SectionCheck::NO_REQUIRE);
+		if (!loaded)
+		{
+			Log("%s", err.c_str());
+			throw pvr::FileNotFoundError(err);
+		}
+		document.takeBuffersFromModel();
 	}
+	tinygltf::Model& tinyModel = document.model;
 
-	auto extraData = gltfExtraToCustomData(tinyModel.scenes[0].extras);
-	asset.getFormattedUserData() = extraData;
+	if (!tinyModel.scenes.empty())
+	{
+		auto extraData = gltfExtraToCustomData(tinyModel.scenes[0].extras);
+		asset.getFormattedUserData() = extraData;
+	}
 
 	// Count total number of meshes
 	uint32_t totalNumMeshes = 0;
@@ -843,7 +1447,7 @@ void readGLTF(const ::pvr::Stream& stream, const IAssetProvider& assetProvider,
 	// Keep a list which maps between the gltf mesh with the framework meshes.
 	// For each gltf meshes there must be at least 1 or more (more than one primitives) framework meshes.
 	std::vector<MeshprimitivesIterator> meshPrimitives(tinyModel.meshes.size());
-	parseAllMesh(tinyModel, asset, meshPrimitives);
+	parseAllMesh(document, asset, meshPrimitives);
 
 	uint32_t cameraNodeIndex = 0;
 
@@ -863,13 +1467,13 @@ void readGLTF(const ::pvr::Stream& stream, const IAssetProvider& assetProvider,
 	}
 
 	//  Animation
-	parseAllAnimation(tinyModel, asset, nodeMappings);
+	parseAllAnimation(document, asset, nodeMappings);
 
 	// Texture and materials
 	parseAllTextureAndMaterials(tinyModel, asset);
 
 	// Skins
-	parseAllSkins(tinyModel, asset, nodeMappings);
+	parseAllSkins(document, asset, nodeMappings);
 
 	// Cameras
 	parseAllCameras(tinyModel, asset);
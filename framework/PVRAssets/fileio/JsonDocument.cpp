@@ -0,0 +1,390 @@
+/*!
+\brief Implementation of the JsonDocument class.
+\file PVRAssets/fileio/JsonDocument.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+#include "PVRAssets/fileio/JsonDocument.h"
+#include "PVRCore/Errors.h"
+#include "PVRCore/strings/StringFunctions.h"
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <locale>
+#include <sstream>
+
+namespace pvr {
+namespace assets {
+constexpr uint32_t JsonDocument::InvalidToken;
+
+namespace {
+// Protects the recursive parser against stack exhaustion on malicious input. Real documents are a handful of levels deep.
+const uint32_t MaxDepth = 512;
+
+inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+std::istringstream createClassicStream()
+{
+	std::istringstream stream;
+	stream.imbue(std::locale::classic());
+	return stream;
+}
+
+inline int32_t hexDigitValue(char c)
+{
+	if (c >= '0' && c <= '9') { return c - '0'; }
+	if (c >= 'a' && c <= 'f') { return c - 'a' + 10; }
+	if (c >= 'A' && c <= 'F') { return c - 'A' + 10; }
+	return -1;
+}
+
+uint32_t readHex4(const char* text)
+{
+	uint32_t value = 0;
+	for (uint32_t i = 0; i < 4; ++i) { value = (value << 4) | static_cast<uint32_t>(hexDigitValue(text[i])); }
+	return value;
+}
+
+void appendUtf8(std::string& out, uint32_t codePoint)
+{
+	if (codePoint < 0x80) { out += static_cast<char>(codePoint); }
+	else if (codePoint < 0x800)
+	{
+		out += static_cast<char>(0xC0 | (codePoint >> 6));
+		out += static_cast<char>(0x80 | (codePoint & 0x3F));
+	}
+	else if (codePoint < 0x10000)
+	{
+		out += static_cast<char>(0xE0 | (codePoint >> 12));
+		out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+		out += static_cast<char>(0x80 | (codePoint & 0x3F));
+	}
+	else
+	{
+		out += static_cast<char>(0xF0 | (codePoint >> 18));
+		out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+		out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+		out += static_cast<char>(0x80 | (codePoint & 0x3F));
+	}
+}
+} // namespace
+
+JsonDocument::JsonDocument(const char* text, size_t size) : _text(text), _size(0), _position(0)
+{
+	if (size >= InvalidToken) { throw InvalidDataError("[JsonDocument]: The text is too large"); }
+	_size = static_cast<uint32_t>(size);
+	// Every token but the last takes at least two characters (e.g. "0,"), and typical documents average far more, so this rarely needs to grow.
+	_tokens.reserve(_size / 8 + 1);
+
+	skipWhitespace();
+	parseValue(0);
+	skipWhitespace();
+	// Tolerate padding with null characters after the root value, as written by some exporters.
+	while (_position < _size && _text[_position] == '\0') { ++_position; }
+	if (_position != _size) { throwError("Unexpected character after the root value"); }
+}
+
+uint32_t JsonDocument::findMember(uint32_t object, const char* key) const
+{
+	if (object == InvalidToken || _tokens[object].type != Type::Object) { return InvalidToken; }
+	for (uint32_t member = getFirstChild(object); member != InvalidToken; member = getNextSibling(member))
+	{
+		if (equals(member, key)) { return member + 1; }
+	}
+	return InvalidToken;
+}
+
+uint32_t JsonDocument::getElement(uint32_t array, uint32_t index) const
+{
+	if (array == InvalidToken || _tokens[array].type != Type::Array) { return InvalidToken; }
+	uint32_t element = getFirstChild(array);
+	for (uint32_t i = 0; i < index && element != InvalidToken; ++i) { element = getNextSibling(element); }
+	return element;
+}
+
+bool JsonDocument::equals(uint32_t token, const char* str) const
+{
+	const Token& t = _tokens[token];
+	if (t.type != Type::String) { return false; }
+	if (t.hasEscapes) { return getString(token) == str; }
+	return strlen(str) == t.length && memcmp(_text + t.start, str, t.length) == 0;
+}
+
+std::string JsonDocument::getString(uint32_t token) const
+{
+	const Token& t = _tokens[token];
+	if (t.type != Type::String) { return std::string(); }
+	if (!t.hasEscapes) { return std::string(_text + t.start, t.length); }
+
+	std::string retval;
+	retval.reserve(t.length);
+	const char* c = _text + t.start;
+	const char* const end = c + t.length;
+	while (c != end)
+	{
+		if (*c != '\\')
+		{
+			retval += *c++;
+			continue;
+		}
+		++c;
+		switch (*c++)
+		{
+		case 'b': retval += '\b'; break;
+		case 'f': retval += '\f'; break;
+		case 'n': retval += '\n'; break;
+		case 'r': retval += '\r'; break;
+		case 't': retval += '\t'; break;
+		case 'u': {
+			uint32_t codePoint = readHex4(c);
+			c += 4;
+			// A high surrogate followed by a low surrogate encodes a code point above U+FFFF. Unpaired surrogates are replaced.
+			if (codePoint >= 0xD800 && codePoint < 0xDC00 && end - c >= 6 && c[0] == '\\' && c[1] == 'u')
+			{
+				const uint32_t low = readHex4(c + 2);
+				if (low >= 0xDC00 && low < 0xE000)
+				{
+					codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+					c += 6;
+				}
+			}
+			if (codePoint >= 0xD800 && codePoint < 0xE000) { codePoint = 0xFFFD; }
+			appendUtf8(retval, codePoint);
+			break;
+		}
+		default: retval += c[-1]; break; // '"', '\\' and '/'
+		}
+	}
+	return retval;
+}
+
+double JsonDocument::getNumber(uint32_t token) const
+{
+	const Token& t = _tokens[token];
+	if (t.type != Type::Number) { return 0.; }
+	const char* c = _text + t.start;
+	const char* end = c + t.length;
+
+	// Most numbers in glTF (indices, counts, offsets) are small integers, which are converted exactly without going through a stream.
+	const bool negative = *c == '-';
+	const char* digits = negative ? c + 1 : c;
+	if (end - digits <= 15 && isInteger(token))
+	{
+		double retval = 0.;
+		for (const char* d = digits; d != end; ++d) { retval = retval * 10. + (*d - '0'); }
+		return negative ? -retval : retval;
+	}
+
+	// strtod and atof follow the global C locale, under which the decimal separator may be a comma. The JSON grammar always uses a point. The stream is
+	// kept per thread, as constructing and imbuing one costs more than the conversion.
+	thread_local std::istringstream stream = createClassicStream();
+	stream.clear();
+	stream.str(std::string(c, t.length));
+	double retval = 0.;
+	stream >> retval;
+	// Streams saturate out of range values, where strtod returns an infinity.
+	if (stream.fail() && std::abs(retval) == (std::numeric_limits<double>::max)()) { retval = retval < 0. ? -HUGE_VAL : HUGE_VAL; }
+	return retval;
+}
+
+bool JsonDocument::isInteger(uint32_t token) const
+{
+	const Token& t = _tokens[token];
+	if (t.type != Type::Number) { return false; }
+	for (uint32_t i = 0; i < t.length; ++i)
+	{
+		const char c = _text[t.start + i];
+		if (c == '.' || c == 'e' || c == 'E') { return false; }
+	}
+	return true;
+}
+
+uint32_t JsonDocument::addToken(Type type, uint32_t start)
+{
+	Token token;
+	token.start = start;
+	token.length = 0;
+	token.numChildren = 0;
+	token.nextSibling = InvalidToken;
+	token.type = type;
+	token.hasEscapes = false;
+	_tokens.push_back(token);
+	return static_cast<uint32_t>(_tokens.size() - 1);
+}
+
+void JsonDocument::skipWhitespace()
+{
+	while (_position < _size)
+	{
+		const char c = _text[_position];
+		if (c != ' ' && c != '\t' && c != '\n' && c != '\r') { break; }
+		++_position;
+	}
+}
+
+void JsonDocument::throwError(const char* message) const
+{
+	throw InvalidDataError(strings::createFormatted("[JsonDocument]: %s at offset %u", message, _position));
+}
+
+uint32_t JsonDocument::parseValue(uint32_t depth)
+{
+	if (_position >= _size) { throwError("Unexpected end of text"); }
+	const char c = _text[_position];
+	if (c == '"') { return parseString(); }
+	if (c == 't')
+	{
+		parseLiteral("true", Type::Bool);
+		return static_cast<uint32_t>(_tokens.size() - 1);
+	}
+	if (c == 'f')
+	{
+		parseLiteral("false", Type::Bool);
+		return static_cast<uint32_t>(_tokens.size() - 1);
+	}
+	if (c == 'n')
+	{
+		parseLiteral("null", Type::Null);
+		return static_cast<uint32_t>(_tokens.size() - 1);
+	}
+	if (c == '-' || isDigit(c))
+	{
+		parseNumber();
+		return static_cast<uint32_t>(_tokens.size() - 1);
+	}
+	if (c != '{' && c != '[') { throwError("Unexpected character"); }
+	if (depth >= MaxDepth) { throwError("Values nested too deeply"); }
+
+	// Arrays and objects. Only indices are kept across the recursive calls, as they may grow the token array.
+	const bool isObject = (c == '{');
+	const char closing = isObject ? '}' : ']';
+	const uint32_t container = addToken(isObject ? Type::Object : Type::Array, _position);
+	++_position;
+	skipWhitespace();
+
+	uint32_t numChildren = 0;
+	uint32_t previousChild = InvalidToken;
+	if (_position < _size && _text[_position] == closing) { ++_position; }
+	else
+	{
+		for (;;)
+		{
+			uint32_t child;
+			if (isObject)
+			{
+				if (_position >= _size || _text[_position] != '"') { throwError("Expected a key"); }
+				child = parseString();
+				skipWhitespace();
+				if (_position >= _size || _text[_position] != ':') { throwError("Expected ':'"); }
+				++_position;
+				skipWhitespace();
+				parseValue(depth + 1);
+			}
+			else
+			{
+				child = parseValue(depth + 1);
+			}
+			if (previousChild != InvalidToken) { _tokens[previousChild].nextSibling = child; }
+			previousChild = child;
+			++numChildren;
+
+			skipWhitespace();
+			if (_position >= _size) { throwError("Unexpected end of text"); }
+			if (_text[_position] == closing)
+			{
+				++_position;
+				break;
+			}
+			if (_text[_position] != ',') { throwError(isObject ? "Expected ',' or '}'" : "Expected ',' or ']'"); }
+			++_position;
+			skipWhitespace();
+		}
+	}
+	_tokens[container].numChildren = numChildren;
+	_tokens[container].length = _position - _tokens[container].start;
+	return container;
+}
+
+uint32_t JsonDocument::parseString()
+{
+	const uint32_t token = addToken(Type::String, _position + 1);
+	bool hasEscapes = false;
+	++_position;
+	for (;;)
+	{
+		if (_position >= _size) { throwError("Unterminated string"); }
+		const char c = _text[_position];
+		if (c == '"') { break; }
+		if (static_cast<unsigned char>(c) < 0x20) { throwError("Control character in string"); }
+		if (c == '\\')
+		{
+			hasEscapes = true;
+			if (++_position >= _size) { throwError("Unterminated string"); }
+			switch (_text[_position])
+			{
+			case '"':
+			case '\\':
+			case '/':
+			case 'b':
+			case 'f':
+			case 'n':
+			case 'r':
+			case 't': break;
+			case 'u':
+				if (_size - _position <= 4) { throwError("Unterminated string"); }
+				for (uint32_t i = 1; i <= 4; ++i)
+				{
+					if (hexDigitValue(_text[_position + i]) < 0) { throwError("Invalid unicode escape sequence"); }
+				}
+				_position += 4;
+				break;
+			default: throwError("Invalid escape sequence");
+			}
+		}
+		++_position;
+	}
+	_tokens[token].length = _position - _tokens[token].start;
+	_tokens[token].hasEscapes = hasEscapes;
+	++_position; // Closing quote
+	return token;
+}
+
+void JsonDocument::parseNumber()
+{
+	const uint32_t start = _position;
+	if (_text[_position] == '-') { ++_position; }
+	if (_position >= _size || !isDigit(_text[_position])) { throwError("Invalid number"); }
+	if (_text[_position] == '0') { ++_position; }
+	else
+	{
+		while (_position < _size && isDigit(_text[_position])) { ++_position; }
+	}
+	if (_position < _size && _text[_position] == '.')
+	{
+		++_position;
+		if (_position >= _size || !isDigit(_text[_position])) { throwError("Invalid number"); }
+		while (_position < _size && isDigit(_text[_position])) { ++_position; }
+	}
+	if (_position < _size && (_text[_position] == 'e' || _text[_position] == 'E'))
+	{
+		++_position;
+		if (_position < _size && (_text[_position] == '+' || _text[_position] == '-')) { ++_position; }
+		if (_position >= _size || !isDigit(_text[_position])) { throwError("Invalid number"); }
+		while (_position < _size && isDigit(_text[_position])) { ++_position; }
+	}
+	const uint32_t token = addToken(Type::Number, start);
+	_tokens[token].length = _position - start;
+}
+
+void JsonDocument::parseLiteral(const char* literal, Type type)
+{
+	const uint32_t length = static_cast<uint32_t>(strlen(literal));
+	if (_size - _position < length || memcmp(_text + _position, literal, length) != 0) { throwError("Invalid literal"); }
+	const uint32_t token = addToken(type, _position);
+	_tokens[token].length = length;
+	_position += length;
+}
+} // namespace assets
+} // namespace pvr
+//!\endcond
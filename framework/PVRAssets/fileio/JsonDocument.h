@@ -0,0 +1,135 @@
+/*!
+\brief Contains a lightweight, read only JSON parser producing a flat array of tokens.
+\file PVRAssets/fileio/JsonDocument.h
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace pvr {
+namespace assets {
+
+/// <summary>A JSON document parsed into a single flat array of tokens, in document order, which reference the text in place. Parsing allocates nothing
+/// but the token array: strings are only unescaped and numbers only converted when they are read, and keys are compared without being copied. The text must
+/// outlive the document.
+///
+/// A token is identified by its index. The children of an array are its elements. The children of an object are the keys of its members, each
+/// immediately followed by its value: the value of the member whose key is token k is token k + 1.</summary>
+class JsonDocument
+{
+public:
+	/// <summary>The type of a JSON value.</summary>
+	enum class Type : uint8_t
+	{
+		Null,
+		Bool,
+		Number,
+		String,
+		Array,
+		Object
+	};
+
+	/// <summary>The index returned when a token does not exist.</summary>
+	static constexpr uint32_t InvalidToken = 0xFFFFFFFFu;
+
+	/// <summary>Constructor. Parses a JSON text. Throws InvalidDataError if the text is not valid JSON.</summary>
+	/// <param name="text">The text. Does not need to be null terminated. Must outlive the document.</param>
+	/// <param name="size">The size of the text, in bytes</param>
+	JsonDocument(const char* text, size_t size);
+
+	/// <summary>Get the root value of the document.</summary>
+	/// <returns>The root token</returns>
+	uint32_t getRoot() const { return 0; }
+
+	/// <summary>Get the type of a token.</summary>
+	/// <param name="token">The token</param>
+	/// <returns>The type of the token. Keys are strings.</returns>
+	Type getType(uint32_t token) const { return _tokens[token].type; }
+
+	/// <summary>Get the number of elements of an array or members of an object.</summary>
+	/// <param name="token">The array or object</param>
+	/// <returns>The number of children, 0 for other types</returns>
+	uint32_t getNumChildren(uint32_t token) const { return _tokens[token].numChildren; }
+
+	/// <summary>Get the first element of an array, or the key of the first member of an object.</summary>
+	/// <param name="token">The array or object</param>
+	/// <returns>The first child, or InvalidToken if there is none</returns>
+	uint32_t getFirstChild(uint32_t token) const { return _tokens[token].numChildren ? token + 1 : InvalidToken; }
+
+	/// <summary>Get the next element of the array, or the key of the next member of the object, containing a token.</summary>
+	/// <param name="token">An element, or the key of a member</param>
+	/// <returns>The next child of the same parent, or InvalidToken if token is the last one</returns>
+	uint32_t getNextSibling(uint32_t token) const { return _tokens[token].nextSibling; }
+
+	/// <summary>Find the value of a member of an object.</summary>
+	/// <param name="object">The object. If it is not an object, the member is not found.</param>
+	/// <param name="key">The key of the member</param>
+	/// <returns>The value of the member, or InvalidToken if the object has no such member</returns>
+	uint32_t findMember(uint32_t object, const char* key) const;
+
+	/// <summary>Get an element of an array. Linear in the index.</summary>
+	/// <param name="array">The array</param>
+	/// <param name="index">The index of the element</param>
+	/// <returns>The element, or InvalidToken if the array is too short or not an array</returns>
+	uint32_t getElement(uint32_t array, uint32_t index) const;
+
+	/// <summary>Compare a string token (e.g. a key) to a string, without copying it.</summary>
+	/// <param name="token">The token</param>
+	/// <param name="str">The null terminated string to compare to</param>
+	/// <returns>True if the token is a string equal to str</returns>
+	bool equals(uint32_t token, const char* str) const;
+
+	/// <summary>Get the value of a string token, unescaped.</summary>
+	/// <param name="token">The token</param>
+	/// <returns>The UTF-8 string, or an empty string if the token is not a string</returns>
+	std::string getString(uint32_t token) const;
+
+	/// <summary>Get the value of a number token.</summary>
+	/// <param name="token">The token</param>
+	/// <returns>The number, or 0 if the token is not a number</returns>
+	double getNumber(uint32_t token) const;
+
+	/// <summary>Get whether a number token is written as an integer, i.e. without a fraction or exponent.</summary>
+	/// <param name="token">The token</param>
+	/// <returns>True if the token is an integer number</returns>
+	bool isInteger(uint32_t token) const;
+
+	/// <summary>Get the value of a boolean token.</summary>
+	/// <param name="token">The token</param>
+	/// <returns>The boolean, or false if the token is not a boolean</returns>
+	bool getBool(uint32_t token) const { return _tokens[token].type == Type::Bool && _text[_tokens[token].start] == 't'; }
+
+	/// <summary>Get the number of tokens in the document.</summary>
+	/// <returns>The number of tokens</returns>
+	uint32_t getNumTokens() const { return static_cast<uint32_t>(_tokens.size()); }
+
+private:
+	struct Token
+	{
+		uint32_t start; // The offset of the first character of the token in the text. For strings, the first character after the opening quote.
+		uint32_t length; // The length of the token in the text. For strings, without the quotes.
+		uint32_t numChildren;
+		uint32_t nextSibling;
+		Type type;
+		bool hasEscapes; // Strings only: whether the string contains escape sequences, so it cannot be compared in place
+	};
+
+	uint32_t parseValue(uint32_t depth);
+	uint32_t parseString();
+	void parseNumber();
+	void parseLiteral(const char* literal, Type type);
+	uint32_t addToken(Type type, uint32_t start);
+	void skipWhitespace();
+	void throwError(const char* message) const;
+
+	const char* _text;
+	uint32_t _size;
+	uint32_t _position;
+	std::vector<Token> _tokens;
+};
+} // namespace assets
+} // namespace pvr
@@ -146,6 +146,25 @@ inline bool read4BytesChecked(const Stream& stream, T& data)
 
 inline bool readTag(const Stream& stream, uint32_t& identifier, uint32_t& dataLength) { return read4BytesChecked(stream, identifier) && read4BytesChecked(stream, dataLength); }
 
+static bool isLittleEndian()
+{
+	short int word = 0x0001;
+	char ret;
+	memcpy(&ret, &word, sizeof(char));
+	return ret ? true : false;
+}
+
+// If the stream is directly addressable in memory (e.g. a MappedFileStream) and the data does not need byte swapping, return a pointer that
+// references the next dataLength bytes of the stream and skip past them. Otherwise return null, leaving the stream untouched.
+std::shared_ptr<const uint8_t> borrowStreamData(const Stream& stream, uint32_t dataLength)
+{
+	if (!dataLength || !isLittleEndian()) { return nullptr; }
+	std::shared_ptr<const unsigned char> data = stream.getSharedDataPointer();
+	if (!data || stream.getSize64() - stream.getPosition64() < dataLength) { return nullptr; }
+	stream.seek(static_cast<long>(dataLength), Stream::SeekOriginFromCurrent);
+	return data;
+}
+
 inline void printMat4(const glm::mat4& mat4, const char* msg)
 {
 	std::string fmtStr(msg);
@@ -163,12 +182,17 @@ void readVertexIndexData(const Stream& stream, assets::Mesh& mesh)
 {
 	uint32_t identifier, dataLength, size(0);
 	std::vector<uint8_t> data;
+	std::shared_ptr<const uint8_t> sharedData;
 	IndexType type(IndexType::IndexType16Bit);
 	while (readTag(stream, identifier, dataLength))
 	{
 		if (identifier == (pod::e_meshVertexIndexList | pod::c_endTagMask))
 		{
-			mesh.addFaces(data.data(), size, type);
+			if (sharedData) { mesh.addExternalFaces(std::move(sharedData), size, type); }
+			else
+			{
+				mesh.addFaces(data.data(), size, type);
+			}
 			return;
 		}
 		switch (identifier)
@@ -189,10 +213,14 @@ void readVertexIndexData(const Stream& stream, assets::Mesh& mesh)
 			continue;
 		}
 		case pod::e_blockData:
-			switch (type)
+			sharedData = borrowStreamData(stream, dataLength);
+			if (!sharedData)
 			{
-			case IndexType::IndexType16Bit: read2ByteArrayIntoVector<uint16_t>(stream, data, dataLength / 2); break;
-			case IndexType::IndexType32Bit: read4ByteArrayIntoVector<uint32_t>(stream, data, dataLength / 4); break;
+				switch (type)
+				{
+				case IndexType::IndexType16Bit: read2ByteArrayIntoVector<uint16_t>(stream, data, dataLength / 2); break;
+				case IndexType::IndexType32Bit: read4ByteArrayIntoVector<uint32_t>(stream, data, dataLength / 4); break;
+				}
 			}
 			size = dataLength;
 			break;
@@ -241,18 +269,24 @@ void readVertexData(const Stream& stream, assets::Mesh& mesh, const char* const
 		case pod::e_blockData:
 			if (dataIndex == -1) // This POD file isn't using interleaved data so this data block must be valid vertex data
 			{
-				std::vector<uint8_t> data;
-				switch (dataTypeSize(type))
-				{
-				case 1: readByteArrayIntoVector<uint8_t>(stream, data, dataLength); break;
-				case 2: read2ByteArrayIntoVector<uint16_t>(stream, data, dataLength / 2); break;
-				case 4: read2ByteArrayIntoVector<uint32_t>(stream, data, dataLength / 4); break;
-				default:
+				if (dataTypeSize(type) > 4) { throw InvalidDataError("[PODReader::readVertexData] : Vertex DataType width was >4"); }
+				std::shared_ptr<const uint8_t> sharedData = borrowStreamData(stream, dataLength);
+				if (sharedData) { dataIndex = mesh.addExternalData(std::move(sharedData), dataLength, stride); }
+				else
 				{
-					throw InvalidDataError("[PODReader::readVertexData] : Vertex DataType width was >4");
+					std::vector<uint8_t> data;
+					switch (dataTypeSize(type))
+					{
+					case 1: readByteArrayIntoVector<uint8_t>(stream, data, dataLength); break;
+					case 2: read2ByteArrayIntoVector<uint16_t>(stream, data, dataLength / 2); break;
+					case 4: read4ByteArrayIntoVector<uint32_t>(stream, data, dataLength / 4); break;
+					default:
+					{
+						throw InvalidDataError("[PODReader::readVertexData] : Vertex DataType width was >4");
+					}
+					}
+					dataIndex = mesh.addData(data.data(), dataLength, stride);
 				}
-				}
-				dataIndex = mesh.addData(data.data(), dataLength, stride);
 			}
 			else
 			{
@@ -742,14 +776,6 @@ static void fixInterleavedEndiannessUsingVertexData(StridedBuffer& interleaved,
 	};
 }
 
-static bool isLittleEndian()
-{
-	short int word = 0x0001;
-	char ret;
-	memcpy(&ret, &word, sizeof(char));
-	return ret ? true : false;
-}
-
 static void fixInterleavedEndianness(assets::Mesh::InternalData& data, int32_t interleavedDataIndex)
 {
 	if (interleavedDataIndex == -1 || isLittleEndian()) { return; }
@@ -789,12 +815,13 @@ struct BoneBatches
 
 struct DataCarrier
 {
-	uint8_t* indexData;
+	const uint8_t* indexData;
 	uint8_t* vertexData;
 	size_t vboStride;
 	size_t attribOffset;
 	size_t indexDataSize;
 	size_t valueToAddToVertices;
+	std::vector<bool>* processedVertices; // One bit per vertex: whether it has already been processed by a previous batch
 };
 template<typename OP>
 class ProcessVertexByIndex
@@ -810,18 +837,17 @@ public:
 	void operator()(uint32_t index) { op(vbo + (stride * index + offset)); }
 };
 
-static std::map<int, int> indices;
-
 template<typename OP, typename IndexType>
-void processByIndex(OP op, const uint8_t* indexData, size_t totalSize)
+void processByIndex(OP op, const uint8_t* indexData, size_t totalSize, std::vector<bool>& processedVertices)
 {
 	const uint8_t* const initialData = indexData;
 	while (indexData < initialData + totalSize)
 	{
 		IndexType index = *reinterpret_cast<const IndexType*>(indexData);
-		if (indices.find(index) == indices.end())
+		if (index >= processedVertices.size()) { throw InvalidDataError("[PODReader::mergeBoneBatches]: Vertex index out of range"); }
+		if (!processedVertices[index])
 		{
-			indices[index] = 0;
+			processedVertices[index] = true;
 			op(index);
 		}
 		indexData += (sizeof(IndexType));
@@ -854,7 +880,8 @@ void addValueWithIndex(const DataCarrier& data, size_t width)
 {
 	typedef AddOp<ValueType> OP;
 	typedef ProcessVertexByIndex<OP> Process;
-	processByIndex<Process, IndexType>(Process(OP((ValueType)data.valueToAddToVertices, width), data.vertexData, data.vboStride, data.attribOffset), data.indexData, data.indexDataSize);
+	processByIndex<Process, IndexType>(
+		Process(OP((ValueType)data.valueToAddToVertices, width), data.vertexData, data.vboStride, data.attribOffset), data.indexData, data.indexDataSize, *data.processedVertices);
 }
 
 template<typename ValueType>
@@ -893,12 +920,15 @@ void mergeBoneBatches(uint32_t boneIndexAttributeId, pvr::assets::Mesh& mesh, Bo
 
 	const auto& attrib = *mesh.getVertexAttribute(boneIndexAttributeId);
 
-	indices.clear();
+	// The vertices shared by several batches are only offset by the first one. Kept per call, so that models can be read concurrently.
+	std::vector<bool> processedVertices(mesh.getNumVertices(), false);
+	data.processedVertices = &processedVertices;
 	IndexType faceDataType = meshData.faces.getDataType();
 	for (uint32_t i = 0; i < bonebatches.numBones.size(); ++i)
 	{
-		data.indexData = meshData.faces.getData() + static_cast<uint32_t>(bonebatches.getBatchFaceOffsetBytes(i, faceDataType));
-		data.vertexData = meshData.vertexAttributeDataBlocks[attrib.getDataIndex()].data();
+		// The vertex data is modified in place, so must be owned by the mesh. The face data is only read.
+		data.indexData = static_cast<const assets::Mesh::FaceData&>(meshData.faces).getData() + static_cast<uint32_t>(bonebatches.getBatchFaceOffsetBytes(i, faceDataType));
+		data.vertexData = mesh.getData(attrib.getDataIndex());
 		data.vboStride = meshData.vertexAttributeDataBlocks[attrib.getDataIndex()].stride;
 		data.attribOffset = attrib.getOffset();
 		if (i + 1u < bonebatches.numBones.size())
@@ -978,9 +1008,14 @@ void readMeshBlock(const Stream& stream, assets::Mesh& mesh, assets::Model& mode
 		}
 		case pod::e_meshInterleavedDataList | pod::c_startTagMask:
 		{
-			UInt8Buffer data;
-			readByteArrayIntoVector<uint8_t>(stream, data, dataLength);
-			interleavedDataIndex = mesh.addData(data.data(), static_cast<uint32_t>(data.size()), 0);
+			std::shared_ptr<const uint8_t> sharedData = borrowStreamData(stream, dataLength);
+			if (sharedData) { interleavedDataIndex = mesh.addExternalData(std::move(sharedData), dataLength, 0); }
+			else
+			{
+				UInt8Buffer data;
+				readByteArrayIntoVector<uint8_t>(stream, data, dataLength);
+				interleavedDataIndex = mesh.addData(data.data(), static_cast<uint32_t>(data.size()), 0);
+			}
 			break;
 		}
 		case pod::e_meshBoneBatchIndexList | pod::c_startTagMask:
@@ -1065,11 +1100,12 @@ void readSceneBlock(const Stream& stream, assets::Model& model)
 			if (numTextures != modelInternalData.textures.size()) { throw InvalidDataError("[PODReader::readSceneBlock]: Unknown error - Number of textures was incorrect."); }
 			if (numNodes != modelInternalData.nodes.size()) { throw InvalidDataError("[PODReader::readSceneBlock]: Unknown error - Number of nodes was incorrect."); }
 
-			// Loop through the skeleton and compute the bone's inverse bin matrices.
+			// Loop through the skeleton and compute the bone's inverse bin matrices. Not through the world matrix cache, which is left for the
+			// application to enable (see Model::updateWorldMatrices).
 			for (auto& skin : model.getInternalData().skeletons)
 			{
 				skin.invBindMatrices.resize(skin.bones.size());
-				for (uint32_t j = 0; j < skin.bones.size(); ++j) { skin.invBindMatrices[j] = glm::inverse(model.getWorldMatrix(skin.bones[j])); }
+				for (uint32_t j = 0; j < skin.bones.size(); ++j) { skin.invBindMatrices[j] = glm::inverse(model.getWorldMatrixNoCache(skin.bones[j])); }
 			}
 
 			return;
@@ -45,6 +45,8 @@ uint32_t AnimationData::getFlags() const { return _data.flags; }
 
 AnimationData::InternalData& AnimationData::getInternalData() { return _data; }
 
+const AnimationData::InternalData& AnimationData::getInternalData() const { return _data; }
+
 void AnimationInstance::updateAnimation(float time)
 {
 	time *= 0.001f; // ms to sec.
@@ -89,7 +91,11 @@ void AnimationInstance::updateAnimation(float time)
 
 			// animate all the nodes.
 			for (uint32_t nodeId = 0; nodeId < keyframeNodes.nodes.size(); ++nodeId)
-			{ static_cast<Node*>(keyframeNodes.nodes[nodeId])->getInternalData().getFrameScaleAnimation() = scale; }
+			{
+				Node& n = *static_cast<Node*>(keyframeNodes.nodes[nodeId]);
+				n.getInternalData().getFrameScaleAnimation() = scale;
+				n.setTransformDirty();
+			}
 		}
 		else if (keyFrame.rotate.size())
 		{
@@ -102,7 +108,11 @@ void AnimationInstance::updateAnimation(float time)
 
 			// animate all the node.
 			for (uint32_t nodeId = 0; nodeId < keyframeNodes.nodes.size(); ++nodeId)
-			{ static_cast<Node*>(keyframeNodes.nodes[nodeId])->getInternalData().getFrameRotationAnimation() = quat; }
+			{
+				Node& n = *static_cast<Node*>(keyframeNodes.nodes[nodeId]);
+				n.getInternalData().getFrameRotationAnimation() = quat;
+				n.setTransformDirty();
+			}
 		}
 
 		else if (keyFrame.translation.size())
@@ -120,6 +130,7 @@ void AnimationInstance::updateAnimation(float time)
 				Node& n = *static_cast<Node*>(keyframeNodes.nodes[ii]);
 				pvr::assets::Node::InternalData& internalData = n.getInternalData();
 				internalData.getFrameTranslationAnimation() = trans;
+				n.setTransformDirty();
 			}
 		}
 
@@ -129,10 +140,12 @@ void AnimationInstance::updateAnimation(float time)
 			// animate all the node.
 			for (uint32_t ii = 0; ii < keyframeNodes.nodes.size(); ++ii)
 			{
-				pvr::assets::Node::InternalData& internalData = static_cast<Node*>(keyframeNodes.nodes[ii])->getInternalData();
+				Node& n = *static_cast<Node*>(keyframeNodes.nodes[ii]);
+				pvr::assets::Node::InternalData& internalData = n.getInternalData();
 				glm::mat4 srtMatrix = pvr::math::constructSRT(internalData.getScale(), internalData.getRotate(), internalData.getTranslation());
 				srtMatrix = transX * srtMatrix;
 				memcpy(internalData.frameTransform, glm::value_ptr(srtMatrix), sizeof(glm::mat4));
+				n.setTransformDirty();
 			}
 		}
 	}
@@ -156,7 +169,9 @@ void AnimationInstance::updateAnimationFromKey(uint32_t frameNumber)
 			// animate all the nodes.
 			for (uint32_t nodeId = 0; nodeId < keyframeNodes.nodes.size(); ++nodeId)
 			{
-				static_cast<Node*>(keyframeNodes.nodes[nodeId])->getInternalData().getFrameScaleAnimation() = keyFrame.scale[f1];
+				Node& n = *static_cast<Node*>(keyframeNodes.nodes[nodeId]);
+				n.getInternalData().getFrameScaleAnimation() = keyFrame.scale[f1];
+				n.setTransformDirty();
 			}
 		}
 		else if (keyFrame.rotate.size())
@@ -164,7 +179,9 @@ void AnimationInstance::updateAnimationFromKey(uint32_t frameNumber)
 			// animate all the node.
 			for (uint32_t nodeId = 0; nodeId < keyframeNodes.nodes.size(); ++nodeId)
 			{
-				static_cast<Node*>(keyframeNodes.nodes[nodeId])->getInternalData().getFrameRotationAnimation() = keyFrame.rotate[f1];
+				Node& n = *static_cast<Node*>(keyframeNodes.nodes[nodeId]);
+				n.getInternalData().getFrameRotationAnimation() = keyFrame.rotate[f1];
+				n.setTransformDirty();
 			}
 		}
 		else if (keyFrame.translation.size())
@@ -175,6 +192,7 @@ void AnimationInstance::updateAnimationFromKey(uint32_t frameNumber)
 				Node& n = *static_cast<Node*>(keyframeNodes.nodes[ii]);
 				pvr::assets::Node::InternalData& internalData = n.getInternalData();
 				internalData.getFrameTranslationAnimation() = keyFrame.translation[f1];
+				n.setTransformDirty();
 			}
 		}
 
@@ -184,10 +202,12 @@ void AnimationInstance::updateAnimationFromKey(uint32_t frameNumber)
 			// animate all the node.
 			for (uint32_t ii = 0; ii < keyframeNodes.nodes.size(); ++ii)
 			{
-				pvr::assets::Node::InternalData& internalData = static_cast<Node*>(keyframeNodes.nodes[ii])->getInternalData();
+				Node& n = *static_cast<Node*>(keyframeNodes.nodes[ii]);
+				pvr::assets::Node::InternalData& internalData = n.getInternalData();
 				glm::mat4 srtMatrix = pvr::math::constructSRT(internalData.getScale(), internalData.getRotate(), internalData.getTranslation());
 				srtMatrix = transX * srtMatrix;
 				memcpy(internalData.frameTransform, glm::value_ptr(srtMatrix), sizeof(glm::mat4));
+				n.setTransformDirty();
 			}
 		}
 	}
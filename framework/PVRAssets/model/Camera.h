@@ -82,7 +82,12 @@ public:
 	/// <returns>A (modifiable) reference to the internal data.
 	inline InternalData& getInternalData() { return _data; }
 
+	/// <summary>Get a const reference to the internal data of this object.</summary>
+	/// <returns>A const reference to the internal data.</returns>
+	inline const InternalData& getInternalData() const { return _data; }
+
 	CustomData& getFormattedUserData() { return _customData; }
+	const CustomData& getFormattedUserData() const { return _customData; }
 
 private:
 	CustomData _customData;
@@ -34,14 +34,31 @@ Mesh::FaceData::FaceData() : _indexType(IndexType::IndexType16Bit) {}
 void Mesh::FaceData::setData(const uint8_t* data, uint32_t size, const IndexType indexType)
 {
 	_indexType = indexType;
+	_externalData = ExternalData();
 	_data.resize(size);
 	memcpy(_data.data(), data, size);
 }
 
+void Mesh::FaceData::setExternalData(std::shared_ptr<const uint8_t> data, uint32_t size, const IndexType indexType)
+{
+	_indexType = indexType;
+	_data.clear();
+	_externalData.data = std::move(data);
+	_externalData.size = size;
+}
+
+void Mesh::FaceData::detachExternalData()
+{
+	if (!_externalData.data) { return; }
+	_data.assign(_externalData.data.get(), _externalData.data.get() + _externalData.size);
+	_externalData = ExternalData();
+}
+
 int32_t Mesh::addData(const uint8_t* data, uint32_t size, uint32_t stride)
 {
 	_data.vertexAttributeDataBlocks.emplace_back(StridedBuffer());
 	_data.vertexAttributeDataBlocks.back().stride = static_cast<uint16_t>(stride);
+	_data.externalVertexDataBlocks.resize(_data.vertexAttributeDataBlocks.size());
 	UInt8Buffer& last_element = _data.vertexAttributeDataBlocks.back();
 	last_element.resize(size);
 	if (data) { memcpy(last_element.data(), data, size); }
@@ -51,6 +68,8 @@ int32_t Mesh::addData(const uint8_t* data, uint32_t size, uint32_t stride)
 int32_t Mesh::addData(const uint8_t* data, uint32_t size, uint32_t stride, uint32_t index)
 {
 	if (_data.vertexAttributeDataBlocks.size() <= index) { _data.vertexAttributeDataBlocks.resize(index + 1); }
+	_data.externalVertexDataBlocks.resize(_data.vertexAttributeDataBlocks.size());
+	_data.externalVertexDataBlocks[index] = ExternalData();
 	StridedBuffer& last_element = _data.vertexAttributeDataBlocks[index];
 	last_element.stride = static_cast<uint16_t>(stride);
 	last_element.resize(size);
@@ -58,9 +77,68 @@ int32_t Mesh::addData(const uint8_t* data, uint32_t size, uint32_t stride, uint3
 	return static_cast<int32_t>(_data.vertexAttributeDataBlocks.size()) - 1;
 }
 
+int32_t Mesh::addExternalData(std::shared_ptr<const uint8_t> data, uint32_t size, uint32_t stride)
+{
+	_data.vertexAttributeDataBlocks.emplace_back(StridedBuffer());
+	_data.vertexAttributeDataBlocks.back().stride = static_cast<uint16_t>(stride);
+	_data.externalVertexDataBlocks.resize(_data.vertexAttributeDataBlocks.size());
+	_data.externalVertexDataBlocks.back().data = std::move(data);
+	_data.externalVertexDataBlocks.back().size = size;
+	return static_cast<int32_t>(_data.vertexAttributeDataBlocks.size()) - 1;
+}
+
+void Mesh::detachExternalData(uint32_t index)
+{
+	if (isDataExternal(index))
+	{
+		ExternalData& external = _data.externalVertexDataBlocks[index];
+		_data.vertexAttributeDataBlocks[index].assign(external.data.get(), external.data.get() + external.size);
+		external = ExternalData();
+	}
+}
+
+uint8_t* Mesh::getData(uint32_t index)
+{
+	if (index >= _data.vertexAttributeDataBlocks.size()) { return NULL; }
+	// The caller may modify the data, so it must be owned by the mesh.
+	detachExternalData(index);
+	return _data.vertexAttributeDataBlocks[index].data();
+}
+
+const std::vector<StridedBuffer>& Mesh::getVertexData()
+{
+	for (uint32_t i = 0; i < _data.vertexAttributeDataBlocks.size(); ++i) { detachExternalData(i); }
+	return _data.vertexAttributeDataBlocks;
+}
+
+const std::vector<StridedBuffer>& Mesh::getVertexData() const
+{
+	for (uint32_t i = 0; i < _data.vertexAttributeDataBlocks.size(); ++i)
+	{
+		if (isDataExternal(i)) { throw InvalidOperationError("[Mesh::getVertexData]: The mesh references external vertex data. Use getData and getDataSize instead."); }
+	}
+	return _data.vertexAttributeDataBlocks;
+}
+
+const StridedBuffer& Mesh::getVertexData(uint32_t n)
+{
+	detachExternalData(n);
+	return _data.vertexAttributeDataBlocks[n];
+}
+
+const StridedBuffer& Mesh::getVertexData(uint32_t n) const
+{
+	if (isDataExternal(n)) { throw InvalidOperationError("[Mesh::getVertexData]: The data block references external vertex data. Use getData and getDataSize instead."); }
+	return _data.vertexAttributeDataBlocks[n];
+}
+
 void Mesh::setStride(uint32_t index, uint32_t stride)
 {
-	if (_data.vertexAttributeDataBlocks.size() <= index) { _data.vertexAttributeDataBlocks.resize(index + 1); }
+	if (_data.vertexAttributeDataBlocks.size() <= index)
+	{
+		_data.vertexAttributeDataBlocks.resize(index + 1);
+		_data.externalVertexDataBlocks.resize(index + 1);
+	}
 	_data.vertexAttributeDataBlocks[index].stride = static_cast<uint16_t>(stride);
 }
 
@@ -68,6 +146,7 @@ void Mesh::removeData(uint32_t index)
 {
 	// Remove element
 	_data.vertexAttributeDataBlocks.erase(_data.vertexAttributeDataBlocks.begin() + index);
+	if (index < _data.externalVertexDataBlocks.size()) { _data.externalVertexDataBlocks.erase(_data.externalVertexDataBlocks.begin() + index); }
 
 	VertexAttributeContainer::iterator walk = _data.vertexAttributes.begin();
 
@@ -132,6 +211,17 @@ void Mesh::addFaces(const uint8_t* data, uint32_t size, IndexType indexType)
 	}
 }
 
+void Mesh::addExternalFaces(std::shared_ptr<const uint8_t> data, uint32_t size, IndexType indexType)
+{
+	_data.faces.setExternalData(std::move(data), size, indexType);
+
+	if (size) { _data.primitiveData.numFaces = size / (indexType == IndexType::IndexType32Bit ? 4 : 2) / 3; }
+	else
+	{
+		_data.primitiveData.numFaces = 0;
+	}
+}
+
 void Mesh::removeVertexAttribute(const StringHash& semantic) { _data.vertexAttributes.erase(semantic); }
 
 void Mesh::removeAllVertexAttributes(void) { _data.vertexAttributes.clear(); }
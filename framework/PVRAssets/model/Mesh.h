@@ -10,6 +10,7 @@ skinned) and material.
 #include "PVRCore/types/Types.h"
 #include "PVRCore/types/FreeValue.h"
 #include "PVRAssets/IndexedArray.h"
+#include <memory>
 
 namespace pvr {
 namespace assets {
@@ -116,6 +117,17 @@ public:
 		bool operator<(const VertexAttributeData& rhs) { return _semantic < rhs._semantic; }
 	};
 
+	/// <summary>A block of externally owned, read only data (for example, part of a memory mapped file) that a Mesh references instead of owning
+	/// a copy of it.</summary>
+	struct ExternalData
+	{
+		std::shared_ptr<const uint8_t> data; //!< The data. Shares ownership of the memory it points into.
+		size_t size; //!< The size of the data, in bytes
+
+		/// <summary>Constructor. Creates an empty ExternalData.</summary>
+		ExternalData() : size(0) {}
+	};
+
 	/// <summary>The FaceData class contains the information of the Indices that defines the Faces of a Mesh.</summary>
 	class FaceData
 	{
@@ -124,6 +136,7 @@ public:
 	protected:
 		IndexType _indexType; //!< The index type
 		UInt8Buffer _data; //!< The data
+		ExternalData _externalData; //!< If set, the externally owned data used instead of _data
 
 	public:
 		/// <summary>Constructor</summary>
@@ -135,15 +148,23 @@ public:
 
 		/// <summary>Get a pointer to the actual face data.</summary>
 		/// <returns>A pointer to the actual index data</returns>
-		const uint8_t* getData() const { return _data.data(); }
+		const uint8_t* getData() const { return _externalData.data ? _externalData.data.get() : _data.data(); }
 
-		/// <summary>Get a pointer to the actual face data.</summary>
+		/// <summary>Get a pointer to the actual face data. If the face data is external, it is first copied into memory owned by this object.</summary>
 		/// <returns>A pointer to the actual index data</returns>
-		uint8_t* getData() { return _data.data(); }
+		uint8_t* getData()
+		{
+			detachExternalData();
+			return _data.data();
+		}
 
 		/// <summary>Get total size of the face data.</summary>
 		/// <returns>The total size of the data</returns>
-		uint32_t getDataSize() const { return static_cast<uint32_t>(_data.size()); }
+		uint32_t getDataSize() const { return static_cast<uint32_t>(_externalData.data ? _externalData.size : _data.size()); }
+
+		/// <summary>Check if the face data references externally owned memory instead of owning a copy of it.</summary>
+		/// <returns>True if the face data is external, otherwise false</returns>
+		bool isDataExternal() const { return _externalData.data != nullptr; }
 
 		/// <summary>Get the size of this face data type in Bits.</summary>
 		/// <returns>The size of each index, in Bits</returns>
@@ -154,6 +175,15 @@ public:
 		/// <param name="size">The amount of data, in bytes, to copy from the pointer</param>
 		/// <param name="indexType">The type of index data (16/32 bit)</param>
 		void setData(const uint8_t* data, uint32_t size, const IndexType indexType = IndexType::IndexType16Bit);
+
+		/// <summary>Set all the data of this instance to reference externally owned memory instead of copying it.</summary>
+		/// <param name="data">Pointer to the data. Ownership is shared, so it stays valid for as long as this object references it</param>
+		/// <param name="size">The amount of data, in bytes</param>
+		/// <param name="indexType">The type of index data (16/32 bit)</param>
+		void setExternalData(std::shared_ptr<const uint8_t> data, uint32_t size, const IndexType indexType = IndexType::IndexType16Bit);
+
+	private:
+		void detachExternalData();
 	};
 
 	/// <summary>Contains mesh information.</summary>
@@ -192,6 +222,7 @@ public:
 		std::map<StringHash, FreeValue> semantics; //!< Container that stores semantic values.
 		VertexAttributeContainer vertexAttributes; //!< Contains information on the vertices, such as semantic names, strides etc.
 		std::vector<StridedBuffer> vertexAttributeDataBlocks; //!< Contains the actual raw data (as in, the bytes of information)
+		std::vector<ExternalData> externalVertexDataBlocks; //!< One per data block. If set, the externally owned data used instead of the block's own data
 		uint32_t numBones; //!< Faces information
 
 		FaceData faces; //!< Faces information
@@ -208,6 +239,7 @@ public:
 
 private:
 	InternalData _data;
+	void detachExternalData(uint32_t index);
 	class PredicateVertAttribMinOffset
 	{
 	public:
@@ -249,27 +281,54 @@ public:
 	/// the data of the block and will be queriable with the (getStride) call with the same index as the data.</remarks>
 	int32_t addData(const uint8_t* data, uint32_t size, uint32_t stride, uint32_t index); // a size of 0 is supported
 
+	/// <summary>Append a block of vertex data to the mesh that references externally owned memory (for example, a memory mapped
+	/// file, see Stream::getSharedDataPointer) instead of copying it.</summary>
+	/// <param name="data">A pointer to the data. Ownership is shared, so it stays valid for as long as the mesh references it</param>
+	/// <param name="size">The size of the data, in bytes</param>
+	/// <param name="stride">The stride that the block will be set to.</param>
+	/// <returns>The index of the block that was just created.</returns>
+	/// <remarks>The data is treated as read only: the first call to the non-const getData for this block will copy it into memory owned
+	/// by the mesh.</remarks>
+	int32_t addExternalData(std::shared_ptr<const uint8_t> data, uint32_t size, uint32_t stride);
+
 	/// <summary>Delete a block of data.</summary>
 	/// <param name="index">The index of the block to delete</param>
 	void removeData(uint32_t index); // Will update Vertex Attributes so they don't point at this data
 
 	/// <summary>Remove all data blocks.</summary>
-	void clearAllData() { _data.vertexAttributeDataBlocks.clear(); }
+	void clearAllData()
+	{
+		_data.vertexAttributeDataBlocks.clear();
+		_data.externalVertexDataBlocks.clear();
+	}
 
 	/// <summary>Get a pointer to the data of a specified Data block. Read only overload.</summary>
 	/// <param name="index">The index of the data block</param>
 	/// <returns>A const pointer to the specified data block.</returns>
-	const void* getData(uint32_t index) const { return static_cast<const void*>(_data.vertexAttributeDataBlocks[index].data()); }
+	const void* getData(uint32_t index) const
+	{
+		if (isDataExternal(index)) { return static_cast<const void*>(_data.externalVertexDataBlocks[index].data.get()); }
+		return static_cast<const void*>(_data.vertexAttributeDataBlocks[index].data());
+	}
 
-	/// <summary>Get a pointer to the data of a specified Data block. Read/write overload.</summary>
+	/// <summary>Get a pointer to the data of a specified Data block. Read/write overload. If the block references external data, it is first
+	/// copied into memory owned by the mesh.</summary>
 	/// <param name="index">The index of the data block</param>
 	/// <returns>A pointer to the specified data block.</returns>
-	uint8_t* getData(uint32_t index) { return (index >= _data.vertexAttributeDataBlocks.size()) ? NULL : _data.vertexAttributeDataBlocks[index].data(); }
+	uint8_t* getData(uint32_t index);
 
 	/// <summary>Get the size of the specified Data block.</summary>
 	/// <param name="index">The index of the data block</param>
 	/// <returns>The size in bytes of the specified Data block.</returns>
-	size_t getDataSize(uint32_t index) const { return _data.vertexAttributeDataBlocks[index].size(); }
+	size_t getDataSize(uint32_t index) const
+	{
+		return isDataExternal(index) ? _data.externalVertexDataBlocks[index].size : _data.vertexAttributeDataBlocks[index].size();
+	}
+
+	/// <summary>Check if the specified Data block references externally owned memory instead of owning a copy of it (see addExternalData).</summary>
+	/// <param name="index">The index of the data block</param>
+	/// <returns>True if the data block is external, otherwise false.</returns>
+	bool isDataExternal(uint32_t index) const { return index < _data.externalVertexDataBlocks.size() && _data.externalVertexDataBlocks[index].data != nullptr; }
 	/// <summary>Get distance in bytes from vertex in an array to the next.</summary>
 	/// <param name="index">The index of the data block whose stride to get</param>
 	/// <returns>The distance in bytes from one array entry to the next.</returns>
@@ -285,6 +344,12 @@ public:
 	/// <param name="indexType">The actual datatype contained in (data). (16 or 32 bit)</param>
 	void addFaces(const uint8_t* data, uint32_t size, const IndexType indexType);
 
+	/// <summary>Add face information to the mesh that references externally owned memory instead of copying it.</summary>
+	/// <param name="data">A pointer to the face data. Ownership is shared, so it stays valid for as long as the mesh references it</param>
+	/// <param name="size">The size, in bytes, of the face data</param>
+	/// <param name="indexType">The actual datatype contained in (data). (16 or 32 bit)</param>
+	void addExternalFaces(std::shared_ptr<const uint8_t> data, uint32_t size, const IndexType indexType);
+
 	/// <summary>Add a vertex attribute to the mesh.</summary>
 	/// <param name="element">The vertex attribute to add</param>
 	/// <param name="forceReplace">If set to true, the element will be replaced if it already exists. Otherwise, the
@@ -368,15 +433,31 @@ public:
 	/// <param name="unpackMatrix">An unpack matrix</param>
 	void setUnpackMatrix(const glm::mat4x4& unpackMatrix) { _data.unpackMatrix = unpackMatrix; }
 
-	/// <summary>Get all DataBlocks of this Mesh.</summary>
+	/// <summary>Get all DataBlocks of this Mesh. Blocks that reference external data (see addExternalData) are first copied into memory owned by
+	/// the mesh, as with getData.</summary>
 	/// <returns>The datablocks, as an std::vector of StridedBuffers that additionally have a stride member.</returns>
-	/// <remarks>Use as char arrays and additionally use the getStride() method to get the element stride</remarks>
-	const std::vector<StridedBuffer>& getVertexData() const { return _data.vertexAttributeDataBlocks; }
+	/// <remarks>Use as char arrays and additionally use the getStride() method to get the element stride. getData() and getDataSize() give
+	/// access to the data without copying external blocks.</remarks>
+	const std::vector<StridedBuffer>& getVertexData();
 
-	/// <summary>Get all DataBlocks of this Mesh.</summary>
+	/// <summary>Get all DataBlocks of this Mesh. Read only overload.</summary>
 	/// <returns>The datablocks, as an std::vector of StridedBuffers that additionally have a stride member.</returns>
-	/// <remarks>Use as char arrays and additionally use the getStride() method to get the element stride</remarks>
-	const StridedBuffer& getVertexData(uint32_t n) const { return _data.vertexAttributeDataBlocks[n]; }
+	/// <remarks>A const mesh cannot copy its external blocks (see addExternalData) into a StridedBuffer, so this throws InvalidOperationError if
+	/// any block is external. Use getData() and getDataSize(), which work for all blocks, or call it on a non-const mesh.</remarks>
+	const std::vector<StridedBuffer>& getVertexData() const;
+
+	/// <summary>Get a DataBlock of this Mesh. If the block references external data (see addExternalData), it is first copied into memory owned
+	/// by the mesh, as with getData.</summary>
+	/// <param name="n">The index of the data block</param>
+	/// <returns>The datablock, as a StridedBuffer that additionally has a stride member.</returns>
+	const StridedBuffer& getVertexData(uint32_t n);
+
+	/// <summary>Get a DataBlock of this Mesh. Read only overload.</summary>
+	/// <param name="n">The index of the data block</param>
+	/// <returns>The datablock, as a StridedBuffer that additionally has a stride member.</returns>
+	/// <remarks>Throws InvalidOperationError if the block references external data (see addExternalData). Use getData(n) and getDataSize(n),
+	/// which work for all blocks, or call it on a non-const mesh.</remarks>
+	const StridedBuffer& getVertexData(uint32_t n) const;
 
 	/// <summary>Get all face data of this mesh.</summary>
 	/// <returns>A reference to the face data object of this mesh</returns>
@@ -476,6 +557,10 @@ public:
 	/// <summary>Get a reference to the internal representation and data of this Mesh. Handle with care.</summary>
 	/// <returns>The internal representation of this object.</returns>
 	InternalData& getInternalData() { return _data; }
+
+	/// <summary>Get a const reference to the internal representation and data of this Mesh.</summary>
+	/// <returns>The internal representation of this object.</returns>
+	const InternalData& getInternalData() const { return _data; }
 };
 } // namespace assets
 } // namespace pvr
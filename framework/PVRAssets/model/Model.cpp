@@ -45,12 +45,9 @@ glm::mat4x4 Model::getBoneWorldMatrix(uint32_t skinNodeId, uint32_t boneIndex) c
 	return getWorldMatrix(skeleton.bones[boneIndex]) * skeleton.invBindMatrices[boneIndex] * nodeWorld;
 }
 
-glm::mat4x4 Model::getWorldMatrix(uint32_t id) const
+namespace {
+glm::mat4x4 getLocalMatrix(const Node::InternalData& nodeData)
 {
-	const Node& node = _data.nodes[id];
-	uint32_t parentID = _data.nodes[id].getParentID();
-	const auto& nodeData = node.getInternalData();
-
 	glm::mat4 srtMatrix = glm::mat4(1.0f);
 	if (nodeData.transformFlags == Node::InternalData::TransformFlags::Matrix)
 	{
@@ -67,13 +64,104 @@ glm::mat4x4 Model::getWorldMatrix(uint32_t id) const
 		if (nodeData.transformFlags & Node::InternalData::TransformFlags::Rotate) { srtMatrix = glm::toMat4(nodeData.getRotate()) * srtMatrix; }
 		if (nodeData.transformFlags & Node::InternalData::TransformFlags::Translate) { srtMatrix = glm::translate(nodeData.getTranslation()) * srtMatrix; }
 	}
+	return srtMatrix;
+}
+} // namespace
+
+glm::mat4x4 Model::getWorldMatrixNoCache(uint32_t id) const
+{
+	const glm::mat4 srtMatrix = getLocalMatrix(_data.nodes[id].getInternalData());
+	uint32_t parentID = _data.nodes[id].getParentID();
 
 	// Concatenate with parent transformation if one exist.
 	if (parentID == static_cast<uint32_t>(-1)) { return srtMatrix; }
 	else
 	{
-		return getWorldMatrix(parentID) * srtMatrix;
+		return getWorldMatrixNoCache(parentID) * srtMatrix;
+	}
+}
+
+bool Model::isWorldMatrixCached(uint32_t id) const
+{
+	const uint32_t numNodes = getNumNodes();
+	if (_worldMatrixCache.matrices.size() != numNodes) { return false; }
+
+	// The matrix is current if neither the node nor any of its parents changed since it was computed.
+	for (uint32_t i = 0; id != static_cast<uint32_t>(-1) && i < numNodes; ++i)
+	{
+		const Node& node = _data.nodes[id];
+		if (_worldMatrixCache.versions[id] != node.getInternalData().transformVersion || _worldMatrixCache.parents[id] != node.getParentID()) { return false; }
+		id = node.getParentID();
+	}
+	return true;
+}
+
+void Model::updateWorldMatrices()
+{
+	const uint32_t numNodes = getNumNodes();
+	WorldMatrixCache& cache = _worldMatrixCache;
+
+	bool rebuild = cache.matrices.size() != numNodes;
+	if (!rebuild)
+	{
+		// Reparenting a node marks it dirty, so only the dirty nodes can invalidate the order.
+		for (uint32_t i = 0; i < numNodes && !rebuild; ++i)
+		{ rebuild = cache.versions[i] != _data.nodes[i].getInternalData().transformVersion && cache.parents[i] != _data.nodes[i].getParentID(); }
 	}
+
+	if (rebuild)
+	{
+		cache.matrices.resize(numNodes);
+		cache.versions.resize(numNodes);
+		cache.updated.resize(numNodes);
+		cache.parents.resize(numNodes);
+		cache.order.clear();
+		cache.order.reserve(numNodes);
+
+		// Sort the nodes so that every node comes after its parent: walk up from each node to the first one already sorted, then add the walked nodes
+		// in reverse. Uses cache.updated to flag the sorted nodes.
+		std::fill(cache.updated.begin(), cache.updated.end(), static_cast<uint8_t>(0));
+		for (uint32_t i = 0; i < numNodes; ++i)
+		{
+			const size_t first = cache.order.size();
+			for (uint32_t id = i; id != static_cast<uint32_t>(-1) && !cache.updated[id]; id = _data.nodes[id].getParentID())
+			{
+				debug_assertion(_data.nodes[id].getParentID() == static_cast<uint32_t>(-1) || _data.nodes[id].getParentID() < numNodes, "Invalid parent node index");
+				cache.updated[id] = 1;
+				cache.order.push_back(id);
+			}
+			std::reverse(cache.order.begin() + first, cache.order.end());
+		}
+		for (uint32_t i = 0; i < numNodes; ++i) { cache.parents[i] = _data.nodes[i].getParentID(); }
+	}
+
+	for (uint32_t id : cache.order)
+	{
+		const Node::InternalData& nodeData = _data.nodes[id].getInternalData();
+		const uint32_t parentID = nodeData.parentIndex;
+
+		// A node is recomputed if it changed, or if its parent was recomputed.
+		const bool dirty = rebuild || cache.versions[id] != nodeData.transformVersion || (parentID != static_cast<uint32_t>(-1) && cache.updated[parentID]);
+		cache.updated[id] = dirty;
+		if (dirty)
+		{
+			const glm::mat4 srtMatrix = getLocalMatrix(nodeData);
+			cache.matrices[id] = parentID == static_cast<uint32_t>(-1) ? srtMatrix : cache.matrices[parentID] * srtMatrix;
+			cache.versions[id] = nodeData.transformVersion;
+		}
+	}
+}
+
+glm::mat4x4 Model::getWorldMatrix(uint32_t id) const
+{
+	if (isWorldMatrixCached(id)) { return _worldMatrixCache.matrices[id]; }
+	return getWorldMatrixNoCache(id);
+}
+
+const glm::mat4x4* Model::getWorldMatrices() const
+{
+	debug_assertion(_worldMatrixCache.matrices.size() == getNumNodes(), "[Model::getWorldMatrices]: updateWorldMatrices must be called after adding nodes");
+	return _worldMatrixCache.matrices.data();
 }
 
 glm::vec3 Model::getLightPosition(uint32_t lightNodeId) const { return glm::vec3(getWorldMatrix(getNodeIdFromLightNodeId(lightNodeId))[3]); }
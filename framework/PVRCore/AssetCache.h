@@ -0,0 +1,228 @@
+/*!
+\brief A cache of decoded assets (textures, models etc.) shared between their users, with a memory budget and least recently used eviction.
+\file PVRCore/AssetCache.h
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+#pragma once
+#include "PVRCore/IAssetProvider.h"
+#include <cstring>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
+
+namespace pvr {
+/// <summary>Hit and miss counters of an AssetCache</summary>
+struct AssetCacheStatistics
+{
+	uint64_t numHits; ///< The number of requests that were served from the cache
+	uint64_t numMisses; ///< The number of requests that had to load the asset
+	uint64_t numEvictions; ///< The number of assets removed from the cache to stay within its budget
+	uint64_t numInvalidations; ///< The number of assets removed from the cache because their file had been modified
+	uint64_t numEntries; ///< The number of assets currently in the cache
+	uint64_t currentSize; ///< The total size, in bytes, of the assets currently in the cache
+	uint64_t byteBudget; ///< The maximum total size, in bytes, of the assets kept in the cache
+};
+
+/// <summary>A cache of decoded assets, so that assets referenced several times (for example, a texture used by many materials) are only loaded and
+/// decoded once. Assets are kept as shared pointers to const: every user of an asset shares the same immutable object, which stays alive for as long
+/// as anyone references it, even after the cache has evicted it. A user that needs to modify an asset must make its own copy of it.
+///
+/// Assets are identified by the path of their file, as resolved by an IAssetProvider, together with the modification time of that file: a request
+/// for a file that has been modified since it was cached loads it again. Assets of different types loaded from the same file are cached separately.
+/// When the total size of the cached assets exceeds the byte budget, the least recently used assets are evicted. A budget of 0 disables the cache:
+/// assets are loaded every time they are requested and nothing is kept alive. All functions are thread safe.</summary>
+class AssetCache
+{
+public:
+	/// <summary>Constructor</summary>
+	/// <param name="byteBudget">The maximum total size, in bytes, of the assets kept in the cache. 0 disables the cache.</param>
+	explicit AssetCache(uint64_t byteBudget) : _byteBudget(byteBudget), _currentSize(0)
+	{
+		std::memset(&_statistics, 0, sizeof(_statistics));
+	}
+
+	/// <summary>Find an asset in the cache, marking it as the most recently used asset.</summary>
+	/// <typeparam name="T">The type of the asset</typeparam>
+	/// <param name="resolvedPath">The resolved path of the file of the asset</param>
+	/// <param name="modificationTime">The modification time of the file of the asset. A cached asset with a different modification time is stale: it
+	/// is removed from the cache and not returned.</param>
+	/// <returns>The cached asset, or null if the asset is not in the cache</returns>
+	template<typename T>
+	std::shared_ptr<const T> find(const std::string& resolvedPath, uint64_t modificationTime)
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		auto it = _entries.find(Key(resolvedPath, typeid(T)));
+		if (it == _entries.end())
+		{
+			++_statistics.numMisses;
+			return nullptr;
+		}
+		if (it->second->modificationTime != modificationTime)
+		{
+			++_statistics.numInvalidations;
+			++_statistics.numMisses;
+			erase(it);
+			return nullptr;
+		}
+		++_statistics.numHits;
+		_lruList.splice(_lruList.begin(), _lruList, it->second);
+		return std::static_pointer_cast<const T>(it->second->asset);
+	}
+
+	/// <summary>Add an asset to the cache, replacing any asset of the same type cached for the same file, then evict the least recently used assets
+	/// until the cache is within its budget. An asset larger than the whole budget is not cached.</summary>
+	/// <typeparam name="T">The type of the asset</typeparam>
+	/// <param name="resolvedPath">The resolved path of the file of the asset</param>
+	/// <param name="modificationTime">The modification time of the file of the asset</param>
+	/// <param name="asset">The asset</param>
+	/// <param name="size">The size of the asset in bytes, used to keep the cache within its budget</param>
+	template<typename T>
+	void insert(const std::string& resolvedPath, uint64_t modificationTime, const std::shared_ptr<const T>& asset, uint64_t size)
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		Key key(resolvedPath, typeid(T));
+		auto it = _entries.find(key);
+		if (it != _entries.end()) { erase(it); }
+		if (!asset || size > _byteBudget) { return; }
+
+		_lruList.emplace_front();
+		Entry& entry = _lruList.front();
+		entry.key = key;
+		entry.modificationTime = modificationTime;
+		entry.asset = asset;
+		entry.size = size;
+		_entries.emplace(std::move(key), _lruList.begin());
+		_currentSize += size;
+		evict(_byteBudget);
+	}
+
+	/// <summary>Get an asset from the cache, loading it and adding it to the cache if it is not there. If the cache is disabled or the asset provider
+	/// cannot resolve the file (see IAssetProvider::resolveAsset), the asset is loaded without being cached.</summary>
+	/// <typeparam name="T">The type of the asset</typeparam>
+	/// <param name="provider">The asset provider used to resolve the file of the asset</param>
+	/// <param name="filename">The name of the file of the asset, as passed to the asset provider</param>
+	/// <param name="load">A function that loads the asset, returning it as a shared pointer</param>
+	/// <param name="sizeOf">A function that returns the size in bytes of a loaded asset</param>
+	/// <returns>The asset, shared with the cache</returns>
+	template<typename T, typename LoadFunc, typename SizeFunc>
+	std::shared_ptr<const T> getOrLoad(const IAssetProvider& provider, const std::string& filename, LoadFunc load, SizeFunc sizeOf)
+	{
+		if (!isEnabled()) { return load(); }
+		std::string resolvedPath;
+		uint64_t modificationTime = 0;
+		if (!provider.resolveAsset(filename, resolvedPath, modificationTime)) { return load(); }
+
+		std::shared_ptr<const T> asset = find<T>(resolvedPath, modificationTime);
+		if (asset) { return asset; }
+		// Loaded without holding the lock, so that different assets can be loaded concurrently. If two threads load the same asset at the same time,
+		// both load it and the last one replaces the other in the cache.
+		asset = load();
+		insert<T>(resolvedPath, modificationTime, asset, static_cast<uint64_t>(sizeOf(*asset)));
+		return asset;
+	}
+
+	/// <summary>Set the maximum total size of the assets kept in the cache, evicting the least recently used assets if necessary.</summary>
+	/// <param name="byteBudget">The budget in bytes. 0 disables the cache and releases all the cached assets.</param>
+	void setByteBudget(uint64_t byteBudget)
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_byteBudget = byteBudget;
+		evict(_byteBudget);
+	}
+
+	/// <summary>Get the maximum total size of the assets kept in the cache.</summary>
+	/// <returns>The budget in bytes</returns>
+	uint64_t getByteBudget() const
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _byteBudget;
+	}
+
+	/// <summary>Check whether the cache keeps the assets it loads, i.e. whether its byte budget is not 0.</summary>
+	/// <returns>True if the cache is enabled</returns>
+	bool isEnabled() const
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _byteBudget != 0;
+	}
+
+	/// <summary>Remove all the assets from the cache. Assets still referenced elsewhere stay alive.</summary>
+	void clear()
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_entries.clear();
+		_lruList.clear();
+		_currentSize = 0;
+	}
+
+	/// <summary>Get the hit and miss counters and the current state of the cache.</summary>
+	/// <returns>The statistics of the cache</returns>
+	AssetCacheStatistics getStatistics() const
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		AssetCacheStatistics statistics = _statistics;
+		statistics.numEntries = _entries.size();
+		statistics.currentSize = _currentSize;
+		statistics.byteBudget = _byteBudget;
+		return statistics;
+	}
+
+	/// <summary>Reset the hit, miss, eviction and invalidation counters.</summary>
+	void resetStatistics()
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		std::memset(&_statistics, 0, sizeof(_statistics));
+	}
+
+private:
+	struct Key
+	{
+		std::string path;
+		std::type_index type;
+		Key() : type(typeid(void)) {}
+		Key(const std::string& assetPath, std::type_index assetType) : path(assetPath), type(assetType) {}
+		bool operator==(const Key& rhs) const { return type == rhs.type && path == rhs.path; }
+	};
+	struct KeyHash
+	{
+		size_t operator()(const Key& key) const { return std::hash<std::string>()(key.path) ^ (key.type.hash_code() * 31); }
+	};
+	struct Entry
+	{
+		Key key;
+		uint64_t modificationTime;
+		std::shared_ptr<const void> asset;
+		uint64_t size;
+	};
+	typedef std::list<Entry> LruList; // Most recently used first
+	typedef std::unordered_map<Key, LruList::iterator, KeyHash> EntryMap;
+
+	mutable std::mutex _mutex;
+	LruList _lruList;
+	EntryMap _entries;
+	uint64_t _byteBudget;
+	uint64_t _currentSize;
+	AssetCacheStatistics _statistics;
+
+	void erase(EntryMap::iterator it)
+	{
+		_currentSize -= it->second->size;
+		_lruList.erase(it->second);
+		_entries.erase(it);
+	}
+
+	void evict(uint64_t budget)
+	{
+		while (_currentSize > budget && !_lruList.empty())
+		{
+			++_statistics.numEvictions;
+			erase(_entries.find(_lruList.back().key));
+		}
+	}
+};
+} // namespace pvr
@@ -12,6 +12,7 @@
 
 namespace pvr {
 class Stream;
+class AssetCache;
 /// <summary>The IAssetProvider interface marks a class that provides the getAssetStream function to load assets in a
 /// platform independent way.</summary>
 class IAssetProvider
@@ -27,5 +28,18 @@ public:
 	/// cases where file not found is to be expected (for example, testing for different files due to convention), set
 	/// logErrorOnNotFound to false to avoid cluttering the Log.</remarks>
 	virtual std::unique_ptr<Stream> getAssetStream(const std::string& filename, bool logErrorOnNotFound = true) const = 0;
+
+	/// <summary>Find the file that getAssetStream would open for the provided filename, without opening it. Used to identify assets, for example
+	/// by AssetCache. The default implementation does not support resolving assets.</summary>
+	/// <param name="filename">The name of the asset, as it would be passed to getAssetStream.</param>
+	/// <param name="outResolvedPath">The path of the file the asset would be read from, or another name uniquely identifying the asset.</param>
+	/// <param name="outModificationTime">The time the file was last modified, in any unit, or 0 if the asset cannot be modified (e.g. resources).</param>
+	/// <returns>True if the asset was found and resolved, false if the asset was not found or this provider does not resolve assets.</returns>
+	virtual bool resolveAsset(const std::string& /*filename*/, std::string& /*outResolvedPath*/, uint64_t& /*outModificationTime*/) const { return false; }
+
+	/// <summary>Get the cache in which the framework loaders (for example textureLoadCached without an explicit cache) keep the assets loaded
+	/// through this provider. The default implementation has no cache, so assets are loaded every time they are requested.</summary>
+	/// <returns>The asset cache of this provider, or null if it has none.</returns>
+	virtual AssetCache* getAssetCache() const { return nullptr; }
 };
 } // namespace pvr
@@ -0,0 +1,247 @@
+/*!
+\brief Implementation of the work-stealing job system.
+\file PVRCore/JobSystem.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+#include "PVRCore/JobSystem.h"
+#include <algorithm>
+#include <deque>
+
+namespace pvr {
+namespace async {
+struct JobSystem::Worker
+{
+	uint32_t index;
+	uint32_t randomState; // For picking victims to steal from
+	std::mutex mutex; // Guards the jobs. Only contended when another worker steals.
+	std::deque<Job> jobs; // The owner pushes and pops at the back, thieves take from the front
+	std::thread thread;
+};
+
+namespace {
+// The worker running on this thread, if any, so that jobs spawned by jobs go to the queue of their worker.
+thread_local JobSystem* t_jobSystem = nullptr;
+thread_local void* t_worker = nullptr;
+
+uint32_t xorshift(uint32_t& state)
+{
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return state;
+}
+} // namespace
+
+JobSystem::JobSystem(uint32_t numWorkers) : _numSleeping(0), _numQueued(0), _done(false)
+{
+	if (numWorkers == 0) { numWorkers = std::max(std::thread::hardware_concurrency(), 2u) - 1; }
+	_workers.reserve(numWorkers);
+	for (uint32_t i = 0; i < numWorkers; ++i)
+	{
+		_workers.emplace_back(new Worker());
+		_workers.back()->index = i;
+		_workers.back()->randomState = 0x9E3779B9u * (i + 1);
+	}
+	for (auto& worker : _workers) { worker->thread = std::thread(&JobSystem::run, this, worker.get()); }
+}
+
+JobSystem::~JobSystem()
+{
+	_done = true;
+	_wakeUp.signal(static_cast<Semaphore::ssize_t>(_workers.size()));
+	for (auto& worker : _workers) { worker->thread.join(); }
+}
+
+void JobSystem::spawn(std::function<void()> job, JobCounter* counter, JobCounter* dependency)
+{
+	if (counter) { ++counter->_pending; }
+	Job newJob;
+	newJob.func = std::move(job);
+	newJob.counter = counter;
+	if (dependency)
+	{
+		// Park the job on its dependency. The lock orders this with the final decrement of the dependency, so either the job is parked before the
+		// continuations are released, or the dependency has already reached zero and the job can run straight away.
+		std::lock_guard<std::mutex> lock(dependency->_mutex);
+		if (dependency->_pending != 0)
+		{
+			dependency->_continuations.emplace_back(std::move(newJob));
+			return;
+		}
+	}
+	push(std::move(newJob));
+}
+
+void JobSystem::push(Job&& job)
+{
+	++_numQueued;
+	if (t_jobSystem == this)
+	{
+		Worker* worker = static_cast<Worker*>(t_worker);
+		std::lock_guard<std::mutex> lock(worker->mutex);
+		worker->jobs.emplace_back(std::move(job));
+	}
+	else
+	{
+		_sharedQueue.enqueue(std::move(job));
+	}
+	// Only pay for the semaphore if a worker is actually asleep. A worker announces itself as sleeping before checking for work one last time,
+	// so either it sees this job, or this thread sees it sleeping.
+	if (_numSleeping != 0) { _wakeUp.signal(); }
+}
+
+bool JobSystem::tryGetJob(Job& job, Worker* worker)
+{
+	if (_numQueued == 0) { return false; }
+	// Own queue first, newest job first: its data is most likely still in the cache.
+	if (worker)
+	{
+		std::lock_guard<std::mutex> lock(worker->mutex);
+		if (!worker->jobs.empty())
+		{
+			job = std::move(worker->jobs.back());
+			worker->jobs.pop_back();
+			--_numQueued;
+			return true;
+		}
+	}
+	if (_sharedQueue.try_dequeue(job))
+	{
+		--_numQueued;
+		return true;
+	}
+	// Steal the oldest job of another worker, starting from a random victim.
+	const uint32_t numWorkers = static_cast<uint32_t>(_workers.size());
+	uint32_t randomState = worker ? worker->randomState : static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&job) >> 4) | 1u;
+	const uint32_t first = xorshift(randomState) % numWorkers;
+	if (worker) { worker->randomState = randomState; }
+	for (uint32_t i = 0; i < numWorkers; ++i)
+	{
+		Worker* victim = _workers[(first + i) % numWorkers].get();
+		if (victim == worker) { continue; }
+		std::lock_guard<std::mutex> lock(victim->mutex);
+		if (!victim->jobs.empty())
+		{
+			job = std::move(victim->jobs.front());
+			victim->jobs.pop_front();
+			--_numQueued;
+			return true;
+		}
+	}
+	return false;
+}
+
+void JobSystem::execute(Job& job)
+{
+	try
+	{
+		job.func();
+	}
+	catch (...)
+	{
+		// Jobs without a counter have nobody to report to.
+		if (!job.counter) { Log(LogLevel::Error, "JobSystem: A job spawned without a counter threw an exception, which was discarded."); }
+		else
+		{
+			std::lock_guard<std::mutex> lock(job.counter->_mutex);
+			if (!job.counter->_exception) { job.counter->_exception = std::current_exception(); }
+		}
+	}
+	if (job.counter) { finish(*job.counter); }
+}
+
+void JobSystem::finish(JobCounter& counter)
+{
+	std::vector<Job> continuations;
+	{
+		// Every access to the counter happens under its lock, and wait() takes the lock once after seeing zero, so the counter cannot be destroyed
+		// by a waiter while it is still being used here.
+		std::lock_guard<std::mutex> lock(counter._mutex);
+		if (--counter._pending == 0) { continuations.swap(counter._continuations); }
+	}
+	for (auto& continuation : continuations) { push(std::move(continuation)); }
+}
+
+void JobSystem::wait(JobCounter& counter)
+{
+	Worker* worker = t_jobSystem == this ? static_cast<Worker*>(t_worker) : nullptr;
+	Job job;
+	while (!counter.isComplete())
+	{
+		if (tryGetJob(job, worker))
+		{
+			execute(job);
+			job.func = nullptr;
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+	std::exception_ptr exception;
+	{
+		std::lock_guard<std::mutex> lock(counter._mutex);
+		std::swap(exception, counter._exception);
+	}
+	if (exception) { std::rethrow_exception(exception); }
+}
+
+void JobSystem::parallelFor(uint32_t begin, uint32_t end, const std::function<void(uint32_t, uint32_t)>& func, uint32_t grainSize)
+{
+	if (end <= begin) { return; }
+	const uint32_t numItems = end - begin;
+	if (grainSize == 0) { grainSize = std::max(1u, numItems / ((getNumWorkers() + 1) * 4)); }
+	if (numItems <= grainSize)
+	{
+		func(begin, end);
+		return;
+	}
+
+	JobCounter counter;
+	// Keep the first chunk for this thread, so that it starts working immediately.
+	for (uint32_t chunkBegin = begin + grainSize; chunkBegin < end; chunkBegin += std::min(grainSize, end - chunkBegin))
+	{
+		const uint32_t chunkEnd = chunkBegin + std::min(grainSize, end - chunkBegin);
+		spawn([&func, chunkBegin, chunkEnd]() { func(chunkBegin, chunkEnd); }, &counter);
+	}
+	std::exception_ptr exception;
+	try
+	{
+		func(begin, begin + grainSize);
+	}
+	catch (...)
+	{
+		exception = std::current_exception();
+	}
+	wait(counter);
+	if (exception) { std::rethrow_exception(exception); }
+}
+
+void JobSystem::run(Worker* worker)
+{
+	t_jobSystem = this;
+	t_worker = worker;
+	Job job;
+	for (;;)
+	{
+		if (tryGetJob(job, worker))
+		{
+			execute(job);
+			job.func = nullptr;
+			continue;
+		}
+		if (_done && _numQueued == 0) { break; }
+
+		// Announce that this worker is going to sleep, then check once more: see push().
+		++_numSleeping;
+		if (_numQueued == 0 && !_done) { _wakeUp.wait(); }
+		--_numSleeping;
+	}
+	t_jobSystem = nullptr;
+	t_worker = nullptr;
+}
+} // namespace async
+} // namespace pvr
+//!\endcond
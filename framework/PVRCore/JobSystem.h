@@ -0,0 +1,111 @@
+/*!
+\brief A work-stealing job system, used to run fine grained tasks (culling, animation, command recording etc.) on a shared pool of worker threads.
+\file PVRCore/JobSystem.h
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+#pragma once
+#include "PVRCore/Threading.h"
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace pvr {
+namespace async {
+class JobSystem;
+
+/// <summary>A counter of the jobs that are still pending in a group of jobs. Every job spawned with a counter increments it, and decrements it once
+/// it has been executed. A thread can wait for a counter to reach zero (JobSystem::wait), and jobs can be made to depend on a counter, in which case
+/// they are only started once it has reached zero (continuations). A counter must outlive the jobs spawned with it and the jobs depending on it.</summary>
+class JobCounter
+{
+public:
+	/// <summary>Constructor. The counter starts at zero.</summary>
+	JobCounter() : _pending(0) {}
+
+	/// <summary>Query if all the jobs spawned with this counter have been executed.</summary>
+	/// <returns>True if no job spawned with this counter is still pending, otherwise false.</returns>
+	bool isComplete() const { return _pending == 0; }
+
+	/// <summary>Get the number of jobs spawned with this counter that have not been executed yet.</summary>
+	/// <returns>The number of pending jobs</returns>
+	uint32_t getNumPending() const { return _pending; }
+
+private:
+	friend class JobSystem;
+	struct Job
+	{
+		std::function<void()> func;
+		JobCounter* counter;
+	};
+
+	std::atomic<uint32_t> _pending;
+	std::mutex _mutex; // Guards the continuations, the exception and the transition to zero
+	std::vector<Job> _continuations;
+	std::exception_ptr _exception;
+
+	JobCounter(const JobCounter&) = delete;
+	JobCounter& operator=(const JobCounter&) = delete;
+};
+
+/// <summary>A work-stealing job system. Each worker thread owns a queue of jobs: jobs spawned from a worker are pushed to, and taken from, the back
+/// of its own queue, which keeps related work on the same core, while idle workers steal from the front of the queues of the others. Jobs spawned
+/// from other threads are shared through a lock-free queue. Threads waiting for a JobCounter execute pending jobs instead of blocking, so jobs can
+/// spawn and wait for other jobs without deadlocking.</summary>
+class JobSystem
+{
+public:
+	/// <summary>Constructor. Spawns the worker threads, which sleep while there is no work.</summary>
+	/// <param name="numWorkers">The number of worker threads. If zero, one less than the number of hardware threads (at least one), as the thread
+	/// waiting for the jobs also executes them.</param>
+	explicit JobSystem(uint32_t numWorkers = 0);
+
+	/// <summary>Destructor. Executes all the jobs that have been spawned and can be started, then stops the worker threads. Jobs that depend on a
+	/// counter that never reaches zero are discarded.</summary>
+	~JobSystem();
+
+	/// <summary>Get the number of worker threads.</summary>
+	/// <returns>The number of worker threads</returns>
+	uint32_t getNumWorkers() const { return static_cast<uint32_t>(_workers.size()); }
+
+	/// <summary>Spawn a job.</summary>
+	/// <param name="job">The function to execute</param>
+	/// <param name="counter">Optional. A counter that is incremented now, and decremented once the job has been executed.</param>
+	/// <param name="dependency">Optional. A counter the job depends on: the job will only be started once this counter has reached zero.</param>
+	void spawn(std::function<void()> job, JobCounter* counter = nullptr, JobCounter* dependency = nullptr);
+
+	/// <summary>Wait until all the jobs spawned with a counter have been executed, executing pending jobs on this thread in the meantime. If any of
+	/// the jobs threw an exception, the first one is rethrown (and cleared from the counter).</summary>
+	/// <param name="counter">The counter to wait for</param>
+	void wait(JobCounter& counter);
+
+	/// <summary>Execute a function over a range of indices, split into chunks executed in parallel. Returns once the whole range has been processed.
+	/// The calling thread takes part in the work. If any chunk threw an exception, the first one is rethrown.</summary>
+	/// <param name="begin">The first index of the range</param>
+	/// <param name="end">One past the last index of the range</param>
+	/// <param name="func">The function to execute for each chunk, called with the first index and one past the last index of the chunk.</param>
+	/// <param name="grainSize">The number of indices in each chunk. If zero, the range is split into a few chunks per thread.</param>
+	void parallelFor(uint32_t begin, uint32_t end, const std::function<void(uint32_t, uint32_t)>& func, uint32_t grainSize = 0);
+
+private:
+	typedef JobCounter::Job Job;
+	struct Worker;
+
+	std::vector<std::unique_ptr<Worker>> _workers;
+	moodycamel::ConcurrentQueue<Job> _sharedQueue;
+	Semaphore _wakeUp;
+	std::atomic<uint32_t> _numSleeping;
+	std::atomic<uint32_t> _numQueued;
+	std::atomic<bool> _done;
+
+	void push(Job&& job);
+	bool tryGetJob(Job& job, Worker* worker);
+	void execute(Job& job);
+	void finish(JobCounter& counter);
+	void run(Worker* worker);
+
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+};
+} // namespace async
+} // namespace pvr
@@ -7,6 +7,7 @@ MoodyCamel's BlockingConcurrentQueue.
 */
 #pragma once
 #include "../external/concurrent_queue/blockingconcurrentqueue.h"
+#include "PVRCore/Log.h"
 
 #include <thread>
 #include <mutex>
@@ -14,6 +15,10 @@ MoodyCamel's BlockingConcurrentQueue.
 #include <condition_variable>
 #include <sstream>
 #include <deque>
+#include <array>
+#include <vector>
+#include <chrono>
+#include <algorithm>
 
 //  ASYNCHRONOUS FRAMEWORK: Framework async loader base etc //
 namespace pvr {
@@ -124,6 +129,30 @@ public:
 	/// failed or has not yet completed</returns>
 	bool isSuccessful() const { return _successful; }
 
+	/// <summary>Cancel the task, if it has not been started yet. A cancelled task is never executed: the future becomes complete immediately,
+	/// is not successful, and its completion callback is not called. A task that has already started cannot be cancelled.</summary>
+	/// <returns>True if the task was cancelled, false if it had already started (or had already been cancelled)</returns>
+	bool cancel()
+	{
+		uint32_t expected = StatePending;
+		if (!_executionState.compare_exchange_strong(expected, StateCancelled)) { return false; }
+		_successful = false;
+		cancel_();
+		return true;
+	}
+
+	/// <summary>Query if the task has been cancelled</summary>
+	/// <returns>True if the task was cancelled before it started, otherwise false</returns>
+	bool isCancelled() const { return _executionState == StateCancelled; }
+
+	/// <summary>Query if the task is still waiting to be executed or is being executed, i.e. has neither finished nor been cancelled</summary>
+	/// <returns>True if the task is queued or running, otherwise false</returns>
+	bool isInProgress() const
+	{
+		const uint32_t state = _executionState;
+		return state == StatePending || state == StateRunning;
+	}
+
 protected:
 	Callback _completionCallback; //!< The callback that will be called on completion
 	std::atomic<bool> _inCallback; //!< This is a mechanism to query if a function is actually called BY the callback to avoid deadlocking.
@@ -145,10 +174,35 @@ protected:
 		}
 	}
 
-	IFrameworkAsyncResult() : _completionCallback(nullptr), _inCallback(false), _successful(false), _isComplete(false) {}
+	IFrameworkAsyncResult() : _completionCallback(nullptr), _inCallback(false), _successful(false), _isComplete(false), _executionState(StatePending) {}
 
 private:
+	template<typename, typename FutureType, void (*)(FutureType)>
+	friend class AsyncScheduler;
+
+	enum : uint32_t
+	{
+		StatePending,
+		StateRunning,
+		StateFinished,
+		StateCancelled,
+	};
+
 	mutable bool _isComplete;
+	std::atomic<uint32_t> _executionState;
+
+	// Called by the scheduler before executing the task. Returns false if the task must not be executed (cancelled, or already executed).
+	bool beginExecution_()
+	{
+		uint32_t expected = StatePending;
+		return _executionState.compare_exchange_strong(expected, StateRunning);
+	}
+	// Called by the scheduler after executing the task.
+	void endExecution_() { _executionState = StateFinished; }
+
+	/// <summary>Implement this to release anyone waiting for the result of a task that has been cancelled before starting, so that isComplete_
+	/// returns true and get_ returns without blocking.</summary>
+	virtual void cancel_() = 0;
 
 	/// <summary>Implement this by returning true if the task is complete (successful or not). Return false
 	/// if the task is not complete (is still running). True should imply that, as far as practical, get()
@@ -162,13 +216,39 @@ private:
 	virtual T get_() const = 0;
 };
 
-/// <summary>The AsyncScheduler is an abstract Scheduling system of a homogeneous task queue running on a background
-/// thread, i.e. a queue of work of a particular type. It provides its child classes wioth access to the actual queue
-/// and the synchronization semaphores in order to facilitate easier implementation. Specifically, it is expected that
-/// the user will provide functions to enqueue and dequeue work, while this class provides the running loop (actually
-/// executing the tasks, calling the callbacks etc</summary>
+/// <summary>The priority classes of the tasks of an AsyncScheduler. Workers always pick a queued task of the highest priority class that has tasks
+/// queued. Within a class, tasks enqueued by the same thread are started in the order they were enqueued, but there is no order between the tasks
+/// of different threads: the queues are lock-free, and not FIFO across producers.</summary>
+enum class TaskPriority : uint32_t
+{
+	High = 0, ///< Work that is needed as soon as possible, for example a texture required to render the current frame
+	Normal = 1, ///< The default priority
+	Low = 2, ///< Background work, for example prefetching assets that may be needed later
+	Count = 3, ///< The number of priority classes
+};
+
+/// <summary>Counters of one priority queue of an AsyncScheduler, used to tune the number of worker threads. Counters are gathered without
+/// locking, so when tasks are in flight the values are only approximately consistent with each other.</summary>
+struct AsyncSchedulerStatistics
+{
+	uint64_t numEnqueued; ///< The number of tasks added to the queue
+	uint64_t numExecuted; ///< The number of tasks that were dequeued and executed
+	uint64_t numDropped; ///< The number of tasks that were dequeued without being executed, because they had been cancelled or already executed
+	uint64_t numQueued; ///< The approximate number of tasks currently waiting in the queue
+	double averageQueueLatency; ///< The average time, in seconds, between a task being enqueued and a worker dequeuing it
+	double maxQueueLatency; ///< The longest time, in seconds, that a task has waited in the queue
+	double averageExecutionTime; ///< The average time, in seconds, spent executing a task
+	double throughput; ///< The number of tasks executed per second since the scheduler was created or its statistics were last reset
+};
+
+/// <summary>The AsyncScheduler is an abstract Scheduling system of a homogeneous task queue running on one or more background threads, i.e. a
+/// queue of work of a particular type. Child classes create the futures and pass them to enqueue, while this class provides the worker threads
+/// that actually execute the tasks. Tasks are held in one lock-free queue per priority class (see TaskPriority). A task whose future has been
+/// cancelled before a worker picked it up is dropped without being executed. The workers finish the queued tasks while this class is destroyed, after
+/// the members of the derived class have been destroyed, so the worker function must only use what the future holds, never the derived scheduler.</summary>
 /// <typeparam name="ValueType">The type of the return value that will be returned by the functions</typeparam>
-/// <typeparam name="FutureType">The type of the future (which will also be the input to the worker function)</typeparam>
+/// <typeparam name="FutureType">The type of the future (which will also be the input to the worker function). Must be a pointer to a class
+/// derived from IFrameworkAsyncResult.</typeparam>
 /// <typeparam name="worker">The function pointer that will be called to perform the work</typeparam>
 template<typename ValueType, typename FutureType, void (*worker)(FutureType)>
 class AsyncScheduler
@@ -179,115 +259,199 @@ public:
 
 	/// <summary>The approximate number of queued items. (Unsynchronized for performance).</summary>
 	/// <returns>The number of queued items (currently visible to this thread)</returns>
-	uint32_t getNumApproxQueuedItem() { return static_cast<uint32_t>(_queue.size()); }
-
-	/// <summary>The precise number of queued items at the time of calling. Although it is poosible
-	/// that (if the queue is currently producing or consuming) the number has changed by the time
-	/// it is used (even if immediately), nevertheless getting the number is synchronized hence precise
-	/// at the time of querying it.</summary>
-	/// <returns>The number of queued items (access is synchronized)</returns>
-	uint32_t getNumQueuedItems()
+	uint32_t getNumApproxQueuedItem()
 	{
-		_queueSemaphore.wait();
-		uint32_t retval = static_cast<uint32_t>(_queue.size());
-		_queueSemaphore.signal();
-		return retval;
+		size_t retval = 0;
+		for (auto& queue : _queues) { retval += queue.queue.size_approx(); }
+		return static_cast<uint32_t>(retval);
 	}
 
-	/// <summary>Destructor (virtual)</summary>
-	virtual ~AsyncScheduler()
+	/// <summary>The number of queued items at the time of calling, including tasks that have been cancelled but not yet removed from the queue by
+	/// a worker. Items are counted until a worker dequeues them, so a return value of zero means that every task has at least been started.</summary>
+	/// <returns>The number of queued items</returns>
+	uint32_t getNumQueuedItems() { return _numQueued; }
+
+	/// <summary>Get the number of worker threads executing the tasks of this scheduler.</summary>
+	/// <returns>The number of worker threads</returns>
+	uint32_t getNumWorkers() const { return static_cast<uint32_t>(_workers.threads.size()); }
+
+	/// <summary>Get the counters of one of the priority queues of this scheduler.</summary>
+	/// <param name="priority">The priority class of the queue</param>
+	/// <returns>The counters of the queue</returns>
+	AsyncSchedulerStatistics getStatistics(TaskPriority priority = TaskPriority::Normal) const
 	{
-		bool didit = false;
-		_queueSemaphore.wait(); // protect the _done variable
-		if (!_done)
+		const PriorityQueue& queue = _queues[static_cast<uint32_t>(priority)];
+		AsyncSchedulerStatistics stats;
+		stats.numEnqueued = queue.numEnqueued;
+		stats.numExecuted = queue.numExecuted;
+		stats.numDropped = queue.numDropped;
+		stats.numQueued = queue.queue.size_approx();
+		const uint64_t numDequeued = stats.numExecuted + stats.numDropped;
+		stats.averageQueueLatency = numDequeued ? static_cast<double>(queue.totalQueueLatency) * 1e-9 / numDequeued : 0.;
+		stats.maxQueueLatency = static_cast<double>(queue.maxQueueLatency) * 1e-9;
+		stats.averageExecutionTime = stats.numExecuted ? static_cast<double>(queue.totalExecutionTime) * 1e-9 / stats.numExecuted : 0.;
+		const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - _statisticsStart.load()).count();
+		stats.throughput = elapsed > 0. ? stats.numExecuted / elapsed : 0.;
+		return stats;
+	}
+
+	/// <summary>Reset the counters of all the priority queues of this scheduler.</summary>
+	void resetStatistics()
+	{
+		for (auto& queue : _queues)
 		{
-			didit = true;
-			_done = true;
-			_workSemaphore.signal();
+			queue.numEnqueued = 0;
+			queue.numExecuted = 0;
+			queue.numDropped = 0;
+			queue.totalQueueLatency = 0;
+			queue.maxQueueLatency = 0;
+			queue.totalExecutionTime = 0;
 		}
-		_queueSemaphore.signal();
-		if (didit) // Only join if it was actually running. Duh!
-		{ _thread.join(); } }
+		_statisticsStart = std::chrono::steady_clock::now();
+	}
+
+	/// <summary>Destructor (virtual). Waits for the workers to finish all the queued tasks (see the class description).</summary>
+	virtual ~AsyncScheduler() {}
 
 protected:
-	/// <summary>Constructor (empty, spawns worker thread and waits)</summary>
-	AsyncScheduler()
+	/// <summary>Constructor. Spawns the worker threads, which sleep until work is enqueued.</summary>
+	/// <param name="numWorkers">The number of worker threads. At least one worker thread is always created.</param>
+	/// <param name="info">A name for this scheduler, used in log messages.</param>
+	explicit AsyncScheduler(uint32_t numWorkers = 1, const std::string& info = "AsyncScheduler") : _myInfo(info), _numQueued(0), _done(false), _workers(*this)
 	{
-		_done = false;
-		_thread = std::thread(&AsyncScheduler::run, this);
+		resetStatistics();
+		numWorkers = std::max(numWorkers, 1u);
+		Log(LogLevel::Information,
+			"%s : Asynchronous Scheduler starting. "
+			"%u worker thread(s) spawned. The worker threads will be sleeping as long as no work is being performed, "
+			"and will be released when the async sheduler is destroyed.",
+			_myInfo.c_str(), numWorkers);
+		_workers.threads.reserve(numWorkers);
+		for (uint32_t i = 0; i < numWorkers; ++i) { _workers.threads.emplace_back(&AsyncScheduler::run, this); }
 	}
 
-	/// <summary>This semaphore is the counter for enqueued work. Signal it once when adding work to the queue.</summary>
+	/// <summary>Add a task to the queue of its priority class, waking up a worker thread to execute it. The same future may be enqueued again (for
+	/// example at a higher priority): it will only be executed once, and the other entries are dropped.</summary>
+	/// <param name="future">The future of the task. Will be passed to the worker function.</param>
+	/// <param name="priority">The priority class of the task</param>
+	void enqueue(const FutureType& future, TaskPriority priority = TaskPriority::Normal)
+	{
+		assertion(!_done, "AsyncScheduler: Attempted to enqueue work while the scheduler was being destroyed");
+		PriorityQueue& queue = _queues[static_cast<uint32_t>(priority)];
+		QueuedTask task;
+		task.future = future;
+		task.enqueueTime = std::chrono::steady_clock::now();
+		++_numQueued; // Before enqueueing, so that the workers never see an empty count with tasks still in a queue
+		++queue.numEnqueued;
+		queue.queue.enqueue(std::move(task));
+		_workSemaphore.signal();
+	}
+
+	/// <summary>This semaphore is the counter for enqueued work. It is signalled once for every task added by enqueue, and once per worker
+	/// when the scheduler is destroyed.</summary>
 	Semaphore _workSemaphore;
-	/// <summary>This is basically a mutex for the queue. Wait on it to lock the queue, then signal it when done.</summary>
-	Semaphore _queueSemaphore;
-	/// <summary>This is the work queue. Each item enqueued will be processed by worker.</summary>
-	std::deque<FutureType> _queue;
 	/// <summary>String information regarding the tasks operations.</summary>
 	std::string _myInfo;
 
 private:
-	std::thread _thread;
+	struct QueuedTask
+	{
+		FutureType future;
+		std::chrono::steady_clock::time_point enqueueTime;
+	};
+
+	struct PriorityQueue
+	{
+		moodycamel::ConcurrentQueue<QueuedTask> queue;
+		std::atomic<uint64_t> numEnqueued;
+		std::atomic<uint64_t> numExecuted;
+		std::atomic<uint64_t> numDropped;
+		std::atomic<uint64_t> totalQueueLatency; // nanoseconds
+		std::atomic<uint64_t> maxQueueLatency; // nanoseconds
+		std::atomic<uint64_t> totalExecutionTime; // nanoseconds
+	};
+
+	// Owns the worker threads. On destruction, waits for the workers to finish all the queued tasks, then joins them.
+	struct Workers
+	{
+		AsyncScheduler& scheduler;
+		std::vector<std::thread> threads;
+
+		explicit Workers(AsyncScheduler& owner) : scheduler(owner) {}
+		~Workers()
+		{
+			scheduler._done = true;
+			scheduler._workSemaphore.signal(static_cast<Semaphore::ssize_t>(threads.size()));
+			for (auto& thread : threads) { thread.join(); }
+		}
+	};
+
+	std::array<PriorityQueue, static_cast<uint32_t>(TaskPriority::Count)> _queues;
+	std::atomic<std::chrono::steady_clock::time_point> _statisticsStart;
+	std::atomic<uint32_t> _numQueued;
 	std::atomic_bool _done;
+	// Declared last, so that it is destroyed first: the workers are joined before any other member of this class goes away.
+	Workers _workers;
+
+	bool tryDequeue(QueuedTask& task, PriorityQueue*& queue)
+	{
+		for (auto& priorityQueue : _queues)
+		{
+			if (priorityQueue.queue.try_dequeue(task))
+			{
+				queue = &priorityQueue;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	static uint64_t nanosecondsBetween(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to)
+	{
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count());
+	}
+
 	void run()
 	{
-		Log(LogLevel::Information,
-			"%s : Asynchronous Scheduler starting. "
-			"1 worker thread spawned. The worker thread will be sleeping as long as no work is being performed, "
-			"and will be released when the async sheduler is destroyed.",
-			_myInfo.c_str());
-
-		std::string _str_0_unlock_ = (_myInfo + " : LOOP ENTER: Unlocking the queue.");
-		std::string _str_1_wait_work_ = (_myInfo + " : Queue unlocked, waiting for work to be scheduled");
-		std::string _str_2_queuelock_ = (_myInfo + " : Work scheduled, Obtaining queue lock");
-		std::string _str_3_queueLocked_ = (_myInfo + " : Queue lock obtained, testing to determine work/exit");
-		std::string _str_4_exit_signal_ = (_myInfo + " : Queue was signalled without items - must be the exit signal. Exiting...");
-		std::string _str_5_obtaining_work_ = (_myInfo + " : Queue had items: Obtaining work!");
-		std::string _str_6_obtained_work_ = (_myInfo + " : Work obtained, Releasing the queue.");
-		std::string _str_7_executing_work_ = (_myInfo + " : Queue released, Executing work.");
-		std::string _str_8_execution_done_ = (_myInfo + " : Work execution done, locking the queue.");
-		std::string _str_9_looping_up_ = (_myInfo + " : Queue locked, LOOPING!");
-
-		// Are we done?
-		// a) The queue will be empty on the first iteration.
-		// b) Even if the queue is empty, consumers may be blocked on results.
-		// c) Even if done, consumers may be blocked on results.
-		while (!_done || _queue.size())
+		for (;;)
 		{
-			DebugLog(_str_0_unlock_.c_str());
-			_queueSemaphore.signal(); // First iteration: Signal that we are actually waiting on the queue, essentially priming it,
-			// consumers to start adding items.
-			// Subsequent iterations: Release the check we are doing on the queue.
-			DebugLog(_str_1_wait_work_.c_str());
-			_workSemaphore.wait(); // Wait for work to arrive
-			DebugLog(_str_2_queuelock_.c_str());
-			_queueSemaphore.wait(); // Work has arrived! Or has it? Lock the queue, as we need to check that it is not empty,
-			DebugLog(_str_3_queueLocked_.c_str());
-			// and to unqueue items.
-			if (!_queue.size()) // Are we done? Was this a signal for work or for us to finish?
+			_workSemaphore.wait(); // Wait for work to arrive, or for the exit signal
+
+			// Every signal but the exit signals matches a task that has already been enqueued, but another worker may have picked up that task in
+			// the meantime: in that case, the task of its signal is still in a queue, or about to become visible.
+			QueuedTask task;
+			PriorityQueue* queue = nullptr;
+			bool exiting = false;
+			while (!tryDequeue(task, queue))
 			{
-				DebugLog(_str_4_exit_signal_.c_str());
-				// Someone signalled the queue without putting items in. This means we are finished.
-				assertion(_done); // duh?
-				break;
+				if (_done && _numQueued == 0)
+				{
+					exiting = true;
+					break;
+				}
+				std::this_thread::yield();
 			}
-			else // Yay! Work to do!
+			if (exiting) { break; }
+			--_numQueued;
+
+			const auto dequeueTime = std::chrono::steady_clock::now();
+			const uint64_t latency = nanosecondsBetween(task.enqueueTime, dequeueTime);
+			queue->totalQueueLatency += latency;
+			uint64_t maxLatency = queue->maxQueueLatency;
+			while (latency > maxLatency && !queue->maxQueueLatency.compare_exchange_weak(maxLatency, latency)) {}
+
+			// Cancelled, or already executed because it was enqueued more than once.
+			if (!task.future->beginExecution_())
 			{
-				DebugLog(_str_5_obtaining_work_.c_str());
-
-				FutureType future = std::move(_queue.front()); // Get work.
-				_queue.pop_front();
-				DebugLog(_str_6_obtained_work_.c_str());
-				_queueSemaphore.signal(); // Release the krak... QUEUE.
-				DebugLog(_str_7_executing_work_.c_str());
-				worker(future); // Load a texture! Yay!
-				DebugLog(_str_8_execution_done_.c_str());
+				++queue->numDropped;
+				continue;
 			}
-			_queueSemaphore.wait(); // Continue. Lock the queue to check it out.
-			DebugLog(_str_9_looping_up_.c_str());
+			worker(task.future);
+			task.future->endExecution_();
+			queue->totalExecutionTime += nanosecondsBetween(dequeueTime, std::chrono::steady_clock::now());
+			++queue->numExecuted;
 		}
-		_queueSemaphore.signal(); // Finish. Release the queue.
-		Log(LogLevel::Information, "%s: Asynchronous asset loader closing down. Freeing workers.", _myInfo.c_str());
+		Log(LogLevel::Information, "%s: Asynchronous scheduler worker thread closing down.", _myInfo.c_str());
 	}
 };
 } // namespace async
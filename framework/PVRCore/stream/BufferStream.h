@@ -148,6 +148,23 @@ private:
 	/// <returns>If suppored, return the total amount of data in the stream.</returns>
 	virtual uint64_t _getSize() const override { return _bufferSize; }
 
+	/// <summary>Positional read. Copies directly from the buffer without touching the current position.</summary>
+	/// <param name="offset">The offset, from the start of the stream, of the first byte to read.</param>
+	/// <param name="elementSize">The size of each element that will be read.</param>
+	/// <param name="numElements">The number of elements to read.</param>
+	/// <param name="buffer">The buffer into which to write the data.</param>
+	virtual void _readAt(uint64_t offset, size_t elementSize, size_t numElements, void* buffer) const override
+	{
+		if (!buffer || !_originalData) { throw InvalidOperationError("Attempted to read a null BufferStream"); }
+		const uint64_t size = static_cast<uint64_t>(elementSize) * numElements;
+		if (offset > _bufferSize || size > _bufferSize - offset) { throw FileEOFError("[BufferStream::readAt]: Attempted to read past the end of stream."); }
+		memcpy(buffer, static_cast<const char*>(_originalData) + offset, static_cast<size_t>(size));
+	}
+
+	/// <summary>Positional reads are plain memory copies, so can be issued from several threads at the same time.</summary>
+	/// <returns>True if the stream has data</returns>
+	virtual bool _supportsConcurrentReads() const override { return _originalData != nullptr; }
+
 private:
 	// Disable copy and assign.
 	void operator=(const BufferStream&);
@@ -0,0 +1,336 @@
+/*!
+\brief An index of the files contained in directories, used to find files without attempting to open them in every possible location.
+\file PVRCore/stream/DirectoryIndex.h
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+#pragma once
+#include "PVRCore/stream/FileStream.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+namespace pvr {
+/// <summary>An index of the regular files contained in directories of the filesystem. Each directory is listed once, the first time a file is looked up
+/// in it, after which finding whether a file exists in that directory is a hash lookup instead of a (possibly failing) attempt to open it. Directories
+/// are not listed recursively: a lookup of "textures/brick.pvr" lists the directory "textures/" only.
+///
+/// The index can be saved to a file and loaded back, so that the directories do not need to be listed again on the next run. A loaded listing is only
+/// trusted if the modification time of its directory has not changed since it was saved, so files added or removed in the meantime are found.
+/// Listings are trusted once made or verified: fileExists never accesses the filesystem for a directory already listed. Files created in a listed
+/// directory while the index is in use are found by recheckFileExists, meant to be called once a file has been missed in every location it is looked
+/// for, or after the directory has been invalidated with invalidateDirectory. All functions are thread safe.</summary>
+class DirectoryIndex
+{
+public:
+	/// <summary>Constructor. Creates an empty index.</summary>
+	DirectoryIndex() : _isModified(false), _numLookups(0), _numDirectoriesListed(0) {}
+
+	/// <summary>Check if a regular file is in the listing of its directory, listing the directory if it has not been listed yet. Does not access the
+	/// filesystem if the directory has already been listed, so a file created since is reported as missing (see recheckFileExists).</summary>
+	/// <param name="filePath">The path of the file. Relative paths are relative to the current directory.</param>
+	/// <returns>True if the file exists, otherwise false</returns>
+	bool fileExists(const std::string& filePath) const
+	{
+		std::string directory, filename;
+		splitPath(filePath, directory, filename);
+		if (filename.empty()) { return false; }
+
+		std::lock_guard<std::mutex> lock(_mutex);
+		++_numLookups;
+		const Directory& listing = getDirectory(directory);
+		return listing.files.find(normalizeName(filename)) != listing.files.end();
+	}
+
+	/// <summary>Check if a regular file exists, first listing its directory again if the directory has been modified since it was listed. Costs a
+	/// stat of the directory, so only call it after fileExists has missed the file in every location it is looked for. Files created within the
+	/// timestamp resolution of the filesystem after their directory was listed may still be missed: use invalidateDirectory after creating them.</summary>
+	/// <param name="filePath">The path of the file. Relative paths are relative to the current directory.</param>
+	/// <returns>True if the file exists, otherwise false</returns>
+	bool recheckFileExists(const std::string& filePath) const
+	{
+		std::string directory, filename;
+		splitPath(filePath, directory, filename);
+		if (filename.empty()) { return false; }
+
+		std::lock_guard<std::mutex> lock(_mutex);
+		++_numLookups;
+		auto it = _directories.find(directory);
+		if (it == _directories.end()) { return getDirectory(directory).files.count(normalizeName(filename)) != 0; }
+		Directory& listing = it->second;
+		uint64_t modificationTime = 0;
+		const bool exists = getDirectoryModificationTime(directory, modificationTime);
+		if (exists != listing.exists || modificationTime != listing.modificationTime)
+		{
+			listDirectory(directory, listing);
+			++_numDirectoriesListed;
+			_isModified = true;
+		}
+		listing.isVerified = true;
+		return listing.files.find(normalizeName(filename)) != listing.files.end();
+	}
+
+	/// <summary>Forget the listing of a directory, for example after a file has been created in it. It will be listed again when next used.</summary>
+	/// <param name="directory">The directory, as it appears in the paths looked up (including the trailing directory separator, if any).</param>
+	void invalidateDirectory(const std::string& directory)
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (_directories.erase(directory)) { _isModified = true; }
+	}
+
+	/// <summary>Forget the listings of all directories.</summary>
+	void clear()
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_isModified = _isModified || !_directories.empty();
+		_directories.clear();
+	}
+
+	/// <summary>Get the number of lookups performed with this index.</summary>
+	/// <returns>The number of calls to fileExists</returns>
+	uint64_t getNumLookups() const
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _numLookups;
+	}
+
+	/// <summary>Get the number of directories that had to be listed, i.e. that were not already known, or whose saved listing was out of date.</summary>
+	/// <returns>The number of directories listed</returns>
+	uint64_t getNumDirectoriesListed() const
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _numDirectoriesListed;
+	}
+
+	/// <summary>Load listings saved with save, adding them to this index. Each listing is checked against the modification time of its directory
+	/// when first used.</summary>
+	/// <param name="indexFilePath">The path of the file to load the index from</param>
+	/// <returns>True if the file was loaded, false if it does not exist or is not a valid index file.</returns>
+	bool load(const std::string& indexFilePath)
+	{
+		FileStream stream(indexFilePath, "rb", false);
+		if (!stream.isReadable()) { return false; }
+		std::unordered_map<std::string, Directory> directories;
+		try
+		{
+			char identifier[c_identifierSize];
+			stream.readExact(1, c_identifierSize, identifier);
+			if (memcmp(identifier, getIdentifier(), c_identifierSize) != 0) { return false; }
+			uint32_t numDirectories;
+			stream.readExact(sizeof(numDirectories), 1, &numDirectories);
+			for (uint32_t i = 0; i < numDirectories; ++i)
+			{
+				std::string path = readString(stream);
+				Directory& directory = directories[path];
+				stream.readExact(sizeof(directory.modificationTime), 1, &directory.modificationTime);
+				uint32_t numFiles;
+				stream.readExact(sizeof(numFiles), 1, &numFiles);
+				directory.files.reserve(numFiles);
+				for (uint32_t j = 0; j < numFiles; ++j) { directory.files.insert(readString(stream)); }
+				directory.exists = true;
+				directory.isVerified = false;
+			}
+		}
+		catch (const PvrError&)
+		{
+			return false;
+		}
+
+		std::lock_guard<std::mutex> lock(_mutex);
+		// Listings made during this run are at least as recent as the saved ones.
+		for (auto& directory : directories) { _directories.insert(std::move(directory)); }
+		return true;
+	}
+
+	/// <summary>Save the listings of this index to a file. Only listings of existing directories are saved.</summary>
+	/// <param name="indexFilePath">The path of the file to save the index to. Overwritten if it exists.</param>
+	/// <returns>True if the file was saved, otherwise false.</returns>
+	bool save(const std::string& indexFilePath) const
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		try
+		{
+			FileStream stream(indexFilePath, "wb", false);
+			if (!stream.isWritable()) { return false; }
+			stream.writeExact(1, c_identifierSize, getIdentifier());
+			uint32_t numDirectories = 0;
+			for (auto& directory : _directories) { numDirectories += directory.second.exists ? 1 : 0; }
+			stream.writeExact(sizeof(numDirectories), 1, &numDirectories);
+			for (auto& directory : _directories)
+			{
+				if (!directory.second.exists) { continue; }
+				writeString(stream, directory.first);
+				stream.writeExact(sizeof(directory.second.modificationTime), 1, &directory.second.modificationTime);
+				const uint32_t numFiles = static_cast<uint32_t>(directory.second.files.size());
+				stream.writeExact(sizeof(numFiles), 1, &numFiles);
+				for (auto& file : directory.second.files) { writeString(stream, file); }
+			}
+		}
+		catch (const PvrError&)
+		{
+			return false;
+		}
+		_isModified = false;
+		return true;
+	}
+
+	/// <summary>Check if the index has changed since it was last saved, i.e. if saving it would make a difference.</summary>
+	/// <returns>True if directories have been listed or forgotten since the index was last saved</returns>
+	bool isModified() const
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _isModified;
+	}
+
+private:
+	struct Directory
+	{
+		std::unordered_set<std::string> files;
+		uint64_t modificationTime;
+		bool exists;
+		bool isVerified; // False for listings loaded from a file, until their modification time has been checked
+		Directory() : modificationTime(0), exists(false), isVerified(true) {}
+	};
+
+	enum
+	{
+		c_identifierSize = 8
+	};
+	static const char* getIdentifier() { return "PVRDIDX1"; }
+
+	mutable std::mutex _mutex;
+	mutable std::unordered_map<std::string, Directory> _directories;
+	mutable bool _isModified;
+	mutable uint64_t _numLookups;
+	mutable uint64_t _numDirectoriesListed;
+
+	static void splitPath(const std::string& filePath, std::string& directory, std::string& filename)
+	{
+		const std::string::size_type separator = filePath.find_last_of("/\\");
+		if (separator == std::string::npos)
+		{
+			directory.clear();
+			filename = filePath;
+		}
+		else
+		{
+			directory = filePath.substr(0, separator + 1);
+			filename = filePath.substr(separator + 1);
+		}
+	}
+
+	// The filesystems of Windows are case insensitive.
+	static std::string normalizeName(std::string name)
+	{
+#ifdef _WIN32
+		std::transform(name.begin(), name.end(), name.begin(), [](char c) { return static_cast<char>(tolower(static_cast<unsigned char>(c))); });
+#endif
+		return name;
+	}
+
+	static bool getDirectoryModificationTime(const std::string& directory, uint64_t& modificationTime)
+	{
+		const std::string path = directory.empty() ? std::string(".") : directory;
+#ifdef _WIN32
+		struct _stat64 directoryStat;
+		if (_stat64(path.c_str(), &directoryStat) != 0 || (directoryStat.st_mode & _S_IFDIR) == 0) { return false; }
+		modificationTime = static_cast<uint64_t>(directoryStat.st_mtime) * 1000000000ull;
+#else
+		struct stat directoryStat;
+		if (stat(path.c_str(), &directoryStat) != 0 || !S_ISDIR(directoryStat.st_mode)) { return false; }
+		modificationTime = static_cast<uint64_t>(directoryStat.st_mtime) * 1000000000ull;
+#if defined(__linux__)
+		modificationTime += static_cast<uint64_t>(directoryStat.st_mtim.tv_nsec);
+#endif
+#endif
+		return true;
+	}
+
+	static void listDirectory(const std::string& directory, Directory& listing)
+	{
+		listing.files.clear();
+		listing.exists = getDirectoryModificationTime(directory, listing.modificationTime);
+		if (!listing.exists) { return; }
+#ifdef _WIN32
+		WIN32_FIND_DATAA findData;
+		HANDLE find = FindFirstFileA((directory.empty() ? std::string(".\\*") : directory + "*").c_str(), &findData);
+		if (find == INVALID_HANDLE_VALUE) { return; }
+		do
+		{
+			if ((findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0) { listing.files.insert(normalizeName(findData.cFileName)); }
+		} while (FindNextFileA(find, &findData));
+		FindClose(find);
+#else
+		DIR* dir = opendir(directory.empty() ? "." : directory.c_str());
+		if (!dir) { return; }
+		while (struct dirent* entry = readdir(dir))
+		{
+			bool isFile = entry->d_type == DT_REG;
+			// Some filesystems do not report the type of the entries, and symbolic links need to be followed.
+			if (entry->d_type == DT_UNKNOWN || entry->d_type == DT_LNK)
+			{
+				struct stat fileStat;
+				isFile = stat((directory + entry->d_name).c_str(), &fileStat) == 0 && S_ISREG(fileStat.st_mode);
+			}
+			if (isFile) { listing.files.insert(entry->d_name); }
+		}
+		closedir(dir);
+#endif
+	}
+
+	// Must be called with the mutex locked.
+	const Directory& getDirectory(const std::string& directory) const
+	{
+		auto it = _directories.find(directory);
+		if (it != _directories.end())
+		{
+			Directory& listing = it->second;
+			if (listing.isVerified) { return listing; }
+			uint64_t modificationTime;
+			listing.isVerified = true;
+			if (getDirectoryModificationTime(directory, modificationTime) && modificationTime == listing.modificationTime) { return listing; }
+			listDirectory(directory, listing);
+			++_numDirectoriesListed;
+			_isModified = true;
+			return listing;
+		}
+		Directory& listing = _directories[directory];
+		listDirectory(directory, listing);
+		++_numDirectoriesListed;
+		_isModified = true;
+		return listing;
+	}
+
+	static std::string readString(const Stream& stream)
+	{
+		uint32_t length;
+		stream.readExact(sizeof(length), 1, &length);
+		std::string str(length, '\0');
+		if (length) { stream.readExact(1, length, &str[0]); }
+		return str;
+	}
+
+	static void writeString(Stream& stream, const std::string& str)
+	{
+		const uint32_t length = static_cast<uint32_t>(str.size());
+		stream.writeExact(sizeof(length), 1, &length);
+		if (length) { stream.writeExact(1, length, str.data()); }
+	}
+};
+} // namespace pvr
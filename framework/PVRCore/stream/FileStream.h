@@ -7,6 +7,10 @@
 #pragma once
 #include "PVRCore/stream/Stream.h"
 #include <string>
+#if !defined(_WIN32)
+#include <cerrno>
+#include <unistd.h>
+#endif
 
 namespace pvr {
 /// <summary>A FileStream is a Stream that is used to access a File in the filesystem of the platform.</summary>
@@ -144,6 +148,36 @@ private:
 		}
 	}
 
+#if !defined(_WIN32)
+	virtual void _readAt(uint64_t offset, size_t elementSize, size_t numElements, void* buffer) const override
+	{
+		// pread does not see data still buffered for writing by the FILE, so fall back to seek and read for writable files.
+		if (_isWritable) { return Stream::_readAt(offset, elementSize, numElements, buffer); }
+		if (!_file) { throw FileIOError(getFileName(), "[Filestream::readAt] Attempted to read empty stream."); }
+
+		const int fileDescriptor = fileno(_file);
+		unsigned char* destination = static_cast<unsigned char*>(buffer);
+		size_t remaining = elementSize * numElements;
+		while (remaining)
+		{
+			const ssize_t dataRead = pread(fileDescriptor, destination, remaining, static_cast<off_t>(offset));
+			if (dataRead < 0)
+			{
+				if (errno == EINTR) { continue; }
+				throw FileIOError(getFileName(), "[Filestream::readAt] Unknown Error.");
+			}
+			if (dataRead == 0) { throw FileEOFError(getFileName(), "[Filestream::readAt] Was attempting to read past the end of stream."); }
+			destination += dataRead;
+			offset += static_cast<uint64_t>(dataRead);
+			remaining -= static_cast<size_t>(dataRead);
+		}
+	}
+
+	// pread neither uses nor changes the position of the file, so it can be called from several threads. Windows has no equivalent for FILE
+	// objects, so reads are serialised through the stream position there.
+	virtual bool _supportsConcurrentReads() const override { return _file && !_isWritable; }
+#endif
+
 	void open()
 	{
 		if (_file) // If file exists, just reset it.
@@ -0,0 +1,209 @@
+/*!
+\brief A read-only Stream that accesses a file by mapping it into memory.
+\file PVRCore/stream/MappedFileStream.h
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+#pragma once
+#include "PVRCore/stream/Stream.h"
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace pvr {
+/// <summary>A MappedFileStream is a read-only Stream that maps a file of the filesystem into memory instead of reading it with fread.
+/// Reading from it is a plain memory copy, and readers that support it (see Stream::getSharedDataPointer) can reference the mapped data directly
+/// instead of copying it, so that for example a Texture loaded from a MappedFileStream does not need its own copy of the pixel data. The mapping is
+/// kept alive for as long as the stream or any pointer returned by getSharedDataPointer exists.</summary>
+class MappedFileStream : public Stream
+{
+private:
+	// Owns the mapping of the file. Shared with every pointer returned by getSharedDataPointer.
+	class Mapping
+	{
+	public:
+		explicit Mapping(const std::string& filePath) : _data(nullptr), _size(0), _isOpen(false)
+		{
+#ifdef _WIN32
+			_mappingHandle = NULL;
+			HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+			if (file == INVALID_HANDLE_VALUE) { return; }
+			LARGE_INTEGER fileSize;
+			if (!GetFileSizeEx(file, &fileSize))
+			{
+				CloseHandle(file);
+				return;
+			}
+			_size = static_cast<size_t>(fileSize.QuadPart);
+			_isOpen = true;
+			// Empty files cannot be mapped, but are still valid (empty) streams.
+			if (_size)
+			{
+				_mappingHandle = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+				if (_mappingHandle) { _data = MapViewOfFile(_mappingHandle, FILE_MAP_READ, 0, 0, 0); }
+				if (!_data) { _isOpen = false; }
+			}
+			// The mapping keeps its own reference to the file.
+			CloseHandle(file);
+#else
+			int file = ::open(filePath.c_str(), O_RDONLY);
+			if (file < 0) { return; }
+			struct stat fileStat;
+			if (fstat(file, &fileStat) != 0 || !S_ISREG(fileStat.st_mode))
+			{
+				::close(file);
+				return;
+			}
+			_size = static_cast<size_t>(fileStat.st_size);
+			_isOpen = true;
+			// Empty files cannot be mapped, but are still valid (empty) streams.
+			if (_size)
+			{
+				void* data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, file, 0);
+				if (data == MAP_FAILED) { _isOpen = false; }
+				else
+				{
+					_data = data;
+				}
+			}
+			// The mapping keeps its own reference to the file.
+			::close(file);
+#endif
+		}
+
+		~Mapping()
+		{
+#ifdef _WIN32
+			if (_data) { UnmapViewOfFile(_data); }
+			if (_mappingHandle) { CloseHandle(_mappingHandle); }
+#else
+			if (_data) { munmap(_data, _size); }
+#endif
+		}
+
+		const unsigned char* getData() const { return static_cast<const unsigned char*>(_data); }
+		size_t getSize() const { return _size; }
+		bool isOpen() const { return _isOpen; }
+
+	private:
+		void* _data;
+		size_t _size;
+		bool _isOpen;
+#ifdef _WIN32
+		HANDLE _mappingHandle;
+#endif
+		Mapping(const Mapping&) = delete;
+		Mapping& operator=(const Mapping&) = delete;
+	};
+
+	std::shared_ptr<Mapping> _mapping;
+	mutable size_t _position;
+
+public:
+	/// <summary>Create a new MappedFileStream of a specified file. The file is opened for reading and mapped into memory immediately.</summary>
+	/// <param name="filePath">The path of the file. Can be in any format the operating system understands (absolute, relative etc.)</param>
+	/// <param name="errorOnFileNotFound">OPTIONAL. Set this to false to avoid an exception when the file is not found or cannot be mapped. If set to
+	/// false, always check isReadable() before using.</param>
+	explicit MappedFileStream(const std::string& filePath, bool errorOnFileNotFound = true) : Stream(filePath, true, false, true), _position(0)
+	{
+		if (filePath.length() == 0) { throw InvalidOperationError("[MappedFileStream::MappedFileStream] Attempted to open a nonexistent file"); }
+		_mapping = std::make_shared<Mapping>(filePath);
+		if (!_mapping->isOpen())
+		{
+			_mapping.reset();
+			if (errorOnFileNotFound) { throw FileNotFoundError(filePath, "[MappedFileStream::MappedFileStream] Failed to open and map file."); }
+			_isReadable = false;
+			_isRandomAccess = false;
+		}
+	}
+
+	/// <summary>Create a new MappedFileStream from a filename</summary>
+	/// <param name="filename">The filename to create a stream for</param>
+	/// <param name="errorOnFileNotFound">OPTIONAL. Set this to false to avoid an error when the file is not found.</param>
+	/// <returns>Return a valid stream. If errorOnFileNotFound is false and the file could not be opened, the stream will not be readable.</returns>
+	static std::unique_ptr<Stream> createMappedFileStream(const std::string& filename, bool errorOnFileNotFound = true)
+	{
+		return std::make_unique<MappedFileStream>(filename, errorOnFileNotFound);
+	}
+
+	/// <summary>Get a pointer to the start of the mapped file. Only valid for as long as this stream exists - use getSharedDataPointer to keep the
+	/// mapping alive for longer.</summary>
+	/// <returns>A pointer to the start of the mapped file. Null if the file is empty or could not be opened.</returns>
+	const unsigned char* getMappedData() const { return _mapping ? _mapping->getData() : nullptr; }
+
+private:
+	virtual uint64_t _getPosition() const override { return _position; }
+
+	virtual uint64_t _getSize() const override { return _mapping ? _mapping->getSize() : 0; }
+
+	virtual void _read(size_t elementSize, size_t numElements, void* buffer, size_t& dataRead) const override
+	{
+		dataRead = 0;
+		if (!_mapping) { throw FileIOError(getFileName(), "[MappedFileStream::read] Attempted to read empty stream."); }
+		if (!elementSize || !numElements) { return; }
+
+		const size_t available = _mapping->getSize() - _position;
+		dataRead = std::min(numElements, available / elementSize);
+		if (dataRead)
+		{
+			memcpy(buffer, _mapping->getData() + _position, dataRead * elementSize);
+			_position += dataRead * elementSize;
+		}
+		if (dataRead != numElements) { throw FileEOFError(getFileName(), "[MappedFileStream::read] Was attempting to read past the end of stream."); }
+	}
+
+	virtual void _write(size_t, size_t, const void*, size_t& dataWritten) override
+	{
+		dataWritten = 0;
+		throw FileIOError(getFileName(), "[MappedFileStream::write] Attempted to write a read-only stream.");
+	}
+
+	virtual void _seek(long offset, SeekOrigin origin) const override
+	{
+		if (!_mapping)
+		{
+			if (offset) { throw FileIOError(getFileName(), "[MappedFileStream::seek] Attempt to seek in empty stream."); }
+			return;
+		}
+		int64_t newPosition = offset;
+		if (origin == SeekOriginFromCurrent) { newPosition += static_cast<int64_t>(_position); }
+		else if (origin == SeekOriginFromEnd)
+		{
+			newPosition += static_cast<int64_t>(_mapping->getSize());
+		}
+		if (newPosition < 0 || newPosition > static_cast<int64_t>(_mapping->getSize()))
+		{ throw FileIOError(getFileName(), "[MappedFileStream::seek] Attempt to seek outside of the stream."); }
+		_position = static_cast<size_t>(newPosition);
+	}
+
+	virtual void _readAt(uint64_t offset, size_t elementSize, size_t numElements, void* buffer) const override
+	{
+		if (!_mapping) { throw FileIOError(getFileName(), "[MappedFileStream::readAt] Attempted to read empty stream."); }
+		const uint64_t size = static_cast<uint64_t>(elementSize) * numElements;
+		if (offset > _mapping->getSize() || size > _mapping->getSize() - offset)
+		{ throw FileEOFError(getFileName(), "[MappedFileStream::readAt] Was attempting to read past the end of stream."); }
+		if (size) { memcpy(buffer, _mapping->getData() + offset, static_cast<size_t>(size)); }
+	}
+
+	virtual bool _supportsConcurrentReads() const override { return _mapping != nullptr; }
+
+	virtual std::shared_ptr<const unsigned char> _getSharedDataPointer() const override
+	{
+		if (!_mapping || !_mapping->getData()) { return nullptr; }
+		// Aliasing constructor: points into the mapping, but shares ownership of the whole mapping.
+		return std::shared_ptr<const unsigned char>(_mapping, _mapping->getData() + _position);
+	}
+};
+} // namespace pvr
@@ -192,6 +192,31 @@ public:
 	/// <returns>If suppored, returns the total amount of data in the stream. Otherwise, returns 0.</returns>
 	uint64_t getSize64() const { return _getSize(); }
 
+	/// <summary>If the contents of the stream are directly addressable in memory (for example, a memory mapped file), get a pointer to the data at the
+	/// current position of the stream. The returned pointer shares ownership of the underlying memory, so readers can reference the data for as long as
+	/// they need to instead of copying it. Does not change the position of the stream.</summary>
+	/// <returns>A pointer to the data at the current position, or null if the stream does not support direct access.</returns>
+	std::shared_ptr<const unsigned char> getSharedDataPointer() const { return _getSharedDataPointer(); }
+
+	/// <summary>Positional read. Read exactly a specified amount of items, starting at a specified offset from the start of the stream, otherwise
+	/// error. Requires a random access stream. Unless the stream supportsConcurrentReads(), the current position of the stream is used and restored, so
+	/// the call must not overlap with any other use of the stream.</summary>
+	/// <param name="offset">The offset, from the start of the stream, of the first byte to read.</param>
+	/// <param name="elementSize">The size of each element that will be read.</param>
+	/// <param name="numElements">The number of elements to read.</param>
+	/// <param name="buffer">The buffer into which to write the data.</param>
+	void readAt(uint64_t offset, size_t elementSize, size_t numElements, void* buffer) const
+	{
+		if (!_isReadable) { throw InvalidOperationError("[Stream::readAt]: Attempted to read non readable stream"); }
+		if (!isRandomAccess()) { throw InvalidOperationError(pvr::strings::createFormatted("[pvr::Stream] Attempted positional read on non-seekable stream '%s'", getFileName().c_str())); }
+		_readAt(offset, elementSize, numElements, buffer);
+	}
+
+	/// <summary>Returns true if several threads can call readAt on this stream at the same time. The current position of the stream is neither used
+	/// nor changed by such reads.</summary>
+	/// <returns>True if positional reads can be issued concurrently, otherwise false</returns>
+	bool supportsConcurrentReads() const { return _supportsConcurrentReads(); }
+
 	/// <summary>Convenience functions that reads all data in the stream into a contiguous block of memory of a specified
 	/// element type. Requires random-access stream.</summary>
 	/// <typeparam name="Type_">The type of item that will be read into.</typeparam>
@@ -281,6 +306,30 @@ protected:
 	/// <summary>The filename (conceptually, a resource identifier as there may be other sources for the stream)</summary>
 	std::string _fileName;
 
+	/// <summary>Override this function to implement positional reads without going through the current position of the stream. The default
+	/// implementation seeks to the offset, reads, and seeks back to the previous position.</summary>
+	/// <param name="offset">The offset, from the start of the stream, of the first byte to read.</param>
+	/// <param name="elementSize">The size of each element that will be read.</param>
+	/// <param name="numElements">The number of elements to read.</param>
+	/// <param name="buffer">The buffer into which to write the data.</param>
+	virtual void _readAt(uint64_t offset, size_t elementSize, size_t numElements, void* buffer) const
+	{
+		const uint64_t position = _getPosition();
+		size_t dataRead = 0;
+		_seek(static_cast<long>(offset), SeekOriginFromStart);
+		try
+		{
+			_read(elementSize, numElements, buffer, dataRead);
+		}
+		catch (...)
+		{
+			_seek(static_cast<long>(position), SeekOriginFromStart);
+			throw;
+		}
+		_seek(static_cast<long>(position), SeekOriginFromStart);
+		if (dataRead != numElements) { throw FileEOFError(*this, "[Stream::readAt]: Failed to read specified number of elements."); }
+	}
+
 private:
 	/// <summary>Override this function to implement a random access stream. After successful call, subsequent operation will
 	/// happen in the specified point.</summary>
@@ -295,6 +344,12 @@ private:
 	virtual uint64_t _getPosition() const = 0;
 	virtual uint64_t _getSize() const = 0;
 
+	/// <summary>Override this function for streams whose data is directly addressable in memory.</summary>
+	virtual std::shared_ptr<const unsigned char> _getSharedDataPointer() const { return nullptr; }
+
+	/// <summary>Override this function for streams whose _readAt implementation is safe to call from several threads at the same time.</summary>
+	virtual bool _supportsConcurrentReads() const { return false; }
+
 	// Disable copying and assign.
 	Stream& operator=(const Stream&) = delete;
 	Stream(const Stream&) = delete;
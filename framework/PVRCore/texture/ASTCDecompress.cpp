@@ -0,0 +1,834 @@
+/*!
+\brief Implementation of the ASTC LDR texture decompression functions.
+\file PVRCore/texture/ASTCDecompress.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+
+#include "ASTCDecompress.h"
+#include "ParallelDecompress.h"
+#include <algorithm>
+#include <cstring>
+
+namespace pvr {
+namespace {
+enum
+{
+	ASTC_BLOCK_SIZE = 16,
+	ASTC_MAX_WEIGHTS = 64,
+	ASTC_MIN_WEIGHT_BITS = 24,
+	ASTC_MAX_WEIGHT_BITS = 96,
+	ASTC_MAX_COLOR_VALUES = 18,
+	ASTC_MAX_TEXELS = 144,
+};
+
+struct Color32
+{
+	uint8_t red, green, blue, alpha;
+};
+
+const Color32 astcErrorColor = { 0xff, 0x00, 0xff, 0xff };
+
+// The integer sequence encoding of every quantization range, in increasing order of levels.
+struct QuantizationMode
+{
+	uint32_t levels;
+	uint32_t trits;
+	uint32_t quints;
+	uint32_t bits;
+};
+
+const QuantizationMode quantizationModes[] = { { 2, 0, 0, 1 }, { 3, 1, 0, 0 }, { 4, 0, 0, 2 }, { 5, 0, 1, 0 }, { 6, 1, 0, 1 }, { 8, 0, 0, 3 }, { 10, 0, 1, 1 }, { 12, 1, 0, 2 },
+	{ 16, 0, 0, 4 }, { 20, 0, 1, 2 }, { 24, 1, 0, 3 }, { 32, 0, 0, 5 }, { 40, 0, 1, 3 }, { 48, 1, 0, 4 }, { 64, 0, 0, 6 }, { 80, 0, 1, 4 }, { 96, 1, 0, 5 }, { 128, 0, 0, 7 },
+	{ 160, 0, 1, 5 }, { 192, 1, 0, 6 }, { 256, 0, 0, 8 } };
+
+enum
+{
+	QUANT_6 = 4,
+	QUANT_256 = 20,
+	NUM_QUANT_MODES = 21,
+	NUM_WEIGHT_QUANT_MODES = 12,
+};
+
+inline uint32_t getIseBitCount(uint32_t count, uint32_t quantMode)
+{
+	const QuantizationMode& mode = quantizationModes[quantMode];
+	return count * mode.bits + (mode.trits ? (8 * count + 4) / 5 : 0) + (mode.quints ? (7 * count + 2) / 3 : 0);
+}
+
+// Reads count (<= 32) bits starting at bit start of a 128 bit little-endian block. Bits at or above end read as zero.
+inline uint32_t readBits(const uint8_t* data, uint32_t start, uint32_t count, uint32_t end = 128)
+{
+	uint32_t result = 0;
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		const uint32_t bit = start + i;
+		if (bit < end) { result |= static_cast<uint32_t>((data[bit >> 3] >> (bit & 7)) & 1) << i; }
+	}
+	return result;
+}
+
+// Decodes count values of the integer sequence encoding starting at bit start.
+void decodeIse(const uint8_t* data, uint32_t start, uint32_t count, uint32_t quantMode, uint8_t* outValues)
+{
+	const QuantizationMode& mode = quantizationModes[quantMode];
+	const uint32_t bits = mode.bits;
+	const uint32_t mask = (1u << bits) - 1;
+	// The trailing trit/quint bits of an incomplete group are not stored and must be read as zero.
+	const uint32_t end = start + getIseBitCount(count, quantMode);
+	uint32_t position = start;
+
+	if (mode.trits)
+	{
+		for (uint32_t block = 0; block < count; block += 5)
+		{
+			// m0 T[1:0] m1 T[3:2] m2 T[4] m3 T[6:5] m4 T[7]
+			uint32_t m[5];
+			uint32_t t;
+			m[0] = readBits(data, position, bits, end), position += bits;
+			t = readBits(data, position, 2, end), position += 2;
+			m[1] = readBits(data, position, bits, end), position += bits;
+			t |= readBits(data, position, 2, end) << 2, position += 2;
+			m[2] = readBits(data, position, bits, end), position += bits;
+			t |= readBits(data, position, 1, end) << 4, position += 1;
+			m[3] = readBits(data, position, bits, end), position += bits;
+			t |= readBits(data, position, 2, end) << 5, position += 2;
+			m[4] = readBits(data, position, bits, end), position += bits;
+			t |= readBits(data, position, 1, end) << 7, position += 1;
+
+			uint32_t trits[5];
+			uint32_t c;
+			if (((t >> 2) & 7) == 7)
+			{
+				c = (((t >> 5) & 7) << 2) | (t & 3);
+				trits[4] = 2;
+				trits[3] = 2;
+			}
+			else
+			{
+				c = t & 0x1f;
+				if (((t >> 5) & 3) == 3)
+				{
+					trits[4] = 2;
+					trits[3] = (t >> 7) & 1;
+				}
+				else
+				{
+					trits[4] = (t >> 7) & 1;
+					trits[3] = (t >> 5) & 3;
+				}
+			}
+			if ((c & 3) == 3)
+			{
+				trits[2] = 2;
+				trits[1] = (c >> 4) & 1;
+				trits[0] = (((c >> 3) & 1) << 1) | (((c >> 2) & 1) & ~((c >> 3) & 1));
+			}
+			else if (((c >> 2) & 3) == 3)
+			{
+				trits[2] = 2;
+				trits[1] = 2;
+				trits[0] = c & 3;
+			}
+			else
+			{
+				trits[2] = (c >> 4) & 1;
+				trits[1] = (c >> 2) & 3;
+				trits[0] = (((c >> 1) & 1) << 1) | ((c & 1) & ~((c >> 1) & 1));
+			}
+			for (uint32_t i = 0; i < 5 && block + i < count; ++i) { outValues[block + i] = static_cast<uint8_t>((trits[i] << bits) | (m[i] & mask)); }
+		}
+	}
+	else if (mode.quints)
+	{
+		for (uint32_t block = 0; block < count; block += 3)
+		{
+			// m0 Q[2:0] m1 Q[4:3] m2 Q[6:5]
+			uint32_t m[3];
+			uint32_t q;
+			m[0] = readBits(data, position, bits, end), position += bits;
+			q = readBits(data, position, 3, end), position += 3;
+			m[1] = readBits(data, position, bits, end), position += bits;
+			q |= readBits(data, position, 2, end) << 3, position += 2;
+			m[2] = readBits(data, position, bits, end), position += bits;
+			q |= readBits(data, position, 2, end) << 5, position += 2;
+
+			uint32_t quints[3];
+			if (((q >> 1) & 3) == 3 && ((q >> 5) & 3) == 0)
+			{
+				const uint32_t q0 = q & 1;
+				quints[2] = (q0 << 2) | ((((q >> 4) & 1) & ~q0) << 1) | (((q >> 3) & 1) & ~q0);
+				quints[1] = 4;
+				quints[0] = 4;
+			}
+			else
+			{
+				uint32_t c;
+				if (((q >> 1) & 3) == 3)
+				{
+					quints[2] = 4;
+					c = (((q >> 3) & 3) << 3) | ((~(q >> 5) & 3) << 1) | (q & 1);
+				}
+				else
+				{
+					quints[2] = (q >> 5) & 3;
+					c = q & 0x1f;
+				}
+				if ((c & 7) == 5)
+				{
+					quints[1] = 4;
+					quints[0] = (c >> 3) & 3;
+				}
+				else
+				{
+					quints[1] = (c >> 3) & 3;
+					quints[0] = c & 7;
+				}
+			}
+			for (uint32_t i = 0; i < 3 && block + i < count; ++i) { outValues[block + i] = static_cast<uint8_t>((quints[i] << bits) | (m[i] & mask)); }
+		}
+	}
+	else
+	{
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			outValues[i] = static_cast<uint8_t>(readBits(data, position, bits, end));
+			position += bits;
+		}
+	}
+}
+
+// Unquantization tables, mapping every value of every quantization mode to [0..255] for colours and [0..64] for weights.
+struct UnquantizationTables
+{
+	uint8_t color[NUM_QUANT_MODES][256];
+	uint8_t weight[NUM_WEIGHT_QUANT_MODES][32];
+
+	UnquantizationTables()
+	{
+		memset(this, 0, sizeof(*this));
+		for (uint32_t quantMode = 0; quantMode < NUM_QUANT_MODES; ++quantMode)
+		{
+			for (uint32_t value = 0; value < quantizationModes[quantMode].levels; ++value) { color[quantMode][value] = unquantizeColor(quantMode, value); }
+		}
+		for (uint32_t quantMode = 0; quantMode < NUM_WEIGHT_QUANT_MODES; ++quantMode)
+		{
+			for (uint32_t value = 0; value < quantizationModes[quantMode].levels; ++value) { weight[quantMode][value] = unquantizeWeight(quantMode, value); }
+		}
+	}
+
+	static uint8_t unquantizeColor(uint32_t quantMode, uint32_t value)
+	{
+		const QuantizationMode& mode = quantizationModes[quantMode];
+		const uint32_t bits = mode.bits;
+		if (!mode.trits && !mode.quints)
+		{
+			// Replicate the bits to fill 8 bits.
+			uint32_t result = 0;
+			for (int32_t shift = 8 - static_cast<int32_t>(bits); shift > -static_cast<int32_t>(bits); shift -= static_cast<int32_t>(bits))
+			{ result |= shift >= 0 ? (value << shift) : (value >> -shift); }
+			return static_cast<uint8_t>(result & 0xff);
+		}
+		const uint32_t d = value >> bits;
+		const uint32_t a = (value & 1) ? 0x1ff : 0;
+		const uint32_t b = (value >> 1) & 1, c = (value >> 2) & 1, dd = (value >> 3) & 1, e = (value >> 4) & 1, f = (value >> 5) & 1;
+		uint32_t B = 0, C = 0;
+		if (mode.trits)
+		{
+			switch (bits)
+			{
+			case 1: C = 204; break;
+			case 2: B = (b << 8) | (b << 4) | (b << 2) | (b << 1), C = 93; break; // b000b0bb0
+			case 3: B = (c << 8) | (b << 7) | (c << 3) | (b << 2) | (c << 1) | b, C = 44; break; // cb000cbcb
+			case 4: B = (dd << 8) | (c << 7) | (b << 6) | (dd << 2) | (c << 1) | b, C = 22; break; // dcb000dcb
+			case 5: B = (e << 8) | (dd << 7) | (c << 6) | (b << 5) | (e << 1) | dd, C = 11; break; // edcb000ed
+			case 6: B = (f << 8) | (e << 7) | (dd << 6) | (c << 5) | (b << 4) | f, C = 5; break; // fedcb000f
+			}
+		}
+		else
+		{
+			switch (bits)
+			{
+			case 1: C = 113; break;
+			case 2: B = (b << 8) | (b << 3) | (b << 2), C = 54; break; // b0000bb00
+			case 3: B = (c << 8) | (b << 7) | (c << 2) | (b << 1) | c, C = 26; break; // cb0000cbc
+			case 4: B = (dd << 8) | (c << 7) | (b << 6) | (dd << 1) | c, C = 13; break; // dcb0000dc
+			case 5: B = (e << 8) | (dd << 7) | (c << 6) | (b << 5) | e, C = 6; break; // edcb0000e
+			}
+		}
+		uint32_t t = d * C + B;
+		t ^= a;
+		return static_cast<uint8_t>((a & 0x80) | (t >> 2));
+	}
+
+	static uint8_t unquantizeWeight(uint32_t quantMode, uint32_t value)
+	{
+		const QuantizationMode& mode = quantizationModes[quantMode];
+		const uint32_t bits = mode.bits;
+		uint32_t result;
+		if (!mode.trits && !mode.quints)
+		{
+			// Replicate the bits to fill 6 bits.
+			result = 0;
+			for (int32_t shift = 6 - static_cast<int32_t>(bits); shift > -static_cast<int32_t>(bits); shift -= static_cast<int32_t>(bits))
+			{ result |= shift >= 0 ? (value << shift) : (value >> -shift); }
+			result &= 0x3f;
+		}
+		else if (bits == 0)
+		{
+			const uint8_t tritValues[3] = { 0, 32, 63 };
+			const uint8_t quintValues[5] = { 0, 16, 32, 47, 63 };
+			result = mode.trits ? tritValues[value] : quintValues[value];
+		}
+		else
+		{
+			const uint32_t d = value >> bits;
+			const uint32_t a = (value & 1) ? 0x7f : 0;
+			const uint32_t b = (value >> 1) & 1, c = (value >> 2) & 1;
+			uint32_t B = 0, C = 0;
+			if (mode.trits)
+			{
+				switch (bits)
+				{
+				case 1: C = 50; break;
+				case 2: B = (b << 6) | (b << 2) | b, C = 23; break; // b000b0b
+				case 3: B = (c << 6) | (b << 5) | (c << 1) | b, C = 11; break; // cb000cb
+				}
+			}
+			else
+			{
+				switch (bits)
+				{
+				case 1: C = 28; break;
+				case 2: B = (b << 6) | (b << 1), C = 13; break; // b0000b0
+				}
+			}
+			uint32_t t = d * C + B;
+			t ^= a;
+			result = (a & 0x20) | (t >> 2);
+		}
+		return static_cast<uint8_t>(result > 32 ? result + 1 : result);
+	}
+};
+
+const UnquantizationTables& getUnquantizationTables()
+{
+	static const UnquantizationTables tables;
+	return tables;
+}
+
+inline uint32_t hash52(uint32_t inp)
+{
+	inp ^= inp >> 15;
+	inp *= 0xEEDE0891;
+	inp ^= inp >> 5;
+	inp += inp << 16;
+	inp ^= inp >> 7;
+	inp ^= inp >> 3;
+	inp ^= inp << 6;
+	inp ^= inp >> 17;
+	return inp;
+}
+
+// The partition pattern hash function of the ASTC specification (2D: z = 0).
+uint32_t selectPartition(int32_t seed, int32_t x, int32_t y, int32_t partitionCount, bool isSmallBlock)
+{
+	if (isSmallBlock)
+	{
+		x <<= 1;
+		y <<= 1;
+	}
+	seed += (partitionCount - 1) * 1024;
+	const uint32_t rnum = hash52(static_cast<uint32_t>(seed));
+	uint8_t seeds[8];
+	for (uint32_t i = 0; i < 8; ++i)
+	{
+		seeds[i] = static_cast<uint8_t>((rnum >> (i * 4)) & 0xf);
+		seeds[i] = static_cast<uint8_t>(seeds[i] * seeds[i]);
+	}
+
+	int32_t sh1, sh2;
+	if (seed & 1)
+	{
+		sh1 = (seed & 2) ? 4 : 5;
+		sh2 = (partitionCount == 3) ? 6 : 5;
+	}
+	else
+	{
+		sh1 = (partitionCount == 3) ? 6 : 5;
+		sh2 = (seed & 2) ? 4 : 5;
+	}
+	for (uint32_t i = 0; i < 8; i += 2)
+	{
+		seeds[i] = static_cast<uint8_t>(seeds[i] >> sh1);
+		seeds[i + 1] = static_cast<uint8_t>(seeds[i + 1] >> sh2);
+	}
+
+	int32_t a = (seeds[0] * x + seeds[1] * y + static_cast<int32_t>(rnum >> 14)) & 0x3f;
+	int32_t b = (seeds[2] * x + seeds[3] * y + static_cast<int32_t>(rnum >> 10)) & 0x3f;
+	int32_t c = (seeds[4] * x + seeds[5] * y + static_cast<int32_t>(rnum >> 6)) & 0x3f;
+	int32_t d = (seeds[6] * x + seeds[7] * y + static_cast<int32_t>(rnum >> 2)) & 0x3f;
+	if (partitionCount < 4) { d = 0; }
+	if (partitionCount < 3) { c = 0; }
+
+	if (a >= b && a >= c && a >= d) { return 0; }
+	else if (b >= c && b >= d)
+	{
+		return 1;
+	}
+	else if (c >= d)
+	{
+		return 2;
+	}
+	return 3;
+}
+
+struct BlockMode
+{
+	uint32_t weightWidth;
+	uint32_t weightHeight;
+	uint32_t weightQuantMode;
+	bool isDualPlane;
+};
+
+// Decodes the 11 bit block mode of a 2D block. Returns false for reserved or invalid modes.
+bool decodeBlockMode(uint32_t mode, BlockMode& outMode)
+{
+	uint32_t quantMode = (mode >> 4) & 1;
+	uint32_t highPrecision = (mode >> 9) & 1;
+	uint32_t dualPlane = (mode >> 10) & 1;
+	const uint32_t a = (mode >> 5) & 3;
+	uint32_t width = 0, height = 0;
+
+	if (mode & 3)
+	{
+		quantMode |= (mode & 3) << 1;
+		uint32_t b = (mode >> 7) & 3;
+		switch ((mode >> 2) & 3)
+		{
+		case 0: width = b + 4, height = a + 2; break;
+		case 1: width = b + 8, height = a + 2; break;
+		case 2: width = a + 2, height = b + 8; break;
+		default:
+			b &= 1;
+			if (mode & 0x100) { width = b + 2, height = a + 2; }
+			else
+			{
+				width = a + 2, height = b + 6;
+			}
+			break;
+		}
+	}
+	else
+	{
+		quantMode |= ((mode >> 2) & 3) << 1;
+		if (((mode >> 2) & 3) == 0) { return false; }
+		const uint32_t b = (mode >> 9) & 3;
+		switch ((mode >> 7) & 3)
+		{
+		case 0: width = 12, height = a + 2; break;
+		case 1: width = a + 2, height = 12; break;
+		case 2:
+			width = a + 6, height = b + 6;
+			dualPlane = 0;
+			highPrecision = 0;
+			break;
+		default:
+			if (a == 0) { width = 6, height = 10; }
+			else if (a == 1)
+			{
+				width = 10, height = 6;
+			}
+			else
+			{
+				return false;
+			}
+			break;
+		}
+	}
+
+	outMode.weightWidth = width;
+	outMode.weightHeight = height;
+	outMode.weightQuantMode = (quantMode - 2) + 6 * highPrecision;
+	outMode.isDualPlane = dualPlane != 0;
+
+	const uint32_t weightCount = width * height * (dualPlane + 1);
+	if (weightCount > ASTC_MAX_WEIGHTS) { return false; }
+	const uint32_t weightBits = getIseBitCount(weightCount, outMode.weightQuantMode);
+	return weightBits >= ASTC_MIN_WEIGHT_BITS && weightBits <= ASTC_MAX_WEIGHT_BITS;
+}
+
+inline int32_t clampColor(int32_t value) { return std::min(255, std::max(0, value)); }
+
+inline void bitTransferSigned(int32_t& a, int32_t& b)
+{
+	b >>= 1;
+	b |= a & 0x80;
+	a >>= 1;
+	a &= 0x3f;
+	if (a & 0x20) { a -= 0x40; }
+}
+
+inline void setEndpoint(int32_t* endpoint, int32_t red, int32_t green, int32_t blue, int32_t alpha)
+{
+	endpoint[0] = red;
+	endpoint[1] = green;
+	endpoint[2] = blue;
+	endpoint[3] = alpha;
+}
+
+inline void setBlueContractedEndpoint(int32_t* endpoint, int32_t red, int32_t green, int32_t blue, int32_t alpha)
+{
+	setEndpoint(endpoint, (red + blue) >> 1, (green + blue) >> 1, blue, alpha);
+}
+
+// Decodes the LDR colour endpoint modes. Returns false for the HDR modes, which are errors in the LDR profile.
+bool decodeColorEndpoints(uint32_t endpointMode, const uint8_t* unquantized, int32_t* endpoint0, int32_t* endpoint1)
+{
+	int32_t v[8];
+	for (uint32_t i = 0; i < ((endpointMode >> 2) + 1) * 2; ++i) { v[i] = unquantized[i]; }
+
+	switch (endpointMode)
+	{
+	case 0: // Luminance, direct
+		setEndpoint(endpoint0, v[0], v[0], v[0], 255);
+		setEndpoint(endpoint1, v[1], v[1], v[1], 255);
+		return true;
+	case 1: // Luminance, base + offset
+	{
+		const int32_t l0 = (v[0] >> 2) | (v[1] & 0xc0);
+		const int32_t l1 = std::min(255, l0 + (v[1] & 0x3f));
+		setEndpoint(endpoint0, l0, l0, l0, 255);
+		setEndpoint(endpoint1, l1, l1, l1, 255);
+		return true;
+	}
+	case 4: // Luminance + alpha, direct
+		setEndpoint(endpoint0, v[0], v[0], v[0], v[2]);
+		setEndpoint(endpoint1, v[1], v[1], v[1], v[3]);
+		return true;
+	case 5: // Luminance + alpha, base + offset
+		bitTransferSigned(v[1], v[0]);
+		bitTransferSigned(v[3], v[2]);
+		setEndpoint(endpoint0, v[0], v[0], v[0], v[2]);
+		setEndpoint(endpoint1, clampColor(v[0] + v[1]), clampColor(v[0] + v[1]), clampColor(v[0] + v[1]), clampColor(v[2] + v[3]));
+		return true;
+	case 6: // RGB, base + scale
+		setEndpoint(endpoint0, (v[0] * v[3]) >> 8, (v[1] * v[3]) >> 8, (v[2] * v[3]) >> 8, 255);
+		setEndpoint(endpoint1, v[0], v[1], v[2], 255);
+		return true;
+	case 8: // RGB, direct
+	case 12: // RGBA, direct
+	{
+		const int32_t alpha0 = endpointMode == 12 ? v[6] : 255;
+		const int32_t alpha1 = endpointMode == 12 ? v[7] : 255;
+		if (v[1] + v[3] + v[5] >= v[0] + v[2] + v[4])
+		{
+			setEndpoint(endpoint0, v[0], v[2], v[4], alpha0);
+			setEndpoint(endpoint1, v[1], v[3], v[5], alpha1);
+		}
+		else
+		{
+			setBlueContractedEndpoint(endpoint0, v[1], v[3], v[5], alpha1);
+			setBlueContractedEndpoint(endpoint1, v[0], v[2], v[4], alpha0);
+		}
+		return true;
+	}
+	case 9: // RGB, base + offset
+	case 13: // RGBA, base + offset
+	{
+		bitTransferSigned(v[1], v[0]);
+		bitTransferSigned(v[3], v[2]);
+		bitTransferSigned(v[5], v[4]);
+		int32_t alpha0 = 255, alpha1 = 255;
+		if (endpointMode == 13)
+		{
+			bitTransferSigned(v[7], v[6]);
+			alpha0 = v[6];
+			alpha1 = v[6] + v[7];
+		}
+		if (v[1] + v[3] + v[5] >= 0)
+		{
+			setEndpoint(endpoint0, v[0], v[2], v[4], alpha0);
+			setEndpoint(endpoint1, v[0] + v[1], v[2] + v[3], v[4] + v[5], alpha1);
+		}
+		else
+		{
+			setBlueContractedEndpoint(endpoint0, v[0] + v[1], v[2] + v[3], v[4] + v[5], alpha1);
+			setBlueContractedEndpoint(endpoint1, v[0], v[2], v[4], alpha0);
+		}
+		// Clamp after the blue contraction, as the reference decoder does.
+		for (uint32_t i = 0; i < 4; ++i)
+		{
+			endpoint0[i] = clampColor(endpoint0[i]);
+			endpoint1[i] = clampColor(endpoint1[i]);
+		}
+		return true;
+	}
+	case 10: // RGB, base + scale, plus two alphas
+		setEndpoint(endpoint0, (v[0] * v[3]) >> 8, (v[1] * v[3]) >> 8, (v[2] * v[3]) >> 8, v[4]);
+		setEndpoint(endpoint1, v[0], v[1], v[2], v[5]);
+		return true;
+	default: return false;
+	}
+}
+
+void fillErrorBlock(Color32* outTexels, uint32_t numTexels)
+{
+	for (uint32_t i = 0; i < numTexels; ++i) { outTexels[i] = astcErrorColor; }
+}
+
+// Decodes one ASTC block into blockWidth * blockHeight texels in row-major order.
+void decodeAstcBlock(const uint8_t* block, uint32_t blockWidth, uint32_t blockHeight, bool isSrgb, Color32* outTexels)
+{
+	const uint32_t numTexels = blockWidth * blockHeight;
+	const uint32_t blockModeBits = readBits(block, 0, 11);
+
+	// Void-extent blocks: a single constant colour stored as UNORM16.
+	if ((blockModeBits & 0x1ff) == 0x1fc)
+	{
+		// The dynamic range bit signifies an HDR (FP16) colour, which is an error in the LDR profile.
+		if (blockModeBits & 0x200) { return fillErrorBlock(outTexels, numTexels); }
+		Color32 color;
+		color.red = block[9];
+		color.green = block[11];
+		color.blue = block[13];
+		color.alpha = block[15];
+		for (uint32_t i = 0; i < numTexels; ++i) { outTexels[i] = color; }
+		return;
+	}
+
+	BlockMode mode;
+	if (!decodeBlockMode(blockModeBits, mode) || mode.weightWidth > blockWidth || mode.weightHeight > blockHeight) { return fillErrorBlock(outTexels, numTexels); }
+
+	const uint32_t partitionCount = readBits(block, 11, 2) + 1;
+	if (partitionCount == 4 && mode.isDualPlane) { return fillErrorBlock(outTexels, numTexels); }
+
+	const uint32_t numWeights = mode.weightWidth * mode.weightHeight * (mode.isDualPlane ? 2 : 1);
+	const uint32_t weightBits = getIseBitCount(numWeights, mode.weightQuantMode);
+	uint32_t belowWeightsPosition = 128 - weightBits;
+
+	// Colour endpoint modes.
+	uint32_t endpointModes[4];
+	uint32_t colorDataStart;
+	uint32_t partitionIndex = 0;
+	if (partitionCount == 1)
+	{
+		endpointModes[0] = readBits(block, 13, 4);
+		colorDataStart = 17;
+	}
+	else
+	{
+		partitionIndex = readBits(block, 13, 10);
+		colorDataStart = 29;
+		const uint32_t encodedModes = readBits(block, 23, 6);
+		const uint32_t baseClass = encodedModes & 3;
+		if (baseClass == 0)
+		{
+			for (uint32_t i = 0; i < partitionCount; ++i) { endpointModes[i] = (encodedModes >> 2) & 0xf; }
+		}
+		else
+		{
+			// The remaining bits of the modes are stored just below the weights.
+			const uint32_t extraBits = 3 * partitionCount - 4;
+			belowWeightsPosition -= extraBits;
+			const uint32_t allModes = encodedModes | (readBits(block, belowWeightsPosition, extraBits) << 6);
+			uint32_t bitPosition = 2;
+			for (uint32_t i = 0; i < partitionCount; ++i, ++bitPosition) { endpointModes[i] = (((allModes >> bitPosition) & 1) + baseClass - 1) << 2; }
+			for (uint32_t i = 0; i < partitionCount; ++i, bitPosition += 2) { endpointModes[i] |= (allModes >> bitPosition) & 3; }
+		}
+	}
+
+	uint32_t planeTwoComponent = 0;
+	if (mode.isDualPlane)
+	{
+		belowWeightsPosition -= 2;
+		planeTwoComponent = readBits(block, belowWeightsPosition, 2);
+	}
+
+	// Work out the quantization of the colour endpoints from the number of bits left.
+	uint32_t numColorValues = 0;
+	for (uint32_t i = 0; i < partitionCount; ++i) { numColorValues += ((endpointModes[i] >> 2) + 1) * 2; }
+	if (numColorValues > ASTC_MAX_COLOR_VALUES || belowWeightsPosition <= colorDataStart) { return fillErrorBlock(outTexels, numTexels); }
+	const uint32_t colorBits = belowWeightsPosition - colorDataStart;
+	int32_t colorQuantMode = QUANT_256;
+	while (colorQuantMode >= QUANT_6 && getIseBitCount(numColorValues, static_cast<uint32_t>(colorQuantMode)) > colorBits) { --colorQuantMode; }
+	if (colorQuantMode < QUANT_6) { return fillErrorBlock(outTexels, numTexels); }
+
+	const UnquantizationTables& tables = getUnquantizationTables();
+
+	uint8_t colorValues[ASTC_MAX_COLOR_VALUES];
+	decodeIse(block, colorDataStart, numColorValues, static_cast<uint32_t>(colorQuantMode), colorValues);
+	for (uint32_t i = 0; i < numColorValues; ++i) { colorValues[i] = tables.color[colorQuantMode][colorValues[i]]; }
+
+	int32_t endpoints[4][2][4];
+	for (uint32_t i = 0, valueIndex = 0; i < partitionCount; ++i)
+	{
+		if (!decodeColorEndpoints(endpointModes[i], colorValues + valueIndex, endpoints[i][0], endpoints[i][1])) { return fillErrorBlock(outTexels, numTexels); }
+		valueIndex += ((endpointModes[i] >> 2) + 1) * 2;
+	}
+
+	// The weights are stored bit-reversed from the top of the block.
+	uint8_t reversed[ASTC_BLOCK_SIZE];
+	for (uint32_t i = 0; i < ASTC_BLOCK_SIZE; ++i)
+	{
+		uint8_t value = block[ASTC_BLOCK_SIZE - 1 - i];
+		value = static_cast<uint8_t>(((value & 0xf0) >> 4) | ((value & 0x0f) << 4));
+		value = static_cast<uint8_t>(((value & 0xcc) >> 2) | ((value & 0x33) << 2));
+		value = static_cast<uint8_t>(((value & 0xaa) >> 1) | ((value & 0x55) << 1));
+		reversed[i] = value;
+	}
+	uint8_t weights[ASTC_MAX_WEIGHTS];
+	decodeIse(reversed, 0, numWeights, mode.weightQuantMode, weights);
+	for (uint32_t i = 0; i < numWeights; ++i) { weights[i] = tables.weight[mode.weightQuantMode][weights[i]]; }
+
+	// Bilinearly infill the weight grid to the texel grid, and interpolate the endpoints.
+	const uint32_t planeCount = mode.isDualPlane ? 2 : 1;
+	const int32_t ds = static_cast<int32_t>((1024 + blockWidth / 2) / (blockWidth - 1));
+	const int32_t dt = static_cast<int32_t>((1024 + blockHeight / 2) / (blockHeight - 1));
+	const bool isSmallBlock = numTexels < 31;
+	const int32_t weightWidth = static_cast<int32_t>(mode.weightWidth);
+	const int32_t weightHeight = static_cast<int32_t>(mode.weightHeight);
+
+	for (uint32_t t = 0; t < blockHeight; ++t)
+	{
+		for (uint32_t s = 0; s < blockWidth; ++s)
+		{
+			const int32_t gs = (ds * static_cast<int32_t>(s) * (weightWidth - 1) + 32) >> 6;
+			const int32_t gt = (dt * static_cast<int32_t>(t) * (weightHeight - 1) + 32) >> 6;
+			const int32_t js = gs >> 4, fs = gs & 0xf;
+			const int32_t jt = gt >> 4, ft = gt & 0xf;
+			const int32_t w11 = (fs * ft + 8) >> 4;
+			const int32_t w10 = ft - w11;
+			const int32_t w01 = fs - w11;
+			const int32_t w00 = 16 - fs - ft + w11;
+			const int32_t v0 = js + jt * weightWidth;
+
+			int32_t planeWeights[2];
+			for (uint32_t plane = 0; plane < planeCount; ++plane)
+			{
+				// Grid points outside of the weight grid always have a zero contribution.
+				const int32_t p00 = weights[v0 * static_cast<int32_t>(planeCount) + static_cast<int32_t>(plane)];
+				const int32_t p01 = w01 ? weights[(v0 + 1) * static_cast<int32_t>(planeCount) + static_cast<int32_t>(plane)] : 0;
+				const int32_t p10 = w10 ? weights[(v0 + weightWidth) * static_cast<int32_t>(planeCount) + static_cast<int32_t>(plane)] : 0;
+				const int32_t p11 = w11 ? weights[(v0 + weightWidth + 1) * static_cast<int32_t>(planeCount) + static_cast<int32_t>(plane)] : 0;
+				planeWeights[plane] = (p00 * w00 + p01 * w01 + p10 * w10 + p11 * w11 + 8) >> 4;
+			}
+
+			const uint32_t partition =
+				partitionCount > 1 ? selectPartition(static_cast<int32_t>(partitionIndex), static_cast<int32_t>(s), static_cast<int32_t>(t), static_cast<int32_t>(partitionCount), isSmallBlock) : 0;
+			uint8_t channels[4];
+			for (uint32_t channel = 0; channel < 4; ++channel)
+			{
+				const int32_t weight = (mode.isDualPlane && channel == planeTwoComponent) ? planeWeights[1] : planeWeights[0];
+				const int32_t e0 = endpoints[partition][0][channel];
+				const int32_t e1 = endpoints[partition][1][channel];
+				// Expand to 16 bits. sRGB endpoints are expanded with 0x80 so that the top 8 bits stay unbiased.
+				const int32_t c0 = isSrgb ? ((e0 << 8) | 0x80) : ((e0 << 8) | e0);
+				const int32_t c1 = isSrgb ? ((e1 << 8) | 0x80) : ((e1 << 8) | e1);
+				const int32_t c = (c0 * (64 - weight) + c1 * weight + 32) >> 6;
+				channels[channel] = static_cast<uint8_t>(c >> 8);
+			}
+			Color32& texel = outTexels[t * blockWidth + s];
+			texel.red = channels[0];
+			texel.green = channels[1];
+			texel.blue = channels[2];
+			texel.alpha = channels[3];
+		}
+	}
+}
+} // namespace
+
+bool getASTCBlockFootprint(CompressedPixelFormat format, uint32_t& outBlockWidth, uint32_t& outBlockHeight)
+{
+	switch (format)
+	{
+	case CompressedPixelFormat::ASTC_4x4: outBlockWidth = 4, outBlockHeight = 4; return true;
+	case CompressedPixelFormat::ASTC_5x4: outBlockWidth = 5, outBlockHeight = 4; return true;
+	case CompressedPixelFormat::ASTC_5x5: outBlockWidth = 5, outBlockHeight = 5; return true;
+	case CompressedPixelFormat::ASTC_6x5: outBlockWidth = 6, outBlockHeight = 5; return true;
+	case CompressedPixelFormat::ASTC_6x6: outBlockWidth = 6, outBlockHeight = 6; return true;
+	case CompressedPixelFormat::ASTC_8x5: outBlockWidth = 8, outBlockHeight = 5; return true;
+	case CompressedPixelFormat::ASTC_8x6: outBlockWidth = 8, outBlockHeight = 6; return true;
+	case CompressedPixelFormat::ASTC_8x8: outBlockWidth = 8, outBlockHeight = 8; return true;
+	case CompressedPixelFormat::ASTC_10x5: outBlockWidth = 10, outBlockHeight = 5; return true;
+	case CompressedPixelFormat::ASTC_10x6: outBlockWidth = 10, outBlockHeight = 6; return true;
+	case CompressedPixelFormat::ASTC_10x8: outBlockWidth = 10, outBlockHeight = 8; return true;
+	case CompressedPixelFormat::ASTC_10x10: outBlockWidth = 10, outBlockHeight = 10; return true;
+	case CompressedPixelFormat::ASTC_12x10: outBlockWidth = 12, outBlockHeight = 10; return true;
+	case CompressedPixelFormat::ASTC_12x12: outBlockWidth = 12, outBlockHeight = 12; return true;
+	default: return false;
+	}
+}
+
+uint32_t PVRTDecompressASTC(const void* srcData, uint32_t xDim, uint32_t yDim, void* dstData, CompressedPixelFormat format, bool isSrgb, const DecompressionOptions& options)
+{
+	uint32_t blockWidth, blockHeight;
+	if (!getASTCBlockFootprint(format, blockWidth, blockHeight)) { return 0; }
+
+	const uint32_t numBlocksX = (xDim + blockWidth - 1) / blockWidth;
+	const uint32_t numBlocksY = (yDim + blockHeight - 1) / blockHeight;
+	const uint8_t* input = static_cast<const uint8_t*>(srcData);
+	Color32* output = static_cast<Color32*>(dstData);
+
+	// Make sure the tables are built before any worker thread needs them.
+	getUnquantizationTables();
+
+	// Every row of blocks is independent. Partial blocks at the right and bottom edges are clipped. The cost of a block grows with its footprint, so
+	// each thread is given at least 64K texels, which take a few hundred microseconds to decode: smaller images are not worth a thread.
+	const uint32_t numThreads = impl::getDecompressionThreadCount(options.maxThreads, numBlocksY, std::max(1u, 65536u / (numBlocksX * blockWidth * blockHeight)));
+	impl::parallelForBands(0, static_cast<int32_t>(numBlocksY), numThreads, [&](int32_t firstBlockY, int32_t lastBlockY) {
+		Color32 texels[ASTC_MAX_TEXELS];
+		for (uint32_t blockY = static_cast<uint32_t>(firstBlockY); blockY < static_cast<uint32_t>(lastBlockY); ++blockY)
+		{
+			for (uint32_t blockX = 0; blockX < numBlocksX; ++blockX)
+			{
+				decodeAstcBlock(input + (blockY * numBlocksX + blockX) * ASTC_BLOCK_SIZE, blockWidth, blockHeight, isSrgb, texels);
+
+				const uint32_t numColumns = std::min(blockWidth, xDim - blockX * blockWidth);
+				const uint32_t numRows = std::min(blockHeight, yDim - blockY * blockHeight);
+				for (uint32_t row = 0; row < numRows; ++row)
+				{ memcpy(output + (blockY * blockHeight + row) * xDim + blockX * blockWidth, texels + row * blockWidth, numColumns * sizeof(Color32)); }
+			}
+		}
+	}, options.jobSystem);
+
+	return numBlocksX * numBlocksY * ASTC_BLOCK_SIZE;
+}
+
+Texture decompressAstcTexture(const Texture& texture, const DecompressionOptions& options)
+{
+	const CompressedPixelFormat format = static_cast<CompressedPixelFormat>(texture.getPixelFormat().getPixelTypeId());
+	uint32_t blockWidth, blockHeight;
+	if (texture.getPixelFormat().getPart().High != 0 || !getASTCBlockFootprint(format, blockWidth, blockHeight))
+	{ throw InvalidArgumentError("texture", "[decompressAstcTexture]: The texture is not in a 2D ASTC format"); }
+
+	// Set up the new texture and header. The colour space is kept, so sRGB data is decompressed to sRGB RGBA8888.
+	const bool isSrgb = texture.getColorSpace() == ColorSpace::sRGB;
+	TextureHeader cDecompressedHeader(texture);
+	cDecompressedHeader.setPixelFormat(GeneratePixelType4<'r', 'g', 'b', 'a', 8, 8, 8, 8>::ID);
+	cDecompressedHeader.setChannelType(VariableType::UnsignedByteNorm);
+	Texture cDecompressedTexture(cDecompressedHeader);
+
+	// Do decompression, one slice at a time. Each slice is decompressed in parallel.
+	for (uint32_t uiMIPLevel = 0; uiMIPLevel < texture.getNumMipMapLevels(); ++uiMIPLevel)
+	{
+		const uint32_t width = texture.getWidth(uiMIPLevel), height = texture.getHeight(uiMIPLevel);
+		for (uint32_t uiArray = 0; uiArray < texture.getNumArrayMembers(); ++uiArray)
+		{
+			for (uint32_t uiFace = 0; uiFace < texture.getNumFaces(); ++uiFace)
+			{
+				const uint8_t* source = texture.getDataPointer(uiMIPLevel, uiArray, uiFace);
+				uint8_t* destination = cDecompressedTexture.getDataPointer(uiMIPLevel, uiArray, uiFace);
+				for (uint32_t slice = 0; slice < texture.getDepth(uiMIPLevel); ++slice)
+				{
+					source += PVRTDecompressASTC(source, width, height, destination, format, isSrgb, options);
+					destination += static_cast<size_t>(width) * height * 4;
+				}
+			}
+		}
+	}
+	return cDecompressedTexture;
+}
+} // namespace pvr
+//!\endcond
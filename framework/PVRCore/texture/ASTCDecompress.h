@@ -0,0 +1,37 @@
+/*!
+\brief Contains functions to decompress 2D ASTC LDR formats into RGBA8888.
+\file PVRCore/texture/ASTCDecompress.h
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+#pragma once
+#include "PVRCore/texture/PVRTDecompress.h"
+namespace pvr {
+
+/// <summary>Get the block footprint of a 2D ASTC format.</summary>
+/// <param name="format">The compressed pixel format</param>
+/// <param name="outBlockWidth">The width of a block in texels</param>
+/// <param name="outBlockHeight">The height of a block in texels</param>
+/// <returns>True if the format is a 2D ASTC format, otherwise false (and the outputs are unchanged)</returns>
+bool getASTCBlockFootprint(CompressedPixelFormat format, uint32_t& outBlockWidth, uint32_t& outBlockHeight);
+
+/// <summary>Decompresses any 2D ASTC format (4x4 to 12x12) to RGBA 8888 using the LDR profile. Rows of blocks are decoded in
+/// parallel. HDR blocks, and blocks that are invalid in the LDR profile, are written as the ASTC error colour (magenta).
+/// Dimensions do not need to be multiples of the block footprint.</summary>
+/// <param name="srcData">The ASTC texture data to decompress</param>
+/// <param name="xDim">X dimension of the texture</param>
+/// <param name="yDim">Y dimension of the texture</param>
+/// <param name="dstData">The decompressed texture data. Must hold xDim * yDim * 4 bytes.</param>
+/// <param name="format">The format of the data. Must be one of the 2D ASTC formats.</param>
+/// <param name="isSrgb">Signifies whether the data is sRGB encoded. sRGB data is decoded to sRGB encoded RGBA8888.</param>
+/// <param name="options">Threading options</param>
+/// <returns>Return The number of bytes of ASTC data decompressed, or 0 if the format is not a 2D ASTC format.</returns>
+uint32_t PVRTDecompressASTC(const void* srcData, uint32_t xDim, uint32_t yDim, void* dstData, CompressedPixelFormat format, bool isSrgb, const DecompressionOptions& options);
+
+/// <summary>Decompress a 2D ASTC texture in software, for APIs or devices that do not support the format. Every surface is decompressed with
+/// PVRTDecompressASTC to UNORM RGBA8888. The colour space is kept, so sRGB data is decompressed to sRGB encoded RGBA8888.</summary>
+/// <param name="texture">The 2D ASTC texture to decompress</param>
+/// <param name="options">Threading and kernel selection options, used for every surface</param>
+/// <returns>The decompressed texture, with the same dimensions, MIP levels, array members and faces as the compressed one</returns>
+Texture decompressAstcTexture(const Texture& texture, const DecompressionOptions& options = DecompressionOptions());
+} // namespace pvr
@@ -0,0 +1,796 @@
+/*!
+\brief Implementation of the BC (S3TC/DXT, RGTC and BPTC) texture decompression functions.
+\file PVRCore/texture/BCDecompress.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+
+#include "BCDecompress.h"
+#include "ParallelDecompress.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PVR_DECOMPRESS_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define PVR_DECOMPRESS_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace pvr {
+namespace {
+enum
+{
+	BC_BLOCK_DIM = 4,
+	BC_NUM_TEXELS = 16,
+};
+
+struct Color32
+{
+	uint8_t red, green, blue, alpha;
+};
+
+struct ColorHalf
+{
+	uint16_t red, green, blue, alpha;
+};
+
+enum class BCBlockType
+{
+	BC1,
+	BC2,
+	BC3,
+	BC4,
+	BC5,
+	BC6,
+	BC7,
+};
+
+inline uint32_t readLittleEndian32(const uint8_t* data) { return data[0] | (data[1] << 8) | (data[2] << 16) | (static_cast<uint32_t>(data[3]) << 24); }
+
+inline uint64_t readLittleEndian64(const uint8_t* data) { return readLittleEndian32(data) | (static_cast<uint64_t>(readLittleEndian32(data + 4)) << 32); }
+
+inline Color32 makeColor32(uint32_t red, uint32_t green, uint32_t blue, uint32_t alpha)
+{
+	Color32 color = { static_cast<uint8_t>(red), static_cast<uint8_t>(green), static_cast<uint8_t>(blue), static_cast<uint8_t>(alpha) };
+	return color;
+}
+
+////////////////////////////////////////////// BC1 to BC5 //////////////////////////////////////////////
+// The colour and channel blocks are decoded in two steps: building the palette of the block, which is scalar, then selecting the palette entry of every
+// texel, which is what the SIMD kernels accelerate. Both kernels produce exactly the same output.
+typedef void (*PfnSelectColors)(const Color32* palette, uint32_t indices, Color32* outTexels);
+typedef void (*PfnSelectChannel)(const uint8_t* palette, uint64_t indices, uint8_t* outValues);
+
+void selectColors(const Color32* palette, uint32_t indices, Color32* outTexels)
+{
+	for (uint32_t i = 0; i < BC_NUM_TEXELS; ++i) { outTexels[i] = palette[(indices >> (i * 2)) & 3]; }
+}
+
+void selectChannel(const uint8_t* palette, uint64_t indices, uint8_t* outValues)
+{
+	for (uint32_t i = 0; i < BC_NUM_TEXELS; ++i) { outValues[i] = palette[(indices >> (i * 3)) & 7]; }
+}
+
+#if defined(PVR_DECOMPRESS_SSE2)
+inline __m128i selectBits(__m128i mask, __m128i ifSet, __m128i ifClear) { return _mm_or_si128(_mm_and_si128(mask, ifSet), _mm_andnot_si128(mask, ifClear)); }
+
+// Each row of 4 texels is one vector: the two bits of each texel's index are tested separately and used to select between the palette entries.
+void selectColorsSimd(const Color32* palette, uint32_t indices, Color32* outTexels)
+{
+	uint32_t entries[4];
+	memcpy(entries, palette, sizeof(entries));
+	const __m128i p0 = _mm_set1_epi32(static_cast<int32_t>(entries[0]));
+	const __m128i p1 = _mm_set1_epi32(static_cast<int32_t>(entries[1]));
+	const __m128i p2 = _mm_set1_epi32(static_cast<int32_t>(entries[2]));
+	const __m128i p3 = _mm_set1_epi32(static_cast<int32_t>(entries[3]));
+	const __m128i lowBits = _mm_setr_epi32(0x01, 0x04, 0x10, 0x40);
+	const __m128i highBits = _mm_setr_epi32(0x02, 0x08, 0x20, 0x80);
+	for (uint32_t row = 0; row < BC_BLOCK_DIM; ++row)
+	{
+		const __m128i rowIndices = _mm_set1_epi32(static_cast<int32_t>((indices >> (row * 8)) & 0xff));
+		const __m128i isLowSet = _mm_cmpeq_epi32(_mm_and_si128(rowIndices, lowBits), lowBits);
+		const __m128i isHighSet = _mm_cmpeq_epi32(_mm_and_si128(rowIndices, highBits), highBits);
+		const __m128i texels = selectBits(isHighSet, selectBits(isLowSet, p3, p2), selectBits(isLowSet, p1, p0));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(outTexels + row * BC_BLOCK_DIM), texels);
+	}
+}
+
+// All 16 texels are one vector of bytes, and the three bits of each index select between the 8 palette entries.
+void selectChannelSimd(const uint8_t* palette, uint64_t indices, uint8_t* outValues)
+{
+	uint8_t unpacked[BC_NUM_TEXELS];
+	for (uint32_t i = 0; i < BC_NUM_TEXELS; ++i) { unpacked[i] = static_cast<uint8_t>((indices >> (i * 3)) & 7); }
+	const __m128i index = _mm_loadu_si128(reinterpret_cast<const __m128i*>(unpacked));
+	__m128i entries[8];
+	for (uint32_t i = 0; i < 8; ++i) { entries[i] = _mm_set1_epi8(static_cast<char>(palette[i])); }
+	const __m128i bit0 = _mm_set1_epi8(1), bit1 = _mm_set1_epi8(2), bit2 = _mm_set1_epi8(4);
+	const __m128i is0 = _mm_cmpeq_epi8(_mm_and_si128(index, bit0), bit0);
+	const __m128i is1 = _mm_cmpeq_epi8(_mm_and_si128(index, bit1), bit1);
+	const __m128i is2 = _mm_cmpeq_epi8(_mm_and_si128(index, bit2), bit2);
+	const __m128i low = selectBits(is1, selectBits(is0, entries[3], entries[2]), selectBits(is0, entries[1], entries[0]));
+	const __m128i high = selectBits(is1, selectBits(is0, entries[7], entries[6]), selectBits(is0, entries[5], entries[4]));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(outValues), selectBits(is2, high, low));
+}
+#elif defined(PVR_DECOMPRESS_NEON)
+// Each row of 4 texels is one vector: the two bits of each texel's index are tested separately and used to select between the palette entries.
+void selectColorsSimd(const Color32* palette, uint32_t indices, Color32* outTexels)
+{
+	uint32_t entries[4];
+	memcpy(entries, palette, sizeof(entries));
+	const uint32x4_t p0 = vdupq_n_u32(entries[0]), p1 = vdupq_n_u32(entries[1]), p2 = vdupq_n_u32(entries[2]), p3 = vdupq_n_u32(entries[3]);
+	const uint32_t lowBitValues[4] = { 0x01, 0x04, 0x10, 0x40 };
+	const uint32_t highBitValues[4] = { 0x02, 0x08, 0x20, 0x80 };
+	const uint32x4_t lowBits = vld1q_u32(lowBitValues), highBits = vld1q_u32(highBitValues);
+	for (uint32_t row = 0; row < BC_BLOCK_DIM; ++row)
+	{
+		const uint32x4_t rowIndices = vdupq_n_u32((indices >> (row * 8)) & 0xff);
+		const uint32x4_t isLowSet = vtstq_u32(rowIndices, lowBits);
+		const uint32x4_t isHighSet = vtstq_u32(rowIndices, highBits);
+		const uint32x4_t texels = vbslq_u32(isHighSet, vbslq_u32(isLowSet, p3, p2), vbslq_u32(isLowSet, p1, p0));
+		vst1q_u32(reinterpret_cast<uint32_t*>(outTexels + row * BC_BLOCK_DIM), texels);
+	}
+}
+
+// The 8 palette entries are a table that the indices of 8 texels at a time are looked up in.
+void selectChannelSimd(const uint8_t* palette, uint64_t indices, uint8_t* outValues)
+{
+	uint8_t unpacked[BC_NUM_TEXELS];
+	for (uint32_t i = 0; i < BC_NUM_TEXELS; ++i) { unpacked[i] = static_cast<uint8_t>((indices >> (i * 3)) & 7); }
+	const uint8x8_t table = vld1_u8(palette);
+	vst1_u8(outValues, vtbl1_u8(table, vld1_u8(unpacked)));
+	vst1_u8(outValues + 8, vtbl1_u8(table, vld1_u8(unpacked + 8)));
+}
+#endif
+
+struct BCKernels
+{
+	PfnSelectColors selectColors;
+	PfnSelectChannel selectChannel;
+};
+
+inline Color32 expand565(uint32_t color)
+{
+	const uint32_t red = (color >> 11) & 0x1f, green = (color >> 5) & 0x3f, blue = color & 0x1f;
+	return makeColor32((red << 3) | (red >> 2), (green << 2) | (green >> 4), (blue << 3) | (blue >> 2), 255);
+}
+
+// Decodes the colour part of a BC1, BC2 or BC3 block. BC2 and BC3 blocks always use the four colour mode.
+void decodeColorBlock(const uint8_t* block, bool allowPunchthrough, const BCKernels& kernels, Color32* outTexels)
+{
+	const uint32_t color0 = block[0] | (block[1] << 8);
+	const uint32_t color1 = block[2] | (block[3] << 8);
+	Color32 palette[4];
+	palette[0] = expand565(color0);
+	palette[1] = expand565(color1);
+	if (color0 > color1 || !allowPunchthrough)
+	{
+		palette[2] = makeColor32((2 * palette[0].red + palette[1].red + 1) / 3, (2 * palette[0].green + palette[1].green + 1) / 3,
+			(2 * palette[0].blue + palette[1].blue + 1) / 3, 255);
+		palette[3] = makeColor32((palette[0].red + 2 * palette[1].red + 1) / 3, (palette[0].green + 2 * palette[1].green + 1) / 3,
+			(palette[0].blue + 2 * palette[1].blue + 1) / 3, 255);
+	}
+	else
+	{
+		palette[2] = makeColor32((palette[0].red + palette[1].red + 1) / 2, (palette[0].green + palette[1].green + 1) / 2, (palette[0].blue + palette[1].blue + 1) / 2, 255);
+		palette[3] = makeColor32(0, 0, 0, 0);
+	}
+	kernels.selectColors(palette, readLittleEndian32(block + 4), outTexels);
+}
+
+// Decodes a BC4 block (also the alpha part of BC3 and each channel of BC5) into 16 values. Signed values are written as SNORM8.
+void decodeChannelBlock(const uint8_t* block, bool isSigned, const BCKernels& kernels, uint8_t* outValues)
+{
+	uint8_t palette[8];
+	if (isSigned)
+	{
+		// -128 and -127 both represent -1.
+		const int32_t value0 = std::max(-127, static_cast<int32_t>(static_cast<int8_t>(block[0])));
+		const int32_t value1 = std::max(-127, static_cast<int32_t>(static_cast<int8_t>(block[1])));
+		int32_t values[8] = { value0, value1, 0, 0, 0, 0, -127, 127 };
+		// Round to nearest, away from zero, on both sides of zero.
+		const uint32_t numInterpolated = value0 > value1 ? 6 : 4;
+		for (uint32_t i = 1; i <= numInterpolated; ++i)
+		{
+			const int32_t numerator = static_cast<int32_t>(numInterpolated + 1 - i) * value0 + static_cast<int32_t>(i) * value1;
+			const int32_t divisor = static_cast<int32_t>(numInterpolated + 1);
+			values[i + 1] = (numerator + (numerator >= 0 ? divisor / 2 : -divisor / 2)) / divisor;
+		}
+		for (uint32_t i = 0; i < 8; ++i) { palette[i] = static_cast<uint8_t>(static_cast<int8_t>(values[i])); }
+	}
+	else
+	{
+		const uint32_t value0 = block[0], value1 = block[1];
+		palette[0] = static_cast<uint8_t>(value0);
+		palette[1] = static_cast<uint8_t>(value1);
+		palette[6] = 0;
+		palette[7] = 255;
+		const uint32_t numInterpolated = value0 > value1 ? 6 : 4;
+		for (uint32_t i = 1; i <= numInterpolated; ++i)
+		{ palette[i + 1] = static_cast<uint8_t>(((numInterpolated + 1 - i) * value0 + i * value1 + (numInterpolated + 1) / 2) / (numInterpolated + 1)); }
+	}
+	kernels.selectChannel(palette, readLittleEndian64(block) >> 16, outValues);
+}
+
+////////////////////////////////////////////// BC6H and BC7 //////////////////////////////////////////////
+// Reads the bits of a 128 bit block, least significant first.
+class BlockBitReader
+{
+public:
+	explicit BlockBitReader(const uint8_t* block) : _position(0)
+	{
+		_bits[0] = readLittleEndian64(block);
+		_bits[1] = readLittleEndian64(block + 8);
+	}
+
+	uint32_t read(uint32_t numBits)
+	{
+		if (!numBits) { return 0; }
+		uint64_t value = _bits[_position >> 6] >> (_position & 63);
+		if ((_position & 63) + numBits > 64) { value |= _bits[1] << (64 - (_position & 63)); }
+		_position += numBits;
+		return static_cast<uint32_t>(value & ((1ull << numBits) - 1));
+	}
+
+	uint32_t getPosition() const { return _position; }
+
+private:
+	uint64_t _bits[2];
+	uint32_t _position;
+};
+
+const uint8_t bptcWeights2[4] = { 0, 21, 43, 64 };
+const uint8_t bptcWeights3[8] = { 0, 9, 18, 27, 37, 46, 55, 64 };
+const uint8_t bptcWeights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+inline const uint8_t* getBptcWeights(uint32_t numIndexBits) { return numIndexBits == 2 ? bptcWeights2 : numIndexBits == 3 ? bptcWeights3 : bptcWeights4; }
+
+// The subset of every texel in the 64 two-subset partitions, one bit per texel. BC6H uses the first 32.
+const uint16_t bptcPartitions2[64] = { 0xcccc, 0x8888, 0xeeee, 0xecc8, 0xc880, 0xfeec, 0xfec8, 0xec80, 0xc800, 0xffec, 0xfe80, 0xe800, 0xffe8, 0xff00, 0xfff0,
+	0xf000, 0xf710, 0x008e, 0x7100, 0x08ce, 0x008c, 0x7310, 0x3100, 0x8cce, 0x088c, 0x3110, 0x6666, 0x366c, 0x17e8, 0x0ff0, 0x718e, 0x399c, 0xaaaa, 0xf0f0,
+	0x5a5a, 0x33cc, 0x3c3c, 0x55aa, 0x9696, 0xa55a, 0x73ce, 0x13c8, 0x324c, 0x3bdc, 0x6996, 0xc33c, 0x9966, 0x0660, 0x0272, 0x04e4, 0x4e40, 0x2720, 0xc936,
+	0x936c, 0x39c6, 0x639c, 0x9336, 0x9cc6, 0x817e, 0xe718, 0xccf0, 0x0fcc, 0x7744, 0xee22 };
+
+// The subset of every texel in the 64 three-subset partitions.
+const uint8_t bptcPartitions3[64][16] = { { 0, 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 1, 2, 2, 2, 2 }, { 0, 0, 0, 1, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 2, 1 },
+	{ 0, 0, 0, 0, 2, 0, 0, 1, 2, 2, 1, 1, 2, 2, 1, 1 }, { 0, 2, 2, 2, 0, 0, 2, 2, 0, 0, 1, 1, 0, 1, 1, 1 }, { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2 },
+	{ 0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 2, 2, 0, 0, 2, 2 }, { 0, 0, 2, 2, 0, 0, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1 }, { 0, 0, 1, 1, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1 },
+	{ 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2 }, { 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2 }, { 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2 },
+	{ 0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2 }, { 0, 1, 1, 2, 0, 1, 1, 2, 0, 1, 1, 2, 0, 1, 1, 2 }, { 0, 1, 2, 2, 0, 1, 2, 2, 0, 1, 2, 2, 0, 1, 2, 2 },
+	{ 0, 0, 1, 1, 0, 1, 1, 2, 1, 1, 2, 2, 1, 2, 2, 2 }, { 0, 0, 1, 1, 2, 0, 0, 1, 2, 2, 0, 0, 2, 2, 2, 0 }, { 0, 0, 0, 1, 0, 0, 1, 1, 0, 1, 1, 2, 1, 1, 2, 2 },
+	{ 0, 1, 1, 1, 0, 0, 1, 1, 2, 0, 0, 1, 2, 2, 0, 0 }, { 0, 0, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1, 2, 2 }, { 0, 0, 2, 2, 0, 0, 2, 2, 0, 0, 2, 2, 1, 1, 1, 1 },
+	{ 0, 1, 1, 1, 0, 1, 1, 1, 0, 2, 2, 2, 0, 2, 2, 2 }, { 0, 0, 0, 1, 0, 0, 0, 1, 2, 2, 2, 1, 2, 2, 2, 1 }, { 0, 0, 0, 0, 0, 0, 1, 1, 0, 1, 2, 2, 0, 1, 2, 2 },
+	{ 0, 0, 0, 0, 1, 1, 0, 0, 2, 2, 1, 0, 2, 2, 1, 0 }, { 0, 1, 2, 2, 0, 1, 2, 2, 0, 0, 1, 1, 0, 0, 0, 0 }, { 0, 0, 1, 2, 0, 0, 1, 2, 1, 1, 2, 2, 2, 2, 2, 2 },
+	{ 0, 1, 1, 0, 1, 2, 2, 1, 1, 2, 2, 1, 0, 1, 1, 0 }, { 0, 0, 0, 0, 0, 1, 1, 0, 1, 2, 2, 1, 1, 2, 2, 1 }, { 0, 0, 2, 2, 1, 1, 0, 2, 1, 1, 0, 2, 0, 0, 2, 2 },
+	{ 0, 1, 1, 0, 0, 1, 1, 0, 2, 0, 0, 2, 2, 2, 2, 2 }, { 0, 0, 1, 1, 0, 1, 2, 2, 0, 1, 2, 2, 0, 0, 1, 1 }, { 0, 0, 0, 0, 2, 0, 0, 0, 2, 2, 1, 1, 2, 2, 2, 1 },
+	{ 0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 2, 2, 2 }, { 0, 2, 2, 2, 0, 0, 2, 2, 0, 0, 1, 2, 0, 0, 1, 1 }, { 0, 0, 1, 1, 0, 0, 1, 2, 0, 0, 2, 2, 0, 2, 2, 2 },
+	{ 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0 }, { 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 0, 0, 0, 0 }, { 0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2, 0 },
+	{ 0, 1, 2, 0, 2, 0, 1, 2, 1, 2, 0, 1, 0, 1, 2, 0 }, { 0, 0, 1, 1, 2, 2, 0, 0, 1, 1, 2, 2, 0, 0, 1, 1 }, { 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 0, 0, 0, 0, 1, 1 },
+	{ 0, 1, 0, 1, 0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2 }, { 0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 2, 1, 2, 1, 2, 1 }, { 0, 0, 2, 2, 1, 1, 2, 2, 0, 0, 2, 2, 1, 1, 2, 2 },
+	{ 0, 0, 2, 2, 0, 0, 1, 1, 0, 0, 2, 2, 0, 0, 1, 1 }, { 0, 2, 2, 0, 1, 2, 2, 1, 0, 2, 2, 0, 1, 2, 2, 1 }, { 0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2, 0, 1, 0, 1 },
+	{ 0, 0, 0, 0, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1 }, { 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 2, 2, 2, 2 }, { 0, 2, 2, 2, 0, 1, 1, 1, 0, 2, 2, 2, 0, 1, 1, 1 },
+	{ 0, 0, 0, 2, 1, 1, 1, 2, 0, 0, 0, 2, 1, 1, 1, 2 }, { 0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1, 2 }, { 0, 2, 2, 2, 0, 1, 1, 1, 0, 1, 1, 1, 0, 2, 2, 2 },
+	{ 0, 0, 0, 2, 1, 1, 1, 2, 1, 1, 1, 2, 0, 0, 0, 2 }, { 0, 1, 1, 0, 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 2, 2 }, { 0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 1, 2 },
+	{ 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 2, 2, 2, 2, 2, 2 }, { 0, 0, 2, 2, 0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 2, 2 }, { 0, 0, 2, 2, 1, 1, 2, 2, 1, 1, 2, 2, 0, 0, 2, 2 },
+	{ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2 }, { 0, 0, 0, 2, 0, 0, 0, 1, 0, 0, 0, 2, 0, 0, 0, 1 }, { 0, 2, 2, 2, 1, 2, 2, 2, 0, 2, 2, 2, 1, 2, 2, 2 },
+	{ 0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2 }, { 0, 1, 1, 1, 2, 0, 1, 1, 2, 2, 0, 1, 2, 2, 2, 0 } };
+
+// The anchor texel of the second subset of the two-subset partitions, and of the second and third subsets of the three-subset partitions. The index of
+// an anchor texel is stored with one bit less, its most significant bit being implicitly zero.
+const uint8_t bptcAnchors2[64] = { 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 2, 8, 2, 2, 8, 8, 15, 2, 8, 2, 2, 8, 8, 2, 2, 15, 15, 6, 8, 2, 8,
+	15, 15, 2, 8, 2, 2, 2, 15, 15, 6, 6, 2, 6, 8, 15, 15, 2, 2, 15, 15, 15, 15, 15, 2, 2, 15 };
+const uint8_t bptcAnchors3Second[64] = { 3, 3, 15, 15, 8, 3, 15, 15, 8, 8, 6, 6, 6, 5, 3, 3, 3, 3, 8, 15, 3, 3, 6, 10, 5, 8, 8, 6, 8, 5, 15, 15, 8, 15, 3, 5, 6, 10,
+	8, 15, 15, 3, 15, 5, 15, 15, 15, 15, 3, 15, 5, 5, 5, 8, 5, 10, 5, 10, 8, 13, 15, 12, 3, 3 };
+const uint8_t bptcAnchors3Third[64] = { 15, 8, 8, 3, 15, 15, 3, 8, 15, 15, 15, 15, 15, 15, 15, 8, 15, 8, 15, 3, 15, 8, 15, 8, 3, 15, 6, 10, 15, 15, 10, 8, 15, 3, 15,
+	10, 10, 8, 9, 10, 6, 15, 8, 15, 3, 6, 6, 8, 15, 3, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 3, 15, 15, 8 };
+
+inline uint32_t getBptcSubset(uint32_t numSubsets, uint32_t partition, uint32_t texel)
+{
+	if (numSubsets == 1) { return 0; }
+	if (numSubsets == 2) { return (bptcPartitions2[partition] >> texel) & 1; }
+	return bptcPartitions3[partition][texel];
+}
+
+inline bool isBptcAnchor(uint32_t numSubsets, uint32_t partition, uint32_t texel)
+{
+	if (texel == 0) { return true; }
+	if (numSubsets == 2) { return texel == bptcAnchors2[partition]; }
+	if (numSubsets == 3) { return texel == bptcAnchors3Second[partition] || texel == bptcAnchors3Third[partition]; }
+	return false;
+}
+
+inline int32_t bptcInterpolate(int32_t endpoint0, int32_t endpoint1, uint32_t weight) { return ((64 - static_cast<int32_t>(weight)) * endpoint0 + static_cast<int32_t>(weight) * endpoint1 + 32) >> 6; }
+
+struct Bc7Mode
+{
+	uint8_t numSubsets;
+	uint8_t partitionBits;
+	uint8_t rotationBits;
+	uint8_t indexSelectionBits;
+	uint8_t colorBits;
+	uint8_t alphaBits;
+	uint8_t endpointPBits;
+	uint8_t sharedPBits;
+	uint8_t indexBits;
+	uint8_t secondaryIndexBits;
+};
+
+const Bc7Mode bc7Modes[8] = {
+	{ 3, 4, 0, 0, 4, 0, 1, 0, 3, 0 },
+	{ 2, 6, 0, 0, 6, 0, 0, 1, 3, 0 },
+	{ 3, 6, 0, 0, 5, 0, 0, 0, 2, 0 },
+	{ 2, 6, 0, 0, 7, 0, 1, 0, 2, 0 },
+	{ 1, 0, 2, 1, 5, 6, 0, 0, 2, 3 },
+	{ 1, 0, 2, 0, 7, 8, 0, 0, 2, 2 },
+	{ 1, 0, 0, 0, 7, 7, 1, 0, 4, 0 },
+	{ 2, 6, 0, 0, 5, 5, 1, 0, 2, 0 },
+};
+
+void decodeBc7Block(const uint8_t* block, Color32* outTexels)
+{
+	// The mode is the position of the lowest set bit of the first byte. Blocks without one are reserved, and decode to transparent black.
+	uint32_t modeIndex = 0;
+	while (modeIndex < 8 && !(block[0] & (1 << modeIndex))) { ++modeIndex; }
+	if (modeIndex == 8)
+	{
+		memset(outTexels, 0, sizeof(Color32) * BC_NUM_TEXELS);
+		return;
+	}
+	const Bc7Mode& mode = bc7Modes[modeIndex];
+
+	BlockBitReader reader(block);
+	reader.read(modeIndex + 1);
+	const uint32_t partition = reader.read(mode.partitionBits);
+	const uint32_t rotation = reader.read(mode.rotationBits);
+	const uint32_t indexSelection = reader.read(mode.indexSelectionBits);
+
+	// Endpoints are stored channel by channel, then the P-bits, which become the least significant bit of every channel of their endpoints.
+	const uint32_t numEndpoints = mode.numSubsets * 2u;
+	uint32_t endpoints[6][4];
+	for (uint32_t channel = 0; channel < 3; ++channel)
+	{
+		for (uint32_t endpoint = 0; endpoint < numEndpoints; ++endpoint) { endpoints[endpoint][channel] = reader.read(mode.colorBits); }
+	}
+	for (uint32_t endpoint = 0; endpoint < numEndpoints; ++endpoint) { endpoints[endpoint][3] = reader.read(mode.alphaBits); }
+	uint32_t pBits[6] = { 0, 0, 0, 0, 0, 0 };
+	if (mode.endpointPBits)
+	{
+		for (uint32_t endpoint = 0; endpoint < numEndpoints; ++endpoint) { pBits[endpoint] = reader.read(1); }
+	}
+	if (mode.sharedPBits)
+	{
+		for (uint32_t subset = 0; subset < mode.numSubsets; ++subset) { pBits[subset * 2] = pBits[subset * 2 + 1] = reader.read(1); }
+	}
+	const bool hasPBits = mode.endpointPBits || mode.sharedPBits;
+	for (uint32_t endpoint = 0; endpoint < numEndpoints; ++endpoint)
+	{
+		for (uint32_t channel = 0; channel < 4; ++channel)
+		{
+			uint32_t numBits = channel < 3 ? mode.colorBits : mode.alphaBits;
+			if (!numBits)
+			{
+				endpoints[endpoint][channel] = 255;
+				continue;
+			}
+			uint32_t value = endpoints[endpoint][channel];
+			if (hasPBits)
+			{
+				value = (value << 1) | pBits[endpoint];
+				++numBits;
+			}
+			// Expand to 8 bits by replicating the most significant bits.
+			value <<= (8 - numBits);
+			endpoints[endpoint][channel] = value | (value >> numBits);
+		}
+	}
+
+	uint32_t indices[BC_NUM_TEXELS];
+	uint32_t secondaryIndices[BC_NUM_TEXELS];
+	for (uint32_t texel = 0; texel < BC_NUM_TEXELS; ++texel) { indices[texel] = reader.read(mode.indexBits - (isBptcAnchor(mode.numSubsets, partition, texel) ? 1 : 0)); }
+	if (mode.secondaryIndexBits)
+	{
+		for (uint32_t texel = 0; texel < BC_NUM_TEXELS; ++texel) { secondaryIndices[texel] = reader.read(mode.secondaryIndexBits - (texel == 0 ? 1 : 0)); }
+	}
+
+	// With two sets of indices, the colour uses the first and the alpha the second, unless the index selection bit swaps them.
+	const uint32_t* colorIndices = indices;
+	const uint32_t* alphaIndices = indices;
+	uint32_t colorIndexBits = mode.indexBits, alphaIndexBits = mode.indexBits;
+	if (mode.secondaryIndexBits)
+	{
+		alphaIndices = secondaryIndices;
+		alphaIndexBits = mode.secondaryIndexBits;
+		if (indexSelection)
+		{
+			std::swap(colorIndices, alphaIndices);
+			std::swap(colorIndexBits, alphaIndexBits);
+		}
+	}
+	const uint8_t* colorWeights = getBptcWeights(colorIndexBits);
+	const uint8_t* alphaWeights = getBptcWeights(alphaIndexBits);
+
+	for (uint32_t texel = 0; texel < BC_NUM_TEXELS; ++texel)
+	{
+		const uint32_t* endpoint0 = endpoints[getBptcSubset(mode.numSubsets, partition, texel) * 2];
+		const uint32_t* endpoint1 = endpoint0 + 4;
+		const uint32_t colorWeight = colorWeights[colorIndices[texel]];
+		const uint32_t alphaWeight = alphaWeights[alphaIndices[texel]];
+		uint8_t texelValues[4];
+		for (uint32_t channel = 0; channel < 3; ++channel)
+		{ texelValues[channel] = static_cast<uint8_t>(bptcInterpolate(static_cast<int32_t>(endpoint0[channel]), static_cast<int32_t>(endpoint1[channel]), colorWeight)); }
+		texelValues[3] = static_cast<uint8_t>(bptcInterpolate(static_cast<int32_t>(endpoint0[3]), static_cast<int32_t>(endpoint1[3]), alphaWeight));
+		// The rotation swaps the alpha channel with one of the colour channels.
+		if (rotation) { std::swap(texelValues[3], texelValues[rotation - 1]); }
+		outTexels[texel] = makeColor32(texelValues[0], texelValues[1], texelValues[2], texelValues[3]);
+	}
+}
+
+// The endpoint fields of BC6H blocks: w and x are the endpoints of the first region, y and z those of the second.
+enum Bc6Field
+{
+	RW,
+	GW,
+	BW,
+	RX,
+	GX,
+	BX,
+	RY,
+	GY,
+	BY,
+	RZ,
+	GZ,
+	BZ,
+	BC6_NUM_FIELDS
+};
+
+struct Bc6FieldBit
+{
+	uint8_t field;
+	uint8_t bit;
+};
+
+struct Bc6Mode
+{
+	uint8_t modeValue;
+	uint8_t numModeBits;
+	uint8_t numRegions;
+	bool isTransformed; // Whether the endpoints other than w are stored as deltas from w
+	uint8_t endpointBits;
+	uint8_t deltaBits[3];
+	const char* layout; // The order of the endpoint bits in the block, after the mode bits. See getBc6Layouts.
+};
+
+const Bc6Mode bc6Modes[14] = {
+	{ 0x00, 2, 2, true, 10, { 5, 5, 5 },
+		"gy4 by4 bz4 rw0:9 gw0:9 bw0:9 rx0:4 gz4 gy0:3 gx0:4 bz0 gz0:3 bx0:4 bz1 by0:3 ry0:4 bz2 rz0:4 bz3" },
+	{ 0x01, 2, 2, true, 7, { 6, 6, 6 },
+		"gy5 gz4 gz5 rw0:6 bz0 bz1 by4 gw0:6 by5 bz2 gy4 bw0:6 bz3 bz5 bz4 rx0:5 gy0:3 gx0:5 gz0:3 bx0:5 by0:3 ry0:5 rz0:5" },
+	{ 0x02, 5, 2, true, 11, { 5, 4, 4 }, "rw0:9 gw0:9 bw0:9 rx0:4 rw10 gy0:3 gx0:3 gw10 bz0 gz0:3 bx0:3 bw10 bz1 by0:3 ry0:4 bz2 rz0:4 bz3" },
+	{ 0x06, 5, 2, true, 11, { 4, 5, 4 }, "rw0:9 gw0:9 bw0:9 rx0:3 rw10 gz4 gy0:3 gx0:4 gw10 gz0:3 bx0:3 bw10 bz1 by0:3 ry0:3 bz0 bz2 rz0:3 gy4 bz3" },
+	{ 0x0a, 5, 2, true, 11, { 4, 4, 5 }, "rw0:9 gw0:9 bw0:9 rx0:3 rw10 by4 gy0:3 gx0:3 gw10 bz0 gz0:3 bx0:4 bw10 by0:3 ry0:3 bz1 bz2 rz0:3 bz4 bz3" },
+	{ 0x0e, 5, 2, true, 9, { 5, 5, 5 }, "rw0:8 by4 gw0:8 gy4 bw0:8 bz4 rx0:4 gz4 gy0:3 gx0:4 bz0 gz0:3 bx0:4 bz1 by0:3 ry0:4 bz2 rz0:4 bz3" },
+	{ 0x12, 5, 2, true, 8, { 6, 5, 5 }, "rw0:7 gz4 by4 gw0:7 bz2 gy4 bw0:7 bz3 bz4 rx0:5 gy0:3 gx0:4 bz0 gz0:3 bx0:4 bz1 by0:3 ry0:5 rz0:5" },
+	{ 0x16, 5, 2, true, 8, { 5, 6, 5 }, "rw0:7 bz0 by4 gw0:7 gy5 gy4 bw0:7 gz5 bz4 rx0:4 gz4 gy0:3 gx0:5 gz0:3 bx0:4 bz1 by0:3 ry0:4 bz2 rz0:4 bz3" },
+	{ 0x1a, 5, 2, true, 8, { 5, 5, 6 }, "rw0:7 bz1 by4 gw0:7 by5 gy4 bw0:7 bz5 bz4 rx0:4 gz4 gy0:3 gx0:4 bz0 gz0:3 bx0:5 by0:3 ry0:4 bz2 rz0:4 bz3" },
+	{ 0x1e, 5, 2, false, 6, { 6, 6, 6 },
+		"rw0:5 gz4 bz0 bz1 by4 gw0:5 gy5 by5 bz2 gy4 bw0:5 gz5 bz3 bz5 bz4 rx0:5 gy0:3 gx0:5 gz0:3 bx0:5 by0:3 ry0:5 rz0:5" },
+	{ 0x03, 5, 1, false, 10, { 10, 10, 10 }, "rw0:9 gw0:9 bw0:9 rx0:9 gx0:9 bx0:9" },
+	{ 0x07, 5, 1, true, 11, { 9, 9, 9 }, "rw0:9 gw0:9 bw0:9 rx0:8 rw10 gx0:8 gw10 bx0:8 bw10" },
+	{ 0x0b, 5, 1, true, 12, { 8, 8, 8 }, "rw0:9 gw0:9 bw0:9 rx0:7 rw11:10 gx0:7 gw11:10 bx0:7 bw11:10" },
+	{ 0x0f, 5, 1, true, 16, { 4, 4, 4 }, "rw0:9 gw0:9 bw0:9 rx0:3 rw15:10 gx0:3 gw15:10 bx0:3 bw15:10" },
+};
+
+enum
+{
+	BC6_TWO_REGION_HEADER_BITS = 77,
+	BC6_ONE_REGION_HEADER_BITS = 65,
+};
+
+struct Bc6Layout
+{
+	Bc6FieldBit bits[BC6_TWO_REGION_HEADER_BITS];
+	uint32_t numBits;
+};
+
+// Parses the layouts of the BC6H modes once. A layout is a list of bit ranges: "rw0:9" are bits 0 to 9 of rw in increasing order, "rw15:10" bits 15
+// down to 10, "gy4" the single bit 4 of gy.
+const Bc6Layout* getBc6Layouts()
+{
+	static const struct Layouts
+	{
+		Bc6Layout layouts[14];
+		Layouts()
+		{
+			for (uint32_t mode = 0; mode < 14; ++mode)
+			{
+				Bc6Layout& layout = layouts[mode];
+				layout.numBits = 0;
+				const char* text = bc6Modes[mode].layout;
+				while (*text)
+				{
+					const uint8_t field = static_cast<uint8_t>((text[1] == 'w' ? 0 : text[1] == 'x' ? 3 : text[1] == 'y' ? 6 : 9) + (text[0] == 'r' ? 0 : text[0] == 'g' ? 1 : 2));
+					text += 2;
+					const uint32_t first = static_cast<uint32_t>(strtoul(text, const_cast<char**>(&text), 10));
+					uint32_t last = first;
+					if (*text == ':') { last = static_cast<uint32_t>(strtoul(text + 1, const_cast<char**>(&text), 10)); }
+					for (int32_t bit = static_cast<int32_t>(first);; bit += (last >= first ? 1 : -1))
+					{
+						layout.bits[layout.numBits].field = field;
+						layout.bits[layout.numBits].bit = static_cast<uint8_t>(bit);
+						++layout.numBits;
+						if (bit == static_cast<int32_t>(last)) { break; }
+					}
+					while (*text == ' ') { ++text; }
+				}
+			}
+		}
+	} layouts;
+	return layouts.layouts;
+}
+
+inline int32_t signExtend(int32_t value, uint32_t numBits) { return (value & (1 << (numBits - 1))) ? (value | ~((1 << numBits) - 1)) : (value & ((1 << numBits) - 1)); }
+
+// Scales a quantized endpoint to 16 bits (unsigned) or 15 bits and a sign (signed).
+int32_t bc6Unquantize(int32_t value, uint32_t numBits, bool isSigned)
+{
+	if (!isSigned)
+	{
+		if (numBits >= 15 || value == 0) { return value; }
+		if (value == (1 << numBits) - 1) { return 0xffff; }
+		return ((value << 16) + 0x8000) >> numBits;
+	}
+	if (numBits >= 16) { return value; }
+	const bool isNegative = value < 0;
+	int32_t magnitude = isNegative ? -value : value;
+	if (magnitude != 0)
+	{
+		if (magnitude >= (1 << (numBits - 1)) - 1) { magnitude = 0x7fff; }
+		else
+		{
+			magnitude = ((magnitude << 15) + 0x4000) >> (numBits - 1);
+		}
+	}
+	return isNegative ? -magnitude : magnitude;
+}
+
+// Scales an interpolated value to the bit pattern of a half float.
+uint16_t bc6ToHalf(int32_t value, bool isSigned)
+{
+	if (!isSigned) { return static_cast<uint16_t>((value * 31) >> 6); }
+	if (value < 0) { return static_cast<uint16_t>(0x8000 | (((-value) * 31) >> 5)); }
+	return static_cast<uint16_t>((value * 31) >> 5);
+}
+
+void decodeBc6Block(const uint8_t* block, bool isSigned, const Bc6Layout* layouts, ColorHalf* outTexels)
+{
+	uint32_t modeValue = block[0] & 0x3;
+	if (modeValue & 2) { modeValue = block[0] & 0x1f; }
+	uint32_t modeIndex = 0;
+	while (modeIndex < 14 && bc6Modes[modeIndex].modeValue != modeValue) { ++modeIndex; }
+	if (modeIndex == 14)
+	{
+		// Reserved modes decode to black.
+		for (uint32_t texel = 0; texel < BC_NUM_TEXELS; ++texel)
+		{
+			const ColorHalf black = { 0, 0, 0, 0x3c00 };
+			outTexels[texel] = black;
+		}
+		return;
+	}
+	const Bc6Mode& mode = bc6Modes[modeIndex];
+	const Bc6Layout& layout = layouts[modeIndex];
+
+	BlockBitReader reader(block);
+	reader.read(mode.numModeBits);
+	int32_t fields[BC6_NUM_FIELDS] = {};
+	for (uint32_t i = 0; i < layout.numBits; ++i) { fields[layout.bits[i].field] |= static_cast<int32_t>(reader.read(1) << layout.bits[i].bit); }
+	const uint32_t partition = reader.read(mode.numRegions == 2 ? 5 : 0);
+
+	// Recover the endpoints: deltas are signed, and are added to the base endpoint, wrapping around at its precision.
+	const uint32_t numFields = mode.numRegions * 6u;
+	const int32_t endpointMask = (1 << mode.endpointBits) - 1;
+	for (uint32_t channel = 0; channel < 3; ++channel)
+	{
+		if (isSigned) { fields[RW + channel] = signExtend(fields[RW + channel], mode.endpointBits); }
+		for (uint32_t field = RX + channel; field < numFields; field += 3)
+		{
+			if (mode.isTransformed)
+			{
+				fields[field] = (fields[RW + channel] + signExtend(fields[field], mode.deltaBits[channel])) & endpointMask;
+				if (isSigned) { fields[field] = signExtend(fields[field], mode.endpointBits); }
+			}
+			else if (isSigned)
+			{
+				fields[field] = signExtend(fields[field], mode.endpointBits);
+			}
+		}
+	}
+	int32_t endpoints[4][3];
+	for (uint32_t endpoint = 0; endpoint < mode.numRegions * 2u; ++endpoint)
+	{
+		for (uint32_t channel = 0; channel < 3; ++channel) { endpoints[endpoint][channel] = bc6Unquantize(fields[endpoint * 3 + channel], mode.endpointBits, isSigned); }
+	}
+
+	const uint32_t indexBits = mode.numRegions == 2 ? 3 : 4;
+	const uint8_t* weights = getBptcWeights(indexBits);
+	for (uint32_t texel = 0; texel < BC_NUM_TEXELS; ++texel)
+	{
+		const uint32_t index = reader.read(indexBits - (isBptcAnchor(mode.numRegions, partition, texel) ? 1 : 0));
+		const int32_t* endpoint0 = endpoints[getBptcSubset(mode.numRegions, partition, texel) * 2];
+		const int32_t* endpoint1 = endpoint0 + 3;
+		outTexels[texel].red = bc6ToHalf(bptcInterpolate(endpoint0[0], endpoint1[0], weights[index]), isSigned);
+		outTexels[texel].green = bc6ToHalf(bptcInterpolate(endpoint0[1], endpoint1[1], weights[index]), isSigned);
+		outTexels[texel].blue = bc6ToHalf(bptcInterpolate(endpoint0[2], endpoint1[2], weights[index]), isSigned);
+		outTexels[texel].alpha = 0x3c00;
+	}
+}
+
+////////////////////////////////////////////// Block dispatch //////////////////////////////////////////////
+void decodeBcBlock(const uint8_t* block, BCBlockType type, bool isSigned, const BCKernels& kernels, const Bc6Layout* bc6Layouts, void* outTexels)
+{
+	Color32* texels = static_cast<Color32*>(outTexels);
+	uint8_t values[BC_NUM_TEXELS];
+	switch (type)
+	{
+	case BCBlockType::BC1: decodeColorBlock(block, true, kernels, texels); break;
+	case BCBlockType::BC2:
+	{
+		decodeColorBlock(block + 8, false, kernels, texels);
+		const uint64_t alphas = readLittleEndian64(block);
+		for (uint32_t i = 0; i < BC_NUM_TEXELS; ++i) { texels[i].alpha = static_cast<uint8_t>(((alphas >> (i * 4)) & 0xf) * 17); }
+		break;
+	}
+	case BCBlockType::BC3:
+	{
+		decodeColorBlock(block + 8, false, kernels, texels);
+		decodeChannelBlock(block, false, kernels, values);
+		for (uint32_t i = 0; i < BC_NUM_TEXELS; ++i) { texels[i].alpha = values[i]; }
+		break;
+	}
+	case BCBlockType::BC4:
+	case BCBlockType::BC5:
+	{
+		const uint8_t one = isSigned ? 127 : 255;
+		decodeChannelBlock(block, isSigned, kernels, values);
+		for (uint32_t i = 0; i < BC_NUM_TEXELS; ++i) { texels[i] = makeColor32(values[i], 0, 0, one); }
+		if (type == BCBlockType::BC5)
+		{
+			decodeChannelBlock(block + 8, isSigned, kernels, values);
+			for (uint32_t i = 0; i < BC_NUM_TEXELS; ++i) { texels[i].green = values[i]; }
+		}
+		break;
+	}
+	case BCBlockType::BC6: decodeBc6Block(block, isSigned, bc6Layouts, static_cast<ColorHalf*>(outTexels)); break;
+	case BCBlockType::BC7: decodeBc7Block(block, texels); break;
+	}
+}
+
+bool getBCBlockType(CompressedPixelFormat format, BCBlockType& outType)
+{
+	switch (format)
+	{
+	case CompressedPixelFormat::DXT1: outType = BCBlockType::BC1; return true;
+	case CompressedPixelFormat::DXT2:
+	case CompressedPixelFormat::DXT3: outType = BCBlockType::BC2; return true;
+	case CompressedPixelFormat::DXT4:
+	case CompressedPixelFormat::DXT5: outType = BCBlockType::BC3; return true;
+	case CompressedPixelFormat::BC4: outType = BCBlockType::BC4; return true;
+	case CompressedPixelFormat::BC5: outType = BCBlockType::BC5; return true;
+	case CompressedPixelFormat::BC6: outType = BCBlockType::BC6; return true;
+	case CompressedPixelFormat::BC7: outType = BCBlockType::BC7; return true;
+	default: return false;
+	}
+}
+} // namespace
+
+bool isBCFormat(CompressedPixelFormat format)
+{
+	BCBlockType type;
+	return getBCBlockType(format, type);
+}
+
+uint32_t getBCDecompressedBytesPerPixel(CompressedPixelFormat format)
+{
+	BCBlockType type;
+	if (!getBCBlockType(format, type)) { return 0; }
+	return type == BCBlockType::BC6 ? static_cast<uint32_t>(sizeof(ColorHalf)) : static_cast<uint32_t>(sizeof(Color32));
+}
+
+uint32_t PVRTDecompressBC(const void* srcData, uint32_t xDim, uint32_t yDim, void* dstData, CompressedPixelFormat format, bool isSigned, const DecompressionOptions& options)
+{
+	BCBlockType type;
+	if (!getBCBlockType(format, type)) { return 0; }
+
+	const uint32_t blockSize = (type == BCBlockType::BC1 || type == BCBlockType::BC4) ? 8 : 16;
+	const uint32_t texelSize = getBCDecompressedBytesPerPixel(format);
+	const uint32_t numBlocksX = (xDim + BC_BLOCK_DIM - 1) / BC_BLOCK_DIM;
+	const uint32_t numBlocksY = (yDim + BC_BLOCK_DIM - 1) / BC_BLOCK_DIM;
+	const uint8_t* input = static_cast<const uint8_t*>(srcData);
+	uint8_t* output = static_cast<uint8_t*>(dstData);
+
+	BCKernels kernels = { &selectColors, &selectChannel };
+#if defined(PVR_DECOMPRESS_SSE2) || defined(PVR_DECOMPRESS_NEON)
+	if (options.allowSimd)
+	{
+		kernels.selectColors = &selectColorsSimd;
+		kernels.selectChannel = &selectChannelSimd;
+	}
+#endif
+	// Make sure the tables are built before any worker thread needs them.
+	const Bc6Layout* bc6Layouts = type == BCBlockType::BC6 ? getBc6Layouts() : nullptr;
+
+	// Every row of blocks is independent. Partial blocks at the right and bottom edges are clipped. Each thread is given at least a hundred microseconds
+	// or so of work, as small images are not worth a thread. BC6 and BC7 blocks are several times slower to decode.
+	const uint32_t blocksPerThread = (type == BCBlockType::BC6 || type == BCBlockType::BC7) ? 1024u : 4096u;
+	const uint32_t numThreads = impl::getDecompressionThreadCount(options.maxThreads, numBlocksY, std::max(1u, blocksPerThread / numBlocksX));
+	impl::parallelForBands(0, static_cast<int32_t>(numBlocksY), numThreads, [&](int32_t firstBlockY, int32_t lastBlockY) {
+		ColorHalf texels[BC_NUM_TEXELS]; // Large enough for every output format
+		for (uint32_t blockY = static_cast<uint32_t>(firstBlockY); blockY < static_cast<uint32_t>(lastBlockY); ++blockY)
+		{
+			for (uint32_t blockX = 0; blockX < numBlocksX; ++blockX)
+			{
+				decodeBcBlock(input + (blockY * numBlocksX + blockX) * blockSize, type, isSigned, kernels, bc6Layouts, texels);
+
+				const uint32_t numColumns = std::min(static_cast<uint32_t>(BC_BLOCK_DIM), xDim - blockX * BC_BLOCK_DIM);
+				const uint32_t numRows = std::min(static_cast<uint32_t>(BC_BLOCK_DIM), yDim - blockY * BC_BLOCK_DIM);
+				const uint8_t* source = reinterpret_cast<const uint8_t*>(texels);
+				for (uint32_t row = 0; row < numRows; ++row)
+				{
+					memcpy(output + (static_cast<size_t>(blockY * BC_BLOCK_DIM + row) * xDim + blockX * BC_BLOCK_DIM) * texelSize, source + row * BC_BLOCK_DIM * texelSize,
+						numColumns * texelSize);
+				}
+			}
+		}
+	}, options.jobSystem);
+
+	return numBlocksX * numBlocksY * blockSize;
+}
+
+Texture decompressBcTexture(const Texture& texture, const DecompressionOptions& options)
+{
+	const CompressedPixelFormat format = static_cast<CompressedPixelFormat>(texture.getPixelFormat().getPixelTypeId());
+	if (texture.getPixelFormat().getPart().High != 0 || !isBCFormat(format)) { throw InvalidArgumentError("texture", "[decompressBcTexture]: The texture is not in a BC format"); }
+
+	// Set up the new texture and header.
+	const bool isSigned = isVariableTypeSigned(texture.getChannelType());
+	TextureHeader cDecompressedHeader(texture);
+	if (format == CompressedPixelFormat::BC6)
+	{
+		cDecompressedHeader.setPixelFormat(GeneratePixelType4<'r', 'g', 'b', 'a', 16, 16, 16, 16>::ID);
+		cDecompressedHeader.setChannelType(VariableType::SignedFloat);
+	}
+	else
+	{
+		cDecompressedHeader.setPixelFormat(GeneratePixelType4<'r', 'g', 'b', 'a', 8, 8, 8, 8>::ID);
+		cDecompressedHeader.setChannelType(isSigned ? VariableType::SignedByteNorm : VariableType::UnsignedByteNorm);
+	}
+	if (format == CompressedPixelFormat::BC4 || format == CompressedPixelFormat::BC5 || format == CompressedPixelFormat::BC6)
+	{ cDecompressedHeader.setColorSpace(ColorSpace::lRGB); }
+	Texture cDecompressedTexture(cDecompressedHeader);
+
+	// Do decompression, one slice at a time. Each slice is decompressed in parallel.
+	const uint32_t bytesPerPixel = getBCDecompressedBytesPerPixel(format);
+	for (uint32_t uiMIPLevel = 0; uiMIPLevel < texture.getNumMipMapLevels(); ++uiMIPLevel)
+	{
+		const uint32_t width = texture.getWidth(uiMIPLevel), height = texture.getHeight(uiMIPLevel);
+		for (uint32_t uiArray = 0; uiArray < texture.getNumArrayMembers(); ++uiArray)
+		{
+			for (uint32_t uiFace = 0; uiFace < texture.getNumFaces(); ++uiFace)
+			{
+				const uint8_t* source = texture.getDataPointer(uiMIPLevel, uiArray, uiFace);
+				uint8_t* destination = cDecompressedTexture.getDataPointer(uiMIPLevel, uiArray, uiFace);
+				for (uint32_t slice = 0; slice < texture.getDepth(uiMIPLevel); ++slice)
+				{
+					source += PVRTDecompressBC(source, width, height, destination, format, isSigned, options);
+					destination += static_cast<size_t>(width) * height * bytesPerPixel;
+				}
+			}
+		}
+	}
+	return cDecompressedTexture;
+}
+} // namespace pvr
+//!\endcond
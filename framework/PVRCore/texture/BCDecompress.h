@@ -0,0 +1,42 @@
+/*!
+\brief Contains functions to decompress the BC (S3TC/DXT, RGTC and BPTC) formats into RGBA8888 or RGBA half float.
+\file PVRCore/texture/BCDecompress.h
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+#pragma once
+#include "PVRCore/texture/PVRTDecompress.h"
+#include "PVRCore/texture/Texture.h"
+namespace pvr {
+
+/// <summary>Query whether a format is one of the BC formats that PVRTDecompressBC can decompress (DXT1 to DXT5, BC4, BC5, BC6 and BC7).</summary>
+/// <param name="format">The compressed pixel format</param>
+/// <returns>True if the format is a BC format, otherwise false</returns>
+bool isBCFormat(CompressedPixelFormat format);
+
+/// <summary>Get the size of a pixel decompressed by PVRTDecompressBC: 8 bytes (RGBA half float) for BC6, 4 bytes (RGBA8888) for the other formats.</summary>
+/// <param name="format">The compressed pixel format</param>
+/// <returns>The number of bytes per decompressed pixel, or 0 if the format is not a BC format.</returns>
+uint32_t getBCDecompressedBytesPerPixel(CompressedPixelFormat format);
+
+/// <summary>Decompresses any BC format. DXT1 to DXT5 and BC7 are written as RGBA 8888 (DXT2 and DXT4 stay premultiplied). BC4 and BC5 are written as
+/// (R, 0, 0, 1) and (R, G, 0, 1) respectively, as SNORM8 if the data is signed. BC6 is written as RGBA half float with an alpha of 1. Rows of blocks are
+/// decoded in parallel. Dimensions do not need to be multiples of the block size.</summary>
+/// <param name="srcData">The BC texture data to decompress</param>
+/// <param name="xDim">X dimension of the texture</param>
+/// <param name="yDim">Y dimension of the texture</param>
+/// <param name="dstData">The decompressed texture data. Must hold xDim * yDim * getBCDecompressedBytesPerPixel(format) bytes.</param>
+/// <param name="format">The format of the data. Must be one of the BC formats.</param>
+/// <param name="isSigned">Only used for BC4, BC5 (SNORM) and BC6 (signed half float): signifies whether the data is signed</param>
+/// <param name="options">Threading and kernel selection options</param>
+/// <returns>Return The number of bytes of BC data decompressed, or 0 if the format is not a BC format.</returns>
+uint32_t PVRTDecompressBC(const void* srcData, uint32_t xDim, uint32_t yDim, void* dstData, CompressedPixelFormat format, bool isSigned, const DecompressionOptions& options);
+
+/// <summary>Decompress a BC (DXT1 to DXT5, BC4 to BC7) texture in software, for APIs or devices that do not support the format. Every surface is
+/// decompressed with PVRTDecompressBC. BC6 is decompressed to RGBA half float, BC4 and BC5 to RGBA8888 (SNORM if signed, and with a linear colour
+/// space), the other formats to RGBA8888 in their own colour space.</summary>
+/// <param name="texture">The BC texture to decompress</param>
+/// <param name="options">Threading and kernel selection options, used for every surface</param>
+/// <returns>The decompressed texture, with the same dimensions, MIP levels, array members and faces as the compressed one</returns>
+Texture decompressBcTexture(const Texture& texture, const DecompressionOptions& options = DecompressionOptions());
+} // namespace pvr
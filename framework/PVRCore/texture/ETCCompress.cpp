@@ -0,0 +1,911 @@
+/*!
+\brief Implementation of the ETC1, ETC2 and EAC texture compression functions.
+\file PVRCore/texture/ETCCompress.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+
+#include "ETCCompress.h"
+#include "ParallelDecompress.h"
+#include "PixelFormatTranscoder.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace pvr {
+namespace {
+enum
+{
+	ETC_BLOCK_DIM = 4,
+	ETC_NUM_TEXELS = 16,
+	ETC_SUBBLOCK_TEXELS = 8,
+};
+
+const uint32_t maxError = 0xffffffffu;
+
+// The tables of the decoder (see PVRTDecompress.cpp).
+const int32_t etcModifiers[8][4] = { { 2, 8, -2, -8 }, { 5, 17, -5, -17 }, { 9, 29, -9, -29 }, { 13, 42, -13, -42 }, { 18, 60, -18, -60 }, { 24, 80, -24, -80 },
+	{ 33, 106, -33, -106 }, { 47, 183, -47, -183 } };
+const int32_t etc2Distances[8] = { 3, 6, 11, 16, 23, 32, 41, 64 };
+const int32_t eacModifiers[16][8] = { { -3, -6, -9, -15, 2, 5, 8, 14 }, { -3, -7, -10, -13, 2, 6, 9, 12 }, { -2, -5, -8, -13, 1, 4, 7, 12 },
+	{ -2, -4, -6, -13, 1, 3, 5, 12 }, { -3, -6, -8, -12, 2, 5, 7, 11 }, { -3, -7, -9, -11, 2, 6, 8, 10 }, { -4, -7, -8, -11, 3, 6, 7, 10 },
+	{ -3, -5, -8, -11, 2, 4, 7, 10 }, { -2, -6, -8, -10, 1, 5, 7, 9 }, { -2, -5, -8, -10, 1, 4, 7, 9 }, { -2, -4, -8, -10, 1, 3, 7, 9 }, { -2, -5, -7, -10, 1, 4, 6, 9 },
+	{ -3, -4, -7, -10, 2, 3, 6, 9 }, { -1, -2, -3, -10, 0, 1, 2, 9 }, { -4, -6, -8, -9, 3, 5, 7, 8 }, { -3, -5, -7, -9, 2, 4, 6, 8 } };
+
+// The layout of a block of any of the ETC formats.
+enum class EtcBlockType
+{
+	ETC1,
+	ETC2_RGB,
+	ETC2_RGB_A1,
+	ETC2_RGBA,
+	EAC_R11,
+	EAC_RG11,
+};
+
+bool getEtcBlockType(CompressedPixelFormat format, EtcBlockType& outType)
+{
+	switch (format)
+	{
+	case CompressedPixelFormat::ETC1: outType = EtcBlockType::ETC1; return true;
+	case CompressedPixelFormat::ETC2_RGB: outType = EtcBlockType::ETC2_RGB; return true;
+	case CompressedPixelFormat::ETC2_RGB_A1: outType = EtcBlockType::ETC2_RGB_A1; return true;
+	case CompressedPixelFormat::ETC2_RGBA: outType = EtcBlockType::ETC2_RGBA; return true;
+	case CompressedPixelFormat::EAC_R11: outType = EtcBlockType::EAC_R11; return true;
+	case CompressedPixelFormat::EAC_RG11: outType = EtcBlockType::EAC_RG11; return true;
+	default: return false;
+	}
+}
+
+inline uint32_t getEtcBlockSize(EtcBlockType type) { return (type == EtcBlockType::ETC2_RGBA || type == EtcBlockType::EAC_RG11) ? 16 : 8; }
+
+inline int32_t clampInt(int32_t value, int32_t low, int32_t high) { return value < low ? low : (value > high ? high : value); }
+inline int32_t clamp255(int32_t value) { return clampInt(value, 0, 255); }
+inline uint32_t square(int32_t value) { return static_cast<uint32_t>(value * value); }
+
+// Expands a 4, 5, 6 or 7 bit colour channel to 8 bits by replicating its most significant bits, like the decoder.
+inline int32_t extendTo8(int32_t value, uint32_t bits) { return (value << (8 - bits)) | (value >> (2 * bits - 8)); }
+
+// Quantizes an 8 bit colour channel to 4, 5, 6 or 7 bits.
+inline int32_t quantize(float value, uint32_t bits)
+{
+	const int32_t maxValue = (1 << bits) - 1;
+	return clampInt(static_cast<int32_t>(std::floor(value * static_cast<float>(maxValue) / 255.f + .5f)), 0, maxValue);
+}
+
+inline void writeBigEndian32(uint32_t value, uint8_t* data)
+{
+	data[0] = static_cast<uint8_t>(value >> 24);
+	data[1] = static_cast<uint8_t>(value >> 16);
+	data[2] = static_cast<uint8_t>(value >> 8);
+	data[3] = static_cast<uint8_t>(value);
+}
+
+// Picks the closest of 4 colours for every pixel and returns the sum of the squared errors. Colours with a negative red channel are not available.
+// Stops as soon as the error reaches errorLimit, in which case the indices are incomplete.
+uint32_t assignIndices(const int32_t (*pixels)[3], uint32_t numPixels, const int32_t (*colors)[3], uint32_t* outIndices, uint32_t errorLimit)
+{
+	uint32_t totalError = 0;
+	for (uint32_t i = 0; i < numPixels && totalError < errorLimit; ++i)
+	{
+		uint32_t bestError = maxError, bestIndex = 0;
+		for (uint32_t index = 0; index < 4; ++index)
+		{
+			if (colors[index][0] < 0) { continue; }
+			const uint32_t error = square(pixels[i][0] - colors[index][0]) + square(pixels[i][1] - colors[index][1]) + square(pixels[i][2] - colors[index][2]);
+			if (error < bestError)
+			{
+				bestError = error;
+				bestIndex = index;
+			}
+		}
+		outIndices[i] = bestIndex;
+		totalError += bestError;
+	}
+	return totalError;
+}
+
+// The colour channels of a block, and which of its pixels are transparent (for punch-through alpha only).
+struct ColorBlock
+{
+	int32_t pixels[ETC_NUM_TEXELS][3]; // Row-major
+	bool isTransparent[ETC_NUM_TEXELS];
+	bool hasTransparency;
+};
+
+// The opaque pixels of one half of a block.
+struct SubBlock
+{
+	int32_t pixels[ETC_SUBBLOCK_TEXELS][3];
+	uint32_t positions[ETC_SUBBLOCK_TEXELS]; // The index of each pixel in the block
+	uint32_t numPixels;
+};
+
+// A base colour, modifier table and per pixel indices for a sub-block.
+struct SubBlockFit
+{
+	int32_t color[3]; // Quantized to 4 or 5 bits
+	uint32_t table;
+	uint32_t indices[ETC_SUBBLOCK_TEXELS];
+	uint32_t error;
+};
+
+// A complete encoding of an ETC1 or ETC2 colour block as its two 32 bit words, and its error.
+struct ColorBlockEncoding
+{
+	uint32_t top;
+	uint32_t bottom;
+	uint32_t error;
+};
+
+// Not flipped: 2 2x4 sub-blocks side by side. Flipped: 2 4x2 sub-blocks on top of each other.
+void getSubBlocks(const ColorBlock& block, bool flip, SubBlock* outSubBlocks)
+{
+	outSubBlocks[0].numPixels = 0;
+	outSubBlocks[1].numPixels = 0;
+	for (uint32_t i = 0; i < ETC_NUM_TEXELS; ++i)
+	{
+		if (block.isTransparent[i]) { continue; }
+		SubBlock& subBlock = outSubBlocks[(flip ? (i / ETC_BLOCK_DIM) : (i % ETC_BLOCK_DIM)) >= 2 ? 1 : 0];
+		memcpy(subBlock.pixels[subBlock.numPixels], block.pixels[i], sizeof(block.pixels[i]));
+		subBlock.positions[subBlock.numPixels++] = i;
+	}
+}
+
+// The 4 colours of a sub-block. With punch-through alpha, index 0 is the unmodified base colour and index 2 is transparent.
+void getSubBlockColors(const int32_t* color, uint32_t bits, uint32_t table, bool punchthrough, int32_t (*outColors)[3])
+{
+	for (uint32_t index = 0; index < 4; ++index)
+	{
+		const int32_t modifier = (punchthrough && index == 0) ? 0 : etcModifiers[table][index];
+		for (uint32_t channel = 0; channel < 3; ++channel) { outColors[index][channel] = clamp255(extendTo8(color[channel], bits) + modifier); }
+	}
+	if (punchthrough) { outColors[2][0] = -1; }
+}
+
+// Picks the index of every pixel of a sub-block for a quantized base colour and a modifier table, and returns the error (see assignIndices).
+uint32_t assignSubBlockIndices(const SubBlock& subBlock, const int32_t* color, uint32_t bits, uint32_t table, bool punchthrough, uint32_t* outIndices, uint32_t errorLimit)
+{
+	const int32_t base[3] = { extendTo8(color[0], bits), extendTo8(color[1], bits), extendTo8(color[2], bits) };
+	const int32_t largestModifier = etcModifiers[table][1];
+	if (std::min(base[0], std::min(base[1], base[2])) < largestModifier || std::max(base[0], std::max(base[1], base[2])) + largestModifier > 255)
+	{
+		int32_t colors[4][3];
+		getSubBlockColors(color, bits, table, punchthrough, colors);
+		return assignIndices(subBlock.pixels, subBlock.numPixels, colors, outIndices, errorLimit);
+	}
+
+	// No channel clamps, so the error of a modifier m is |pixel - base|^2 - 2 * m * sum(pixel - base) + 3 * m^2.
+	int32_t modifiers[4];
+	for (uint32_t index = 0; index < 4; ++index) { modifiers[index] = (punchthrough && index == 0) ? 0 : etcModifiers[table][index]; }
+	uint32_t totalError = 0;
+	for (uint32_t i = 0; i < subBlock.numPixels && totalError < errorLimit; ++i)
+	{
+		const int32_t red = subBlock.pixels[i][0] - base[0], green = subBlock.pixels[i][1] - base[1], blue = subBlock.pixels[i][2] - base[2];
+		const int32_t sum = red + green + blue, distance = red * red + green * green + blue * blue;
+		uint32_t bestError = maxError, bestIndex = 0;
+		for (uint32_t index = 0; index < 4; ++index)
+		{
+			if (punchthrough && index == 2) { continue; }
+			const uint32_t error = static_cast<uint32_t>(distance + modifiers[index] * (3 * modifiers[index] - 2 * sum));
+			if (error < bestError)
+			{
+				bestError = error;
+				bestIndex = index;
+			}
+		}
+		outIndices[i] = bestIndex;
+		totalError += bestError;
+	}
+	return totalError;
+}
+
+// Evaluates a quantized base colour and a modifier table for a sub-block, and keeps them if they beat the best fit so far.
+void tryBaseColor(const SubBlock& subBlock, const int32_t* color, uint32_t bits, uint32_t table, bool punchthrough, SubBlockFit& bestFit)
+{
+	uint32_t indices[ETC_SUBBLOCK_TEXELS];
+	const uint32_t error = assignSubBlockIndices(subBlock, color, bits, table, punchthrough, indices, bestFit.error);
+	if (error < bestFit.error)
+	{
+		memcpy(bestFit.color, color, sizeof(bestFit.color));
+		memcpy(bestFit.indices, indices, sizeof(bestFit.indices));
+		bestFit.table = table;
+		bestFit.error = error;
+	}
+}
+
+// Finds the base colour and modifier table of a sub-block. The base colour is quantized to 'bits' bits per channel and limited to [low, high], which
+// is how the second sub-block of a differential block is kept within reach of the first one.
+SubBlockFit fitSubBlock(const SubBlock& subBlock, uint32_t bits, const int32_t* low, const int32_t* high, bool punchthrough, CompressionQuality quality)
+{
+	SubBlockFit bestFit;
+	bestFit.error = maxError;
+
+	float average[3] = { 0.f, 0.f, 0.f };
+	for (uint32_t i = 0; i < subBlock.numPixels; ++i)
+	{
+		for (uint32_t channel = 0; channel < 3; ++channel) { average[channel] += static_cast<float>(subBlock.pixels[i][channel]); }
+	}
+	int32_t start[3];
+	for (uint32_t channel = 0; channel < 3; ++channel)
+	{
+		if (subBlock.numPixels) { average[channel] /= static_cast<float>(subBlock.numPixels); }
+		start[channel] = clampInt(quantize(average[channel], bits), low[channel], high[channel]);
+	}
+
+	for (uint32_t table = 0; table < 8; ++table)
+	{
+		if (quality == CompressionQuality::Fast)
+		{
+			tryBaseColor(subBlock, start, bits, table, punchthrough, bestFit);
+			continue;
+		}
+
+		// The average is only the best base colour if no modifier is clamped and the modifiers cancel out. Move the base colour to the average of the
+		// pixels minus their modifiers, and quantize that.
+		int32_t color[3] = { start[0], start[1], start[2] };
+		const uint32_t numIterations = quality == CompressionQuality::High ? 2 : 1;
+		for (uint32_t iteration = 0; iteration <= numIterations; ++iteration)
+		{
+			uint32_t indices[ETC_SUBBLOCK_TEXELS];
+			const uint32_t error = assignSubBlockIndices(subBlock, color, bits, table, punchthrough, indices, maxError);
+			if (error < bestFit.error)
+			{
+				memcpy(bestFit.color, color, sizeof(bestFit.color));
+				memcpy(bestFit.indices, indices, sizeof(bestFit.indices));
+				bestFit.table = table;
+				bestFit.error = error;
+			}
+			// Tables which start far behind the best one rarely catch up.
+			if (iteration == numIterations || !subBlock.numPixels || (quality == CompressionQuality::Normal && iteration == 0 && error / 4 > bestFit.error)) { break; }
+
+			float refined[3] = { 0.f, 0.f, 0.f };
+			for (uint32_t i = 0; i < subBlock.numPixels; ++i)
+			{
+				const int32_t modifier = (punchthrough && indices[i] == 0) ? 0 : etcModifiers[table][indices[i]];
+				for (uint32_t channel = 0; channel < 3; ++channel) { refined[channel] += static_cast<float>(subBlock.pixels[i][channel] - modifier); }
+			}
+			int32_t next[3];
+			for (uint32_t channel = 0; channel < 3; ++channel)
+			{
+				refined[channel] /= static_cast<float>(subBlock.numPixels);
+				next[channel] = clampInt(quantize(refined[channel], bits), low[channel], high[channel]);
+			}
+			if (quality == CompressionQuality::High)
+			{
+				// Rounding each channel to nearest is not always best, so also try the other neighbour of every channel.
+				int32_t other[3];
+				for (uint32_t channel = 0; channel < 3; ++channel)
+				{
+					const int32_t step = refined[channel] > static_cast<float>(extendTo8(next[channel], bits)) ? 1 : -1;
+					other[channel] = clampInt(next[channel] + step, low[channel], high[channel]);
+				}
+				for (uint32_t combination = 1; combination < 8; ++combination)
+				{
+					const int32_t candidate[3] = { (combination & 1) ? other[0] : next[0], (combination & 2) ? other[1] : next[1], (combination & 4) ? other[2] : next[2] };
+					tryBaseColor(subBlock, candidate, bits, table, punchthrough, bestFit);
+				}
+			}
+			if (memcmp(next, color, sizeof(color)) == 0) { break; }
+			memcpy(color, next, sizeof(color));
+		}
+	}
+	return bestFit;
+}
+
+// Packs 16 2 bit indices, given in row-major order, into the bottom word of a colour block: column-major, with the most significant bits in the upper half.
+uint32_t packColorIndices(const uint32_t* indices)
+{
+	uint32_t bottom = 0;
+	for (uint32_t i = 0; i < ETC_NUM_TEXELS; ++i)
+	{
+		const uint32_t bit = (i % ETC_BLOCK_DIM) * ETC_BLOCK_DIM + i / ETC_BLOCK_DIM;
+		bottom |= ((indices[i] & 0x1) << bit) | ((indices[i] >> 1) << (bit + 16));
+	}
+	return bottom;
+}
+
+uint32_t packSubBlockIndices(const SubBlock* subBlocks, const SubBlockFit* fits)
+{
+	// Transparent pixels of punch-through blocks use index 2.
+	uint32_t indices[ETC_NUM_TEXELS];
+	for (uint32_t i = 0; i < ETC_NUM_TEXELS; ++i) { indices[i] = 2; }
+	for (uint32_t half = 0; half < 2; ++half)
+	{
+		for (uint32_t i = 0; i < subBlocks[half].numPixels; ++i) { indices[subBlocks[half].positions[i]] = fits[half].indices[i]; }
+	}
+	return packColorIndices(indices);
+}
+
+// The 'individual' (4 + 4 bit base colours) and 'differential' (5 bit base colour and 3 bit signed difference) modes shared by ETC1 and ETC2.
+void encodeSubBlockModes(const ColorBlock& block, EtcBlockType type, CompressionQuality quality, ColorBlockEncoding& best)
+{
+	// With punch-through alpha the 'differential' bit is the 'opaque' bit, so only the differential mode is available.
+	const bool punchthrough = type == EtcBlockType::ETC2_RGB_A1;
+	const bool hasTransparency = punchthrough && block.hasTransparency;
+	const int32_t zero[3] = { 0, 0, 0 }, max4[3] = { 15, 15, 15 }, max5[3] = { 31, 31, 31 };
+	for (uint32_t flip = 0; flip < 2; ++flip)
+	{
+		SubBlock subBlocks[2];
+		getSubBlocks(block, flip != 0, subBlocks);
+
+		if (!punchthrough)
+		{
+			SubBlockFit fits[2];
+			fits[0] = fitSubBlock(subBlocks[0], 4, zero, max4, false, quality);
+			fits[1] = fitSubBlock(subBlocks[1], 4, zero, max4, false, quality);
+			if (fits[0].error + fits[1].error < best.error)
+			{
+				best.error = fits[0].error + fits[1].error;
+				best.top = (static_cast<uint32_t>(fits[0].color[0]) << 28) | (static_cast<uint32_t>(fits[1].color[0]) << 24) | (static_cast<uint32_t>(fits[0].color[1]) << 20) |
+					(static_cast<uint32_t>(fits[1].color[1]) << 16) | (static_cast<uint32_t>(fits[0].color[2]) << 12) | (static_cast<uint32_t>(fits[1].color[2]) << 8) |
+					(fits[0].table << 5) | (fits[1].table << 2) | flip;
+				best.bottom = packSubBlockIndices(subBlocks, fits);
+			}
+		}
+
+		// Fit one sub-block freely and the other one within the reach of the 3 bit difference. High quality tries both orders.
+		const uint32_t numOrders = quality == CompressionQuality::High ? 2 : 1;
+		for (uint32_t first = 0; first < numOrders; ++first)
+		{
+			SubBlockFit fits[2];
+			fits[first] = fitSubBlock(subBlocks[first], 5, zero, max5, hasTransparency, quality);
+			int32_t low[3], high[3];
+			for (uint32_t channel = 0; channel < 3; ++channel)
+			{
+				// The second base colour is the first one plus [-4, 3].
+				low[channel] = std::max(0, fits[first].color[channel] - (first == 0 ? 4 : 3));
+				high[channel] = std::min(31, fits[first].color[channel] + (first == 0 ? 3 : 4));
+			}
+			fits[1 - first] = fitSubBlock(subBlocks[1 - first], 5, low, high, hasTransparency, quality);
+			if (fits[0].error + fits[1].error < best.error)
+			{
+				best.error = fits[0].error + fits[1].error;
+				best.top = (static_cast<uint32_t>(fits[0].color[0]) << 27) | (static_cast<uint32_t>((fits[1].color[0] - fits[0].color[0]) & 0x7) << 24) |
+					(static_cast<uint32_t>(fits[0].color[1]) << 19) | (static_cast<uint32_t>((fits[1].color[1] - fits[0].color[1]) & 0x7) << 16) |
+					(static_cast<uint32_t>(fits[0].color[2]) << 11) | (static_cast<uint32_t>((fits[1].color[2] - fits[0].color[2]) & 0x7) << 8) | (fits[0].table << 5) |
+					(fits[1].table << 2) | (hasTransparency ? 0 : 0x2) | flip;
+				best.bottom = packSubBlockIndices(subBlocks, fits);
+			}
+		}
+	}
+}
+
+// Whether the 5 bit base colour and 3 bit signed difference of a channel (red at shift 24, green at 16, blue at 8) of a differential block overflow.
+// This is how ETC2 selects its additional modes.
+inline bool differentialOverflows(uint32_t top, uint32_t shift)
+{
+	const int32_t base = static_cast<int32_t>((top >> (shift + 3)) & 0x1f);
+	const int32_t difference = static_cast<int32_t>((top >> shift) & 0x7) - static_cast<int32_t>((top >> shift) & 0x4) * 2;
+	return base + difference < 0 || base + difference > 31;
+}
+
+// Sets the unused bits of a 'T' (channel 0), 'H' (channel 1) or planar (channel 2) block so that this channel overflows and the ones before it do not.
+uint32_t selectEtc2Mode(uint32_t top, uint32_t unusedBits, uint32_t channel)
+{
+	const uint32_t shifts[3] = { 24, 16, 8 };
+	for (uint32_t subset = unusedBits;; subset = (subset - 1) & unusedBits)
+	{
+		const uint32_t candidate = top | subset;
+		bool selectsMode = differentialOverflows(candidate, shifts[channel]);
+		for (uint32_t previous = 0; previous < channel; ++previous) { selectsMode = selectsMode && !differentialOverflows(candidate, shifts[previous]); }
+		if (selectsMode) { return candidate; }
+		if (!subset) { break; }
+	}
+	assert(false && "Every ETC2 mode can be selected for any colour");
+	return top;
+}
+
+// The error of one channel of a planar block, decoded exactly like the decoder does.
+uint32_t getPlanarChannelError(const ColorBlock& block, uint32_t channel, uint32_t bits, int32_t origin, int32_t horizontal, int32_t vertical, uint32_t errorLimit)
+{
+	const int32_t o = extendTo8(origin, bits), h = extendTo8(horizontal, bits), v = extendTo8(vertical, bits);
+	uint32_t error = 0;
+	for (int32_t y = 0; y < ETC_BLOCK_DIM && error < errorLimit; ++y)
+	{
+		for (int32_t x = 0; x < ETC_BLOCK_DIM; ++x)
+		{
+			error += square(clamp255((x * (h - o) + y * (v - o) + 4 * o + 2) >> 2) - block.pixels[y * ETC_BLOCK_DIM + x][channel]);
+		}
+	}
+	return error;
+}
+
+// The ETC2 'planar' mode: a colour at the origin, at x = 4 and at y = 4 are interpolated. The channels are independent, so each is fitted by least
+// squares, and Normal and High quality search the neighbouring quantized values.
+void encodePlanarMode(const ColorBlock& block, CompressionQuality quality, ColorBlockEncoding& best)
+{
+	const uint32_t bits[3] = { 6, 7, 6 };
+	int32_t origin[3], horizontal[3], vertical[3];
+	uint32_t error = 0;
+	for (uint32_t channel = 0; channel < 3; ++channel)
+	{
+		float sum = 0.f, sumX = 0.f, sumY = 0.f;
+		for (uint32_t i = 0; i < ETC_NUM_TEXELS; ++i)
+		{
+			const float value = static_cast<float>(block.pixels[i][channel]);
+			sum += value;
+			sumX += (static_cast<float>(i % ETC_BLOCK_DIM) - 1.5f) * value;
+			sumY += (static_cast<float>(i / ETC_BLOCK_DIM) - 1.5f) * value;
+		}
+		// The coordinates are centred on 1.5, and the sum of their squares over the block is 20.
+		const float slopeX = sumX / 20.f, slopeY = sumY / 20.f;
+		const float value = sum / 16.f - 1.5f * (slopeX + slopeY);
+		origin[channel] = quantize(value, bits[channel]);
+		horizontal[channel] = quantize(value + 4.f * slopeX, bits[channel]);
+		vertical[channel] = quantize(value + 4.f * slopeY, bits[channel]);
+		uint32_t channelError = getPlanarChannelError(block, channel, bits[channel], origin[channel], horizontal[channel], vertical[channel], maxError);
+
+		if (quality != CompressionQuality::Fast)
+		{
+			const int32_t maxValue = (1 << bits[channel]) - 1;
+			const int32_t o = origin[channel], h = horizontal[channel], v = vertical[channel];
+			for (int32_t candidateO = std::max(0, o - 1); candidateO <= std::min(maxValue, o + 1); ++candidateO)
+			{
+				for (int32_t candidateH = std::max(0, h - 1); candidateH <= std::min(maxValue, h + 1); ++candidateH)
+				{
+					for (int32_t candidateV = std::max(0, v - 1); candidateV <= std::min(maxValue, v + 1); ++candidateV)
+					{
+						const uint32_t candidateError = getPlanarChannelError(block, channel, bits[channel], candidateO, candidateH, candidateV, channelError);
+						if (candidateError < channelError)
+						{
+							channelError = candidateError;
+							origin[channel] = candidateO;
+							horizontal[channel] = candidateH;
+							vertical[channel] = candidateV;
+						}
+					}
+				}
+			}
+		}
+		error += channelError;
+	}
+	if (error >= best.error) { return; }
+
+	const uint32_t ro = static_cast<uint32_t>(origin[0]), go = static_cast<uint32_t>(origin[1]), bo = static_cast<uint32_t>(origin[2]);
+	const uint32_t rh = static_cast<uint32_t>(horizontal[0]), gh = static_cast<uint32_t>(horizontal[1]), bh = static_cast<uint32_t>(horizontal[2]);
+	const uint32_t rv = static_cast<uint32_t>(vertical[0]), gv = static_cast<uint32_t>(vertical[1]), bv = static_cast<uint32_t>(vertical[2]);
+	const uint32_t top = (ro << 25) | ((go >> 6) << 24) | ((go & 0x3f) << 17) | ((bo >> 5) << 16) | (((bo >> 3) & 0x3) << 11) | ((bo & 0x7) << 7) | ((rh >> 1) << 2) | 0x2 |
+		(rh & 0x1);
+	best.top = selectEtc2Mode(top, 0x8080e400, 2);
+	best.bottom = (gh << 25) | (bh << 19) | (rv << 13) | (gv << 6) | bv;
+	best.error = error;
+}
+
+// Splits the pixels of a block into two clusters for the 'T' and 'H' modes: along the principal axis of the colours, refined with a few iterations of
+// k-means. Returns false if the block has a single colour.
+bool getColorClusters(const ColorBlock& block, float (*outCentroids)[3])
+{
+	float mean[3] = { 0.f, 0.f, 0.f };
+	for (uint32_t i = 0; i < ETC_NUM_TEXELS; ++i)
+	{
+		for (uint32_t channel = 0; channel < 3; ++channel) { mean[channel] += static_cast<float>(block.pixels[i][channel]) / 16.f; }
+	}
+	float covariance[3][3] = {};
+	for (uint32_t i = 0; i < ETC_NUM_TEXELS; ++i)
+	{
+		for (uint32_t row = 0; row < 3; ++row)
+		{
+			for (uint32_t column = 0; column < 3; ++column)
+			{ covariance[row][column] += (static_cast<float>(block.pixels[i][row]) - mean[row]) * (static_cast<float>(block.pixels[i][column]) - mean[column]); }
+		}
+	}
+	if (covariance[0][0] + covariance[1][1] + covariance[2][2] <= 0.f) { return false; }
+
+	// A few power iterations are enough to find a good splitting direction.
+	float axis[3] = { 1.f, 1.f, 1.f };
+	for (uint32_t iteration = 0; iteration < 4; ++iteration)
+	{
+		float next[3];
+		for (uint32_t row = 0; row < 3; ++row) { next[row] = covariance[row][0] * axis[0] + covariance[row][1] * axis[1] + covariance[row][2] * axis[2]; }
+		const float length = std::max(std::fabs(next[0]), std::max(std::fabs(next[1]), std::fabs(next[2])));
+		if (length <= 0.f) { break; }
+		for (uint32_t channel = 0; channel < 3; ++channel) { axis[channel] = next[channel] / length; }
+	}
+
+	bool isSecond[ETC_NUM_TEXELS];
+	for (uint32_t i = 0; i < ETC_NUM_TEXELS; ++i)
+	{
+		float projection = 0.f;
+		for (uint32_t channel = 0; channel < 3; ++channel) { projection += (static_cast<float>(block.pixels[i][channel]) - mean[channel]) * axis[channel]; }
+		isSecond[i] = projection > 0.f;
+	}
+	for (uint32_t iteration = 0; iteration < 3; ++iteration)
+	{
+		uint32_t counts[2] = { 0, 0 };
+		memset(outCentroids, 0, sizeof(float) * 6);
+		for (uint32_t i = 0; i < ETC_NUM_TEXELS; ++i)
+		{
+			++counts[isSecond[i]];
+			for (uint32_t channel = 0; channel < 3; ++channel) { outCentroids[isSecond[i]][channel] += static_cast<float>(block.pixels[i][channel]); }
+		}
+		if (!counts[0] || !counts[1]) { return false; }
+		for (uint32_t cluster = 0; cluster < 2; ++cluster)
+		{
+			for (uint32_t channel = 0; channel < 3; ++channel) { outCentroids[cluster][channel] /= static_cast<float>(counts[cluster]); }
+		}
+		for (uint32_t i = 0; i < ETC_NUM_TEXELS; ++i)
+		{
+			float distances[2] = { 0.f, 0.f };
+			for (uint32_t cluster = 0; cluster < 2; ++cluster)
+			{
+				for (uint32_t channel = 0; channel < 3; ++channel)
+				{
+					const float difference = static_cast<float>(block.pixels[i][channel]) - outCentroids[cluster][channel];
+					distances[cluster] += difference * difference;
+				}
+			}
+			isSecond[i] = distances[1] < distances[0];
+		}
+	}
+	return true;
+}
+
+// The 4 colours of a 'T' (one colour, and another one plus and minus the distance) or 'H' (two colours plus and minus the distance) block.
+void getPaintColors(const int32_t (*colors)[3], uint32_t distanceIndex, bool isHMode, int32_t (*outPaints)[3])
+{
+	const int32_t distance = etc2Distances[distanceIndex];
+	for (uint32_t channel = 0; channel < 3; ++channel)
+	{
+		const int32_t first = extendTo8(colors[0][channel], 4), second = extendTo8(colors[1][channel], 4);
+		outPaints[0][channel] = isHMode ? clamp255(first + distance) : first;
+		outPaints[1][channel] = isHMode ? clamp255(first - distance) : clamp255(second + distance);
+		outPaints[2][channel] = isHMode ? clamp255(second + distance) : second;
+		outPaints[3][channel] = clamp255(second - distance);
+	}
+}
+
+// Picks the best distance for two 4 bit colours in 'T' or 'H' mode. In 'H' mode the least significant bit of the distance index is implied by the order
+// of the colours, so the odd indices are only available if the first colour is not smaller than the second, and the even ones if it is smaller. The
+// colours are swapped by the caller if required.
+uint32_t fitPaintColors(const ColorBlock& block, const int32_t (*colors)[3], bool isHMode, uint32_t& outDistanceIndex, uint32_t* outIndices, uint32_t errorLimit)
+{
+	uint32_t bestError = maxError;
+	for (uint32_t distanceIndex = 0; distanceIndex < 8; ++distanceIndex)
+	{
+		if (isHMode && (distanceIndex & 0x1) == 0)
+		{
+			// Even indices need the first colour to be smaller: only possible by swapping them if they differ.
+			if (colors[0][0] == colors[1][0] && colors[0][1] == colors[1][1] && colors[0][2] == colors[1][2]) { continue; }
+		}
+		int32_t paints[4][3];
+		uint32_t indices[ETC_NUM_TEXELS];
+		getPaintColors(colors, distanceIndex, isHMode, paints);
+		const uint32_t error = assignIndices(block.pixels, ETC_NUM_TEXELS, paints, indices, std::min(bestError, errorLimit));
+		if (error < bestError && error < errorLimit)
+		{
+			bestError = error;
+			outDistanceIndex = distanceIndex;
+			memcpy(outIndices, indices, sizeof(indices));
+		}
+	}
+	return bestError;
+}
+
+// Moves the colours of a 'T' or 'H' block to the average of the pixels which use them, minus the distance, and quantizes them.
+void refinePaintColors(const ColorBlock& block, const uint32_t* indices, uint32_t distanceIndex, bool isHMode, int32_t (*colors)[3])
+{
+	const int32_t distance = etc2Distances[distanceIndex];
+	// The colour and the offset from it of each index.
+	const uint32_t colorOfIndex[4] = { 0, isHMode ? 0u : 1u, 1, 1 };
+	const int32_t offsetOfIndex[4] = { isHMode ? distance : 0, isHMode ? -distance : distance, isHMode ? distance : 0, -distance };
+	float sums[2][3] = {};
+	uint32_t counts[2] = { 0, 0 };
+	for (uint32_t i = 0; i < ETC_NUM_TEXELS; ++i)
+	{
+		const uint32_t color = colorOfIndex[indices[i]];
+		++counts[color];
+		for (uint32_t channel = 0; channel < 3; ++channel) { sums[color][channel] += static_cast<float>(block.pixels[i][channel] - offsetOfIndex[indices[i]]); }
+	}
+	for (uint32_t color = 0; color < 2; ++color)
+	{
+		if (!counts[color]) { continue; }
+		for (uint32_t channel = 0; channel < 3; ++channel) { colors[color][channel] = quantize(sums[color][channel] / static_cast<float>(counts[color]), 4); }
+	}
+}
+
+// The ETC2 'T' and 'H' modes, for blocks with two distinct groups of colours.
+void encodeTAndHModes(const ColorBlock& block, CompressionQuality quality, ColorBlockEncoding& best)
+{
+	float centroids[2][3];
+	if (!getColorClusters(block, centroids)) { return; }
+
+	for (uint32_t mode = 0; mode < 3; ++mode)
+	{
+		// 'T' mode with either cluster as the single colour, then 'H' mode.
+		const bool isHMode = mode == 2;
+		const uint32_t single = mode == 1 ? 1 : 0;
+		int32_t colors[2][3];
+		for (uint32_t channel = 0; channel < 3; ++channel)
+		{
+			colors[0][channel] = quantize(centroids[single][channel], 4);
+			colors[1][channel] = quantize(centroids[1 - single][channel], 4);
+		}
+
+		uint32_t distanceIndex = 0, indices[ETC_NUM_TEXELS];
+		uint32_t error = fitPaintColors(block, colors, isHMode, distanceIndex, indices, best.error);
+		if (quality == CompressionQuality::High && error != maxError)
+		{
+			for (uint32_t iteration = 0; iteration < 2; ++iteration)
+			{
+				int32_t refined[2][3];
+				memcpy(refined, colors, sizeof(refined));
+				refinePaintColors(block, indices, distanceIndex, isHMode, refined);
+				uint32_t refinedDistanceIndex = 0, refinedIndices[ETC_NUM_TEXELS];
+				const uint32_t refinedError = fitPaintColors(block, refined, isHMode, refinedDistanceIndex, refinedIndices, error);
+				if (refinedError >= error) { break; }
+				error = refinedError;
+				distanceIndex = refinedDistanceIndex;
+				memcpy(colors, refined, sizeof(colors));
+				memcpy(indices, refinedIndices, sizeof(indices));
+			}
+		}
+		if (error >= best.error) { continue; }
+
+		if (isHMode)
+		{
+			// The order of the colours encodes the least significant bit of the distance index. Swapping them swaps the pairs of indices.
+			const uint32_t first = (static_cast<uint32_t>(colors[0][0]) << 8) | (static_cast<uint32_t>(colors[0][1]) << 4) | static_cast<uint32_t>(colors[0][2]);
+			const uint32_t second = (static_cast<uint32_t>(colors[1][0]) << 8) | (static_cast<uint32_t>(colors[1][1]) << 4) | static_cast<uint32_t>(colors[1][2]);
+			if ((first >= second) != ((distanceIndex & 0x1) != 0))
+			{
+				std::swap(colors[0], colors[1]);
+				for (uint32_t i = 0; i < ETC_NUM_TEXELS; ++i) { indices[i] ^= 0x2; }
+			}
+		}
+
+		const uint32_t r1 = static_cast<uint32_t>(colors[0][0]), g1 = static_cast<uint32_t>(colors[0][1]), b1 = static_cast<uint32_t>(colors[0][2]);
+		const uint32_t r2 = static_cast<uint32_t>(colors[1][0]), g2 = static_cast<uint32_t>(colors[1][1]), b2 = static_cast<uint32_t>(colors[1][2]);
+		if (isHMode)
+		{
+			const uint32_t top = (r1 << 27) | ((g1 >> 1) << 24) | ((g1 & 0x1) << 20) | ((b1 >> 3) << 19) | (((b1 >> 1) & 0x3) << 16) | ((b1 & 0x1) << 15) | (r2 << 11) | (g2 << 7) |
+				(b2 << 3) | ((distanceIndex >> 2) << 2) | 0x2 | ((distanceIndex >> 1) & 0x1);
+			best.top = selectEtc2Mode(top, 0x80e40000, 1);
+		}
+		else
+		{
+			const uint32_t top = ((r1 >> 2) << 27) | ((r1 & 0x3) << 24) | (g1 << 20) | (b1 << 16) | (r2 << 12) | (g2 << 8) | (b2 << 4) | ((distanceIndex >> 1) << 2) | 0x2 |
+				(distanceIndex & 0x1);
+			best.top = selectEtc2Mode(top, 0xe4000000, 0);
+		}
+		best.bottom = packColorIndices(indices);
+		best.error = error;
+	}
+}
+
+// Encodes the colour of 16 RGBA 8888 pixels into an ETC1 or ETC2 colour block.
+void encodeColorBlock(const uint8_t (*texels)[4], EtcBlockType type, CompressionQuality quality, uint8_t* outBlock)
+{
+	ColorBlock block;
+	block.hasTransparency = false;
+	for (uint32_t i = 0; i < ETC_NUM_TEXELS; ++i)
+	{
+		for (uint32_t channel = 0; channel < 3; ++channel) { block.pixels[i][channel] = texels[i][channel]; }
+		block.isTransparent[i] = type == EtcBlockType::ETC2_RGB_A1 && texels[i][3] < 128;
+		block.hasTransparency = block.hasTransparency || block.isTransparent[i];
+	}
+
+	ColorBlockEncoding best;
+	best.top = 0;
+	best.bottom = 0;
+	best.error = maxError;
+	encodeSubBlockModes(block, type, quality, best);
+	// The additional modes of ETC2 are always opaque.
+	if (type != EtcBlockType::ETC1 && !block.hasTransparency && best.error > 0)
+	{
+		encodePlanarMode(block, quality, best);
+		if (quality != CompressionQuality::Fast && best.error > 0) { encodeTAndHModes(block, quality, best); }
+	}
+	writeBigEndian32(best.top, outBlock);
+	writeBigEndian32(best.bottom, outBlock + 4);
+}
+
+// Encodes 16 values, in row-major order, into an EAC block. 8 bit alpha blocks decode to base + modifier * multiplier in [0..255], and 11 bit blocks to
+// base * 8 + 4 + modifier * multiplier * 8 (or + modifier if the multiplier is 0) in [0..2047]. For every modifier table, the base and multiplier
+// which span the range of the values are tried, and Normal and High quality also search around them.
+void encodeEacBlock(const int32_t* values, bool isEightBitAlpha, CompressionQuality quality, uint8_t* outBlock)
+{
+	const int32_t maxValue = isEightBitAlpha ? 255 : 2047;
+	const int32_t minMultiplier = isEightBitAlpha ? 1 : 0;
+	const int32_t multiplierRadius = quality == CompressionQuality::Fast ? 0 : (quality == CompressionQuality::Normal ? 1 : 2);
+	const int32_t baseRadius = quality == CompressionQuality::Fast ? 0 : (quality == CompressionQuality::Normal ? 1 : 3);
+	int32_t minValue = values[0], maxBlockValue = values[0];
+	for (uint32_t i = 1; i < ETC_NUM_TEXELS; ++i)
+	{
+		minValue = std::min(minValue, values[i]);
+		maxBlockValue = std::max(maxBlockValue, values[i]);
+	}
+
+	uint32_t bestError = maxError, bestIndices[ETC_NUM_TEXELS] = {};
+	int32_t bestBase = 0, bestMultiplier = minMultiplier, bestTable = 0;
+	for (int32_t table = 0; table < 16 && bestError; ++table)
+	{
+		const int32_t* modifiers = eacModifiers[table];
+		const float modifierRange = static_cast<float>((modifiers[7] - modifiers[3]) * (isEightBitAlpha ? 1 : 8));
+		const int32_t idealMultiplier = clampInt(static_cast<int32_t>(std::floor(static_cast<float>(maxBlockValue - minValue) / modifierRange + .5f)), minMultiplier, 15);
+		for (int32_t multiplier = std::max(minMultiplier, idealMultiplier - multiplierRadius); multiplier <= std::min(15, idealMultiplier + multiplierRadius); ++multiplier)
+		{
+			const int32_t step = isEightBitAlpha ? multiplier : (multiplier ? multiplier * 8 : 1);
+			const float center = static_cast<float>(minValue + maxBlockValue) * .5f - static_cast<float>(modifiers[3] + modifiers[7]) * .5f * static_cast<float>(step);
+			const int32_t idealBase = static_cast<int32_t>(std::floor((isEightBitAlpha ? center : (center - 4.f) / 8.f) + .5f));
+			for (int32_t base = std::max(0, idealBase - baseRadius); base <= std::min(255, idealBase + baseRadius); ++base)
+			{
+				int32_t decoded[8];
+				for (uint32_t index = 0; index < 8; ++index)
+				{ decoded[index] = clampInt((isEightBitAlpha ? base : base * 8 + 4) + modifiers[index] * step, 0, maxValue); }
+				uint32_t error = 0, indices[ETC_NUM_TEXELS];
+				for (uint32_t i = 0; i < ETC_NUM_TEXELS && error < bestError; ++i)
+				{
+					uint32_t bestValueError = maxError;
+					for (uint32_t index = 0; index < 8; ++index)
+					{
+						const uint32_t valueError = square(decoded[index] - values[i]);
+						if (valueError < bestValueError)
+						{
+							bestValueError = valueError;
+							indices[i] = index;
+						}
+					}
+					error += bestValueError;
+				}
+				if (error < bestError)
+				{
+					bestError = error;
+					bestBase = base;
+					bestMultiplier = multiplier;
+					bestTable = table;
+					memcpy(bestIndices, indices, sizeof(indices));
+				}
+			}
+		}
+	}
+
+	// The 3 bit indices are stored column-major, most significant first.
+	uint64_t bits = 0;
+	for (uint32_t i = 0; i < ETC_NUM_TEXELS; ++i) { bits |= static_cast<uint64_t>(bestIndices[i]) << (45 - 3 * ((i % ETC_BLOCK_DIM) * ETC_BLOCK_DIM + i / ETC_BLOCK_DIM)); }
+	outBlock[0] = static_cast<uint8_t>(bestBase);
+	outBlock[1] = static_cast<uint8_t>((bestMultiplier << 4) | bestTable);
+	for (uint32_t i = 0; i < 6; ++i) { outBlock[2 + i] = static_cast<uint8_t>(bits >> (40 - 8 * i)); }
+}
+
+// Encodes a channel of 16 RGBA 8888 pixels into an EAC block.
+void encodeEacChannel(const uint8_t (*texels)[4], uint32_t channel, bool isEightBitAlpha, CompressionQuality quality, uint8_t* outBlock)
+{
+	int32_t values[ETC_NUM_TEXELS];
+	// 11 bit channels are rescaled so that 255 maps to 2047.
+	for (uint32_t i = 0; i < ETC_NUM_TEXELS; ++i) { values[i] = isEightBitAlpha ? texels[i][channel] : (texels[i][channel] * 2047 + 127) / 255; }
+	encodeEacBlock(values, isEightBitAlpha, quality, outBlock);
+}
+
+void encodeEtcBlock(const uint8_t (*texels)[4], EtcBlockType type, CompressionQuality quality, uint8_t* outBlock)
+{
+	switch (type)
+	{
+	case EtcBlockType::ETC1:
+	case EtcBlockType::ETC2_RGB:
+	case EtcBlockType::ETC2_RGB_A1: encodeColorBlock(texels, type, quality, outBlock); break;
+	case EtcBlockType::ETC2_RGBA:
+		encodeEacChannel(texels, 3, true, quality, outBlock);
+		encodeColorBlock(texels, EtcBlockType::ETC2_RGB, quality, outBlock + 8);
+		break;
+	case EtcBlockType::EAC_R11: encodeEacChannel(texels, 0, false, quality, outBlock); break;
+	case EtcBlockType::EAC_RG11:
+		encodeEacChannel(texels, 0, false, quality, outBlock);
+		encodeEacChannel(texels, 1, false, quality, outBlock + 8);
+		break;
+	}
+}
+
+// Encodes a row of blocks. Partial blocks at the right and bottom edges are padded by repeating the last column and row.
+void encodeEtcBlockRow(const uint8_t* src, uint32_t xDim, uint32_t yDim, uint32_t blockY, uint8_t* dst, EtcBlockType type, CompressionQuality quality)
+{
+	const uint32_t numBlocksX = (xDim + ETC_BLOCK_DIM - 1) / ETC_BLOCK_DIM;
+	const uint32_t blockSize = getEtcBlockSize(type);
+	uint8_t texels[ETC_NUM_TEXELS][4];
+	for (uint32_t blockX = 0; blockX < numBlocksX; ++blockX)
+	{
+		for (uint32_t i = 0; i < ETC_NUM_TEXELS; ++i)
+		{
+			const uint32_t x = std::min(blockX * ETC_BLOCK_DIM + i % ETC_BLOCK_DIM, xDim - 1);
+			const uint32_t y = std::min(blockY * ETC_BLOCK_DIM + i / ETC_BLOCK_DIM, yDim - 1);
+			memcpy(texels[i], src + (static_cast<size_t>(y) * xDim + x) * 4, 4);
+		}
+		encodeEtcBlock(texels, type, quality, dst + (static_cast<size_t>(blockY) * numBlocksX + blockX) * blockSize);
+	}
+}
+} // namespace
+
+bool isETCCompressionSupported(CompressedPixelFormat format)
+{
+	EtcBlockType type;
+	return getEtcBlockType(format, type);
+}
+
+uint32_t PVRTCompressETC(const void* srcData, uint32_t xDim, uint32_t yDim, void* dstData, CompressedPixelFormat format, const CompressionOptions& options)
+{
+	EtcBlockType type;
+	if (!getEtcBlockType(format, type) || !xDim || !yDim) { return 0; }
+	const uint32_t numBlocksX = (xDim + ETC_BLOCK_DIM - 1) / ETC_BLOCK_DIM;
+	const uint32_t numBlocksY = (yDim + ETC_BLOCK_DIM - 1) / ETC_BLOCK_DIM;
+	const uint8_t* input = static_cast<const uint8_t*>(srcData);
+	uint8_t* output = static_cast<uint8_t*>(dstData);
+
+	// Every row of blocks is independent, and encoding a block is far more expensive than decoding it, so even small images are split.
+	const uint32_t numThreads = impl::getDecompressionThreadCount(options.maxThreads, numBlocksY, std::max(1u, 64u / numBlocksX));
+	impl::parallelForBands(0, static_cast<int32_t>(numBlocksY), numThreads, [&](int32_t firstBlockY, int32_t lastBlockY) {
+		for (int32_t blockY = firstBlockY; blockY < lastBlockY; ++blockY) { encodeEtcBlockRow(input, xDim, yDim, static_cast<uint32_t>(blockY), output, type, options.quality); }
+	}, options.jobSystem);
+	return numBlocksX * numBlocksY * getEtcBlockSize(type);
+}
+
+Texture compressTexture(const Texture& texture, CompressedPixelFormat format, const CompressionOptions& options)
+{
+	EtcBlockType type;
+	if (!getEtcBlockType(format, type)) { throw InvalidArgumentError("format", "[compressTexture]: Cannot compress to " + to_string(PixelFormat(format))); }
+	if (texture.getPixelFormat().isCompressedFormat()) { throw InvalidArgumentError("texture", "[compressTexture]: The texture is already compressed"); }
+
+	// The compressor works on RGBA 8888. The EAC formats store data rather than colours, so they are always linear.
+	const bool isEac = type == EtcBlockType::EAC_R11 || type == EtcBlockType::EAC_RG11;
+	const ColorSpace colorSpace = isEac ? ColorSpace::lRGB : texture.getColorSpace();
+	const PixelFormat rgba8 = GeneratePixelType4<'r', 'g', 'b', 'a', 8, 8, 8, 8>::ID;
+	Texture converted;
+	const Texture* source = &texture;
+	if (texture.getPixelFormat() != rgba8 || texture.getChannelType() != VariableType::UnsignedByteNorm || texture.getColorSpace() != colorSpace)
+	{
+		TranscodeOptions transcodeOptions;
+		transcodeOptions.maxThreads = options.maxThreads;
+		converted = transcodeTexture(texture, rgba8, VariableType::UnsignedByteNorm, colorSpace, transcodeOptions);
+		source = &converted;
+	}
+
+	TextureHeader header(*source);
+	header.setPixelFormat(PixelFormat(format));
+	header.setChannelType(VariableType::UnsignedByteNorm);
+	header.setColorSpace(colorSpace);
+	Texture result(header);
+
+	// Every depth slice of every surface is an independent image. Rows of blocks are handed out one at a time across all of them, which balances the
+	// large top levels against the many small MIP map levels.
+	struct Slice
+	{
+		const uint8_t* src;
+		uint8_t* dst;
+		uint32_t width;
+		uint32_t height;
+		uint32_t firstBlockRow;
+	};
+	std::vector<Slice> slices;
+	const uint32_t blockSize = getEtcBlockSize(type);
+	uint32_t numBlockRows = 0;
+	for (uint32_t mipLevel = 0; mipLevel < header.getNumMipMapLevels(); ++mipLevel)
+	{
+		const uint32_t width = header.getWidth(mipLevel), height = header.getHeight(mipLevel), depth = header.getDepth(mipLevel);
+		const uint32_t numBlocksX = (width + ETC_BLOCK_DIM - 1) / ETC_BLOCK_DIM, numBlocksY = (height + ETC_BLOCK_DIM - 1) / ETC_BLOCK_DIM;
+		for (uint32_t arrayMember = 0; arrayMember < header.getNumArrayMembers(); ++arrayMember)
+		{
+			for (uint32_t face = 0; face < header.getNumFaces(); ++face)
+			{
+				const uint8_t* src = source->getDataPointer(mipLevel, arrayMember, face);
+				uint8_t* dst = result.getDataPointer(mipLevel, arrayMember, face);
+				for (uint32_t slice = 0; slice < depth; ++slice)
+				{
+					slices.push_back(Slice{ src + static_cast<size_t>(slice) * width * height * 4, dst + static_cast<size_t>(slice) * numBlocksX * numBlocksY * blockSize, width,
+						height, numBlockRows });
+					numBlockRows += numBlocksY;
+				}
+			}
+		}
+	}
+
+	const uint32_t numThreads = impl::getDecompressionThreadCount(options.maxThreads, numBlockRows, 1);
+	impl::parallelForEachItem(numBlockRows, numThreads, [&](uint32_t blockRow) {
+		const auto slice = std::upper_bound(slices.begin(), slices.end(), blockRow, [](uint32_t row, const Slice& s) { return row < s.firstBlockRow; }) - 1;
+		encodeEtcBlockRow(slice->src, slice->width, slice->height, blockRow - slice->firstBlockRow, slice->dst, type, options.quality);
+	}, options.jobSystem);
+	return result;
+}
+} // namespace pvr
+//!\endcond
@@ -0,0 +1,62 @@
+/*!
+\brief Contains functions to compress RGBA8888 pixels and textures into the ETC1, ETC2 and EAC formats.
+\file PVRCore/texture/ETCCompress.h
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+#pragma once
+#include "PVRCore/texture/Texture.h"
+namespace pvr {
+namespace async {
+class JobSystem;
+}
+
+/// <summary>Trades the quality of the compressed blocks against compression speed.</summary>
+enum class CompressionQuality
+{
+	Fast, ///< Base colours are the averages of the sub-blocks. The ETC2 formats also try the planar mode. Suited to previews and iteration.
+	Normal, ///< Base colours are refined for the promising modifier tables, and the ETC2 formats also try the 'T' and 'H' modes. 2 to 4 times slower than Fast.
+	High, ///< Refines every modifier table, searches the neighbouring quantized base colours and refines the 'T' and 'H' colours. 2 to 5 times slower than Normal.
+};
+
+/// <summary>Controls how the block compressors execute. The defaults use the Normal quality and one thread per hardware thread.</summary>
+struct CompressionOptions
+{
+	CompressionQuality quality; ///< The quality preset
+	uint32_t maxThreads; ///< The maximum number of threads to compress with. 0 uses one thread per hardware thread, 1 compresses on the calling thread.
+	async::JobSystem* jobSystem; ///< Optional. If not null, the work is spread over the workers of this job system instead of threads created for each call.
+
+	/// <summary>Constructor. Defaults to the Normal quality, all hardware threads and no job system.</summary>
+	/// <param name="quality">The quality preset</param>
+	CompressionOptions(CompressionQuality quality = CompressionQuality::Normal) : quality(quality), maxThreads(0), jobSystem(nullptr) {}
+};
+
+/// <summary>Query whether a format can be compressed to by PVRTCompressETC and compressTexture: ETC1, ETC2 RGB, ETC2 RGBA, ETC2 RGB with
+/// punch-through alpha, and unsigned EAC R11 and RG11.</summary>
+/// <param name="format">The compressed pixel format</param>
+/// <returns>True if the format can be compressed to, otherwise false</returns>
+bool isETCCompressionSupported(CompressedPixelFormat format);
+
+/// <summary>Compresses RGBA 8888 pixels to any format of the ETC family supported by isETCCompressionSupported. Rows of blocks are encoded in parallel,
+/// and the output does not depend on the number of threads. The EAC formats encode red (R11) or red and green (RG11) as unsigned values, the
+/// punch-through format treats alpha below 128 as transparent, and the colour formats ignore alpha. Dimensions do not need to be multiples of the block
+/// size: partial blocks at the right and bottom edges are padded by repeating the last column and row.</summary>
+/// <param name="srcData">The RGBA 8888 pixels to compress, row by row</param>
+/// <param name="xDim">X dimension of the image</param>
+/// <param name="yDim">Y dimension of the image</param>
+/// <param name="dstData">The compressed data. Must hold one 8 byte block (16 bytes for ETC2 RGBA and EAC RG11) per 4x4 pixels.</param>
+/// <param name="format">The format to compress to</param>
+/// <param name="options">Quality and threading options</param>
+/// <returns>Return The number of bytes of compressed data written, or 0 if the format is not supported.</returns>
+uint32_t PVRTCompressETC(const void* srcData, uint32_t xDim, uint32_t yDim, void* dstData, CompressedPixelFormat format, const CompressionOptions& options);
+
+/// <summary>Creates a compressed copy of a texture, encoding every MIP map level, array member, face and depth slice. The blocks of all the surfaces
+/// are encoded in parallel. Textures which are not RGBA 8888 are first converted to it with transcodeTexture, so the texture must be uncompressed and
+/// its format supported by isTranscodingSupported.</summary>
+/// <param name="texture">The texture to compress</param>
+/// <param name="format">The format to compress to. Must be supported by isETCCompressionSupported, otherwise throws InvalidArgumentError.</param>
+/// <param name="options">Quality and threading options</param>
+/// <returns>The compressed texture, with the same dimensions, MIP map levels and metadata as the original one. The colour formats keep the colour
+/// space of the original texture. The EAC formats are always linear, and sRGB textures are converted.</returns>
+Texture compressTexture(const Texture& texture, CompressedPixelFormat format, const CompressionOptions& options = CompressionOptions());
+} // namespace pvr
@@ -53,76 +53,38 @@ public:
 
 public:
 	/// <summary>Constructor</summary>
-	TextureMetaData() : _fourCC(0), _key(0), _dataSize(0), _data(NULL) {}
+	TextureMetaData() : _fourCC(0), _key(0), _dataSize(0), _heapData(NULL) {}
 
 	/// <summary>Constructor</summary>
 	/// <param name="fourCC">FourCC of the metadata</param>
 	/// <param name="key">Key of the metadata</param>
 	/// <param name="dataSize">The total size of the payload of the metadata</param>
-	/// <param name="data">A pointer to the actual data</param>
-	TextureMetaData(uint32_t fourCC, uint32_t key, uint32_t dataSize, const char* data) : _fourCC(0), _key(0), _dataSize(0), _data(NULL)
+	/// <param name="data">A pointer to the actual data. If NULL, the data is zero initialised.</param>
+	TextureMetaData(uint32_t fourCC, uint32_t key, uint32_t dataSize, const char* data) : _fourCC(fourCC), _key(key), _dataSize(0), _heapData(NULL)
 	{
-		// Copy the data across.
-		if (dataSize)
+		allocate(dataSize);
+		if (!_dataSize) { return; }
+		if (data) { memcpy(getData(), data, _dataSize); }
+		else
 		{
-			_data = new unsigned char[dataSize];
-			memset(_data, 0, sizeof(unsigned char) * dataSize);
-		}
-		if (_data)
-		{
-			_fourCC = fourCC;
-			_key = key;
-			_dataSize = dataSize;
-			if (data) { memcpy(_data, data, _dataSize); }
+			memset(getData(), 0, _dataSize);
 		}
 	}
 
 	/// <summary>Copy Constructor</summary>
 	/// <param name="rhs">Copy from this object</param>
-	TextureMetaData(const TextureMetaData& rhs) : _fourCC(0), _key(0), _dataSize(0), _data(NULL)
+	TextureMetaData(const TextureMetaData& rhs) : _fourCC(rhs._fourCC), _key(rhs._key), _dataSize(0), _heapData(NULL)
 	{
-		// Copy the data across.
-		if (rhs._dataSize)
-		{
-			_data = new unsigned char[rhs._dataSize];
-			memset(_data, 0, sizeof(unsigned char) * rhs._dataSize);
-		}
-		if (_data)
-		{
-			_fourCC = rhs._fourCC;
-			_key = rhs._key;
-			_dataSize = rhs._dataSize;
-			if (rhs._data) { memcpy(_data, rhs._data, _dataSize); }
-		}
-	}
-	/// <summary>Copy Constructor</summary>
-	/// <param name="rhs">Copy from this object</param>
-	TextureMetaData(const TextureMetaData&& rhs) : _fourCC(0), _key(0), _dataSize(0), _data(NULL)
-	{
-		// Copy the data across.
-		if (rhs._dataSize)
-		{
-			_data = new unsigned char[rhs._dataSize];
-			memset(_data, 0, sizeof(unsigned char) * rhs._dataSize);
-		}
-		if (_data)
-		{
-			_fourCC = rhs._fourCC;
-			_key = rhs._key;
-			_dataSize = rhs._dataSize;
-			if (rhs._data) { memcpy(_data, rhs._data, _dataSize); }
-		}
+		allocate(rhs._dataSize);
+		if (_dataSize) { memcpy(getData(), rhs.getData(), _dataSize); }
 	}
 
+	/// <summary>Move Constructor. Takes over the data of rhs if it is stored on the heap.</summary>
+	/// <param name="rhs">Move from this object</param>
+	TextureMetaData(TextureMetaData&& rhs) noexcept : _fourCC(0), _key(0), _dataSize(0), _heapData(NULL) { moveFrom(rhs); }
+
 	/// <summary>Destructor</summary>
-	~TextureMetaData()
-	{
-		if (_data)
-		{
-			delete[] _data;
-			_data = NULL;
-		}
-	}
+	~TextureMetaData() { delete[] _heapData; }
 
 	/// <summary>Copy assignment operator</summary>
 	/// <param name="rhs">Copy from this object</param>
@@ -131,27 +93,19 @@ public:
 	{
 		// If it equals itself, return early.
 		if (&rhs == this) { return *this; }
+		_fourCC = rhs._fourCC;
+		_key = rhs._key;
+		allocate(rhs._dataSize);
+		if (_dataSize) { memcpy(getData(), rhs.getData(), _dataSize); }
+		return *this;
+	}
 
-		// Initialize
-		_fourCC = _key = _dataSize = 0;
-
-		// Delete any old data
-		if (_data)
-		{
-			delete[] _data;
-			_data = NULL;
-		}
-
-		// Copy the data across.
-		_data = new unsigned char[rhs._dataSize];
-		if (_data)
-		{
-			_fourCC = rhs._fourCC;
-			_key = rhs._key;
-			_dataSize = rhs._dataSize;
-			if (rhs._data) { memcpy(_data, rhs._data, _dataSize); }
-		}
-
+	/// <summary>Move assignment operator</summary>
+	/// <param name="rhs">Move from this object</param>
+	/// <returns>This object</returns>
+	TextureMetaData& operator=(TextureMetaData&& rhs) noexcept
+	{
+		if (&rhs != this) { moveFrom(rhs); }
 		return *this;
 	}
 
@@ -170,22 +124,59 @@ public:
 
 	/// <summary>Get the data, can be absolutely anything, the loader needs to know how to handle it based on fourCC
 	/// and key.</summary>
-	/// <returns>Return the data</returns>
-	const unsigned char* getData() const { return _data; }
+	/// <returns>Return the data, or NULL if the data is empty</returns>
+	const unsigned char* getData() const { return _heapData ? _heapData : _dataSize ? _localData : NULL; }
 	/// <summary>Get the data, can be absolutely anything, the loader needs to know how to handle it based on fourCC
 	/// and key.</summary>
-	/// <returns>Return the data</returns>
-	unsigned char* getData() { return _data; }
+	/// <returns>Return the data, or NULL if the data is empty</returns>
+	unsigned char* getData() { return _heapData ? _heapData : _dataSize ? _localData : NULL; }
 
 	/// <summary>Get the data total size in memory</summary>
 	/// <returns>Return the data total size in memory</returns>
 	uint32_t getTotalSizeInMemory() const { return sizeof(_fourCC) + sizeof(_key) + sizeof(_dataSize) + _dataSize; }
 
 private:
+	// The size up to which the data is stored in the object itself rather than on the heap. It covers all the meta data defined by the PVR format (orientation,
+	// cube map order, bump data, ...), so that most headers do not allocate for their meta data.
+	enum
+	{
+		LocalDataCapacity = 16
+	};
+
+	// Sets the size of the data, reusing the current heap storage if it is large enough. The content of the data is undefined.
+	void allocate(uint32_t dataSize)
+	{
+		if (dataSize > LocalDataCapacity && (!_heapData || dataSize > _dataSize))
+		{
+			delete[] _heapData;
+			_heapData = new unsigned char[dataSize];
+		}
+		else if (dataSize <= LocalDataCapacity)
+		{
+			delete[] _heapData;
+			_heapData = NULL;
+		}
+		_dataSize = dataSize;
+	}
+
+	void moveFrom(TextureMetaData& rhs)
+	{
+		delete[] _heapData;
+		_fourCC = rhs._fourCC;
+		_key = rhs._key;
+		_dataSize = rhs._dataSize;
+		_heapData = rhs._heapData;
+		if (!_heapData && _dataSize) { memcpy(_localData, rhs._localData, _dataSize); }
+		rhs._heapData = NULL;
+		rhs._dataSize = 0;
+	}
+
 	uint32_t _fourCC; // A 4cc descriptor of the data type's creator.
 	// Values equating to values between 'P' 'V' 'R' 0 and 'P' 'V' 'R' 255 will be used by our headers.
 	uint32_t _key; // Enumeration key identifying the data type.
 	uint32_t _dataSize; // Size of attached data.
-	unsigned char* _data; // Data array, can be absolutely anything, the loader needs to know how to handle it based on fourCC and key.
+	unsigned char* _heapData; // The data if larger than LocalDataCapacity, NULL otherwise
+	unsigned char _localData[LocalDataCapacity]; // The data if not larger than LocalDataCapacity
+	// The data can be absolutely anything, the loader needs to know how to handle it based on fourCC and key.
 };
 } // namespace pvr
@@ -0,0 +1,559 @@
+/*!
+\brief Implementation of the CPU MIP map generation functions.
+\file PVRCore/texture/MipmapGenerator.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+
+#include "MipmapGenerator.h"
+#include "ParallelDecompress.h"
+#include "PixelConversion.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PVR_MIPMAP_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define PVR_MIPMAP_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace pvr {
+namespace {
+// Texels are filtered as 4 floats, whatever the number of channels of the texture.
+enum
+{
+	FLOATS_PER_TEXEL = 4,
+	KAISER_HALF_WIDTH = 3, // In texels of the smaller level
+	MIN_TEXELS_PER_THREAD = 16384, // Below this, starting a thread costs more than filtering
+};
+const float kaiserAlpha = 4.f;
+const double pi = 3.14159265358979323846;
+
+enum class ChannelEncoding
+{
+	UnsignedNorm8,
+	SignedNorm8,
+	UnsignedNorm16,
+	SignedNorm16,
+	Half,
+	Float,
+};
+
+struct TexelFormat
+{
+	ChannelEncoding encoding;
+	uint32_t numChannels;
+	uint32_t bytesPerChannel;
+	bool isChannelGammaEncoded[4]; // True for the colour channels of sRGB textures filtered in linear space
+	bool isUnsigned; // Values are clamped to be non negative (normalized and unsigned float formats)
+};
+
+bool getTexelFormat(const TextureHeader& header, TexelFormat& outFormat)
+{
+	const PixelFormat pixelFormat = header.getPixelFormat();
+	if (pixelFormat.getPart().High == 0 || header.getNumPlanes() > 1) { return false; }
+	outFormat.numChannels = pixelFormat.getNumChannels();
+	if (outFormat.numChannels == 0) { return false; }
+	const uint32_t bits = pixelFormat.getChannelBits(0);
+	for (uint8_t channel = 1; channel < outFormat.numChannels; ++channel)
+	{
+		if (pixelFormat.getChannelBits(channel) != bits) { return false; }
+	}
+	switch (header.getChannelType())
+	{
+	case VariableType::UnsignedByteNorm:
+		if (bits != 8) { return false; }
+		outFormat.encoding = ChannelEncoding::UnsignedNorm8;
+		break;
+	case VariableType::SignedByteNorm:
+		if (bits != 8) { return false; }
+		outFormat.encoding = ChannelEncoding::SignedNorm8;
+		break;
+	case VariableType::UnsignedShortNorm:
+		if (bits != 16) { return false; }
+		outFormat.encoding = ChannelEncoding::UnsignedNorm16;
+		break;
+	case VariableType::SignedShortNorm:
+		if (bits != 16) { return false; }
+		outFormat.encoding = ChannelEncoding::SignedNorm16;
+		break;
+	case VariableType::SignedFloat:
+	case VariableType::UnsignedFloat:
+		if (bits != 16 && bits != 32) { return false; }
+		outFormat.encoding = bits == 16 ? ChannelEncoding::Half : ChannelEncoding::Float;
+		break;
+	default: return false;
+	}
+	outFormat.bytesPerChannel = bits / 8;
+	outFormat.isUnsigned = header.getChannelType() == VariableType::UnsignedByteNorm || header.getChannelType() == VariableType::UnsignedShortNorm ||
+		header.getChannelType() == VariableType::UnsignedFloat;
+	for (uint8_t channel = 0; channel < 4; ++channel) { outFormat.isChannelGammaEncoded[channel] = false; }
+	return true;
+}
+
+inline float clampFloat(float value, float minValue, float maxValue) { return std::min(std::max(value, minValue), maxValue); }
+
+// Reads the texels of a surface into 4 floats per texel. Unused channels are 0.
+void loadTexels(const uint8_t* source, size_t numTexels, const TexelFormat& format, float* outTexels)
+{
+	const impl::SrgbTables& srgb = impl::getSrgbTables();
+	const uint32_t texelSize = format.numChannels * format.bytesPerChannel;
+	if (format.encoding == ChannelEncoding::UnsignedNorm8)
+	{
+		// The most common case: one table lookup per channel.
+		float channelTables[4][256];
+		for (uint32_t channel = 0; channel < format.numChannels; ++channel)
+		{
+			for (uint32_t i = 0; i < 256; ++i) { channelTables[channel][i] = format.isChannelGammaEncoded[channel] ? srgb.toLinear[i] : i / 255.f; }
+		}
+		for (size_t texel = 0; texel < numTexels; ++texel)
+		{
+			float* outTexel = outTexels + texel * FLOATS_PER_TEXEL;
+			for (uint32_t channel = 0; channel < FLOATS_PER_TEXEL; ++channel)
+			{ outTexel[channel] = channel < format.numChannels ? channelTables[channel][source[texel * texelSize + channel]] : 0.f; }
+		}
+		return;
+	}
+	for (size_t texel = 0; texel < numTexels; ++texel)
+	{
+		const uint8_t* sourceTexel = source + texel * texelSize;
+		float* outTexel = outTexels + texel * FLOATS_PER_TEXEL;
+		for (uint32_t channel = 0; channel < FLOATS_PER_TEXEL; ++channel)
+		{
+			if (channel >= format.numChannels)
+			{
+				outTexel[channel] = 0.f;
+				continue;
+			}
+			const uint8_t* value = sourceTexel + channel * format.bytesPerChannel;
+			float result = 0.f;
+			switch (format.encoding)
+			{
+			case ChannelEncoding::UnsignedNorm8: result = format.isChannelGammaEncoded[channel] ? srgb.toLinear[*value] : *value / 255.f; break;
+			case ChannelEncoding::SignedNorm8: result = std::max(-1.f, static_cast<int8_t>(*value) / 127.f); break;
+			case ChannelEncoding::UnsignedNorm16:
+			case ChannelEncoding::SignedNorm16:
+			case ChannelEncoding::Half:
+			{
+				uint16_t value16;
+				memcpy(&value16, value, sizeof(value16));
+				if (format.encoding == ChannelEncoding::Half) { result = impl::halfToFloat(value16); }
+				else if (format.encoding == ChannelEncoding::SignedNorm16)
+				{
+					result = std::max(-1.f, static_cast<int16_t>(value16) / 32767.f);
+				}
+				else
+				{
+					result = value16 / 65535.f;
+					if (format.isChannelGammaEncoded[channel]) { result = impl::srgbToLinear(result); }
+				}
+				break;
+			}
+			case ChannelEncoding::Float: memcpy(&result, value, sizeof(result)); break;
+			}
+			outTexel[channel] = result;
+		}
+	}
+}
+
+// Writes texels of 4 floats in the format of the texture, rounding to nearest and clamping to the range of the format.
+void storeTexels(const float* texels, size_t numTexels, const TexelFormat& format, uint8_t* destination)
+{
+	const impl::SrgbTables& srgb = impl::getSrgbTables();
+	const uint32_t texelSize = format.numChannels * format.bytesPerChannel;
+	if (format.encoding == ChannelEncoding::UnsignedNorm8)
+	{
+		for (size_t texel = 0; texel < numTexels; ++texel)
+		{
+			for (uint32_t channel = 0; channel < format.numChannels; ++channel)
+			{
+				const float value = texels[texel * FLOATS_PER_TEXEL + channel];
+				destination[texel * texelSize + channel] = format.isChannelGammaEncoded[channel] ? srgb.encode(value) : static_cast<uint8_t>(clampFloat(value, 0.f, 1.f) * 255.f + .5f);
+			}
+		}
+		return;
+	}
+	for (size_t texel = 0; texel < numTexels; ++texel)
+	{
+		const float* sourceTexel = texels + texel * FLOATS_PER_TEXEL;
+		uint8_t* outTexel = destination + texel * texelSize;
+		for (uint32_t channel = 0; channel < format.numChannels; ++channel)
+		{
+			float value = sourceTexel[channel];
+			if (format.isUnsigned) { value = std::max(value, 0.f); }
+			uint8_t* outValue = outTexel + channel * format.bytesPerChannel;
+			switch (format.encoding)
+			{
+			case ChannelEncoding::UnsignedNorm8:
+				*outValue = format.isChannelGammaEncoded[channel] ? srgb.encode(value) : static_cast<uint8_t>(std::min(value, 1.f) * 255.f + .5f);
+				break;
+			case ChannelEncoding::SignedNorm8: *outValue = static_cast<uint8_t>(static_cast<int8_t>(std::floor(clampFloat(value, -1.f, 1.f) * 127.f + .5f))); break;
+			case ChannelEncoding::UnsignedNorm16:
+			case ChannelEncoding::SignedNorm16:
+			case ChannelEncoding::Half:
+			{
+				uint16_t value16;
+				if (format.encoding == ChannelEncoding::Half)
+				{
+					// Finite values too large for a half are clamped to the largest half rather than becoming infinite.
+					value16 = impl::floatToHalf(std::isinf(value) ? value : clampFloat(value, -65504.f, 65504.f));
+				}
+				else if (format.encoding == ChannelEncoding::SignedNorm16)
+				{
+					value16 = static_cast<uint16_t>(static_cast<int16_t>(std::floor(clampFloat(value, -1.f, 1.f) * 32767.f + .5f)));
+				}
+				else
+				{
+					value = std::min(value, 1.f);
+					if (format.isChannelGammaEncoded[channel]) { value = impl::linearToSrgb(value); }
+					value16 = static_cast<uint16_t>(value * 65535.f + .5f);
+				}
+				memcpy(outValue, &value16, sizeof(value16));
+				break;
+			}
+			case ChannelEncoding::Float: memcpy(outValue, &value, sizeof(value)); break;
+			}
+		}
+	}
+}
+
+////////////////////////////////////////////// Filter kernels //////////////////////////////////////////////
+// The weights of the source texels of every destination texel along one dimension. Every destination texel has the same number of taps, starting at
+// its own first source texel, so that the filter loops have no data dependent bounds. Taps outside the filter footprint have a weight of 0.
+struct FilterKernel
+{
+	uint32_t numTaps;
+	std::vector<uint32_t> firstTap;
+	std::vector<float> weights; // numTaps weights per destination texel
+};
+
+double besselI0(double x)
+{
+	double sum = 1., term = 1.;
+	for (uint32_t k = 1; k < 32; ++k)
+	{
+		term *= (x / (2. * k)) * (x / (2. * k));
+		sum += term;
+		if (term < sum * 1e-12) { break; }
+	}
+	return sum;
+}
+
+// x is in texels of the destination level.
+double kaiserWindowedSinc(double x)
+{
+	const double t = x / KAISER_HALF_WIDTH;
+	if (t <= -1. || t >= 1.) { return 0.; }
+	const double sinc = std::fabs(x) < 1e-9 ? 1. : std::sin(pi * x) / (pi * x);
+	return sinc * besselI0(kaiserAlpha * std::sqrt(1. - t * t)) / besselI0(kaiserAlpha);
+}
+
+FilterKernel buildFilterKernel(uint32_t sourceSize, uint32_t destinationSize, MipmapFilter filter)
+{
+	const double scale = static_cast<double>(sourceSize) / destinationSize;
+	std::vector<std::vector<double> > taps(destinationSize);
+	std::vector<int32_t> firstTaps(destinationSize);
+	uint32_t numTaps = 1;
+	for (uint32_t i = 0; i < destinationSize; ++i)
+	{
+		// The footprint of the destination texel, in source texels. Out of range taps are clamped to the edge.
+		int32_t first, last;
+		if (filter == MipmapFilter::Box)
+		{
+			first = static_cast<int32_t>(std::floor(i * scale));
+			last = static_cast<int32_t>(std::ceil((i + 1) * scale)) - 1;
+		}
+		else
+		{
+			const double center = (i + .5) * scale;
+			first = static_cast<int32_t>(std::floor(center - KAISER_HALF_WIDTH * scale));
+			last = static_cast<int32_t>(std::ceil(center + KAISER_HALF_WIDTH * scale));
+		}
+		const int32_t clampedFirst = std::max(first, 0);
+		const int32_t clampedLast = std::min(last, static_cast<int32_t>(sourceSize) - 1);
+		std::vector<double>& weights = taps[i];
+		weights.assign(static_cast<size_t>(clampedLast - clampedFirst + 1), 0.);
+		double sum = 0.;
+		for (int32_t j = first; j <= last; ++j)
+		{
+			double weight;
+			if (filter == MipmapFilter::Box) { weight = std::min<double>(j + 1, (i + 1) * scale) - std::max<double>(j, i * scale); }
+			else
+			{
+				weight = kaiserWindowedSinc((j + .5 - (i + .5) * scale) / scale);
+			}
+			weights[static_cast<size_t>(std::min(std::max(j, clampedFirst), clampedLast) - clampedFirst)] += weight;
+			sum += weight;
+		}
+		for (double& weight : weights) { weight /= sum; }
+		firstTaps[i] = clampedFirst;
+		numTaps = std::max(numTaps, static_cast<uint32_t>(weights.size()));
+	}
+
+	FilterKernel kernel;
+	kernel.numTaps = numTaps;
+	kernel.firstTap.resize(destinationSize);
+	kernel.weights.assign(static_cast<size_t>(destinationSize) * numTaps, 0.f);
+	for (uint32_t i = 0; i < destinationSize; ++i)
+	{
+		// Shift windows that would run past the end of the source back, with leading zero weights.
+		const uint32_t first = std::min(static_cast<uint32_t>(firstTaps[i]), sourceSize - numTaps);
+		kernel.firstTap[i] = first;
+		for (size_t t = 0; t < taps[i].size(); ++t) { kernel.weights[i * numTaps + (firstTaps[i] - first) + t] = static_cast<float>(taps[i][t]); }
+	}
+	return kernel;
+}
+
+// Filters a row of texels horizontally: destination texel i is the weighted sum of the kernel's taps for i.
+typedef void (*PfnFilterRow)(const float* source, const FilterKernel& kernel, uint32_t destinationSize, float* destination);
+// Weighted sum of numRows rows of numFloats floats each.
+typedef void (*PfnBlendRows)(const float* const* sourceRows, const float* weights, uint32_t numRows, uint32_t numFloats, float* destination);
+
+void filterRow(const float* source, const FilterKernel& kernel, uint32_t destinationSize, float* destination)
+{
+	for (uint32_t i = 0; i < destinationSize; ++i)
+	{
+		const float* taps = source + kernel.firstTap[i] * FLOATS_PER_TEXEL;
+		const float* weights = &kernel.weights[i * kernel.numTaps];
+		float sum[FLOATS_PER_TEXEL] = { 0.f, 0.f, 0.f, 0.f };
+		for (uint32_t t = 0; t < kernel.numTaps; ++t)
+		{
+			for (uint32_t c = 0; c < FLOATS_PER_TEXEL; ++c) { sum[c] += weights[t] * taps[t * FLOATS_PER_TEXEL + c]; }
+		}
+		memcpy(destination + i * FLOATS_PER_TEXEL, sum, sizeof(sum));
+	}
+}
+
+void blendRows(const float* const* sourceRows, const float* weights, uint32_t numRows, uint32_t numFloats, float* destination)
+{
+	for (uint32_t f = 0; f < numFloats; ++f)
+	{
+		float sum = 0.f;
+		for (uint32_t r = 0; r < numRows; ++r) { sum += weights[r] * sourceRows[r][f]; }
+		destination[f] = sum;
+	}
+}
+
+#if defined(PVR_MIPMAP_SSE2)
+// A texel is one vector.
+void filterRowSimd(const float* source, const FilterKernel& kernel, uint32_t destinationSize, float* destination)
+{
+	for (uint32_t i = 0; i < destinationSize; ++i)
+	{
+		const float* taps = source + kernel.firstTap[i] * FLOATS_PER_TEXEL;
+		const float* weights = &kernel.weights[i * kernel.numTaps];
+		__m128 sum = _mm_setzero_ps();
+		for (uint32_t t = 0; t < kernel.numTaps; ++t) { sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weights[t]), _mm_loadu_ps(taps + t * FLOATS_PER_TEXEL))); }
+		_mm_storeu_ps(destination + i * FLOATS_PER_TEXEL, sum);
+	}
+}
+
+// numFloats is always a multiple of 4, as rows are made of texels.
+void blendRowsSimd(const float* const* sourceRows, const float* weights, uint32_t numRows, uint32_t numFloats, float* destination)
+{
+	for (uint32_t f = 0; f < numFloats; f += 4)
+	{
+		__m128 sum = _mm_setzero_ps();
+		for (uint32_t r = 0; r < numRows; ++r) { sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weights[r]), _mm_loadu_ps(sourceRows[r] + f))); }
+		_mm_storeu_ps(destination + f, sum);
+	}
+}
+#elif defined(PVR_MIPMAP_NEON)
+// A texel is one vector.
+void filterRowSimd(const float* source, const FilterKernel& kernel, uint32_t destinationSize, float* destination)
+{
+	for (uint32_t i = 0; i < destinationSize; ++i)
+	{
+		const float* taps = source + kernel.firstTap[i] * FLOATS_PER_TEXEL;
+		const float* weights = &kernel.weights[i * kernel.numTaps];
+		float32x4_t sum = vdupq_n_f32(0.f);
+		for (uint32_t t = 0; t < kernel.numTaps; ++t) { sum = vaddq_f32(sum, vmulq_n_f32(vld1q_f32(taps + t * FLOATS_PER_TEXEL), weights[t])); }
+		vst1q_f32(destination + i * FLOATS_PER_TEXEL, sum);
+	}
+}
+
+// numFloats is always a multiple of 4, as rows are made of texels.
+void blendRowsSimd(const float* const* sourceRows, const float* weights, uint32_t numRows, uint32_t numFloats, float* destination)
+{
+	for (uint32_t f = 0; f < numFloats; f += 4)
+	{
+		float32x4_t sum = vdupq_n_f32(0.f);
+		for (uint32_t r = 0; r < numRows; ++r) { sum = vaddq_f32(sum, vmulq_n_f32(vld1q_f32(sourceRows[r] + f), weights[r])); }
+		vst1q_f32(destination + f, sum);
+	}
+}
+#endif
+
+struct FilterKernels
+{
+	PfnFilterRow filterRow;
+	PfnBlendRows blendRows;
+};
+
+struct Extent
+{
+	uint32_t width, height, depth;
+};
+
+// Reduces a level, stored as 4 floats per texel, to the next one, one dimension at a time. Dimensions that do not change are not filtered.
+// If packedSource is not null, the level is read from it instead, converting each row just before it is filtered, which avoids converting the
+// whole top level (the largest by far) to floats. Only possible if the width changes, as the horizontal pass is the one reading the source.
+// Passes over small levels use fewer threads than numThreads, down to the calling thread alone.
+void reduceLevel(const std::vector<float>& source, const uint8_t* packedSource, const TexelFormat& format, Extent sourceExtent, Extent destinationExtent,
+	MipmapFilter filter, const FilterKernels& kernels, uint32_t numThreads, async::JobSystem* jobSystem, std::vector<float>& scratch, std::vector<float>& destination)
+{
+	const std::vector<float>* input = &source;
+	Extent extent = sourceExtent;
+	std::vector<float>* buffers[2] = { &scratch, &destination };
+	uint32_t numPasses = 0;
+	for (uint32_t dimension = 0; dimension < 3; ++dimension)
+	{
+		const uint32_t sourceSize = dimension == 0 ? extent.width : dimension == 1 ? extent.height : extent.depth;
+		const uint32_t destinationSize = dimension == 0 ? destinationExtent.width : dimension == 1 ? destinationExtent.height : destinationExtent.depth;
+		if (sourceSize == destinationSize) { continue; }
+		++numPasses;
+	}
+	// Alternate between the buffers so that the last pass writes to the destination.
+	uint32_t bufferIndex = numPasses % 2;
+
+	for (uint32_t dimension = 0; dimension < 3; ++dimension)
+	{
+		const uint32_t sourceSize = dimension == 0 ? extent.width : dimension == 1 ? extent.height : extent.depth;
+		const uint32_t destinationSize = dimension == 0 ? destinationExtent.width : dimension == 1 ? destinationExtent.height : destinationExtent.depth;
+		if (sourceSize == destinationSize) { continue; }
+		const FilterKernel kernel = buildFilterKernel(sourceSize, destinationSize, filter);
+		Extent outExtent = extent;
+		(dimension == 0 ? outExtent.width : dimension == 1 ? outExtent.height : outExtent.depth) = destinationSize;
+
+		std::vector<float>& output = *buffers[bufferIndex];
+		output.resize(static_cast<size_t>(outExtent.width) * outExtent.height * outExtent.depth * FLOATS_PER_TEXEL);
+		const float* in = input->data();
+		float* out = output.data();
+		const size_t inRowFloats = static_cast<size_t>(extent.width) * FLOATS_PER_TEXEL;
+		const size_t outRowFloats = static_cast<size_t>(outExtent.width) * FLOATS_PER_TEXEL;
+		const uint32_t numOutRows = outExtent.height * outExtent.depth;
+		const uint32_t numPassThreads = impl::getDecompressionThreadCount(numThreads, numOutRows, std::max(1u, MIN_TEXELS_PER_THREAD / outExtent.width));
+
+		impl::parallelForBands(0, static_cast<int32_t>(numOutRows), numPassThreads, [&](int32_t firstRow, int32_t lastRow) {
+			std::vector<const float*> rows(kernel.numTaps);
+			std::vector<float> unpackedRow(packedSource ? inRowFloats : 0);
+			for (uint32_t row = static_cast<uint32_t>(firstRow); row < static_cast<uint32_t>(lastRow); ++row)
+			{
+				if (dimension == 0)
+				{
+					const float* sourceRow = in + row * inRowFloats;
+					if (packedSource)
+					{
+						loadTexels(packedSource + static_cast<size_t>(row) * extent.width * format.numChannels * format.bytesPerChannel, extent.width, format, unpackedRow.data());
+						sourceRow = unpackedRow.data();
+					}
+					kernels.filterRow(sourceRow, kernel, destinationSize, out + row * outRowFloats);
+					continue;
+				}
+				const uint32_t y = row % outExtent.height, z = row / outExtent.height;
+				const uint32_t target = dimension == 1 ? y : z;
+				for (uint32_t t = 0; t < kernel.numTaps; ++t)
+				{
+					const uint32_t sourceY = dimension == 1 ? kernel.firstTap[target] + t : y;
+					const uint32_t sourceZ = dimension == 2 ? kernel.firstTap[target] + t : z;
+					rows[t] = in + (static_cast<size_t>(sourceZ) * extent.height + sourceY) * inRowFloats;
+				}
+				kernels.blendRows(rows.data(), &kernel.weights[target * kernel.numTaps], kernel.numTaps, static_cast<uint32_t>(outRowFloats), out + row * outRowFloats);
+			}
+		}, jobSystem);
+		input = &output;
+		extent = outExtent;
+		bufferIndex ^= 1;
+		packedSource = nullptr;
+	}
+}
+
+uint32_t getFullChainLength(const TextureHeader& header)
+{
+	uint32_t maxDimension = std::max(std::max(header.getWidth(), header.getHeight()), header.getDepth());
+	uint32_t numLevels = 1;
+	while (maxDimension > 1)
+	{
+		maxDimension >>= 1;
+		++numLevels;
+	}
+	return numLevels;
+}
+} // namespace
+
+bool isMipmapGenerationSupported(const TextureHeader& header)
+{
+	TexelFormat format;
+	return getTexelFormat(header, format);
+}
+
+void generateMipmaps(Texture& texture, const MipmapGenerationOptions& options)
+{
+	TexelFormat format;
+	if (!getTexelFormat(texture, format))
+	{ throw InvalidArgumentError("texture", "[generateMipmaps]: Unsupported texture format " + to_string(texture.getPixelFormat()) + " " + to_string(texture.getChannelType())); }
+	if (options.gammaCorrect && texture.getColorSpace() == ColorSpace::sRGB &&
+		(format.encoding == ChannelEncoding::UnsignedNorm8 || format.encoding == ChannelEncoding::UnsignedNorm16))
+	{
+		for (uint8_t channel = 0; channel < format.numChannels; ++channel) { format.isChannelGammaEncoded[channel] = texture.getPixelFormat().getChannelContent(channel) != 'a'; }
+	}
+
+	const uint32_t fullChainLength = getFullChainLength(texture);
+	const uint32_t numLevels = options.numMipMapLevels ? std::min(options.numMipMapLevels, fullChainLength) : fullChainLength;
+
+	// The new texture has the same header apart from the number of levels. Only the top level of the original is used.
+	TextureHeader header(texture);
+	header.setNumMipMapLevels(numLevels);
+	Texture result(header);
+	const Texture& source = texture;
+	const uint32_t numFaces = texture.getNumFaces();
+	const uint32_t numSurfaces = texture.getNumArrayMembers() * numFaces;
+	const size_t topLevelSize = texture.getDataSize(0, false, false);
+	for (uint32_t surface = 0; surface < numSurfaces; ++surface)
+	{ memcpy(result.getDataPointer(0, surface / numFaces, surface % numFaces), source.getDataPointer(0, surface / numFaces, surface % numFaces), topLevelSize); }
+
+	FilterKernels kernels = { &filterRow, &blendRows };
+#if defined(PVR_MIPMAP_SSE2) || defined(PVR_MIPMAP_NEON)
+	if (options.allowSimd)
+	{
+		kernels.filterRow = &filterRowSimd;
+		kernels.blendRows = &blendRowsSimd;
+	}
+#endif
+	impl::getSrgbTables(); // Built before any worker thread needs them
+
+	// Surfaces (array members and faces) are independent. Threads that are not needed to process every surface at once filter the rows of each level.
+	const Extent topExtent = { texture.getWidth(), texture.getHeight(), texture.getDepth() };
+	const uint32_t numThreads = impl::getDecompressionThreadCount(options.maxThreads, topExtent.width * topExtent.height * topExtent.depth * numSurfaces, MIN_TEXELS_PER_THREAD);
+	const uint32_t numSurfaceThreads = std::min(numThreads, numSurfaces);
+	const uint32_t numRowThreads = std::max(1u, numThreads / numSurfaceThreads);
+	impl::parallelForEachItem(numSurfaces, numSurfaceThreads, [&](uint32_t surface) {
+		const uint32_t arrayMember = surface / numFaces, face = surface % numFaces;
+		const uint8_t* topLevel = source.getDataPointer(0, arrayMember, face);
+		std::vector<float> level, nextLevel, scratch;
+		if (topExtent.width == 1)
+		{
+			level.resize(static_cast<size_t>(topExtent.height) * topExtent.depth * FLOATS_PER_TEXEL);
+			loadTexels(topLevel, static_cast<size_t>(topExtent.height) * topExtent.depth, format, level.data());
+			topLevel = nullptr;
+		}
+		Extent extent = topExtent;
+		for (uint32_t mipLevel = 1; mipLevel < numLevels; ++mipLevel)
+		{
+			const Extent nextExtent = { result.getWidth(mipLevel), result.getHeight(mipLevel), result.getDepth(mipLevel) };
+			reduceLevel(level, mipLevel == 1 ? topLevel : nullptr, format, extent, nextExtent, options.filter, kernels, numRowThreads, options.jobSystem, scratch, nextLevel);
+			storeTexels(nextLevel.data(), static_cast<size_t>(nextExtent.width) * nextExtent.height * nextExtent.depth, format,
+				result.getDataPointer(mipLevel, arrayMember, face));
+			level.swap(nextLevel);
+			extent = nextExtent;
+		}
+	}, options.jobSystem);
+	texture = std::move(result);
+}
+} // namespace pvr
+//!\endcond
@@ -0,0 +1,49 @@
+/*!
+\brief Contains functions to generate the MIP map chain of a texture on the CPU.
+\file PVRCore/texture/MipmapGenerator.h
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+#pragma once
+#include "PVRCore/texture/Texture.h"
+namespace pvr {
+namespace async {
+class JobSystem;
+}
+
+/// <summary>The filters that MIP map levels can be generated with.</summary>
+enum class MipmapFilter
+{
+	Box, ///< Averages the texels covered by each texel of the smaller level. Fast, but slightly blurry, and prone to aliasing.
+	Kaiser, ///< Kaiser windowed sinc. Sharper and with less aliasing than Box, at several times the cost.
+};
+
+/// <summary>Controls how generateMipmaps builds the MIP map chain.</summary>
+struct MipmapGenerationOptions
+{
+	MipmapFilter filter; ///< The filter used to reduce each level to the next one
+	uint32_t numMipMapLevels; ///< The number of MIP map levels of the result, including the top level. 0 generates the full chain down to 1x1x1.
+	bool gammaCorrect; ///< If true, sRGB textures are filtered in linear space (alpha is always linear). If false, the encoded values are filtered.
+	uint32_t maxThreads; ///< The maximum number of threads to use. 0 uses one thread per hardware thread, 1 generates on the calling thread.
+	bool allowSimd; ///< Set to false to force the scalar filter kernels, for example to validate the output of the vectorized ones.
+	async::JobSystem* jobSystem; ///< Optional. If not null, the work is spread over the workers of this job system instead of threads created for each level.
+
+	/// <summary>Constructor. Defaults to a gamma correct box filtered full chain, using all hardware threads, the SIMD kernels and no job system.</summary>
+	MipmapGenerationOptions() : filter(MipmapFilter::Box), numMipMapLevels(0), gammaCorrect(true), maxThreads(0), allowSimd(true), jobSystem(nullptr) {}
+};
+
+/// <summary>Query whether a texture is in a format that generateMipmaps supports: uncompressed formats of 1 to 4 channels of the same size, which are
+/// 8 or 16 bit normalized integers, or 16 or 32 bit floats.</summary>
+/// <param name="header">The header of the texture</param>
+/// <returns>True if generateMipmaps can generate the MIP map levels of the texture, otherwise false</returns>
+bool isMipmapGenerationSupported(const TextureHeader& header);
+
+/// <summary>Generate the MIP map levels of a texture from its top level, replacing any levels it already has. Each level is filtered from the previous
+/// one, separably in each dimension, with the edges clamped. Dimensions do not need to be powers of two: each level is half the size of the previous
+/// one, rounded down, and the filter footprint is adjusted to cover odd sizes exactly. Every array member, face and depth slice (3D textures are
+/// reduced in depth too) gets its own chain. Array members and faces are processed in parallel, and so are the rows of large levels.</summary>
+/// <param name="texture">The texture. Must be in a format supported by generateMipmaps (see isMipmapGenerationSupported), otherwise throws
+/// InvalidArgumentError. On return, it has options.numMipMapLevels levels (the full chain by default).</param>
+/// <param name="options">The filter, number of levels and threading options</param>
+void generateMipmaps(Texture& texture, const MipmapGenerationOptions& options = MipmapGenerationOptions());
+} // namespace pvr
@@ -13,10 +13,28 @@
 #include <algorithm>
 #include <cstring>
 #include "PVRTDecompress.h"
+#include "ParallelDecompress.h"
 #include <cassert>
 #include <vector>
 
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PVR_DECOMPRESS_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define PVR_DECOMPRESS_NEON 1
+#include <arm_neon.h>
+#endif
+
 namespace pvr {
+bool isSimdDecompressionSupported()
+{
+#if defined(PVR_DECOMPRESS_SSE2) || defined(PVR_DECOMPRESS_NEON)
+	return true;
+#else
+	return false;
+#endif
+}
+
 enum
 {
 	ETC_MIN_TEXWIDTH = 4,
@@ -422,6 +440,175 @@ static void pvrtcGetDecompressedPixels(const PVRTCWord& P, const PVRTCWord& Q, c
 	}
 }
 
+#if defined(PVR_DECOMPRESS_SSE2) || defined(PVR_DECOMPRESS_NEON)
+// Vectorized equivalents of interpolateColors and the modulation blend of pvrtcGetDecompressedPixels. Each Pixel128S is
+// handled as one 4x32 bit vector. All intermediate values are non-negative and at most 8 * 255, so the 16 bit multiplies
+// and the shifts below produce exactly the same results as the scalar divisions.
+#if defined(PVR_DECOMPRESS_SSE2)
+typedef __m128i Vec4i;
+static inline Vec4i vecLoad(const Pixel128S& p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(&p)); }
+static inline Vec4i vecSet(const Pixel32& p) { return _mm_setr_epi32(p.red, p.green, p.blue, p.alpha); }
+static inline void vecStore(Pixel128S& p, Vec4i v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(&p), v); }
+static inline Vec4i vecAdd(Vec4i a, Vec4i b) { return _mm_add_epi32(a, b); }
+static inline Vec4i vecSub(Vec4i a, Vec4i b) { return _mm_sub_epi32(a, b); }
+static inline Vec4i vecMulSmall(Vec4i a, Vec4i b) { return _mm_mullo_epi16(a, b); }
+template<int Shift>
+static inline Vec4i vecShl(Vec4i a)
+{
+	return _mm_slli_epi32(a, Shift);
+}
+template<int Shift>
+static inline Vec4i vecShr(Vec4i a)
+{
+	return _mm_srai_epi32(a, Shift);
+}
+static inline Vec4i vecSelectAlpha(Vec4i rgb, Vec4i alpha)
+{
+	const __m128i alphaMask = _mm_setr_epi32(0, 0, 0, -1);
+	return _mm_or_si128(_mm_andnot_si128(alphaMask, rgb), _mm_and_si128(alphaMask, alpha));
+}
+static inline Vec4i vecClearAlpha(Vec4i v) { return _mm_and_si128(v, _mm_setr_epi32(-1, -1, -1, 0)); }
+static inline Vec4i vecSplat(int32_t value) { return _mm_set1_epi32(value); }
+static inline Pixel32 vecToPixel32(Vec4i v)
+{
+	const __m128i packed = _mm_packus_epi16(_mm_packs_epi32(v, v), _mm_setzero_si128());
+	const uint32_t value = static_cast<uint32_t>(_mm_cvtsi128_si32(packed));
+	Pixel32 result;
+	memcpy(&result, &value, sizeof(result));
+	return result;
+}
+#else
+typedef int32x4_t Vec4i;
+static inline Vec4i vecLoad(const Pixel128S& p) { return vld1q_s32(&p.red); }
+static inline Vec4i vecSet(const Pixel32& p)
+{
+	const int32_t values[4] = { p.red, p.green, p.blue, p.alpha };
+	return vld1q_s32(values);
+}
+static inline void vecStore(Pixel128S& p, Vec4i v) { vst1q_s32(&p.red, v); }
+static inline Vec4i vecAdd(Vec4i a, Vec4i b) { return vaddq_s32(a, b); }
+static inline Vec4i vecSub(Vec4i a, Vec4i b) { return vsubq_s32(a, b); }
+static inline Vec4i vecMulSmall(Vec4i a, Vec4i b) { return vmulq_s32(a, b); }
+template<int Shift>
+static inline Vec4i vecShl(Vec4i a)
+{
+	return vshlq_n_s32(a, Shift);
+}
+template<int Shift>
+static inline Vec4i vecShr(Vec4i a)
+{
+	return vshrq_n_s32(a, Shift);
+}
+static inline Vec4i vecSelectAlpha(Vec4i rgb, Vec4i alpha)
+{
+	const uint32_t maskValues[4] = { 0, 0, 0, 0xffffffffu };
+	return vbslq_s32(vld1q_u32(maskValues), alpha, rgb);
+}
+static inline Vec4i vecClearAlpha(Vec4i v) { return vsetq_lane_s32(0, v, 3); }
+static inline Vec4i vecSplat(int32_t value) { return vdupq_n_s32(value); }
+static inline Pixel32 vecToPixel32(Vec4i v)
+{
+	const uint8x8_t packed = vqmovn_u16(vcombine_u16(vqmovun_s32(v), vdup_n_u16(0)));
+	Pixel32 result;
+	memcpy(&result, &packed, sizeof(result));
+	return result;
+}
+#endif
+
+static void interpolateColorsSimd(Pixel32 P, Pixel32 Q, Pixel32 R, Pixel32 S, Pixel128S* pPixel, uint8_t bpp)
+{
+	Vec4i hP = vecSet(P);
+	Vec4i hR = vecSet(R);
+	const Vec4i QminusP = vecSub(vecSet(Q), hP);
+	const Vec4i SminusR = vecSub(vecSet(S), hR);
+
+	if (bpp == 2)
+	{
+		const uint32_t wordWidth = 8;
+		const uint32_t wordHeight = 4;
+		hP = vecShl<3>(hP);
+		hR = vecShl<3>(hR);
+		for (uint32_t x = 0; x < wordWidth; x++)
+		{
+			Vec4i result = vecShl<2>(hP);
+			const Vec4i dY = vecSub(hR, hP);
+			for (uint32_t y = 0; y < wordHeight; y++)
+			{
+				const Vec4i rgb = vecAdd(vecShr<7>(result), vecShr<2>(result));
+				const Vec4i alpha = vecAdd(vecShr<5>(result), vecShr<1>(result));
+				vecStore(pPixel[y * wordWidth + x], vecSelectAlpha(rgb, alpha));
+				result = vecAdd(result, dY);
+			}
+			hP = vecAdd(hP, QminusP);
+			hR = vecAdd(hR, SminusR);
+		}
+	}
+	else
+	{
+		const uint32_t wordWidth = 4;
+		const uint32_t wordHeight = 4;
+		hP = vecShl<2>(hP);
+		hR = vecShl<2>(hR);
+		for (uint32_t y = 0; y < wordHeight; y++)
+		{
+			Vec4i result = vecShl<2>(hP);
+			const Vec4i dY = vecSub(hR, hP);
+			for (uint32_t x = 0; x < wordWidth; x++)
+			{
+				const Vec4i rgb = vecAdd(vecShr<6>(result), vecShr<1>(result));
+				const Vec4i alpha = vecAdd(vecShr<4>(result), result);
+				vecStore(pPixel[y * wordWidth + x], vecSelectAlpha(rgb, alpha));
+				result = vecAdd(result, dY);
+			}
+			hP = vecAdd(hP, QminusP);
+			hR = vecAdd(hR, SminusR);
+		}
+	}
+}
+
+static void pvrtcGetDecompressedPixelsSimd(const PVRTCWord& P, const PVRTCWord& Q, const PVRTCWord& R, const PVRTCWord& S, Pixel32* pColorData, uint8_t bpp)
+{
+	int32_t modulationValues[16][8];
+	int32_t modulationModes[16][8];
+	Pixel128S upscaledColorA[32];
+	Pixel128S upscaledColorB[32];
+
+	uint32_t wordWidth = 4;
+	uint32_t wordHeight = 4;
+	if (bpp == 2) { wordWidth = 8; }
+
+	unpackModulations(P, 0, 0, modulationValues, modulationModes, bpp);
+	unpackModulations(Q, wordWidth, 0, modulationValues, modulationModes, bpp);
+	unpackModulations(R, 0, wordHeight, modulationValues, modulationModes, bpp);
+	unpackModulations(S, wordWidth, wordHeight, modulationValues, modulationModes, bpp);
+
+	interpolateColorsSimd(getColorA(P.colorData), getColorA(Q.colorData), getColorA(R.colorData), getColorA(S.colorData), upscaledColorA, bpp);
+	interpolateColorsSimd(getColorB(P.colorData), getColorB(Q.colorData), getColorB(R.colorData), getColorB(S.colorData), upscaledColorB, bpp);
+
+	const Vec4i eight = vecSplat(8);
+	for (uint32_t y = 0; y < wordHeight; y++)
+	{
+		for (uint32_t x = 0; x < wordWidth; x++)
+		{
+			int32_t mod = getModulationValues(modulationValues, modulationModes, x + wordWidth / 2, y + wordHeight / 2, bpp);
+			const bool punchthroughAlpha = mod > 10;
+			if (punchthroughAlpha) { mod -= 10; }
+
+			const Vec4i modulation = vecSplat(mod);
+			Vec4i result = vecShr<3>(vecAdd(vecMulSmall(vecLoad(upscaledColorA[y * wordWidth + x]), vecSub(eight, modulation)),
+				vecMulSmall(vecLoad(upscaledColorB[y * wordWidth + x]), modulation)));
+			if (punchthroughAlpha) { result = vecClearAlpha(result); }
+
+			if (bpp == 2) { pColorData[y * wordWidth + x] = vecToPixel32(result); }
+			else
+			{
+				pColorData[y + x * wordHeight] = vecToPixel32(result);
+			}
+		}
+	}
+}
+#endif
+
 static uint32_t wrapWordIndex(uint32_t numWords, int word) { return ((word + numWords) % numWords); }
 
 static bool isPowerOf2(uint32_t input)
@@ -496,25 +683,22 @@ static void mapDecompressedData(Pixel32* pOutput, uint32_t width, const Pixel32*
 		}
 	}
 }
-static uint32_t pvrtcDecompress(uint8_t* pCompressedData, Pixel32* pDecompressedData, uint32_t width, uint32_t height, uint8_t bpp)
+typedef void (*PfnPvrtcGetDecompressedPixels)(const PVRTCWord& P, const PVRTCWord& Q, const PVRTCWord& R, const PVRTCWord& S, Pixel32* pColorData, uint8_t bpp);
+
+// Decompresses the words rows [firstWordY, lastWordY). Each word row writes a disjoint set of output rows, so bands of word rows can be decoded concurrently.
+static void pvrtcDecompressWordRows(const uint32_t* pWordMembers, Pixel32* pOutData, uint32_t width, int32_t i32NumXWords, int32_t i32NumYWords, int32_t firstWordY,
+	int32_t lastWordY, uint8_t bpp, PfnPvrtcGetDecompressedPixels getDecompressedPixels)
 {
 	uint32_t wordWidth = 4;
 	uint32_t wordHeight = 4;
 	if (bpp == 2) { wordWidth = 8; }
 
-	uint32_t* pWordMembers = (uint32_t*)pCompressedData;
-	Pixel32* pOutData = pDecompressedData;
-
-	// Calculate number of words
-	int i32NumXWords = static_cast<int>(width / wordWidth);
-	int i32NumYWords = static_cast<int>(height / wordHeight);
-
 	// Structs used for decompression
 	PVRTCWordIndices indices;
 	std::vector<Pixel32> pPixels(wordWidth * wordHeight * sizeof(Pixel32));
 
 	// For each row of words
-	for (int32_t wordY = -1; wordY < i32NumYWords - 1; wordY++)
+	for (int32_t wordY = firstWordY; wordY < lastWordY; wordY++)
 	{
 		// for each column of words
 		for (int32_t wordX = -1; wordX < i32NumXWords - 1; wordX++)
@@ -548,17 +732,47 @@ static uint32_t pvrtcDecompress(uint8_t* pCompressedData, Pixel32* pDecompressed
 			S.modulationData = static_cast<uint32_t>(pWordMembers[WordOffsets[3]]);
 
 			// assemble 4 words into struct to get decompressed pixels from
-			pvrtcGetDecompressedPixels(P, Q, R, S, pPixels.data(), bpp);
+			getDecompressedPixels(P, Q, R, S, pPixels.data(), bpp);
 			mapDecompressedData(pOutData, width, pPixels.data(), indices, bpp);
 
 		} // for each word
 	} // for each row of words
+}
+
+static uint32_t pvrtcDecompress(uint8_t* pCompressedData, Pixel32* pDecompressedData, uint32_t width, uint32_t height, uint8_t bpp, const DecompressionOptions& options)
+{
+	uint32_t wordWidth = 4;
+	uint32_t wordHeight = 4;
+	if (bpp == 2) { wordWidth = 8; }
+
+	const uint32_t* pWordMembers = (const uint32_t*)pCompressedData;
+
+	// Calculate number of words
+	int i32NumXWords = static_cast<int>(width / wordWidth);
+	int i32NumYWords = static_cast<int>(height / wordHeight);
+
+	PfnPvrtcGetDecompressedPixels getDecompressedPixels = &pvrtcGetDecompressedPixels;
+#if defined(PVR_DECOMPRESS_SSE2) || defined(PVR_DECOMPRESS_NEON)
+	if (options.allowSimd) { getDecompressedPixels = &pvrtcGetDecompressedPixelsSimd; }
+#endif
+
+	// Word rows are iterated from -1 (wrapping to the last row) to numYWords - 1. Small images are not worth a thread.
+	const uint32_t minWordRowsPerThread = std::max(1u, 4096u / static_cast<uint32_t>(i32NumXWords));
+	const uint32_t numThreads = impl::getDecompressionThreadCount(options.maxThreads, static_cast<uint32_t>(i32NumYWords), minWordRowsPerThread);
+	impl::parallelForBands(-1, i32NumYWords - 1, numThreads, [&](int32_t firstWordY, int32_t lastWordY) {
+		pvrtcDecompressWordRows(pWordMembers, pDecompressedData, width, i32NumXWords, i32NumYWords, firstWordY, lastWordY, bpp, getDecompressedPixels);
+	}, options.jobSystem);
 
 	// Return the data size
 	return width * height / static_cast<uint32_t>((wordWidth / 2));
 }
 
 uint32_t PVRTDecompressPVRTC(const void* pCompressedData, uint32_t Do2bitMode, uint32_t XDim, uint32_t YDim, uint8_t* pResultImage)
+{
+	return PVRTDecompressPVRTC(pCompressedData, Do2bitMode, XDim, YDim, pResultImage, DecompressionOptions());
+}
+
+uint32_t PVRTDecompressPVRTC(const void* pCompressedData, uint32_t Do2bitMode, uint32_t XDim, uint32_t YDim, uint8_t* pResultImage, const DecompressionOptions& options)
 {
 	// Cast the output buffer to a Pixel32 pointer.
 	Pixel32* pDecompressedData = (Pixel32*)pResultImage;
@@ -571,7 +785,7 @@ uint32_t PVRTDecompressPVRTC(const void* pCompressedData, uint32_t Do2bitMode, u
 	if (XTrueDim != XDim || YTrueDim != YDim) { pDecompressedData = new Pixel32[XTrueDim * YTrueDim]; }
 
 	// Decompress the surface.
-	uint32_t retval = pvrtcDecompress((uint8_t*)pCompressedData, pDecompressedData, XTrueDim, YTrueDim, uint8_t(Do2bitMode == 1 ? 2 : 4));
+	uint32_t retval = pvrtcDecompress((uint8_t*)pCompressedData, pDecompressedData, XTrueDim, YTrueDim, uint8_t(Do2bitMode == 1 ? 2 : 4), options);
 
 	// If the dimensions were too small, then copy the new buffer back into the output buffer.
 	if (XTrueDim != XDim || YTrueDim != YDim)
@@ -592,166 +806,392 @@ uint32_t PVRTDecompressPVRTC(const void* pCompressedData, uint32_t Do2bitMode, u
 
 #define _CLAMP_(X, Xmin, Xmax) ((X) < (Xmax) ? ((X) < (Xmin) ? (Xmin) : (X)) : (Xmax))
 
-uint32_t ETC_FLIP = 0x01000000;
-uint32_t ETC_DIFF = 0x02000000;
 const int mod[8][4] = { { 2, 8, -2, -8 }, { 5, 17, -5, -17 }, { 9, 29, -9, -29 }, { 13, 42, -13, -42 }, { 18, 60, -18, -60 }, { 24, 80, -24, -80 }, { 33, 106, -33, -106 },
 	{ 47, 183, -47, -183 } };
 
-static uint32_t modifyPixel(int red, int green, int blue, int x, int y, uint32_t modBlock, int modTable)
+// Distances used by the ETC2 'T' and 'H' modes.
+const int etc2Distance[8] = { 3, 6, 11, 16, 23, 32, 41, 64 };
+
+// Modifier tables used by EAC (the alpha channel of ETC2 RGBA, and R11/RG11).
+const int eacModifiers[16][8] = { { -3, -6, -9, -15, 2, 5, 8, 14 }, { -3, -7, -10, -13, 2, 6, 9, 12 }, { -2, -5, -8, -13, 1, 4, 7, 12 }, { -2, -4, -6, -13, 1, 3, 5, 12 },
+	{ -3, -6, -8, -12, 2, 5, 7, 11 }, { -3, -7, -9, -11, 2, 6, 8, 10 }, { -4, -7, -8, -11, 3, 6, 7, 10 }, { -3, -5, -8, -11, 2, 4, 7, 10 }, { -2, -6, -8, -10, 1, 5, 7, 9 },
+	{ -2, -5, -8, -10, 1, 4, 7, 9 }, { -2, -4, -8, -10, 1, 3, 7, 9 }, { -2, -5, -7, -10, 1, 4, 6, 9 }, { -3, -4, -7, -10, 2, 3, 6, 9 }, { -1, -2, -3, -10, 0, 1, 2, 9 },
+	{ -4, -6, -8, -9, 3, 5, 7, 8 }, { -3, -5, -7, -9, 2, 4, 6, 8 } };
+
+// The layout of a block of any of the ETC formats.
+enum class EtcBlockType
 {
-	int index = x * 4 + y, pixelMod;
-	uint32_t mostSig = modBlock << 1;
+	ETC1, // 64 bit colour block, 'individual' and 'differential' modes only
+	ETC2_RGB, // 64 bit colour block with the additional 'T', 'H' and 'planar' modes
+	ETC2_RGB_A1, // 64 bit colour block with punch-through alpha
+	ETC2_RGBA, // 64 bit EAC alpha block followed by a 64 bit ETC2 colour block
+	EAC_R11, // 64 bit EAC block
+	EAC_RG11, // Two 64 bit EAC blocks
+};
 
-	if (index < 8) { pixelMod = mod[modTable][((modBlock >> (index + 24)) & 0x1) + ((mostSig >> (index + 8)) & 0x2)]; }
-	else
-	{
-		pixelMod = mod[modTable][((modBlock >> (index + 8)) & 0x1) + ((mostSig >> (index - 8)) & 0x2)];
-	}
+static inline uint32_t readBigEndian32(const uint8_t* data)
+{
+	return (static_cast<uint32_t>(data[0]) << 24) | (static_cast<uint32_t>(data[1]) << 16) | (static_cast<uint32_t>(data[2]) << 8) | static_cast<uint32_t>(data[3]);
+}
 
-	red = _CLAMP_(red + pixelMod, 0, 255);
-	green = _CLAMP_(green + pixelMod, 0, 255);
-	blue = _CLAMP_(blue + pixelMod, 0, 255);
+static inline uint8_t extend4To8(uint32_t value) { return static_cast<uint8_t>((value << 4) | value); }
+static inline uint8_t extend5To8(uint32_t value) { return static_cast<uint8_t>((value << 3) | (value >> 2)); }
+static inline uint8_t extend6To8(uint32_t value) { return static_cast<uint8_t>((value << 2) | (value >> 4)); }
+static inline uint8_t extend7To8(uint32_t value) { return static_cast<uint8_t>((value << 1) | (value >> 6)); }
+static inline uint8_t clamp255(int value) { return static_cast<uint8_t>(_CLAMP_(value, 0, 255)); }
 
-	return ((red << 16) + (green << 8) + blue) | 0xff000000;
+static inline Pixel32 makePixel32(int red, int green, int blue, int alpha)
+{
+	Pixel32 pixel = { clamp255(red), clamp255(green), clamp255(blue), clamp255(alpha) };
+	return pixel;
 }
 
-static uint32_t ETCTextureDecompress(const void* pSrcData, uint32_t x, uint32_t y, void* pDestData, uint32_t /*nMode*/)
+// Adds a per pixel luminance modifier to the red, green and blue channels of 16 pixels, saturating to [0..255].
+typedef void (*PfnApplyEtcModifiers)(const Pixel32* baseColors, const int32_t* modifiers, Pixel32* outPixels);
+
+static void applyEtcModifiers(const Pixel32* baseColors, const int32_t* modifiers, Pixel32* outPixels)
 {
-	uint32_t* output;
-	uint32_t blockTop, blockBot;
-	const uint32_t* input = static_cast<const uint32_t*>(pSrcData);
-	unsigned char red1, green1, blue1, red2, green2, blue2;
-	bool bFlip, bDiff;
-	int modtable1, modtable2;
+	for (uint32_t i = 0; i < 16; ++i)
+	{
+		outPixels[i] = makePixel32(baseColors[i].red + modifiers[i], baseColors[i].green + modifiers[i], baseColors[i].blue + modifiers[i], baseColors[i].alpha);
+	}
+}
 
-	for (uint32_t i = 0; i < y; i += 4)
+#if defined(PVR_DECOMPRESS_SSE2)
+static void applyEtcModifiersSimd(const Pixel32* baseColors, const int32_t* modifiers, Pixel32* outPixels)
+{
+	const __m128i zero = _mm_setzero_si128();
+	for (uint32_t i = 0; i < 16; i += 4)
 	{
-		for (uint32_t m = 0; m < x; m += 4)
-		{
-			blockTop = *(input++);
-			blockBot = *(input++);
+		// Widen 4 pixels to 16 bit lanes, add the modifiers to the colour lanes and saturate back to 8 bits.
+		const __m128i base = _mm_loadu_si128(reinterpret_cast<const __m128i*>(baseColors + i));
+		const __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(base, zero),
+			_mm_setr_epi16(static_cast<int16_t>(modifiers[i]), static_cast<int16_t>(modifiers[i]), static_cast<int16_t>(modifiers[i]), 0,
+				static_cast<int16_t>(modifiers[i + 1]), static_cast<int16_t>(modifiers[i + 1]), static_cast<int16_t>(modifiers[i + 1]), 0));
+		const __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(base, zero),
+			_mm_setr_epi16(static_cast<int16_t>(modifiers[i + 2]), static_cast<int16_t>(modifiers[i + 2]), static_cast<int16_t>(modifiers[i + 2]), 0,
+				static_cast<int16_t>(modifiers[i + 3]), static_cast<int16_t>(modifiers[i + 3]), static_cast<int16_t>(modifiers[i + 3]), 0));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(outPixels + i), _mm_packus_epi16(lo, hi));
+	}
+}
+#elif defined(PVR_DECOMPRESS_NEON)
+static void applyEtcModifiersSimd(const Pixel32* baseColors, const int32_t* modifiers, Pixel32* outPixels)
+{
+	for (uint32_t i = 0; i < 16; i += 2)
+	{
+		// Widen 2 pixels to 16 bit lanes, add the modifiers to the colour lanes and saturate back to 8 bits.
+		const uint8x8_t base = vld1_u8(reinterpret_cast<const uint8_t*>(baseColors + i));
+		const int16_t modifierValues[8] = { static_cast<int16_t>(modifiers[i]), static_cast<int16_t>(modifiers[i]), static_cast<int16_t>(modifiers[i]), 0,
+			static_cast<int16_t>(modifiers[i + 1]), static_cast<int16_t>(modifiers[i + 1]), static_cast<int16_t>(modifiers[i + 1]), 0 };
+		const int16x8_t sum = vaddq_s16(vreinterpretq_s16_u16(vmovl_u8(base)), vld1q_s16(modifierValues));
+		vst1_u8(reinterpret_cast<uint8_t*>(outPixels + i), vqmovun_s16(sum));
+	}
+}
+#endif
 
-			output = (uint32_t*)pDestData + i * x + m;
+// Decodes an ETC1 or ETC2 colour block into 16 pixels, in row-major order.
+static void decodeEtcColorBlock(const uint8_t* block, EtcBlockType type, Pixel32* outPixels, PfnApplyEtcModifiers applyModifiers)
+{
+	const uint32_t blockTop = readBigEndian32(block);
+	const uint32_t blockBot = readBigEndian32(block + 4);
+	const bool isEtc2 = type != EtcBlockType::ETC1;
+	const bool punchthrough = type == EtcBlockType::ETC2_RGB_A1;
+	// With punch-through alpha the 'differential' bit is reused as the 'opaque' bit, and the block is always differential.
+	const bool bDiff = punchthrough || (blockTop & 0x2) != 0;
+	const bool bOpaque = !punchthrough || (blockTop & 0x2) != 0;
+	const bool bFlip = (blockTop & 0x1) != 0;
+
+	// The 2 bit index of each pixel. The bits are stored column-major.
+	uint32_t pixelIndices[16];
+	for (uint32_t y = 0; y < 4; ++y)
+	{
+		for (uint32_t x = 0; x < 4; ++x)
+		{
+			const uint32_t bit = x * 4 + y;
+			pixelIndices[y * 4 + x] = (((blockBot >> (bit + 16)) & 0x1) << 1) | ((blockBot >> bit) & 0x1);
+		}
+	}
 
-			// check flipbit
-			bFlip = (blockTop & ETC_FLIP) != 0;
-			bDiff = (blockTop & ETC_DIFF) != 0;
+	Pixel32 colors1, colors2;
+	if (bDiff)
+	{
+		const int red = static_cast<int>((blockTop >> 27) & 0x1f), green = static_cast<int>((blockTop >> 19) & 0x1f), blue = static_cast<int>((blockTop >> 11) & 0x1f);
+		// Sign extend the 3 bit deltas.
+		const int dRed = static_cast<int>((blockTop >> 24) & 0x7) - static_cast<int>((blockTop >> 24) & 0x4) * 2;
+		const int dGreen = static_cast<int>((blockTop >> 16) & 0x7) - static_cast<int>((blockTop >> 16) & 0x4) * 2;
+		const int dBlue = static_cast<int>((blockTop >> 8) & 0x7) - static_cast<int>((blockTop >> 8) & 0x4) * 2;
 
-			if (bDiff)
+		if (isEtc2 && (red + dRed < 0 || red + dRed > 31))
+		{
+			// 'T' mode
+			const uint32_t r1 = (((blockTop >> 27) & 0x3) << 2) | ((blockTop >> 24) & 0x3);
+			Pixel32 paint[4];
+			paint[0] = makePixel32(extend4To8(r1), extend4To8((blockTop >> 20) & 0xf), extend4To8((blockTop >> 16) & 0xf), 255);
+			const int distance = etc2Distance[(((blockTop >> 2) & 0x3) << 1) | (blockTop & 0x1)];
+			const int r2 = extend4To8((blockTop >> 12) & 0xf), g2 = extend4To8((blockTop >> 8) & 0xf), b2 = extend4To8((blockTop >> 4) & 0xf);
+			paint[1] = makePixel32(r2 + distance, g2 + distance, b2 + distance, 255);
+			paint[2] = makePixel32(r2, g2, b2, 255);
+			paint[3] = makePixel32(r2 - distance, g2 - distance, b2 - distance, 255);
+			if (!bOpaque) { paint[2] = makePixel32(0, 0, 0, 0); }
+			for (uint32_t i = 0; i < 16; ++i) { outPixels[i] = paint[pixelIndices[i]]; }
+			return;
+		}
+		if (isEtc2 && (green + dGreen < 0 || green + dGreen > 31))
+		{
+			// 'H' mode
+			const uint32_t r1 = (blockTop >> 27) & 0xf;
+			const uint32_t g1 = (((blockTop >> 24) & 0x7) << 1) | ((blockTop >> 20) & 0x1);
+			const uint32_t b1 = (((blockTop >> 19) & 0x1) << 3) | ((blockTop >> 15) & 0x7);
+			const uint32_t r2 = (blockTop >> 11) & 0xf, g2 = (blockTop >> 7) & 0xf, b2 = (blockTop >> 3) & 0xf;
+			const uint32_t distanceIndex = (((blockTop >> 2) & 0x1) << 2) | ((blockTop & 0x1) << 1) | (((r1 << 8) | (g1 << 4) | b1) >= ((r2 << 8) | (g2 << 4) | b2) ? 1 : 0);
+			const int distance = etc2Distance[distanceIndex];
+			Pixel32 paint[4];
+			paint[0] = makePixel32(extend4To8(r1) + distance, extend4To8(g1) + distance, extend4To8(b1) + distance, 255);
+			paint[1] = makePixel32(extend4To8(r1) - distance, extend4To8(g1) - distance, extend4To8(b1) - distance, 255);
+			paint[2] = makePixel32(extend4To8(r2) + distance, extend4To8(g2) + distance, extend4To8(b2) + distance, 255);
+			paint[3] = makePixel32(extend4To8(r2) - distance, extend4To8(g2) - distance, extend4To8(b2) - distance, 255);
+			if (!bOpaque) { paint[2] = makePixel32(0, 0, 0, 0); }
+			for (uint32_t i = 0; i < 16; ++i) { outPixels[i] = paint[pixelIndices[i]]; }
+			return;
+		}
+		if (isEtc2 && (blue + dBlue < 0 || blue + dBlue > 31))
+		{
+			// 'Planar' mode. Always opaque.
+			const int ro = extend6To8((blockTop >> 25) & 0x3f);
+			const int go = extend7To8((((blockTop >> 24) & 0x1) << 6) | ((blockTop >> 17) & 0x3f));
+			const int bo = extend6To8((((blockTop >> 16) & 0x1) << 5) | (((blockTop >> 11) & 0x3) << 3) | ((blockTop >> 7) & 0x7));
+			const int rh = extend6To8((((blockTop >> 2) & 0x1f) << 1) | (blockTop & 0x1));
+			const int gh = extend7To8((blockBot >> 25) & 0x7f);
+			const int bh = extend6To8((blockBot >> 19) & 0x3f);
+			const int rv = extend6To8((blockBot >> 13) & 0x3f);
+			const int gv = extend7To8((blockBot >> 6) & 0x7f);
+			const int bv = extend6To8(blockBot & 0x3f);
+			for (int y = 0; y < 4; ++y)
 			{
-				// differential mode 5 color bits + 3 difference bits
-				// get base color for subblock 1
-				blue1 = static_cast<unsigned char>((blockTop & 0xf80000) >> 16u);
-				green1 = static_cast<unsigned char>((blockTop & 0xf800) >> 8u);
-				red1 = static_cast<unsigned char>(blockTop & 0xf8);
-
-				// get differential color for subblock 2
-				signed char blues = static_cast<signed char>(blue1 >> 3) + (static_cast<signed char>((blockTop & 0x70000) >> 11) >> 5);
-				signed char greens = static_cast<signed char>(green1 >> 3) + (static_cast<signed char>((blockTop & 0x700) >> 3) >> 5);
-				signed char reds = static_cast<signed char>(red1 >> 3) + (static_cast<signed char>((blockTop & 0x7) << 5) >> 5);
-
-				blue2 = static_cast<unsigned char>(blues);
-				green2 = static_cast<unsigned char>(greens);
-				red2 = static_cast<unsigned char>(reds);
-
-				red1 = static_cast<unsigned char>(red1 + (red1 >> 5u)); // copy bits to lower sig
-				green1 = static_cast<unsigned char>(green1 + (green1 >> 5u)); // copy bits to lower sig
-				blue1 = static_cast<unsigned char>(blue1 + (blue1 >> 5u)); // copy bits to lower sig
-
-				red2 = static_cast<unsigned char>((red2 << 3u) + (red2 >> 2u)); // copy bits to lower sig
-				green2 = static_cast<unsigned char>((green2 << 3u) + (green2 >> 2u)); // copy bits to lower sig
-				blue2 = static_cast<unsigned char>((blue2 << 3u) + (blue2 >> 2u)); // copy bits to lower sig
+				for (int x = 0; x < 4; ++x)
+				{
+					outPixels[y * 4 + x] = makePixel32((x * (rh - ro) + y * (rv - ro) + 4 * ro + 2) >> 2, (x * (gh - go) + y * (gv - go) + 4 * go + 2) >> 2,
+						(x * (bh - bo) + y * (bv - bo) + 4 * bo + 2) >> 2, 255);
+				}
 			}
-			else
+			return;
+		}
+
+		// Differential mode: 5 colour bits + 3 difference bits. Plain ETC1 has no overflow modes, the values just wrap.
+		colors1 = makePixel32(extend5To8(static_cast<uint32_t>(red)), extend5To8(static_cast<uint32_t>(green)), extend5To8(static_cast<uint32_t>(blue)), 255);
+		const uint8_t red2 = static_cast<uint8_t>(red + dRed), green2 = static_cast<uint8_t>(green + dGreen), blue2 = static_cast<uint8_t>(blue + dBlue);
+		colors2.red = static_cast<uint8_t>((red2 << 3) + (red2 >> 2));
+		colors2.green = static_cast<uint8_t>((green2 << 3) + (green2 >> 2));
+		colors2.blue = static_cast<uint8_t>((blue2 << 3) + (blue2 >> 2));
+		colors2.alpha = 255;
+	}
+	else
+	{
+		// Individual mode: 4 + 4 colour bits.
+		colors1 = makePixel32(extend4To8((blockTop >> 28) & 0xf), extend4To8((blockTop >> 20) & 0xf), extend4To8((blockTop >> 12) & 0xf), 255);
+		colors2 = makePixel32(extend4To8((blockTop >> 24) & 0xf), extend4To8((blockTop >> 16) & 0xf), extend4To8((blockTop >> 8) & 0xf), 255);
+	}
+
+	// Get the modtables for each subblock and work out the colour of each pixel before modification.
+	const int* modTable1 = mod[(blockTop >> 5) & 0x7];
+	const int* modTable2 = mod[(blockTop >> 2) & 0x7];
+	Pixel32 baseColors[16];
+	int32_t modifiers[16];
+	for (uint32_t y = 0; y < 4; ++y)
+	{
+		for (uint32_t x = 0; x < 4; ++x)
+		{
+			// Not flipped: 2 2x4 blocks side by side. Flipped: 2 4x2 blocks on top of each other.
+			const bool isSecondSubBlock = bFlip ? (y >= 2) : (x >= 2);
+			const uint32_t index = pixelIndices[y * 4 + x];
+			baseColors[y * 4 + x] = isSecondSubBlock ? colors2 : colors1;
+			modifiers[y * 4 + x] = (isSecondSubBlock ? modTable2 : modTable1)[index];
+			if (!bOpaque)
 			{
-				// individual mode 4 + 4 color bits
-				// get base color for subblock 1
-				blue1 = static_cast<unsigned char>((blockTop & 0xf00000) >> 16);
-				blue1 = static_cast<unsigned char>(blue1 + (blue1 >> 4)); // copy bits to lower sig
-				green1 = static_cast<unsigned char>((blockTop & 0xf000) >> 8);
-				green1 = static_cast<unsigned char>(green1 + (green1 >> 4)); // copy bits to lower sig
-				red1 = static_cast<unsigned char>(blockTop & 0xf0);
-				red1 = static_cast<unsigned char>(red1 + (red1 >> 4)); // copy bits to lower sig
-
-				// get base color for subblock 2
-				blue2 = static_cast<unsigned char>((blockTop & 0xf0000) >> 12);
-				blue2 = static_cast<unsigned char>(blue2 + (blue2 >> 4)); // copy bits to lower sig
-				green2 = static_cast<unsigned char>((blockTop & 0xf00) >> 4);
-				green2 = static_cast<unsigned char>(green2 + (green2 >> 4)); // copy bits to lower sig
-				red2 = static_cast<unsigned char>((blockTop & 0xf) << 4);
-				red2 = static_cast<unsigned char>(red2 + (red2 >> 4)); // copy bits to lower sig
+				// Punch-through: index 2 is fully transparent, and index 0 is not modified.
+				if (index == 2) { baseColors[y * 4 + x] = makePixel32(0, 0, 0, 0); }
+				if ((index & 0x1) == 0) { modifiers[y * 4 + x] = 0; }
 			}
-			// get the modtables for each subblock
-			modtable1 = static_cast<int>((blockTop >> 29) & 0x7);
-			modtable2 = static_cast<int>((blockTop >> 26) & 0x7);
+		}
+	}
+	applyModifiers(baseColors, modifiers, outPixels);
+}
 
-			if (!bFlip)
-			{
-				// 2 2x4 blocks side by side
+// Decodes a 64 bit EAC block into 16 values, in row-major order. Unsigned results are in [0..2047], signed results in [-1023..1023].
+static void decodeEacBlock(const uint8_t* block, bool isSigned, bool isEightBitAlpha, int32_t* outValues)
+{
+	const int multiplier = block[1] >> 4;
+	const int* modifierTable = eacModifiers[block[1] & 0xf];
+	const uint64_t indices = (static_cast<uint64_t>(readBigEndian32(block)) << 32) | readBigEndian32(block + 4);
 
-				for (uint8_t j = 0; j < 4; j++) // vertical
-				{
-					for (uint8_t k = 0; k < 2; k++) // horizontal
-					{
-						*(output + j * x + k) = modifyPixel(red1, green1, blue1, k, j, blockBot, modtable1);
-						*(output + j * x + k + 2) = modifyPixel(red2, green2, blue2, k + 2, j, blockBot, modtable2);
-					}
-				}
+	int base;
+	if (isEightBitAlpha) { base = block[0]; }
+	else if (isSigned)
+	{
+		base = static_cast<int8_t>(block[0]);
+		if (base == -128) { base = -127; }
+	}
+	else
+	{
+		base = block[0];
+	}
+
+	for (uint32_t y = 0; y < 4; ++y)
+	{
+		for (uint32_t x = 0; x < 4; ++x)
+		{
+			// The 3 bit indices are stored column-major, most significant first.
+			const uint32_t pixel = x * 4 + y;
+			const int modifier = modifierTable[(indices >> (45 - 3 * pixel)) & 0x7];
+			int value;
+			if (isEightBitAlpha) { value = _CLAMP_(base + modifier * multiplier, 0, 255); }
+			else if (isSigned)
+			{
+				value = base * 8 + (multiplier ? modifier * multiplier * 8 : modifier);
+				value = _CLAMP_(value, -1023, 1023);
 			}
 			else
 			{
-				// 2 4x2 blocks on top of each other
-				for (uint8_t j = 0; j < 2; j++)
-				{
-					for (uint8_t k = 0; k < 4; k++)
-					{
-						*(output + j * x + k) = modifyPixel(red1, green1, blue1, k, j, blockBot, modtable1);
-						*(output + (j + 2) * x + k) = modifyPixel(red2, green2, blue2, k, j + 2, blockBot, modtable2);
-					}
-				}
+				value = base * 8 + 4 + (multiplier ? modifier * multiplier * 8 : modifier);
+				value = _CLAMP_(value, 0, 2047);
 			}
+			outValues[y * 4 + x] = value;
 		}
 	}
-
-	return x * y / 2;
 }
 
-uint32_t PVRTDecompressETC(const void* pSrcData, uint32_t x, uint32_t y, void* pDestData, uint32_t nMode)
+// Converts an 11 bit EAC value to 8 bits. Signed values are returned as two's complement SNORM8.
+static inline uint8_t eacTo8Bit(int32_t value, bool isSigned)
 {
-	uint32_t i32read;
+	if (isSigned) { return static_cast<uint8_t>(static_cast<int8_t>((value * 127 + (value < 0 ? -511 : 511)) / 1023)); }
+	return static_cast<uint8_t>(value >> 3);
+}
 
-	if (x < ETC_MIN_TEXWIDTH || y < ETC_MIN_TEXHEIGHT)
+static void decodeEtcBlock(const uint8_t* block, EtcBlockType type, bool isSigned, Pixel32* outPixels, PfnApplyEtcModifiers applyModifiers)
+{
+	int32_t values[16];
+	switch (type)
+	{
+	case EtcBlockType::ETC1:
+	case EtcBlockType::ETC2_RGB:
+	case EtcBlockType::ETC2_RGB_A1: decodeEtcColorBlock(block, type, outPixels, applyModifiers); break;
+	case EtcBlockType::ETC2_RGBA:
+		decodeEtcColorBlock(block + 8, type, outPixels, applyModifiers);
+		decodeEacBlock(block, false, true, values);
+		for (uint32_t i = 0; i < 16; ++i) { outPixels[i].alpha = static_cast<uint8_t>(values[i]); }
+		break;
+	case EtcBlockType::EAC_R11:
+	case EtcBlockType::EAC_RG11:
 	{
-		// decompress into a buffer big enough to take the minimum size
-		char* pTempBuffer = new char[std::max<uint32_t>(x, ETC_MIN_TEXWIDTH) * std::max<uint32_t>(y, ETC_MIN_TEXHEIGHT) * 4];
-		i32read = ETCTextureDecompress(pSrcData, std::max<uint32_t>(x, ETC_MIN_TEXWIDTH), std::max<uint32_t>(y, ETC_MIN_TEXHEIGHT), pTempBuffer, nMode);
+		// Missing channels are zero, and alpha is one (0xff for UNORM, 0x7f for SNORM).
+		const uint8_t one = isSigned ? 0x7f : 0xff;
+		decodeEacBlock(block, isSigned, false, values);
+		for (uint32_t i = 0; i < 16; ++i)
+		{
+			outPixels[i].red = eacTo8Bit(values[i], isSigned);
+			outPixels[i].green = 0;
+			outPixels[i].blue = 0;
+			outPixels[i].alpha = one;
+		}
+		if (type == EtcBlockType::EAC_RG11)
+		{
+			decodeEacBlock(block + 8, isSigned, false, values);
+			for (uint32_t i = 0; i < 16; ++i) { outPixels[i].green = eacTo8Bit(values[i], isSigned); }
+		}
+		break;
+	}
+	}
+}
 
-		for (uint32_t i = 0; i < y; i++)
+static uint32_t ETCTextureDecompress(const void* pSrcData, uint32_t x, uint32_t y, void* pDestData, EtcBlockType type, bool isSigned, const DecompressionOptions& options)
+{
+	const uint32_t blockSize = (type == EtcBlockType::ETC2_RGBA || type == EtcBlockType::EAC_RG11) ? 16 : 8;
+	const uint32_t numBlocksX = (x + ETC_MIN_TEXWIDTH - 1) / ETC_MIN_TEXWIDTH;
+	const uint32_t numBlocksY = (y + ETC_MIN_TEXHEIGHT - 1) / ETC_MIN_TEXHEIGHT;
+	const uint8_t* input = static_cast<const uint8_t*>(pSrcData);
+	Pixel32* output = static_cast<Pixel32*>(pDestData);
+
+	PfnApplyEtcModifiers applyModifiers = &applyEtcModifiers;
+#if defined(PVR_DECOMPRESS_SSE2) || defined(PVR_DECOMPRESS_NEON)
+	if (options.allowSimd) { applyModifiers = &applyEtcModifiersSimd; }
+#endif
+
+	// Every row of blocks is independent. Partial blocks at the right and bottom edges are clipped. Each thread is given at least a hundred microseconds
+	// or so of work, as small images are not worth a thread.
+	const uint32_t numThreads = impl::getDecompressionThreadCount(options.maxThreads, numBlocksY, std::max(1u, 2048u / numBlocksX));
+	impl::parallelForBands(0, static_cast<int32_t>(numBlocksY), numThreads, [&](int32_t firstBlockY, int32_t lastBlockY) {
+		Pixel32 pixels[16];
+		for (uint32_t blockY = static_cast<uint32_t>(firstBlockY); blockY < static_cast<uint32_t>(lastBlockY); ++blockY)
 		{
-			// copy from larger temp buffer to output data
-			memcpy(static_cast<char*>(pDestData) + i * x * 4, pTempBuffer + std::max<uint32_t>(x, ETC_MIN_TEXWIDTH) * 4 * i, x * 4);
+			for (uint32_t blockX = 0; blockX < numBlocksX; ++blockX)
+			{
+				decodeEtcBlock(input + (blockY * numBlocksX + blockX) * blockSize, type, isSigned, pixels, applyModifiers);
+
+				const uint32_t numColumns = std::min(4u, x - blockX * 4);
+				const uint32_t numRows = std::min(4u, y - blockY * 4);
+				for (uint32_t row = 0; row < numRows; ++row) { memcpy(output + (blockY * 4 + row) * x + blockX * 4, pixels + row * 4, numColumns * sizeof(Pixel32)); }
+			}
 		}
+	}, options.jobSystem);
 
-		delete[] pTempBuffer;
-	}
-	else // decompress larger MIP levels straight into the output data
+	return numBlocksX * numBlocksY * blockSize;
+}
+
+uint32_t PVRTDecompressETC(const void* pSrcData, uint32_t x, uint32_t y, void* pDestData, uint32_t /*nMode*/)
+{
+	return PVRTDecompressETC(pSrcData, x, y, pDestData, CompressedPixelFormat::ETC1, false, DecompressionOptions());
+}
+
+uint32_t PVRTDecompressETC(const void* srcData, uint32_t xDim, uint32_t yDim, void* dstData, CompressedPixelFormat format, bool isSigned, const DecompressionOptions& options)
+{
+	EtcBlockType type;
+	switch (format)
 	{
-		i32read = ETCTextureDecompress(pSrcData, x, y, pDestData, nMode);
+	case CompressedPixelFormat::ETC1: type = EtcBlockType::ETC1; break;
+	case CompressedPixelFormat::ETC2_RGB: type = EtcBlockType::ETC2_RGB; break;
+	case CompressedPixelFormat::ETC2_RGB_A1: type = EtcBlockType::ETC2_RGB_A1; break;
+	case CompressedPixelFormat::ETC2_RGBA: type = EtcBlockType::ETC2_RGBA; break;
+	case CompressedPixelFormat::EAC_R11: type = EtcBlockType::EAC_R11; break;
+	case CompressedPixelFormat::EAC_RG11: type = EtcBlockType::EAC_RG11; break;
+	default: return 0;
 	}
+	return ETCTextureDecompress(srcData, xDim, yDim, dstData, type, isSigned, options);
+}
 
-	// swap r and b channels
-	unsigned char *pSwap = static_cast<unsigned char*>(pDestData), swap;
-
-	for (uint32_t i = 0; i < y; i++)
-		for (uint32_t j = 0; j < x; j++)
+Texture decompressEtcTexture(const Texture& texture, const DecompressionOptions& options)
+{
+	const CompressedPixelFormat format = static_cast<CompressedPixelFormat>(texture.getPixelFormat().getPixelTypeId());
+	if (texture.getPixelFormat().getPart().High != 0 ||
+		(format != CompressedPixelFormat::ETC1 && format != CompressedPixelFormat::ETC2_RGB && format != CompressedPixelFormat::ETC2_RGBA &&
+			format != CompressedPixelFormat::ETC2_RGB_A1 && format != CompressedPixelFormat::EAC_R11 && format != CompressedPixelFormat::EAC_RG11))
+	{ throw InvalidArgumentError("texture", "[decompressEtcTexture]: The texture is not in an ETC or EAC format"); }
+
+	// Set up the new texture and header. Signed EAC data is decompressed to SNORM, everything else to UNORM.
+	const bool isSigned = isVariableTypeSigned(texture.getChannelType());
+	TextureHeader cDecompressedHeader(texture);
+	cDecompressedHeader.setPixelFormat(GeneratePixelType4<'r', 'g', 'b', 'a', 8, 8, 8, 8>::ID);
+	cDecompressedHeader.setChannelType(isSigned ? VariableType::SignedByteNorm : VariableType::UnsignedByteNorm);
+	Texture cDecompressedTexture(cDecompressedHeader);
+
+	// Do decompression, one slice at a time. Each slice is decompressed in parallel.
+	for (uint32_t uiMIPLevel = 0; uiMIPLevel < texture.getNumMipMapLevels(); ++uiMIPLevel)
+	{
+		const uint32_t width = texture.getWidth(uiMIPLevel), height = texture.getHeight(uiMIPLevel);
+		for (uint32_t uiArray = 0; uiArray < texture.getNumArrayMembers(); ++uiArray)
 		{
-			swap = pSwap[0];
-			pSwap[0] = pSwap[2];
-			pSwap[2] = swap;
-			pSwap += 4;
+			for (uint32_t uiFace = 0; uiFace < texture.getNumFaces(); ++uiFace)
+			{
+				const uint8_t* source = texture.getDataPointer(uiMIPLevel, uiArray, uiFace);
+				uint8_t* destination = cDecompressedTexture.getDataPointer(uiMIPLevel, uiArray, uiFace);
+				for (uint32_t slice = 0; slice < texture.getDepth(uiMIPLevel); ++slice)
+				{
+					source += PVRTDecompressETC(source, width, height, destination, format, isSigned, options);
+					destination += static_cast<size_t>(width) * height * 4;
+				}
+			}
 		}
-
-	return i32read;
+	}
+	return cDecompressedTexture;
 }
 } // namespace pvr
 //!\endcond
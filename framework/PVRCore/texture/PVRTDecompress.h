@@ -1,12 +1,34 @@
 /*!
-\brief Contains functions to decompress PVRTC or ETC formats into RGBA8888.
+\brief Contains functions to decompress PVRTC or ETC/EAC formats into RGBA8888.
 \file PVRCore/texture/PVRTDecompress.h
 \author PowerVR by Imagination, Developer Technology Team
 \copyright Copyright (c) Imagination Technologies Limited.
 */
 #pragma once
 #include <stdint.h>
+#include "PVRCore/texture/PixelFormat.h"
+#include "PVRCore/texture/Texture.h"
 namespace pvr {
+namespace async {
+class JobSystem;
+}
+
+/// <summary>Controls how the software decompressors execute. The defaults use one thread per hardware thread and
+/// the SIMD kernels if the build target supports them. Without a job system, every call that is large enough to split creates and joins its own
+/// threads, so applications decompressing many surfaces should provide one.</summary>
+struct DecompressionOptions
+{
+	uint32_t maxThreads; ///< The maximum number of threads to decompress with. 0 uses one thread per hardware thread, 1 decompresses on the calling thread.
+	bool allowSimd; ///< Set to false to force the scalar kernels, for example to validate the output of the vectorized ones.
+	async::JobSystem* jobSystem; ///< Optional. If not null, the work is spread over the workers of this job system instead of threads created for each call.
+
+	/// <summary>Constructor. Defaults to all hardware threads, SIMD kernels enabled and no job system.</summary>
+	DecompressionOptions() : maxThreads(0), allowSimd(true), jobSystem(nullptr) {}
+};
+
+/// <summary>Query whether this build contains vectorized (SSE2 or NEON) decompression kernels.</summary>
+/// <returns>True if the SIMD kernels are available and will be used unless DecompressionOptions::allowSimd is false.</returns>
+bool isSimdDecompressionSupported();
 
 /// <summary>Decompresses PVRTC to RGBA 8888.</summary>
 /// <param name="compressedData">The PVRTC texture data to decompress</param>
@@ -17,6 +39,17 @@ namespace pvr {
 /// <returns>Return the amount of data that was decompressed.</returns>
 uint32_t PVRTDecompressPVRTC(const void* compressedData, uint32_t do2bitMode, uint32_t xDim, uint32_t yDim, uint8_t* outResultImage);
 
+/// <summary>Decompresses PVRTC to RGBA 8888, splitting the image into bands of rows which are decoded in parallel.
+/// The output is bit-exact regardless of the number of threads or the kernel used.</summary>
+/// <param name="compressedData">The PVRTC texture data to decompress</param>
+/// <param name="do2bitMode">Signifies whether the data is PVRTC2 or PVRTC4</param>
+/// <param name="xDim">X dimension of the texture</param>
+/// <param name="yDim">Y dimension of the texture</param>
+/// <param name="outResultImage">The decompressed texture data</param>
+/// <param name="options">Threading and kernel selection options</param>
+/// <returns>Return the amount of data that was decompressed.</returns>
+uint32_t PVRTDecompressPVRTC(const void* compressedData, uint32_t do2bitMode, uint32_t xDim, uint32_t yDim, uint8_t* outResultImage, const DecompressionOptions& options);
+
 /// <summary>Decompresses ETC to RGBA 8888.</summary>
 /// <param name="srcData">The ETC texture data to decompress</param>
 /// <param name="xDim">X dimension of the texture</param>
@@ -25,4 +58,25 @@ uint32_t PVRTDecompressPVRTC(const void* compressedData, uint32_t do2bitMode, ui
 /// <param name="mode">The format of the data</param>
 /// <returns>Return The number of bytes of ETC data decompressed</returns>
 uint32_t PVRTDecompressETC(const void* srcData, uint32_t xDim, uint32_t yDim, void* dstData, uint32_t mode);
+
+/// <summary>Decompresses any format of the ETC family (ETC1, ETC2 RGB, ETC2 RGBA, ETC2 RGB with punch-through alpha,
+/// EAC R11 and EAC RG11) to RGBA 8888. Rows of blocks are decoded in parallel. EAC formats are written as (R, 0, 0, 1)
+/// and (R, G, 0, 1) respectively, keeping the 8 most significant bits of each 11 bit channel. Signed EAC data is written as
+/// SNORM8. Dimensions do not need to be multiples of the block size.</summary>
+/// <param name="srcData">The ETC texture data to decompress</param>
+/// <param name="xDim">X dimension of the texture</param>
+/// <param name="yDim">Y dimension of the texture</param>
+/// <param name="dstData">The decompressed texture data. Must hold xDim * yDim * 4 bytes.</param>
+/// <param name="format">The format of the data. Must be one of the ETC1, ETC2 or EAC formats.</param>
+/// <param name="isSigned">Only used for the EAC formats: signifies whether the data is signed (SNORM) or unsigned (UNORM)</param>
+/// <param name="options">Threading and kernel selection options</param>
+/// <returns>Return The number of bytes of ETC data decompressed, or 0 if the format is not an ETC format.</returns>
+uint32_t PVRTDecompressETC(const void* srcData, uint32_t xDim, uint32_t yDim, void* dstData, CompressedPixelFormat format, bool isSigned, const DecompressionOptions& options);
+
+/// <summary>Decompress an ETC1, ETC2 or EAC texture in software, for APIs or devices that do not support the format. Every surface is decompressed
+/// with PVRTDecompressETC to RGBA8888, SNORM if the texture is signed and UNORM otherwise, in the colour space of the texture.</summary>
+/// <param name="texture">The ETC texture to decompress</param>
+/// <param name="options">Threading and kernel selection options, used for every surface</param>
+/// <returns>The decompressed texture, with the same dimensions, MIP levels, array members and faces as the compressed one</returns>
+Texture decompressEtcTexture(const Texture& texture, const DecompressionOptions& options = DecompressionOptions());
 } // namespace pvr
@@ -0,0 +1,161 @@
+/*!
+\brief Internal helpers used by the software texture decompressors and texture readers to split work across threads, or across the workers of a
+JobSystem if the caller provides one.
+\file PVRCore/texture/ParallelDecompress.h
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+#pragma once
+#include "PVRCore/JobSystem.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//!\cond NO_DOXYGEN
+namespace pvr {
+namespace impl {
+/// <summary>Works out how many threads a decompression job should use.</summary>
+/// <param name="maxThreads">The requested maximum. 0 means one thread per hardware thread.</param>
+/// <param name="numItems">The number of independent work items (rows of blocks, surfaces...) in the job</param>
+/// <param name="minItemsPerThread">The minimum number of items that make spawning another thread worthwhile</param>
+/// <returns>The number of threads to use, including the calling thread. Always at least 1.</returns>
+inline uint32_t getDecompressionThreadCount(uint32_t maxThreads, uint32_t numItems, uint32_t minItemsPerThread)
+{
+	uint32_t numThreads = maxThreads;
+	if (!numThreads) { numThreads = std::max(1u, static_cast<uint32_t>(std::thread::hardware_concurrency())); }
+	return std::max(1u, std::min(numThreads, numItems / std::max(1u, minItemsPerThread)));
+}
+
+/// <summary>Splits the range [begin, end) into numThreads contiguous bands and calls func(bandBegin, bandEnd) for each of them.
+/// The last band is executed on the calling thread. Returns after all bands are done. The bands must not write to overlapping memory. If func throws,
+/// all the bands are still waited for, and the first exception is rethrown on the calling thread.</summary>
+/// <param name="begin">The first item of the range</param>
+/// <param name="end">One past the last item of the range</param>
+/// <param name="numThreads">The number of bands to split the range into (see getDecompressionThreadCount)</param>
+/// <param name="func">The function to execute for each band</param>
+/// <param name="jobSystem">Optional. If not null, the other bands are spawned as jobs on its workers instead of on threads created for this call.</param>
+template<typename Func>
+void parallelForBands(int32_t begin, int32_t end, uint32_t numThreads, const Func& func, async::JobSystem* jobSystem = nullptr)
+{
+	const int32_t numItems = end - begin;
+	if (numThreads <= 1 || numItems <= 1)
+	{
+		func(begin, end);
+		return;
+	}
+	numThreads = std::min(numThreads, static_cast<uint32_t>(numItems));
+
+	// Exceptions must not escape a band: destroying a joinable std::thread calls std::terminate.
+	std::exception_ptr firstError;
+	std::mutex errorMutex;
+	auto runBand = [&](int32_t bandBegin, int32_t bandEnd) {
+		try
+		{
+			func(bandBegin, bandEnd);
+		}
+		catch (...)
+		{
+			std::lock_guard<std::mutex> lock(errorMutex);
+			if (!firstError) { firstError = std::current_exception(); }
+		}
+	};
+
+	async::JobCounter counter;
+	std::vector<std::thread> workers;
+	if (!jobSystem) { workers.reserve(numThreads - 1); }
+	int32_t bandBegin = begin;
+	for (uint32_t i = 0; i < numThreads; ++i)
+	{
+		// Distribute the remainder over the first bands so that band sizes differ by at most one.
+		const int32_t bandEnd = bandBegin + numItems / static_cast<int32_t>(numThreads) + (static_cast<int32_t>(i) < numItems % static_cast<int32_t>(numThreads) ? 1 : 0);
+		if (i + 1 == numThreads) { runBand(bandBegin, bandEnd); }
+		else
+		{
+			// If no more threads or jobs can be created, execute the band on the calling thread.
+			try
+			{
+				if (jobSystem) { jobSystem->spawn([&runBand, bandBegin, bandEnd]() { runBand(bandBegin, bandEnd); }, &counter); }
+				else
+				{
+					workers.emplace_back([&runBand, bandBegin, bandEnd]() { runBand(bandBegin, bandEnd); });
+				}
+			}
+			catch (...)
+			{
+				runBand(bandBegin, bandEnd);
+			}
+		}
+		bandBegin = bandEnd;
+	}
+	if (jobSystem) { jobSystem->wait(counter); }
+	for (auto& worker : workers) { worker.join(); }
+	if (firstError) { std::rethrow_exception(firstError); }
+}
+
+/// <summary>Calls func(item) for every item in [0, numItems). Items are handed out one at a time to numThreads threads (the calling thread included),
+/// which balances items of very different cost (such as the mip levels of a texture). Returns after all items are done. If func throws, the remaining
+/// items are skipped and the first exception is rethrown on the calling thread.</summary>
+/// <param name="numItems">The number of items</param>
+/// <param name="numThreads">The number of threads to use (see getDecompressionThreadCount)</param>
+/// <param name="func">The function to execute for each item</param>
+/// <param name="jobSystem">Optional. If not null, the other threads are jobs spawned on its workers instead of threads created for this call.</param>
+template<typename Func>
+void parallelForEachItem(uint32_t numItems, uint32_t numThreads, const Func& func, async::JobSystem* jobSystem = nullptr)
+{
+	if (numThreads <= 1 || numItems <= 1)
+	{
+		for (uint32_t i = 0; i < numItems; ++i) { func(i); }
+		return;
+	}
+	numThreads = std::min(numThreads, numItems);
+
+	std::atomic<uint32_t> nextItem(0);
+	std::exception_ptr firstError;
+	std::mutex errorMutex;
+	auto worker = [&]() {
+		for (uint32_t item = nextItem++; item < numItems; item = nextItem++)
+		{
+			try
+			{
+				func(item);
+			}
+			catch (...)
+			{
+				std::lock_guard<std::mutex> lock(errorMutex);
+				if (!firstError) { firstError = std::current_exception(); }
+				nextItem = numItems;
+			}
+		}
+	};
+
+	async::JobCounter counter;
+	std::vector<std::thread> workers;
+	if (!jobSystem) { workers.reserve(numThreads - 1); }
+	for (uint32_t i = 1; i < numThreads; ++i)
+	{
+		// If no more threads or jobs can be created, the threads already running (and the calling thread) process the remaining items.
+		try
+		{
+			if (jobSystem) { jobSystem->spawn(worker, &counter); }
+			else
+			{
+				workers.emplace_back(worker);
+			}
+		}
+		catch (...)
+		{
+			break;
+		}
+	}
+	worker();
+	if (jobSystem) { jobSystem->wait(counter); }
+	for (auto& thread : workers) { thread.join(); }
+	if (firstError) { std::rethrow_exception(firstError); }
+}
+} // namespace impl
+} // namespace pvr
+//!\endcond
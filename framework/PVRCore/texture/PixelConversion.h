@@ -0,0 +1,184 @@
+/*!
+\brief Internal helpers used by the texture processing functions to convert between float and half float, packed float and sRGB values.
+\file PVRCore/texture/PixelConversion.h
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+//!\cond NO_DOXYGEN
+namespace pvr {
+namespace impl {
+/// <summary>Converts an IEEE half float to a float. The conversion is exact for all values, including denormals, infinities and NaNs.</summary>
+/// <param name="half">The bits of the half float</param>
+/// <returns>The value of the half float</returns>
+inline float halfToFloat(uint16_t half)
+{
+	const uint32_t sign = static_cast<uint32_t>(half & 0x8000) << 16;
+	uint32_t exponent = (half >> 10) & 0x1f;
+	uint32_t mantissa = half & 0x3ff;
+	uint32_t bits;
+	if (exponent == 0x1f) { bits = sign | 0x7f800000 | (mantissa << 13); } // Infinity or NaN
+	else if (exponent != 0)
+	{
+		bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+	}
+	else if (mantissa == 0)
+	{
+		bits = sign;
+	}
+	else
+	{
+		// Denormal: normalize it.
+		exponent = 113;
+		while (!(mantissa & 0x400))
+		{
+			mantissa <<= 1;
+			--exponent;
+		}
+		bits = sign | (exponent << 23) | ((mantissa & 0x3ff) << 13);
+	}
+	float value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+/// <summary>Converts a float to an IEEE half float, rounding to nearest even. Values too large for a half become infinite, and all NaNs become the
+/// quiet NaN 0x7e00 (with the sign of the input), like the SSE2 conversions of the texture functions.</summary>
+/// <param name="value">The float to convert</param>
+/// <returns>The bits of the half float</returns>
+inline uint16_t floatToHalf(float value)
+{
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	const uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+	const uint32_t magnitude = bits & 0x7fffffff;
+	if (magnitude > 0x7f800000) { return static_cast<uint16_t>(sign | 0x7e00); }
+	if (magnitude >= 0x477ff000) { return static_cast<uint16_t>(sign | 0x7c00); } // 65520 and above round to infinity
+	if (magnitude < 0x38800000)
+	{
+		// Denormal or zero.
+		if (magnitude < 0x33000000) { return sign; }
+		const uint32_t exponent = magnitude >> 23;
+		const uint32_t mantissa = (magnitude & 0x7fffff) | 0x800000;
+		const uint32_t shift = 126 - exponent;
+		uint32_t result = mantissa >> shift;
+		const uint32_t remainder = mantissa & ((1u << shift) - 1);
+		const uint32_t halfway = 1u << (shift - 1);
+		if (remainder > halfway || (remainder == halfway && (result & 1))) { ++result; }
+		return static_cast<uint16_t>(sign | result);
+	}
+	uint32_t result = ((magnitude >> 13) - (112 << 10));
+	const uint32_t remainder = magnitude & 0x1fff;
+	if (remainder > 0x1000 || (remainder == 0x1000 && (result & 1))) { ++result; }
+	return static_cast<uint16_t>(sign | result);
+}
+
+/// <summary>Converts an unsigned float with a 5 bit exponent and no sign bit, as used by the 11 and 10 bit channels of packed float formats, to a float.</summary>
+/// <param name="bits">The bits of the packed float</param>
+/// <param name="mantissaBits">The number of mantissa bits: 6 for 11 bit floats, 5 for 10 bit floats</param>
+/// <returns>The value of the packed float</returns>
+inline float unsignedSmallFloatToFloat(uint32_t bits, uint32_t mantissaBits)
+{
+	const uint32_t exponent = bits >> mantissaBits;
+	const uint32_t mantissa = bits & ((1u << mantissaBits) - 1);
+	if (exponent == 0) { return std::ldexp(static_cast<float>(mantissa), -14 - static_cast<int32_t>(mantissaBits)); }
+	const uint32_t floatBits = exponent == 0x1f ? (0x7f800000 | (mantissa << (23 - mantissaBits))) : (((exponent + 112) << 23) | (mantissa << (23 - mantissaBits)));
+	float value;
+	memcpy(&value, &floatBits, sizeof(value));
+	return value;
+}
+
+/// <summary>Converts a float to an unsigned float with a 5 bit exponent and no sign bit, rounding to nearest even. Negative values become 0, and finite
+/// values too large for the format are clamped to its largest finite value.</summary>
+/// <param name="value">The float to convert</param>
+/// <param name="mantissaBits">The number of mantissa bits: 6 for 11 bit floats, 5 for 10 bit floats</param>
+/// <returns>The bits of the packed float</returns>
+inline uint32_t floatToUnsignedSmallFloat(float value, uint32_t mantissaBits)
+{
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	const uint32_t infinity = 0x1fu << mantissaBits;
+	if ((bits & 0x7fffffff) > 0x7f800000) { return infinity | (1u << (mantissaBits - 1)); } // NaN, whatever its sign
+	if (bits & 0x80000000) { return 0; }
+	if (bits == 0x7f800000) { return infinity; }
+	const uint32_t exponent = bits >> 23;
+	const uint32_t mantissa = (bits & 0x7fffff) | 0x800000;
+	uint32_t result, shift;
+	if (exponent < 113)
+	{
+		// Denormal or zero.
+		shift = 136 - mantissaBits - exponent;
+		if (shift > 24) { return 0; }
+		result = mantissa >> shift;
+	}
+	else
+	{
+		shift = 23 - mantissaBits;
+		result = (bits >> shift) - (112u << mantissaBits);
+	}
+	const uint32_t remainder = mantissa & ((1u << shift) - 1);
+	const uint32_t halfway = 1u << (shift - 1);
+	if (remainder > halfway || (remainder == halfway && (result & 1))) { ++result; }
+	return std::min(result, infinity - 1);
+}
+
+/// <summary>Decodes an sRGB value to linear.</summary>
+/// <param name="value">The sRGB encoded value, from 0 to 1</param>
+/// <returns>The linear value</returns>
+inline float srgbToLinear(float value) { return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f); }
+
+/// <summary>Encodes a linear value to sRGB.</summary>
+/// <param name="value">The linear value, from 0 to 1</param>
+/// <returns>The sRGB encoded value</returns>
+inline float linearToSrgb(float value) { return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.f / 2.4f) - 0.055f; }
+
+/// <summary>Decoding table of 8 bit sRGB values, and the linear values halfway between consecutive sRGB values, which encode exactly like
+/// round(linearToSrgb(value) * 255) without evaluating a power for every channel of every texel. The thresholds are never closer to each other than
+/// 1 / 8192, so that the sRGB value at the start of each 1 / 8192 wide range of linear values is at most one less than that of any value in the range.
+/// Use getSrgbTables to get the shared instance.</summary>
+struct SrgbTables
+{
+	enum
+	{
+		NUM_ENCODING_RANGES = 8192
+	};
+	float toLinear[256];
+	float encodingThresholds[256];
+	uint8_t encodingRangeStarts[NUM_ENCODING_RANGES + 1];
+	SrgbTables()
+	{
+		for (uint32_t i = 0; i < 256; ++i) { toLinear[i] = srgbToLinear(i / 255.f); }
+		for (uint32_t i = 0; i < 255; ++i) { encodingThresholds[i] = srgbToLinear((i + .5f) / 255.f); }
+		encodingThresholds[255] = 2.f; // Never reached, as values are clamped to 1
+		uint32_t code = 0;
+		for (uint32_t i = 0; i <= NUM_ENCODING_RANGES; ++i)
+		{
+			while (code < 255 && encodingThresholds[code] <= static_cast<float>(i) / NUM_ENCODING_RANGES) { ++code; }
+			encodingRangeStarts[i] = static_cast<uint8_t>(code);
+		}
+	}
+	/// <summary>Encodes a linear value to 8 bit sRGB, clamping it to [0, 1]. NaNs encode to 0.</summary>
+	uint8_t encode(float linear) const
+	{
+		linear = linear > 0.f ? std::min(linear, 1.f) : 0.f;
+		uint32_t code = encodingRangeStarts[static_cast<uint32_t>(linear * NUM_ENCODING_RANGES)];
+		code += encodingThresholds[code] <= linear ? 1 : 0;
+		return static_cast<uint8_t>(code);
+	}
+};
+
+/// <summary>Get the sRGB tables, building them on first use.</summary>
+/// <returns>The shared sRGB tables</returns>
+inline const SrgbTables& getSrgbTables()
+{
+	static const SrgbTables tables;
+	return tables;
+}
+} // namespace impl
+} // namespace pvr
+//!\endcond
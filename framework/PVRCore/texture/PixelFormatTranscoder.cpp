@@ -0,0 +1,1051 @@
+/*!
+\brief Implementation of the pixel format transcoding functions.
+\file PVRCore/texture/PixelFormatTranscoder.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+
+#include "PixelFormatTranscoder.h"
+#include "ParallelDecompress.h"
+#include "PixelConversion.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PVR_TRANSCODE_SSE2 1
+#include <emmintrin.h>
+#if defined(__SSSE3__) || defined(__AVX__)
+#define PVR_TRANSCODE_SSSE3 1
+#include <tmmintrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define PVR_TRANSCODE_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace pvr {
+namespace {
+enum
+{
+	PIXELS_PER_BLOCK = 256, // Pixels converted through the intermediate float buffer at a time
+	PIXELS_PER_CHUNK = 16384, // Pixels given to a thread at a time
+	MIN_CHUNKS_PER_THREAD = 4,
+	MAX_CHANNELS = 4,
+	BYTE_ZERO = -1, // Byte shuffle sources that are constants rather than source bytes
+	BYTE_ONE = -2,
+};
+
+enum class ChannelKind
+{
+	UnsignedNorm,
+	SignedNorm,
+	UnsignedInteger,
+	SignedInteger,
+	Float,
+	UnsignedFloat,
+};
+
+struct PixelChannel
+{
+	char name;
+	uint32_t bits;
+	uint32_t offset; // In bytes for consecutive channels, in bits from the least significant bit of the pixel for packed ones
+	uint32_t decodeTargets; // Bit mask of the RGBA components the channel is read into
+	int32_t encodeSource; // The RGBA component the channel is written from, or -1 for padding
+	bool isGammaConverted; // The channel is converted between sRGB and linear
+};
+
+struct PixelLayout
+{
+	enum Type
+	{
+		Consecutive, // Each channel is one or more whole bytes
+		Packed, // Each channel is a bit field of one little endian word
+		SharedExponent, // R9G9B9E5
+	} type;
+	ChannelKind kind;
+	uint32_t bytesPerPixel;
+	uint32_t numChannels;
+	PixelChannel channels[MAX_CHANNELS];
+};
+
+ChannelKind getChannelKind(VariableType channelType)
+{
+	if (channelType == VariableType::SignedFloat) { return ChannelKind::Float; }
+	if (channelType == VariableType::UnsignedFloat) { return ChannelKind::UnsignedFloat; }
+	if (isVariableTypeNormalized(channelType)) { return isVariableTypeSigned(channelType) ? ChannelKind::SignedNorm : ChannelKind::UnsignedNorm; }
+	return isVariableTypeSigned(channelType) ? ChannelKind::SignedInteger : ChannelKind::UnsignedInteger;
+}
+
+// The size of the values of a channel type, or 0 for floats, whose size is given by the channel.
+uint32_t getChannelTypeBits(VariableType channelType)
+{
+	switch (channelType)
+	{
+	case VariableType::UnsignedByteNorm:
+	case VariableType::SignedByteNorm:
+	case VariableType::UnsignedByte:
+	case VariableType::SignedByte: return 8;
+	case VariableType::UnsignedShortNorm:
+	case VariableType::SignedShortNorm:
+	case VariableType::UnsignedShort:
+	case VariableType::SignedShort: return 16;
+	case VariableType::UnsignedIntegerNorm:
+	case VariableType::SignedIntegerNorm:
+	case VariableType::UnsignedInteger:
+	case VariableType::SignedInteger: return 32;
+	default: return 0;
+	}
+}
+
+bool setChannelName(char name, PixelChannel& outChannel)
+{
+	outChannel.name = name;
+	switch (name)
+	{
+	case 'r': outChannel.decodeTargets = 1, outChannel.encodeSource = 0; return true;
+	case 'g': outChannel.decodeTargets = 2, outChannel.encodeSource = 1; return true;
+	case 'b': outChannel.decodeTargets = 4, outChannel.encodeSource = 2; return true;
+	case 'a': outChannel.decodeTargets = 8, outChannel.encodeSource = 3; return true;
+	case 'l': outChannel.decodeTargets = 7, outChannel.encodeSource = 0; return true;
+	case 'i': outChannel.decodeTargets = 15, outChannel.encodeSource = 0; return true;
+	case 'd': outChannel.decodeTargets = 1, outChannel.encodeSource = 0; return true;
+	case 's': outChannel.decodeTargets = 2, outChannel.encodeSource = 1; return true;
+	case 'x': outChannel.decodeTargets = 0, outChannel.encodeSource = -1; return true;
+	default: return false;
+	}
+}
+
+bool getPixelLayout(const PixelFormat& format, VariableType channelType, PixelLayout& outLayout)
+{
+	if (static_cast<uint32_t>(channelType) >= static_cast<uint32_t>(VariableType::NumVarTypes)) { return false; }
+	outLayout.kind = getChannelKind(channelType);
+	if (format.getPart().High == 0)
+	{
+		if (format.getPixelTypeId() != static_cast<uint64_t>(CompressedPixelFormat::SharedExponentR9G9B9E5)) { return false; }
+		outLayout.type = PixelLayout::SharedExponent;
+		outLayout.kind = ChannelKind::UnsignedFloat;
+		outLayout.bytesPerPixel = 4;
+		outLayout.numChannels = 3;
+		for (uint32_t channel = 0; channel < 3; ++channel)
+		{
+			setChannelName("rgb"[channel], outLayout.channels[channel]);
+			outLayout.channels[channel].bits = 9;
+			outLayout.channels[channel].offset = channel * 9;
+			outLayout.channels[channel].isGammaConverted = false;
+		}
+		return true;
+	}
+
+	const uint32_t bitsPerPixel = format.getBitsPerPixel();
+	const uint32_t typeBits = getChannelTypeBits(channelType);
+	const bool isFloat = outLayout.kind == ChannelKind::Float || outLayout.kind == ChannelKind::UnsignedFloat;
+	outLayout.numChannels = format.getNumChannels();
+	if (outLayout.numChannels == 0 || bitsPerPixel % 8 != 0) { return false; }
+	outLayout.bytesPerPixel = bitsPerPixel / 8;
+
+	bool isConsecutive = true;
+	for (uint8_t channel = 0; channel < outLayout.numChannels; ++channel)
+	{
+		PixelChannel& pixelChannel = outLayout.channels[channel];
+		pixelChannel.bits = format.getChannelBits(channel);
+		pixelChannel.isGammaConverted = false;
+		if (!setChannelName(format.getChannelContent(channel), pixelChannel) || pixelChannel.bits == 0 || pixelChannel.bits > 32) { return false; }
+		if (typeBits ? pixelChannel.bits != typeBits : (pixelChannel.bits != 16 && pixelChannel.bits != 32)) { isConsecutive = false; }
+	}
+	if (isConsecutive)
+	{
+		outLayout.type = PixelLayout::Consecutive;
+		uint32_t offset = 0;
+		for (uint32_t channel = 0; channel < outLayout.numChannels; ++channel)
+		{
+			outLayout.channels[channel].offset = offset;
+			offset += outLayout.channels[channel].bits / 8;
+		}
+		return true;
+	}
+
+	// Bit fields, the first channel in the most significant bits.
+	if (bitsPerPixel != 8 && bitsPerPixel != 16 && bitsPerPixel != 32) { return false; }
+	outLayout.type = PixelLayout::Packed;
+	uint32_t offset = bitsPerPixel;
+	for (uint32_t channel = 0; channel < outLayout.numChannels; ++channel)
+	{
+		PixelChannel& pixelChannel = outLayout.channels[channel];
+		if (isFloat && pixelChannel.name != 'x' && pixelChannel.bits != 10 && pixelChannel.bits != 11 && pixelChannel.bits != 16) { return false; }
+		offset -= pixelChannel.bits;
+		pixelChannel.offset = offset;
+	}
+	return true;
+}
+
+inline uint32_t getChannelMask(uint32_t bits) { return bits >= 32 ? 0xffffffffu : (1u << bits) - 1; }
+
+inline int32_t signExtend(uint32_t value, uint32_t bits) { return bits >= 32 ? static_cast<int32_t>(value) : static_cast<int32_t>(value << (32 - bits)) >> (32 - bits); }
+
+float decodeValue(uint32_t raw, ChannelKind kind, uint32_t bits)
+{
+	switch (kind)
+	{
+	case ChannelKind::UnsignedNorm: return static_cast<float>(raw / static_cast<double>(getChannelMask(bits)));
+	case ChannelKind::SignedNorm: return std::max(-1.f, static_cast<float>(signExtend(raw, bits) / static_cast<double>(getChannelMask(bits - 1))));
+	case ChannelKind::UnsignedInteger: return static_cast<float>(raw);
+	case ChannelKind::SignedInteger: return static_cast<float>(signExtend(raw, bits));
+	case ChannelKind::Float:
+	case ChannelKind::UnsignedFloat:
+	{
+		if (bits == 16) { return impl::halfToFloat(static_cast<uint16_t>(raw)); }
+		if (bits == 32)
+		{
+			float value;
+			memcpy(&value, &raw, sizeof(value));
+			return value;
+		}
+		return impl::unsignedSmallFloatToFloat(raw, bits - 5);
+	}
+	}
+	return 0.f;
+}
+
+// Clamps a value to a range, with NaNs becoming 0.
+inline double clampOrZero(double value, double minValue, double maxValue) { return value >= minValue ? std::min(value, maxValue) : value < minValue ? minValue : 0.; }
+
+uint32_t encodeValue(float value, ChannelKind kind, uint32_t bits)
+{
+	switch (kind)
+	{
+	case ChannelKind::UnsignedNorm:
+	{
+		if (bits <= 16) { return static_cast<uint32_t>(static_cast<float>(clampOrZero(value, 0., 1.)) * getChannelMask(bits) + .5f); }
+		return static_cast<uint32_t>(clampOrZero(value, 0., 1.) * getChannelMask(bits) + .5);
+	}
+	case ChannelKind::SignedNorm:
+	{
+		const double maxValue = getChannelMask(bits - 1);
+		return static_cast<uint32_t>(static_cast<int32_t>(std::floor(clampOrZero(value, -1., 1.) * maxValue + .5))) & getChannelMask(bits);
+	}
+	case ChannelKind::UnsignedInteger: return static_cast<uint32_t>(std::floor(clampOrZero(value, 0., getChannelMask(bits)) + .5));
+	case ChannelKind::SignedInteger:
+	{
+		const double maxValue = getChannelMask(bits - 1);
+		return static_cast<uint32_t>(static_cast<int32_t>(std::floor(clampOrZero(value, -maxValue - 1., maxValue) + .5))) & getChannelMask(bits);
+	}
+	case ChannelKind::Float:
+	case ChannelKind::UnsignedFloat:
+	{
+		if (kind == ChannelKind::UnsignedFloat) { value = std::max(value, 0.f); } // NaNs stay NaNs
+		if (bits == 16) { return impl::floatToHalf(value); }
+		if (bits == 32)
+		{
+			uint32_t raw;
+			memcpy(&raw, &value, sizeof(raw));
+			return raw;
+		}
+		return impl::floatToUnsignedSmallFloat(value, bits - 5);
+	}
+	}
+	return 0;
+}
+
+uint32_t encodeSharedExponent(const float* rgba)
+{
+	// As specified by EXT_texture_shared_exponent.
+	const double maxValue = 65408.; // (2^9 - 1) / 2^9 * 2^(31 - 15)
+	double color[3];
+	for (uint32_t channel = 0; channel < 3; ++channel) { color[channel] = clampOrZero(rgba[channel], 0., maxValue); }
+	const double maxColor = std::max(color[0], std::max(color[1], color[2]));
+	if (maxColor == 0.) { return 0; }
+	int32_t exponent;
+	std::frexp(maxColor, &exponent); // maxColor = m * 2^exponent with m in [0.5, 1), so floor(log2(maxColor)) = exponent - 1
+	int32_t sharedExponent = std::max(-16, exponent - 1) + 16;
+	double scale = std::ldexp(1., 24 - sharedExponent);
+	if (std::floor(maxColor * scale + .5) == 512.)
+	{
+		++sharedExponent;
+		scale *= .5;
+	}
+	uint32_t result = static_cast<uint32_t>(sharedExponent) << 27;
+	for (uint32_t channel = 0; channel < 3; ++channel) { result |= static_cast<uint32_t>(std::floor(color[channel] * scale + .5)) << (channel * 9); }
+	return result;
+}
+
+struct Transcoder;
+typedef void (*TranscodeKernel)(const Transcoder& transcoder, const uint8_t* source, uint8_t* destination, size_t numPixels);
+
+struct Transcoder
+{
+	PixelLayout source;
+	PixelLayout destination;
+	TranscodeKernel kernel;
+	bool hasDecodeTable[MAX_CHANNELS]; // Source channels of up to 8 bits are decoded with a table
+	float decodeTables[MAX_CHANNELS][256];
+	int32_t byteSources[MAX_CHANNELS]; // Byte kernels: the source byte of each destination byte, or BYTE_ZERO or BYTE_ONE
+	uint8_t byteOne;
+	uint8_t byteTables[MAX_CHANNELS][256]; // Byte kernels with colour space conversion: the conversion of each destination byte
+};
+
+////////////////////////////////////////////// Generic kernel //////////////////////////////////////////////
+// Little endian values of 1 to 4 bytes.
+inline uint32_t readValue(const uint8_t* data, uint32_t numBytes)
+{
+	switch (numBytes)
+	{
+	case 1: return *data;
+	case 2:
+	{
+		uint16_t value;
+		memcpy(&value, data, 2);
+		return value;
+	}
+	case 3: return data[0] | (data[1] << 8) | (data[2] << 16);
+	default:
+	{
+		uint32_t value;
+		memcpy(&value, data, 4);
+		return value;
+	}
+	}
+}
+
+inline void writeValue(uint8_t* data, uint32_t value, uint32_t numBytes)
+{
+	switch (numBytes)
+	{
+	case 1: *data = static_cast<uint8_t>(value); break;
+	case 2:
+	{
+		const uint16_t value16 = static_cast<uint16_t>(value);
+		memcpy(data, &value16, 2);
+		break;
+	}
+	case 3:
+		data[0] = static_cast<uint8_t>(value);
+		data[1] = static_cast<uint8_t>(value >> 8);
+		data[2] = static_cast<uint8_t>(value >> 16);
+		break;
+	default: memcpy(data, &value, 4); break;
+	}
+}
+
+// Both work a channel at a time, so that the loops over the pixels do not branch on the format.
+void decodePixels(const Transcoder& transcoder, const uint8_t* source, size_t numPixels, float* outRgba)
+{
+	const PixelLayout& layout = transcoder.source;
+	for (size_t pixel = 0; pixel < numPixels; ++pixel)
+	{
+		float* rgba = outRgba + pixel * 4;
+		rgba[0] = rgba[1] = rgba[2] = 0.f;
+		rgba[3] = 1.f;
+	}
+	if (layout.type == PixelLayout::SharedExponent)
+	{
+		for (size_t pixel = 0; pixel < numPixels; ++pixel)
+		{
+			const uint32_t word = readValue(source + pixel * 4, 4);
+			const float scale = std::ldexp(1.f, static_cast<int32_t>(word >> 27) - 24);
+			for (uint32_t channel = 0; channel < 3; ++channel)
+			{
+				const float value = ((word >> (channel * 9)) & 0x1ff) * scale;
+				outRgba[pixel * 4 + channel] = layout.channels[channel].isGammaConverted ? impl::srgbToLinear(value) : value;
+			}
+		}
+		return;
+	}
+	float values[PIXELS_PER_BLOCK];
+	for (uint32_t channel = 0; channel < layout.numChannels; ++channel)
+	{
+		const PixelChannel& pixelChannel = layout.channels[channel];
+		if (!pixelChannel.decodeTargets) { continue; }
+		const bool isPacked = layout.type == PixelLayout::Packed;
+		const uint8_t* channelData = source + (isPacked ? 0 : pixelChannel.offset);
+		const uint32_t numBytes = isPacked ? layout.bytesPerPixel : pixelChannel.bits / 8;
+		const uint32_t shift = isPacked ? pixelChannel.offset : 0;
+		const uint32_t mask = getChannelMask(pixelChannel.bits);
+		if (transcoder.hasDecodeTable[channel])
+		{
+			const float* table = transcoder.decodeTables[channel];
+			for (size_t pixel = 0; pixel < numPixels; ++pixel) { values[pixel] = table[(readValue(channelData + pixel * layout.bytesPerPixel, numBytes) >> shift) & mask]; }
+		}
+		else
+		{
+			for (size_t pixel = 0; pixel < numPixels; ++pixel)
+			{
+				const uint32_t raw = (readValue(channelData + pixel * layout.bytesPerPixel, numBytes) >> shift) & mask;
+				values[pixel] = decodeValue(raw, layout.kind, pixelChannel.bits);
+			}
+			if (pixelChannel.isGammaConverted)
+			{
+				for (size_t pixel = 0; pixel < numPixels; ++pixel) { values[pixel] = impl::srgbToLinear(values[pixel]); }
+			}
+		}
+		for (uint32_t target = 0; target < 4; ++target)
+		{
+			if (!(pixelChannel.decodeTargets & (1u << target))) { continue; }
+			for (size_t pixel = 0; pixel < numPixels; ++pixel) { outRgba[pixel * 4 + target] = values[pixel]; }
+		}
+	}
+}
+
+// Encodes one component of a block of RGBA values, with the common cases in their own loops.
+void encodeChannel(const float* rgba, int32_t component, size_t numPixels, ChannelKind kind, uint32_t bits, bool isGammaConverted, uint32_t* outRaw)
+{
+	if (component < 0)
+	{
+		std::fill(outRaw, outRaw + numPixels, 0u);
+		return;
+	}
+	const float* values = rgba + component;
+	if (isGammaConverted)
+	{
+		if (bits == 8 && kind == ChannelKind::UnsignedNorm)
+		{
+			const impl::SrgbTables& srgb = impl::getSrgbTables();
+			for (size_t pixel = 0; pixel < numPixels; ++pixel) { outRaw[pixel] = srgb.encode(values[pixel * 4]); }
+		}
+		else
+		{
+			for (size_t pixel = 0; pixel < numPixels; ++pixel) { outRaw[pixel] = encodeValue(impl::linearToSrgb(std::max(values[pixel * 4], 0.f)), kind, bits); }
+		}
+		return;
+	}
+	if (kind == ChannelKind::UnsignedNorm && bits <= 16)
+	{
+		const float maxValue = static_cast<float>(getChannelMask(bits));
+		for (size_t pixel = 0; pixel < numPixels; ++pixel)
+		{
+			const float value = values[pixel * 4];
+			outRaw[pixel] = static_cast<uint32_t>((value > 0.f ? std::min(value, 1.f) : 0.f) * maxValue + .5f);
+		}
+	}
+	else if (kind == ChannelKind::Float && bits == 32)
+	{
+		for (size_t pixel = 0; pixel < numPixels; ++pixel) { memcpy(outRaw + pixel, values + pixel * 4, 4); }
+	}
+	else if (kind == ChannelKind::Float && bits == 16)
+	{
+		for (size_t pixel = 0; pixel < numPixels; ++pixel) { outRaw[pixel] = impl::floatToHalf(values[pixel * 4]); }
+	}
+	else
+	{
+		for (size_t pixel = 0; pixel < numPixels; ++pixel) { outRaw[pixel] = encodeValue(values[pixel * 4], kind, bits); }
+	}
+}
+
+void encodePixels(const Transcoder& transcoder, const float* rgba, size_t numPixels, uint8_t* destination)
+{
+	const PixelLayout& layout = transcoder.destination;
+	if (layout.type == PixelLayout::SharedExponent)
+	{
+		for (size_t pixel = 0; pixel < numPixels; ++pixel)
+		{
+			float color[3];
+			for (uint32_t channel = 0; channel < 3; ++channel)
+			{
+				const float value = rgba[pixel * 4 + channel];
+				color[channel] = layout.channels[channel].isGammaConverted ? impl::linearToSrgb(std::max(value, 0.f)) : value;
+			}
+			writeValue(destination + pixel * 4, encodeSharedExponent(color), 4);
+		}
+		return;
+	}
+	const bool isPacked = layout.type == PixelLayout::Packed;
+	uint32_t raw[PIXELS_PER_BLOCK];
+	uint32_t words[PIXELS_PER_BLOCK];
+	if (isPacked) { std::fill(words, words + numPixels, 0u); }
+	for (uint32_t channel = 0; channel < layout.numChannels; ++channel)
+	{
+		const PixelChannel& pixelChannel = layout.channels[channel];
+		encodeChannel(rgba, pixelChannel.encodeSource, numPixels, layout.kind, pixelChannel.bits, pixelChannel.isGammaConverted, raw);
+		if (isPacked)
+		{
+			for (size_t pixel = 0; pixel < numPixels; ++pixel) { words[pixel] |= raw[pixel] << pixelChannel.offset; }
+		}
+		else
+		{
+			const uint32_t numBytes = pixelChannel.bits / 8;
+			for (size_t pixel = 0; pixel < numPixels; ++pixel) { writeValue(destination + pixelChannel.offset + pixel * layout.bytesPerPixel, raw[pixel], numBytes); }
+		}
+	}
+	if (isPacked)
+	{
+		for (size_t pixel = 0; pixel < numPixels; ++pixel) { writeValue(destination + pixel * layout.bytesPerPixel, words[pixel], layout.bytesPerPixel); }
+	}
+}
+
+void transcodeThroughFloats(const Transcoder& transcoder, const uint8_t* source, uint8_t* destination, size_t numPixels)
+{
+	float rgba[PIXELS_PER_BLOCK * 4];
+	while (numPixels)
+	{
+		const size_t numBlockPixels = std::min<size_t>(numPixels, PIXELS_PER_BLOCK);
+		decodePixels(transcoder, source, numBlockPixels, rgba);
+		encodePixels(transcoder, rgba, numBlockPixels, destination);
+		source += numBlockPixels * transcoder.source.bytesPerPixel;
+		destination += numBlockPixels * transcoder.destination.bytesPerPixel;
+		numPixels -= numBlockPixels;
+	}
+}
+
+void copyPixels(const Transcoder& transcoder, const uint8_t* source, uint8_t* destination, size_t numPixels)
+{
+	memcpy(destination, source, numPixels * transcoder.source.bytesPerPixel);
+}
+
+////////////////////////////////////////////// Byte kernels //////////////////////////////////////////////
+// Shuffles the bytes of formats of 8 bit channels, and optionally converts them between sRGB and linear with a table.
+template<bool UseTables>
+void shuffleBytes(const Transcoder& transcoder, const uint8_t* source, uint8_t* destination, size_t numPixels)
+{
+	const uint32_t sourceSize = transcoder.source.bytesPerPixel, destinationSize = transcoder.destination.bytesPerPixel;
+	for (size_t pixel = 0; pixel < numPixels; ++pixel, source += sourceSize, destination += destinationSize)
+	{
+		for (uint32_t channel = 0; channel < destinationSize; ++channel)
+		{
+			const int32_t byteSource = transcoder.byteSources[channel];
+			const uint8_t value = byteSource >= 0 ? source[byteSource] : byteSource == BYTE_ONE ? transcoder.byteOne : 0;
+			destination[channel] = UseTables ? transcoder.byteTables[channel][value] : value;
+		}
+	}
+}
+
+// RGBA8 <-> BGRA8, processing each pixel as a 32 bit word.
+void swapRedBlue(const Transcoder&, const uint8_t* source, uint8_t* destination, size_t numPixels)
+{
+	for (size_t pixel = 0; pixel < numPixels; ++pixel)
+	{
+		uint32_t word;
+		memcpy(&word, source + pixel * 4, 4);
+		word = (word & 0xff00ff00) | ((word >> 16) & 0xff) | ((word & 0xff) << 16);
+		memcpy(destination + pixel * 4, &word, 4);
+	}
+}
+
+// RGB8 -> RGBA8 with an opaque alpha, with the three colour bytes taken from source bytes R, G and B.
+template<uint32_t R, uint32_t G, uint32_t B>
+void expandToFourBytes(const Transcoder& transcoder, const uint8_t* source, uint8_t* destination, size_t numPixels)
+{
+	for (size_t pixel = 0; pixel < numPixels; ++pixel, source += 3, destination += 4)
+	{
+		destination[0] = source[R];
+		destination[1] = source[G];
+		destination[2] = source[B];
+		destination[3] = transcoder.byteOne;
+	}
+}
+
+// RGBA8 -> RGB8, with the three colour bytes taken from source bytes R, G and B.
+template<uint32_t R, uint32_t G, uint32_t B>
+void shrinkToThreeBytes(const Transcoder&, const uint8_t* source, uint8_t* destination, size_t numPixels)
+{
+	for (size_t pixel = 0; pixel < numPixels; ++pixel, source += 4, destination += 3)
+	{
+		destination[0] = source[R];
+		destination[1] = source[G];
+		destination[2] = source[B];
+	}
+}
+
+#if defined(PVR_TRANSCODE_SSE2)
+void swapRedBlueSimd(const Transcoder& transcoder, const uint8_t* source, uint8_t* destination, size_t numPixels)
+{
+	const __m128i greenAlphaMask = _mm_set1_epi32(static_cast<int32_t>(0xff00ff00));
+	size_t pixel = 0;
+	for (; pixel + 4 <= numPixels; pixel += 4)
+	{
+		const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + pixel * 4));
+		const __m128i redBlue = _mm_andnot_si128(greenAlphaMask, pixels);
+		const __m128i swapped = _mm_or_si128(_mm_srli_epi32(redBlue, 16), _mm_slli_epi32(redBlue, 16));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + pixel * 4), _mm_or_si128(_mm_and_si128(pixels, greenAlphaMask), swapped));
+	}
+	swapRedBlue(transcoder, source + pixel * 4, destination + pixel * 4, numPixels - pixel);
+}
+#elif defined(PVR_TRANSCODE_NEON)
+void swapRedBlueSimd(const Transcoder& transcoder, const uint8_t* source, uint8_t* destination, size_t numPixels)
+{
+	size_t pixel = 0;
+	for (; pixel + 16 <= numPixels; pixel += 16)
+	{
+		uint8x16x4_t pixels = vld4q_u8(source + pixel * 4);
+		const uint8x16_t red = pixels.val[0];
+		pixels.val[0] = pixels.val[2];
+		pixels.val[2] = red;
+		vst4q_u8(destination + pixel * 4, pixels);
+	}
+	swapRedBlue(transcoder, source + pixel * 4, destination + pixel * 4, numPixels - pixel);
+}
+#endif
+
+#if defined(PVR_TRANSCODE_SSSE3)
+template<uint32_t R, uint32_t G, uint32_t B>
+void expandToFourBytesSimd(const Transcoder& transcoder, const uint8_t* source, uint8_t* destination, size_t numPixels)
+{
+	// 4 pixels at a time. The loads read 16 bytes for the 12 that are used, so stop while 4 bytes of source are left after them.
+	const __m128i shuffle = _mm_setr_epi8(R, G, B, -1, 3 + R, 3 + G, 3 + B, -1, 6 + R, 6 + G, 6 + B, -1, 9 + R, 9 + G, 9 + B, -1);
+	const __m128i alpha = _mm_set1_epi32(static_cast<int32_t>(static_cast<uint32_t>(transcoder.byteOne) << 24));
+	size_t pixel = 0;
+	for (; pixel + 6 <= numPixels; pixel += 4)
+	{
+		const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + pixel * 3));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + pixel * 4), _mm_or_si128(_mm_shuffle_epi8(pixels, shuffle), alpha));
+	}
+	expandToFourBytes<R, G, B>(transcoder, source + pixel * 3, destination + pixel * 4, numPixels - pixel);
+}
+
+template<uint32_t R, uint32_t G, uint32_t B>
+void shrinkToThreeBytesSimd(const Transcoder& transcoder, const uint8_t* source, uint8_t* destination, size_t numPixels)
+{
+	// 4 pixels at a time. The stores write 16 bytes for the 12 that are produced, so stop while 4 bytes of destination are left after them.
+	const __m128i shuffle = _mm_setr_epi8(R, G, B, 4 + R, 4 + G, 4 + B, 8 + R, 8 + G, 8 + B, 12 + R, 12 + G, 12 + B, -1, -1, -1, -1);
+	size_t pixel = 0;
+	for (; pixel + 6 <= numPixels; pixel += 4)
+	{
+		const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + pixel * 4));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + pixel * 3), _mm_shuffle_epi8(pixels, shuffle));
+	}
+	shrinkToThreeBytes<R, G, B>(transcoder, source + pixel * 4, destination + pixel * 3, numPixels - pixel);
+}
+#elif defined(PVR_TRANSCODE_NEON)
+template<uint32_t R, uint32_t G, uint32_t B>
+void expandToFourBytesSimd(const Transcoder& transcoder, const uint8_t* source, uint8_t* destination, size_t numPixels)
+{
+	size_t pixel = 0;
+	for (; pixel + 16 <= numPixels; pixel += 16)
+	{
+		const uint8x16x3_t pixels = vld3q_u8(source + pixel * 3);
+		uint8x16x4_t result;
+		result.val[0] = pixels.val[R];
+		result.val[1] = pixels.val[G];
+		result.val[2] = pixels.val[B];
+		result.val[3] = vdupq_n_u8(transcoder.byteOne);
+		vst4q_u8(destination + pixel * 4, result);
+	}
+	expandToFourBytes<R, G, B>(transcoder, source + pixel * 3, destination + pixel * 4, numPixels - pixel);
+}
+
+template<uint32_t R, uint32_t G, uint32_t B>
+void shrinkToThreeBytesSimd(const Transcoder& transcoder, const uint8_t* source, uint8_t* destination, size_t numPixels)
+{
+	size_t pixel = 0;
+	for (; pixel + 16 <= numPixels; pixel += 16)
+	{
+		const uint8x16x4_t pixels = vld4q_u8(source + pixel * 4);
+		uint8x16x3_t result;
+		result.val[0] = pixels.val[R];
+		result.val[1] = pixels.val[G];
+		result.val[2] = pixels.val[B];
+		vst3q_u8(destination + pixel * 3, result);
+	}
+	shrinkToThreeBytes<R, G, B>(transcoder, source + pixel * 4, destination + pixel * 3, numPixels - pixel);
+}
+#endif
+
+////////////////////////////////////////////// Half float kernels //////////////////////////////////////////////
+// Both convert numPixels * the number of channels values.
+void halvesToFloats(const Transcoder& transcoder, const uint8_t* source, uint8_t* destination, size_t numPixels)
+{
+	const size_t numValues = numPixels * transcoder.source.numChannels;
+	for (size_t value = 0; value < numValues; ++value)
+	{
+		uint16_t half;
+		memcpy(&half, source + value * 2, 2);
+		const float result = impl::halfToFloat(half);
+		memcpy(destination + value * 4, &result, 4);
+	}
+}
+
+void floatsToHalves(const Transcoder& transcoder, const uint8_t* source, uint8_t* destination, size_t numPixels)
+{
+	const size_t numValues = numPixels * transcoder.source.numChannels;
+	for (size_t value = 0; value < numValues; ++value)
+	{
+		float single;
+		memcpy(&single, source + value * 4, 4);
+		const uint16_t result = impl::floatToHalf(single);
+		memcpy(destination + value * 2, &result, 2);
+	}
+}
+
+#if defined(PVR_TRANSCODE_SSE2)
+// Integer reimplementations of the scalar conversions, exact for all values as long as denormals are not flushed to zero by the floating point unit.
+inline __m128 halvesToFloatsSse2(__m128i halves)
+{
+	const __m128i exponentMantissa = _mm_and_si128(halves, _mm_set1_epi32(0x7fff));
+	const __m128i sign = _mm_slli_epi32(_mm_xor_si128(halves, exponentMantissa), 16);
+	// Rescaling the shifted bits by 2^112 fixes the exponent bias, and normalizes denormals.
+	const __m128 scaled = _mm_mul_ps(_mm_castsi128_ps(_mm_slli_epi32(exponentMantissa, 13)), _mm_castsi128_ps(_mm_set1_epi32(239 << 23)));
+	const __m128i isInfinityOrNan = _mm_cmpgt_epi32(exponentMantissa, _mm_set1_epi32(0x7bff));
+	const __m128i infinityOrNanExponent = _mm_and_si128(isInfinityOrNan, _mm_set1_epi32(255 << 23));
+	return _mm_or_ps(scaled, _mm_castsi128_ps(_mm_or_si128(sign, infinityOrNanExponent)));
+}
+
+inline __m128i floatsToHalvesSse2(__m128 floats)
+{
+	const __m128i bits = _mm_castps_si128(floats);
+	const __m128i sign = _mm_and_si128(bits, _mm_set1_epi32(static_cast<int32_t>(0x80000000)));
+	const __m128i magnitude = _mm_xor_si128(bits, sign);
+	const __m128i isNan = _mm_cmpgt_epi32(magnitude, _mm_set1_epi32(0x7f800000));
+	const __m128i isFinite = _mm_cmplt_epi32(magnitude, _mm_set1_epi32(0x477ff000)); // Below 65520, which rounds to infinity
+	const __m128i isDenormal = _mm_cmplt_epi32(magnitude, _mm_set1_epi32(113 << 23));
+	const __m128i infinityOrNan = _mm_or_si128(_mm_set1_epi32(0x7c00), _mm_and_si128(isNan, _mm_set1_epi32(0x200)));
+	// Denormals: adding 0.5 lines the half mantissa up with the least significant bits of the float mantissa, with the rounding done by the addition.
+	const __m128i denormalMagic = _mm_set1_epi32(126 << 23);
+	const __m128i denormal = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(magnitude), _mm_castsi128_ps(denormalMagic))), denormalMagic);
+	// Normals: round to nearest even by adding 0xfff plus the lowest kept mantissa bit, then rebias the exponent.
+	const __m128i mantissaOdd = _mm_and_si128(_mm_srli_epi32(magnitude, 13), _mm_set1_epi32(1));
+	const __m128i rounded = _mm_add_epi32(_mm_add_epi32(magnitude, _mm_set1_epi32(0xfff - (112 << 23))), mantissaOdd);
+	const __m128i normal = _mm_srli_epi32(rounded, 13);
+	const __m128i finite = _mm_or_si128(_mm_and_si128(isDenormal, denormal), _mm_andnot_si128(isDenormal, normal));
+	const __m128i result = _mm_or_si128(_mm_and_si128(isFinite, finite), _mm_andnot_si128(isFinite, infinityOrNan));
+	return _mm_or_si128(result, _mm_srli_epi32(sign, 16));
+}
+
+void halvesToFloatsSimd(const Transcoder& transcoder, const uint8_t* source, uint8_t* destination, size_t numPixels)
+{
+	const size_t numValues = numPixels * transcoder.source.numChannels;
+	const __m128i zero = _mm_setzero_si128();
+	size_t value = 0;
+	for (; value + 8 <= numValues; value += 8)
+	{
+		const __m128i halves = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + value * 2));
+		_mm_storeu_ps(reinterpret_cast<float*>(destination + value * 4), halvesToFloatsSse2(_mm_unpacklo_epi16(halves, zero)));
+		_mm_storeu_ps(reinterpret_cast<float*>(destination + value * 4 + 16), halvesToFloatsSse2(_mm_unpackhi_epi16(halves, zero)));
+	}
+	for (; value < numValues; ++value)
+	{
+		uint16_t half;
+		memcpy(&half, source + value * 2, 2);
+		const float result = impl::halfToFloat(half);
+		memcpy(destination + value * 4, &result, 4);
+	}
+}
+
+void floatsToHalvesSimd(const Transcoder& transcoder, const uint8_t* source, uint8_t* destination, size_t numPixels)
+{
+	const size_t numValues = numPixels * transcoder.source.numChannels;
+	size_t value = 0;
+	for (; value + 8 <= numValues; value += 8)
+	{
+		const __m128i low = floatsToHalvesSse2(_mm_loadu_ps(reinterpret_cast<const float*>(source + value * 4)));
+		const __m128i high = floatsToHalvesSse2(_mm_loadu_ps(reinterpret_cast<const float*>(source + value * 4 + 16)));
+		// Sign extend the 16 bit results so that the saturating pack keeps them intact.
+		const __m128i packed = _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(low, 16), 16), _mm_srai_epi32(_mm_slli_epi32(high, 16), 16));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + value * 2), packed);
+	}
+	for (; value < numValues; ++value)
+	{
+		float single;
+		memcpy(&single, source + value * 4, 4);
+		const uint16_t result = impl::floatToHalf(single);
+		memcpy(destination + value * 2, &result, 2);
+	}
+}
+#elif defined(PVR_TRANSCODE_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+// The hardware conversions. Unlike the scalar ones, they keep the payload of NaNs.
+void halvesToFloatsSimd(const Transcoder& transcoder, const uint8_t* source, uint8_t* destination, size_t numPixels)
+{
+	const size_t numValues = numPixels * transcoder.source.numChannels;
+	size_t value = 0;
+	for (; value + 4 <= numValues; value += 4)
+	{ vst1q_f32(reinterpret_cast<float*>(destination + value * 4), vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(reinterpret_cast<const uint16_t*>(source + value * 2))))); }
+	for (; value < numValues; ++value)
+	{
+		uint16_t half;
+		memcpy(&half, source + value * 2, 2);
+		const float result = impl::halfToFloat(half);
+		memcpy(destination + value * 4, &result, 4);
+	}
+}
+
+void floatsToHalvesSimd(const Transcoder& transcoder, const uint8_t* source, uint8_t* destination, size_t numPixels)
+{
+	const size_t numValues = numPixels * transcoder.source.numChannels;
+	size_t value = 0;
+	for (; value + 4 <= numValues; value += 4)
+	{ vst1_u16(reinterpret_cast<uint16_t*>(destination + value * 2), vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(reinterpret_cast<const float*>(source + value * 4))))); }
+	for (; value < numValues; ++value)
+	{
+		float single;
+		memcpy(&single, source + value * 4, 4);
+		const uint16_t result = impl::floatToHalf(single);
+		memcpy(destination + value * 2, &result, 2);
+	}
+}
+#define PVR_TRANSCODE_HALF_SIMD 1
+#endif
+#if defined(PVR_TRANSCODE_SSE2)
+#define PVR_TRANSCODE_HALF_SIMD 1
+#endif
+
+////////////////////////////////////////////// Kernel selection //////////////////////////////////////////////
+bool isGammaChannel(const PixelChannel& channel) { return channel.name == 'r' || channel.name == 'g' || channel.name == 'b' || channel.name == 'l' || channel.name == 'i'; }
+
+bool areAllChannels(const PixelLayout& layout, PixelLayout::Type type, uint32_t bits)
+{
+	if (layout.type != type) { return false; }
+	for (uint32_t channel = 0; channel < layout.numChannels; ++channel)
+	{
+		if (layout.channels[channel].bits != bits) { return false; }
+	}
+	return true;
+}
+
+bool isGammaConverted(const PixelLayout& layout)
+{
+	for (uint32_t channel = 0; channel < layout.numChannels; ++channel)
+	{
+		if (layout.channels[channel].isGammaConverted) { return true; }
+	}
+	return false;
+}
+
+// Formats of 8 bit channels of the same kind only need their bytes shuffled, plus a table lookup for colour space conversions.
+bool selectByteKernel(Transcoder& transcoder, bool allowSimd)
+{
+	const PixelLayout& source = transcoder.source;
+	const PixelLayout& destination = transcoder.destination;
+	if (!areAllChannels(source, PixelLayout::Consecutive, 8) || !areAllChannels(destination, PixelLayout::Consecutive, 8) || source.kind != destination.kind) { return false; }
+	const bool useTables = isGammaConverted(source) || isGammaConverted(destination);
+	if (useTables && source.kind != ChannelKind::UnsignedNorm) { return false; }
+
+	transcoder.byteOne = source.kind == ChannelKind::UnsignedNorm ? 255 : source.kind == ChannelKind::SignedNorm ? 127 : 1;
+	for (uint32_t channel = 0; channel < destination.numChannels; ++channel)
+	{
+		const int32_t component = destination.channels[channel].encodeSource;
+		int32_t& byteSource = transcoder.byteSources[channel];
+		byteSource = component == 3 ? BYTE_ONE : BYTE_ZERO;
+		if (component < 0)
+		{
+			byteSource = BYTE_ZERO;
+			continue;
+		}
+		for (uint32_t sourceChannel = 0; sourceChannel < source.numChannels; ++sourceChannel)
+		{
+			// The last channel wins, like in decodePixels.
+			if (source.channels[sourceChannel].decodeTargets & (1u << component)) { byteSource = static_cast<int32_t>(sourceChannel); }
+		}
+	}
+
+	if (useTables)
+	{
+		const impl::SrgbTables& srgb = impl::getSrgbTables();
+		for (uint32_t channel = 0; channel < destination.numChannels; ++channel)
+		{
+			const int32_t byteSource = transcoder.byteSources[channel];
+			const bool isSourceGamma = byteSource >= 0 && source.channels[byteSource].isGammaConverted;
+			const bool isDestinationGamma = destination.channels[channel].isGammaConverted && byteSource >= 0;
+			for (uint32_t value = 0; value < 256; ++value)
+			{
+				const float linear = isSourceGamma ? srgb.toLinear[value] : value / 255.f;
+				transcoder.byteTables[channel][value] = isDestinationGamma ? srgb.encode(linear) : static_cast<uint8_t>(linear * 255.f + .5f);
+			}
+		}
+		transcoder.kernel = shuffleBytes<true>;
+		return true;
+	}
+
+	const int32_t* byteSources = transcoder.byteSources;
+	transcoder.kernel = shuffleBytes<false>;
+	if (source.bytesPerPixel == 4 && destination.bytesPerPixel == 4 && byteSources[0] == 2 && byteSources[1] == 1 && byteSources[2] == 0 && byteSources[3] == 3)
+	{ transcoder.kernel = swapRedBlue; }
+	else if (source.bytesPerPixel == 3 && destination.bytesPerPixel == 4 && byteSources[1] == 1 && byteSources[3] == BYTE_ONE)
+	{
+		if (byteSources[0] == 0 && byteSources[2] == 2) { transcoder.kernel = expandToFourBytes<0, 1, 2>; }
+		else if (byteSources[0] == 2 && byteSources[2] == 0)
+		{
+			transcoder.kernel = expandToFourBytes<2, 1, 0>;
+		}
+	}
+	else if (source.bytesPerPixel == 4 && destination.bytesPerPixel == 3 && byteSources[1] == 1)
+	{
+		if (byteSources[0] == 0 && byteSources[2] == 2) { transcoder.kernel = shrinkToThreeBytes<0, 1, 2>; }
+		else if (byteSources[0] == 2 && byteSources[2] == 0)
+		{
+			transcoder.kernel = shrinkToThreeBytes<2, 1, 0>;
+		}
+	}
+#if defined(PVR_TRANSCODE_SSE2) || defined(PVR_TRANSCODE_NEON)
+	if (allowSimd)
+	{
+		if (transcoder.kernel == swapRedBlue) { transcoder.kernel = swapRedBlueSimd; }
+#if defined(PVR_TRANSCODE_SSSE3) || defined(PVR_TRANSCODE_NEON)
+		if (transcoder.kernel == expandToFourBytes<0, 1, 2>) { transcoder.kernel = expandToFourBytesSimd<0, 1, 2>; }
+		if (transcoder.kernel == expandToFourBytes<2, 1, 0>) { transcoder.kernel = expandToFourBytesSimd<2, 1, 0>; }
+		if (transcoder.kernel == shrinkToThreeBytes<0, 1, 2>) { transcoder.kernel = shrinkToThreeBytesSimd<0, 1, 2>; }
+		if (transcoder.kernel == shrinkToThreeBytes<2, 1, 0>) { transcoder.kernel = shrinkToThreeBytesSimd<2, 1, 0>; }
+#endif
+	}
+#else
+	(void)allowSimd;
+#endif
+	return true;
+}
+
+// Half and single precision floats with the same channels convert value by value.
+bool selectHalfKernel(Transcoder& transcoder, bool allowSimd)
+{
+	const PixelLayout& source = transcoder.source;
+	const PixelLayout& destination = transcoder.destination;
+	const bool isSourceFloat = source.kind == ChannelKind::Float || source.kind == ChannelKind::UnsignedFloat;
+	if (!isSourceFloat || source.numChannels != destination.numChannels || isGammaConverted(source) || isGammaConverted(destination)) { return false; }
+	// Negative values would need clamping.
+	if (destination.kind != ChannelKind::Float && (destination.kind != ChannelKind::UnsignedFloat || source.kind != ChannelKind::UnsignedFloat)) { return false; }
+	for (uint32_t channel = 0; channel < source.numChannels; ++channel)
+	{
+		if (source.channels[channel].name != destination.channels[channel].name || source.channels[channel].name == 'x') { return false; }
+	}
+	const bool isHalfToFloat = areAllChannels(source, PixelLayout::Consecutive, 16) && areAllChannels(destination, PixelLayout::Consecutive, 32);
+	const bool isFloatToHalf = areAllChannels(source, PixelLayout::Consecutive, 32) && areAllChannels(destination, PixelLayout::Consecutive, 16);
+	if (!isHalfToFloat && !isFloatToHalf) { return false; }
+	transcoder.kernel = isHalfToFloat ? halvesToFloats : floatsToHalves;
+#if defined(PVR_TRANSCODE_HALF_SIMD)
+	if (allowSimd) { transcoder.kernel = isHalfToFloat ? halvesToFloatsSimd : floatsToHalvesSimd; }
+#else
+	(void)allowSimd;
+#endif
+	return true;
+}
+
+void setupTranscoder(Transcoder& transcoder, const PixelFormat& srcFormat, VariableType srcChannelType, ColorSpace srcColorSpace, const PixelFormat& dstFormat,
+	VariableType dstChannelType, ColorSpace dstColorSpace, bool allowSimd)
+{
+	if (!getPixelLayout(srcFormat, srcChannelType, transcoder.source))
+	{ throw InvalidArgumentError("srcFormat", "[transcodePixels]: Cannot transcode from " + to_string(srcFormat) + " (" + to_string(srcChannelType) + ")"); }
+	if (!getPixelLayout(dstFormat, dstChannelType, transcoder.destination))
+	{ throw InvalidArgumentError("dstFormat", "[transcodePixels]: Cannot transcode to " + to_string(dstFormat) + " (" + to_string(dstChannelType) + ")"); }
+
+	PixelLayout& source = transcoder.source;
+	PixelLayout& destination = transcoder.destination;
+	if (srcColorSpace != dstColorSpace)
+	{
+		PixelLayout& encoded = srcColorSpace == ColorSpace::sRGB ? source : destination;
+		for (uint32_t channel = 0; channel < encoded.numChannels; ++channel) { encoded.channels[channel].isGammaConverted = isGammaChannel(encoded.channels[channel]); }
+	}
+
+	// Decoding tables for small integer channels.
+	const impl::SrgbTables& srgb = impl::getSrgbTables();
+	for (uint32_t channel = 0; channel < MAX_CHANNELS; ++channel)
+	{
+		const PixelChannel& pixelChannel = source.channels[channel];
+		const bool isInteger = source.kind != ChannelKind::Float && source.kind != ChannelKind::UnsignedFloat;
+		transcoder.hasDecodeTable[channel] = channel < source.numChannels && source.type != PixelLayout::SharedExponent && isInteger && pixelChannel.bits <= 8;
+		if (!transcoder.hasDecodeTable[channel]) { continue; }
+		for (uint32_t raw = 0; raw <= getChannelMask(pixelChannel.bits); ++raw)
+		{
+			float value = decodeValue(raw, source.kind, pixelChannel.bits);
+			if (pixelChannel.isGammaConverted) { value = pixelChannel.bits == 8 && source.kind == ChannelKind::UnsignedNorm ? srgb.toLinear[raw] : impl::srgbToLinear(value); }
+			transcoder.decodeTables[channel][raw] = value;
+		}
+	}
+
+	if (srcFormat == dstFormat && srcChannelType == dstChannelType && !isGammaConverted(source) && !isGammaConverted(destination))
+	{
+		transcoder.kernel = copyPixels;
+		return;
+	}
+	if (selectByteKernel(transcoder, allowSimd) || selectHalfKernel(transcoder, allowSimd)) { return; }
+	transcoder.kernel = transcodeThroughFloats;
+}
+} // namespace
+
+bool isTranscodingSupported(const PixelFormat& format, VariableType channelType)
+{
+	PixelLayout layout;
+	return getPixelLayout(format, channelType, layout);
+}
+
+bool getLosslessRgbaFormat(const PixelFormat& format, VariableType channelType, ColorSpace colorSpace, PixelFormat& outFormat, VariableType& outChannelType)
+{
+	const PixelFormat rgba8 = GeneratePixelType4<'r', 'g', 'b', 'a', 8, 8, 8, 8>::ID;
+	const PixelFormat rgba16 = GeneratePixelType4<'r', 'g', 'b', 'a', 16, 16, 16, 16>::ID;
+	const PixelFormat rgba32 = GeneratePixelType4<'r', 'g', 'b', 'a', 32, 32, 32, 32>::ID;
+
+	// The shared exponent format has 9 bit mantissas, which half floats cannot hold for small values.
+	if (format.getPart().High == 0)
+	{
+		if (format.getPixelTypeId() != static_cast<uint64_t>(CompressedPixelFormat::SharedExponentR9G9B9E5)) { return false; }
+		outFormat = rgba32;
+		outChannelType = VariableType::SignedFloat;
+		return true;
+	}
+
+	// Only 8 bit normalized formats have sRGB variants.
+	if (colorSpace == ColorSpace::sRGB && channelType != VariableType::UnsignedByteNorm) { return false; }
+
+	uint32_t minBits = 32, maxBits = 0;
+	for (uint8_t i = 0; i < format.getNumChannels(); ++i)
+	{
+		minBits = std::min<uint32_t>(minBits, format.getChannelBits(i));
+		maxBits = std::max<uint32_t>(maxBits, format.getChannelBits(i));
+	}
+	if (channelType == VariableType::SignedFloat || channelType == VariableType::UnsignedFloat)
+	{
+		// Packed 10 and 11 bit unsigned floats fit in half floats.
+		outFormat = maxBits <= 16 ? rgba16 : rgba32;
+		outChannelType = VariableType::SignedFloat;
+		return maxBits <= 32;
+	}
+	if (static_cast<uint32_t>(channelType) >= static_cast<uint32_t>(VariableType::SignedFloat)) { return false; }
+
+	// The normalized and integer types come in groups of four (unsigned normalized, signed normalized, unsigned, signed) for 8, 16 and 32 bits. There
+	// is no 32 bit normalized format to expand to.
+	const uint32_t kind = static_cast<uint32_t>(channelType) % 4;
+	const bool isNormalized = kind < 2;
+	if (isNormalized && (minBits != maxBits || (maxBits != 8 && maxBits != 16))) { return false; }
+	if (maxBits <= 8) { outFormat = rgba8; }
+	else if (maxBits <= 16) { outFormat = rgba16; }
+	else if (maxBits <= 32) { outFormat = rgba32; }
+	else
+	{
+		return false;
+	}
+	outChannelType = static_cast<VariableType>((maxBits <= 8 ? 0 : maxBits <= 16 ? 4 : 8) + kind);
+	return true;
+}
+
+void transcodePixels(const void* srcData, const PixelFormat& srcFormat, VariableType srcChannelType, ColorSpace srcColorSpace, void* dstData, const PixelFormat& dstFormat,
+	VariableType dstChannelType, ColorSpace dstColorSpace, size_t numPixels, const TranscodeOptions& options)
+{
+	Transcoder transcoder;
+	setupTranscoder(transcoder, srcFormat, srcChannelType, srcColorSpace, dstFormat, dstChannelType, dstColorSpace, options.allowSimd);
+	if (!numPixels) { return; }
+
+	const uint8_t* source = static_cast<const uint8_t*>(srcData);
+	uint8_t* destination = static_cast<uint8_t*>(dstData);
+	const size_t numChunks = (numPixels + PIXELS_PER_CHUNK - 1) / PIXELS_PER_CHUNK;
+	const uint32_t numThreads = impl::getDecompressionThreadCount(options.maxThreads, static_cast<uint32_t>(std::min<size_t>(numChunks, 0x7fffffff)), MIN_CHUNKS_PER_THREAD);
+	if (numThreads == 1)
+	{
+		transcoder.kernel(transcoder, source, destination, numPixels);
+		return;
+	}
+	impl::parallelForBands(0, static_cast<int32_t>(numChunks), numThreads, [&](int32_t firstChunk, int32_t lastChunk) {
+		const size_t firstPixel = static_cast<size_t>(firstChunk) * PIXELS_PER_CHUNK;
+		const size_t lastPixel = std::min(numPixels, static_cast<size_t>(lastChunk) * PIXELS_PER_CHUNK);
+		transcoder.kernel(transcoder, source + firstPixel * transcoder.source.bytesPerPixel, destination + firstPixel * transcoder.destination.bytesPerPixel, lastPixel - firstPixel);
+	}, options.jobSystem);
+}
+
+Texture transcodeTexture(const Texture& texture, const PixelFormat& format, VariableType channelType, ColorSpace colorSpace, const TranscodeOptions& options)
+{
+	if (!isTranscodingSupported(texture.getPixelFormat(), texture.getChannelType()))
+	{
+		throw InvalidArgumentError(
+			"texture", "[transcodeTexture]: Cannot transcode from " + to_string(texture.getPixelFormat()) + " (" + to_string(texture.getChannelType()) + ")");
+	}
+	if (texture.getNumPlanes() > 1) { throw InvalidArgumentError("texture", "[transcodeTexture]: Multi-planar textures cannot be transcoded"); }
+	TextureHeader header(texture);
+	header.setPixelFormat(format);
+	header.setChannelType(channelType);
+	header.setColorSpace(colorSpace);
+	Texture result(header);
+
+	// The pixels of all the surfaces of uncompressed textures are tightly packed, so they can be transcoded in one go.
+	const size_t numPixels = texture.getDataSize() / (texture.getPixelFormat().getBitsPerPixel() / 8);
+	transcodePixels(texture.getDataPointer(), texture.getPixelFormat(), texture.getChannelType(), texture.getColorSpace(), result.getDataPointer(), format, channelType, colorSpace,
+		numPixels, options);
+	return result;
+}
+} // namespace pvr
+//!\endcond
@@ -0,0 +1,74 @@
+/*!
+\brief Contains functions to convert uncompressed pixel data between pixel formats, channel types and colour spaces.
+\file PVRCore/texture/PixelFormatTranscoder.h
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+#pragma once
+#include "PVRCore/texture/Texture.h"
+namespace pvr {
+namespace async {
+class JobSystem;
+}
+
+/// <summary>Controls how the pixel format transcoder executes. The defaults use one thread per hardware thread and the SIMD kernels if the build target
+/// supports them.</summary>
+struct TranscodeOptions
+{
+	uint32_t maxThreads; ///< The maximum number of threads to transcode with. 0 uses one thread per hardware thread, 1 transcodes on the calling thread.
+	bool allowSimd; ///< Set to false to force the scalar kernels, for example to validate the output of the vectorized ones.
+	async::JobSystem* jobSystem; ///< Optional. If not null, the work is spread over the workers of this job system instead of threads created for each call.
+
+	/// <summary>Constructor. Defaults to all hardware threads, SIMD kernels enabled and no job system.</summary>
+	TranscodeOptions() : maxThreads(0), allowSimd(true), jobSystem(nullptr) {}
+};
+
+/// <summary>Query whether pixels of a format can be transcoded from or to. Supported are the uncompressed formats of whole bytes per pixel whose
+/// channels are either consecutive 8, 16 or 32 bit values of the channel type, or bit fields of a single 8, 16 or 32 bit little endian word (with the
+/// first channel in the most significant bits, e.g. r5g6b5 or a2b10g10r10), and the shared exponent format R9G9B9E5. Float channels may be 16 or 32 bits,
+/// or 10 and 11 bits unsigned floats in packed formats (e.g. b10g11r11).</summary>
+/// <param name="format">The pixel format</param>
+/// <param name="channelType">The channel type of the pixels</param>
+/// <returns>True if transcodePixels and transcodeTexture can convert from and to this format, otherwise false</returns>
+bool isTranscodingSupported(const PixelFormat& format, VariableType channelType);
+
+/// <summary>Find the RGBA format with the same kind of channels (unsigned or signed normalized, unsigned or signed integer, or float) as an
+/// uncompressed format, that represents every value of the original format exactly. Used to convert formats that an API cannot sample (such as 24 bit
+/// RGB) without changing their values. Integer formats are never turned into float or normalized ones, as shaders read them with different sampler
+/// types, and normalized channels are never resized, as that changes their values slightly. R9G9B9E5 is expanded to 32 bit floats.</summary>
+/// <param name="format">The pixel format</param>
+/// <param name="channelType">The channel type of the pixels</param>
+/// <param name="colorSpace">The colour space of the pixels. Only 8 bit normalized formats can be sRGB.</param>
+/// <param name="outFormat">The RGBA format (8, 16 or 32 bits per channel). Unchanged if there is none.</param>
+/// <param name="outChannelType">The channel type of the RGBA format. Unchanged if there is none.</param>
+/// <returns>True if there is such a format, otherwise false</returns>
+bool getLosslessRgbaFormat(const PixelFormat& format, VariableType channelType, ColorSpace colorSpace, PixelFormat& outFormat, VariableType& outChannelType);
+
+/// <summary>Converts pixels from one format to another. Channels are matched by name: luminance and intensity are read into red, green and blue (and
+/// alpha for intensity) and are written from red, depth and stencil are treated as red and green, and channels missing from the source are 0, except
+/// alpha which is 1. Normalized values are rounded to nearest and clamped to the range of the destination, and integer channels are converted as
+/// numbers (255 as an UnsignedByte becomes 255.0 as a float, or 1 as a normalized value). If the colour spaces differ, the colour channels are
+/// converted between sRGB and linear; alpha never is. Common conversions between 8 bit formats (e.g. RGBA8 to BGRA8, RGB8 to RGBA8) and between
+/// half and single precision floats use dedicated, vectorized kernels; the rest go through an intermediate float per channel.</summary>
+/// <param name="srcData">The source pixels</param>
+/// <param name="srcFormat">The pixel format of the source. Must be supported (see isTranscodingSupported), otherwise throws InvalidArgumentError.</param>
+/// <param name="srcChannelType">The channel type of the source</param>
+/// <param name="srcColorSpace">The colour space of the source</param>
+/// <param name="dstData">The destination. Must hold numPixels pixels of the destination format, and must not overlap the source.</param>
+/// <param name="dstFormat">The pixel format of the destination. Must be supported, otherwise throws InvalidArgumentError.</param>
+/// <param name="dstChannelType">The channel type of the destination</param>
+/// <param name="dstColorSpace">The colour space of the destination</param>
+/// <param name="numPixels">The number of pixels to convert</param>
+/// <param name="options">Threading and kernel selection options</param>
+void transcodePixels(const void* srcData, const PixelFormat& srcFormat, VariableType srcChannelType, ColorSpace srcColorSpace, void* dstData, const PixelFormat& dstFormat,
+	VariableType dstChannelType, ColorSpace dstColorSpace, size_t numPixels, const TranscodeOptions& options = TranscodeOptions());
+
+/// <summary>Creates a copy of a texture in a different format, converting every MIP map level, array member, face and depth slice with transcodePixels.</summary>
+/// <param name="texture">The texture to convert. Its format must be supported (see isTranscodingSupported), otherwise throws InvalidArgumentError.</param>
+/// <param name="format">The pixel format of the new texture</param>
+/// <param name="channelType">The channel type of the new texture</param>
+/// <param name="colorSpace">The colour space of the new texture</param>
+/// <param name="options">Threading and kernel selection options</param>
+/// <returns>The converted texture, with the same dimensions, MIP map levels and metadata as the original one.</returns>
+Texture transcodeTexture(const Texture& texture, const PixelFormat& format, VariableType channelType, ColorSpace colorSpace, const TranscodeOptions& options = TranscodeOptions());
+} // namespace pvr
@@ -23,6 +23,7 @@ TextureFileFormat getTextureFormatFromFilename(const char* assetname)
 		if (!s.compare("pvr")) { return TextureFileFormat::PVR; }
 		if (!s.compare("tga")) { return TextureFileFormat::TGA; }
 		if (!s.compare("ktx")) { return TextureFileFormat::KTX; }
+		if (!s.compare("ktx2")) { return TextureFileFormat::KTX2; }
 		if (!s.compare("bmp")) { return TextureFileFormat::BMP; }
 		if (!s.compare("dds")) { return TextureFileFormat::DDS; }
 		if (!s.compare("ddx")) { return TextureFileFormat::DDX; }
@@ -36,6 +37,8 @@ Texture::Texture() { _pTextureData.resize(getDataSize()); }
 
 Texture::Texture(const TextureHeader& sHeader, const unsigned char* pData) : TextureHeader(sHeader)
 {
+	// Readers fill in the header members directly, so make sure the lookups of this texture are constant time.
+	updateDataLayout();
 	uint32_t sizeOfData = getDataSize();
 	// Allocate new memory for the texture.
 	_pTextureData.resize(sizeOfData);
@@ -44,13 +47,29 @@ Texture::Texture(const TextureHeader& sHeader, const unsigned char* pData) : Tex
 	if (pData && sizeOfData) { memcpy(_pTextureData.data(), pData, sizeOfData); }
 }
 
+Texture::Texture(const TextureHeader& sHeader, std::shared_ptr<const unsigned char> externalData) : TextureHeader(sHeader), _externalData(std::move(externalData))
+{
+	updateDataLayout();
+	if (!_externalData) { _pTextureData.resize(getDataSize()); }
+}
+
 void Texture::initializeWithHeader(const TextureHeader& sHeader)
 {
-	*this = sHeader;
+	// Assign the header part only. Assigning sHeader to *this would construct (and allocate the data of) a temporary Texture.
+	static_cast<TextureHeader&>(*this) = sHeader;
+	updateDataLayout();
+	_externalData.reset();
 	// Get the data size from the newly attached header.
 	_pTextureData.resize(getDataSize());
 }
 
+void Texture::detachExternalData()
+{
+	if (!_externalData) { return; }
+	_pTextureData.assign(_externalData.get(), _externalData.get() + getDataSize());
+	_externalData.reset();
+}
+
 const unsigned char* Texture::getDataPointer(uint32_t mipMapLevel /*= 0*/, uint32_t arrayMember /*= 0*/, uint32_t face /*= 0*/, uint32_t plane /*= 0*/) const
 {
 	if ((static_cast<int32_t>(mipMapLevel) == pvrTextureAllMipMaps) || mipMapLevel >= getNumMipMapLevels())
@@ -58,57 +77,28 @@ const unsigned char* Texture::getDataPointer(uint32_t mipMapLevel /*= 0*/, uint3
 	if (arrayMember >= getNumArrayMembers()) { throw InvalidArgumentError("arrayMember", "Texture::getDataPointer: Specified array member did not exist"); }
 	if (face >= getNumFaces()) { throw InvalidArgumentError("face", "Texture::getDataPointer: Specified face did not exist"); }
 	if (plane >= getNumPlanes()) { throw InvalidArgumentError("plane", "Texture::getDataPointer: Specified plane did not exist"); }
-	uint32_t offSet = 0;
-	// File is organised by MIP Map levels, then surfaces, then faces, then planes.
-
-	// Get the start of the MIP level.
-	if (mipMapLevel != 0)
-	{
-		// Get the size for all MIP Map levels up to this one.
-		for (uint32_t uiCurrentMipMap = 0; uiCurrentMipMap < mipMapLevel; ++uiCurrentMipMap) { offSet += getDataSize(static_cast<int32_t>(uiCurrentMipMap), true, true, true); }
-	}
 
-	// Get the start of the array.
-	if (arrayMember != 0) { offSet += arrayMember * getDataSize(static_cast<int32_t>(mipMapLevel), false, true, true); }
-
-	// Get the start of the face.
-	if (face != 0) { offSet += face * getDataSize(static_cast<int32_t>(mipMapLevel), false, false, true); }
-
-	// Get the total size of the previous planes.
-	while (plane > 0) { offSet += getDataSize(static_cast<int32_t>(mipMapLevel), false, false, false, --plane); }
+	// File is organised by MIP Map levels, then surfaces, then faces, then planes.
+	const ptrdiff_t offSet = getDataOffset(mipMapLevel, arrayMember, face, plane);
 
 	// Return the data pointer plus whatever offSet has been specified.
+	if (_externalData) { return _externalData.get() + offSet; }
 	return &_pTextureData[offSet];
 }
 
 unsigned char* Texture::getDataPointer(uint32_t mipMapLevel /*= 0*/, uint32_t arrayMember /*= 0*/, uint32_t face /*= 0*/, uint32_t plane /*= 0*/)
 {
-	// Initialize the offSet value.
-	uint32_t offSet = 0;
+	// The caller may modify the data, so it must be owned by the texture.
+	detachExternalData();
 
-	// Error checking
 	if ((static_cast<int32_t>(mipMapLevel) == pvrTextureAllMipMaps) || mipMapLevel >= getNumMipMapLevels())
 	{ throw InvalidArgumentError("mipmapLevel", "Texture::getDataPointer: Specified mipmap level did not exist"); }
 	if (arrayMember >= getNumArrayMembers()) { throw InvalidArgumentError("arrayMember", "Texture::getDataPointer: Specified array member did not exist"); }
 	if (face >= getNumFaces()) { throw InvalidArgumentError("face", "Texture::getDataPointer: Specified face did not exist"); }
 	if (plane >= getNumPlanes()) { throw InvalidArgumentError("plane", "Texture::getDataPointer: Specified plane did not exist"); }
-	// File is organised by MIP Map levels, then surfaces, then faces.
 
-	// Get the start of the MIP level.
-	if (mipMapLevel != 0)
-	{
-		// Get the size for all MIP Map levels up to this one.
-		for (uint32_t uiCurrentMipMap = 0; uiCurrentMipMap < mipMapLevel; ++uiCurrentMipMap) { offSet += getDataSize(static_cast<int32_t>(uiCurrentMipMap), true, true, true); }
-	}
-
-	// Get the start of the array.
-	if (arrayMember != 0) { offSet += arrayMember * getDataSize(mipMapLevel, false, true, true); }
-
-	// Get the start of the face.
-	if (face != 0) { offSet += face * getDataSize(mipMapLevel, false, false, true); }
-
-	// Get the start of the plane.
-	if (plane != 0) { offSet += plane * getDataSize(mipMapLevel, false, false, false, plane); }
+	// File is organised by MIP Map levels, then surfaces, then faces, then planes.
+	const ptrdiff_t offSet = getDataOffset(mipMapLevel, arrayMember, face, plane);
 
 	// Return the data pointer plus whatever offSet has been specified.
 	return &_pTextureData[offSet];
@@ -8,6 +8,7 @@
 #include "PVRCore/Errors.h"
 #include "PVRCore/texture/TextureHeader.h"
 #include <cmath>
+#include <memory>
 
 namespace pvr {
 
@@ -544,7 +545,20 @@ enum class TextureFileFormat
 	TGA,
 	BMP,
 	DDS,
-	JPEG
+	JPEG,
+	KTX2
+};
+
+/// <summary>Options controlling how the texture readers load the data of a texture from a stream.</summary>
+struct TextureLoadOptions
+{
+	/// <summary>The maximum number of threads used to read the surfaces (mip levels, array members and faces) of a texture. 1 reads everything
+	/// sequentially on the calling thread. 0 uses one thread per hardware thread. Parallel reads are only used with streams that support concurrent
+	/// positional reads (see Stream::supportsConcurrentReads), otherwise the data is read sequentially regardless.</summary>
+	uint32_t maxThreads;
+
+	/// <summary>Constructor. Defaults to reading sequentially on the calling thread.</summary>
+	TextureLoadOptions() : maxThreads(1) {}
 };
 
 /// <summary>A 2D Texture asset, together with Information, Metadata and actual Pixel data. Only represents the
@@ -564,6 +578,15 @@ public:
 	/// header, the behaviour is undefined.</remarks>
 	Texture(const TextureHeader& sHeader, const unsigned char* pData = NULL);
 
+	/// <summary>Create a texture using the information from a Texture header that references, instead of copying, externally owned data
+	/// (for example, a memory mapped file, see Stream::getSharedDataPointer).</summary>
+	/// <param name="sHeader">A texture header describing the texture</param>
+	/// <param name="externalData">Pointer to memory containing the actual data. The texture shares ownership of it, so it stays valid for the
+	/// lifetime of the texture (and any copies of it). Must contain at least as much data as is dictated by the texture header.</param>
+	/// <remarks>The data is treated as read only: the first call to the non-const getDataPointer will copy it into memory owned by the
+	/// texture.</remarks>
+	Texture(const TextureHeader& sHeader, std::shared_ptr<const unsigned char> externalData);
+
 	/// <summary>Create a texture using the information from a Texture header and preallocate memory for its data.
 	///</summary>
 	/// <param name="sHeader">A texture header describing the texture</param>
@@ -676,8 +699,17 @@ public:
 	///</remarks>
 	void addPaddingMetaData(uint32_t alignment);
 
+	/// <summary>Check if this texture references externally owned data instead of owning a copy of it (see the constructor that takes
+	/// externalData).</summary>
+	/// <returns>True if the data of the texture is externally owned, otherwise false</returns>
+	bool isDataExternal() const { return _externalData != nullptr; }
+
 private:
+	// If the texture references external data, copy it into memory owned by the texture so that it can be modified.
+	void detachExternalData();
+
 	std::vector<unsigned char> _pTextureData; // Pointer to texture data.
+	std::shared_ptr<const unsigned char> _externalData; // Externally owned texture data. If set, used instead of _pTextureData.
 };
 
 /// <summary>Infer the texture format from a filename.</summary>
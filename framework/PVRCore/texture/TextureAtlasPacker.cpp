@@ -0,0 +1,238 @@
+/*!
+\brief Implementation of the MaxRects texture atlas packer.
+\file PVRCore/texture/TextureAtlasPacker.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+#include "PVRCore/texture/TextureAtlasPacker.h"
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+
+namespace pvr {
+namespace {
+// The length of the overlap of the segments [start1, end1) and [start2, end2).
+inline int64_t getOverlap(uint32_t start1, uint32_t end1, uint32_t start2, uint32_t end2)
+{
+	return end1 < start2 || end2 < start1 ? 0 : static_cast<int64_t>(std::min(end1, end2)) - static_cast<int64_t>(std::max(start1, start2));
+}
+} // namespace
+
+TextureAtlasPacker::TextureAtlasPacker(uint32_t width, uint32_t height, const AtlasPackerOptions& options) : _options(options) { reset(width, height); }
+
+void TextureAtlasPacker::reset(uint32_t width, uint32_t height)
+{
+	_width = width;
+	_height = height;
+	_freeRects.clear();
+	_usedRects.clear();
+	_usedArea = 0;
+	if (width && height) { _freeRects.push_back(Rect{ 0, 0, width, height }); }
+}
+
+float TextureAtlasPacker::getOccupancy() const
+{
+	const uint64_t atlasArea = static_cast<uint64_t>(_width) * _height;
+	return atlasArea ? static_cast<float>(static_cast<double>(_usedArea) / static_cast<double>(atlasArea)) : 0.f;
+}
+
+int64_t TextureAtlasPacker::getContactScore(const Rect& rect) const
+{
+	int64_t score = 0;
+	if (rect.x == 0 || rect.x + rect.width == _width) { score += rect.height; }
+	if (rect.y == 0 || rect.y + rect.height == _height) { score += rect.width; }
+	for (const Rect& used : _usedRects)
+	{
+		if (used.x == rect.x + rect.width || used.x + used.width == rect.x) { score += getOverlap(used.y, used.y + used.height, rect.y, rect.y + rect.height); }
+		if (used.y == rect.y + rect.height || used.y + used.height == rect.y) { score += getOverlap(used.x, used.x + used.width, rect.x, rect.x + rect.width); }
+	}
+	return score;
+}
+
+bool TextureAtlasPacker::findPosition(uint32_t width, uint32_t height, Placement& outPlacement) const
+{
+	// Lower scores are better.
+	outPlacement.score = std::numeric_limits<int64_t>::max();
+	outPlacement.secondaryScore = std::numeric_limits<int64_t>::max();
+	const uint32_t numOrientations = (_options.allowRotation && width != height) ? 2 : 1;
+	for (const Rect& freeRect : _freeRects)
+	{
+		for (uint32_t orientation = 0; orientation < numOrientations; ++orientation)
+		{
+			const uint32_t w = orientation ? height : width, h = orientation ? width : height;
+			if (w > freeRect.width || h > freeRect.height) { continue; }
+			const int64_t leftoverX = freeRect.width - w, leftoverY = freeRect.height - h;
+			const Rect rect = { freeRect.x, freeRect.y, w, h };
+			int64_t score, secondaryScore;
+			switch (_options.heuristic)
+			{
+			case AtlasPackingHeuristic::BestLongSideFit:
+				score = std::max(leftoverX, leftoverY);
+				secondaryScore = std::min(leftoverX, leftoverY);
+				break;
+			case AtlasPackingHeuristic::BestAreaFit:
+				score = static_cast<int64_t>(freeRect.width) * freeRect.height - static_cast<int64_t>(w) * h;
+				secondaryScore = std::min(leftoverX, leftoverY);
+				break;
+			case AtlasPackingHeuristic::BottomLeft:
+				score = static_cast<int64_t>(rect.y) + h;
+				secondaryScore = rect.x;
+				break;
+			case AtlasPackingHeuristic::ContactPoint:
+				score = -getContactScore(rect);
+				secondaryScore = 0;
+				break;
+			case AtlasPackingHeuristic::BestShortSideFit:
+			default:
+				score = std::min(leftoverX, leftoverY);
+				secondaryScore = std::max(leftoverX, leftoverY);
+				break;
+			}
+			if (score < outPlacement.score || (score == outPlacement.score && secondaryScore < outPlacement.secondaryScore))
+			{
+				outPlacement.rect = rect;
+				outPlacement.isRotated = orientation != 0;
+				outPlacement.score = score;
+				outPlacement.secondaryScore = secondaryScore;
+			}
+		}
+	}
+	return outPlacement.score != std::numeric_limits<int64_t>::max();
+}
+
+void TextureAtlasPacker::place(const Rect& rect)
+{
+	// Replace every free rectangle the new one intersects by the (up to 4) maximal rectangles of what is left of it.
+	const size_t numOldRects = _freeRects.size();
+	std::vector<Rect> newRects;
+	size_t numKept = 0;
+	for (size_t i = 0; i < numOldRects; ++i)
+	{
+		const Rect freeRect = _freeRects[i];
+		if (rect.x >= freeRect.x + freeRect.width || rect.x + rect.width <= freeRect.x || rect.y >= freeRect.y + freeRect.height || rect.y + rect.height <= freeRect.y)
+		{
+			_freeRects[numKept++] = freeRect;
+			continue;
+		}
+		if (rect.x > freeRect.x) { newRects.push_back(Rect{ freeRect.x, freeRect.y, rect.x - freeRect.x, freeRect.height }); }
+		if (rect.x + rect.width < freeRect.x + freeRect.width)
+		{ newRects.push_back(Rect{ rect.x + rect.width, freeRect.y, freeRect.x + freeRect.width - (rect.x + rect.width), freeRect.height }); }
+		if (rect.y > freeRect.y) { newRects.push_back(Rect{ freeRect.x, freeRect.y, freeRect.width, rect.y - freeRect.y }); }
+		if (rect.y + rect.height < freeRect.y + freeRect.height)
+		{ newRects.push_back(Rect{ freeRect.x, rect.y + rect.height, freeRect.width, freeRect.y + freeRect.height - (rect.y + rect.height) }); }
+	}
+	_freeRects.resize(numKept);
+
+	// Only keep maximal rectangles. A new rectangle is part of a rectangle that was maximal, so it cannot contain any of the ones kept; it only needs to
+	// be checked against them and against the other new ones.
+	auto contains = [](const Rect& outer, const Rect& inner) {
+		return inner.x >= outer.x && inner.y >= outer.y && inner.x + inner.width <= outer.x + outer.width && inner.y + inner.height <= outer.y + outer.height;
+	};
+	for (size_t i = 0; i < newRects.size(); ++i)
+	{
+		bool isContained = false;
+		for (size_t j = 0; j < newRects.size() && !isContained; ++j)
+		{
+			// Of two identical rectangles, keep the first.
+			isContained = i != j && contains(newRects[j], newRects[i]) && (j < i || !contains(newRects[i], newRects[j]));
+		}
+		for (size_t j = 0; j < numKept && !isContained; ++j) { isContained = contains(_freeRects[j], newRects[i]); }
+		if (!isContained) { _freeRects.push_back(newRects[i]); }
+	}
+	_usedRects.push_back(rect);
+}
+
+AtlasRect TextureAtlasPacker::toAtlasRect(const Placement& placement) const
+{
+	AtlasRect result;
+	result.x = placement.rect.x + _options.padding;
+	result.y = placement.rect.y + _options.padding;
+	result.width = placement.rect.width - 2 * _options.padding;
+	result.height = placement.rect.height - 2 * _options.padding;
+	result.isRotated = placement.isRotated;
+	return result;
+}
+
+bool TextureAtlasPacker::insert(uint32_t width, uint32_t height, AtlasRect& outRect)
+{
+	Placement placement;
+	if (!width || !height || !findPosition(width + 2 * _options.padding, height + 2 * _options.padding, placement)) { return false; }
+	place(placement.rect);
+	_usedArea += static_cast<uint64_t>(width) * height;
+	outRect = toAtlasRect(placement);
+	return true;
+}
+
+bool TextureAtlasPacker::insert(const uint32_t* widths, const uint32_t* heights, uint32_t numRects, AtlasRect* outRects)
+{
+	const std::vector<Rect> freeRects = _freeRects, usedRects = _usedRects;
+	const uint64_t usedArea = _usedArea;
+
+	std::vector<uint32_t> remaining(numRects);
+	for (uint32_t i = 0; i < numRects; ++i) { remaining[i] = i; }
+	while (!remaining.empty())
+	{
+		// Place the rectangle which fits best first.
+		Placement best;
+		best.score = std::numeric_limits<int64_t>::max();
+		best.secondaryScore = std::numeric_limits<int64_t>::max();
+		size_t bestIndex = remaining.size();
+		for (size_t i = 0; i < remaining.size(); ++i)
+		{
+			Placement placement;
+			const uint32_t width = widths[remaining[i]], height = heights[remaining[i]];
+			if (!width || !height || !findPosition(width + 2 * _options.padding, height + 2 * _options.padding, placement)) { bestIndex = remaining.size(); break; }
+			if (placement.score < best.score || (placement.score == best.score && placement.secondaryScore < best.secondaryScore))
+			{
+				best = placement;
+				bestIndex = i;
+			}
+		}
+		if (bestIndex == remaining.size())
+		{
+			_freeRects = freeRects;
+			_usedRects = usedRects;
+			_usedArea = usedArea;
+			return false;
+		}
+		place(best.rect);
+		_usedArea += static_cast<uint64_t>(widths[remaining[bestIndex]]) * heights[remaining[bestIndex]];
+		outRects[remaining[bestIndex]] = toAtlasRect(best);
+		remaining.erase(remaining.begin() + static_cast<std::ptrdiff_t>(bestIndex));
+	}
+	return true;
+}
+
+bool packTextureAtlas(const uint32_t* widths, const uint32_t* heights, uint32_t numRects, uint32_t maxDimension, const AtlasPackerOptions& options, uint32_t& outWidth,
+	uint32_t& outHeight, AtlasRect* outRects)
+{
+	// The atlas can never be smaller than the total area of the rectangles, and its longer side can never be shorter than the longest side of any of them.
+	uint64_t totalArea = 0;
+	uint32_t minDimension = 0;
+	for (uint32_t i = 0; i < numRects; ++i)
+	{
+		const uint32_t width = widths[i] + 2 * options.padding, height = heights[i] + 2 * options.padding;
+		totalArea += static_cast<uint64_t>(width) * height;
+		minDimension = std::max(minDimension, std::max(width, height));
+	}
+
+	TextureAtlasPacker packer(0, 0, options);
+	for (uint32_t height = 8; height <= maxDimension; height *= 2)
+	{
+		for (uint32_t width = height; width <= std::min(height * 2, maxDimension); width *= 2)
+		{
+			if (static_cast<uint64_t>(width) * height < totalArea || std::max(width, height) < minDimension) { continue; }
+			packer.reset(width, height);
+			if (packer.insert(widths, heights, numRects, outRects))
+			{
+				outWidth = width;
+				outHeight = height;
+				return true;
+			}
+		}
+	}
+	return false;
+}
+} // namespace pvr
+//!\endcond
@@ -0,0 +1,146 @@
+/*!
+\brief Contains a graphics API independent rectangle packer (MaxRects) used to build texture atlases.
+\file PVRCore/texture/TextureAtlasPacker.h
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+#pragma once
+#include <cstdint>
+#include <vector>
+namespace pvr {
+
+/// <summary>The rule used to choose where the next rectangle goes among the free areas of the atlas.</summary>
+enum class AtlasPackingHeuristic
+{
+	BestShortSideFit, ///< The free area whose shorter leftover side is smallest. A good default.
+	BestLongSideFit, ///< The free area whose longer leftover side is smallest
+	BestAreaFit, ///< The smallest free area the rectangle fits in
+	BottomLeft, ///< The lowest position, then the leftmost one (Tetris style placement)
+	ContactPoint, ///< The position where the rectangle touches the most edges of the atlas and of the rectangles already placed
+};
+
+/// <summary>Controls how TextureAtlasPacker places rectangles.</summary>
+struct AtlasPackerOptions
+{
+	AtlasPackingHeuristic heuristic; ///< How to choose the position of each rectangle
+	uint32_t padding; ///< The number of pixels kept free around each rectangle, e.g. so that bilinear filtering does not bleed between neighbours
+	bool allowRotation; ///< Allow rectangles to be rotated by 90 degrees if that fits better. The caller must then rotate the image data.
+
+	/// <summary>Constructor. Defaults to BestShortSideFit, no padding and no rotation.</summary>
+	/// <param name="heuristic">How to choose the position of each rectangle</param>
+	/// <param name="padding">The number of pixels kept free around each rectangle</param>
+	/// <param name="allowRotation">Allow rectangles to be rotated by 90 degrees</param>
+	AtlasPackerOptions(AtlasPackingHeuristic heuristic = AtlasPackingHeuristic::BestShortSideFit, uint32_t padding = 0, bool allowRotation = false)
+		: heuristic(heuristic), padding(padding), allowRotation(allowRotation)
+	{}
+};
+
+/// <summary>The position of a rectangle in an atlas, excluding its padding.</summary>
+struct AtlasRect
+{
+	uint32_t x; ///< The x coordinate of the left side of the rectangle
+	uint32_t y; ///< The y coordinate of the top side of the rectangle
+	uint32_t width; ///< The width of the rectangle in the atlas. Equal to the requested height if the rectangle is rotated.
+	uint32_t height; ///< The height of the rectangle in the atlas. Equal to the requested width if the rectangle is rotated.
+	bool isRotated; ///< True if the rectangle was rotated by 90 degrees
+
+	/// <summary>Constructor. Creates an empty rectangle at the origin.</summary>
+	AtlasRect() : x(0), y(0), width(0), height(0), isRotated(false) {}
+};
+
+/// <summary>Packs rectangles into a fixed size atlas with the MaxRects algorithm: the packer keeps the list of maximal free rectangles of the atlas,
+/// which may overlap, and places each new rectangle into one of them according to a heuristic. Rectangles can be inserted one at a time as they become
+/// known (e.g. glyphs added to a font atlas at runtime), or as a batch, which places the best fitting rectangle of the batch first and packs tighter.</summary>
+class TextureAtlasPacker
+{
+public:
+	/// <summary>Constructor. Creates an empty atlas.</summary>
+	/// <param name="width">The width of the atlas</param>
+	/// <param name="height">The height of the atlas</param>
+	/// <param name="options">The placement options</param>
+	TextureAtlasPacker(uint32_t width, uint32_t height, const AtlasPackerOptions& options = AtlasPackerOptions());
+
+	/// <summary>Removes every rectangle and resizes the atlas.</summary>
+	/// <param name="width">The new width of the atlas</param>
+	/// <param name="height">The new height of the atlas</param>
+	void reset(uint32_t width, uint32_t height);
+
+	/// <summary>Places a rectangle into the atlas.</summary>
+	/// <param name="width">The width of the rectangle, excluding padding. Must not be 0.</param>
+	/// <param name="height">The height of the rectangle, excluding padding. Must not be 0.</param>
+	/// <param name="outRect">The position of the rectangle in the atlas</param>
+	/// <returns>True if the rectangle was placed, false if it does not fit or is empty (the atlas is then unchanged)</returns>
+	bool insert(uint32_t width, uint32_t height, AtlasRect& outRect);
+
+	/// <summary>Places a batch of rectangles into the atlas. At every step, the rectangle of the batch which fits best according to the heuristic is placed.</summary>
+	/// <param name="widths">The widths of the rectangles, excluding padding</param>
+	/// <param name="heights">The heights of the rectangles, excluding padding</param>
+	/// <param name="numRects">The number of rectangles</param>
+	/// <param name="outRects">The positions of the rectangles in the atlas, in the order of the input</param>
+	/// <returns>True if all the rectangles were placed. If any does not fit or is empty, returns false and the atlas is left unchanged.</returns>
+	bool insert(const uint32_t* widths, const uint32_t* heights, uint32_t numRects, AtlasRect* outRects);
+
+	/// <summary>Get the width of the atlas.</summary>
+	/// <returns>The width of the atlas</returns>
+	uint32_t getWidth() const { return _width; }
+
+	/// <summary>Get the height of the atlas.</summary>
+	/// <returns>The height of the atlas</returns>
+	uint32_t getHeight() const { return _height; }
+
+	/// <summary>Get the placement options.</summary>
+	/// <returns>The placement options</returns>
+	const AtlasPackerOptions& getOptions() const { return _options; }
+
+	/// <summary>Get the number of rectangles placed so far.</summary>
+	/// <returns>The number of rectangles in the atlas</returns>
+	uint32_t getNumRects() const { return static_cast<uint32_t>(_usedRects.size()); }
+
+	/// <summary>Get the number of pixels covered by the rectangles placed so far, excluding their padding.</summary>
+	/// <returns>The used area in pixels</returns>
+	uint64_t getUsedArea() const { return _usedArea; }
+
+	/// <summary>Get the fraction of the atlas covered by the rectangles placed so far, excluding their padding.</summary>
+	/// <returns>The occupancy, from 0 to 1</returns>
+	float getOccupancy() const;
+
+private:
+	struct Rect
+	{
+		uint32_t x, y, width, height;
+	};
+	struct Placement
+	{
+		Rect rect;
+		bool isRotated;
+		int64_t score;
+		int64_t secondaryScore;
+	};
+
+	bool findPosition(uint32_t width, uint32_t height, Placement& outPlacement) const;
+	int64_t getContactScore(const Rect& rect) const;
+	void place(const Rect& rect);
+	AtlasRect toAtlasRect(const Placement& placement) const;
+
+	uint32_t _width;
+	uint32_t _height;
+	AtlasPackerOptions _options;
+	std::vector<Rect> _freeRects;
+	std::vector<Rect> _usedRects;
+	uint64_t _usedArea;
+};
+
+/// <summary>Packs a batch of rectangles into the smallest power of two atlas that holds them, for example to build a texture atlas from a set of
+/// images. Square atlases and atlases twice as wide as high are tried in order of area (8x8, 16x8, 16x16, 32x16...), up to maxDimension on each side.</summary>
+/// <param name="widths">The widths of the rectangles, excluding padding</param>
+/// <param name="heights">The heights of the rectangles, excluding padding</param>
+/// <param name="numRects">The number of rectangles</param>
+/// <param name="maxDimension">The maximum width and height of the atlas, e.g. the maximum texture size of the device</param>
+/// <param name="options">The placement options</param>
+/// <param name="outWidth">The width of the atlas</param>
+/// <param name="outHeight">The height of the atlas</param>
+/// <param name="outRects">The positions of the rectangles in the atlas, in the order of the input</param>
+/// <returns>True if the rectangles were packed, false if they do not fit in an atlas of maxDimension x maxDimension.</returns>
+bool packTextureAtlas(const uint32_t* widths, const uint32_t* heights, uint32_t numRects, uint32_t maxDimension, const AtlasPackerOptions& options, uint32_t& outWidth,
+	uint32_t& outHeight, AtlasRect* outRects);
+} // namespace pvr
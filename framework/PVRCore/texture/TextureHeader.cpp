@@ -13,8 +13,14 @@
 #include "PVRCore/Log.h"
 #include <algorithm>
 using std::string;
-using std::map;
 namespace pvr {
+namespace {
+// Orders meta data by fourCC, then key.
+inline bool metaDataLess(const TextureMetaData& lhs, uint64_t rhsFourCCAndKey)
+{
+	return ((static_cast<uint64_t>(lhs.getFourCC()) << 32) | lhs.getKey()) < rhsFourCCAndKey;
+}
+} // namespace
 
 TextureHeader::TextureHeader()
 {
@@ -30,6 +36,7 @@ TextureHeader::TextureHeader()
 	numMipMaps = 1;
 	numPlanes = 1;
 	metaDataSize = 0;
+	updateDataLayout();
 }
 
 /*
@@ -54,6 +61,8 @@ TextureHeader::TextureHeader(PixelFormat pixelFormat, uint32_t width, uint32_t h
 	this->numFaces = numFaces;
 	this->numPlanes = numPlanes;
 	this->flags = flags;
+	this->metaDataSize = 0;
+	updateDataLayout();
 	if (metaData)
 	{
 		for (uint32_t i = 0; i < metaDataSize; ++i) { addMetaData(metaData[i]); }
@@ -62,20 +71,15 @@ TextureHeader::TextureHeader(PixelFormat pixelFormat, uint32_t width, uint32_t h
 
 const std::string TextureHeader::getCubeMapOrder() const
 {
-	// Make sure the meta block exists
-	map<uint32_t, map<uint32_t, TextureMetaData>>::const_iterator foundFourCC = _metaDataMap.find(PVRv3);
 	if (getNumFaces() <= 1) { throw InvalidOperationError("TextureHeader::getCubeMapOrder: Request for cube map order on non-cubemap Texture"); }
 
-	if (foundFourCC != _metaDataMap.end())
+	// Make sure the meta block exists
+	const TextureMetaData* cubeOrderMetaData = findMetaData(PVRv3, TextureMetaData::IdentifierCubeMapOrder);
+	if (cubeOrderMetaData)
 	{
-		map<uint32_t, TextureMetaData>::const_iterator foundMetaData = (foundFourCC->second).find(TextureMetaData::IdentifierCubeMapOrder);
-		if (foundMetaData != (foundFourCC->second).end())
-		{
-			char cubeMapOrder[7];
-			cubeMapOrder[6] = 0;
-			memcpy(cubeMapOrder, (foundMetaData->second).getData(), 6);
-			return std::string(cubeMapOrder);
-		}
+		char cubeMapOrder[7] = {};
+		memcpy(cubeMapOrder, cubeOrderMetaData->getData(), (std::min)(cubeOrderMetaData->getDataSize(), 6u));
+		return std::string(cubeMapOrder);
 	}
 
 	std::string defaultOrder("XxYyZz");
@@ -785,12 +789,6 @@ void TextureHeader::setBumpMap(float bumpScale, std::string bumpOrder)
 		Log("Invalid Bumpmap order std::string");
 		return;
 	}
-	// Get a reference to the meta data block.
-	TextureMetaData& bumpMetaData = _metaDataMap[PVRv3][TextureMetaData::IdentifierBumpData];
-
-	// Check if it's already been set or not.
-	if (bumpMetaData.getData()) { metaDataSize -= bumpMetaData.getTotalSizeInMemory(); }
-
 	// Initialize and clear the bump map data
 	char bumpData[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
 
@@ -798,22 +796,15 @@ void TextureHeader::setBumpMap(float bumpScale, std::string bumpOrder)
 	memcpy(bumpData, &bumpScale, 4);
 	memcpy(bumpData + 4, bumpOrder.c_str(), (std::min)(bumpOrder.length(), size_t(4)));
 
-	bumpMetaData = TextureMetaData(PVRv3, TextureMetaData::IdentifierBumpData, 8, bumpData);
-
-	// Increment the meta data size.
-	metaDataSize += bumpMetaData.getTotalSizeInMemory();
+	addMetaData(TextureMetaData(PVRv3, TextureMetaData::IdentifierBumpData, 8, bumpData));
 }
 
 TextureMetaData::AxisOrientation TextureHeader::getOrientation(TextureMetaData::Axis axis) const
 {
 	// Make sure the meta block exists
-
-	std::map<uint32_t, std::map<uint32_t, TextureMetaData>>::const_iterator foundIdentifer = _metaDataMap.find(PVRv3);
-	if (foundIdentifer != _metaDataMap.end())
-	{
-		std::map<uint32_t, TextureMetaData>::const_iterator foundTexMetaData = foundIdentifer->second.find(TextureMetaData::IdentifierTextureOrientation);
-		if (foundTexMetaData != foundIdentifer->second.end()) { return static_cast<TextureMetaData::AxisOrientation>(foundTexMetaData->second.getData()[axis]); }
-	}
+	const TextureMetaData* orientationMetaData = findMetaData(PVRv3, TextureMetaData::IdentifierTextureOrientation);
+	if (orientationMetaData && static_cast<uint32_t>(axis) < orientationMetaData->getDataSize())
+	{ return static_cast<TextureMetaData::AxisOrientation>(orientationMetaData->getData()[axis]); }
 
 	return static_cast<TextureMetaData::AxisOrientation>(0); // Default is the flag values.
 }
@@ -1197,7 +1188,51 @@ bool TextureHeader::getDirect3DFormat(uint32_t& d3dFormat) const
 	return false;
 }
 
+bool TextureHeader::isDataLayoutCurrent() const
+{
+	return !_dataLayout.levels.empty() && _dataLayout.pixelFormat == getPixelFormat().getPixelTypeId() && _dataLayout.width == width && _dataLayout.height == height &&
+		_dataLayout.depth == depth && _dataLayout.numSurfaces == numSurfaces && _dataLayout.numFaces == numFaces && _dataLayout.numMipMaps == numMipMaps &&
+		_dataLayout.numPlanes == numPlanes;
+}
+
+void TextureHeader::updateDataLayout()
+{
+	if (isDataLayoutCurrent()) { return; }
+	_dataLayout.levels.clear();
+
+	// A MIP chain cannot be longer than the number of bits of the dimensions. Leave the layout of invalid headers to be computed on demand.
+	if (numMipMaps > 64) { return; }
+
+	_dataLayout.pixelFormat = getPixelFormat().getPixelTypeId();
+	_dataLayout.width = width, _dataLayout.height = height, _dataLayout.depth = depth;
+	_dataLayout.numSurfaces = numSurfaces, _dataLayout.numFaces = numFaces, _dataLayout.numMipMaps = numMipMaps, _dataLayout.numPlanes = numPlanes;
+	_dataLayout.levels.resize(numMipMaps + 1);
+
+	uint64_t offset = 0;
+	for (uint32_t mipLevel = 0; mipLevel <= numMipMaps; ++mipLevel)
+	{
+		// The last entry holds the sizes of all the levels together, which are not always the sum of the sizes of each level as sizes are rounded to bytes.
+		const int32_t level = mipLevel < numMipMaps ? static_cast<int32_t>(mipLevel) : static_cast<int32_t>(pvrTextureAllMipMaps);
+		LevelLayout& layout = _dataLayout.levels[mipLevel];
+		layout.offset = offset;
+		layout.surfaceSizes[0] = computeDataSize(level, false, false, true, 0);
+		layout.surfaceSizes[1] = computeDataSize(level, false, false, false, 0);
+		layout.surfaceSizes[2] = computeDataSize(level, false, false, false, 1);
+		offset += static_cast<uint64_t>(layout.surfaceSizes[0]) * numSurfaces * numFaces;
+	}
+}
+
 uint32_t TextureHeader::getDataSize(int32_t iMipLevel, bool bAllSurfaces, bool bAllFaces, bool bAllPlanes, uint32_t planeIndex) const
+{
+	if ((iMipLevel == pvrTextureAllMipMaps || (iMipLevel >= 0 && static_cast<uint32_t>(iMipLevel) < numMipMaps)) && isDataLayoutCurrent())
+	{
+		const LevelLayout& layout = _dataLayout.levels[iMipLevel == pvrTextureAllMipMaps ? numMipMaps : static_cast<uint32_t>(iMipLevel)];
+		return layout.surfaceSizes[bAllPlanes ? 0 : planeIndex ? 2 : 1] * (bAllSurfaces ? getNumArrayMembers() : 1) * (bAllFaces ? getNumFaces() : 1);
+	}
+	return computeDataSize(iMipLevel, bAllSurfaces, bAllFaces, bAllPlanes, planeIndex);
+}
+
+uint32_t TextureHeader::computeDataSize(int32_t iMipLevel, bool bAllSurfaces, bool bAllFaces, bool bAllPlanes, uint32_t planeIndex) const
 {
 	// The smallest divisible sizes for a pixel format
 	uint32_t uiSmallestWidth = 1;
@@ -1339,6 +1374,14 @@ ptrdiff_t TextureHeader::getDataOffset(uint32_t mipMapLevel /*= 0*/, uint32_t ar
 		throw InvalidArgumentError("face", "TextureHeader::getDataOffset: Specified face did not exist");
 	} // File is organised by MIP Map levels, then surfaces, then faces.
 
+	if (isDataLayoutCurrent())
+	{
+		const LevelLayout& layout = _dataLayout.levels[mipMapLevel];
+		uint64_t offset = layout.offset + (static_cast<uint64_t>(arrayMember) * getNumFaces() + face) * layout.surfaceSizes[0];
+		if (plane) { offset += layout.surfaceSizes[1] + static_cast<uint64_t>(plane - 1) * layout.surfaceSizes[2]; }
+		return static_cast<ptrdiff_t>(offset);
+	}
+
 	// Get the start of the MIP level.
 	if (mipMapLevel != 0)
 	{
@@ -1361,12 +1404,6 @@ ptrdiff_t TextureHeader::getDataOffset(uint32_t mipMapLevel /*= 0*/, uint32_t ar
 
 void TextureHeader::setOrientation(TextureMetaData::AxisOrientation eAxisOrientation)
 {
-	// Get a reference to the meta data block.
-	TextureMetaData& orientationMetaData = _metaDataMap[PVRv3][TextureMetaData::IdentifierTextureOrientation];
-
-	// Check if it's already been set or not.
-	if (orientationMetaData.getData()) { metaDataSize -= orientationMetaData.getTotalSizeInMemory(); }
-
 	// Set the orientation data
 	char orientationData[3];
 
@@ -1392,19 +1429,7 @@ void TextureHeader::setOrientation(TextureMetaData::AxisOrientation eAxisOrienta
 	}
 
 	// Update the meta data block
-	orientationMetaData = TextureMetaData(PVRv3, TextureMetaData::IdentifierTextureOrientation, 3, orientationData);
-
-	// Check that the meta data was created successfully.
-	if (orientationMetaData.getDataSize() != 0)
-	{
-		// Increment the meta data size.
-		metaDataSize += orientationMetaData.getTotalSizeInMemory();
-	}
-	else
-	{
-		// Otherwise remove it.
-		_metaDataMap.erase(TextureMetaData::IdentifierTextureOrientation);
-	}
+	addMetaData(TextureMetaData(PVRv3, TextureMetaData::IdentifierTextureOrientation, 3, orientationData));
 }
 
 void TextureHeader::setCubeMapOrder(std::string cubeMapOrder)
@@ -1412,39 +1437,42 @@ void TextureHeader::setCubeMapOrder(std::string cubeMapOrder)
 	if (cubeMapOrder.find_first_not_of("xXyYzZ") != std::string::npos)
 	{
 		throw InvalidArgumentError("cubeMapOrder", "TextureHeader::setCubeMapOrder: Specified cubemap order string was invalid.");
-	} // Get a reference to the meta data block.
-	TextureMetaData& cubeOrderMetaData = _metaDataMap[PVRv3][TextureMetaData::IdentifierCubeMapOrder];
-
-	// Check if it's already been set or not.
-	if (cubeOrderMetaData.getData()) { metaDataSize -= cubeOrderMetaData.getTotalSizeInMemory(); }
-
-	cubeOrderMetaData =
-		TextureMetaData(PVRv3, TextureMetaData::IdentifierCubeMapOrder, (std::min)(static_cast<uint32_t>(cubeMapOrder.length()), 6u), static_cast<const char*>(cubeMapOrder.data()));
+	}
+	addMetaData(TextureMetaData(
+		PVRv3, TextureMetaData::IdentifierCubeMapOrder, (std::min)(static_cast<uint32_t>(cubeMapOrder.length()), 6u), static_cast<const char*>(cubeMapOrder.data())));
+}
 
-	// Increment the meta data size.
-	metaDataSize += cubeOrderMetaData.getTotalSizeInMemory();
+const TextureMetaData* TextureHeader::findMetaData(uint32_t fourCC, uint32_t key) const
+{
+	// Textures carry a handful of meta data blocks, for which a linear scan beats a binary search.
+	const uint64_t fourCCAndKey = (static_cast<uint64_t>(fourCC) << 32) | key;
+	for (const TextureMetaData& metaData : _metaData)
+	{
+		if (!metaDataLess(metaData, fourCCAndKey)) { return metaData.getFourCC() == fourCC && metaData.getKey() == key ? &metaData : NULL; }
+	}
+	return NULL;
 }
 
 void TextureHeader::addMetaData(const TextureMetaData& metaData)
 {
-	// Get a reference to the meta data block.
-	TextureMetaData& currentMetaData = _metaDataMap[metaData.getFourCC()][metaData.getKey()];
-
-	// Check if it's already been set or not.
-	if (currentMetaData.getData()) { metaDataSize -= currentMetaData.getTotalSizeInMemory(); }
-
-	// Set the meta data block
-	currentMetaData = metaData;
+	// Keep the meta data sorted, replacing the block with the same fourCC and key if it has already been set.
+	const uint64_t fourCCAndKey = (static_cast<uint64_t>(metaData.getFourCC()) << 32) | metaData.getKey();
+	std::vector<TextureMetaData>::iterator found = std::lower_bound(_metaData.begin(), _metaData.end(), fourCCAndKey, metaDataLess);
+	if (found != _metaData.end() && found->getFourCC() == metaData.getFourCC() && found->getKey() == metaData.getKey())
+	{
+		metaDataSize -= found->getTotalSizeInMemory();
+		*found = metaData;
+	}
+	else
+	{
+		_metaData.insert(found, metaData);
+	}
 
 	// Increment the meta data size.
-	metaDataSize += currentMetaData.getTotalSizeInMemory();
+	metaDataSize += metaData.getTotalSizeInMemory();
 }
 
-bool TextureHeader::isBumpMap() const
-{
-	const std::map<uint32_t, TextureMetaData>& dataMap = _metaDataMap.at(PVRv3);
-	return (dataMap.find(TextureMetaData::IdentifierBumpData) != dataMap.end());
-}
+bool TextureHeader::isBumpMap() const { return findMetaData(PVRv3, TextureMetaData::IdentifierBumpData) != NULL; }
 
 } // namespace pvr
 //!\endcond
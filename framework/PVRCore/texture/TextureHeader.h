@@ -61,7 +61,7 @@ public:
 	uint32_t metaDataSize; //!< Size of the accompanying meta data.
 
 	// Header _header; //!< Texture header as laid out in a file.
-	std::map<uint32_t, std::map<uint32_t, TextureMetaData>> _metaDataMap; //!< Map of all the meta data stored for a texture.
+	std::vector<TextureMetaData> _metaData; //!< All the meta data stored for a texture, sorted by fourCC then key.
 
 	/// <summary>Default constructor for a TextureHeader. Returns an empty header.</summary>
 	TextureHeader();
@@ -177,16 +177,28 @@ public:
 	/// <param name="mipMapLevel">The mip map level of the offset</param>
 	/// <param name="arrayMember">The array index of the offset</param>
 	/// <param name="face">The face of the offset</param>
+	/// <param name="plane">The plane of the offset</param>
 	/// <returns>Return data offset</returns>
 	ptrdiff_t getDataOffset(uint32_t mipMapLevel = 0, uint32_t arrayMember = 0, uint32_t face = 0, uint32_t plane = 0) const;
 
+	/// <summary>Recomputes the table of the sizes and offsets of the surfaces, which makes getDataSize and getDataOffset constant time. The constructors and
+	/// the setters keep it up to date, so this only needs to be called after assigning the layout members (width, numMipMaps, pixelFormat...) directly:
+	/// until then, getDataSize and getDataOffset compute the layout on every call. Does nothing if the table is up to date.</summary>
+	void updateDataLayout();
+
 	/// <summary>Gets the number of array members stored in this texture.</summary>
 	/// <returns>Return the number of array members in this texture.</returns>
 	uint32_t getNumArrayMembers() const { return numSurfaces; }
 
-	/// <summary>Get a pointer directly to the Meta Data Map, to allow users to read out data.</summary>
-	/// <returns>Return a direct pointer to the MetaData map.</returns>
-	const std::map<uint32_t, std::map<uint32_t, TextureMetaData>>* getMetaDataMap() const { return &_metaDataMap; }
+	/// <summary>Get all the meta data, to allow users to read out data.</summary>
+	/// <returns>Return the meta data, sorted by fourCC then key.</returns>
+	const std::vector<TextureMetaData>& getMetaData() const { return _metaData; }
+
+	/// <summary>Find a piece of meta data.</summary>
+	/// <param name="fourCC">The fourCC of the meta data, e.g. PVRv3</param>
+	/// <param name="key">The key of the meta data, e.g. TextureMetaData::IdentifierCubeMapOrder</param>
+	/// <returns>Return the meta data, or NULL if the texture has none with this fourCC and key.</returns>
+	const TextureMetaData* findMetaData(uint32_t fourCC, uint32_t key) const;
 
 	/// <summary>Gets the number of MIP-Map levels stored in this texture.</summary>
 	/// <returns>Return the number of MIP-Map levels in this texture.</returns>
@@ -233,7 +245,11 @@ public:
 
 	/// <summary>Sets the pixel format for this texture.</summary>
 	/// <param name="uPixelFormat">The format of the pixel.</param>
-	void setPixelFormat(PixelFormat uPixelFormat) { pixelFormat = uPixelFormat.getPixelTypeId(); }
+	void setPixelFormat(PixelFormat uPixelFormat)
+	{
+		pixelFormat = uPixelFormat.getPixelTypeId();
+		updateDataLayout();
+	}
 
 	/// <summary>Sets the color space for this texture. Default is lRGB.</summary>
 	/// <param name="colorSpace">A color space of the texture.</param>
@@ -262,31 +278,59 @@ public:
 
 	/// <summary>Sets the texture width.</summary>
 	/// <param name="newWidth">The new width.</param>
-	void setWidth(uint32_t newWidth) { width = newWidth; }
+	void setWidth(uint32_t newWidth)
+	{
+		width = newWidth;
+		updateDataLayout();
+	}
 
 	/// <summary>Sets the texture height.</summary>
 	/// <param name="newHeight">The new height.</param>
-	void setHeight(uint32_t newHeight) { height = newHeight; }
+	void setHeight(uint32_t newHeight)
+	{
+		height = newHeight;
+		updateDataLayout();
+	}
 
 	/// <summary>Sets the texture depth.</summary>
 	/// <param name="newDepth">The new depth.</param>
-	void setDepth(uint32_t newDepth) { depth = newDepth; }
+	void setDepth(uint32_t newDepth)
+	{
+		depth = newDepth;
+		updateDataLayout();
+	}
 
 	/// <summary>Sets the number of arrays in this texture</summary>
 	/// <param name="numNewMembers">The new number of members in this array.</param>
-	void setNumArrayMembers(uint32_t numNewMembers) { numSurfaces = numNewMembers; }
+	void setNumArrayMembers(uint32_t numNewMembers)
+	{
+		numSurfaces = numNewMembers;
+		updateDataLayout();
+	}
 
 	/// <summary>Sets the number of MIP-Map levels in this texture.</summary>
 	/// <param name="numNewMipMapLevels">New number of MIP-Map levels.</param>
-	void setNumMipMapLevels(uint32_t numNewMipMapLevels) { numMipMaps = numNewMipMapLevels; }
+	void setNumMipMapLevels(uint32_t numNewMipMapLevels)
+	{
+		numMipMaps = numNewMipMapLevels;
+		updateDataLayout();
+	}
 
 	/// <summary>Sets the number of faces stored in this texture.</summary>
 	/// <param name="numNewFaces">New number of faces for this texture.</param>
-	void setNumFaces(uint32_t numNewFaces) { numFaces = numNewFaces; }
+	void setNumFaces(uint32_t numNewFaces)
+	{
+		numFaces = numNewFaces;
+		updateDataLayout();
+	}
 
 	/// <summary>Sets the number of planes stored in this texture.</summary>
 	/// <param name="numNewPlanes">New number of planes for this texture.</param>
-	void setNumPlanes(uint32_t numNewPlanes) { numPlanes = numNewPlanes; }
+	void setNumPlanes(uint32_t numNewPlanes)
+	{
+		numPlanes = numNewPlanes;
+		updateDataLayout();
+	}
 
 	/// <summary>Sets the data orientation for a given axis in this texture.</summary>
 	/// <param name="axisOrientation">Specifying axis and orientation.</param>
@@ -323,8 +367,29 @@ public:
 		}
 	}
 
-	/// <summary>Adds an arbitrary piece of meta data.</summary>
+	/// <summary>Adds an arbitrary piece of meta data, replacing any with the same fourCC and key.</summary>
 	/// <param name="metaData">Meta data block to be added.</param>
 	void addMetaData(const TextureMetaData& metaData);
+
+private:
+	// The sizes of a single face of a single array member of a MIP level, and the offset of the level.
+	struct LevelLayout
+	{
+		uint64_t offset; // The offset of the level in the data
+		uint32_t surfaceSizes[3]; // The size of all planes, of the first plane, and of any other plane
+	};
+
+	// The layout of the data, and the values of the members it was computed from, which are public and may be assigned directly.
+	struct DataLayout
+	{
+		uint64_t pixelFormat;
+		uint32_t width, height, depth, numSurfaces, numFaces, numMipMaps, numPlanes;
+		std::vector<LevelLayout> levels; // One entry per MIP level, then one for all the levels together. Empty if not computed.
+	};
+
+	bool isDataLayoutCurrent() const;
+	uint32_t computeDataSize(int32_t mipLevel, bool allSurfaces, bool allFaces, bool allPlanes, uint32_t planeIndex) const;
+
+	DataLayout _dataLayout;
 };
 } // namespace pvr
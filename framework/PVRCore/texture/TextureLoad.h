@@ -9,22 +9,26 @@
 #include "PVRCore/textureio/TextureReaderPVR.h"
 #include "PVRCore/textureio/TextureReaderBMP.h"
 #include "PVRCore/textureio/TextureReaderKTX.h"
+#include "PVRCore/textureio/TextureReaderKTX2.h"
 #include "PVRCore/textureio/TextureReaderDDS.h"
 #include "PVRCore/textureio/TextureReaderXNB.h"
 #include "PVRCore/textureio/TextureReaderTGA.h"
+#include "PVRCore/AssetCache.h"
 
 namespace pvr {
 
-/// <summary>Load a texture from binary data. Synchronous.</summary>
+/// <summary>Load a texture from binary data. Synchronous, but may read the data on several threads (see TextureLoadOptions).</summary>
 /// <param name="textureStream">A stream from which to load the binary data</param>
 /// <param name="type">The type of the texture. Several supported formats.</param>
+/// <param name="options">Options for loading the texture. Only used by the PVR, KTX and KTX2 readers.</param>
 /// <returns>Returns a successfully created pvr::Texture object otherwise will throw</returns>
-inline Texture textureLoad(const Stream& textureStream, TextureFileFormat type)
+inline Texture textureLoad(const Stream& textureStream, TextureFileFormat type, const TextureLoadOptions& options)
 {
 	switch (type)
 	{
-	case TextureFileFormat::KTX: return assetReaders::readKTX(textureStream);
-	case TextureFileFormat::PVR: return assetReaders::readPVR(textureStream);
+	case TextureFileFormat::KTX: return assetReaders::readKTX(textureStream, options);
+	case TextureFileFormat::KTX2: return assetReaders::readKTX2(textureStream, options);
+	case TextureFileFormat::PVR: return assetReaders::readPVR(textureStream, options);
 	case TextureFileFormat::TGA: return assetReaders::readTGA(textureStream);
 	case TextureFileFormat::BMP: return assetReaders::readBMP(textureStream);
 	case TextureFileFormat::DDS: return assetReaders::readDDS(textureStream);
@@ -32,8 +36,78 @@ inline Texture textureLoad(const Stream& textureStream, TextureFileFormat type)
 	}
 }
 
+/// <summary>Load a texture from binary data. Synchronous.</summary>
+/// <param name="textureStream">A stream from which to load the binary data</param>
+/// <param name="type">The type of the texture. Several supported formats.</param>
+/// <returns>Returns a successfully created pvr::Texture object otherwise will throw</returns>
+inline Texture textureLoad(const Stream& textureStream, TextureFileFormat type) { return textureLoad(textureStream, type, TextureLoadOptions()); }
+
 /// <summary>Load a texture from binary data. Synchronous.</summary>
 /// <param name="textureStream">A stream from which to load the binary data</param>
 /// <returns>True if successful, otherwise false</returns>
 inline Texture textureLoad(const Stream& textureStream) { return textureLoad(textureStream, getTextureFormatFromFilename(textureStream.getFileName().c_str())); }
+
+/// <summary>Load a texture through an asset cache: if the texture has already been loaded from the same file (and the file has not been modified
+/// since), the cached texture is returned instead of loading it again. Textures returned by this function are shared by every user of the cache and
+/// are therefore immutable: copy a texture to modify it.</summary>
+/// <param name="cache">The asset cache</param>
+/// <param name="assetProvider">The asset provider used to find and open the file of the texture</param>
+/// <param name="filename">The name of the file of the texture</param>
+/// <param name="type">The type of the texture. If UNKNOWN, it is determined from the extension of the filename.</param>
+/// <param name="options">Options for loading the texture, if it is not in the cache.</param>
+/// <returns>The texture, shared with the cache. Throws if the texture cannot be loaded.</returns>
+inline std::shared_ptr<const Texture> textureLoadCached(AssetCache& cache, const IAssetProvider& assetProvider, const std::string& filename,
+	TextureFileFormat type = TextureFileFormat::UNKNOWN, const TextureLoadOptions& options = TextureLoadOptions())
+{
+	if (type == TextureFileFormat::UNKNOWN) { type = getTextureFormatFromFilename(filename.c_str()); }
+	return cache.getOrLoad<Texture>(
+		assetProvider, filename,
+		[&]() {
+			std::unique_ptr<Stream> stream = assetProvider.getAssetStream(filename);
+			if (!stream) { throw FileNotFoundError(filename, "[textureLoadCached]"); }
+			return std::make_shared<Texture>(textureLoad(*stream, type, options));
+		},
+		[](const Texture& texture) { return sizeof(Texture) + texture.getDataSize(); });
+}
+
+/// <summary>Load a texture through the asset cache of an asset provider (see IAssetProvider::getAssetCache). If the provider has no cache or its
+/// cache is disabled, the texture is loaded every time. Textures returned by this function may be shared with other users and are therefore immutable.</summary>
+/// <param name="assetProvider">The asset provider used to find and open the file of the texture, and whose cache is used</param>
+/// <param name="filename">The name of the file of the texture</param>
+/// <param name="type">The type of the texture. If UNKNOWN, it is determined from the extension of the filename.</param>
+/// <param name="options">Options for loading the texture, if it is not in the cache.</param>
+/// <returns>The texture. Throws if the texture cannot be loaded.</returns>
+inline std::shared_ptr<const Texture> textureLoadCached(const IAssetProvider& assetProvider, const std::string& filename, TextureFileFormat type = TextureFileFormat::UNKNOWN,
+	const TextureLoadOptions& options = TextureLoadOptions())
+{
+	AssetCache* cache = assetProvider.getAssetCache();
+	if (cache) { return textureLoadCached(*cache, assetProvider, filename, type, options); }
+	if (type == TextureFileFormat::UNKNOWN) { type = getTextureFormatFromFilename(filename.c_str()); }
+	std::unique_ptr<Stream> stream = assetProvider.getAssetStream(filename);
+	if (!stream) { throw FileNotFoundError(filename, "[textureLoadCached]"); }
+	return std::make_shared<Texture>(textureLoad(*stream, type, options));
+}
+
+/// <summary>Load a texture to upload it, for loaders which may also return a copy of it to their caller. If the asset cache of the asset provider
+/// is enabled, the texture is loaded through it and copied to outTexture if requested. Otherwise it is loaded straight into outTexture, or into
+/// outCachedTexture if outTexture is null, so that it is neither copied nor kept alive by the cache.</summary>
+/// <param name="assetProvider">The asset provider used to find and open the file of the texture, and whose cache is used</param>
+/// <param name="filename">The name of the file of the texture</param>
+/// <param name="outTexture">If not null, receives the texture</param>
+/// <param name="outCachedTexture">Keeps the returned texture alive if it is not outTexture</param>
+/// <returns>The texture, which is valid as long as both outTexture and outCachedTexture are. Throws if the texture cannot be loaded.</returns>
+inline const Texture& textureLoadForUpload(const IAssetProvider& assetProvider, const std::string& filename, Texture* outTexture, std::shared_ptr<const Texture>& outCachedTexture)
+{
+	AssetCache* cache = assetProvider.getAssetCache();
+	if (!outTexture || (cache && cache->isEnabled()))
+	{
+		outCachedTexture = textureLoadCached(assetProvider, filename);
+		if (outTexture) { *outTexture = *outCachedTexture; }
+		return *outCachedTexture;
+	}
+	std::unique_ptr<Stream> stream = assetProvider.getAssetStream(filename);
+	if (!stream) { throw FileNotFoundError(filename, "[textureLoadForUpload]"); }
+	*outTexture = textureLoad(*stream, getTextureFormatFromFilename(filename.c_str()));
+	return *outTexture;
+}
 } // namespace pvr
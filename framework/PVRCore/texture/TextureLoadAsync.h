@@ -9,6 +9,7 @@
 #include "PVRCore/texture/TextureLoad.h"
 #include "PVRCore/Threading.h"
 #include "PVRCore/IAssetProvider.h"
+#include <map>
 
 namespace pvr {
 namespace async {
@@ -78,6 +79,7 @@ private:
 		}
 		return false;
 	}
+	void cancel_() { resultSemaphore->signal(); }
 	void cleanup_() {}
 	void destroyObject() {}
 };
@@ -92,23 +94,62 @@ namespace impl {
 inline void textureLoadAsyncWorker(TextureLoadFuture future) { future->loadNow(); }
 } // namespace impl
 
-/// <summary>A class that loads Textures in a (single) different thread and provides futures to them.
+/// <summary>A class that loads Textures in one or more different threads and provides futures to them.
 /// Create an instance of it, and then just call loadTextureAsync foreach texture to load. When each texture
 /// has completed loading, a callback may be called, otherwise you can use all the typical functionality
-/// of futures, such as querying if loading is comlete, or using a blocking wait to get the result</summary>
+/// of futures, such as querying if loading is comlete, or using a blocking wait to get the result.
+/// Requests for a file that is already being loaded are coalesced: they return the future of the load in progress
+/// instead of loading the file again (see setCoalesceDuplicateRequests).</summary>
 class TextureAsyncLoader : public AsyncScheduler<TexturePtr, TextureLoadFuture, &impl::textureLoadAsyncWorker>
 {
 public:
-	TextureAsyncLoader() { _myInfo = "TextureAsyncLoader"; }
+	/// <summary>Constructor. Spawns the worker threads.</summary>
+	/// <param name="numWorkers">The number of textures that can be loaded at the same time, each on its own worker thread.</param>
+	explicit TextureAsyncLoader(uint32_t numWorkers = 1) : AsyncScheduler(numWorkers, "TextureAsyncLoader"), _coalesceDuplicateRequests(true), _nextPruneSize(64) {}
+
+	/// <summary>Enable or disable coalescing duplicate requests (enabled by default). When enabled, a request without a callback for a file that is
+	/// already queued or being loaded, with the same asset provider and format, returns the future of the existing request, so all the requesters
+	/// share the same Texture object. Note that cancelling a coalesced future cancels it for every requester.</summary>
+	/// <param name="coalesce">True to coalesce duplicate requests, false to always load the file again</param>
+	void setCoalesceDuplicateRequests(bool coalesce)
+	{
+		std::lock_guard<std::mutex> lock(_inFlightMutex);
+		_coalesceDuplicateRequests = coalesce;
+		if (!coalesce) { _inFlight.clear(); }
+	}
+
 	/// <summary>This function enqueues a "load texture" on a background thread, and returns an object
 	/// that can be used to query and wait for the result.</summary>
 	/// <param name="filename">The filename of the texture to load</param>
 	/// <param name="loader">A class that provides a "getAssetStream" function to get a Stream from the filename (usually, the application class itself)</param>
 	/// <param name="format">The texture format as which to load the texture.</param>
 	/// <param name="callback">An optional callback to call immediately after texture loading is complete.</param>
+	/// <param name="priority">The priority of the request. If the request is coalesced with a queued request of lower priority, that request is
+	/// promoted to this priority.</param>
 	/// <returns> A future to a texture : TextureLoadFuture</returns>
-	AsyncResult loadTextureAsync(const std::string& filename, IAssetProvider* loader, TextureFileFormat format, AsyncResult::element_type::Callback callback = NULL)
+	AsyncResult loadTextureAsync(const std::string& filename, IAssetProvider* loader, TextureFileFormat format, AsyncResult::element_type::Callback callback = NULL,
+		TaskPriority priority = TaskPriority::Normal)
 	{
+		std::unique_lock<std::mutex> lock(_inFlightMutex);
+		if (_coalesceDuplicateRequests && callback == nullptr)
+		{
+			auto it = _inFlight.find(filename);
+			if (it != _inFlight.end())
+			{
+				TextureLoadFuture existing = it->second.future.lock();
+				if (existing && existing->isInProgress() && existing->loader == loader && existing->format == format)
+				{
+					// Promote: the entry of lower priority will be dropped by the worker that dequeues it after this one has been executed.
+					if (priority < it->second.priority)
+					{
+						it->second.priority = priority;
+						enqueue(existing, priority);
+					}
+					return existing;
+				}
+			}
+		}
+
 		auto future = std::make_shared<TextureLoadFuture_>();
 		auto& params = *future;
 		params.filename = filename;
@@ -118,12 +159,46 @@ public:
 		params.resultSemaphore = std::make_shared<Semaphore>();
 		params.workSemaphore = &_workSemaphore;
 		params.setCallBack(callback);
-		_queueSemaphore.wait();
-		_queue.emplace_back(future);
-		_queueSemaphore.signal();
-		_workSemaphore.signal();
+
+		if (_coalesceDuplicateRequests)
+		{
+			if (_inFlight.size() >= _nextPruneSize) { pruneInFlight(); }
+			InFlightRequest& request = _inFlight[filename];
+			request.future = future;
+			request.priority = priority;
+		}
+		lock.unlock();
+
+		enqueue(future, priority);
 		return future;
 	}
+
+private:
+	struct InFlightRequest
+	{
+		std::weak_ptr<TextureLoadFuture_> future;
+		TaskPriority priority;
+	};
+
+	std::mutex _inFlightMutex;
+	std::map<std::string, InFlightRequest> _inFlight;
+	bool _coalesceDuplicateRequests;
+	size_t _nextPruneSize;
+
+	// Remove the requests that have completed. Amortised by only pruning when the map has doubled in size since the last time.
+	void pruneInFlight()
+	{
+		for (auto it = _inFlight.begin(); it != _inFlight.end();)
+		{
+			TextureLoadFuture future = it->second.future.lock();
+			if (!future || !future->isInProgress()) { it = _inFlight.erase(it); }
+			else
+			{
+				++it;
+			}
+		}
+		_nextPruneSize = std::max<size_t>(64, _inFlight.size() * 2);
+	}
 };
 } // namespace async
 } // namespace pvr
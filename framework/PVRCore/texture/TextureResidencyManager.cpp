@@ -0,0 +1,202 @@
+/*!
+\brief Implementation of the texture residency scheduler.
+\file PVRCore/texture/TextureResidencyManager.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+#include "PVRCore/texture/TextureResidencyManager.h"
+#include "PVRCore/Errors.h"
+#include <algorithm>
+#include <cmath>
+#include <queue>
+
+namespace pvr {
+constexpr float TextureResidencyManager::AlwaysResidentPriority;
+
+uint32_t TextureResidencyManager::addTexture(const TextureHeader& header, uint32_t numAlwaysResidentLevels)
+{
+	std::vector<uint64_t> levelSizes(header.getNumMipMapLevels());
+	for (uint32_t mip = 0; mip < levelSizes.size(); ++mip) { levelSizes[mip] = header.getDataSize(static_cast<int32_t>(mip), true, true); }
+	return addTexture(levelSizes.data(), static_cast<uint32_t>(levelSizes.size()), numAlwaysResidentLevels);
+}
+
+uint32_t TextureResidencyManager::addTexture(const uint64_t* levelSizes, uint32_t numLevels, uint32_t numAlwaysResidentLevels)
+{
+	if (!numLevels || !levelSizes) { throw InvalidArgumentError("levelSizes", "TextureResidencyManager: A texture needs at least one level"); }
+	TextureState texture;
+	texture.levelSizes.assign(levelSizes, levelSizes + numLevels);
+	texture.residentMip = numLevels;
+	texture.alwaysResidentMip = numLevels - std::min(std::max(numAlwaysResidentLevels, 1u), numLevels);
+	texture.requestedMip = texture.alwaysResidentMip;
+	texture.priority = 0.f;
+	texture.isRemoved = false;
+	_textures.push_back(std::move(texture));
+	return static_cast<uint32_t>(_textures.size() - 1);
+}
+
+void TextureResidencyManager::removeTexture(uint32_t textureId)
+{
+	TextureState& texture = getTexture(textureId);
+	_usedMemory -= getResidentSize(textureId);
+	texture.isRemoved = true;
+	texture.residentMip = static_cast<uint32_t>(texture.levelSizes.size());
+}
+
+void TextureResidencyManager::request(uint32_t textureId, uint32_t mipLevel, float priority)
+{
+	TextureState& texture = getTexture(textureId);
+	texture.requestedMip = std::min(mipLevel, texture.alwaysResidentMip);
+	texture.priority = priority;
+}
+
+uint64_t TextureResidencyManager::getResidentSize(uint32_t textureId) const
+{
+	const TextureState& texture = getTexture(textureId);
+	uint64_t size = 0;
+	for (uint32_t mip = texture.residentMip; mip < texture.levelSizes.size(); ++mip) { size += texture.levelSizes[mip]; }
+	return size;
+}
+
+bool TextureResidencyManager::isSettled() const
+{
+	for (const TextureState& texture : _textures)
+	{
+		if (!texture.isRemoved && texture.residentMip > texture.requestedMip) { return false; }
+	}
+	return true;
+}
+
+TextureResidencyManager::TextureState& TextureResidencyManager::getTexture(uint32_t textureId)
+{
+	if (textureId >= _textures.size() || _textures[textureId].isRemoved) { throw InvalidArgumentError("textureId", "TextureResidencyManager: Invalid texture"); }
+	return _textures[textureId];
+}
+
+const TextureResidencyManager::TextureState& TextureResidencyManager::getTexture(uint32_t textureId) const
+{
+	if (textureId >= _textures.size() || _textures[textureId].isRemoved) { throw InvalidArgumentError("textureId", "TextureResidencyManager: Invalid texture"); }
+	return _textures[textureId];
+}
+
+// Evicts the finest resident level of the best victim: a texture holding levels finer than requested, or else the texture of lowest priority below
+// belowPriority holding levels above its always resident ones. Among equal priorities, the finest level goes first, as it frees the most memory.
+bool TextureResidencyManager::evictOneLevel(float belowPriority, uint32_t excludedTextureId)
+{
+	uint32_t victim = static_cast<uint32_t>(-1);
+	bool victimIsUnrequested = false;
+	for (uint32_t i = 0; i < _textures.size(); ++i)
+	{
+		const TextureState& texture = _textures[i];
+		if (texture.isRemoved || i == excludedTextureId || texture.residentMip >= texture.alwaysResidentMip) { continue; }
+		const bool isUnrequested = texture.residentMip < texture.requestedMip;
+		if (!isUnrequested && !(texture.priority < belowPriority)) { continue; }
+		if (victim != static_cast<uint32_t>(-1))
+		{
+			const TextureState& best = _textures[victim];
+			if (victimIsUnrequested != isUnrequested)
+			{
+				if (victimIsUnrequested) { continue; }
+			}
+			else if (texture.priority > best.priority || (texture.priority == best.priority && texture.residentMip >= best.residentMip))
+			{
+				continue;
+			}
+		}
+		victim = i;
+		victimIsUnrequested = isUnrequested;
+	}
+	if (victim == static_cast<uint32_t>(-1)) { return false; }
+
+	TextureState& texture = _textures[victim];
+	_usedMemory -= texture.levelSizes[texture.residentMip];
+	++texture.residentMip;
+	return true;
+}
+
+std::vector<TextureResidencyChange> TextureResidencyManager::update(uint64_t maxLoadBytes)
+{
+	std::vector<uint32_t> oldResidentMips(_textures.size());
+	for (uint32_t i = 0; i < _textures.size(); ++i) { oldResidentMips[i] = _textures[i].residentMip; }
+
+	// Honour a reduced budget first.
+	while (_usedMemory > _budget && evictOneLevel(std::numeric_limits<float>::infinity(), static_cast<uint32_t>(-1))) {}
+
+	// Serve the requests by decreasing priority, one level at a time so that the coarse levels of all textures come before the fine levels of any. The always
+	// resident levels are served before everything else, regardless of the budget.
+	struct Candidate
+	{
+		float priority;
+		uint32_t residentMip;
+		uint32_t textureId;
+		bool operator<(const Candidate& rhs) const { return priority < rhs.priority || (priority == rhs.priority && residentMip < rhs.residentMip); }
+	};
+	const auto getCandidate = [this](uint32_t textureId) {
+		const TextureState& texture = _textures[textureId];
+		return Candidate{ texture.residentMip > texture.alwaysResidentMip ? AlwaysResidentPriority : texture.priority, texture.residentMip, textureId };
+	};
+	std::priority_queue<Candidate> candidates;
+	for (uint32_t i = 0; i < _textures.size(); ++i)
+	{
+		if (!_textures[i].isRemoved && _textures[i].residentMip > _textures[i].requestedMip) { candidates.push(getCandidate(i)); }
+	}
+
+	uint64_t loadedBytes = 0;
+	while (!candidates.empty())
+	{
+		const uint32_t textureId = candidates.top().textureId;
+		candidates.pop();
+		TextureState& texture = _textures[textureId];
+		if (texture.residentMip <= texture.requestedMip) { continue; } // Stale: served through another entry
+
+		const uint32_t level = texture.residentMip - 1;
+		const uint64_t size = texture.levelSizes[level];
+		if (loadedBytes && loadedBytes + size > maxLoadBytes) { break; }
+
+		if (level < texture.alwaysResidentMip && _usedMemory + size > _budget)
+		{
+			// Only evict if enough memory can be freed, so that levels are not dropped for nothing.
+			uint64_t freeable = 0;
+			for (uint32_t i = 0; i < _textures.size(); ++i)
+			{
+				const TextureState& other = _textures[i];
+				if (other.isRemoved || i == textureId || (!(other.priority < texture.priority) && other.residentMip >= other.requestedMip)) { continue; }
+				const uint32_t lowestEvictable = other.priority < texture.priority ? other.alwaysResidentMip : other.requestedMip;
+				for (uint32_t mip = other.residentMip; mip < lowestEvictable; ++mip) { freeable += other.levelSizes[mip]; }
+			}
+			if (_usedMemory + size > _budget + freeable) { continue; } // This texture stays as it is until the pressure drops
+			while (_usedMemory + size > _budget && evictOneLevel(texture.priority, textureId)) {}
+			// The estimate above and evictOneLevel must agree on what can be evicted. Should they ever not, stop when there is nothing left to evict
+			// instead of looping forever: the level is not loaded, and the memory freed serves the next candidates.
+			if (_usedMemory + size > _budget) { continue; }
+		}
+
+		texture.residentMip = level;
+		_usedMemory += size;
+		loadedBytes += size;
+		if (texture.residentMip > texture.requestedMip) { candidates.push(getCandidate(textureId)); }
+	}
+
+	std::vector<TextureResidencyChange> changes;
+	for (uint32_t i = 0; i < _textures.size(); ++i)
+	{
+		if (_textures[i].residentMip > oldResidentMips[i]) { changes.push_back(TextureResidencyChange{ i, oldResidentMips[i], _textures[i].residentMip }); }
+	}
+	for (uint32_t i = 0; i < _textures.size(); ++i)
+	{
+		if (_textures[i].residentMip < oldResidentMips[i]) { changes.push_back(TextureResidencyChange{ i, oldResidentMips[i], _textures[i].residentMip }); }
+	}
+	return changes;
+}
+
+uint32_t getMipLevelForScreenSize(uint32_t textureWidth, uint32_t textureHeight, float screenSize, uint32_t numMipLevels)
+{
+	if (!numMipLevels) { return 0; }
+	const float textureSize = static_cast<float>(std::max(textureWidth, textureHeight));
+	if (!(screenSize > 0.f)) { return numMipLevels - 1; }
+	if (screenSize >= textureSize) { return 0; }
+	const float level = std::floor(std::log2(textureSize / screenSize));
+	return std::min(static_cast<uint32_t>(level), numMipLevels - 1);
+}
+} // namespace pvr
+//!\endcond
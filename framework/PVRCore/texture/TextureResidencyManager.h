@@ -0,0 +1,144 @@
+/*!
+\brief Contains an API independent scheduler deciding which mip levels of streamed textures are resident in GPU memory.
+\file PVRCore/texture/TextureResidencyManager.h
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+#pragma once
+#include "PVRCore/texture/TextureHeader.h"
+#include <limits>
+#include <vector>
+
+namespace pvr {
+
+/// <summary>A change of the resident mip levels of a texture, which the caller of TextureResidencyManager::update must apply. The resident levels of a texture
+/// are always a contiguous range from a level down to the smallest (coarsest) level, so a change is described by the finest resident level before and after it.
+/// If newResidentMip is smaller than oldResidentMip, levels newResidentMip to oldResidentMip - 1 must be loaded; otherwise levels oldResidentMip to newResidentMip - 1
+/// must be evicted.</summary>
+struct TextureResidencyChange
+{
+	uint32_t textureId; ///< The texture whose residency changes
+	uint32_t oldResidentMip; ///< The finest resident level before the change. Equal to the number of levels if the texture had no resident level.
+	uint32_t newResidentMip; ///< The finest resident level after the change
+
+	/// <summary>Get whether the change loads levels, as opposed to evicting them.</summary>
+	/// <returns>True if levels are loaded</returns>
+	bool isLoad() const { return newResidentMip < oldResidentMip; }
+};
+
+/// <summary>Decides which mip levels of a set of streamed textures are resident in GPU memory, within a memory budget. It only does the bookkeeping and the
+/// scheduling, and does not touch any graphics API, so that it can be driven and tested without a device: see pvr::utils::TextureStreamer for a Vulkan
+/// implementation uploading the levels.
+///
+/// Each texture keeps its coarsest levels resident at all times, so that it can always be sampled, and finer levels are streamed in one at a time, coarse first,
+/// as they are requested. The application requests a level (e.g. from getMipLevelForScreenSize) and a priority (e.g. the inverse of the distance to the camera)
+/// for each visible texture, then calls update once per frame. Textures of higher priority are served first, and when the budget is full the levels nobody
+/// requested any more, then the finest levels of textures of lower priority, are evicted to make room. Requests persist until they are changed.</summary>
+class TextureResidencyManager
+{
+public:
+	/// <summary>The priority given to the levels which must always be resident.</summary>
+	static constexpr float AlwaysResidentPriority = std::numeric_limits<float>::max();
+
+	/// <summary>Constructor.</summary>
+	/// <param name="budget">The GPU memory available to the streamed textures, in bytes</param>
+	explicit TextureResidencyManager(uint64_t budget) : _budget(budget), _usedMemory(0) {}
+
+	/// <summary>Adds a texture. No level is resident until the next update, which loads its always resident levels.</summary>
+	/// <param name="header">The header of the texture. The size of each level is that of all its array members and faces.</param>
+	/// <param name="numAlwaysResidentLevels">The number of coarsest levels which are loaded first and never evicted. At least 1.</param>
+	/// <returns>The identifier of the texture</returns>
+	uint32_t addTexture(const TextureHeader& header, uint32_t numAlwaysResidentLevels = 1);
+
+	/// <summary>Adds a texture from the sizes of its levels.</summary>
+	/// <param name="levelSizes">The size in bytes of each level, finest (level 0) first</param>
+	/// <param name="numLevels">The number of levels</param>
+	/// <param name="numAlwaysResidentLevels">The number of coarsest levels which are loaded first and never evicted. At least 1.</param>
+	/// <returns>The identifier of the texture</returns>
+	uint32_t addTexture(const uint64_t* levelSizes, uint32_t numLevels, uint32_t numAlwaysResidentLevels = 1);
+
+	/// <summary>Removes a texture, releasing its memory from the budget. The caller frees its GPU resources. Identifiers are not reused.</summary>
+	/// <param name="textureId">The texture to remove</param>
+	void removeTexture(uint32_t textureId);
+
+	/// <summary>Requests the levels of a texture down to a level, with a priority. The request replaces the previous one for this texture.</summary>
+	/// <param name="textureId">The texture</param>
+	/// <param name="mipLevel">The finest level wanted. Clamped to the always resident levels.</param>
+	/// <param name="priority">The priority of the request. Higher is served first, e.g. the inverse of the distance to the camera, or the size on screen.</param>
+	void request(uint32_t textureId, uint32_t mipLevel, float priority);
+
+	/// <summary>Schedules the loads and evictions for this frame, and records them as applied.</summary>
+	/// <param name="maxLoadBytes">The maximum number of bytes to load, to spread the uploads over several frames. At least one level is loaded per update if any
+	/// is pending, even if larger.</param>
+	/// <returns>The changes to apply, evictions first. At most one change per texture.</returns>
+	std::vector<TextureResidencyChange> update(uint64_t maxLoadBytes = std::numeric_limits<uint64_t>::max());
+
+	/// <summary>Sets the memory budget. If lower than the memory used, levels are evicted by the next update.</summary>
+	/// <param name="budget">The GPU memory available to the streamed textures, in bytes</param>
+	void setBudget(uint64_t budget) { _budget = budget; }
+
+	/// <summary>Get the memory budget.</summary>
+	/// <returns>The GPU memory available to the streamed textures, in bytes</returns>
+	uint64_t getBudget() const { return _budget; }
+
+	/// <summary>Get the memory used by the resident levels. Can exceed the budget if the always resident levels do not fit in it.</summary>
+	/// <returns>The memory used, in bytes</returns>
+	uint64_t getUsedMemory() const { return _usedMemory; }
+
+	/// <summary>Get the number of textures added, including the removed ones.</summary>
+	/// <returns>The number of texture identifiers</returns>
+	uint32_t getNumTextures() const { return static_cast<uint32_t>(_textures.size()); }
+
+	/// <summary>Get the number of mip levels of a texture.</summary>
+	/// <param name="textureId">The texture</param>
+	/// <returns>The number of levels</returns>
+	uint32_t getNumMipLevels(uint32_t textureId) const { return static_cast<uint32_t>(getTexture(textureId).levelSizes.size()); }
+
+	/// <summary>Get the finest resident level of a texture.</summary>
+	/// <param name="textureId">The texture</param>
+	/// <returns>The finest resident level, or the number of levels if no level is resident</returns>
+	uint32_t getResidentMip(uint32_t textureId) const { return getTexture(textureId).residentMip; }
+
+	/// <summary>Get the finest level requested for a texture.</summary>
+	/// <param name="textureId">The texture</param>
+	/// <returns>The level requested, clamped to the always resident levels</returns>
+	uint32_t getRequestedMip(uint32_t textureId) const { return getTexture(textureId).requestedMip; }
+
+	/// <summary>Get the memory used by the resident levels of a texture.</summary>
+	/// <param name="textureId">The texture</param>
+	/// <returns>The memory used, in bytes</returns>
+	uint64_t getResidentSize(uint32_t textureId) const;
+
+	/// <summary>Get whether every level requested for every texture is resident.</summary>
+	/// <returns>True if no load is pending</returns>
+	bool isSettled() const;
+
+private:
+	struct TextureState
+	{
+		std::vector<uint64_t> levelSizes;
+		uint32_t residentMip; // The finest resident level, levelSizes.size() if none
+		uint32_t requestedMip;
+		uint32_t alwaysResidentMip; // The finest of the levels never evicted
+		float priority;
+		bool isRemoved;
+	};
+
+	TextureState& getTexture(uint32_t textureId);
+	const TextureState& getTexture(uint32_t textureId) const;
+	bool evictOneLevel(float belowPriority, uint32_t excludedTextureId);
+
+	std::vector<TextureState> _textures;
+	uint64_t _budget;
+	uint64_t _usedMemory;
+};
+
+/// <summary>Computes the mip level of a texture matching its size on screen, i.e. the finest level worth streaming for it. Use the projected size of the
+/// largest object using the texture, scaled by the number of times the texture repeats across it.</summary>
+/// <param name="textureWidth">The width of the texture, at level 0</param>
+/// <param name="textureHeight">The height of the texture, at level 0</param>
+/// <param name="screenSize">The size of the texture on screen, in pixels</param>
+/// <param name="numMipLevels">The number of levels of the texture</param>
+/// <returns>The level whose size is the closest above the size on screen</returns>
+uint32_t getMipLevelForScreenSize(uint32_t textureWidth, uint32_t textureHeight, float screenSize, uint32_t numMipLevels);
+} // namespace pvr
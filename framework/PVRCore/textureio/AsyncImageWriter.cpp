@@ -0,0 +1,185 @@
+/*!
+\brief Implementation of the background writer of captured images.
+\file PVRCore/textureio/AsyncImageWriter.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+#include "PVRCore/textureio/AsyncImageWriter.h"
+#include "PVRCore/stream/FileStream.h"
+#include "PVRCore/textureio/PNGWriter.h"
+#include "PVRCore/textureio/TGAWriter.h"
+#include "PVRCore/textureio/TextureWriterPVR.h"
+#include "PVRCore/Log.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+namespace pvr {
+namespace {
+// Converts the bottom-up BGRA pixels of a capture to top-down RGB, as stored by PNG and PVR files.
+std::vector<unsigned char> toTopDownRGB(const CapturedImage& image)
+{
+	std::vector<unsigned char> result(static_cast<size_t>(image.width) * image.height * 3);
+	for (uint32_t y = 0; y < image.height; ++y)
+	{
+		const unsigned char* src = &image.pixels[static_cast<size_t>(image.height - 1 - y) * image.width * 4];
+		unsigned char* dst = &result[static_cast<size_t>(y) * image.width * 3];
+		for (uint32_t x = 0; x < image.width; ++x, src += 4, dst += 3)
+		{
+			dst[0] = src[2];
+			dst[1] = src[1];
+			dst[2] = src[0];
+		}
+	}
+	return result;
+}
+} // namespace
+
+const char* getCaptureFileExtension(CaptureFileFormat format)
+{
+	switch (format)
+	{
+	case CaptureFileFormat::PNG: return ".png";
+	case CaptureFileFormat::PVR: return ".pvr";
+	case CaptureFileFormat::TGA:
+	default: return ".tga";
+	}
+}
+
+void writeCapturedImage(const CapturedImage& image, CaptureFileFormat format, Stream& stream)
+{
+	if (image.pixels.size() < static_cast<size_t>(image.width) * image.height * 4) { throw InvalidArgumentError("image", "The captured image holds fewer pixels than its size"); }
+	switch (format)
+	{
+	case CaptureFileFormat::TGA: writeTGA(stream, image.width, image.height, image.pixels.data(), 4, image.pixelReplicate); break;
+	case CaptureFileFormat::PNG: writePNG(stream, image.width, image.height, toTopDownRGB(image).data(), 3, image.pixelReplicate); break;
+	case CaptureFileFormat::PVR:
+	{
+		if (image.pixelReplicate == 0 || image.width == 0 || image.height == 0) { throw InvalidArgumentError("image", "Invalid size"); }
+		const std::vector<unsigned char> rgb = toTopDownRGB(image);
+		const uint32_t width = image.width * image.pixelReplicate, height = image.height * image.pixelReplicate;
+		Texture texture(TextureHeader(PixelFormat::RGB_888(), width, height, 1, 1, image.colorSpace, VariableType::UnsignedByteNorm));
+		unsigned char* dst = texture.getDataPointer();
+		for (uint32_t y = 0; y < height; ++y)
+		{
+			const unsigned char* src = &rgb[static_cast<size_t>(y / image.pixelReplicate) * image.width * 3];
+			for (uint32_t x = 0; x < width; ++x, dst += 3) { memcpy(dst, &src[(x / image.pixelReplicate) * 3], 3); }
+		}
+		assetWriters::writePVR(texture, stream);
+		break;
+	}
+	default: throw InvalidArgumentError("format", "Unknown capture file format");
+	}
+}
+
+void writeCapturedImage(const CapturedImage& image, CaptureFileFormat format)
+{
+	FileStream stream(image.filename, "wb");
+	writeCapturedImage(image, format, stream);
+}
+
+AsyncImageWriter::AsyncImageWriter(uint32_t maxQueuedImages)
+	: _maxQueuedImages(std::max(maxQueuedImages, 1u)), _numInProgress(0), _numWritten(0), _numFailed(0), _isExiting(false)
+{
+	_thread = std::thread(&AsyncImageWriter::run, this);
+}
+
+AsyncImageWriter::~AsyncImageWriter()
+{
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		_isExiting = true;
+	}
+	_workAvailable.notify_one();
+	_thread.join();
+}
+
+void AsyncImageWriter::write(CapturedImage&& image, CaptureFileFormat format)
+{
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		_workDone.wait(lock, [this] { return _queue.size() < _maxQueuedImages; });
+		_queue.push_back(Job{ std::move(image), format });
+	}
+	_workAvailable.notify_one();
+}
+
+void AsyncImageWriter::flush()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	_workDone.wait(lock, [this] { return _queue.empty() && !_numInProgress; });
+}
+
+uint32_t AsyncImageWriter::getNumPending() const
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	return static_cast<uint32_t>(_queue.size()) + _numInProgress;
+}
+
+uint32_t AsyncImageWriter::getNumWritten() const
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	return _numWritten;
+}
+
+uint32_t AsyncImageWriter::getNumFailed() const
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	return _numFailed;
+}
+
+void AsyncImageWriter::run()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	for (;;)
+	{
+		// Drain the queue before exiting, so that no capture is lost.
+		_workAvailable.wait(lock, [this] { return _isExiting || !_queue.empty(); });
+		if (_queue.empty()) { return; }
+		Job job = std::move(_queue.front());
+		_queue.pop_front();
+		++_numInProgress;
+		_workDone.notify_all(); // A producer may be waiting for room in the queue
+		lock.unlock();
+
+		bool succeeded = true;
+		try
+		{
+			Log(LogLevel::Information, "Writing screenshot, filename %s.", job.image.filename.c_str());
+			writeCapturedImage(job.image, job.format);
+		}
+		catch (const std::exception& e)
+		{
+			Log(LogLevel::Error, "Screenshot was not written successfully, filename %s: %s", job.image.filename.c_str(), e.what());
+			succeeded = false;
+		}
+
+		lock.lock();
+		--_numInProgress;
+		++(succeeded ? _numWritten : _numFailed);
+		_workDone.notify_all();
+	}
+}
+
+namespace {
+std::atomic<AsyncImageWriter*> screenshotWriter(nullptr);
+} // namespace
+
+void setScreenshotWriter(AsyncImageWriter* writer) { screenshotWriter.store(writer); }
+
+AsyncImageWriter* getScreenshotWriter() { return screenshotWriter.load(); }
+
+void writeScreenshot(CapturedImage&& image, CaptureFileFormat format)
+{
+	AsyncImageWriter* writer = getScreenshotWriter();
+	if (writer)
+	{
+		writer->write(std::move(image), format);
+		return;
+	}
+	Log(LogLevel::Information, "Writing screenshot, filename %s.", image.filename.c_str());
+	writeCapturedImage(image, format);
+}
+} // namespace pvr
+//!\endcond
@@ -0,0 +1,131 @@
+/*!
+\brief Contains a background writer that encodes captured frames (screenshots) to TGA, PNG or PVR files without blocking the render thread.
+\file PVRCore/textureio/AsyncImageWriter.h
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+#pragma once
+#include "PVRCore/stream/Stream.h"
+#include "PVRCore/texture/PixelFormat.h"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace pvr {
+
+/// <summary>The file formats captured images can be saved as.</summary>
+enum class CaptureFileFormat
+{
+	TGA, ///< 32 bit uncompressed TGA, as written by the screenshot functions of PVRUtils. The cheapest to encode.
+	PNG, ///< 24 bit PNG, with uncompressed image data
+	PVR, ///< 24 bit RGB 888 PVR texture, which keeps the colour space of the capture
+};
+
+/// <summary>Get the file extension of a capture file format.</summary>
+/// <param name="format">The file format</param>
+/// <returns>The extension, including the dot (e.g. ".tga")</returns>
+const char* getCaptureFileExtension(CaptureFileFormat format);
+
+/// <summary>An image read back from the GPU, waiting to be saved.</summary>
+struct CapturedImage
+{
+	std::string filename; ///< The file to write the image to
+	uint32_t width; ///< The width of the image
+	uint32_t height; ///< The height of the image
+	std::vector<unsigned char> pixels; ///< BGRA 8888 pixels, row by row from the bottom of the image, as the screenshot functions of PVRUtils read them back
+	ColorSpace colorSpace; ///< The colour space of the pixels. Only stored by the PVR format.
+	uint32_t pixelReplicate; ///< The upscale factor of the saved image
+
+	/// <summary>Constructor. Creates an empty linear image.</summary>
+	CapturedImage() : width(0), height(0), colorSpace(ColorSpace::lRGB), pixelReplicate(1) {}
+};
+
+/// <summary>Encodes a captured image to a stream. This is what AsyncImageWriter runs on its thread, and can be called directly to encode synchronously.
+/// Alpha is only kept by the TGA format (as in the existing screenshots): PNG and PVR files are RGB, as the alpha channel of a swapchain image is usually
+/// meaningless.</summary>
+/// <param name="image">The image to encode. Its filename is ignored.</param>
+/// <param name="format">The file format</param>
+/// <param name="stream">The stream to write to</param>
+void writeCapturedImage(const CapturedImage& image, CaptureFileFormat format, Stream& stream);
+
+/// <summary>Encodes a captured image to the file named by image.filename.</summary>
+/// <param name="image">The image to encode</param>
+/// <param name="format">The file format</param>
+void writeCapturedImage(const CapturedImage& image, CaptureFileFormat format);
+
+/// <summary>Encodes and writes captured images on a background thread, in the order they were queued, so that capturing a range of frames does not
+/// stall the render thread on file IO. The queue is bounded: if the writer falls behind, write() blocks until an image has been written, which limits
+/// the memory held by queued images. Errors are logged and counted, and do not stop the writer.</summary>
+class AsyncImageWriter
+{
+public:
+	/// <summary>Constructor. Starts the writer thread.</summary>
+	/// <param name="maxQueuedImages">The maximum number of images waiting to be written before write() blocks. At least 1.</param>
+	explicit AsyncImageWriter(uint32_t maxQueuedImages = 8);
+
+	/// <summary>Destructor. Writes the queued images, then stops the writer thread.</summary>
+	~AsyncImageWriter();
+
+	/// <summary>Queues an image to be written. Blocks while the queue is full.</summary>
+	/// <param name="image">The image to write. Its pixels are moved into the queue.</param>
+	/// <param name="format">The file format</param>
+	void write(CapturedImage&& image, CaptureFileFormat format);
+
+	/// <summary>Blocks until every queued image has been written.</summary>
+	void flush();
+
+	/// <summary>Get the number of images queued or being written.</summary>
+	/// <returns>The number of images not written yet</returns>
+	uint32_t getNumPending() const;
+
+	/// <summary>Get the number of images written successfully so far.</summary>
+	/// <returns>The number of images written</returns>
+	uint32_t getNumWritten() const;
+
+	/// <summary>Get the number of images which could not be written so far.</summary>
+	/// <returns>The number of failed images</returns>
+	uint32_t getNumFailed() const;
+
+private:
+	struct Job
+	{
+		CapturedImage image;
+		CaptureFileFormat format;
+	};
+
+	void run();
+
+	uint32_t _maxQueuedImages;
+	std::deque<Job> _queue;
+	uint32_t _numInProgress;
+	uint32_t _numWritten;
+	uint32_t _numFailed;
+	bool _isExiting;
+	mutable std::mutex _mutex;
+	std::condition_variable _workAvailable;
+	std::condition_variable _workDone;
+	std::thread _thread;
+
+	AsyncImageWriter(const AsyncImageWriter&) = delete;
+	AsyncImageWriter& operator=(const AsyncImageWriter&) = delete;
+};
+
+/// <summary>Set the writer used by the screenshot functions of PVRUtils (utils::takeScreenshot, utils::saveImage), so that the images they capture are
+/// encoded and written in the background instead of on the render thread. The writer is owned by the caller, which must set the screenshot writer
+/// back to null before destroying it. pvr::Shell sets one while a range of frames is captured (see Shell::setCaptureFrames), flushes it once the last
+/// frame of the range has been rendered, and destroys it, writing any queued image, when the application exits.</summary>
+/// <param name="writer">The screenshot writer, or null to write screenshots synchronously</param>
+void setScreenshotWriter(AsyncImageWriter* writer);
+
+/// <summary>Get the writer used by the screenshot functions of PVRUtils (see setScreenshotWriter).</summary>
+/// <returns>The screenshot writer, or null if screenshots are written synchronously</returns>
+AsyncImageWriter* getScreenshotWriter();
+
+/// <summary>Write a screenshot through the screenshot writer if one is set, otherwise encode and write it before returning.</summary>
+/// <param name="image">The image to write. Its pixels are moved into the queue of the screenshot writer.</param>
+/// <param name="format">The file format</param>
+void writeScreenshot(CapturedImage&& image, CaptureFileFormat format);
+} // namespace pvr
@@ -0,0 +1,152 @@
+/*!
+\brief Defines used internally by the KTX2 reader.
+\file PVRCore/textureio/FileDefinesKTX2.h
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+#pragma once
+#include <cstdint>
+
+namespace pvr {
+namespace texture_ktx2 {
+/// <summary>KTX2 file header, including the index of the data format descriptor, key/value data and supercompression global data</summary>
+struct FileHeader
+{
+	uint8_t identifier[12]; //!< The identifier used for KTX2 files
+	uint32_t vkFormat; //!< The Vulkan format of the texture data. VK_FORMAT_UNDEFINED for formats described only by the data format descriptor
+	uint32_t typeSize; //!< The size of the data type, used for endianness conversion
+	uint32_t pixelWidth; //!< The width of the texture in pixels
+	uint32_t pixelHeight; //!< The height of the texture in pixels. 0 for 1D textures
+	uint32_t pixelDepth; //!< The depth of the texture in pixels. 0 for 1D and 2D textures
+	uint32_t layerCount; //!< The number of array layers. 0 if the texture is not an array
+	uint32_t faceCount; //!< The number of faces (6 for cube maps, otherwise 1)
+	uint32_t levelCount; //!< The number of mip map levels. 0 requests that the mip map levels are generated at load time
+	uint32_t supercompressionScheme; //!< The supercompression scheme applied to every mip map level (see SupercompressionScheme)
+	uint32_t dfdByteOffset; //!< The offset of the data format descriptor
+	uint32_t dfdByteLength; //!< The size of the data format descriptor
+	uint32_t kvdByteOffset; //!< The offset of the key/value data
+	uint32_t kvdByteLength; //!< The size of the key/value data
+	uint64_t sgdByteOffset; //!< The offset of the supercompression global data
+	uint64_t sgdByteLength; //!< The size of the supercompression global data
+};
+
+/// <summary>An entry of the level index, which follows the header and locates each mip map level in the file</summary>
+struct LevelIndexEntry
+{
+	uint64_t byteOffset; //!< The offset of the level data from the start of the file
+	uint64_t byteLength; //!< The size of the level data in the file
+	uint64_t uncompressedByteLength; //!< The size of the level data once supercompression has been removed
+};
+
+/// <summary>Supercompression schemes defined by the KTX2 specification</summary>
+enum class SupercompressionScheme : uint32_t
+{
+	None = 0,
+	BasisLZ = 1,
+	Zstandard = 2,
+	ZLIB = 3,
+};
+
+// Magic identifier
+static const uint8_t c_identifier[] = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+
+// Size of the header (including the index) in file
+static const uint32_t c_headerSize = 80;
+
+// Size of a level index entry in file
+static const uint32_t c_levelIndexEntrySize = 24;
+
+// Identifier for the orientation meta data
+static const char c_orientationMetaDataKey[] = "KTXorientation";
+
+namespace VulkanFormats {
+/// <summary>The Vulkan formats understood by the KTX2 reader</summary>
+enum Enum
+{
+	VK_FORMAT_UNDEFINED = 0,
+	VK_FORMAT_R4G4B4A4_UNORM_PACK16 = 2,
+	VK_FORMAT_R5G6B5_UNORM_PACK16 = 4,
+	VK_FORMAT_R5G5B5A1_UNORM_PACK16 = 6,
+	VK_FORMAT_R8_UNORM = 9,
+	VK_FORMAT_R8_SNORM = 10,
+	VK_FORMAT_R8_UINT = 13,
+	VK_FORMAT_R8_SINT = 14,
+	VK_FORMAT_R8_SRGB = 15,
+	VK_FORMAT_R8G8_UNORM = 16,
+	VK_FORMAT_R8G8_SNORM = 17,
+	VK_FORMAT_R8G8_UINT = 20,
+	VK_FORMAT_R8G8_SINT = 21,
+	VK_FORMAT_R8G8_SRGB = 22,
+	VK_FORMAT_R8G8B8_UNORM = 23,
+	VK_FORMAT_R8G8B8_SNORM = 24,
+	VK_FORMAT_R8G8B8_UINT = 27,
+	VK_FORMAT_R8G8B8_SINT = 28,
+	VK_FORMAT_R8G8B8_SRGB = 29,
+	VK_FORMAT_B8G8R8_UNORM = 30,
+	VK_FORMAT_B8G8R8_SRGB = 36,
+	VK_FORMAT_R8G8B8A8_UNORM = 37,
+	VK_FORMAT_R8G8B8A8_SNORM = 38,
+	VK_FORMAT_R8G8B8A8_UINT = 41,
+	VK_FORMAT_R8G8B8A8_SINT = 42,
+	VK_FORMAT_R8G8B8A8_SRGB = 43,
+	VK_FORMAT_B8G8R8A8_UNORM = 44,
+	VK_FORMAT_B8G8R8A8_SRGB = 50,
+	VK_FORMAT_R16_UNORM = 70,
+	VK_FORMAT_R16_UINT = 74,
+	VK_FORMAT_R16_SFLOAT = 76,
+	VK_FORMAT_R16G16_UNORM = 77,
+	VK_FORMAT_R16G16_UINT = 81,
+	VK_FORMAT_R16G16_SFLOAT = 83,
+	VK_FORMAT_R16G16B16_SFLOAT = 90,
+	VK_FORMAT_R16G16B16A16_UNORM = 91,
+	VK_FORMAT_R16G16B16A16_UINT = 95,
+	VK_FORMAT_R16G16B16A16_SFLOAT = 97,
+	VK_FORMAT_R32_UINT = 98,
+	VK_FORMAT_R32_SFLOAT = 100,
+	VK_FORMAT_R32G32_UINT = 101,
+	VK_FORMAT_R32G32_SFLOAT = 103,
+	VK_FORMAT_R32G32B32_SFLOAT = 106,
+	VK_FORMAT_R32G32B32A32_UINT = 107,
+	VK_FORMAT_R32G32B32A32_SFLOAT = 109,
+	VK_FORMAT_B10G11R11_UFLOAT_PACK32 = 122,
+	VK_FORMAT_E5B9G9R9_UFLOAT_PACK32 = 123,
+	VK_FORMAT_BC1_RGB_UNORM_BLOCK = 131,
+	VK_FORMAT_BC1_RGB_SRGB_BLOCK = 132,
+	VK_FORMAT_BC1_RGBA_UNORM_BLOCK = 133,
+	VK_FORMAT_BC1_RGBA_SRGB_BLOCK = 134,
+	VK_FORMAT_BC2_UNORM_BLOCK = 135,
+	VK_FORMAT_BC2_SRGB_BLOCK = 136,
+	VK_FORMAT_BC3_UNORM_BLOCK = 137,
+	VK_FORMAT_BC3_SRGB_BLOCK = 138,
+	VK_FORMAT_BC4_UNORM_BLOCK = 139,
+	VK_FORMAT_BC4_SNORM_BLOCK = 140,
+	VK_FORMAT_BC5_UNORM_BLOCK = 141,
+	VK_FORMAT_BC5_SNORM_BLOCK = 142,
+	VK_FORMAT_BC6H_UFLOAT_BLOCK = 143,
+	VK_FORMAT_BC6H_SFLOAT_BLOCK = 144,
+	VK_FORMAT_BC7_UNORM_BLOCK = 145,
+	VK_FORMAT_BC7_SRGB_BLOCK = 146,
+	VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK = 147,
+	VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK = 148,
+	VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK = 149,
+	VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK = 150,
+	VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK = 151,
+	VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK = 152,
+	VK_FORMAT_EAC_R11_UNORM_BLOCK = 153,
+	VK_FORMAT_EAC_R11_SNORM_BLOCK = 154,
+	VK_FORMAT_EAC_R11G11_UNORM_BLOCK = 155,
+	VK_FORMAT_EAC_R11G11_SNORM_BLOCK = 156,
+	VK_FORMAT_ASTC_4x4_UNORM_BLOCK = 157, // The 2D ASTC formats follow in the order of CompressedPixelFormat, alternating UNORM and SRGB
+	VK_FORMAT_ASTC_12x12_SRGB_BLOCK = 184,
+	VK_FORMAT_PVRTC1_2BPP_UNORM_BLOCK_IMG = 1000054000,
+	VK_FORMAT_PVRTC1_4BPP_UNORM_BLOCK_IMG = 1000054001,
+	VK_FORMAT_PVRTC2_2BPP_UNORM_BLOCK_IMG = 1000054002,
+	VK_FORMAT_PVRTC2_4BPP_UNORM_BLOCK_IMG = 1000054003,
+	VK_FORMAT_PVRTC1_2BPP_SRGB_BLOCK_IMG = 1000054004,
+	VK_FORMAT_PVRTC1_4BPP_SRGB_BLOCK_IMG = 1000054005,
+	VK_FORMAT_PVRTC2_2BPP_SRGB_BLOCK_IMG = 1000054006,
+	VK_FORMAT_PVRTC2_4BPP_SRGB_BLOCK_IMG = 1000054007,
+};
+} // namespace VulkanFormats
+} // namespace texture_ktx2
+} // namespace pvr
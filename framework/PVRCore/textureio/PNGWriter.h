@@ -0,0 +1,172 @@
+/*!
+\brief Contains a function to write PNG data to a file
+\file PVRCore/textureio/PNGWriter.h
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+#pragma once
+#include "PVRCore/stream/FileStream.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace pvr {
+namespace impl {
+/// <summary>Computes the CRC-32 (ISO 3309) checksum used by PNG chunks.</summary>
+/// <param name="crc">The checksum of the previous data, or 0 for the first block</param>
+/// <param name="data">The data to checksum</param>
+/// <param name="size">The size of the data in bytes</param>
+/// <returns>The updated checksum</returns>
+inline uint32_t updatePNGCrc(uint32_t crc, const unsigned char* data, size_t size)
+{
+	static const std::vector<uint32_t> table = [] {
+		std::vector<uint32_t> result(256);
+		for (uint32_t i = 0; i < 256; ++i)
+		{
+			uint32_t value = i;
+			for (uint32_t bit = 0; bit < 8; ++bit) { value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : value >> 1; }
+			result[i] = value;
+		}
+		return result;
+	}();
+	crc = ~crc;
+	for (size_t i = 0; i < size; ++i) { crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8); }
+	return ~crc;
+}
+
+/// <summary>Appends a 32 bit value in big endian order, as PNG stores all its integers.</summary>
+/// <param name="out">The vector to append to</param>
+/// <param name="value">The value to append</param>
+inline void appendPNGUint32(std::vector<unsigned char>& out, uint32_t value)
+{
+	out.push_back(static_cast<unsigned char>(value >> 24));
+	out.push_back(static_cast<unsigned char>(value >> 16));
+	out.push_back(static_cast<unsigned char>(value >> 8));
+	out.push_back(static_cast<unsigned char>(value));
+}
+
+/// <summary>Writes a PNG chunk: its length, type, data and CRC.</summary>
+/// <param name="file">The stream to write to</param>
+/// <param name="type">The four character type of the chunk</param>
+/// <param name="data">The data of the chunk</param>
+inline void writePNGChunk(Stream& file, const char* type, const std::vector<unsigned char>& data)
+{
+	std::vector<unsigned char> header;
+	appendPNGUint32(header, static_cast<uint32_t>(data.size()));
+	header.insert(header.end(), type, type + 4);
+	uint32_t crc = updatePNGCrc(0, header.data() + 4, 4);
+	crc = updatePNGCrc(crc, data.data(), data.size());
+	std::vector<unsigned char> footer;
+	appendPNGUint32(footer, crc);
+
+	file.writeExact(1, header.size(), header.data());
+	if (!data.empty()) { file.writeExact(1, data.size(), data.data()); }
+	file.writeExact(1, footer.size(), footer.data());
+}
+} // namespace impl
+
+/// <summary>Write out PNG data from an image. The image data is stored uncompressed (in deflate 'stored' blocks), which makes writing fast at the cost of
+/// file size; any PNG reader can open the files.</summary>
+/// <param name="file">Stream to write the PNG into</param>
+/// <param name="w">The width of the image</param>
+/// <param name="h">The height of the image</param>
+/// <param name="imageData">Pointer to the raw image data: RGB or RGBA pixels, row by row from the top of the image</param>
+/// <param name="stride">Size in bytes of each pixel: 3 for RGB, 4 for RGBA</param>
+/// <param name="pixelReplicate">Upscale factor.</param>
+inline void writePNG(pvr::Stream& file, uint32_t w, uint32_t h, const unsigned char* imageData, const uint32_t stride, uint32_t pixelReplicate = 1)
+{
+	if (!file.isWritable()) { throw InvalidOperationError("[writePNG]: Attempted to write to non-writable stream"); }
+	if (pixelReplicate == 0 || w == 0 || h == 0) { throw InvalidArgumentError("writePNG: Invalid size."); }
+	if (stride != 3 && stride != 4) { throw InvalidArgumentError("writePNG: Only RGB and RGBA images are supported."); }
+	if (!imageData) { throw InvalidArgumentError("writePNG: Pointer to data was null"); }
+
+	const uint32_t outWidth = w * pixelReplicate, outHeight = h * pixelReplicate;
+	const size_t rowSize = 1 + static_cast<size_t>(outWidth) * stride; // Each row starts with its filter type, which is always 0 (none)
+
+	static const unsigned char signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+	file.writeExact(1, sizeof(signature), signature);
+
+	std::vector<unsigned char> header;
+	impl::appendPNGUint32(header, outWidth);
+	impl::appendPNGUint32(header, outHeight);
+	header.push_back(8); // Bit depth
+	header.push_back(stride == 4 ? 6 : 2); // Colour type: RGBA or RGB
+	header.push_back(0); // Compression method: deflate
+	header.push_back(0); // Filter method
+	header.push_back(0); // No interlacing
+	impl::writePNGChunk(file, "IHDR", header);
+
+	// Build the filtered scanlines, then wrap them into a zlib stream of stored blocks of at most 65535 bytes each.
+	std::vector<unsigned char> scanlines(rowSize * outHeight);
+	for (uint32_t y = 0; y < outHeight; ++y)
+	{
+		unsigned char* dst = &scanlines[rowSize * y];
+		const unsigned char* src = &imageData[static_cast<size_t>(stride) * w * (y / pixelReplicate)];
+		*dst++ = 0;
+		if (pixelReplicate == 1) { memcpy(dst, src, static_cast<size_t>(w) * stride); }
+		else
+		{
+			for (uint32_t x = 0; x < outWidth; ++x, dst += stride) { memcpy(dst, &src[stride * (x / pixelReplicate)], stride); }
+		}
+	}
+
+	const size_t maxBlockSize = 65535;
+	const size_t numBlocks = (scanlines.size() + maxBlockSize - 1) / maxBlockSize;
+	std::vector<unsigned char> imageChunk;
+	imageChunk.reserve(2 + scanlines.size() + numBlocks * 5 + 4);
+	imageChunk.push_back(0x78); // zlib header: deflate with a 32K window, no dictionary
+	imageChunk.push_back(0x01);
+	uint32_t adlerA = 1, adlerB = 0;
+	for (size_t offset = 0; offset < scanlines.size(); offset += maxBlockSize)
+	{
+		const size_t blockSize = std::min(maxBlockSize, scanlines.size() - offset);
+		imageChunk.push_back(offset + blockSize == scanlines.size() ? 1 : 0); // Final block flag, block type 0 (stored)
+		imageChunk.push_back(static_cast<unsigned char>(blockSize));
+		imageChunk.push_back(static_cast<unsigned char>(blockSize >> 8));
+		imageChunk.push_back(static_cast<unsigned char>(~blockSize));
+		imageChunk.push_back(static_cast<unsigned char>(~blockSize >> 8));
+		imageChunk.insert(imageChunk.end(), scanlines.begin() + static_cast<std::ptrdiff_t>(offset), scanlines.begin() + static_cast<std::ptrdiff_t>(offset + blockSize));
+
+		// The Adler-32 sums can be accumulated for 5552 bytes before they need to be reduced.
+		for (size_t i = 0; i < blockSize; i += 5552)
+		{
+			const size_t end = std::min(blockSize, i + 5552);
+			for (size_t j = i; j < end; ++j)
+			{
+				adlerA += scanlines[offset + j];
+				adlerB += adlerA;
+			}
+			adlerA %= 65521;
+			adlerB %= 65521;
+		}
+	}
+	impl::appendPNGUint32(imageChunk, (adlerB << 16) | adlerA);
+	impl::writePNGChunk(file, "IDAT", imageChunk);
+	impl::writePNGChunk(file, "IEND", std::vector<unsigned char>());
+}
+
+/// <summary>Write out PNG data from an image.</summary>
+/// <param name="file">Stream to write the PNG into</param>
+/// <param name="w">The width of the image</param>
+/// <param name="h">The height of the image</param>
+/// <param name="imageData">Pointer to the raw image data: RGB or RGBA pixels, row by row from the top of the image</param>
+/// <param name="stride">Size in bytes of each pixel: 3 for RGB, 4 for RGBA</param>
+/// <param name="pixelReplicate">Upscale factor.</param>
+inline void writePNG(pvr::Stream&& file, uint32_t w, uint32_t h, const unsigned char* imageData, const uint32_t stride, uint32_t pixelReplicate = 1)
+{
+	writePNG(file, w, h, imageData, stride, pixelReplicate);
+}
+
+/// <summary>Write out PNG data from an image.</summary>
+/// <param name="filename">Filename for which a filestream will be created to write the PNG into</param>
+/// <param name="w">The width of the image</param>
+/// <param name="h">The height of the image</param>
+/// <param name="imageData">Pointer to the raw image data: RGB or RGBA pixels, row by row from the top of the image</param>
+/// <param name="stride">Size in bytes of each pixel: 3 for RGB, 4 for RGBA</param>
+/// <param name="pixelReplicate">Upscale factor.</param>
+inline void writePNG(const char* filename, uint32_t w, uint32_t h, const unsigned char* imageData, const uint32_t stride, uint32_t pixelReplicate = 1)
+{
+	FileStream fs(filename, "wb");
+	writePNG(fs, w, h, imageData, stride, pixelReplicate);
+}
+} // namespace pvr
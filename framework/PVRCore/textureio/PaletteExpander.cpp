@@ -5,11 +5,50 @@
 \copyright Copyright (c) Imagination Technologies Limited.
 */
 //!\cond NO_DOXYGEN
+#include <algorithm>
 #include <cstring>
+#include <vector>
 #include "PaletteExpander.h"
 #include "PVRCore/Errors.h"
 
 namespace pvr {
+namespace {
+inline uint32_t readIndex(const uint8_t* indices, uint32_t i, uint32_t bytesPerIndex)
+{
+	return bytesPerIndex == 1 ? indices[i] : static_cast<uint32_t>(indices[i * 2] | (indices[i * 2 + 1] << 8));
+}
+
+// Copies of a compile-time size turn into a single load and store per pixel.
+template<uint32_t EntrySize>
+void expand(const uint8_t* palette, const uint8_t* indices, uint32_t numIndices, uint32_t bytesPerIndex, uint8_t* outputData)
+{
+	if (bytesPerIndex == 1)
+	{
+		for (uint32_t i = 0; i < numIndices; ++i) { memcpy(outputData + i * EntrySize, palette + indices[i] * EntrySize, EntrySize); }
+	}
+	else
+	{
+		for (uint32_t i = 0; i < numIndices; ++i) { memcpy(outputData + i * EntrySize, palette + readIndex(indices, i, 2) * EntrySize, EntrySize); }
+	}
+}
+
+// Three byte entries are padded to four so that each pixel is a single four byte store, the extra byte being overwritten by the next pixel. The last
+// pixel is written on its own so as not to write past the end of the output.
+void expand3(const uint8_t* palette, uint32_t numEntries, const uint8_t* indices, uint32_t numIndices, uint32_t bytesPerIndex, uint8_t* outputData)
+{
+	// Padding the palette only pays off when there are more pixels than palette entries.
+	if (numIndices < numEntries)
+	{
+		expand<3>(palette, indices, numIndices, bytesPerIndex, outputData);
+		return;
+	}
+	std::vector<uint32_t> padded(numEntries);
+	for (uint32_t i = 0; i < numEntries; ++i) { memcpy(&padded[i], palette + i * 3, 3); }
+	for (uint32_t i = 0; i < numIndices - 1; ++i) { memcpy(outputData + i * 3, &padded[readIndex(indices, i, bytesPerIndex)], 4); }
+	memcpy(outputData + (numIndices - 1) * 3, palette + readIndex(indices, numIndices - 1, bytesPerIndex) * 3, 3);
+}
+} // namespace
+
 PaletteExpander::PaletteExpander(const uint8_t* paletteData, uint32_t paletteSize, uint32_t bytesPerEntry)
 	: _paletteData(paletteData), _paletteSize(paletteSize), _bytesPerEntry(bytesPerEntry)
 {}
@@ -20,5 +59,50 @@ void PaletteExpander::getColorFromIndex(uint32_t index, unsigned char* outputDat
 	if (index >= (_paletteSize / _bytesPerEntry)) { throw IndexOutOfRange("[PaletteExpander::getColorFromIndex]", index, _paletteSize / _bytesPerEntry); }
 	memcpy(outputData, &(_paletteData[index * _bytesPerEntry]), _bytesPerEntry);
 }
+
+void PaletteExpander::expandIndices(const uint8_t* indices, uint32_t numIndices, uint32_t bytesPerIndex, uint8_t* outputData) const
+{
+	if (!(_paletteData != 0 && _paletteSize != 0 && _bytesPerEntry != 0)) { throw InvalidOperationError("[PaletteExpander::expandIndices]: Palette Expander was invalid."); }
+	if (bytesPerIndex != 1 && bytesPerIndex != 2) { throw InvalidArgumentError("bytesPerIndex", "[PaletteExpander::expandIndices]: Indices must be 1 or 2 bytes."); }
+	if (numIndices == 0) { return; }
+
+	// Validate all the indices up front, so that the expansion loops do not need to.
+	const uint32_t numEntries = _paletteSize / _bytesPerEntry;
+	uint32_t maxIndex = 0;
+	for (uint32_t i = 0; i < numIndices; ++i) { maxIndex = std::max(maxIndex, readIndex(indices, i, bytesPerIndex)); }
+	if (maxIndex >= numEntries) { throw IndexOutOfRange("[PaletteExpander::expandIndices]", maxIndex, numEntries); }
+
+	switch (_bytesPerEntry)
+	{
+	case 1: expand<1>(_paletteData, indices, numIndices, bytesPerIndex, outputData); break;
+	case 2: expand<2>(_paletteData, indices, numIndices, bytesPerIndex, outputData); break;
+	case 3: expand3(_paletteData, numEntries, indices, numIndices, bytesPerIndex, outputData); break;
+	case 4: expand<4>(_paletteData, indices, numIndices, bytesPerIndex, outputData); break;
+	default:
+		for (uint32_t i = 0; i < numIndices; ++i) { memcpy(outputData + i * _bytesPerEntry, _paletteData + readIndex(indices, i, bytesPerIndex) * _bytesPerEntry, _bytesPerEntry); }
+	}
+}
+
+void PaletteExpander::expandPackedIndices(const uint8_t* packedIndices, uint32_t numIndices, uint32_t bitsPerIndex, uint8_t* outputData) const
+{
+	if (bitsPerIndex == 8)
+	{
+		expandIndices(packedIndices, numIndices, 1, outputData);
+		return;
+	}
+	if (bitsPerIndex != 1 && bitsPerIndex != 2 && bitsPerIndex != 4)
+	{ throw InvalidArgumentError("bitsPerIndex", "[PaletteExpander::expandPackedIndices]: Packed indices must be 1, 2, 4 or 8 bits."); }
+
+	// Unpack to one byte per index, then expand those.
+	const uint32_t indicesPerByte = 8 / bitsPerIndex;
+	const uint8_t indexMask = static_cast<uint8_t>(0xffu >> (8 - bitsPerIndex));
+	std::vector<uint8_t> indices(numIndices);
+	for (uint32_t i = 0; i < numIndices; ++i)
+	{
+		const uint32_t bitShift = 8 - bitsPerIndex * (i % indicesPerByte + 1);
+		indices[i] = static_cast<uint8_t>((packedIndices[i / indicesPerByte] >> bitShift) & indexMask);
+	}
+	expandIndices(indices.data(), numIndices, 1, outputData);
+}
 } // namespace pvr
 //!\endcond
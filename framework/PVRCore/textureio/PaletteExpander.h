@@ -24,6 +24,20 @@ public:
 	/// <param name="outputData">A pointer to the palette color for the specified index is returned here</param>
 	void getColorFromIndex(uint32_t index, unsigned char* outputData) const;
 
+	/// <summary>Gets the colors of an array of indices, writing them contiguously. All the indices are validated before anything is written.</summary>
+	/// <param name="indices">The indices. Multi-byte indices are little endian.</param>
+	/// <param name="numIndices">The number of indices</param>
+	/// <param name="bytesPerIndex">The size of each index in bytes (1 or 2)</param>
+	/// <param name="outputData">The colors are written here. Must have space for numIndices entries of the palette.</param>
+	void expandIndices(const uint8_t* indices, uint32_t numIndices, uint32_t bytesPerIndex, uint8_t* outputData) const;
+
+	/// <summary>Gets the colors of an array of indices packed several to a byte, most significant bits first, writing them contiguously.</summary>
+	/// <param name="packedIndices">The packed indices</param>
+	/// <param name="numIndices">The number of indices</param>
+	/// <param name="bitsPerIndex">The size of each index in bits (1, 2, 4 or 8)</param>
+	/// <param name="outputData">The colors are written here. Must have space for numIndices entries of the palette.</param>
+	void expandPackedIndices(const uint8_t* packedIndices, uint32_t numIndices, uint32_t bitsPerIndex, uint8_t* outputData) const;
+
 private:
 	const uint8_t* _paletteData;
 	const uint32_t _paletteSize;
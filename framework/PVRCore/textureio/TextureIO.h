@@ -2,6 +2,7 @@
 #include "TextureReaderBMP.h"
 #include "TextureReaderDDS.h"
 #include "TextureReaderKTX.h"
+#include "TextureReaderKTX2.h"
 #include "TextureReaderPVR.h"
 #include "TextureReaderTGA.h"
 #include "TextureReaderXNB.h"
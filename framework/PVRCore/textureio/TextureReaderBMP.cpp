@@ -87,37 +87,18 @@ void loadIndexed(const Stream& stream, const texture_bmp::FileHeader& fileheader
 	uint32_t bytesPerScanline = (asset.getWidth() + (indicesPerByte - 1)) / indicesPerByte;
 	uint32_t scanlinePadding = (((-1 * bytesPerScanline) % rowAlignment) * 8) / 8;
 
-	// Work out the bit mask of the index value
-	uint8_t indexMask = 0xffu >> (8 - bitsPerDataEntry);
-
-	// Start reading data
+	// Start reading data, a whole scan line of indices at a time
 	unsigned char* outputPixel = asset.getDataPointer();
-	uint8_t currentIndexData = 0;
+	vector<uint8_t> scanline(bytesPerScanline);
 	for (uint32_t y = 0; y < (asset.getHeight()); ++y)
 	{
-		for (uint32_t x = 0; x < (asset.getWidth()); x += indicesPerByte)
-		{
-			// Read the next char of indices
-			stream.readExact(1, 1, &currentIndexData);
-
-			// Loop through all the indices in the char
-			for (uint32_t indexPosition = 0; indexPosition < indicesPerByte; ++indexPosition)
-			{
-				if ((x + indexPosition) < asset.getWidth())
-				{
-					// Mask out the actual index from the current index data
-					uint8_t bitShift = static_cast<uint8_t>(8 - (bitsPerDataEntry * (indexPosition + 1)));
+		stream.readExact(1, bytesPerScanline, scanline.data());
 
-					uint8_t actualIndex = static_cast<uint8_t>((currentIndexData & (indexMask << (bitShift))) >> (bitShift));
+		// Get the color output
+		paletteLookup.expandPackedIndices(scanline.data(), asset.getWidth(), bitsPerDataEntry, outputPixel);
 
-					// Get the color output - don't need to check for errors, as the out of bounds condition is impossible due to the mask.
-					paletteLookup.getColorFromIndex(actualIndex, outputPixel);
-
-					// Increment the pixel
-					outputPixel += bytesPerPaletteEntry;
-				}
-			}
-		}
+		// Increment the pixel
+		outputPixel += asset.getWidth() * bytesPerPaletteEntry;
 
 		// seek past the scan line padding
 		stream.seek(static_cast<long>(scanlinePadding), Stream::SeekOriginFromCurrent);
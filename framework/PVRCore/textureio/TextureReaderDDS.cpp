@@ -877,10 +877,17 @@ bool setDirectXGIFormat(pvr::TextureHeader& hd, uint32_t dxgiFormat)
 		hd.setChannelType(pvr::VariableType::UnsignedByteNorm);
 		return true;
 	}
+	case pvr::texture_dds::DXGI_FORMAT_BC6H_UF16:
+	{
+		hd.setPixelFormat(pvr::CompressedPixelFormat::BC6);
+		hd.setColorSpace(pvr::ColorSpace::lRGB);
+		hd.setChannelType(pvr::VariableType::UnsignedFloat);
+		return true;
+	}
 	case pvr::texture_dds::DXGI_FORMAT_BC6H_SF16:
 	{
-		hd.setPixelFormat(pvr::CompressedPixelFormat::BC7);
-		hd.setColorSpace(pvr::ColorSpace::sRGB);
+		hd.setPixelFormat(pvr::CompressedPixelFormat::BC6);
+		hd.setColorSpace(pvr::ColorSpace::lRGB);
 		hd.setChannelType(pvr::VariableType::SignedFloat);
 		return true;
 	}
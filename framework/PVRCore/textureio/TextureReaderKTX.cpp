@@ -8,9 +8,84 @@
 #include "PVRCore/textureio/TextureReaderKTX.h"
 #include "PVRCore/textureio/FileDefinesKTX.h"
 #include "PVRCore/texture/TextureDefines.h"
+#include "PVRCore/texture/ParallelDecompress.h"
 
 namespace {
 inline uint64_t textureOffset3D(uint64_t x, uint64_t y, uint64_t z, uint64_t width, uint64_t height) { return ((x) + (y * width) + (z * width * height)); }
+
+// The location of one surface (a face of an array member of a mip level) in a KTX file.
+struct KtxSurface
+{
+	uint64_t fileOffset;
+	uint32_t mipMapLevel;
+	uint32_t arrayMember;
+	uint32_t face;
+};
+
+/// <summary>Read the data of a KTX texture with positional reads issued from several threads. The offset of every surface is worked out first from the
+/// image sizes stored in the file. Each surface is then read, and its scan line padding removed, independently of the others.</summary>
+/// <param name="stream">A stream that supports concurrent reads</param>
+/// <param name="dataOffset">The offset of the first image size field in the stream</param>
+/// <param name="asset">The texture to read into. Must already be allocated.</param>
+/// <param name="hasScanLinePadding">True if the rows of the images are padded to 4 bytes (uncompressed formats)</param>
+/// <param name="maxThreads">The maximum number of threads (see TextureLoadOptions)</param>
+void readKTXDataParallel(const pvr::Stream& stream, uint64_t dataOffset, pvr::Texture& asset, bool hasScanLinePadding, uint32_t maxThreads)
+{
+	const bool isCubeMap = asset.getNumFaces() == 6 && asset.getNumArrayMembers() == 1;
+	std::vector<KtxSurface> surfaces;
+	surfaces.reserve(asset.getNumMipMapLevels() * asset.getNumArrayMembers() * asset.getNumFaces());
+
+	uint64_t offset = dataOffset;
+	for (uint32_t mipMapLevel = 0; mipMapLevel < asset.getNumMipMapLevels(); ++mipMapLevel)
+	{
+		uint32_t mipMapSize = 0;
+		stream.readAt(offset, sizeof(mipMapSize), 1, &mipMapSize);
+		offset += sizeof(mipMapSize);
+
+		// Sanity check the size - regular cube maps are a slight exception
+		if (mipMapSize != (isCubeMap ? asset.getDataSize(mipMapLevel, false, false) : asset.getDataSize(mipMapLevel)))
+		{ throw pvr::InvalidOperationError("[TextureReaderKTX::readAsset_]: Mipmap size read was not expected size."); }
+
+		const uint32_t faceSize = asset.getDataSize(mipMapLevel, false, false);
+		const uint32_t cubePadding = isCubeMap ? (3 - ((faceSize + 3) % 4)) : 0;
+		uint64_t storedFaceSize = faceSize;
+		if (hasScanLinePadding)
+		{
+			const uint64_t rowSize = (asset.getBitsPerPixel() / 8) * asset.getWidth(mipMapLevel);
+			storedFaceSize = ((rowSize + 3) & ~3ull) * asset.getHeight(mipMapLevel) * asset.getDepth(mipMapLevel);
+		}
+
+		for (uint32_t iSurface = 0; iSurface < asset.getNumArrayMembers(); ++iSurface)
+		{
+			for (uint32_t iFace = 0; iFace < asset.getNumFaces(); ++iFace)
+			{
+				surfaces.push_back(KtxSurface{ offset, mipMapLevel, iSurface, iFace });
+				offset += storedFaceSize + cubePadding;
+			}
+		}
+		// Skip the MIP Map padding, worked out exactly like the sequential reader does.
+		offset += 3 - ((mipMapSize + 3) % 4);
+	}
+
+	const uint32_t numSurfaces = static_cast<uint32_t>(surfaces.size());
+	pvr::impl::parallelForEachItem(numSurfaces, pvr::impl::getDecompressionThreadCount(maxThreads, numSurfaces, 1), [&](uint32_t item) {
+		const KtxSurface& surface = surfaces[item];
+		unsigned char* destination = asset.getDataPointer(surface.mipMapLevel, surface.arrayMember, surface.face);
+		const uint32_t faceSize = asset.getDataSize(surface.mipMapLevel, false, false);
+		const uint32_t rowSize = (asset.getBitsPerPixel() / 8) * asset.getWidth(surface.mipMapLevel);
+		const uint32_t paddedRowSize = (rowSize + 3) & ~3u;
+		if (!hasScanLinePadding || rowSize == paddedRowSize)
+		{
+			stream.readAt(surface.fileOffset, faceSize, 1, destination);
+			return;
+		}
+		// Read the padded rows in one go, then pack them.
+		const uint32_t numRows = asset.getHeight(surface.mipMapLevel) * asset.getDepth(surface.mipMapLevel);
+		std::vector<unsigned char> paddedData(static_cast<size_t>(paddedRowSize) * numRows);
+		stream.readAt(surface.fileOffset, 1, paddedData.size(), paddedData.data());
+		for (uint32_t row = 0; row < numRows; ++row) { memcpy(destination + static_cast<size_t>(row) * rowSize, paddedData.data() + static_cast<size_t>(row) * paddedRowSize, rowSize); }
+	});
+}
 bool setopenGLFormat(pvr::TextureHeader& hd, uint32_t glInternalFormat, uint32_t, uint32_t glType)
 {
 	/*  Try to determine the format. This code is naive, and only checks the data that matters (e.g. glInternalFormat first, then glType
@@ -1039,7 +1114,9 @@ using std::vector;
 namespace pvr {
 namespace assetReaders {
 
-Texture readKTX(const pvr::Stream& stream)
+Texture readKTX(const pvr::Stream& stream) { return readKTX(stream, TextureLoadOptions()); }
+
+Texture readKTX(const pvr::Stream& stream, const TextureLoadOptions& options)
 {
 	if (!stream.isReadable()) { throw InvalidOperationError("[pvr::assetReaders::readKTX] Attempted to read a non-readable assetStream"); }
 
@@ -1169,6 +1246,17 @@ Texture readKTX(const pvr::Stream& stream)
 	// Seek to the start of the texture data, just in case.
 	stream.seek(ktxFileHeader.bytesOfKeyValueData + texture_ktx::c_expectedHeaderSize, Stream::SeekOriginFromStart);
 
+	// Compressed images are written without scan line padding.
+	const bool hasScanLinePadding =
+		!(asset.getPixelFormat().getPart().High == 0 && asset.getPixelFormat().getPixelTypeId() != static_cast<uint64_t>(CompressedPixelFormat::SharedExponentR9G9B9E5));
+
+	// Read the surfaces in parallel if possible. Textures with a single surface gain nothing from it.
+	if (options.maxThreads != 1 && stream.supportsConcurrentReads() && asset.getNumMipMapLevels() * asset.getNumArrayMembers() * asset.getNumFaces() > 1)
+	{
+		readKTXDataParallel(stream, stream.getPosition64(), asset, hasScanLinePadding, options.maxThreads);
+		return asset;
+	}
+
 	// Read in the texture data
 	for (uint32_t mipMapLevel = 0; mipMapLevel < ktxFileHeader.numMipmapLevels; ++mipMapLevel)
 	{
@@ -1192,7 +1280,7 @@ Texture readKTX(const pvr::Stream& stream)
 		if (asset.getDataSize(mipMapLevel, false, false) % 4) { cubePadding = 4 - (asset.getDataSize(mipMapLevel, false, false) % 4); }
 
 		// Compressed images are written without scan line padding.
-		if (asset.getPixelFormat().getPart().High == 0 && asset.getPixelFormat().getPixelTypeId() != static_cast<uint64_t>(CompressedPixelFormat::SharedExponentR9G9B9E5))
+		if (!hasScanLinePadding)
 		{
 			for (uint32_t iSurface = 0; iSurface < asset.getNumArrayMembers(); ++iSurface)
 			{
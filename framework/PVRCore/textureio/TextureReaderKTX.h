@@ -12,7 +12,11 @@
 namespace pvr {
 namespace assetReaders {
 
+/// <summary>Creates pvr::Texture object from a Stream containing KTX texture data.</summary>
 Texture readKTX(const Stream& stream);
+/// <summary>Creates pvr::Texture object from a Stream containing KTX texture data. If the options allow it and the stream supports concurrent
+/// reads, the mip levels, array members and faces are read, and their padding removed, on several threads.</summary>
+Texture readKTX(const Stream& stream, const TextureLoadOptions& options);
 
 } // namespace assetReaders
 } // namespace pvr
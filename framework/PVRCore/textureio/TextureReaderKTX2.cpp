@@ -0,0 +1,329 @@
+/*!
+\brief Implementation of methods of the TextureReaderKTX2 class.
+\file PVRCore/textureio/TextureReaderKTX2.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+#include "PVRCore/textureio/TextureReaderKTX2.h"
+#include "PVRCore/texture/ParallelDecompress.h"
+#include <cstring>
+#ifdef PVR_SUPPORT_ZSTD
+#include <zstd.h>
+#endif
+
+namespace {
+inline void setFormat(pvr::TextureHeader& hd, pvr::PixelFormat pixelFormat, pvr::VariableType channelType, pvr::ColorSpace colorSpace)
+{
+	hd.setPixelFormat(pixelFormat);
+	hd.setChannelType(channelType);
+	hd.setColorSpace(colorSpace);
+}
+
+bool setVulkanFormat(pvr::TextureHeader& hd, uint32_t vkFormat)
+{
+	using namespace pvr;
+	using namespace pvr::texture_ktx2::VulkanFormats;
+
+	// The 2D ASTC formats are contiguous, alternating UNORM and SRGB, and in the same order as CompressedPixelFormat.
+	if (vkFormat >= VK_FORMAT_ASTC_4x4_UNORM_BLOCK && vkFormat <= VK_FORMAT_ASTC_12x12_SRGB_BLOCK)
+	{
+		const uint32_t astcIndex = vkFormat - VK_FORMAT_ASTC_4x4_UNORM_BLOCK;
+		setFormat(hd, static_cast<CompressedPixelFormat>(static_cast<uint32_t>(CompressedPixelFormat::ASTC_4x4) + astcIndex / 2), VariableType::UnsignedByteNorm,
+			(astcIndex % 2) ? ColorSpace::sRGB : ColorSpace::lRGB);
+		return true;
+	}
+
+	switch (vkFormat)
+	{
+	case VK_FORMAT_R4G4B4A4_UNORM_PACK16: setFormat(hd, GeneratePixelType4<'r', 'g', 'b', 'a', 4, 4, 4, 4>::ID, VariableType::UnsignedShortNorm, ColorSpace::lRGB); return true;
+	case VK_FORMAT_R5G6B5_UNORM_PACK16: setFormat(hd, GeneratePixelType3<'r', 'g', 'b', 5, 6, 5>::ID, VariableType::UnsignedShortNorm, ColorSpace::lRGB); return true;
+	case VK_FORMAT_R5G5B5A1_UNORM_PACK16: setFormat(hd, GeneratePixelType4<'r', 'g', 'b', 'a', 5, 5, 5, 1>::ID, VariableType::UnsignedShortNorm, ColorSpace::lRGB); return true;
+
+	case VK_FORMAT_R8_UNORM: setFormat(hd, GeneratePixelType1<'r', 8>::ID, VariableType::UnsignedByteNorm, ColorSpace::lRGB); return true;
+	case VK_FORMAT_R8_SNORM: setFormat(hd, GeneratePixelType1<'r', 8>::ID, VariableType::SignedByteNorm, ColorSpace::lRGB); return true;
+	case VK_FORMAT_R8_UINT: setFormat(hd, GeneratePixelType1<'r', 8>::ID, VariableType::UnsignedByte, ColorSpace::lRGB); return true;
+	case VK_FORMAT_R8_SINT: setFormat(hd, GeneratePixelType1<'r', 8>::ID, VariableType::SignedByte, ColorSpace::lRGB); return true;
+	case VK_FORMAT_R8_SRGB: setFormat(hd, GeneratePixelType1<'r', 8>::ID, VariableType::UnsignedByteNorm, ColorSpace::sRGB); return true;
+	case VK_FORMAT_R8G8_UNORM: setFormat(hd, GeneratePixelType2<'r', 'g', 8, 8>::ID, VariableType::UnsignedByteNorm, ColorSpace::lRGB); return true;
+	case VK_FORMAT_R8G8_SNORM: setFormat(hd, GeneratePixelType2<'r', 'g', 8, 8>::ID, VariableType::SignedByteNorm, ColorSpace::lRGB); return true;
+	case VK_FORMAT_R8G8_UINT: setFormat(hd, GeneratePixelType2<'r', 'g', 8, 8>::ID, VariableType::UnsignedByte, ColorSpace::lRGB); return true;
+	case VK_FORMAT_R8G8_SINT: setFormat(hd, GeneratePixelType2<'r', 'g', 8, 8>::ID, VariableType::SignedByte, ColorSpace::lRGB); return true;
+	case VK_FORMAT_R8G8_SRGB: setFormat(hd, GeneratePixelType2<'r', 'g', 8, 8>::ID, VariableType::UnsignedByteNorm, ColorSpace::sRGB); return true;
+	case VK_FORMAT_R8G8B8_UNORM: setFormat(hd, GeneratePixelType3<'r', 'g', 'b', 8, 8, 8>::ID, VariableType::UnsignedByteNorm, ColorSpace::lRGB); return true;
+	case VK_FORMAT_R8G8B8_SNORM: setFormat(hd, GeneratePixelType3<'r', 'g', 'b', 8, 8, 8>::ID, VariableType::SignedByteNorm, ColorSpace::lRGB); return true;
+	case VK_FORMAT_R8G8B8_UINT: setFormat(hd, GeneratePixelType3<'r', 'g', 'b', 8, 8, 8>::ID, VariableType::UnsignedByte, ColorSpace::lRGB); return true;
+	case VK_FORMAT_R8G8B8_SINT: setFormat(hd, GeneratePixelType3<'r', 'g', 'b', 8, 8, 8>::ID, VariableType::SignedByte, ColorSpace::lRGB); return true;
+	case VK_FORMAT_R8G8B8_SRGB: setFormat(hd, GeneratePixelType3<'r', 'g', 'b', 8, 8, 8>::ID, VariableType::UnsignedByteNorm, ColorSpace::sRGB); return true;
+	case VK_FORMAT_B8G8R8_UNORM: setFormat(hd, GeneratePixelType3<'b', 'g', 'r', 8, 8, 8>::ID, VariableType::UnsignedByteNorm, ColorSpace::lRGB); return true;
+	case VK_FORMAT_B8G8R8_SRGB: setFormat(hd, GeneratePixelType3<'b', 'g', 'r', 8, 8, 8>::ID, VariableType::UnsignedByteNorm, ColorSpace::sRGB); return true;
+	case VK_FORMAT_R8G8B8A8_UNORM: setFormat(hd, GeneratePixelType4<'r', 'g', 'b', 'a', 8, 8, 8, 8>::ID, VariableType::UnsignedByteNorm, ColorSpace::lRGB); return true;
+	case VK_FORMAT_R8G8B8A8_SNORM: setFormat(hd, GeneratePixelType4<'r', 'g', 'b', 'a', 8, 8, 8, 8>::ID, VariableType::SignedByteNorm, ColorSpace::lRGB); return true;
+	case VK_FORMAT_R8G8B8A8_UINT: setFormat(hd, GeneratePixelType4<'r', 'g', 'b', 'a', 8, 8, 8, 8>::ID, VariableType::UnsignedByte, ColorSpace::lRGB); return true;
+	case VK_FORMAT_R8G8B8A8_SINT: setFormat(hd, GeneratePixelType4<'r', 'g', 'b', 'a', 8, 8, 8, 8>::ID, VariableType::SignedByte, ColorSpace::lRGB); return true;
+	case VK_FORMAT_R8G8B8A8_SRGB: setFormat(hd, GeneratePixelType4<'r', 'g', 'b', 'a', 8, 8, 8, 8>::ID, VariableType::UnsignedByteNorm, ColorSpace::sRGB); return true;
+	case VK_FORMAT_B8G8R8A8_UNORM: setFormat(hd, GeneratePixelType4<'b', 'g', 'r', 'a', 8, 8, 8, 8>::ID, VariableType::UnsignedByteNorm, ColorSpace::lRGB); return true;
+	case VK_FORMAT_B8G8R8A8_SRGB: setFormat(hd, GeneratePixelType4<'b', 'g', 'r', 'a', 8, 8, 8, 8>::ID, VariableType::UnsignedByteNorm, ColorSpace::sRGB); return true;
+
+	case VK_FORMAT_R16_UNORM: setFormat(hd, GeneratePixelType1<'r', 16>::ID, VariableType::UnsignedShortNorm, ColorSpace::lRGB); return true;
+	case VK_FORMAT_R16_UINT: setFormat(hd, GeneratePixelType1<'r', 16>::ID, VariableType::UnsignedShort, ColorSpace::lRGB); return true;
+	case VK_FORMAT_R16_SFLOAT: setFormat(hd, GeneratePixelType1<'r', 16>::ID, VariableType::SignedFloat, ColorSpace::lRGB); return true;
+	case VK_FORMAT_R16G16_UNORM: setFormat(hd, GeneratePixelType2<'r', 'g', 16, 16>::ID, VariableType::UnsignedShortNorm, ColorSpace::lRGB); return true;
+	case VK_FORMAT_R16G16_UINT: setFormat(hd, GeneratePixelType2<'r', 'g', 16, 16>::ID, VariableType::UnsignedShort, ColorSpace::lRGB); return true;
+	case VK_FORMAT_R16G16_SFLOAT: setFormat(hd, GeneratePixelType2<'r', 'g', 16, 16>::ID, VariableType::SignedFloat, ColorSpace::lRGB); return true;
+	case VK_FORMAT_R16G16B16_SFLOAT: setFormat(hd, GeneratePixelType3<'r', 'g', 'b', 16, 16, 16>::ID, VariableType::SignedFloat, ColorSpace::lRGB); return true;
+	case VK_FORMAT_R16G16B16A16_UNORM: setFormat(hd, GeneratePixelType4<'r', 'g', 'b', 'a', 16, 16, 16, 16>::ID, VariableType::UnsignedShortNorm, ColorSpace::lRGB); return true;
+	case VK_FORMAT_R16G16B16A16_UINT: setFormat(hd, GeneratePixelType4<'r', 'g', 'b', 'a', 16, 16, 16, 16>::ID, VariableType::UnsignedShort, ColorSpace::lRGB); return true;
+	case VK_FORMAT_R16G16B16A16_SFLOAT: setFormat(hd, GeneratePixelType4<'r', 'g', 'b', 'a', 16, 16, 16, 16>::ID, VariableType::SignedFloat, ColorSpace::lRGB); return true;
+
+	case VK_FORMAT_R32_UINT: setFormat(hd, GeneratePixelType1<'r', 32>::ID, VariableType::UnsignedInteger, ColorSpace::lRGB); return true;
+	case VK_FORMAT_R32_SFLOAT: setFormat(hd, GeneratePixelType1<'r', 32>::ID, VariableType::SignedFloat, ColorSpace::lRGB); return true;
+	case VK_FORMAT_R32G32_UINT: setFormat(hd, GeneratePixelType2<'r', 'g', 32, 32>::ID, VariableType::UnsignedInteger, ColorSpace::lRGB); return true;
+	case VK_FORMAT_R32G32_SFLOAT: setFormat(hd, GeneratePixelType2<'r', 'g', 32, 32>::ID, VariableType::SignedFloat, ColorSpace::lRGB); return true;
+	case VK_FORMAT_R32G32B32_SFLOAT: setFormat(hd, GeneratePixelType3<'r', 'g', 'b', 32, 32, 32>::ID, VariableType::SignedFloat, ColorSpace::lRGB); return true;
+	case VK_FORMAT_R32G32B32A32_UINT: setFormat(hd, GeneratePixelType4<'r', 'g', 'b', 'a', 32, 32, 32, 32>::ID, VariableType::UnsignedInteger, ColorSpace::lRGB); return true;
+	case VK_FORMAT_R32G32B32A32_SFLOAT: setFormat(hd, GeneratePixelType4<'r', 'g', 'b', 'a', 32, 32, 32, 32>::ID, VariableType::SignedFloat, ColorSpace::lRGB); return true;
+
+	case VK_FORMAT_B10G11R11_UFLOAT_PACK32: setFormat(hd, GeneratePixelType3<'r', 'g', 'b', 11, 11, 10>::ID, VariableType::UnsignedFloat, ColorSpace::lRGB); return true;
+	case VK_FORMAT_E5B9G9R9_UFLOAT_PACK32: setFormat(hd, CompressedPixelFormat::SharedExponentR9G9B9E5, VariableType::UnsignedFloat, ColorSpace::lRGB); return true;
+
+	case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+	case VK_FORMAT_BC1_RGBA_UNORM_BLOCK: setFormat(hd, CompressedPixelFormat::BC1, VariableType::UnsignedByteNorm, ColorSpace::lRGB); return true;
+	case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+	case VK_FORMAT_BC1_RGBA_SRGB_BLOCK: setFormat(hd, CompressedPixelFormat::BC1, VariableType::UnsignedByteNorm, ColorSpace::sRGB); return true;
+	case VK_FORMAT_BC2_UNORM_BLOCK: setFormat(hd, CompressedPixelFormat::BC2, VariableType::UnsignedByteNorm, ColorSpace::lRGB); return true;
+	case VK_FORMAT_BC2_SRGB_BLOCK: setFormat(hd, CompressedPixelFormat::BC2, VariableType::UnsignedByteNorm, ColorSpace::sRGB); return true;
+	case VK_FORMAT_BC3_UNORM_BLOCK: setFormat(hd, CompressedPixelFormat::BC3, VariableType::UnsignedByteNorm, ColorSpace::lRGB); return true;
+	case VK_FORMAT_BC3_SRGB_BLOCK: setFormat(hd, CompressedPixelFormat::BC3, VariableType::UnsignedByteNorm, ColorSpace::sRGB); return true;
+	case VK_FORMAT_BC4_UNORM_BLOCK: setFormat(hd, CompressedPixelFormat::BC4, VariableType::UnsignedByteNorm, ColorSpace::lRGB); return true;
+	case VK_FORMAT_BC4_SNORM_BLOCK: setFormat(hd, CompressedPixelFormat::BC4, VariableType::SignedByteNorm, ColorSpace::lRGB); return true;
+	case VK_FORMAT_BC5_UNORM_BLOCK: setFormat(hd, CompressedPixelFormat::BC5, VariableType::UnsignedByteNorm, ColorSpace::lRGB); return true;
+	case VK_FORMAT_BC5_SNORM_BLOCK: setFormat(hd, CompressedPixelFormat::BC5, VariableType::SignedByteNorm, ColorSpace::lRGB); return true;
+	case VK_FORMAT_BC6H_UFLOAT_BLOCK: setFormat(hd, CompressedPixelFormat::BC6, VariableType::UnsignedFloat, ColorSpace::lRGB); return true;
+	case VK_FORMAT_BC6H_SFLOAT_BLOCK: setFormat(hd, CompressedPixelFormat::BC6, VariableType::SignedFloat, ColorSpace::lRGB); return true;
+	case VK_FORMAT_BC7_UNORM_BLOCK: setFormat(hd, CompressedPixelFormat::BC7, VariableType::UnsignedByteNorm, ColorSpace::lRGB); return true;
+	case VK_FORMAT_BC7_SRGB_BLOCK: setFormat(hd, CompressedPixelFormat::BC7, VariableType::UnsignedByteNorm, ColorSpace::sRGB); return true;
+
+	case VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK: setFormat(hd, CompressedPixelFormat::ETC2_RGB, VariableType::UnsignedByteNorm, ColorSpace::lRGB); return true;
+	case VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK: setFormat(hd, CompressedPixelFormat::ETC2_RGB, VariableType::UnsignedByteNorm, ColorSpace::sRGB); return true;
+	case VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK: setFormat(hd, CompressedPixelFormat::ETC2_RGB_A1, VariableType::UnsignedByteNorm, ColorSpace::lRGB); return true;
+	case VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK: setFormat(hd, CompressedPixelFormat::ETC2_RGB_A1, VariableType::UnsignedByteNorm, ColorSpace::sRGB); return true;
+	case VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK: setFormat(hd, CompressedPixelFormat::ETC2_RGBA, VariableType::UnsignedByteNorm, ColorSpace::lRGB); return true;
+	case VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK: setFormat(hd, CompressedPixelFormat::ETC2_RGBA, VariableType::UnsignedByteNorm, ColorSpace::sRGB); return true;
+	case VK_FORMAT_EAC_R11_UNORM_BLOCK: setFormat(hd, CompressedPixelFormat::EAC_R11, VariableType::UnsignedByteNorm, ColorSpace::lRGB); return true;
+	case VK_FORMAT_EAC_R11_SNORM_BLOCK: setFormat(hd, CompressedPixelFormat::EAC_R11, VariableType::SignedByteNorm, ColorSpace::lRGB); return true;
+	case VK_FORMAT_EAC_R11G11_UNORM_BLOCK: setFormat(hd, CompressedPixelFormat::EAC_RG11, VariableType::UnsignedByteNorm, ColorSpace::lRGB); return true;
+	case VK_FORMAT_EAC_R11G11_SNORM_BLOCK: setFormat(hd, CompressedPixelFormat::EAC_RG11, VariableType::SignedByteNorm, ColorSpace::lRGB); return true;
+
+	case VK_FORMAT_PVRTC1_2BPP_UNORM_BLOCK_IMG: setFormat(hd, CompressedPixelFormat::PVRTCI_2bpp_RGBA, VariableType::UnsignedByteNorm, ColorSpace::lRGB); return true;
+	case VK_FORMAT_PVRTC1_4BPP_UNORM_BLOCK_IMG: setFormat(hd, CompressedPixelFormat::PVRTCI_4bpp_RGBA, VariableType::UnsignedByteNorm, ColorSpace::lRGB); return true;
+	case VK_FORMAT_PVRTC2_2BPP_UNORM_BLOCK_IMG: setFormat(hd, CompressedPixelFormat::PVRTCII_2bpp, VariableType::UnsignedByteNorm, ColorSpace::lRGB); return true;
+	case VK_FORMAT_PVRTC2_4BPP_UNORM_BLOCK_IMG: setFormat(hd, CompressedPixelFormat::PVRTCII_4bpp, VariableType::UnsignedByteNorm, ColorSpace::lRGB); return true;
+	case VK_FORMAT_PVRTC1_2BPP_SRGB_BLOCK_IMG: setFormat(hd, CompressedPixelFormat::PVRTCI_2bpp_RGBA, VariableType::UnsignedByteNorm, ColorSpace::sRGB); return true;
+	case VK_FORMAT_PVRTC1_4BPP_SRGB_BLOCK_IMG: setFormat(hd, CompressedPixelFormat::PVRTCI_4bpp_RGBA, VariableType::UnsignedByteNorm, ColorSpace::sRGB); return true;
+	case VK_FORMAT_PVRTC2_2BPP_SRGB_BLOCK_IMG: setFormat(hd, CompressedPixelFormat::PVRTCII_2bpp, VariableType::UnsignedByteNorm, ColorSpace::sRGB); return true;
+	case VK_FORMAT_PVRTC2_4BPP_SRGB_BLOCK_IMG: setFormat(hd, CompressedPixelFormat::PVRTCII_4bpp, VariableType::UnsignedByteNorm, ColorSpace::sRGB); return true;
+	default: return false;
+	}
+}
+
+template<typename T>
+inline T readValue(const unsigned char* data, size_t offset)
+{
+	T value;
+	memcpy(&value, data + offset, sizeof(T));
+	return value;
+}
+
+// Parse the key/value data, looking for the orientation. This is the only meta data currently supported.
+uint32_t readOrientation(const std::vector<unsigned char>& keyValueData)
+{
+	uint32_t orientation = 0;
+	size_t offset = 0;
+	while (offset + sizeof(uint32_t) <= keyValueData.size())
+	{
+		const uint32_t keyAndValueSize = readValue<uint32_t>(keyValueData.data(), offset);
+		offset += sizeof(uint32_t);
+		if (keyAndValueSize > keyValueData.size() - offset) { throw pvr::InvalidDataError("[TextureReaderKTX2::readAsset_]: Key/value data were invalid"); }
+
+		const char* keyAndValue = reinterpret_cast<const char*>(keyValueData.data() + offset);
+		const size_t keyLength = strnlen(keyAndValue, keyAndValueSize);
+		if (keyLength < keyAndValueSize && std::string(keyAndValue, keyLength) == pvr::texture_ktx2::c_orientationMetaDataKey)
+		{
+			// The value is one character per dimension: r/l for S, d/u for T and o/i for R.
+			const std::string orientationString(keyAndValue + keyLength + 1, keyAndValueSize - keyLength - 1);
+			if (orientationString.size() > 0 && orientationString[0] == 'l') { orientation |= pvr::TextureMetaData::AxisOrientationLeft; }
+			if (orientationString.size() > 1 && orientationString[1] == 'u') { orientation |= pvr::TextureMetaData::AxisOrientationUp; }
+			if (orientationString.size() > 2 && orientationString[2] == 'o') { orientation |= pvr::TextureMetaData::AxisOrientationOut; }
+		}
+
+		// Skip the value and the padding to the next 4 byte boundary.
+		offset += (keyAndValueSize + 3) & ~3u;
+	}
+	return orientation;
+}
+} // namespace
+
+namespace pvr {
+namespace assetReaders {
+KTX2Reader::KTX2Reader(const Stream& stream) : _stream(stream), _supercompressionScheme(texture_ktx2::SupercompressionScheme::None)
+{
+	if (!stream.isReadable()) { throw InvalidOperationError("[pvr::assetReaders::KTX2Reader] Attempted to read a non-readable assetStream"); }
+	if (!stream.isRandomAccess()) { throw InvalidOperationError("[pvr::assetReaders::KTX2Reader] KTX2 files can only be read from random access streams"); }
+
+	// Read the header and the index that follows it.
+	unsigned char headerData[texture_ktx2::c_headerSize];
+	stream.readAt(0, 1, sizeof(headerData), headerData);
+	if (memcmp(headerData, texture_ktx2::c_identifier, sizeof(texture_ktx2::c_identifier)) != 0)
+	{ throw InvalidDataError("[TextureReaderKTX2::readAsset_]: Stream did not contain a valid KTX2 identifier."); }
+
+	texture_ktx2::FileHeader fileHeader;
+	memcpy(fileHeader.identifier, headerData, sizeof(fileHeader.identifier));
+	fileHeader.vkFormat = readValue<uint32_t>(headerData, 12);
+	fileHeader.typeSize = readValue<uint32_t>(headerData, 16);
+	fileHeader.pixelWidth = readValue<uint32_t>(headerData, 20);
+	fileHeader.pixelHeight = readValue<uint32_t>(headerData, 24);
+	fileHeader.pixelDepth = readValue<uint32_t>(headerData, 28);
+	fileHeader.layerCount = readValue<uint32_t>(headerData, 32);
+	fileHeader.faceCount = readValue<uint32_t>(headerData, 36);
+	fileHeader.levelCount = readValue<uint32_t>(headerData, 40);
+	fileHeader.supercompressionScheme = readValue<uint32_t>(headerData, 44);
+	fileHeader.dfdByteOffset = readValue<uint32_t>(headerData, 48);
+	fileHeader.dfdByteLength = readValue<uint32_t>(headerData, 52);
+	fileHeader.kvdByteOffset = readValue<uint32_t>(headerData, 56);
+	fileHeader.kvdByteLength = readValue<uint32_t>(headerData, 60);
+	fileHeader.sgdByteOffset = readValue<uint64_t>(headerData, 64);
+	fileHeader.sgdByteLength = readValue<uint64_t>(headerData, 72);
+
+	if (!fileHeader.pixelWidth || (fileHeader.faceCount != 1 && fileHeader.faceCount != 6))
+	{ throw InvalidDataError("[TextureReaderKTX2::readAsset_]: Texture dimensions were invalid."); }
+
+	_supercompressionScheme = static_cast<texture_ktx2::SupercompressionScheme>(fileHeader.supercompressionScheme);
+	switch (_supercompressionScheme)
+	{
+	case texture_ktx2::SupercompressionScheme::None: break;
+	case texture_ktx2::SupercompressionScheme::Zstandard:
+#ifdef PVR_SUPPORT_ZSTD
+		break;
+#else
+		throw InvalidDataError("[TextureReaderKTX2::readAsset_]: Zstandard supercompression is not supported by this build (requires PVR_SUPPORT_ZSTD).");
+#endif
+	default: throw InvalidDataError("[TextureReaderKTX2::readAsset_]: Unsupported supercompression scheme.");
+	}
+
+	// Construct the texture header
+	if (!setVulkanFormat(_textureHeader, fileHeader.vkFormat)) { throw InvalidDataError("[TextureReaderKTX2::readAsset_]: Unsupported texture format."); }
+	_textureHeader.setWidth(fileHeader.pixelWidth);
+	_textureHeader.setHeight(std::max(fileHeader.pixelHeight, 1u));
+	_textureHeader.setDepth(std::max(fileHeader.pixelDepth, 1u));
+	_textureHeader.setNumArrayMembers(std::max(fileHeader.layerCount, 1u));
+	_textureHeader.setNumFaces(fileHeader.faceCount);
+	// A level count of 0 asks for the mip map chain to be generated at load time: only the base level is stored.
+	const uint32_t numLevels = std::max(fileHeader.levelCount, 1u);
+	_textureHeader.setNumMipMapLevels(numLevels);
+
+	// Read the meta data
+	if (fileHeader.kvdByteLength)
+	{
+		std::vector<unsigned char> keyValueData(fileHeader.kvdByteLength);
+		stream.readAt(fileHeader.kvdByteOffset, 1, keyValueData.size(), keyValueData.data());
+		_textureHeader.setOrientation(static_cast<TextureMetaData::AxisOrientation>(readOrientation(keyValueData)));
+	}
+
+	// Read and validate the level index
+	const uint64_t streamSize = stream.getSize64();
+	std::vector<unsigned char> levelIndexData(static_cast<size_t>(numLevels) * texture_ktx2::c_levelIndexEntrySize);
+	stream.readAt(texture_ktx2::c_headerSize, 1, levelIndexData.size(), levelIndexData.data());
+	_levelIndex.resize(numLevels);
+	for (uint32_t level = 0; level < numLevels; ++level)
+	{
+		texture_ktx2::LevelIndexEntry& entry = _levelIndex[level];
+		entry.byteOffset = readValue<uint64_t>(levelIndexData.data(), level * texture_ktx2::c_levelIndexEntrySize);
+		entry.byteLength = readValue<uint64_t>(levelIndexData.data(), level * texture_ktx2::c_levelIndexEntrySize + 8);
+		entry.uncompressedByteLength = readValue<uint64_t>(levelIndexData.data(), level * texture_ktx2::c_levelIndexEntrySize + 16);
+
+		if (entry.byteOffset > streamSize || entry.byteLength > streamSize - entry.byteOffset)
+		{ throw InvalidDataError("[TextureReaderKTX2::readAsset_]: Mipmap level extends past the end of the stream."); }
+		if (entry.uncompressedByteLength != _textureHeader.getDataSize(level))
+		{ throw InvalidDataError("[TextureReaderKTX2::readAsset_]: Mipmap size read was not expected size."); }
+		if (_supercompressionScheme == texture_ktx2::SupercompressionScheme::None && entry.byteLength != entry.uncompressedByteLength)
+		{ throw InvalidDataError("[TextureReaderKTX2::readAsset_]: Mipmap size read was not expected size."); }
+	}
+}
+
+void KTX2Reader::loadMipMapLevel(uint32_t mipMapLevel, Texture& texture) const
+{
+	if (mipMapLevel >= getNumMipMapLevels()) { throw InvalidArgumentError("mipMapLevel", "[KTX2Reader::loadMipMapLevel] Specified mipmap level did not exist"); }
+	const texture_ktx2::LevelIndexEntry& level = _levelIndex[mipMapLevel];
+	if (mipMapLevel >= texture.getNumMipMapLevels() || texture.getDataSize(mipMapLevel) != level.uncompressedByteLength)
+	{ throw InvalidArgumentError("texture", "[KTX2Reader::loadMipMapLevel] The texture does not match the header of the file"); }
+
+	// KTX2 levels are stored as layers, then faces, then depth slices, which is the layout of a mip map level of a Texture.
+	unsigned char* destination = texture.getDataPointer(mipMapLevel);
+	auto readLevelData = [&](void* buffer) {
+		if (_stream.supportsConcurrentReads()) { _stream.readAt(level.byteOffset, 1, static_cast<size_t>(level.byteLength), buffer); }
+		else
+		{
+			std::lock_guard<std::mutex> lock(_streamMutex);
+			_stream.readAt(level.byteOffset, 1, static_cast<size_t>(level.byteLength), buffer);
+		}
+	};
+
+	if (_supercompressionScheme == texture_ktx2::SupercompressionScheme::None)
+	{
+		readLevelData(destination);
+		return;
+	}
+
+	std::vector<unsigned char> compressedData(static_cast<size_t>(level.byteLength));
+	readLevelData(compressedData.data());
+#ifdef PVR_SUPPORT_ZSTD
+	const size_t result = ZSTD_decompress(destination, static_cast<size_t>(level.uncompressedByteLength), compressedData.data(), compressedData.size());
+	if (ZSTD_isError(result) || result != level.uncompressedByteLength)
+	{ throw InvalidDataError("[TextureReaderKTX2::loadMipMapLevel]: Failed to decompress Zstandard supercompressed mipmap level."); }
+#endif
+}
+
+void KTX2Reader::loadMipMapLevelsSmallestFirst(Texture& texture, const std::function<void(uint32_t)>& levelLoaded) const
+{
+	for (uint32_t level = getNumMipMapLevels(); level-- > 0;)
+	{
+		loadMipMapLevel(level, texture);
+		if (levelLoaded) { levelLoaded(level); }
+	}
+}
+
+Texture KTX2Reader::readTexture(const TextureLoadOptions& options) const
+{
+	Texture texture = createTexture();
+	// Levels are handed out largest first, so that the most expensive ones start as early as possible.
+	const uint32_t numLevels = getNumMipMapLevels();
+	impl::parallelForEachItem(numLevels, impl::getDecompressionThreadCount(options.maxThreads, numLevels, 1), [&](uint32_t level) { loadMipMapLevel(level, texture); });
+	return texture;
+}
+
+Texture readKTX2(const Stream& stream) { return readKTX2(stream, TextureLoadOptions()); }
+
+Texture readKTX2(const Stream& stream, const TextureLoadOptions& options)
+{
+	KTX2Reader reader(stream);
+	return reader.readTexture(options);
+}
+
+bool isKTX2(const Stream& stream)
+{
+	if (!stream.isReadable() || !stream.isRandomAccess()) { return false; }
+	uint8_t identifier[sizeof(texture_ktx2::c_identifier)];
+	try
+	{
+		stream.readAt(0, 1, sizeof(identifier), identifier);
+	}
+	catch (const FileEOFError&)
+	{
+		return false;
+	}
+	return memcmp(identifier, texture_ktx2::c_identifier, sizeof(identifier)) == 0;
+}
+} // namespace assetReaders
+} // namespace pvr
+//!\endcond
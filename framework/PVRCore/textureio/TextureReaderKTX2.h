@@ -0,0 +1,83 @@
+/*!
+\brief A KTX2 texture reader, supporting Zstandard supercompression and loading mip map levels on demand.
+\file PVRCore/textureio/TextureReaderKTX2.h
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+#pragma once
+#include "PVRCore/texture/Texture.h"
+#include "PVRCore/textureio/FileDefinesKTX2.h"
+#include "PVRCore/stream/Stream.h"
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace pvr {
+namespace assetReaders {
+/// <summary>Reads a KTX2 file one mip map level at a time. Constructing the reader only reads the header, the level index and the key/value data.
+/// Each mip map level is then read, and its supercompression removed, only when requested. This allows an application to display a texture with
+/// its smallest levels while the larger ones are still loading (see loadMipMapLevelsSmallestFirst).
+///
+/// Levels without supercompression, and Zstandard supercompressed levels, are supported. Zstandard support requires the Framework to be built with
+/// zstd available (PVR_SUPPORT_ZSTD): otherwise, Zstandard supercompressed files are rejected when the reader is constructed. BasisLZ and ZLIB are
+/// not supported.</summary>
+class KTX2Reader
+{
+public:
+	/// <summary>Constructor. Reads and validates the header, the level index and the key/value data of the file.</summary>
+	/// <param name="stream">A random access stream containing a KTX2 file. Must stay valid for as long as mip map levels are loaded from this reader.</param>
+	explicit KTX2Reader(const Stream& stream);
+
+	/// <summary>Get a header that describes the whole texture (format, dimensions, number of levels etc.).</summary>
+	/// <returns>The header of the texture.</returns>
+	const TextureHeader& getTextureHeader() const { return _textureHeader; }
+
+	/// <summary>Get the number of mip map levels in the file.</summary>
+	/// <returns>The number of mip map levels.</returns>
+	uint32_t getNumMipMapLevels() const { return static_cast<uint32_t>(_levelIndex.size()); }
+
+	/// <summary>Get the supercompression scheme applied to the mip map levels of the file.</summary>
+	/// <returns>The supercompression scheme.</returns>
+	texture_ktx2::SupercompressionScheme getSupercompressionScheme() const { return _supercompressionScheme; }
+
+	/// <summary>Create a texture with the header of the file and storage for all levels, but without reading any level.</summary>
+	/// <returns>A texture ready to be passed to loadMipMapLevel.</returns>
+	Texture createTexture() const { return Texture(_textureHeader); }
+
+	/// <summary>Read a mip map level from the file and remove its supercompression, writing it into a texture. Can be called from several threads at the
+	/// same time for different levels: reads from the stream are serialised unless it supports concurrent reads, but decompression happens in parallel.</summary>
+	/// <param name="mipMapLevel">The mip map level to load</param>
+	/// <param name="texture">The texture to write the level into. Must have been created with createTexture (or have an identical header).</param>
+	void loadMipMapLevel(uint32_t mipMapLevel, Texture& texture) const;
+
+	/// <summary>Load all mip map levels one by one, from the smallest to the largest, calling a function after each level has been loaded. The
+	/// texture can be displayed using the levels loaded so far as soon as the function has been called for the first time.</summary>
+	/// <param name="texture">The texture to write the levels into. Must have been created with createTexture (or have an identical header).</param>
+	/// <param name="levelLoaded">A function called with the index of each mip map level once it has been loaded. Can be empty.</param>
+	void loadMipMapLevelsSmallestFirst(Texture& texture, const std::function<void(uint32_t)>& levelLoaded) const;
+
+	/// <summary>Load the whole texture.</summary>
+	/// <param name="options">Options for loading the texture. Levels are loaded on several threads if options.maxThreads allows it.</param>
+	/// <returns>The texture, with all mip map levels loaded.</returns>
+	Texture readTexture(const TextureLoadOptions& options = TextureLoadOptions()) const;
+
+private:
+	const Stream& _stream;
+	TextureHeader _textureHeader;
+	texture_ktx2::SupercompressionScheme _supercompressionScheme;
+	std::vector<texture_ktx2::LevelIndexEntry> _levelIndex;
+	mutable std::mutex _streamMutex;
+
+	KTX2Reader(const KTX2Reader&) = delete;
+	KTX2Reader& operator=(const KTX2Reader&) = delete;
+};
+
+/// <summary>Creates pvr::Texture object from a Stream containing KTX2 texture data.</summary>
+Texture readKTX2(const Stream& stream);
+/// <summary>Creates pvr::Texture object from a Stream containing KTX2 texture data. If the options allow it, the mip map levels are read and
+/// decompressed on several threads.</summary>
+Texture readKTX2(const Stream& stream, const TextureLoadOptions& options);
+/// <summary>Check if a Stream contains KTX2 texture data, by looking at its identifier. Does not change the position of the stream.</summary>
+bool isKTX2(const Stream& stream);
+} // namespace assetReaders
+} // namespace pvr
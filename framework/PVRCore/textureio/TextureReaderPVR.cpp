@@ -7,11 +7,33 @@
 //!\cond NO_DOXYGEN
 #include "PVRCore/textureio/TextureReaderPVR.h"
 #include "PVRCore/Log.h"
+#include "PVRCore/texture/ParallelDecompress.h"
 using std::vector;
 namespace pvr {
 namespace assetReaders {
 
 namespace {
+// The granularity of parallel reads. Small enough to balance the load, large enough that each positional read is efficient.
+const uint64_t c_parallelReadChunkSize = 1024 * 1024;
+
+/// <summary>Read the data of a texture with positional reads issued from several threads. The data of a PVR file is laid out exactly like the
+/// data of a Texture, so every chunk of the file can be read independently straight into its final place.</summary>
+/// <param name="stream">A stream that supports concurrent reads</param>
+/// <param name="dataOffset">The offset of the texture data in the stream</param>
+/// <param name="asset">The texture to read into. Must already be initialized with its header.</param>
+/// <param name="maxThreads">The maximum number of threads (see TextureLoadOptions)</param>
+inline void readTextureDataParallel(const Stream& stream, uint64_t dataOffset, Texture& asset, uint32_t maxThreads)
+{
+	const uint64_t dataSize = asset.getDataSize();
+	unsigned char* const data = asset.getDataPointer();
+	const uint32_t numChunks = static_cast<uint32_t>((dataSize + c_parallelReadChunkSize - 1) / c_parallelReadChunkSize);
+	impl::parallelForEachItem(numChunks, impl::getDecompressionThreadCount(maxThreads, numChunks, 1), [&](uint32_t chunk) {
+		const uint64_t chunkOffset = chunk * c_parallelReadChunkSize;
+		const uint64_t chunkSize = std::min(c_parallelReadChunkSize, dataSize - chunkOffset);
+		stream.readAt(dataOffset + chunkOffset, 1, static_cast<size_t>(chunkSize), data + chunkOffset);
+	});
+}
+
 /// <summary>Load the this texture meta data from a stream</summary>
 /// <param name="stream">Stream to load the meta data from</param>
 inline TextureMetaData loadTextureMetadataFromStream(const Stream& stream)
@@ -1368,7 +1390,9 @@ bool isPVR(const Stream& assetStream)
 
 	return false;
 }
-Texture readPVR(const Stream& stream)
+Texture readPVR(const Stream& stream) { return readPVR(stream, TextureLoadOptions()); }
+
+Texture readPVR(const Stream& stream, const TextureLoadOptions& options)
 {
 	if (!stream.isReadable()) { throw InvalidOperationError("[pvr::assetReaders::readPVR] Attempted to read a non-readable assetStream"); }
 
@@ -1434,7 +1458,6 @@ Texture readPVR(const Stream& stream)
 			// Set the meta data size to 0
 			textureFileHeader.metaDataSize = 0;
 
-			asset.initializeWithHeader(textureFileHeader);
 			// Read the meta data
 			uint32_t metaDataRead = 0;
 			while (metaDataRead < tempMetaDataSize)
@@ -1442,17 +1465,39 @@ Texture readPVR(const Stream& stream)
 				TextureMetaData metaDataBlock = loadTextureMetadataFromStream(stream);
 
 				// Add the meta data
-				asset.addMetaData(metaDataBlock);
+				textureFileHeader.addMetaData(metaDataBlock);
 
 				// Evaluate the meta data read
-				metaDataRead = asset.getMetaDataSize();
+				metaDataRead = textureFileHeader.getMetaDataSize();
 			}
 
 			// Make sure the provided data size wasn't wrong. If it was, there are no guarantees about the contents of the texture data.
 			if (metaDataRead > tempMetaDataSize) { throw InvalidDataError("[TextureReaderPVR::readAsset_] Metadata seems to be corrupted while reading."); }
 
-			// Read the texture data
-			stream.readExact(1, asset.getDataSize(), asset.getDataPointer());
+			// If the stream is directly addressable in memory (e.g. a MappedFileStream), reference the texture data instead of copying it.
+			std::shared_ptr<const unsigned char> sharedData = stream.getSharedDataPointer();
+			const uint32_t dataSize = textureFileHeader.getDataSize();
+			if (sharedData && stream.getSize64() - stream.getPosition64() >= dataSize)
+			{
+				asset = Texture(textureFileHeader, std::move(sharedData));
+				stream.seek(static_cast<long>(dataSize), Stream::SeekOriginFromCurrent);
+			}
+			else if (options.maxThreads != 1 && dataSize > c_parallelReadChunkSize && stream.supportsConcurrentReads())
+			{
+				// Read the texture data in parallel, then leave the stream after the data as the sequential path would. Querying the size of some
+				// streams resets their position, so seek from the start.
+				const uint64_t dataOffset = stream.getPosition64();
+				if (stream.getSize64() - dataOffset < dataSize) { throw InvalidDataError("[TextureReaderPVR::readAsset_]: Not a not a valid PVR file."); }
+				asset.initializeWithHeader(textureFileHeader);
+				readTextureDataParallel(stream, dataOffset, asset, options.maxThreads);
+				stream.seek(static_cast<long>(dataOffset + dataSize), Stream::SeekOriginFromStart);
+			}
+			else
+			{
+				// Read the texture data
+				asset.initializeWithHeader(textureFileHeader);
+				stream.readExact(1, asset.getDataSize(), asset.getDataPointer());
+			}
 		}
 		else if (version == texture_legacy::c_headerSizeV1 || version == texture_legacy::c_headerSizeV2)
 		{
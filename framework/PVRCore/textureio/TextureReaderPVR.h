@@ -16,6 +16,9 @@ namespace assetReaders {
 
 /// <summary>Creates pvr::Texture object from a Stream containing PVR texture data.</summary>
 Texture readPVR(const Stream& stream);
+/// <summary>Creates pvr::Texture object from a Stream containing PVR texture data. If the options allow it and the stream supports concurrent
+/// reads, the texture data is read with positional reads issued from several threads.</summary>
+Texture readPVR(const Stream& stream, const TextureLoadOptions& options);
 
 bool isPVR(const Stream& assetStream);
 
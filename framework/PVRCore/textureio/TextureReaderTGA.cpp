@@ -9,6 +9,7 @@
 #include "PVRCore/textureio/TextureReaderTGA.h"
 #include "PVRCore/textureio/PaletteExpander.h"
 #include <algorithm>
+#include <cstring>
 using std::vector;
 namespace pvr {
 namespace assetReaders {
@@ -43,6 +44,73 @@ texture_tga::FileHeader readFileHeader(const pvr::Stream& stream)
 	return fileheader;
 }
 
+// Reads a stream through a large buffer, so that the decoders can parse small items (packet headers, single pixels) from memory instead of making a
+// stream call for each one.
+class ChunkedReader
+{
+public:
+	explicit ChunkedReader(const Stream& stream) : _stream(stream), _buffer(c_chunkSize), _position(0), _end(0)
+	{
+		// Some streams fail reads that go past their end, so only ever ask for what is left. Getting the size may move the position of the stream.
+		const uint64_t position = stream.getPosition();
+		const uint64_t size = stream.getSize64();
+		stream.seek(static_cast<long>(position), Stream::SeekOriginFromStart);
+		_streamBytesLeft = size > position ? size - position : 0;
+	}
+
+	// Get a pointer to the next numBytes bytes of the stream, refilling the buffer if needed, and advance past them.
+	const uint8_t* read(size_t numBytes)
+	{
+		if (_end - _position < numBytes) { refill(numBytes); }
+		const uint8_t* data = _buffer.data() + _position;
+		_position += numBytes;
+		return data;
+	}
+
+private:
+	enum
+	{
+		c_chunkSize = 64 * 1024
+	};
+	const Stream& _stream;
+	std::vector<uint8_t> _buffer;
+	size_t _position;
+	size_t _end;
+	uint64_t _streamBytesLeft;
+
+	void refill(size_t numBytes)
+	{
+		// Keep the bytes not consumed yet, and read as much as fits after them.
+		const size_t remaining = _end - _position;
+		memmove(_buffer.data(), _buffer.data() + _position, remaining);
+		if (_buffer.size() < numBytes) { _buffer.resize(numBytes); }
+		const size_t bytesToRead = static_cast<size_t>(std::min<uint64_t>(_buffer.size() - remaining, _streamBytesLeft));
+		size_t dataRead = 0;
+		if (bytesToRead) { _stream.read(1, bytesToRead, _buffer.data() + remaining, dataRead); }
+		_streamBytesLeft -= dataRead;
+		_position = 0;
+		_end = remaining + dataRead;
+		if (_end < numBytes) { throw FileEOFError(_stream, "[TextureReaderTGA]: Image data is truncated."); }
+	}
+};
+
+// Write the same pixel count times, doubling the size of each copy.
+void fillPixels(uint8_t* outputPixel, const uint8_t* value, uint32_t bytesPerPixel, uint32_t count)
+{
+	const size_t totalSize = static_cast<size_t>(bytesPerPixel) * count;
+	if (bytesPerPixel == 1)
+	{
+		memset(outputPixel, *value, totalSize);
+		return;
+	}
+	if (outputPixel != value) { memcpy(outputPixel, value, bytesPerPixel); }
+	for (size_t filled = bytesPerPixel; filled < totalSize; filled *= 2) { memcpy(outputPixel + filled, outputPixel, std::min(filled, totalSize - filled)); }
+}
+
+// The number of pixels in the packet starting with this character, which is a count of literal pixels if positive, or a count of repeats of one
+// pixel otherwise.
+inline uint32_t getPacketLength(int8_t leadingCharacter) { return 1u + (leadingCharacter & 0x7f); }
+
 void loadIndexed(const texture_tga::FileHeader& header, const Stream& stream, Texture& asset, uint32_t bytesPerPaletteEntry, uint32_t bytesPerDataEntry)
 {
 	// Check that a palette is present.
@@ -68,68 +136,35 @@ void loadIndexed(const texture_tga::FileHeader& header, const Stream& stream, Te
 	// Create the palette helper class
 	PaletteExpander paletteLookup(paletteData.data(), paletteSize, bytesPerPaletteEntry);
 
-	// Start reading data
-	unsigned char* outputPixel = asset.getDataPointer();
-	uint32_t currentIndex = 0;
-	for (uint32_t texturePosition = 0; texturePosition < (asset.getTextureSize()); ++texturePosition)
-	{
-		// Read the index
-		stream.readExact(bytesPerDataEntry, 1, &currentIndex);
-		// Get the color output
-		paletteLookup.getColorFromIndex(currentIndex, outputPixel);
-
-		// Increment the pixel
-		outputPixel += bytesPerPaletteEntry;
-	}
+	// Read all the indices at once, then expand them
+	std::vector<uint8_t> indices(static_cast<size_t>(asset.getTextureSize()) * bytesPerDataEntry);
+	stream.readExact(bytesPerDataEntry, asset.getTextureSize(), indices.data());
+	paletteLookup.expandIndices(indices.data(), asset.getTextureSize(), bytesPerDataEntry, asset.getDataPointer());
 }
 
 void loadRunLength(const texture_tga::FileHeader& header, const Stream& stream, Texture& asset, uint32_t bytesPerDataEntry)
 {
 	(void)header;
-	// Buffer for any repeated values come across
-	vector<char> repeatedValue;
-	repeatedValue.resize(bytesPerDataEntry);
+	ChunkedReader reader(stream);
 
 	// Read the run length encoded data, and decode it.
-	unsigned char* outputPixel = asset.getDataPointer();
-	while (outputPixel < (asset.getDataPointer() + asset.getDataSize()))
+	uint8_t* outputPixel = asset.getDataPointer();
+	uint32_t pixelsLeft = asset.getDataSize() / bytesPerDataEntry;
+	while (pixelsLeft)
 	{
 		// Read the leading character for this block
-		int8_t leadingCharacter;
-		stream.readExact(1, 1, &leadingCharacter);
+		const int8_t leadingCharacter = static_cast<int8_t>(*reader.read(1));
+		// Character -128 is a "no op", so there's nothing to do for it. It's used as padding basically.
+		if (leadingCharacter == -128) { continue; }
+		const uint32_t numPixels = std::min(getPacketLength(leadingCharacter), pixelsLeft);
 		// Check if it's a run of differing values or a run of the same value multiple times
-		if (leadingCharacter >= 0)
-		{
-			// Read each value in turn
-			for (int runIndex = 0; runIndex < (1 + (leadingCharacter & 0x7f)); ++runIndex)
-			{
-				if (outputPixel < (asset.getDataPointer() + asset.getDataSize()))
-				{
-					// Read in the value
-					stream.readExact(bytesPerDataEntry, 1, outputPixel);
-					// Increment the output location
-					outputPixel += bytesPerDataEntry;
-				}
-			}
-		}
-		else if (leadingCharacter > -128)
+		if (leadingCharacter >= 0) { memcpy(outputPixel, reader.read(numPixels * bytesPerDataEntry), numPixels * bytesPerDataEntry); }
+		else
 		{
-			// Read a repeated value
-			stream.readExact(bytesPerDataEntry, 1, repeatedValue.data());
-			// Write the repeated value the appropriate number of times
-			for (int runIndex = 0; runIndex < (1 + (leadingCharacter & 0x7f)); ++runIndex)
-			{
-				if (outputPixel < (asset.getDataPointer() + asset.getDataSize()))
-				{
-					// Copy the data across
-					memcpy(outputPixel, repeatedValue.data(), bytesPerDataEntry);
-
-					// Increment the output location
-					outputPixel += bytesPerDataEntry;
-				}
-			}
+			fillPixels(outputPixel, reader.read(bytesPerDataEntry), bytesPerDataEntry, numPixels);
 		}
-		// Character -128 is a "no op", so there's nothing to do for it. It's used as padding basically.
+		outputPixel += numPixels * bytesPerDataEntry;
+		pixelsLeft -= numPixels;
 	}
 }
 
@@ -154,53 +189,28 @@ void loadRunLengthIndexed(const texture_tga::FileHeader& header, const Stream& s
 
 	// Create the palette helper class
 	PaletteExpander paletteLookup(paletteData.data(), paletteSize, bytesPerPaletteEntry);
+	ChunkedReader reader(stream);
 
-	// Index value into the palette
-	uint32_t currentIndex = 0;
-
-	// Read the run length encoded data, and decode it.
+	// Read the run length encoded data, and decode it. The output is made of palette entries, not indices.
 	uint8_t* outputPixel = asset.getDataPointer();
-	while (outputPixel < (asset.getDataPointer() + asset.getDataSize()))
+	uint32_t pixelsLeft = asset.getDataSize() / bytesPerPaletteEntry;
+	while (pixelsLeft)
 	{
 		// Read the leading character for this block
-		int8_t leadingCharacter;
-		stream.readExact(1, 1, &leadingCharacter);
+		const int8_t leadingCharacter = static_cast<int8_t>(*reader.read(1));
+		// Character -128 is a "no op", so there's nothing to do for it. It's used as padding basically.
+		if (leadingCharacter == -128) { continue; }
+		const uint32_t numPixels = std::min(getPacketLength(leadingCharacter), pixelsLeft);
 		// Check if it's a run of differing values or a run of the same value multiple times
-		if (leadingCharacter >= 0)
-		{
-			// Read each index value in turn
-			for (int runIndex = 0; runIndex < (1 + (leadingCharacter & 0x7f)); ++runIndex)
-			{
-				if (outputPixel < (asset.getDataPointer() + asset.getDataSize()))
-				{
-					// Read in the value
-					stream.readExact(bytesPerDataEntry, 1, &currentIndex);
-					// Get the color output
-					paletteLookup.getColorFromIndex(currentIndex, outputPixel);
-
-					// Increment the output location
-					outputPixel += bytesPerDataEntry;
-				}
-			}
-		}
-		else if (leadingCharacter > -128)
+		if (leadingCharacter >= 0) { paletteLookup.expandIndices(reader.read(numPixels * bytesPerDataEntry), numPixels, bytesPerDataEntry, outputPixel); }
+		else
 		{
-			// Read in the repeated value
-			stream.readExact(bytesPerDataEntry, 1, &currentIndex);
-			// Write the repeated value the appropriate number of times
-			for (int runIndex = 0; runIndex < (1 + (leadingCharacter & 0x7f)); ++runIndex)
-			{
-				if (outputPixel < (asset.getDataPointer() + asset.getDataSize()))
-				{
-					// Get the color output
-					paletteLookup.getColorFromIndex(currentIndex, outputPixel);
-
-					// Increment the output location
-					outputPixel += bytesPerDataEntry;
-				}
-			}
+			// Look the repeated value up once, then copy it
+			paletteLookup.expandIndices(reader.read(bytesPerDataEntry), 1, bytesPerDataEntry, outputPixel);
+			fillPixels(outputPixel, outputPixel, bytesPerPaletteEntry, numPixels);
 		}
-		// Character -128 is a "no op", so there's nothing to do for it. It's used as padding basically.
+		outputPixel += numPixels * bytesPerPaletteEntry;
+		pixelsLeft -= numPixels;
 	}
 }
 
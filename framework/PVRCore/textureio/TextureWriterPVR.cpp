@@ -8,7 +8,6 @@
 #include "PVRCore/textureio/TextureWriterPVR.h"
 #include "PVRCore/textureio/FileDefinesPVR.h"
 #include "PVRCore/Log.h"
-using std::map;
 using std::vector;
 namespace pvr {
 namespace assetWriters {
@@ -49,14 +48,7 @@ void writePVR(const Texture& asset, Stream& stream)
 	stream.writeExact(sizeof(asset.metaDataSize), 1, &asset.metaDataSize); // Write the meta data size
 
 	// Write the meta data
-	const map<uint32_t, map<uint32_t, TextureMetaData>>* metaDataMap = asset.getMetaDataMap();
-	map<uint32_t, map<uint32_t, TextureMetaData>>::const_iterator walkMetaDataMap = metaDataMap->begin();
-	for (; walkMetaDataMap != metaDataMap->end(); ++walkMetaDataMap)
-	{
-		const map<uint32_t, TextureMetaData>& currentDevMetaDataMap = walkMetaDataMap->second;
-		map<uint32_t, TextureMetaData>::const_iterator walkCurDevMetaMap = currentDevMetaDataMap.begin();
-		for (; walkCurDevMetaMap != currentDevMetaDataMap.end(); ++walkCurDevMetaMap) { writeTextureMetaDataToStream(stream, walkCurDevMetaMap->second); }
-	}
+	for (const TextureMetaData& metaData : asset.getMetaData()) { writeTextureMetaDataToStream(stream, metaData); }
 
 	// Write the texture data
 	stream.writeExact(1, asset.getDataSize(), asset.getDataPointer());
@@ -68,6 +60,14 @@ void writePVR(const Texture& asset, Stream&& stream)
 	writePVR(asset, str);
 }
 
+void writePVR(const Texture& asset, Stream& stream, CompressedPixelFormat format, const CompressionOptions& options) { writePVR(compressTexture(asset, format, options), stream); }
+
+void writePVR(const Texture& asset, Stream&& stream, CompressedPixelFormat format, const CompressionOptions& options)
+{
+	Stream& str = stream;
+	writePVR(asset, str, format, options);
+}
+
 } // namespace assetWriters
 } // namespace pvr
 //!\endcond
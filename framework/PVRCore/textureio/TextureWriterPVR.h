@@ -5,6 +5,7 @@
 \copyright Copyright (c) Imagination Technologies Limited.
 */
 #pragma once
+#include "PVRCore/texture/ETCCompress.h"
 #include "PVRCore/texture/Texture.h"
 #include "PVRCore/stream/Stream.h"
 
@@ -12,5 +13,20 @@ namespace pvr {
 namespace assetWriters {
 void writePVR(const ::pvr::Texture& texture, ::pvr::Stream& stream);
 void writePVR(const ::pvr::Texture& texture, ::pvr::Stream&& stream);
+
+/// <summary>Compresses an uncompressed texture (see compressTexture) and writes the result into a PVR file, for example to bake a cubemap and its
+/// MIP map chain to ETC2 at build time.</summary>
+/// <param name="texture">The texture to compress and write</param>
+/// <param name="stream">The stream to write to</param>
+/// <param name="format">The compressed format to write. Must be supported by isETCCompressionSupported, otherwise throws InvalidArgumentError.</param>
+/// <param name="options">Quality and threading options of the compressor</param>
+void writePVR(const ::pvr::Texture& texture, ::pvr::Stream& stream, ::pvr::CompressedPixelFormat format, const ::pvr::CompressionOptions& options = ::pvr::CompressionOptions());
+
+/// <summary>Compresses an uncompressed texture (see compressTexture) and writes the result into a PVR file.</summary>
+/// <param name="texture">The texture to compress and write</param>
+/// <param name="stream">The stream to write to</param>
+/// <param name="format">The compressed format to write. Must be supported by isETCCompressionSupported, otherwise throws InvalidArgumentError.</param>
+/// <param name="options">Quality and threading options of the compressor</param>
+void writePVR(const ::pvr::Texture& texture, ::pvr::Stream&& stream, ::pvr::CompressedPixelFormat format, const ::pvr::CompressionOptions& options = ::pvr::CompressionOptions());
 } // namespace assetWriters
 } // namespace pvr
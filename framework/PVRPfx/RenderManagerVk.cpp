@@ -261,7 +261,7 @@ inline void createVbos(utils::RenderManager& renderman, const std::map<assets::M
 			}
 
 			uint32_t size = static_cast<uint32_t>(attribConfig.size());
-			size = (mesh.getVertexData().empty() ? 0 : size); // make sure the mesh has a vertex data.
+			size = (mesh.getNumDataElements() == 0 ? 0 : size); // make sure the mesh has a vertex data.
 			apimesh.vbos.resize(size);
 			for (uint32_t vbo_id = 0; vbo_id < size; ++vbo_id)
 			{
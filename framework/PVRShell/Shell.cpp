@@ -10,10 +10,13 @@
 #include "PVRCore/stream/FilePath.h"
 #include "PVRShell/OS/ShellOS.h"
 #include "PVRCore/stream/FileStream.h"
+#include "PVRCore/stream/MappedFileStream.h"
 #include "PVRCore/types/Types.h"
 #include "PVRCore/Log.h"
 #include <cstdlib>
 #include <fstream>
+#include <sys/types.h>
+#include <sys/stat.h>
 #if defined(_WIN32)
 #include "PVRCore/Windows/WindowsResourceStream.h"
 #elif defined(__ANDROID__)
@@ -24,6 +27,38 @@
 #define EPSILON_PIXEL_SQUARE 100
 namespace pvr {
 namespace platform {
+namespace {
+// Baked models (.pvrmodel) are memory mapped where possible, so that readBakedModel references their vertex and index data in place instead of copying
+// it, which is what makes loading them independent of their size. Other assets are read: a mapping stays alive as long as anything referencing its
+// data (textures, meshes), and on Windows prevents the file from being rewritten while it is, which is only worth it for files meant to be loaded
+// this way. Falls back to reading the file if it cannot be mapped.
+std::unique_ptr<Stream> openAssetFile(const std::string& filepath)
+{
+	if (strings::endsWith(strings::toLower(filepath), ".pvrmodel"))
+	{
+		std::unique_ptr<Stream> stream = std::make_unique<MappedFileStream>(filepath, false);
+		if (stream->isReadable()) { return stream; }
+	}
+	return std::make_unique<FileStream>(filepath, "rb", false);
+}
+
+// Find the file of an asset on the filesystem: the filename itself, then the filename relative to each read path. Every location is first looked up
+// in the index only, which does not access the filesystem for directories already listed. The listings are only checked against the filesystem if
+// every location misses, in case the file was created after its directory was listed.
+bool findAssetFile(const DirectoryIndex& index, const std::vector<std::string>& readPaths, const std::string& filename, std::string& outFilePath)
+{
+	for (int recheck = 0; recheck < 2; ++recheck)
+	{
+		for (size_t i = 0; i <= readPaths.size(); ++i)
+		{
+			outFilePath = i == 0 ? filename : readPaths[i - 1] + filename;
+			if (recheck ? index.recheckFileExists(outFilePath) : index.fileExists(outFilePath)) { return true; }
+		}
+	}
+	return false;
+}
+} // namespace
+
 Shell::Shell() : _dragging(false), _data(0) {}
 
 Shell::~Shell() {}
@@ -433,6 +468,12 @@ void Shell::setCaptureFrames(uint32_t start, uint32_t stop)
 {
 	_data->captureFrameStart = start;
 	_data->captureFrameStop = stop;
+	// Write the captured frames in the background, so that capturing does not stall rendering on file IO.
+	if (!_data->screenshotWriter)
+	{
+		_data->screenshotWriter = std::make_unique<AsyncImageWriter>();
+		setScreenshotWriter(_data->screenshotWriter.get());
+	}
 }
 
 void Shell::setCaptureFrameScale(uint32_t value)
@@ -469,7 +510,10 @@ std::unique_ptr<Stream> Shell::getWriteAssetStream(const std::string& filename,
 		mode.append((truncateIfExists ? "a" : "w")).append("b").append((allowRead ? "+" : ""));
 
 		// The files will be written to the WritePath which is platform specific.
-		stream = std::make_unique<FileStream>(getWritePath() + filename, mode, false);
+		const std::string filepath = getWritePath() + filename;
+		stream = std::make_unique<FileStream>(filepath, mode, false);
+		// The file may have just been created: make sure the asset path index sees it.
+		_data->assetPathIndex.invalidateDirectory(filepath.substr(0, filepath.find_last_of("/\\") + 1));
 
 		if (stream.get())
 		{
@@ -488,23 +532,14 @@ std::unique_ptr<Stream> Shell::getAssetStream(const std::string& filename, bool
 {
 	// The shell will first attempt to open a file in your readpath with the same name.
 	// This allows you to override any built-in assets
+	// Files are only opened where the index of the read paths says they are (trying the absolute path first, then relative to the search paths), to
+	// avoid a failed open per read path.
 	std::unique_ptr<Stream> stream;
-	// Try absolute path first:
-
-	stream = std::make_unique<FileStream>(filename, "rb", false);
-	if (stream->isReadable()) { return stream; }
-	stream.reset(0);
-
-	// Then relative to the search paths:
-	const std::vector<std::string>& paths = getOS().getReadPaths();
-	for (size_t i = 0; i < paths.size(); ++i)
+	std::string filepath;
+	if (findAssetFile(_data->assetPathIndex, getOS().getReadPaths(), filename, filepath))
 	{
-		std::string filepath(paths[i]);
-		filepath += filename;
-
-		stream = std::make_unique<FileStream>(filepath, "rb", false);
+		stream = openAssetFile(filepath);
 		if (stream->isReadable()) { return stream; }
-
 		stream.reset(0);
 	}
 
@@ -545,6 +580,58 @@ std::unique_ptr<Stream> Shell::getAssetStream(const std::string& filename, bool
 	return std::unique_ptr<Stream>();
 }
 
+namespace {
+// Get the modification time of a regular file. Returns false if the file does not exist or is not a regular file.
+bool getFileModificationTime(const std::string& path, uint64_t& modificationTime)
+{
+#ifdef _WIN32
+	struct _stat64 fileStat;
+	if (_stat64(path.c_str(), &fileStat) != 0 || (fileStat.st_mode & _S_IFREG) == 0) { return false; }
+#else
+	struct stat fileStat;
+	if (stat(path.c_str(), &fileStat) != 0 || !S_ISREG(fileStat.st_mode)) { return false; }
+#endif
+	modificationTime = static_cast<uint64_t>(fileStat.st_mtime);
+	return true;
+}
+} // namespace
+
+bool Shell::resolveAsset(const std::string& filename, std::string& outResolvedPath, uint64_t& outModificationTime) const
+{
+	// Same lookup order as getAssetStream: absolute path, then the read paths, then the platform-specific stores.
+	if (findAssetFile(_data->assetPathIndex, getOS().getReadPaths(), filename, outResolvedPath) && getFileModificationTime(outResolvedPath, outModificationTime))
+	{
+		return true;
+	}
+	// Built-in assets cannot change while the application is running.
+	if (getAssetStream(filename, false))
+	{
+		outResolvedPath = "<built-in>:" + filename;
+		outModificationTime = 0;
+		return true;
+	}
+	return false;
+}
+
+AssetCache* Shell::getAssetCache() const { return &_data->assetCache; }
+
+void Shell::setAssetPathIndexPersistent(bool persistent)
+{
+	if (!persistent)
+	{
+		_data->assetPathIndexFile.clear();
+		return;
+	}
+	_data->assetPathIndexFile = getWritePath() + getApplicationName() + ".pathindex";
+	if (_data->assetPathIndex.load(_data->assetPathIndexFile)) { Log(LogLevel::Debug, "Asset path index loaded from %s", _data->assetPathIndexFile.c_str()); }
+}
+
+void Shell::saveAssetPathIndex()
+{
+	if (_data->assetPathIndexFile.empty() || !_data->assetPathIndex.isModified()) { return; }
+	if (!_data->assetPathIndex.save(_data->assetPathIndexFile)) { Log(LogLevel::Warning, "Could not save the asset path index to %s", _data->assetPathIndexFile.c_str()); }
+}
+
 template<typename... Args>
 void Shell::setApplicationName(const char* const format, Args... args)
 {
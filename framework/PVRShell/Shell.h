@@ -9,6 +9,7 @@ bottom of this file or of any Demo file for the newDemo function the user must i
 #include "PVRCore/commandline/CommandLine.h"
 #include "PVRShell/ShellData.h"
 #include "PVRCore/IAssetProvider.h"
+#include "PVRCore/AssetCache.h"
 #include "PVRCore/stream/BufferStream.h"
 #include "PVRCore/Log.h"
 #include "PVRCore/strings/StringFunctions.h"
@@ -827,7 +828,8 @@ public:
 	void showOutputInfo() const;
 
 	/// <summary>ONLY EFFECTIVE IF CALLED AT INIT APPLICATION. Captures the frames between start and stop and saves
-	/// them as TGA screenshots.</summary>
+	/// them as TGA screenshots. The screenshots are written in the background (see setScreenshotWriter), and are all on disk once the last
+	/// frame of the range has been rendered.</summary>
 	/// <param name="start">First frame to be captured</param>
 	/// <param name="stop">Last frame to be captured</param>
 	void setCaptureFrames(uint32_t start, uint32_t stop);
@@ -945,13 +947,34 @@ public:
 	/// <summary>Create and return a Stream object for a specific filename. Uses platform dependent lookup rules to
 	/// create the stream from the filesystem or a platform-specific store (Windows resources, Android .apk assets)
 	/// etc. Will first try the filesystem (if available) and then the built-in stores, in order to allow the user to
-	/// easily override built-in assets.</summary>
+	/// easily override built-in assets. Baked models (.pvrmodel) on the filesystem are opened as a MappedFileStream where possible, so that
+	/// readBakedModel references their data in place.</summary>
 	/// <param name="filename">The name of the file to load. Is usually a raw filename, but may contain a path.</param>
 	/// <param name="errorIfFileNotFound">Set this to false if file-not-found are expected and should not be logged as
 	/// errors.</param>
 	/// <returns>A unique pointer to the Stream returned if successful, an Empty unique pointer if failed.</returns>
 	std::unique_ptr<Stream> getAssetStream(const std::string& filename, bool errorIfFileNotFound = true) const;
 
+	/// <summary>Find the file that getAssetStream would open for a specific filename, without opening it, and get its modification time. Assets
+	/// that are not on the filesystem (Windows resources, Android .apk assets) are identified by their name, and never considered modified.</summary>
+	/// <param name="filename">The name of the file, as it would be passed to getAssetStream.</param>
+	/// <param name="outResolvedPath">The path of the file on the filesystem, or a name identifying the built-in asset.</param>
+	/// <param name="outModificationTime">The time the file was last modified, or 0 for built-in assets.</param>
+	/// <returns>True if the asset was found, otherwise false.</returns>
+	bool resolveAsset(const std::string& filename, std::string& outResolvedPath, uint64_t& outModificationTime) const override;
+
+	/// <summary>Enable or disable saving the index of the files found in the read paths when the application exits, so that the next run can reuse
+	/// it instead of listing the directories again. The index is saved in the write path. Enabling it loads any index saved by a previous run. Can
+	/// also be enabled with the command line option -persistpathindex.</summary>
+	/// <param name="persistent">True to save the index at exit, false to not save it</param>
+	void setAssetPathIndexPersistent(bool persistent);
+
+	/// <summary>Get the cache of decoded assets (textures, models) of this application. It is disabled by default, as cached assets stay in memory
+	/// after being uploaded: enable it by setting its byte budget, e.g. getAssetCache()->setByteBudget(64 * 1024 * 1024), to have the framework texture
+	/// loaders (textureLoadCached, utils::loadAndUploadImage, utils::textureUpload) only load and decode textures referenced several times once.</summary>
+	/// <returns>The asset cache of the application. Never null.</returns>
+	AssetCache* getAssetCache() const override;
+
 	/// <summary>Create and return a Stream object for a specific filename. Uses platform dependent write path rules to
 	/// create the stream</summary>
 	/// <param name="filename">The name of the file to load. Should be a raw filename.</param>
@@ -982,6 +1005,7 @@ private:
 	PrivatePointerState _pointerState;
 	ShellData* _data;
 	ConfigureEvent _configureEvent;
+	void saveAssetPathIndex();
 	SimplifiedInput MapKeyToMainInput(Keys key) const
 	{
 		switch (key)
@@ -9,6 +9,9 @@
 #include "PVRCore/texture/PixelFormat.h"
 #include "PVRCore/types/Types.h"
 #include "PVRCore/Time_.h"
+#include "PVRCore/AssetCache.h"
+#include "PVRCore/textureio/AsyncImageWriter.h"
+#include "PVRCore/stream/DirectoryIndex.h"
 
 /*! This file simply defines a version std::string. It can be commented out. */
 #include "sdkver.h"
@@ -67,11 +70,16 @@ struct ShellData
 	Api contextType; //!< The API used
 	Api minContextType; //!< The minimum API supported
 
+	std::unique_ptr<AsyncImageWriter> screenshotWriter; //!< The screenshot writer set while a range of frames is captured. Null if none is captured
+	AssetCache assetCache; //!< The cache of decoded assets shared by the application. Disabled until the application sets its budget
+	DirectoryIndex assetPathIndex; //!< The index of the files in the directories searched for assets
+	std::string assetPathIndexFile; //!< The file the asset path index is saved to at exit. Empty if the index is not persisted
+
 	/// <summary>Default constructor.</summary>
 	ShellData()
 		: os(0), commandLine(0), captureFrameStart(-1), captureFrameStop(-1), captureFrameScale(1), trapPointerOnDrag(true), forceFrameTime(false), fakeFrameTime(16),
 		  exiting(false), frameNo(0), forceReleaseInitWindow(false), forceReleaseInitView(false), dieAfterFrame(-1), dieAfterTime(-1), startTime(0), outputInfo(false),
-		  weAreDone(false), FPS(0.0f), showFPS(false), contextType(Api::Unspecified), minContextType(Api::Unspecified), currentFrameTime(static_cast<uint64_t>(-1)),
+		  weAreDone(false), FPS(0.0f), showFPS(false), contextType(Api::Unspecified), minContextType(Api::Unspecified), assetCache(0), currentFrameTime(static_cast<uint64_t>(-1)),
 		  lastFrameTime(static_cast<uint64_t>(-1)), timeAtInitApplication(static_cast<uint64_t>(-1)){};
 };
 } // namespace platform
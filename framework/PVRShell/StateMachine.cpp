@@ -295,6 +295,7 @@ void setForceFrameTime(Shell& shell, const char* arg, const char* val)
 }
 void showVersion(Shell& shell, const char* /*arg*/, const char* /*val*/) { Log(LogLevel::Information, "Version: '%hs'", shell.getSDKVersion()); }
 void setShowFps(Shell& shell, const char* /*arg*/, const char* /*val*/) { shell.setShowFPS(true); }
+void setPersistPathIndex(Shell& shell, const char* /*arg*/, const char* /*val*/) { shell.setAssetPathIndexPersistent(true); }
 void showInfo(Shell& shell, const char* /*arg*/, const char* /*val*/) { shell.getOS()._shellData.outputInfo = true; }
 void showCommandLineOptions(Shell& shell, const char* arg, const char* val);
 } // namespace
@@ -310,7 +311,7 @@ const std::map<std::string, SetShellParameterPtr> supportedCommandLineOptions{ s
 	std::make_pair("-c", &setCaptureFrames), std::make_pair("-screenshotscale", &setScreenshotScale), std::make_pair("-priority", &setContextPriority),
 	std::make_pair("-config", &setDesiredCconfigId), std::make_pair("-forceframetime", &setForceFrameTime), std::make_pair("-fft", &setForceFrameTime),
 	std::make_pair("-version", &showVersion), std::make_pair("-fps", &setShowFps), std::make_pair("-info", &showInfo), std::make_pair("-h", &showCommandLineOptions),
-	std::make_pair("-help", &showCommandLineOptions), std::make_pair("--help", &showCommandLineOptions) };
+	std::make_pair("-help", &showCommandLineOptions), std::make_pair("--help", &showCommandLineOptions), std::make_pair("-persistpathindex", &setPersistPathIndex) };
 
 namespace {
 void showCommandLineOptions(Shell& /*shell*/, const char* /*arg*/, const char* /*val*/)
@@ -480,6 +481,7 @@ Result StateMachine::executeQuitApplication()
 {
 	Log(LogLevel::Debug, "StateMachine::executeQuitApplication executing");
 	Result result = _shell->shellQuitApplication();
+	_shell->saveAssetPathIndex();
 
 	if (result != Result::Success)
 	{
@@ -497,6 +499,12 @@ Result StateMachine::executeQuitApplication()
 void StateMachine::preExit()
 {
 	Log(LogLevel::Debug, "StateMachine::preExit executing");
+	// Write the queued screenshots before exiting, rather than leaving them to a writer outliving the application.
+	if (_shellData.screenshotWriter)
+	{
+		setScreenshotWriter(nullptr);
+		_shellData.screenshotWriter.reset();
+	}
 	if (!_shellData.exitMessage.empty()) { ShellOS::popUpMessage(ShellOS::getApplicationName().c_str(), _shellData.exitMessage.c_str()); }
 }
 
@@ -620,6 +628,9 @@ Result StateMachine::executeFrame()
 				: "Reinit View requested: starting Reinitialization cycle. ReleaseView will be called next, then InitView. Window will not be recreated.");
 	}
 
+	// Make sure the captured range of frames is on disk as soon as its last frame has been rendered.
+	if (_shellData.screenshotWriter && static_cast<int32_t>(_shellData.frameNo) == _shellData.captureFrameStop) { _shellData.screenshotWriter->flush(); }
+
 	// Increment our frame number
 	++_shellData.frameNo;
 	if (_shellData.weAreDone) { Log(LogLevel::Debug, "[StateMachine]: We Are Done"); }
@@ -0,0 +1,164 @@
+/*!
+\brief Implementation of the non-stalling framebuffer capture.
+\file PVRUtils/OpenGLES/FrameCaptureGles.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+#include "PVRUtils/OpenGLES/FrameCaptureGles.h"
+#include "PVRUtils/OpenGLES/ErrorsGles.h"
+#include "PVRCore/strings/StringFunctions.h"
+#include <algorithm>
+
+namespace pvr {
+namespace utils {
+namespace {
+// Copies RGBA pixels, as read by glReadPixels, to the BGRA layout of captured images.
+void copyRgbaToBgra(const unsigned char* src, unsigned char* dst, size_t numPixels)
+{
+	for (size_t i = 0; i < numPixels; ++i, src += 4, dst += 4)
+	{
+		dst[0] = src[2];
+		dst[1] = src[1];
+		dst[2] = src[0];
+		dst[3] = src[3];
+	}
+}
+} // namespace
+
+FrameCapture::FrameCapture(uint32_t width, uint32_t height, bool isEs2, ColorSpace colorSpace, CaptureFileFormat fileFormat, uint32_t screenshotScale, uint32_t numBuffers,
+	uint32_t maxQueuedImages)
+	: _nextSlot(0), _width(width), _height(height), _isEs2(isEs2), _colorSpace(colorSpace), _fileFormat(fileFormat), _screenshotScale(screenshotScale), _writer(maxQueuedImages)
+{
+	if (_isEs2) { return; }
+
+	GLint previousBuffer = 0;
+	gl::GetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &previousBuffer);
+	_slots.resize(std::max(numBuffers, 1u));
+	for (Slot& slot : _slots)
+	{
+		slot.fence = nullptr;
+		gl::GenBuffers(1, &slot.buffer);
+		gl::BindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+		gl::BufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(_width) * _height * 4, nullptr, GL_STREAM_READ);
+	}
+	gl::BindBuffer(GL_PIXEL_PACK_BUFFER, static_cast<GLuint>(previousBuffer));
+	throwOnGlError("FrameCapture: Could not create the pixel pack buffers");
+}
+
+FrameCapture::~FrameCapture()
+{
+	flush();
+	for (Slot& slot : _slots) { gl::DeleteBuffers(1, &slot.buffer); }
+}
+
+std::string FrameCapture::getFileName(const std::string& filename) const
+{
+	std::string name, extension;
+	strings::getFileNameAndExtension(filename, name, extension);
+	return name + getCaptureFileExtension(_fileFormat);
+}
+
+void FrameCapture::capture(const std::string& filename)
+{
+	if (_isEs2)
+	{
+		CapturedImage image;
+		image.filename = getFileName(filename);
+		image.width = _width;
+		image.height = _height;
+		image.colorSpace = _colorSpace;
+		image.pixelReplicate = _screenshotScale;
+		std::vector<unsigned char> rgba(static_cast<size_t>(_width) * _height * 4);
+		gl::ReadPixels(0, 0, static_cast<GLsizei>(_width), static_cast<GLsizei>(_height), GL_RGBA, GL_UNSIGNED_BYTE, rgba.data());
+		if (gl::GetError() != GL_NO_ERROR)
+		{
+			Log(LogLevel::Error, "Screenshot was not taken successfully, filename %s.", image.filename.c_str());
+			return;
+		}
+		image.pixels.resize(rgba.size());
+		copyRgbaToBgra(rgba.data(), image.pixels.data(), static_cast<size_t>(_width) * _height);
+		_writer.write(std::move(image), _fileFormat);
+		return;
+	}
+
+	poll();
+	// If every buffer holds a capture still in flight, wait for the oldest one, which uses the buffer captured into next.
+	if (_inFlight.size() == _slots.size()) { collect(true); }
+
+	Slot& slot = _slots[_nextSlot];
+	GLint previousBuffer = 0;
+	gl::GetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &previousBuffer);
+	gl::BindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+	// With a pixel pack buffer bound, the last parameter is an offset into it and the read returns without waiting for the frame to be rendered.
+	gl::ReadPixels(0, 0, static_cast<GLsizei>(_width), static_cast<GLsizei>(_height), GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	gl::BindBuffer(GL_PIXEL_PACK_BUFFER, static_cast<GLuint>(previousBuffer));
+	if (gl::GetError() != GL_NO_ERROR)
+	{
+		Log(LogLevel::Error, "Screenshot was not taken successfully, filename %s.", filename.c_str());
+		return;
+	}
+	slot.fence = gl::FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	slot.filename = getFileName(filename);
+	_inFlight.push_back(_nextSlot);
+	_nextSlot = (_nextSlot + 1) % static_cast<uint32_t>(_slots.size());
+}
+
+void FrameCapture::poll()
+{
+	// Captures complete in submission order, so stop at the first one still in flight.
+	while (!_inFlight.empty() && collect(false)) {}
+}
+
+void FrameCapture::flush()
+{
+	while (!_inFlight.empty()) { collect(true); }
+	_writer.flush();
+}
+
+bool FrameCapture::collect(bool wait)
+{
+	Slot& slot = _slots[_inFlight.front()];
+	// The commands must be flushed when waiting, otherwise the fence may never be signalled.
+	const GLenum status = gl::ClientWaitSync(slot.fence, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, wait ? GL_TIMEOUT_IGNORED : 0);
+	if (status == GL_TIMEOUT_EXPIRED) { return false; }
+	gl::DeleteSync(slot.fence);
+	slot.fence = nullptr;
+	_inFlight.pop_front();
+
+	CapturedImage image;
+	image.filename = std::move(slot.filename);
+	slot.filename.clear();
+	image.width = _width;
+	image.height = _height;
+	image.colorSpace = _colorSpace;
+	image.pixelReplicate = _screenshotScale;
+	if (status == GL_WAIT_FAILED)
+	{
+		Log(LogLevel::Error, "Screenshot was not taken successfully, filename %s.", image.filename.c_str());
+		return true;
+	}
+
+	const size_t numPixels = static_cast<size_t>(_width) * _height;
+	GLint previousBuffer = 0;
+	gl::GetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &previousBuffer);
+	gl::BindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+	const void* data = gl::MapBufferRange(GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(numPixels * 4), GL_MAP_READ_BIT);
+	if (data)
+	{
+		image.pixels.resize(numPixels * 4);
+		copyRgbaToBgra(static_cast<const unsigned char*>(data), image.pixels.data(), numPixels);
+		gl::UnmapBuffer(GL_PIXEL_PACK_BUFFER);
+	}
+	gl::BindBuffer(GL_PIXEL_PACK_BUFFER, static_cast<GLuint>(previousBuffer));
+	if (!data)
+	{
+		Log(LogLevel::Error, "Screenshot was not taken successfully, filename %s.", image.filename.c_str());
+		return true;
+	}
+	_writer.write(std::move(image), _fileFormat);
+	return true;
+}
+} // namespace utils
+} // namespace pvr
+//!\endcond
@@ -0,0 +1,90 @@
+/*!
+\brief Contains a class capturing the default framebuffer to files without stalling the render thread.
+\file PVRUtils/OpenGLES/FrameCaptureGles.h
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+#pragma once
+#include "PVRCore/textureio/AsyncImageWriter.h"
+#include "PVRUtils/OpenGLES/BindingsGles.h"
+#include <deque>
+
+namespace pvr {
+namespace utils {
+
+/// <summary>Captures the framebuffer to files without stalling the render thread, as an alternative to takeScreenshot for capturing ranges of frames
+/// (see Shell::shouldTakeScreenshot). Each capture is read into one of a ring of pixel pack buffers, followed by a fence, so that glReadPixels returns
+/// without waiting for the frame to be rendered. Completed captures are collected later by polling their fences, and their pixels are encoded and
+/// written to disk by a background AsyncImageWriter. The render thread only waits if every buffer of the ring holds a capture still in flight, or if
+/// the writer falls behind. OpenGL ES 2 has neither pixel pack buffers nor fences: there, captures are read back synchronously, and only encoding
+/// and writing happen in the background.
+///
+/// All the functions, including the destructor, must be called with the context the object was created on current. Typical use, before swapping
+/// buffers:
+/// <code>
+/// if (shouldTakeScreenshot()) { frameCapture.capture(getScreenshotFileName()); }
+/// </code></summary>
+class FrameCapture
+{
+public:
+	/// <summary>Constructor. Creates the pixel pack buffers.</summary>
+	/// <param name="width">The width of the region captured, from the bottom left corner of the read framebuffer</param>
+	/// <param name="height">The height of the region captured, from the bottom left corner of the read framebuffer</param>
+	/// <param name="isEs2">True if the context is OpenGL ES 2, in which case captures are read back synchronously</param>
+	/// <param name="colorSpace">The colour space of the framebuffer. Only stored by the PVR file format.</param>
+	/// <param name="fileFormat">The format of the saved files. The extension of the file names passed to capture is replaced by the one of this format.</param>
+	/// <param name="screenshotScale">A scaling factor to use for increasing the size of the saved screenshots.</param>
+	/// <param name="numBuffers">The number of captures which can be in flight on the GPU before capture waits for the oldest one. At least 1.</param>
+	/// <param name="maxQueuedImages">The maximum number of images read back but not written yet, before capture blocks.</param>
+	FrameCapture(uint32_t width, uint32_t height, bool isEs2 = false, ColorSpace colorSpace = ColorSpace::lRGB, CaptureFileFormat fileFormat = CaptureFileFormat::TGA,
+		uint32_t screenshotScale = 1, uint32_t numBuffers = 3, uint32_t maxQueuedImages = 8);
+
+	/// <summary>Destructor. Waits for the pending captures and writes them, then deletes the pixel pack buffers.</summary>
+	~FrameCapture();
+
+	/// <summary>Captures the read framebuffer. Call it after rendering the frame and before swapping buffers. Also collects the captures which have
+	/// completed since the previous call.</summary>
+	/// <param name="filename">The name of the file to save the image to</param>
+	void capture(const std::string& filename);
+
+	/// <summary>Collects the captures which have completed, without waiting, and queues them to be written.</summary>
+	void poll();
+
+	/// <summary>Waits for every pending capture to complete and to be written to disk.</summary>
+	void flush();
+
+	/// <summary>Get the number of captures read into pixel pack buffers but not collected yet.</summary>
+	/// <returns>The number of captures in flight on the GPU</returns>
+	uint32_t getNumInFlight() const { return static_cast<uint32_t>(_inFlight.size()); }
+
+	/// <summary>Get the background writer, e.g. to query the number of images written or failed.</summary>
+	/// <returns>The image writer</returns>
+	const AsyncImageWriter& getWriter() const { return _writer; }
+
+private:
+	struct Slot
+	{
+		GLuint buffer;
+		GLsync fence;
+		std::string filename;
+	};
+
+	bool collect(bool wait);
+	std::string getFileName(const std::string& filename) const;
+
+	std::vector<Slot> _slots;
+	std::deque<uint32_t> _inFlight; // The slots read into and not collected yet, in submission order
+	uint32_t _nextSlot;
+	uint32_t _width;
+	uint32_t _height;
+	bool _isEs2;
+	ColorSpace _colorSpace;
+	CaptureFileFormat _fileFormat;
+	uint32_t _screenshotScale;
+	AsyncImageWriter _writer;
+
+	FrameCapture(const FrameCapture&) = delete;
+	FrameCapture& operator=(const FrameCapture&) = delete;
+};
+} // namespace utils
+} // namespace pvr
@@ -109,10 +109,10 @@ bool RetrieveTexcoords(const pvr::assets::Model::Mesh& mesh, uint32_t texcoordLa
 		for (uint32_t i = 0; i < nbVertices; i++) { uv[i] = glm::vec2(0.f, 0.f); }
 		return false;
 	}
-	const pvr::StridedBuffer& uvBuffer = mesh.getVertexData(originalUvAttribute->getDataIndex());
+	const uint8_t* uvBuffer = static_cast<const uint8_t*>(mesh.getData(originalUvAttribute->getDataIndex()));
 	const uint32_t stride = mesh.getStride(originalUvAttribute->getDataIndex());
 
-	for (uint32_t i = 0; i < nbVertices; i++) { memcpy((uint8_t*)glm::value_ptr(uv[i]), uvBuffer.data() + originalUvAttribute->getOffset() + i * stride, sizeof(float) * 2); }
+	for (uint32_t i = 0; i < nbVertices; i++) { memcpy((uint8_t*)glm::value_ptr(uv[i]), uvBuffer + originalUvAttribute->getOffset() + i * stride, sizeof(float) * 2); }
 
 	return true;
 }
@@ -133,7 +133,7 @@ bool RetrieveColours(const pvr::assets::Model::Mesh& mesh, std::vector<glm::u16v
 		return false;
 	}
 
-	const pvr::StridedBuffer& colorBuffer = mesh.getVertexData(originalColorAttribute->getDataIndex());
+	const uint8_t* colorBuffer = static_cast<const uint8_t*>(mesh.getData(originalColorAttribute->getDataIndex()));
 	const uint32_t stride = mesh.getStride(originalColorAttribute->getDataIndex());
 
 	if (originalColorAttribute->getVertexLayout().dataType == pvr::DataType::Float32)
@@ -143,7 +143,7 @@ bool RetrieveColours(const pvr::assets::Model::Mesh& mesh, std::vector<glm::u16v
 		{
 			const uint32_t inputAddress = originalColorAttribute->getOffset() + i * stride;
 			glm::vec4 fcolour;
-			memcpy((uint8_t*)glm::value_ptr(fcolour), colorBuffer.data() + inputAddress, sizeof(glm::vec4));
+			memcpy((uint8_t*)glm::value_ptr(fcolour), colorBuffer + inputAddress, sizeof(glm::vec4));
 
 			glm::u16vec4 ucolour = glm::u16vec4(fcolour * 65535.f);
 			colours[i] = ucolour;
@@ -154,7 +154,7 @@ bool RetrieveColours(const pvr::assets::Model::Mesh& mesh, std::vector<glm::u16v
 		// No conversion needed, just copy
 		for (uint32_t i = 0; i < nbVertices; i++)
 		{
-			memcpy((uint8_t*)glm::value_ptr(colours[i]), colorBuffer.data() + originalColorAttribute->getOffset() + i * stride, sizeof(uint16_t) * 4);
+			memcpy((uint8_t*)glm::value_ptr(colours[i]), colorBuffer + originalColorAttribute->getOffset() + i * stride, sizeof(uint16_t) * 4);
 		}
 	}
 	return true;
@@ -173,7 +173,7 @@ bool RetrieveTangents(const pvr::assets::Model::Mesh& mesh, std::vector<glm::vec
 		for (uint32_t i = 0; i < nbVertices; i++) { tangents[i] = glm::vec4(1.f, 0.f, 0.f, 1.f); }
 		return false;
 	}
-	const pvr::StridedBuffer& tangentBuffer = mesh.getVertexData(originalTangentAttribute->getDataIndex());
+	const uint8_t* tangentBuffer = static_cast<const uint8_t*>(mesh.getData(originalTangentAttribute->getDataIndex()));
 	const uint32_t tangentStride = mesh.getStride(originalTangentAttribute->getDataIndex());
 	const uint32_t tangentElements = originalTangentAttribute->getN();
 
@@ -181,7 +181,7 @@ bool RetrieveTangents(const pvr::assets::Model::Mesh& mesh, std::vector<glm::vec
 	{
 		glm::vec4 tangent = glm::vec4(1.f, 0.f, 0.f, 1.f);
 
-		memcpy((uint8_t*)glm::value_ptr(tangent), tangentBuffer.data() + originalTangentAttribute->getOffset() + i * tangentStride, sizeof(float) * tangentElements);
+		memcpy((uint8_t*)glm::value_ptr(tangent), tangentBuffer + originalTangentAttribute->getOffset() + i * tangentStride, sizeof(float) * tangentElements);
 
 		if (forceNormalization)
 		{
@@ -209,12 +209,12 @@ bool RetrieveNormals(const pvr::assets::Model::Mesh& mesh, std::vector<glm::vec3
 		for (uint32_t i = 0; i < nbVertices; i++) { normals[i] = glm::vec3(0.f, 1.f, 0.f); }
 		return false;
 	}
-	const pvr::StridedBuffer& posBuffer = mesh.getVertexData(originalNormalAttribute->getDataIndex());
+	const uint8_t* posBuffer = static_cast<const uint8_t*>(mesh.getData(originalNormalAttribute->getDataIndex()));
 	const uint32_t stride = mesh.getStride(originalNormalAttribute->getDataIndex());
 
 	for (uint32_t i = 0; i < nbVertices; i++)
 	{
-		memcpy((uint8_t*)glm::value_ptr(normals[i]), posBuffer.data() + originalNormalAttribute->getOffset() + i * stride, sizeof(float) * 3);
+		memcpy((uint8_t*)glm::value_ptr(normals[i]), posBuffer + originalNormalAttribute->getOffset() + i * stride, sizeof(float) * 3);
 		if (forceNormalization) { normals[i] = glm::normalize(normals[i]); }
 	}
 
@@ -230,12 +230,12 @@ bool RetrievePositions(const pvr::assets::Model::Mesh& mesh, std::vector<glm::ve
 
 	const pvr::assets::Mesh::VertexAttributeData* originalPosAttribute = mesh.getVertexAttributeByName(positionAttributeName);
 	if (originalPosAttribute == nullptr) { return false; }
-	const pvr::StridedBuffer& posBuffer = mesh.getVertexData(originalPosAttribute->getDataIndex());
+	const uint8_t* posBuffer = static_cast<const uint8_t*>(mesh.getData(originalPosAttribute->getDataIndex()));
 	const uint32_t stride = mesh.getStride(originalPosAttribute->getDataIndex());
 
 	for (uint32_t i = 0; i < nbVertices; i++)
 	{
-		memcpy((uint8_t*)glm::value_ptr(positions[i]), posBuffer.data() + originalPosAttribute->getOffset() + i * stride, sizeof(float) * 3);
+		memcpy((uint8_t*)glm::value_ptr(positions[i]), posBuffer + originalPosAttribute->getOffset() + i * stride, sizeof(float) * 3);
 	}
 
 	return true;
@@ -252,10 +252,10 @@ bool RetrieveBoneIndicesAndWeights(
 	const uint32_t nbVertices = mesh.getNumVertices();
 
 	const pvr::assets::Mesh::VertexAttributeData* originalBoneIndexAttribute = mesh.getVertexAttributeByName(boneIndexAttributeName);
-	const pvr::StridedBuffer& boneIndexBuffer = mesh.getVertexData(originalBoneIndexAttribute->getDataIndex());
+	const uint8_t* boneIndexBuffer = static_cast<const uint8_t*>(mesh.getData(originalBoneIndexAttribute->getDataIndex()));
 	const uint32_t boneIndexStride = mesh.getStride(originalBoneIndexAttribute->getDataIndex());
 	const pvr::assets::Mesh::VertexAttributeData* originalBoneWeightsAttribute = mesh.getVertexAttributeByName(boneWeightAttributeName);
-	const pvr::StridedBuffer& boneWeightBuffer = mesh.getVertexData(originalBoneWeightsAttribute->getDataIndex());
+	const uint8_t* boneWeightBuffer = static_cast<const uint8_t*>(mesh.getData(originalBoneWeightsAttribute->getDataIndex()));
 	const uint32_t bonWeightStride = mesh.getStride(originalBoneWeightsAttribute->getDataIndex());
 
 	// Check how many bytes are used for a single bone index
@@ -278,7 +278,7 @@ bool RetrieveBoneIndicesAndWeights(
 		{
 			// Read the bone index
 			uint32_t boneIndex = 0;
-			if (b < originalBonesPerVertex) { memcpy((uint8_t*)&boneIndex, boneIndexBuffer.data() + inputIndexVertexStart + originalBoneIndexSize * b, originalBoneIndexSize); }
+			if (b < originalBonesPerVertex) { memcpy((uint8_t*)&boneIndex, boneIndexBuffer + inputIndexVertexStart + originalBoneIndexSize * b, originalBoneIndexSize); }
 			// Write the bone index
 			memcpy(boneIndices.data() + outputIndexVertexStart + requestedBoneIndexSize * b, &boneIndex, requestedBoneIndexSize);
 		}
@@ -290,7 +290,7 @@ bool RetrieveBoneIndicesAndWeights(
 
 			glm::vec4 weights(0.f);
 			// Read the weights
-			memcpy((uint8_t*)glm::value_ptr(weights), boneWeightBuffer.data() + inputWeightVertexStart, minBonesPerVertex * sizeof(float));
+			memcpy((uint8_t*)glm::value_ptr(weights), boneWeightBuffer + inputWeightVertexStart, minBonesPerVertex * sizeof(float));
 
 			// TODO: should we renormalize weights when truncating num bones?
 
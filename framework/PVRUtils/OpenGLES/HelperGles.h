@@ -7,14 +7,17 @@
 #pragma once
 #include "PVRCore/IAssetProvider.h"
 #include "PVRCore/texture/PVRTDecompress.h"
+#include "PVRCore/texture/BCDecompress.h"
 #include "PVRUtils/PVRUtilsTypes.h"
 #include "PVRAssets/Model.h"
 #include "PVRCore/texture/TextureLoad.h"
+#include "PVRCore/texture/TextureAtlasPacker.h"
 #include "PVRUtils/OpenGLES/TextureUtilsGles.h"
 #include "PVRUtils/OpenGLES/ShaderUtilsGles.h"
 #include "PVRUtils/OpenGLES/ConvertToGlesTypes.h"
 #include "PVRUtils/OpenGLES/ErrorsGles.h"
 #include "PVRCore/textureio/TGAWriter.h"
+#include "PVRCore/textureio/AsyncImageWriter.h"
 #include "PVRUtils/OpenGLES/PBRUtilsGles.h"
 #include <iterator>
 
@@ -185,7 +188,8 @@ inline bool checkFboStatus()
 /// <summary>Reads a block of pixel data from the frame buffer using the dimensions width and height as the dimensions of the
 /// pixel rectangle saved. The function will save the pixel data as a TGA file with the name specified by screenshotFileName. The
 /// function can be used to take screenshots of the current frame buffer or frame when called prior to presenting the backbuffer i.e.
-/// swapping buffers.</summary>
+/// swapping buffers. The pixels are read back before returning. The file is written in the background by the screenshot writer if one is set (see
+/// setScreenshotWriter), otherwise before returning. FrameCapture avoids waiting for the read back as well, and is preferable to capture ranges of frames.</summary>
 /// <param name="screenshotFileName">The name used as the filename for the saved TGA screenshot.</param>
 /// <param name="width">The width of the pixel rectangle retrieved.</param>
 /// <param name="height">The width of the pixel rectangle retrieved.</param>
@@ -210,8 +214,13 @@ inline void takeScreenshot(const std::string& screenshotFileName, const uint32_t
 			pBuffer[i + 2] = tmp;
 		}
 
-		Log(LogLevel::Information, "Writing TGA screenshot, filename %s.", screenshotFileName.c_str());
-		writeTGA(screenshotFileName.c_str(), width, height, pBuffer.data(), 4, screenshotScale);
+		CapturedImage image;
+		image.filename = screenshotFileName;
+		image.width = width;
+		image.height = height;
+		image.pixels = std::move(pBuffer);
+		image.pixelReplicate = screenshotScale;
+		writeScreenshot(std::move(image), CaptureFileFormat::TGA);
 	}
 
 	err = gl::GetError();
@@ -230,9 +239,8 @@ inline void takeScreenshot(const std::string& screenshotFileName, const uint32_t
 /// <returns>A scaling factor to use for increasing the size of the saved screenshot.</returns>
 inline GLuint textureUpload(const IAssetProvider& app, const char* file, pvr::Texture& outTexture, bool isEs2 = false)
 {
-	outTexture = pvr::textureLoad(*app.getAssetStream(file), pvr::getTextureFormatFromFilename(file));
-
-	auto res = pvr::utils::textureUpload(outTexture, isEs2, true);
+	std::shared_ptr<const Texture> cachedTexture;
+	auto res = pvr::utils::textureUpload(pvr::textureLoadForUpload(app, file, &outTexture, cachedTexture), isEs2, true);
 
 	return res.image;
 }
@@ -244,21 +252,20 @@ inline GLuint textureUpload(const IAssetProvider& app, const std::string& file,
 
 inline GLuint textureUpload(const IAssetProvider& app, const char* file, bool isEs2 = false)
 {
-	pvr::Texture tex;
-	return textureUpload(app, file, tex, isEs2);
+	// Uploaded straight from the texture shared with the cache of the asset provider, if it is enabled, to avoid copying it.
+	return pvr::utils::textureUpload(*pvr::textureLoadCached(app, file), isEs2, true).image;
 }
 
 inline GLuint textureUpload(const IAssetProvider& app, const std::string& file, bool isEs2 = false) { return textureUpload(app, file.c_str(), isEs2); }
 
 inline TextureUploadResults textureUploadWithResults(const IAssetProvider& app, const char* file, pvr::Texture& outTexture, bool isEs2 = false)
 {
-	outTexture = pvr::textureLoad(*app.getAssetStream(file), pvr::getTextureFormatFromFilename(file));
-
-	return pvr::utils::textureUpload(outTexture, isEs2, true);
+	std::shared_ptr<const Texture> cachedTexture;
+	return pvr::utils::textureUpload(pvr::textureLoadForUpload(app, file, &outTexture, cachedTexture), isEs2, true);
 }
 inline TextureUploadResults textureUploadWithResults(const IAssetProvider& app, const char* file, bool isEs2 = false)
 {
-	return pvr::utils::textureUpload(pvr::textureLoad(*app.getAssetStream(file), pvr::getTextureFormatFromFilename(file)), isEs2, true);
+	return pvr::utils::textureUpload(*pvr::textureLoadCached(app, file), isEs2, true);
 }
 
 inline pvr::Texture getTextureData(const IAssetProvider& app, const char* file)
@@ -269,6 +276,10 @@ inline pvr::Texture getTextureData(const IAssetProvider& app, const char* file)
 	bool isCompressedFormat =
 		(outTexture.getPixelFormat().getPart().High == 0) && (outTexture.getPixelFormat().getPixelTypeId() != static_cast<uint64_t>(CompressedPixelFormat::SharedExponentR9G9B9E5));
 
+	// BC textures are decompressed regardless of the support of the platform, as most of them have no OpenGL ES format.
+	if (isCompressedFormat && isBCFormat(static_cast<CompressedPixelFormat>(outTexture.getPixelFormat().getPixelTypeId())))
+	{ return decompressBcTexture(outTexture); }
+
 	if (isCompressedFormat)
 	{
 		// Get the texture format for the API
@@ -335,188 +346,29 @@ inline pvr::Texture getTextureData(const IAssetProvider& app, const char* file)
 inline void generateTextureAtlas(
 	const IAssetProvider& app, const StringHash* fileNames, Rectanglef* outUVs, uint32_t numTextures, GLuint* outTexture, TextureHeader* outDescriptor, bool isEs2 = false)
 {
-	struct SortedImage
-	{
-		uint32_t id;
-		pvr::Texture texture;
-		uint16_t width;
-		uint16_t height;
-		uint16_t srcX;
-		uint16_t srcY;
-		bool hasAlpha;
-	};
-	std::vector<SortedImage> sortedImage(numTextures);
-	struct SortCompare
-	{
-		bool operator()(const SortedImage& a, const SortedImage& b)
-		{
-			uint32_t aSize = a.width * a.height;
-			uint32_t bSize = b.width * b.height;
-			return (aSize > bSize);
-		}
-	};
-
-	struct Area
-	{
-		uint32_t x;
-		uint32_t y;
-		uint32_t w;
-		uint32_t h;
-		uint32_t size;
-		bool isFilled;
-
-		Area* right;
-		Area* left;
-
-	private:
-		void setSize(uint32_t width, uint32_t height)
-		{
-			w = width;
-			h = height;
-			size = width * height;
-		}
-
-	public:
-		Area(uint32_t width, uint32_t height) : x(0), y(0), isFilled(false), right(NULL), left(NULL) { setSize(width, height); }
-		Area() : x(0), y(0), isFilled(false), right(NULL), left(NULL) { setSize(0, 0); }
-
-		Area* insert(uint32_t width, uint32_t height)
-		{
-			// If this area has branches below it (i.e. is not a leaf) then traverse those.
-			// Check the left branch first.
-			if (left)
-			{
-				Area* tempPtr = NULL;
-				tempPtr = left->insert(width, height);
-				if (tempPtr != NULL) { return tempPtr; }
-			}
-			// Now check right
-			if (right) { return right->insert(width, height); }
-			// Already filled!
-			if (isFilled) { return NULL; }
-
-			// Too small
-			if (size < width * height || w < width || h < height) { return NULL; }
-
-			// Just right!
-			if (size == width * height && w == width && h == height)
-			{
-				isFilled = true;
-				return this;
-			}
-			// Too big. Split up.
-			if (size > width * height && w >= width && h >= height)
-			{
-				// Initializes the children, and sets the left child's coordinates as these don't change.
-				left = new Area;
-				right = new Area;
-				left->x = x;
-				left->y = y;
-
-				// --- Splits the current area depending on the size and position of the placed texture.
-				// Splits vertically if larger free distance across the texture.
-				if ((w - width) > (h - height))
-				{
-					left->w = width;
-					left->h = h;
-
-					right->x = x + width;
-					right->y = y;
-					right->w = w - width;
-					right->h = h;
-				}
-				// Splits horizontally if larger or equal free distance downwards.
-				else
-				{
-					left->w = w;
-					left->h = height;
-
-					right->x = x;
-					right->y = y + height;
-					right->w = w;
-					right->h = h - height;
-				}
-
-				// Initializes the child members' size attributes.
-				left->size = left->h * left->w;
-				right->size = right->h * right->w;
-
-				// Inserts the texture into the left child member.
-				return left->insert(width, height);
-			}
-			// Catch all error return.
-			return NULL;
-		}
-
-		bool deleteArea()
-		{
-			if (left != NULL)
-			{
-				if (left->left != NULL)
-				{
-					if (!left->deleteArea()) { return false; }
-					if (!right->deleteArea()) { return false; }
-				}
-			}
-			if (right != NULL)
-			{
-				if (right->left != NULL)
-				{
-					if (!left->deleteArea()) { return false; }
-					if (!right->deleteArea()) { return false; }
-				}
-			}
-			delete right;
-			right = NULL;
-			delete left;
-			left = NULL;
-			return true;
-		}
-	};
-
 	// load the textures
+	std::vector<pvr::Texture> textures(numTextures);
+	std::vector<uint32_t> widths(numTextures), heights(numTextures);
 	for (uint32_t i = 0; i < numTextures; ++i)
 	{
-		sortedImage[i].texture = pvr::utils::getTextureData(app, fileNames[i].c_str());
-
-		sortedImage[i].id = i;
-		sortedImage[i].width = static_cast<uint16_t>(sortedImage[i].texture.getWidth());
-		sortedImage[i].height = static_cast<uint16_t>(sortedImage[i].texture.getHeight());
-		const unsigned char* pixelString = sortedImage[i].texture.getPixelFormat().getPixelTypeChar();
-		if (sortedImage[i].texture.getPixelFormat().getPixelTypeId() == static_cast<uint64_t>(pvr::CompressedPixelFormat::PVRTCI_2bpp_RGBA) ||
-			sortedImage[i].texture.getPixelFormat().getPixelTypeId() == static_cast<uint64_t>(pvr::CompressedPixelFormat::PVRTCI_4bpp_RGBA) || pixelString[0] == 'a' ||
-			pixelString[1] == 'a' || pixelString[2] == 'a' || pixelString[3] == 'a')
-		{
-			sortedImage[i].hasAlpha = true;
-		}
-		else
-		{
-			sortedImage[i].hasAlpha = false;
-		}
+		textures[i] = pvr::utils::getTextureData(app, fileNames[i].c_str());
+		widths[i] = textures[i].getWidth();
+		heights[i] = textures[i].getHeight();
 	}
 
 	pvr::utils::throwOnGlError("generateTextureAtlas Begin");
 
-	//// sort the sprites
-	std::sort(sortedImage.begin(), sortedImage.end(), SortCompare());
-	// find the best width and height
-	uint32_t width = 0, height = 0, area = 0;
-	uint32_t preferredDim[] = { 8, 16, 32, 64, 128, 256, 512, 1024 };
+	// Pack the textures, keeping a one pixel border around each of them so that filtering does not bleed between neighbours.
 	const uint32_t atlasPixelBorder = 1;
-	const uint32_t totalBorder = atlasPixelBorder * 2;
-	uint32_t i = 0;
-	// calculate the total area
-	for (; i < sortedImage.size(); ++i) { area += (sortedImage[i].width + totalBorder) * (sortedImage[i].height + totalBorder); }
-	i = 0;
-	while ((preferredDim[i] * preferredDim[i]) < area && i < sizeof(preferredDim) / sizeof(preferredDim[0])) { ++i; }
-	if (i >= sizeof(preferredDim) / sizeof(preferredDim[0])) { throw InvalidDataError("Cannot find a best size for texture atlas"); }
-	width = height = preferredDim[i];
-	float oneOverWidth = 1.f / width;
-	float oneOverHeight = 1.f / height;
-
-	Area* head = new Area(width, height);
-	Area* pRtrn = NULL;
-	Offset3D dstOffset[2];
+	GLint maxTextureSize = 0;
+	gl::GetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+	std::vector<AtlasRect> rects(numTextures);
+	uint32_t width = 0, height = 0;
+	if (!packTextureAtlas(widths.data(), heights.data(), numTextures, static_cast<uint32_t>(maxTextureSize), AtlasPackerOptions(AtlasPackingHeuristic::BestShortSideFit, atlasPixelBorder),
+			width, height, rects.data()))
+	{ throw InvalidDataError("Cannot find a best size for texture atlas"); }
+	const float oneOverWidth = 1.f / width;
+	const float oneOverHeight = 1.f / height;
 
 	// create the out texture store
 	ImageStorageFormat outFmt(PixelFormat::RGBA_32323232(), 1, ColorSpace::lRGB, VariableType::Float);
@@ -535,8 +387,7 @@ inline void generateTextureAtlas(
 	bool unused;
 
 	// Check that the format is a valid format for this API - Doesn't check specifically between OpenGL/ES
-	utils::getOpenGLFormat(sortedImage[0].texture.getPixelFormat(), sortedImage[0].texture.getColorSpace(), sortedImage[0].texture.getChannelType(), glInternalFormat, glFormat,
-		glType, glTypeSize, unused);
+	utils::getOpenGLFormat(textures[0].getPixelFormat(), textures[0].getColorSpace(), textures[0].getChannelType(), glInternalFormat, glFormat, glType, glTypeSize, unused);
 
 	if (useTexStorage) { gl::TexStorage2D(GL_TEXTURE_2D, 1, glInternalFormat, static_cast<GLsizei>(width), static_cast<GLsizei>(height)); }
 	else
@@ -547,31 +398,17 @@ inline void generateTextureAtlas(
 
 	pvr::utils::throwOnGlError("generateTextureAtlas Generate output texture");
 
-	for (uint32_t textureIndex = 0; textureIndex < numTextures; ++textureIndex)
+	// The whole layout is known at this point, so the uploads are issued back to back.
+	for (uint32_t i = 0; i < numTextures; ++i)
 	{
-		const SortedImage& image = sortedImage[textureIndex];
-		pRtrn = head->insert(sortedImage[textureIndex].width + totalBorder, sortedImage[textureIndex].height + totalBorder);
-		if (!pRtrn)
-		{
-			head->deleteArea();
-			delete head;
-			throw InvalidDataError("ERROR: Not enough room in texture atlas!");
-		}
-		dstOffset[0].x = static_cast<uint16_t>(pRtrn->x + atlasPixelBorder);
-		dstOffset[0].y = static_cast<uint16_t>(pRtrn->y + atlasPixelBorder);
-		dstOffset[0].z = 0;
-
-		dstOffset[1].x = static_cast<uint16_t>(dstOffset[0].x + sortedImage[textureIndex].width);
-		dstOffset[1].y = static_cast<uint16_t>(dstOffset[0].y + sortedImage[textureIndex].height);
-		dstOffset[1].z = 1;
-
-		outUVs[image.id].x = dstOffset[0].x * oneOverWidth;
-		outUVs[image.id].y = dstOffset[0].y * oneOverHeight;
-		outUVs[image.id].width = sortedImage[textureIndex].width * oneOverWidth;
-		outUVs[image.id].height = sortedImage[textureIndex].height * oneOverHeight;
-
-		gl::TexSubImage2D(GL_TEXTURE_2D, 0, static_cast<GLint>(dstOffset[0].x), static_cast<GLint>(dstOffset[0].y), static_cast<GLsizei>(sortedImage[textureIndex].width),
-			static_cast<GLsizei>(sortedImage[textureIndex].height), glFormat, glType, image.texture.getDataPointer());
+		const AtlasRect& rect = rects[i];
+		outUVs[i].x = rect.x * oneOverWidth;
+		outUVs[i].y = rect.y * oneOverHeight;
+		outUVs[i].width = rect.width * oneOverWidth;
+		outUVs[i].height = rect.height * oneOverHeight;
+
+		gl::TexSubImage2D(GL_TEXTURE_2D, 0, static_cast<GLint>(rect.x), static_cast<GLint>(rect.y), static_cast<GLsizei>(rect.width), static_cast<GLsizei>(rect.height), glFormat,
+			glType, textures[i].getDataPointer());
 	}
 	if (outDescriptor)
 	{
@@ -591,9 +428,6 @@ inline void generateTextureAtlas(
 		gl::FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0x00000000);
 	}
 #endif
-	head->deleteArea();
-	delete head;
-
 	pvr::utils::throwOnGlError("generateTextureAtlas End");
 }
 
@@ -195,36 +195,37 @@ void Font_::loadFontData(const Texture& texture)
 	_dim.x = texHeader.getWidth();
 	_dim.y = texHeader.getHeight();
 
-	const Header* header = reinterpret_cast<const Header*>(texture.getMetaDataMap()->at(TextureHeader::PVRv3).at(FontHeader).getData());
+	const TextureMetaData* headerMetaData = texture.findMetaData(TextureHeader::PVRv3, FontHeader);
+	if (!headerMetaData) { throw InvalidDataError("Font: The texture does not contain font data"); }
+	const Header* header = reinterpret_cast<const Header*>(headerMetaData->getData());
 
 	_header = *header;
 	_header.numCharacters = _header.numCharacters & 0xFFFF;
 	_header.numKerningPairs = _header.numKerningPairs & 0xFFFF;
 
-	const std::map<uint32_t, TextureMetaData>& metaDataMap = texture.getMetaDataMap()->at(TextureHeader::PVRv3);
-	std::map<uint32_t, TextureMetaData>::const_iterator found;
+	const TextureMetaData* found;
 
 	if (_header.numCharacters)
 	{
 		_characters.resize(_header.numCharacters);
-		found = metaDataMap.find(FontCharList);
+		found = texture.findMetaData(TextureHeader::PVRv3, FontCharList);
 
-		if (found != metaDataMap.end()) { memcpy(&_characters[0], found->second.getData(), found->second.getDataSize()); }
+		if (found) { memcpy(&_characters[0], found->getData(), found->getDataSize()); }
 
 		_yOffsets.resize(_header.numCharacters);
-		found = metaDataMap.find(FontYoffset);
+		found = texture.findMetaData(TextureHeader::PVRv3, FontYoffset);
 
-		if (found != metaDataMap.end()) { memcpy(&_yOffsets[0], found->second.getData(), found->second.getDataSize()); }
+		if (found) { memcpy(&_yOffsets[0], found->getData(), found->getDataSize()); }
 
 		_charMetrics.resize(_header.numCharacters);
-		found = metaDataMap.find(FontMetrics);
+		found = texture.findMetaData(TextureHeader::PVRv3, FontMetrics);
 
-		if (found != metaDataMap.end()) { memcpy(&_charMetrics[0], found->second.getData(), found->second.getDataSize()); }
+		if (found) { memcpy(&_charMetrics[0], found->getData(), found->getDataSize()); }
 
 		_rects.resize(_header.numCharacters);
-		found = metaDataMap.find(FontRects);
+		found = texture.findMetaData(TextureHeader::PVRv3, FontRects);
 
-		if (found != metaDataMap.end()) { memcpy(&_rects[0], found->second.getData(), found->second.getDataSize()); }
+		if (found) { memcpy(&_rects[0], found->getData(), found->getDataSize()); }
 
 		// Build UVs
 		_characterUVs.resize(_header.numCharacters);
@@ -239,10 +240,10 @@ void Font_::loadFontData(const Texture& texture)
 
 	if (_header.numKerningPairs)
 	{
-		found = metaDataMap.find(FontKerning);
+		found = texture.findMetaData(TextureHeader::PVRv3, FontKerning);
 		_kerningPairs.resize(_header.numKerningPairs);
 
-		if (found != metaDataMap.end()) { memcpy(&_kerningPairs[0], found->second.getData(), found->second.getDataSize()); }
+		if (found) { memcpy(&_kerningPairs[0], found->getData(), found->getDataSize()); }
 	}
 }
 
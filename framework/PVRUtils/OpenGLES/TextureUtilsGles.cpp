@@ -9,18 +9,66 @@
 #include "PVRUtils/OpenGLES/TextureUtilsGles.h"
 #include "PVRCore/texture/Texture.h"
 #include "PVRCore/texture/PVRTDecompress.h"
+#include "PVRCore/texture/ASTCDecompress.h"
+#include "PVRCore/texture/BCDecompress.h"
+#include "PVRCore/texture/PixelFormatTranscoder.h"
 #include "PVRUtils/OpenGLES/ErrorsGles.h"
 #include "PVRUtils/OpenGLES/ConvertToGlesTypes.h"
 #include <algorithm>
 
 namespace pvr {
 namespace utils {
+namespace {
+// Uploads the software decompressed version of a BC texture.
+TextureUploadResults textureUploadDecompressedBc(const Texture& texture, bool isEs2)
+{
+	Log(LogLevel::Information, "BC texture format support not detected. Decompressing %s in software", to_string(texture.getPixelFormat()).c_str());
+	TextureUploadResults retval = textureUpload(decompressBcTexture(texture), isEs2, false);
+	retval.isDecompressed = true;
+	return retval;
+}
+
+// Finds the RGBA format that holds every value of an uncompressed texture exactly (see getLosslessRgbaFormat), to convert formats that OpenGL ES, or
+// this implementation of it, does not support. Returns false if there is no such format, or if it has no OpenGL ES equivalent either.
+bool getLosslessGlesRgbaFormat(const Texture& texture, PixelFormat& outFormat, VariableType& outChannelType)
+{
+	if (texture.getPixelFormat().isCompressedFormat() || !isTranscodingSupported(texture.getPixelFormat(), texture.getChannelType())) { return false; }
+	if (!getLosslessRgbaFormat(texture.getPixelFormat(), texture.getChannelType(), texture.getColorSpace(), outFormat, outChannelType)) { return false; }
+	try
+	{
+		GLenum glInternalFormat, glFormat, glType, glTypeSize;
+		bool isCompressed;
+		utils::getOpenGLFormat(outFormat, texture.getColorSpace(), outChannelType, glInternalFormat, glFormat, glType, glTypeSize, isCompressed);
+	}
+	catch (const InvalidOperationError&)
+	{
+		return false;
+	}
+	return true;
+}
+
+// Uploads a copy of an uncompressed texture converted to another format (see getLosslessGlesRgbaFormat).
+TextureUploadResults textureUploadTranscoded(const Texture& texture, const PixelFormat& format, VariableType channelType, bool isEs2)
+{
+	Log(LogLevel::Information, "Texture format %s support not detected. Converting it to %s in software", to_string(texture.getPixelFormat()).c_str(), to_string(format).c_str());
+	TextureUploadResults retval = textureUpload(transcodeTexture(texture, format, channelType, texture.getColorSpace()), isEs2, false);
+	retval.isDecompressed = true;
+	return retval;
+}
+} // namespace
+
 TextureUploadResults textureUpload(const Texture& texture, bool isEs2, bool allowDecompress)
 {
 	TextureUploadResults retval;
 	// Check that the texture is valid.
 	if (!texture.getDataSize()) { throw InvalidDataError("[textureUpload]: Invalid texture supplied, please verify inputs.\n"); }
 
+	// BC4 to BC7 have no OpenGL ES format at all, so they can only be used decompressed.
+	if (allowDecompress && texture.getPixelFormat().getPart().High == 0 &&
+		texture.getPixelFormat().getPixelTypeId() >= static_cast<uint64_t>(CompressedPixelFormat::BC4) &&
+		texture.getPixelFormat().getPixelTypeId() <= static_cast<uint64_t>(CompressedPixelFormat::BC7))
+	{ return textureUploadDecompressedBc(texture, isEs2); }
+
 	std::string extensionString;
 
 	// Initial error checks
@@ -36,7 +84,24 @@ TextureUploadResults textureUpload(const Texture& texture, bool isEs2, bool allo
 
 	// Check that the format is a valid format for this API - Doesn't check specifically between OpenGL/ES,
 	// it simply gets the values that would be set for a KTX file.
-	utils::getOpenGLFormat(texture.getPixelFormat(), texture.getColorSpace(), texture.getChannelType(), glInternalFormat, glFormat, glType, glTypeSize, unused);
+	try
+	{
+		utils::getOpenGLFormat(texture.getPixelFormat(), texture.getColorSpace(), texture.getChannelType(), glInternalFormat, glFormat, glType, glTypeSize, unused);
+	}
+	catch (const InvalidOperationError&)
+	{
+		// Uncompressed formats without an OpenGL ES equivalent (e.g. b8g8r8) can still be used as an RGBA format that holds every value exactly.
+		// Formats that would lose precision (e.g. a2b10g10r10 as RGBA8) are rejected, as on Vulkan.
+		PixelFormat expandedFormat;
+		VariableType expandedChannelType;
+		if (getLosslessGlesRgbaFormat(texture, expandedFormat, expandedChannelType)) { return textureUploadTranscoded(texture, expandedFormat, expandedChannelType, isEs2); }
+		if (!texture.getPixelFormat().isCompressedFormat() && isTranscodingSupported(texture.getPixelFormat(), texture.getChannelType()))
+		{
+			Log(LogLevel::Error, "Texture format %s (%s) is not supported by OpenGL ES, and cannot be converted to a supported format without changing its values",
+				to_string(texture.getPixelFormat()).c_str(), to_string(texture.getChannelType()).c_str());
+		}
+		throw;
+	}
 
 	// Is the texture compressed? RGB9E5 is treated as an uncompressed texture in OpenGL/ES so is a special case.
 	bool isCompressedFormat =
@@ -268,7 +333,31 @@ TextureUploadResults textureUpload(const Texture& texture, bool isEs2, bool allo
 		case GL_ETC1_RGB8_OES:
 		{
 			if (!gl::isGlExtensionSupported("GL_OES_compressed_ETC1_RGB8_texture"))
-			{ throw GlExtensionNotSupportedError("GL_OES_compressed_ETC1_RGB8_texture", "[textureUplodad] Format was unsupported in this implementation."); }
+			{
+				if (allowDecompress)
+				{
+					// No longer compressed if this is the case.
+					isCompressedFormat = false;
+
+					// Decompress every surface to RGBA8888.
+					cDecompressedTexture = decompressEtcTexture(*textureToUse);
+
+					// Update the texture format.
+					utils::getOpenGLFormat(cDecompressedTexture.getPixelFormat(), cDecompressedTexture.getColorSpace(), cDecompressedTexture.getChannelType(), glInternalFormat,
+						glFormat, glType, glTypeSize, unused);
+
+					// Make sure the function knows to use a decompressed texture instead.
+					textureToUse = &cDecompressedTexture;
+
+					retval.isDecompressed = true;
+				}
+				else
+				{
+					throw GlExtensionNotSupportedError("GL_OES_compressed_ETC1_RGB8_texture",
+						"[textureUplodad] Format was unsupported in this implementation."
+						"Allowing software decompression (allowDecompress=true) will enable you to use this format.");
+				}
+			}
 			break;
 		}
 #endif
@@ -278,19 +367,34 @@ TextureUploadResults textureUpload(const Texture& texture, bool isEs2, bool allo
 		case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
 		{
 			if (!gl::isGlExtensionSupported("GL_EXT_texture_compression_dxt1"))
-			{ throw GlExtensionNotSupportedError("GL_EXT_texture_compression_dxt1", "[textureUplodad] Format was unsupported in this implementation."); }
+			{
+				if (allowDecompress) { return textureUploadDecompressedBc(texture, isEs2); }
+				throw GlExtensionNotSupportedError("GL_EXT_texture_compression_dxt1",
+					"[textureUplodad] Format was unsupported in this implementation."
+					"Allowing software decompression (allowDecompress=true) will enable you to use this format.");
+			}
 			break;
 		}
 		case GL_COMPRESSED_RGBA_S3TC_DXT3_ANGLE:
 		{
 			if (!gl::isGlExtensionSupported("GL_ANGLE_texture_compression_dxt3"))
-			{ throw GlExtensionNotSupportedError("GL_ANGLE_texture_compression_dxt3", "[textureUplodad] Format was unsupported in this implementation."); }
+			{
+				if (allowDecompress) { return textureUploadDecompressedBc(texture, isEs2); }
+				throw GlExtensionNotSupportedError("GL_ANGLE_texture_compression_dxt3",
+					"[textureUplodad] Format was unsupported in this implementation."
+					"Allowing software decompression (allowDecompress=true) will enable you to use this format.");
+			}
 			break;
 		}
 		case GL_COMPRESSED_RGBA_S3TC_DXT5_ANGLE:
 		{
 			if (!gl::isGlExtensionSupported("GL_ANGLE_texture_compression_dxt5"))
-			{ throw GlExtensionNotSupportedError("GL_ANGLE_texture_compression_dxt5", "[textureUplodad] Format was unsupported in this implementation."); }
+			{
+				if (allowDecompress) { return textureUploadDecompressedBc(texture, isEs2); }
+				throw GlExtensionNotSupportedError("GL_ANGLE_texture_compression_dxt5",
+					"[textureUplodad] Format was unsupported in this implementation."
+					"Allowing software decompression (allowDecompress=true) will enable you to use this format.");
+			}
 			break;
 		}
 #endif
@@ -308,8 +412,11 @@ TextureUploadResults textureUpload(const Texture& texture, bool isEs2, bool allo
 				}
 				else
 				{
-					throw GlExtensionNotSupportedError(
-						"GL_EXT_texture_format_BGRA8888 or GL_APPLE_texture_format_BGRA8888", "[textureUplodad] Format was unsupported in this implementation.");
+					// Swizzling in software is cheap, and leaves the driver nothing to convert.
+					PixelFormat expandedFormat;
+					VariableType expandedChannelType;
+					if (getLosslessGlesRgbaFormat(texture, expandedFormat, expandedChannelType)) { return textureUploadTranscoded(texture, expandedFormat, expandedChannelType, isEs2); }
+					throw GlExtensionNotSupportedError("GL_EXT_texture_format_BGRA8888", "[textureUplodad] Format was unsupported in this implementation.");
 				}
 			}
 			break;
@@ -333,8 +440,29 @@ TextureUploadResults textureUpload(const Texture& texture, bool isEs2, bool allo
 			{
 				if (!gl::isGlExtensionSupported("GL_KHR_texture_compression_astc_hdr") && !gl::isGlExtensionSupported("GL_KHR_texture_compression_astc_ldr"))
 				{
-					throw GlExtensionNotSupportedError(
-						"GL_KHR_texture_compression_astc_hdr/GL_KHR_texture_compression_astc_ldr", "[textureUplodad] Format was unsupported in this implementation.");
+					if (allowDecompress)
+					{
+						// No longer compressed if this is the case.
+						isCompressedFormat = false;
+
+						// Decompress every surface to RGBA8888. The colour space is kept, so sRGB data is uploaded as sRGB RGBA8888.
+						cDecompressedTexture = decompressAstcTexture(*textureToUse);
+
+						// Update the texture format.
+						utils::getOpenGLFormat(cDecompressedTexture.getPixelFormat(), cDecompressedTexture.getColorSpace(), cDecompressedTexture.getChannelType(), glInternalFormat,
+							glFormat, glType, glTypeSize, unused);
+
+						// Make sure the function knows to use a decompressed texture instead.
+						textureToUse = &cDecompressedTexture;
+
+						retval.isDecompressed = true;
+					}
+					else
+					{
+						throw GlExtensionNotSupportedError("GL_KHR_texture_compression_astc_hdr/GL_KHR_texture_compression_astc_ldr",
+							"[textureUplodad] Format was unsupported in this implementation."
+							"Allowing software decompression (allowDecompress=true) will enable you to use this format.");
+					}
 				}
 			}
 #endif
@@ -54,11 +54,12 @@ private:
 /// context is ES2 only then the texture upload should not use ES3+ functionality as it will be unsupported via this context.</param>
 /// <param name="allowDecompress">Set to true to allow to attempt to de-compress unsupported compressed textures.
 /// The textures will be decompressed if ALL of the following are true: The texture is in a compressed format that
-/// can be decompressed by the framework (PVRTC), the platform does NOT support this format (if it is hardware
+/// can be decompressed by the framework (PVRTC, ETC1, ASTC, BC1 to BC7), the platform does NOT support this format (if it is hardware
 /// supported, it will never be decompressed), and this flag is set to true. Default:true.</param>
 /// <returns>A TextureUploadResults object containing the uploaded texture and all necessary information (size, formats,
 /// whether it was actually decompressed. The "result" field will contain Result::Success
 /// on success, errorcode otherwise. See the Texture</returns>
 TextureUploadResults textureUpload(const Texture& texture, bool isEs2, bool allowDecompress);
+
 } // namespace utils
 } // namespace pvr
@@ -14,4 +14,5 @@
 #include "PVRUtils/OpenGLES/ErrorsGles.h"
 #include "PVRUtils/OpenGLES/ConvertToGlesTypes.h"
 #include "PVRUtils/OpenGLES/TextureUtilsGles.h"
+#include "PVRUtils/OpenGLES/FrameCaptureGles.h"
 #include "PVRAssets/Helper.h"
@@ -44,11 +44,14 @@ public:
 	/// <summary>A pvr::Texture to asynchronously upload to the Gpu.</summary>
 	AsyncTexture _texture;
 
-	/// <summary>A command pool from which comand buffers will be allocated to record image upload operations.</summary>
-	pvrvk::CommandPool _cmdPool;
+	/// <summary>The command pools from which comand buffers will be allocated to record image upload operations. A pool is taken out of the
+	/// queue for the duration of the upload, so that no two uploads record into the same pool at the same time. Shared with the uploader, and kept
+	/// alive by the uploads that are still queued when it is destroyed.</summary>
+	std::shared_ptr<moodycamel::BlockingConcurrentQueue<pvrvk::CommandPool>> _cmdPools;
 
-	/// <summary>A semaphore used to guard access to submitting to the CommandQueue.
-	async::Mutex* _cmdQueueMutex;
+	/// <summary>A semaphore used to guard access to submitting to the CommandQueue. Null if the queue needs no guarding. Does not own a mutex that
+	/// was passed to ImageApiAsyncUploader::init.</summary>
+	std::shared_ptr<async::Mutex> _cmdQueueMutex;
 
 	/// <summary>Specifies whether the uploaded texture can be decompressed as it is uploaded.</summary>
 	bool _allowDecompress;
@@ -86,12 +89,35 @@ public:
 	const pvrvk::ImageView& getResult() { return _result; }
 
 private:
+	// Keeps a command pool out of the shared queue of pools for as long as the command buffer allocated from it exists.
+	struct CommandPoolLease
+	{
+		moodycamel::BlockingConcurrentQueue<pvrvk::CommandPool>& pools;
+		pvrvk::CommandPool pool;
+		pvrvk::CommandBuffer cmdBuffer;
+
+		explicit CommandPoolLease(moodycamel::BlockingConcurrentQueue<pvrvk::CommandPool>& poolQueue) : pools(poolQueue)
+		{
+			pools.wait_dequeue(pool);
+			cmdBuffer = pool->allocateCommandBuffer();
+		}
+		~CommandPoolLease()
+		{
+			cmdBuffer.reset();
+			pools.enqueue(std::move(pool));
+		}
+	};
+
 	pvrvk::ImageView customUploadImage()
 	{
-		Texture& assetTexture = *_texture->get();
-		pvrvk::CommandBuffer cmdBuffer = _cmdPool->allocateCommandBuffer();
+		TexturePtr texture = _texture->get();
+		// The texture failed to load, or its load was cancelled.
+		if (!_texture->isSuccessful()) { return pvrvk::ImageView(); }
+
+		CommandPoolLease lease(*_cmdPools);
+		pvrvk::CommandBuffer& cmdBuffer = lease.cmdBuffer;
 		cmdBuffer->begin();
-		pvrvk::ImageView results = uploadImageAndView(_device, assetTexture, _allowDecompress, cmdBuffer);
+		pvrvk::ImageView results = uploadImageAndView(_device, *texture, _allowDecompress, cmdBuffer);
 		cmdBuffer->end();
 
 		pvrvk::SubmitInfo submitInfo;
@@ -135,6 +161,7 @@ private:
 		}
 		return false;
 	}
+	void cancel_() { _resultSemaphore->signal(); }
 	void cleanup_() {}
 	void destroyObject() {}
 };
@@ -148,19 +175,24 @@ typedef std::shared_ptr<ImageUploadFuture_> ImageUploadFuture;
 /// <param name="uploadFuture">An image upload future to be uploaded on a separate thread.</param>
 inline void imageUploadAsyncWorker(ImageUploadFuture uploadFuture) { uploadFuture->loadNow(); }
 
-/// <summary>This class wraps a worker thread that uploads texture to the GPU asynchronously and returns
+/// <summary>This class wraps one or more worker threads that upload texture to the GPU asynchronously and returns
 /// futures to them. This class would normally be used with Texture Futures as well, in order to do both
 /// of the operations asynchronously.</summary>
 class ImageApiAsyncUploader : public async::AsyncScheduler<pvrvk::ImageView, ImageUploadFuture, imageUploadAsyncWorker>
 {
 private:
+	// Everything an upload uses is held by its future too, as the uploads still queued are finished after the members of this class are destroyed.
 	pvrvk::Device _device;
 	pvrvk::Queue _queueVk;
-	pvrvk::CommandPool _cmdPool;
-	async::Mutex* _cmdQueueMutex;
+	std::shared_ptr<moodycamel::BlockingConcurrentQueue<pvrvk::CommandPool>> _cmdPools;
+	std::shared_ptr<async::Mutex> _cmdQueueMutex;
+	std::shared_ptr<async::Mutex> _internalQueueMutex;
 
 public:
-	ImageApiAsyncUploader() : _cmdQueueMutex(nullptr) { _myInfo = "ImageApiAsyncUploader"; }
+	/// <summary>Constructor. Spawns the worker threads.</summary>
+	/// <param name="numWorkers">The number of textures that can be uploaded at the same time, each on its own worker thread.</param>
+	explicit ImageApiAsyncUploader(uint32_t numWorkers = 1) : AsyncScheduler(numWorkers, "ImageApiAsyncUploader"), _internalQueueMutex(std::make_shared<async::Mutex>()) {}
+
 	/// <summary>The type of the optional callback that is called at the end of the operation</summary>
 	typedef async::IFrameworkAsyncResult<pvrvk::ImageView>::Callback CallbackType;
 
@@ -174,13 +206,24 @@ public:
 	/// <param name="queueSemaphore">Use the Semaphore as a mutex: Initial count 1, call wait() before
 	/// all accesses to the Vulkan queue, then signal() when finished accessing. If the queue does
 	/// not need external synchronization (i.e. it is only used by this object), leave the
-	/// queueSemaphore at its default value of NULL</param>
+	/// queueSemaphore at its default value of NULL: if there is more than one worker, an internal
+	/// mutex is then used to serialise the submissions of the workers. An external mutex must outlive the uploads queued after this call, which
+	/// are finished even if the uploader is destroyed first.</param>
 	void init(pvrvk::Device& device, pvrvk::Queue& queue, async::Mutex* queueSemaphore = nullptr)
 	{
 		_device = device;
 		_queueVk = queue;
-		_cmdPool = device->createCommandPool(pvrvk::CommandPoolCreateInfo(queue->getFamilyIndex(), pvrvk::CommandPoolCreateFlags::e_RESET_COMMAND_BUFFER_BIT));
-		_cmdQueueMutex = queueSemaphore;
+		// One command pool per worker, as command pools must not be used by several threads at the same time. Uploads queued before this call keep
+		// the previous pools.
+		_cmdPools = std::make_shared<moodycamel::BlockingConcurrentQueue<pvrvk::CommandPool>>();
+		for (uint32_t i = 0; i < getNumWorkers(); ++i)
+		{ _cmdPools->enqueue(device->createCommandPool(pvrvk::CommandPoolCreateInfo(queue->getFamilyIndex(), pvrvk::CommandPoolCreateFlags::e_RESET_COMMAND_BUFFER_BIT))); }
+		// An external mutex is not owned, so it is wrapped in a shared_ptr that shares no ownership.
+		if (queueSemaphore != nullptr) { _cmdQueueMutex = std::shared_ptr<async::Mutex>(std::shared_ptr<async::Mutex>(), queueSemaphore); }
+		else
+		{
+			_cmdQueueMutex = getNumWorkers() > 1 ? _internalQueueMutex : nullptr;
+		}
 	}
 
 	/// <summary>Begin a texture uploading task and return the future to the Vulkan Texture. Use the returned
@@ -196,8 +239,10 @@ public:
 	/// of the Result future (the Texture future) is signalled as complete. Defaults to false, so as to avoid the deadlock that
 	/// will happen if the user attempts to call "get" on the future while the signal will happen just after return of the callback.
 	/// Set to "true" if you want to do something WITHOUT calling "get" on the future, but before the texture is  used.</param>
+	/// <param name="priority">The priority of the upload. Uploads of higher priority are started first.</param>
 	/// <returns> A texture upload Future which you can use to query or get the uploaded texture</returns>
-	AsyncApiTexture uploadTextureAsync(const AsyncTexture& texture, bool allowDecompress = true, CallbackType callback = nullptr, bool callbackBeforeSignal = false)
+	AsyncApiTexture uploadTextureAsync(
+		const AsyncTexture& texture, bool allowDecompress = true, CallbackType callback = nullptr, bool callbackBeforeSignal = false, async::TaskPriority priority = async::TaskPriority::Normal)
 	{
 		assertion(_queueVk != nullptr, "Queue has not been initialized");
 		auto future = std::make_shared<ImageUploadFuture_>();
@@ -207,14 +252,11 @@ public:
 		params._device = _device;
 		params._texture = texture;
 		params._resultSemaphore = std::make_shared<async::Semaphore>();
-		params._cmdPool = _cmdPool;
+		params._cmdPools = _cmdPools;
 		params.setCallBack(callback);
 		params._callbackBeforeSignal = callbackBeforeSignal;
 		params._cmdQueueMutex = _cmdQueueMutex;
-		_queueSemaphore.wait();
-		_queue.emplace_back(future);
-		_queueSemaphore.signal();
-		_workSemaphore.signal();
+		enqueue(future, priority);
 		return future;
 	}
 };
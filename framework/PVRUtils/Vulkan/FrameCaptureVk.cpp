@@ -0,0 +1,169 @@
+/*!
+\brief Implementation of the non-stalling swapchain capture.
+\file PVRUtils/Vulkan/FrameCaptureVk.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+#include "PVRUtils/Vulkan/FrameCaptureVk.h"
+#include "PVRCore/strings/StringFunctions.h"
+#include "PVRVk/CommandPoolVk.h"
+#include "PVRVk/MemoryBarrierVk.h"
+#include "PVRVk/QueueVk.h"
+#include "PVRVk/SwapchainVk.h"
+#include <cstring>
+
+namespace pvr {
+namespace utils {
+FrameCapture::FrameCapture(pvrvk::Device& device, pvrvk::Swapchain& swapchain, pvrvk::CommandPool& commandPool, vma::Allocator bufferAllocator, vma::Allocator imageAllocator,
+	CaptureFileFormat fileFormat, uint32_t screenshotScale, uint32_t maxQueuedImages)
+	: _extent(swapchain->getDimension()), _fileFormat(fileFormat), _screenshotScale(screenshotScale), _writer(maxQueuedImages)
+{
+	if (!swapchain->supportsUsage(pvrvk::ImageUsageFlags::e_TRANSFER_SRC_BIT))
+	{ throw pvrvk::ErrorValidationFailedEXT("FrameCapture: The swapchain must support TRANSFER_SRC_BIT to be captured"); }
+
+	// Swapchain images are converted to BGRA 8888 by a blit, which also flips them to the bottom-up order of the screenshots.
+	const bool isSrgb = pvrvk::isSrgb(swapchain->getImageFormat());
+	const pvrvk::Format format = isSrgb ? pvrvk::Format::e_B8G8R8A8_SRGB : pvrvk::Format::e_B8G8R8A8_UNORM;
+	_colorSpace = isSrgb ? ColorSpace::sRGB : ColorSpace::lRGB;
+	if ((device->getPhysicalDevice()->getFormatProperties(format).getOptimalTilingFeatures() & pvrvk::FormatFeatureFlags::e_BLIT_DST_BIT) == 0)
+	{ throw pvrvk::ErrorValidationFailedEXT("Screen Capture requested Image format is not supported"); }
+
+	const uint32_t width = _extent.getWidth(), height = _extent.getHeight();
+	const uint32_t bufferSize = width * height * 4;
+	const uint32_t queueFamilyId = commandPool->getQueueFamilyIndex();
+	const pvrvk::Offset3D srcOffsets[2] = { pvrvk::Offset3D(0, 0, 0), pvrvk::Offset3D(static_cast<int32_t>(width), static_cast<int32_t>(height), 1) };
+	const pvrvk::Offset3D dstOffsets[2] = { pvrvk::Offset3D(0, static_cast<int32_t>(height), 0), pvrvk::Offset3D(static_cast<int32_t>(width), 0, 1) };
+	const pvrvk::ImageSubresourceRange colorRange(pvrvk::ImageAspectFlags::e_COLOR_BIT);
+
+	_slots.resize(swapchain->getSwapchainLength());
+	for (uint32_t i = 0; i < _slots.size(); ++i)
+	{
+		Slot& slot = _slots[i];
+		pvrvk::Image& swapchainImage = swapchain->getImage(i);
+		slot.image = createImage(device,
+			pvrvk::ImageCreateInfo(pvrvk::ImageType::e_2D, format, pvrvk::Extent3D(width, height, 1u), pvrvk::ImageUsageFlags::e_TRANSFER_DST_BIT | pvrvk::ImageUsageFlags::e_TRANSFER_SRC_BIT),
+			pvrvk::MemoryPropertyFlags::e_DEVICE_LOCAL_BIT, pvrvk::MemoryPropertyFlags::e_DEVICE_LOCAL_BIT, imageAllocator);
+		slot.buffer = createBuffer(device, pvrvk::BufferCreateInfo(bufferSize, pvrvk::BufferUsageFlags::e_TRANSFER_DST_BIT), pvrvk::MemoryPropertyFlags::e_HOST_VISIBLE_BIT,
+			pvrvk::MemoryPropertyFlags::e_HOST_VISIBLE_BIT | pvrvk::MemoryPropertyFlags::e_HOST_CACHED_BIT, bufferAllocator, vma::AllocationCreateFlags::e_MAPPED_BIT);
+		slot.buffer->setObjectName("PVRUtilsVk::FrameCapture::Readback Buffer");
+		if (!slot.buffer->getDeviceMemory()->isMapped()) { slot.buffer->getDeviceMemory()->map(0, bufferSize); }
+		slot.fence = device->createFence(pvrvk::FenceCreateFlags(0));
+		slot.semaphore = device->createSemaphore();
+
+		// The copy of each swapchain image never changes, so it is recorded once. The semaphore wait of the submission happens at the transfer stage,
+		// which the first barrier chains to.
+		slot.commandBuffer = commandPool->allocateCommandBuffer();
+		pvrvk::CommandBuffer& cmdBuffer = slot.commandBuffer;
+		cmdBuffer->begin();
+		pvr::utils::beginCommandBufferDebugLabel(cmdBuffer, pvrvk::DebugUtilsLabel("PVRUtilsVk::FrameCapture"));
+
+		pvrvk::MemoryBarrierSet barriers;
+		barriers.addBarrier(pvrvk::ImageMemoryBarrier(pvrvk::AccessFlags::e_NONE, pvrvk::AccessFlags::e_TRANSFER_READ_BIT, swapchainImage, colorRange,
+			pvrvk::ImageLayout::e_PRESENT_SRC_KHR, pvrvk::ImageLayout::e_TRANSFER_SRC_OPTIMAL, queueFamilyId, queueFamilyId));
+		barriers.addBarrier(pvrvk::ImageMemoryBarrier(pvrvk::AccessFlags::e_NONE, pvrvk::AccessFlags::e_TRANSFER_WRITE_BIT, slot.image, colorRange,
+			pvrvk::ImageLayout::e_UNDEFINED, pvrvk::ImageLayout::e_TRANSFER_DST_OPTIMAL, queueFamilyId, queueFamilyId));
+		cmdBuffer->pipelineBarrier(pvrvk::PipelineStageFlags::e_TRANSFER_BIT, pvrvk::PipelineStageFlags::e_TRANSFER_BIT, barriers);
+
+		pvrvk::ImageBlit blit(pvrvk::ImageSubresourceLayers(), srcOffsets, pvrvk::ImageSubresourceLayers(), dstOffsets);
+		cmdBuffer->blitImage(swapchainImage, slot.image, &blit, 1, pvrvk::Filter::e_NEAREST, pvrvk::ImageLayout::e_TRANSFER_SRC_OPTIMAL, pvrvk::ImageLayout::e_TRANSFER_DST_OPTIMAL);
+
+		barriers.clearAllBarriers();
+		barriers.addBarrier(pvrvk::ImageMemoryBarrier(pvrvk::AccessFlags::e_TRANSFER_READ_BIT, pvrvk::AccessFlags::e_NONE, swapchainImage, colorRange,
+			pvrvk::ImageLayout::e_TRANSFER_SRC_OPTIMAL, pvrvk::ImageLayout::e_PRESENT_SRC_KHR, queueFamilyId, queueFamilyId));
+		barriers.addBarrier(pvrvk::ImageMemoryBarrier(pvrvk::AccessFlags::e_TRANSFER_WRITE_BIT, pvrvk::AccessFlags::e_TRANSFER_READ_BIT, slot.image, colorRange,
+			pvrvk::ImageLayout::e_TRANSFER_DST_OPTIMAL, pvrvk::ImageLayout::e_TRANSFER_SRC_OPTIMAL, queueFamilyId, queueFamilyId));
+		cmdBuffer->pipelineBarrier(pvrvk::PipelineStageFlags::e_TRANSFER_BIT, pvrvk::PipelineStageFlags::e_TRANSFER_BIT, barriers);
+
+		pvrvk::ImageSubresourceLayers subResource;
+		subResource.setAspectMask(pvrvk::ImageAspectFlags::e_COLOR_BIT);
+		pvrvk::BufferImageCopy region(0, 0, 0, subResource, pvrvk::Offset3D(0, 0, 0), pvrvk::Extent3D(width, height, 1u));
+		cmdBuffer->copyImageToBuffer(slot.image, pvrvk::ImageLayout::e_TRANSFER_SRC_OPTIMAL, slot.buffer, &region, 1);
+
+		barriers.clearAllBarriers();
+		barriers.addBarrier(pvrvk::BufferMemoryBarrier(pvrvk::AccessFlags::e_TRANSFER_WRITE_BIT, pvrvk::AccessFlags::e_HOST_READ_BIT, slot.buffer, 0, bufferSize));
+		cmdBuffer->pipelineBarrier(pvrvk::PipelineStageFlags::e_TRANSFER_BIT, pvrvk::PipelineStageFlags::e_HOST_BIT, barriers);
+
+		pvr::utils::endCommandBufferDebugLabel(cmdBuffer);
+		cmdBuffer->end();
+	}
+}
+
+FrameCapture::~FrameCapture() { flush(); }
+
+const pvrvk::Semaphore& FrameCapture::capture(pvrvk::Queue& queue, uint32_t swapIndex, const std::string& filename, const pvrvk::Semaphore& renderCompleteSemaphore)
+{
+	if (swapIndex >= _slots.size()) { throw InvalidArgumentError("swapIndex", "FrameCapture: Swapchain index out of range"); }
+	poll();
+
+	// The previous capture of this swapchain image is normally complete by the time the image has been presented and acquired again. If not, wait
+	// for it, along with the older ones, so that the files are still written in order.
+	Slot& slot = _slots[swapIndex];
+	if (!slot.filename.empty())
+	{
+		while (!_inFlight.empty())
+		{
+			const uint32_t oldest = _inFlight.front();
+			_slots[oldest].fence->wait();
+			collect(oldest);
+			if (oldest == swapIndex) { break; }
+		}
+	}
+
+	std::string name, extension;
+	strings::getFileNameAndExtension(filename, name, extension);
+	slot.filename = name + getCaptureFileExtension(_fileFormat);
+	slot.fence->reset();
+
+	const pvrvk::PipelineStageFlags waitStage = pvrvk::PipelineStageFlags::e_TRANSFER_BIT;
+	pvrvk::SubmitInfo submitInfo;
+	submitInfo.commandBuffers = &slot.commandBuffer;
+	submitInfo.numCommandBuffers = 1;
+	submitInfo.waitSemaphores = &renderCompleteSemaphore;
+	submitInfo.numWaitSemaphores = 1;
+	submitInfo.waitDstStageMask = &waitStage;
+	submitInfo.signalSemaphores = &slot.semaphore;
+	submitInfo.numSignalSemaphores = 1;
+	queue->submit(&submitInfo, 1, slot.fence);
+	_inFlight.push_back(swapIndex);
+	return slot.semaphore;
+}
+
+void FrameCapture::poll()
+{
+	// Captures complete in submission order, so stop at the first one still in flight.
+	while (!_inFlight.empty() && _slots[_inFlight.front()].fence->isSignalled()) { collect(_inFlight.front()); }
+}
+
+void FrameCapture::flush()
+{
+	while (!_inFlight.empty())
+	{
+		_slots[_inFlight.front()].fence->wait();
+		collect(_inFlight.front());
+	}
+	_writer.flush();
+}
+
+void FrameCapture::collect(uint32_t slotIndex)
+{
+	Slot& slot = _slots[slotIndex];
+	_inFlight.pop_front();
+
+	CapturedImage image;
+	image.filename = std::move(slot.filename);
+	slot.filename.clear();
+	image.width = _extent.getWidth();
+	image.height = _extent.getHeight();
+	image.colorSpace = _colorSpace;
+	image.pixelReplicate = _screenshotScale;
+	image.pixels.resize(static_cast<size_t>(image.width) * image.height * 4);
+
+	pvrvk::DeviceMemory& memory = slot.buffer->getDeviceMemory();
+	if (static_cast<uint32_t>(memory->getMemoryFlags() & pvrvk::MemoryPropertyFlags::e_HOST_COHERENT_BIT) == 0) { memory->invalidateRange(0, image.pixels.size()); }
+	memcpy(image.pixels.data(), memory->getMappedData(), image.pixels.size());
+	_writer.write(std::move(image), _fileFormat);
+}
+} // namespace utils
+} // namespace pvr
+//!\endcond
@@ -0,0 +1,94 @@
+/*!
+\brief Contains a class capturing swapchain images to files without stalling the render thread.
+\file PVRUtils/Vulkan/FrameCaptureVk.h
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+#pragma once
+#include "PVRCore/textureio/AsyncImageWriter.h"
+#include "PVRUtils/Vulkan/HelperVk.h"
+#include <deque>
+
+namespace pvr {
+namespace utils {
+
+/// <summary>Captures swapchain images to files without stalling the render thread, as an alternative to takeScreenshot for capturing ranges of frames
+/// (see Shell::shouldTakeScreenshot). Each swapchain image has its own readback buffer and pre-recorded copy command buffer. A capture is submitted
+/// after the frame, and the present waits for it through a semaphore instead of the CPU waiting for the queue to idle. Completed captures are collected
+/// later by polling their fences, and their pixels are encoded and written to disk by a background AsyncImageWriter. The render thread only waits
+/// if it captures a swapchain image whose previous capture has not completed yet, or if the writer falls behind.
+///
+/// Typical use, where renderCompleteSemaphore is the semaphore signalled by the submission of the frame:
+/// <code>
+/// pvrvk::Semaphore presentWaitSemaphore = renderCompleteSemaphore;
+/// if (shouldTakeScreenshot()) { presentWaitSemaphore = frameCapture.capture(queue, swapchainIndex, getScreenshotFileName(), renderCompleteSemaphore); }
+/// presentInfo.waitSemaphores = &presentWaitSemaphore;
+/// </code></summary>
+class FrameCapture
+{
+public:
+	/// <summary>Constructor. Allocates the readback resources of every swapchain image.</summary>
+	/// <param name="device">The device the swapchain was created on</param>
+	/// <param name="swapchain">The swapchain to capture. It must have been created with pvrvk::ImageUsageFlags::e_TRANSFER_SRC_BIT, otherwise throws
+	/// pvrvk::ErrorValidationFailedEXT.</param>
+	/// <param name="commandPool">A command pool to allocate the copy command buffers from. It must be compatible with the queue passed to capture.</param>
+	/// <param name="bufferAllocator">A VMA allocator used to allocate memory for the readback buffers.</param>
+	/// <param name="imageAllocator">A VMA allocator used to allocate memory for the images converting the swapchain format to BGRA 8888.</param>
+	/// <param name="fileFormat">The format of the saved files. The extension of the file names passed to capture is replaced by the one of this format.</param>
+	/// <param name="screenshotScale">A scaling factor to use for increasing the size of the saved screenshots.</param>
+	/// <param name="maxQueuedImages">The maximum number of images read back but not written yet, before capture blocks.</param>
+	FrameCapture(pvrvk::Device& device, pvrvk::Swapchain& swapchain, pvrvk::CommandPool& commandPool, vma::Allocator bufferAllocator = nullptr,
+		vma::Allocator imageAllocator = nullptr, CaptureFileFormat fileFormat = CaptureFileFormat::TGA, uint32_t screenshotScale = 1, uint32_t maxQueuedImages = 8);
+
+	/// <summary>Destructor. Waits for the pending captures and writes them.</summary>
+	~FrameCapture();
+
+	/// <summary>Captures a swapchain image. Call it after submitting the command buffers rendering the image, and make the present wait for the returned
+	/// semaphore instead of renderCompleteSemaphore. Also collects the captures which have completed since the previous call.</summary>
+	/// <param name="queue">The queue to submit the copy to. Must be the queue the image is presented on.</param>
+	/// <param name="swapIndex">The index of the swapchain image to capture</param>
+	/// <param name="filename">The name of the file to save the image to</param>
+	/// <param name="renderCompleteSemaphore">The semaphore signalled when the image has been rendered</param>
+	/// <returns>The semaphore signalled when the copy is complete, which the present must wait for</returns>
+	const pvrvk::Semaphore& capture(pvrvk::Queue& queue, uint32_t swapIndex, const std::string& filename, const pvrvk::Semaphore& renderCompleteSemaphore);
+
+	/// <summary>Collects the captures which have completed, without waiting, and queues them to be written.</summary>
+	void poll();
+
+	/// <summary>Waits for every pending capture to complete and to be written to disk.</summary>
+	void flush();
+
+	/// <summary>Get the number of captures submitted but not collected yet.</summary>
+	/// <returns>The number of captures in flight on the GPU</returns>
+	uint32_t getNumInFlight() const { return static_cast<uint32_t>(_inFlight.size()); }
+
+	/// <summary>Get the background writer, e.g. to query the number of images written or failed.</summary>
+	/// <returns>The image writer</returns>
+	const AsyncImageWriter& getWriter() const { return _writer; }
+
+private:
+	struct Slot
+	{
+		pvrvk::Image image;
+		pvrvk::Buffer buffer;
+		pvrvk::CommandBuffer commandBuffer;
+		pvrvk::Fence fence;
+		pvrvk::Semaphore semaphore;
+		std::string filename;
+	};
+
+	void collect(uint32_t slotIndex);
+
+	std::vector<Slot> _slots;
+	std::deque<uint32_t> _inFlight; // The slots submitted and not collected yet, in submission order
+	pvrvk::Extent2D _extent;
+	ColorSpace _colorSpace;
+	CaptureFileFormat _fileFormat;
+	uint32_t _screenshotScale;
+	AsyncImageWriter _writer;
+
+	FrameCapture(const FrameCapture&) = delete;
+	FrameCapture& operator=(const FrameCapture&) = delete;
+};
+} // namespace utils
+} // namespace pvr
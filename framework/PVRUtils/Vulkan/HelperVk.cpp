@@ -8,7 +8,12 @@
 //!\cond NO_DOXYGEN
 #include "HelperVk.h"
 #include "PVRCore/texture/PVRTDecompress.h"
+#include "PVRCore/texture/ASTCDecompress.h"
+#include "PVRCore/texture/BCDecompress.h"
+#include "PVRCore/texture/PixelFormatTranscoder.h"
+#include "PVRCore/texture/TextureAtlasPacker.h"
 #include "PVRCore/textureio/TGAWriter.h"
+#include "PVRCore/textureio/AsyncImageWriter.h"
 #include "PVRVk/ImageVk.h"
 #include "PVRVk/CommandPoolVk.h"
 #include "PVRVk/QueueVk.h"
@@ -718,6 +723,78 @@ const Texture* decompressIfRequired(
 				throw TextureDecompressionError(cszUnsupportedFormatDecompressionAvailable, "PVRTC");
 			}
 		}
+		if (texture.getPixelFormat().getPixelTypeId() == uint64_t(CompressedPixelFormat::ETC1) ||
+			(texture.getPixelFormat().getPixelTypeId() >= uint64_t(CompressedPixelFormat::ETC2_RGB) &&
+				texture.getPixelFormat().getPixelTypeId() <= uint64_t(CompressedPixelFormat::EAC_RG11)))
+		{
+			if (allowDecompress)
+			{
+				Log(LogLevel::Information, "ETC2/EAC texture format support not detected. Decompressing %s to RGBA8888", to_string(texture.getPixelFormat()).c_str());
+				decompressedTexture = decompressEtcTexture(texture);
+				isDecompressed = true;
+				outFormat = convertToPVRVkPixelFormat(decompressedTexture.getPixelFormat(), decompressedTexture.getColorSpace(), decompressedTexture.getChannelType(), isDecompressed);
+				return &decompressedTexture;
+			}
+			else
+			{
+				throw TextureDecompressionError(cszUnsupportedFormatDecompressionAvailable, to_string(texture.getPixelFormat()));
+			}
+		}
+		uint32_t astcBlockWidth, astcBlockHeight;
+		if (texture.getDepth() == 1 &&
+			getASTCBlockFootprint(static_cast<CompressedPixelFormat>(texture.getPixelFormat().getPixelTypeId()), astcBlockWidth, astcBlockHeight))
+		{
+			if (allowDecompress)
+			{
+				Log(LogLevel::Information, "ASTC texture format support not detected. Decompressing %s to RGBA8888", to_string(texture.getPixelFormat()).c_str());
+				decompressedTexture = decompressAstcTexture(texture);
+				isDecompressed = true;
+				outFormat = convertToPVRVkPixelFormat(decompressedTexture.getPixelFormat(), decompressedTexture.getColorSpace(), decompressedTexture.getChannelType(), isDecompressed);
+				return &decompressedTexture;
+			}
+			else
+			{
+				throw TextureDecompressionError(cszUnsupportedFormatDecompressionAvailable, to_string(texture.getPixelFormat()));
+			}
+		}
+		if (isBCFormat(static_cast<CompressedPixelFormat>(texture.getPixelFormat().getPixelTypeId())))
+		{
+			if (allowDecompress)
+			{
+				Log(LogLevel::Information, "BC texture format support not detected. Decompressing %s to RGBA8888 (RGBA16F for BC6)", to_string(texture.getPixelFormat()).c_str());
+				decompressedTexture = decompressBcTexture(texture);
+				isDecompressed = true;
+				outFormat = convertToPVRVkPixelFormat(decompressedTexture.getPixelFormat(), decompressedTexture.getColorSpace(), decompressedTexture.getChannelType(), isDecompressed);
+				return &decompressedTexture;
+			}
+			else
+			{
+				throw TextureDecompressionError(cszUnsupportedFormatDecompressionAvailable, to_string(texture.getPixelFormat()));
+			}
+		}
+		// Uncompressed formats the device cannot sample (typically 24 bit RGB) are expanded to an RGBA format that holds every value of the original one
+		// exactly (see getLosslessRgbaFormat), so that the conversion does not need allowDecompress. Formats without such an equivalent, or whose
+		// equivalent the device does not support either, are rejected.
+		if (isTranscodingSupported(texture.getPixelFormat(), texture.getChannelType()) && texture.getNumPlanes() == 1)
+		{
+			PixelFormat expandedFormat;
+			VariableType expandedChannelType;
+			if (getLosslessRgbaFormat(texture.getPixelFormat(), texture.getChannelType(), texture.getColorSpace(), expandedFormat, expandedChannelType))
+			{
+				const pvrvk::Format candidateFormat = convertToPVRVkPixelFormat(expandedFormat, texture.getColorSpace(), expandedChannelType);
+				if (candidateFormat != pvrvk::Format::e_UNDEFINED && isSupportedFormat(pdev, candidateFormat))
+				{
+					Log(LogLevel::Information, "Texture format %s support not detected. Converting it to %s", to_string(texture.getPixelFormat()).c_str(),
+						to_string(expandedFormat).c_str());
+					decompressedTexture = transcodeTexture(texture, expandedFormat, expandedChannelType, texture.getColorSpace());
+					isDecompressed = true;
+					outFormat = convertToPVRVkPixelFormat(decompressedTexture.getPixelFormat(), decompressedTexture.getColorSpace(), decompressedTexture.getChannelType(), isDecompressed);
+					return &decompressedTexture;
+				}
+			}
+			Log(LogLevel::Error, "Texture format %s (%s) is not supported by the device, and cannot be converted to a supported format without changing its values",
+				to_string(texture.getPixelFormat()).c_str(), to_string(texture.getChannelType()).c_str());
+		}
 		throw TextureDecompressionError(cszUnsupportedFormat, to_string(texture.getPixelFormat()));
 	}
 }
@@ -952,13 +1029,11 @@ inline pvrvk::ImageView loadAndUploadImageAndViewHelper(pvrvk::Device& device, c
 	IAssetProvider& assetProvider, pvrvk::ImageUsageFlags usageFlags, pvrvk::ImageLayout finalLayout, Texture* outAssetTexture = nullptr, vma::Allocator imageAllocator = nullptr,
 	vma::Allocator bufferAllocator = nullptr, vma::AllocationCreateFlags imageAllocationCreateFlags = vma::AllocationCreateFlags::e_NONE, const void* pNext = nullptr)
 {
-	Texture outTexture;
-	Texture* pOutTexture = &outTexture;
-	if (outAssetTexture) { pOutTexture = outAssetTexture; }
-	auto assetStream = assetProvider.getAssetStream(fileName);
-	*pOutTexture = pvr::textureLoad(*assetStream, pvr::getTextureFormatFromFilename(fileName));
+	// Loaded through the cache of the asset provider if the application enabled it, so that textures used several times are only read and decoded once.
+	std::shared_ptr<const Texture> cachedTexture;
+	const Texture& texture = pvr::textureLoadForUpload(assetProvider, fileName, outAssetTexture, cachedTexture);
 	pvrvk::ImageView imageView =
-		uploadImageAndViewHelper(device, *pOutTexture, allowDecompress, commandBuffer, usageFlags, finalLayout, bufferAllocator, imageAllocator, imageAllocationCreateFlags, pNext);
+		uploadImageAndViewHelper(device, texture, allowDecompress, commandBuffer, usageFlags, finalLayout, bufferAllocator, imageAllocator, imageAllocationCreateFlags, pNext);
 	imageView->setObjectName(fileName);
 	return imageView;
 }
@@ -967,13 +1042,10 @@ inline pvrvk::Image loadAndUploadImageHelper(pvrvk::Device& device, const char*
 	pvrvk::ImageUsageFlags usageFlags, pvrvk::ImageLayout finalLayout, Texture* outAssetTexture = nullptr, vma::Allocator stagingBufferAllocator = nullptr,
 	vma::Allocator imageAllocator = nullptr, vma::AllocationCreateFlags imageAllocationCreateFlags = vma::AllocationCreateFlags::e_NONE)
 {
-	Texture outTexture;
-	Texture* pOutTexture = &outTexture;
-	if (outAssetTexture) { pOutTexture = outAssetTexture; }
-	auto assetStream = assetProvider.getAssetStream(fileName);
-	*pOutTexture = pvr::textureLoad(*assetStream, pvr::getTextureFormatFromFilename(fileName));
+	std::shared_ptr<const Texture> cachedTexture;
+	const Texture& texture = pvr::textureLoadForUpload(assetProvider, fileName, outAssetTexture, cachedTexture);
 	pvrvk::Image image =
-		uploadImageHelper(device, *pOutTexture, allowDecompress, commandBuffer, usageFlags, finalLayout, stagingBufferAllocator, imageAllocator, imageAllocationCreateFlags);
+		uploadImageHelper(device, texture, allowDecompress, commandBuffer, usageFlags, finalLayout, stagingBufferAllocator, imageAllocator, imageAllocationCreateFlags);
 	image->setObjectName(fileName);
 	return image;
 }
@@ -1042,184 +1114,24 @@ void generateTextureAtlas(pvrvk::Device& device, const pvrvk::Image* inputImages
 	pvrvk::ImageView* outImageView, TextureHeader* outDescriptor, pvrvk::CommandBufferBase cmdBuffer, pvrvk::ImageLayout finalLayout, vma::Allocator imageAllocator,
 	vma::AllocationCreateFlags imageAllocationCreateFlags)
 {
-	TextureHeader header;
-	struct SortedImage
-	{
-		uint32_t id;
-		pvrvk::Image image;
-		uint16_t width;
-		uint16_t height;
-		uint16_t srcX;
-		uint16_t srcY;
-		bool hasAlpha;
-	};
-	std::vector<SortedImage> sortedImage(numImages);
-	struct SortCompare
-	{
-		bool operator()(const SortedImage& a, const SortedImage& b)
-		{
-			uint32_t aSize = a.width * a.height;
-			uint32_t bSize = b.width * b.height;
-			return (aSize > bSize);
-		}
-	};
-
-	struct Area
-	{
-		int32_t x;
-		int32_t y;
-		int32_t w;
-		int32_t h;
-		int32_t size;
-		bool isFilled;
-
-		Area* right;
-		Area* left;
-
-	private:
-		void setSize(int32_t width, int32_t height)
-		{
-			w = width;
-			h = height;
-			size = width * height;
-		}
-
-	public:
-		Area(int32_t width, int32_t height) : x(0), y(0), isFilled(false), right(NULL), left(NULL) { setSize(width, height); }
-
-		Area() : x(0), y(0), isFilled(false), right(NULL), left(NULL) { setSize(0, 0); }
-
-		Area* insert(int32_t width, int32_t height)
-		{
-			// If this area has branches below it (i.e. is not a leaf) then traverse those.
-			// Check the left branch first.
-			if (left)
-			{
-				Area* tempPtr = NULL;
-				tempPtr = left->insert(width, height);
-				if (tempPtr != NULL) { return tempPtr; }
-			}
-			// Now check right
-			if (right) { return right->insert(width, height); }
-			// Already filled!
-			if (isFilled) { return NULL; }
-
-			// Too small
-			if (size < width * height || w < width || h < height) { return NULL; }
-
-			// Just right!
-			if (size == width * height && w == width && h == height)
-			{
-				isFilled = true;
-				return this;
-			}
-			// Too big. Split up.
-			if (size > width * height && w >= width && h >= height)
-			{
-				// Initializes the children, and sets the left child's coordinates as these don't change.
-				left = new Area;
-				right = new Area;
-				left->x = x;
-				left->y = y;
-
-				// --- Splits the current area depending on the size and position of the placed texture.
-				// Splits vertically if larger free distance across the texture.
-				if ((w - width) > (h - height))
-				{
-					left->w = width;
-					left->h = h;
-
-					right->x = x + width;
-					right->y = y;
-					right->w = w - width;
-					right->h = h;
-				}
-				// Splits horizontally if larger or equal free distance downwards.
-				else
-				{
-					left->w = w;
-					left->h = height;
-
-					right->x = x;
-					right->y = y + height;
-					right->w = w;
-					right->h = h - height;
-				}
-
-				// Initializes the child members' size attributes.
-				left->size = left->h * left->w;
-				right->size = right->h * right->w;
-
-				// Inserts the texture into the left child member.
-				return left->insert(width, height);
-			}
-			// Catch all error return.
-			return NULL;
-		}
-
-		bool deleteArea()
-		{
-			if (left != NULL)
-			{
-				if (left->left != NULL)
-				{
-					if (!left->deleteArea()) { return false; }
-					if (!right->deleteArea()) { return false; }
-				}
-			}
-			if (right != NULL)
-			{
-				if (right->left != NULL)
-				{
-					if (!left->deleteArea()) { return false; }
-					if (!right->deleteArea()) { return false; }
-				}
-			}
-			delete right;
-			right = NULL;
-			delete left;
-			left = NULL;
-			return true;
-		}
-	};
-
-	// load the textures
-	for (uint32_t i = 0; i < numImages; ++i)
-	{
-		sortedImage[i].image = inputImages[i];
-		sortedImage[i].id = i;
-		sortedImage[i].width = static_cast<uint16_t>(inputImages[i]->getWidth());
-		sortedImage[i].height = static_cast<uint16_t>(inputImages[i]->getHeight());
-	}
-	//// sort the sprites
-	std::sort(sortedImage.begin(), sortedImage.end(), SortCompare());
-	// find the best width and height
-	int32_t width = 0, height = 0, area = 0;
-	uint32_t preferredDim[] = { 8, 16, 32, 64, 128, 256, 512, 1024 };
+	// Pack the images, keeping a one pixel border around each of them so that filtering does not bleed between neighbours. Blits cannot rotate images.
 	const uint32_t atlasPixelBorder = 1;
-	const uint32_t totalBorder = atlasPixelBorder * 2;
-	uint32_t sortedImagesIterator = 0;
-	// calculate the total area
-	for (; sortedImagesIterator < sortedImage.size(); ++sortedImagesIterator)
-	{
-		area += (sortedImage[sortedImagesIterator].width + totalBorder) * (sortedImage[sortedImagesIterator].height + totalBorder);
-	}
-	sortedImagesIterator = 0;
-	while ((static_cast<int32_t>(preferredDim[sortedImagesIterator]) * static_cast<int32_t>(preferredDim[sortedImagesIterator])) < area &&
-		sortedImagesIterator < sizeof(preferredDim) / sizeof(preferredDim[0]))
+	std::vector<uint32_t> widths(numImages), heights(numImages);
+	for (uint32_t i = 0; i < numImages; ++i)
 	{
-		++sortedImagesIterator;
+		widths[i] = inputImages[i]->getWidth();
+		heights[i] = inputImages[i]->getHeight();
 	}
-	if (sortedImagesIterator >= sizeof(preferredDim) / sizeof(preferredDim[0])) { throw pvrvk::ErrorValidationFailedEXT("Cannot find a best size for the texture atlas"); }
+	std::vector<AtlasRect> rects(numImages);
+	uint32_t width = 0, height = 0;
+	if (!packTextureAtlas(widths.data(), heights.data(), numImages, device->getPhysicalDevice()->getProperties().getLimits().getMaxImageDimension2D(),
+			AtlasPackerOptions(AtlasPackingHeuristic::BestShortSideFit, atlasPixelBorder), width, height, rects.data()))
+	{ throw pvrvk::ErrorValidationFailedEXT("Cannot find a best size for the texture atlas"); }
 
 	pvr::utils::beginCommandBufferDebugLabel(cmdBuffer, pvrvk::DebugUtilsLabel("PVRUtilsVk::generateTextureAtlas"));
 
-	width = height = preferredDim[sortedImagesIterator];
-	float oneOverWidth = 1.f / width;
-	float oneOverHeight = 1.f / height;
-	Area* head = new Area(width, height);
-	Area* pRtrn = nullptr;
-	pvrvk::Offset3D dstOffsets[2];
+	const float oneOverWidth = 1.f / width;
+	const float oneOverHeight = 1.f / height;
 
 	// create the out texture store
 	pvrvk::Format outFmt = pvrvk::Format::e_R8G8B8A8_UNORM;
@@ -1232,34 +1144,19 @@ void generateTextureAtlas(pvrvk::Device& device, const pvrvk::Image* inputImages
 	pvrvk::ImageView view = device->createImageView(pvrvk::ImageViewCreateInfo(outTexStore));
 	cmdBuffer->clearColorImage(view, pvrvk::ClearColorValue(0.0f, 0.f, 0.f, 0.f), pvrvk::ImageLayout::e_TRANSFER_DST_OPTIMAL);
 
+	// The whole layout is known at this point, so the blits are recorded back to back.
 	for (uint32_t i = 0; i < numImages; ++i)
 	{
-		const SortedImage& image = sortedImage[i];
-		pRtrn = head->insert(static_cast<int32_t>(sortedImage[i].width) + totalBorder, static_cast<int32_t>(sortedImage[i].height) + totalBorder);
-		if (!pRtrn)
-		{
-			head->deleteArea();
-			delete head;
-			throw pvrvk::ErrorUnknown("Cannot find a best size for the texture atlas");
-		}
-		dstOffsets[0].setX(static_cast<uint16_t>(pRtrn->x + atlasPixelBorder));
-		dstOffsets[0].setY(static_cast<uint16_t>(pRtrn->y + atlasPixelBorder));
-		dstOffsets[0].setZ(0);
-
-		dstOffsets[1].setX(static_cast<uint16_t>(dstOffsets[0].getX() + sortedImage[i].width));
-		dstOffsets[1].setY(static_cast<uint16_t>(dstOffsets[0].getY() + sortedImage[i].height));
-		dstOffsets[1].setZ(1);
+		const AtlasRect& rect = rects[i];
+		outUVs[i].setOffset(pvrvk::Offset2Df(rect.x * oneOverWidth, rect.y * oneOverHeight));
+		outUVs[i].setExtent(pvrvk::Extent2Df(rect.width * oneOverWidth, rect.height * oneOverHeight));
 
-		pvrvk::Offset2Df offset(dstOffsets[0].getX() * oneOverWidth, dstOffsets[0].getY() * oneOverHeight);
-		pvrvk::Extent2Df extent(sortedImage[i].width * oneOverWidth, sortedImage[i].height * oneOverHeight);
-
-		outUVs[image.id].setOffset(offset);
-		outUVs[image.id].setExtent(extent);
-
-		pvrvk::Offset3D srcOffsets[2] = { pvrvk::Offset3D(0, 0, 0), pvrvk::Offset3D(image.width, image.height, 1) };
+		const int32_t x = static_cast<int32_t>(rect.x), y = static_cast<int32_t>(rect.y), w = static_cast<int32_t>(rect.width), h = static_cast<int32_t>(rect.height);
+		pvrvk::Offset3D srcOffsets[2] = { pvrvk::Offset3D(0, 0, 0), pvrvk::Offset3D(w, h, 1) };
+		pvrvk::Offset3D dstOffsets[2] = { pvrvk::Offset3D(x, y, 0), pvrvk::Offset3D(x + w, y + h, 1) };
 		pvrvk::ImageBlit blit(pvrvk::ImageSubresourceLayers(), srcOffsets, pvrvk::ImageSubresourceLayers(), dstOffsets);
 
-		cmdBuffer->blitImage(sortedImage[i].image, outTexStore, &blit, 1, pvrvk::Filter::e_NEAREST, inputImageLayout, pvrvk::ImageLayout::e_TRANSFER_DST_OPTIMAL);
+		cmdBuffer->blitImage(inputImages[i], outTexStore, &blit, 1, pvrvk::Filter::e_NEAREST, inputImageLayout, pvrvk::ImageLayout::e_TRANSFER_DST_OPTIMAL);
 	}
 	if (outDescriptor)
 	{
@@ -1280,9 +1177,6 @@ void generateTextureAtlas(pvrvk::Device& device, const pvrvk::Image* inputImages
 
 	cmdBuffer->pipelineBarrier(pvrvk::PipelineStageFlags::e_TRANSFER_BIT, pvrvk::PipelineStageFlags::e_FRAGMENT_SHADER_BIT | pvrvk::PipelineStageFlags::e_COMPUTE_SHADER_BIT, barrier);
 
-	head->deleteArea();
-	delete head;
-
 	pvr::utils::endCommandBufferDebugLabel(cmdBuffer);
 }
 
@@ -1809,8 +1703,15 @@ void saveImage(pvrvk::Queue& queue, pvrvk::CommandPool& cmdPool, pvrvk::Image& i
 	std::vector<unsigned char> imageData = captureImageRegion(queue, cmdPool, image, pvrvk::Offset3D(0, 0, 0),
 		pvrvk::Extent3D(image->getExtent().getWidth(), image->getExtent().getHeight(), image->getExtent().getDepth()), destinationImageFormat, imageInitialLayout, imageFinalLayout,
 		bufferAllocator, imageAllocator);
-	Log(LogLevel::Information, "Writing TGA screenshot, filename %s.", filename.c_str());
-	writeTGA(filename.c_str(), image->getExtent().getWidth(), image->getExtent().getHeight(), imageData.data(), 4, screenshotScale);
+	// Encoding and writing the file is left to the screenshot writer, if one is set, so that capturing a range of frames does not wait for the disk.
+	CapturedImage capturedImage;
+	capturedImage.filename = filename;
+	capturedImage.width = image->getExtent().getWidth();
+	capturedImage.height = image->getExtent().getHeight();
+	capturedImage.pixels = std::move(imageData);
+	capturedImage.colorSpace = pvrvk::isSrgb(image->getFormat()) ? ColorSpace::sRGB : ColorSpace::lRGB;
+	capturedImage.pixelReplicate = screenshotScale;
+	writeScreenshot(std::move(capturedImage), CaptureFileFormat::TGA);
 }
 
 #pragma endregion
@@ -1706,7 +1706,8 @@ std::vector<unsigned char> captureImageRegion(pvrvk::Queue& queue, pvrvk::Comman
 	pvrvk::ImageLayout imageFinalLayout = pvrvk::ImageLayout::e_TRANSFER_DST_OPTIMAL, vma::Allocator bufferAllocator = nullptr, vma::Allocator imageAllocator = nullptr);
 
 /// <summary>Saves the input image as a TGA file with the filename specified. Note that the image must have been created with the
-/// pvrvk::ImageUsageFlags::e_TRANSFER_SRC_BIT set.</summary>
+/// pvrvk::ImageUsageFlags::e_TRANSFER_SRC_BIT set. The image is read back before returning. The file is written in the background by the screenshot
+/// writer if one is set (see setScreenshotWriter), otherwise before returning.</summary>
 /// <param name="queue">A queue to submit the generated command buffer to. This queue must be compatible with the command pool provided.</param>
 /// <param name="commandPool">A command pool from which to allocate a temporary command buffer to carry out the transfer operations.</param>
 /// <param name="image">The image to save as a TGA file.</param>
@@ -1719,7 +1720,9 @@ std::vector<unsigned char> captureImageRegion(pvrvk::Queue& queue, pvrvk::Comman
 void saveImage(pvrvk::Queue& queue, pvrvk::CommandPool& commandPool, pvrvk::Image& image, const pvrvk::ImageLayout imageInitialLayout, const pvrvk::ImageLayout imageFinalLayout,
 	const std::string& filename, vma::Allocator bufferAllocator = nullptr, vma::Allocator imageAllocator = nullptr, const uint32_t screenshotScale = 1);
 
-/// <summary>Saves a particular swapchain image corresponding to the swapchain image at index swapIndex for the swapchain.</summary>
+/// <summary>Saves a particular swapchain image corresponding to the swapchain image at index swapIndex for the swapchain. The queue is idled and the image
+/// read back before returning, as the present is not synchronised with the copy; the file is written in the background by the screenshot writer if
+/// one is set (see setScreenshotWriter). FrameCapture avoids the wait for the queue as well, and is preferable to capture ranges of frames.</summary>
 /// <param name="queue">A queue to submit the generated command buffer to. This queue must be compatible with the command pool provided.</param>
 /// <param name="commandPool">A command pool from which to allocate a temporary command buffer to carry out the transfer operations.</param>
 /// <param name="swapchain">The swapchain from which a particular image will be saved.</param>
@@ -174,37 +174,38 @@ void Font_::loadFontData(const Texture& texture)
 	_dim.x = texHeader.getWidth();
 	_dim.y = texHeader.getHeight();
 
-	const Header* header = reinterpret_cast<const Header*>(texture.getMetaDataMap()->at(TextureHeader::PVRv3).at(static_cast<uint32_t>(FontHeader)).getData());
+	const TextureMetaData* headerMetaData = texture.findMetaData(TextureHeader::PVRv3, static_cast<uint32_t>(FontHeader));
+	if (!headerMetaData) { throw InvalidDataError("Font: The texture does not contain font data"); }
+	const Header* header = reinterpret_cast<const Header*>(headerMetaData->getData());
 	assertion(header != NULL);
 
 	_header = *header;
 	_header.numCharacters = _header.numCharacters & 0xFFFF;
 	_header.numKerningPairs = _header.numKerningPairs & 0xFFFF;
 
-	const std::map<uint32_t, TextureMetaData>& metaDataMap = texture.getMetaDataMap()->at(TextureHeader::PVRv3);
-	std::map<uint32_t, TextureMetaData>::const_iterator found;
+	const TextureMetaData* found;
 
 	if (_header.numCharacters)
 	{
 		_characters.resize(_header.numCharacters);
-		found = metaDataMap.find(static_cast<uint32_t>(FontCharList));
+		found = texture.findMetaData(TextureHeader::PVRv3, static_cast<uint32_t>(FontCharList));
 
-		if (found != metaDataMap.end()) { memcpy(&_characters[0], found->second.getData(), found->second.getDataSize()); }
+		if (found) { memcpy(&_characters[0], found->getData(), found->getDataSize()); }
 
 		_yOffsets.resize(_header.numCharacters);
-		found = metaDataMap.find(static_cast<uint32_t>(FontYoffset));
+		found = texture.findMetaData(TextureHeader::PVRv3, static_cast<uint32_t>(FontYoffset));
 
-		if (found != metaDataMap.end()) { memcpy(&_yOffsets[0], found->second.getData(), found->second.getDataSize()); }
+		if (found) { memcpy(&_yOffsets[0], found->getData(), found->getDataSize()); }
 
 		_charMetrics.resize(_header.numCharacters);
-		found = metaDataMap.find(static_cast<uint32_t>(FontMetrics));
+		found = texture.findMetaData(TextureHeader::PVRv3, static_cast<uint32_t>(FontMetrics));
 
-		if (found != metaDataMap.end()) { memcpy(&_charMetrics[0], found->second.getData(), found->second.getDataSize()); }
+		if (found) { memcpy(&_charMetrics[0], found->getData(), found->getDataSize()); }
 
 		_rects.resize(_header.numCharacters);
-		found = metaDataMap.find(static_cast<uint32_t>(FontRects));
+		found = texture.findMetaData(TextureHeader::PVRv3, static_cast<uint32_t>(FontRects));
 
-		if (found != metaDataMap.end()) { memcpy(&_rects[0], found->second.getData(), found->second.getDataSize()); }
+		if (found) { memcpy(&_rects[0], found->getData(), found->getDataSize()); }
 
 		// Build UVs
 		_characterUVs.resize(_header.numCharacters);
@@ -219,10 +220,10 @@ void Font_::loadFontData(const Texture& texture)
 
 	if (_header.numKerningPairs)
 	{
-		found = metaDataMap.find(static_cast<uint32_t>(FontKerning));
+		found = texture.findMetaData(TextureHeader::PVRv3, static_cast<uint32_t>(FontKerning));
 		_kerningPairs.resize(_header.numKerningPairs);
 
-		if (found != metaDataMap.end()) { memcpy(&_kerningPairs[0], found->second.getData(), found->second.getDataSize()); }
+		if (found) { memcpy(&_kerningPairs[0], found->getData(), found->getDataSize()); }
 	}
 }
 
@@ -0,0 +1,241 @@
+/*!
+\brief Implementation of the texture mip level streamer.
+\file PVRUtils/Vulkan/TextureStreamerVk.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+#include "PVRUtils/Vulkan/TextureStreamerVk.h"
+#include "PVRVk/CommandPoolVk.h"
+#include "PVRVk/MemoryBarrierVk.h"
+#include "PVRVk/QueueVk.h"
+#include <algorithm>
+#include <cstring>
+
+namespace pvr {
+namespace utils {
+namespace {
+inline VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment) { return (value + alignment - 1) / alignment * alignment; }
+
+pvrvk::Extent3D getLevelExtent(const Texture& texture, uint32_t mipLevel)
+{
+	return pvrvk::Extent3D(texture.getWidth(mipLevel), texture.getHeight(mipLevel), texture.getDepth(mipLevel));
+}
+
+pvrvk::ImageCreateInfo getImageCreateInfo(const Texture& texture, pvrvk::Format format, uint32_t firstMipLevel)
+{
+	const uint32_t numLayers = texture.getNumArrayMembers() * texture.getNumFaces();
+	const pvrvk::ImageType imageType = texture.getDepth() > 1 ? pvrvk::ImageType::e_3D : texture.getHeight() > 1 ? pvrvk::ImageType::e_2D : pvrvk::ImageType::e_1D;
+	const pvrvk::ImageCreateFlags flags = texture.getNumFaces() > 1 ? pvrvk::ImageCreateFlags::e_CUBE_COMPATIBLE_BIT : pvrvk::ImageCreateFlags::e_NONE;
+	return pvrvk::ImageCreateInfo(imageType, format, getLevelExtent(texture, firstMipLevel),
+		pvrvk::ImageUsageFlags::e_SAMPLED_BIT | pvrvk::ImageUsageFlags::e_TRANSFER_DST_BIT | pvrvk::ImageUsageFlags::e_TRANSFER_SRC_BIT, texture.getNumMipMapLevels() - firstMipLevel,
+		numLayers, pvrvk::SampleCountFlags::e_1_BIT, flags);
+}
+} // namespace
+
+TextureStreamer::TextureStreamer(
+	pvrvk::Device& device, pvrvk::CommandPool& commandPool, uint64_t budget, uint32_t numFramesInFlight, vma::Allocator bufferAllocator, vma::Allocator imageAllocator)
+	: _device(device), _commandPool(commandPool), _bufferAllocator(bufferAllocator), _imageAllocator(imageAllocator), _numFramesInFlight(numFramesInFlight), _updateIndex(0),
+	  _residency(budget)
+{}
+
+TextureStreamer::~TextureStreamer() { releaseRetiredResources(true); }
+
+uint32_t TextureStreamer::addTexture(Texture texture, uint32_t numAlwaysResidentLevels)
+{
+	if (!texture.getDataSize()) { throw pvrvk::ErrorValidationFailedEXT("TextureStreamer: Invalid texture supplied, please verify inputs."); }
+	if (texture.getNumPlanes() > 1) { throw pvrvk::ErrorValidationFailedEXT("TextureStreamer: Multi-planar textures cannot be streamed."); }
+	const pvrvk::Format format = convertToPVRVkPixelFormat(texture.getPixelFormat(), texture.getColorSpace(), texture.getChannelType());
+	if (format == pvrvk::Format::e_UNDEFINED ||
+		(_device->getPhysicalDevice()->getFormatProperties(format).getOptimalTilingFeatures() & pvrvk::FormatFeatureFlags::e_SAMPLED_IMAGE_BIT) == 0)
+	{ throw pvrvk::ErrorValidationFailedEXT("TextureStreamer: Texture format is not supported for sampling by this device."); }
+
+	const uint32_t textureId = _residency.addTexture(texture, numAlwaysResidentLevels);
+	_textures.resize(textureId + 1);
+	_textures[textureId].texture = std::move(texture);
+	_textures[textureId].format = format;
+	return textureId;
+}
+
+void TextureStreamer::removeTexture(uint32_t textureId)
+{
+	_residency.removeTexture(textureId);
+	StreamedTexture& streamed = _textures[textureId];
+	if (streamed.view)
+	{
+		RetiredResources retired;
+		retired.updateIndex = _updateIndex;
+		retired.views.push_back(std::move(streamed.view));
+		_retired.push_back(std::move(retired));
+	}
+	streamed.view.reset();
+	streamed.texture = Texture();
+}
+
+void TextureStreamer::releaseRetiredResources(bool waitForAll)
+{
+	while (!_retired.empty())
+	{
+		RetiredResources& retired = _retired.front();
+		if (waitForAll)
+		{
+			if (retired.fence) { retired.fence->wait(); }
+		}
+		else if (retired.updateIndex + _numFramesInFlight > _updateIndex || (retired.fence && !retired.fence->isSignalled()))
+		{
+			break;
+		}
+		_retired.pop_front();
+	}
+}
+
+const std::vector<uint32_t>& TextureStreamer::update(pvrvk::Queue& queue, uint64_t maxUploadBytes)
+{
+	++_updateIndex;
+	releaseRetiredResources(false);
+	_changedTextures.clear();
+
+	const std::vector<TextureResidencyChange> changes = _residency.update(maxUploadBytes);
+	if (changes.empty()) { return _changedTextures; }
+
+	// Pack the new levels into a single staging buffer. Each level holds all the array members and faces of the texture, in the order of the Vulkan array
+	// layers, and starts at an offset aligned to both 4 bytes and the size of a texel block, as copies require.
+	std::vector<VkDeviceSize> stagingOffsets(changes.size());
+	std::vector<VkDeviceSize> stagingAlignments(changes.size(), 1);
+	VkDeviceSize stagingSize = 0;
+	for (size_t i = 0; i < changes.size(); ++i)
+	{
+		if (!changes[i].isLoad()) { continue; }
+		const Texture& texture = _textures[changes[i].textureId].texture;
+		uint32_t blockWidth, blockHeight, blockDepth;
+		texture.getMinDimensionsForFormat(blockWidth, blockHeight, blockDepth);
+		stagingAlignments[i] = std::max<VkDeviceSize>(texture.getBitsPerPixel() * blockWidth * blockHeight * blockDepth / 8, 1) * 4;
+		stagingOffsets[i] = stagingSize = alignUp(stagingSize, stagingAlignments[i]);
+		for (uint32_t mip = changes[i].newResidentMip; mip < std::min(changes[i].oldResidentMip, texture.getNumMipMapLevels()); ++mip)
+		{ stagingSize += alignUp(texture.getDataSize(static_cast<int32_t>(mip), true, true), stagingAlignments[i]); }
+	}
+
+	RetiredResources retired;
+	retired.updateIndex = _updateIndex;
+	if (stagingSize)
+	{
+		retired.stagingBuffer = createBuffer(_device, pvrvk::BufferCreateInfo(stagingSize, pvrvk::BufferUsageFlags::e_TRANSFER_SRC_BIT), pvrvk::MemoryPropertyFlags::e_HOST_VISIBLE_BIT,
+			pvrvk::MemoryPropertyFlags::e_HOST_VISIBLE_BIT | pvrvk::MemoryPropertyFlags::e_HOST_COHERENT_BIT, _bufferAllocator, vma::AllocationCreateFlags::e_MAPPED_BIT);
+		retired.stagingBuffer->setObjectName("PVRUtilsVk::TextureStreamer::Staging Buffer");
+		pvrvk::DeviceMemory& memory = retired.stagingBuffer->getDeviceMemory();
+		if (!memory->isMapped()) { memory->map(0, stagingSize); }
+		unsigned char* mapped = static_cast<unsigned char*>(memory->getMappedData());
+		for (size_t i = 0; i < changes.size(); ++i)
+		{
+			if (!changes[i].isLoad()) { continue; }
+			const Texture& texture = _textures[changes[i].textureId].texture;
+			VkDeviceSize offset = stagingOffsets[i];
+			for (uint32_t mip = changes[i].newResidentMip; mip < std::min(changes[i].oldResidentMip, texture.getNumMipMapLevels()); ++mip)
+			{
+				const uint32_t size = texture.getDataSize(static_cast<int32_t>(mip), true, true);
+				memcpy(mapped + offset, texture.getDataPointer(mip), size);
+				offset += alignUp(size, stagingAlignments[i]);
+			}
+		}
+		if (static_cast<uint32_t>(memory->getMemoryFlags() & pvrvk::MemoryPropertyFlags::e_HOST_COHERENT_BIT) == 0) { memory->flushRange(0, stagingSize); }
+	}
+
+	retired.commandBuffer = _commandPool->allocateCommandBuffer();
+	pvrvk::CommandBuffer& cmdBuffer = retired.commandBuffer;
+	cmdBuffer->begin(pvrvk::CommandBufferUsageFlags::e_ONE_TIME_SUBMIT_BIT);
+	pvr::utils::beginCommandBufferDebugLabel(cmdBuffer, pvrvk::DebugUtilsLabel("PVRUtilsVk::TextureStreamer"));
+
+	// The previous images are read by the frames already submitted, which the first barrier waits for.
+	std::vector<pvrvk::Image> newImages(changes.size());
+	pvrvk::MemoryBarrierSet barriers;
+	for (size_t i = 0; i < changes.size(); ++i)
+	{
+		const StreamedTexture& streamed = _textures[changes[i].textureId];
+		const pvrvk::ImageAspectFlags aspect = pvrvk::formatToImageAspect(streamed.format);
+		newImages[i] = createImage(_device, getImageCreateInfo(streamed.texture, streamed.format, changes[i].newResidentMip), pvrvk::MemoryPropertyFlags::e_DEVICE_LOCAL_BIT,
+			pvrvk::MemoryPropertyFlags::e_DEVICE_LOCAL_BIT, _imageAllocator);
+		newImages[i]->setObjectName("PVRUtilsVk::TextureStreamer::Image");
+		barriers.addBarrier(pvrvk::ImageMemoryBarrier(pvrvk::AccessFlags::e_NONE, pvrvk::AccessFlags::e_TRANSFER_WRITE_BIT, newImages[i],
+			pvrvk::ImageSubresourceRange(aspect, 0, newImages[i]->getNumMipLevels(), 0, newImages[i]->getNumArrayLayers()), pvrvk::ImageLayout::e_UNDEFINED,
+			pvrvk::ImageLayout::e_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(-1), static_cast<uint32_t>(-1)));
+		if (streamed.view)
+		{
+			const pvrvk::Image& oldImage = streamed.view->getImage();
+			barriers.addBarrier(pvrvk::ImageMemoryBarrier(pvrvk::AccessFlags::e_SHADER_READ_BIT, pvrvk::AccessFlags::e_TRANSFER_READ_BIT, oldImage,
+				pvrvk::ImageSubresourceRange(aspect, 0, oldImage->getNumMipLevels(), 0, oldImage->getNumArrayLayers()), pvrvk::ImageLayout::e_SHADER_READ_ONLY_OPTIMAL,
+				pvrvk::ImageLayout::e_TRANSFER_SRC_OPTIMAL, static_cast<uint32_t>(-1), static_cast<uint32_t>(-1)));
+		}
+	}
+	cmdBuffer->pipelineBarrier(pvrvk::PipelineStageFlags::e_ALL_COMMANDS_BIT, pvrvk::PipelineStageFlags::e_TRANSFER_BIT, barriers);
+
+	// Copy the levels kept from the previous images, then upload the new ones.
+	std::vector<pvrvk::ImageCopy> imageCopies;
+	std::vector<pvrvk::BufferImageCopy> bufferCopies;
+	for (size_t i = 0; i < changes.size(); ++i)
+	{
+		const StreamedTexture& streamed = _textures[changes[i].textureId];
+		const pvrvk::ImageAspectFlags aspect = pvrvk::formatToImageAspect(streamed.format);
+		const uint32_t numLevels = streamed.texture.getNumMipMapLevels();
+		const uint32_t numLayers = newImages[i]->getNumArrayLayers();
+		const uint32_t newMip = changes[i].newResidentMip, oldMip = changes[i].oldResidentMip;
+		if (streamed.view)
+		{
+			imageCopies.clear();
+			for (uint32_t mip = std::max(newMip, oldMip); mip < numLevels; ++mip)
+			{
+				imageCopies.push_back(pvrvk::ImageCopy(pvrvk::ImageSubresourceLayers(aspect, mip - oldMip, 0, numLayers), pvrvk::Offset3D(0, 0, 0),
+					pvrvk::ImageSubresourceLayers(aspect, mip - newMip, 0, numLayers), pvrvk::Offset3D(0, 0, 0), getLevelExtent(streamed.texture, mip)));
+			}
+			cmdBuffer->copyImage(streamed.view->getImage(), newImages[i], pvrvk::ImageLayout::e_TRANSFER_SRC_OPTIMAL, pvrvk::ImageLayout::e_TRANSFER_DST_OPTIMAL,
+				static_cast<uint32_t>(imageCopies.size()), imageCopies.data());
+		}
+		if (changes[i].isLoad())
+		{
+			bufferCopies.clear();
+			VkDeviceSize offset = stagingOffsets[i];
+			for (uint32_t mip = newMip; mip < std::min(oldMip, numLevels); ++mip)
+			{
+				bufferCopies.push_back(pvrvk::BufferImageCopy(
+					offset, 0, 0, pvrvk::ImageSubresourceLayers(aspect, mip - newMip, 0, numLayers), pvrvk::Offset3D(0, 0, 0), getLevelExtent(streamed.texture, mip)));
+				offset += alignUp(streamed.texture.getDataSize(static_cast<int32_t>(mip), true, true), stagingAlignments[i]);
+			}
+			cmdBuffer->copyBufferToImage(retired.stagingBuffer, newImages[i], pvrvk::ImageLayout::e_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(bufferCopies.size()), bufferCopies.data());
+		}
+	}
+
+	// Make the new images sampleable, and the previous ones again, as the frames in flight may still be recorded with them.
+	barriers.clearAllBarriers();
+	for (size_t i = 0; i < changes.size(); ++i)
+	{
+		StreamedTexture& streamed = _textures[changes[i].textureId];
+		const pvrvk::ImageAspectFlags aspect = pvrvk::formatToImageAspect(streamed.format);
+		barriers.addBarrier(pvrvk::ImageMemoryBarrier(pvrvk::AccessFlags::e_TRANSFER_WRITE_BIT, pvrvk::AccessFlags::e_SHADER_READ_BIT, newImages[i],
+			pvrvk::ImageSubresourceRange(aspect, 0, newImages[i]->getNumMipLevels(), 0, newImages[i]->getNumArrayLayers()), pvrvk::ImageLayout::e_TRANSFER_DST_OPTIMAL,
+			pvrvk::ImageLayout::e_SHADER_READ_ONLY_OPTIMAL, static_cast<uint32_t>(-1), static_cast<uint32_t>(-1)));
+		if (streamed.view)
+		{
+			const pvrvk::Image& oldImage = streamed.view->getImage();
+			barriers.addBarrier(pvrvk::ImageMemoryBarrier(pvrvk::AccessFlags::e_TRANSFER_READ_BIT, pvrvk::AccessFlags::e_SHADER_READ_BIT, oldImage,
+				pvrvk::ImageSubresourceRange(aspect, 0, oldImage->getNumMipLevels(), 0, oldImage->getNumArrayLayers()), pvrvk::ImageLayout::e_TRANSFER_SRC_OPTIMAL,
+				pvrvk::ImageLayout::e_SHADER_READ_ONLY_OPTIMAL, static_cast<uint32_t>(-1), static_cast<uint32_t>(-1)));
+			retired.views.push_back(std::move(streamed.view));
+		}
+		streamed.view = _device->createImageView(pvrvk::ImageViewCreateInfo(newImages[i]));
+		_changedTextures.push_back(changes[i].textureId);
+	}
+	cmdBuffer->pipelineBarrier(pvrvk::PipelineStageFlags::e_TRANSFER_BIT, pvrvk::PipelineStageFlags::e_ALL_COMMANDS_BIT, barriers);
+
+	pvr::utils::endCommandBufferDebugLabel(cmdBuffer);
+	cmdBuffer->end();
+
+	retired.fence = _device->createFence(pvrvk::FenceCreateFlags(0));
+	pvrvk::SubmitInfo submitInfo;
+	submitInfo.commandBuffers = &cmdBuffer;
+	submitInfo.numCommandBuffers = 1;
+	queue->submit(&submitInfo, 1, retired.fence);
+	_retired.push_back(std::move(retired));
+	return _changedTextures;
+}
+} // namespace utils
+} // namespace pvr
+//!\endcond
@@ -0,0 +1,123 @@
+/*!
+\brief Contains a class streaming the mip levels of textures to the GPU within a memory budget.
+\file PVRUtils/Vulkan/TextureStreamerVk.h
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+#pragma once
+#include "PVRCore/texture/TextureResidencyManager.h"
+#include "PVRUtils/Vulkan/HelperVk.h"
+#include <deque>
+
+namespace pvr {
+namespace utils {
+
+/// <summary>Streams the mip levels of textures to the GPU within a memory budget, as an alternative to uploadImage for large sets of textures which do not all
+/// need their full resolution at once. The textures stay in system memory, and only the levels chosen by a TextureResidencyManager are uploaded: the coarsest
+/// levels when a texture is added, then finer levels as they are requested, while the levels of textures of lower priority are evicted under pressure.
+///
+/// The image of a texture only holds its resident levels, so changing them recreates the image: the levels kept are copied from the previous image on the GPU,
+/// and the new levels are uploaded from a staging buffer. Sampling the image with normalized coordinates is unaffected, as its level 0 is the finest resident
+/// level of the texture. The previous image and view remain valid and sampleable for numFramesInFlight further updates, so that the descriptor sets of the
+/// frames in flight can be updated as they are reused.
+///
+/// Typical use, once per frame before recording the frame:
+/// <code>
+/// for (auto& object : visibleObjects) { streamer.request(object.texture, pvr::getMipLevelForScreenSize(w, h, object.screenSize, numLevels), object.screenSize); }
+/// for (uint32_t textureId : streamer.update(queue, maxUploadBytesPerFrame)) { updateDescriptors(textureId, streamer.getImageView(textureId)); }
+/// </code></summary>
+class TextureStreamer
+{
+public:
+	/// <summary>Constructor.</summary>
+	/// <param name="device">The device to create the images on</param>
+	/// <param name="commandPool">A command pool to allocate the upload command buffers from. It must be compatible with the queue passed to update.</param>
+	/// <param name="budget">The GPU memory available to the streamed textures, in bytes</param>
+	/// <param name="numFramesInFlight">The number of updates (frames) during which the images replaced by an update are kept alive, e.g. the swapchain length</param>
+	/// <param name="bufferAllocator">A VMA allocator used to allocate memory for the staging buffers</param>
+	/// <param name="imageAllocator">A VMA allocator used to allocate memory for the images</param>
+	TextureStreamer(pvrvk::Device& device, pvrvk::CommandPool& commandPool, uint64_t budget, uint32_t numFramesInFlight, vma::Allocator bufferAllocator = nullptr,
+		vma::Allocator imageAllocator = nullptr);
+
+	/// <summary>Destructor. Waits for the pending uploads.</summary>
+	~TextureStreamer();
+
+	/// <summary>Adds a texture. Its always resident levels are uploaded by the next update. The format of the texture must be supported for sampling by the
+	/// device (compressed textures are not decompressed), and must have a single plane, otherwise throws pvrvk::ErrorValidationFailedEXT. The image views use
+	/// the identity component mapping.</summary>
+	/// <param name="texture">The texture, which is kept in system memory</param>
+	/// <param name="numAlwaysResidentLevels">The number of coarsest levels which are loaded first and never evicted</param>
+	/// <returns>The identifier of the texture</returns>
+	uint32_t addTexture(Texture texture, uint32_t numAlwaysResidentLevels = 1);
+
+	/// <summary>Removes a texture. Its image is released after numFramesInFlight updates.</summary>
+	/// <param name="textureId">The texture to remove</param>
+	void removeTexture(uint32_t textureId);
+
+	/// <summary>Requests the levels of a texture down to a level, with a priority. See TextureResidencyManager::request.</summary>
+	/// <param name="textureId">The texture</param>
+	/// <param name="mipLevel">The finest level wanted</param>
+	/// <param name="priority">The priority of the request. Higher is served first.</param>
+	void request(uint32_t textureId, uint32_t mipLevel, float priority) { _residency.request(textureId, mipLevel, priority); }
+
+	/// <summary>Applies the loads and evictions scheduled for this frame: records and submits the copies, and releases the resources no longer in use. Call
+	/// it once per frame, on the queue the textures are sampled on, before submitting the frame.</summary>
+	/// <param name="queue">The queue to submit the copies to</param>
+	/// <param name="maxUploadBytes">The maximum number of bytes to upload, to spread the uploads over several frames</param>
+	/// <returns>The textures whose image view changed, and whose descriptor sets must be updated</returns>
+	const std::vector<uint32_t>& update(pvrvk::Queue& queue, uint64_t maxUploadBytes = std::numeric_limits<uint64_t>::max());
+
+	/// <summary>Get the image view of a texture.</summary>
+	/// <param name="textureId">The texture</param>
+	/// <returns>The view of the resident levels of the texture. Null until the first update after adding the texture.</returns>
+	const pvrvk::ImageView& getImageView(uint32_t textureId) const { return _textures[textureId].view; }
+
+	/// <summary>Get the texture data in system memory.</summary>
+	/// <param name="textureId">The texture</param>
+	/// <returns>The texture</returns>
+	const Texture& getTexture(uint32_t textureId) const { return _textures[textureId].texture; }
+
+	/// <summary>Get the scheduler, to query the residency of the textures or change the budget.</summary>
+	/// <returns>The residency manager</returns>
+	TextureResidencyManager& getResidencyManager() { return _residency; }
+
+	/// <summary>Get the scheduler, to query the residency of the textures.</summary>
+	/// <returns>The residency manager</returns>
+	const TextureResidencyManager& getResidencyManager() const { return _residency; }
+
+private:
+	struct StreamedTexture
+	{
+		Texture texture;
+		pvrvk::Format format;
+		pvrvk::ImageView view;
+	};
+
+	// The resources of an update, released once its copies are complete and the frames which may have used the replaced images are too.
+	struct RetiredResources
+	{
+		uint64_t updateIndex;
+		pvrvk::Fence fence;
+		pvrvk::CommandBuffer commandBuffer;
+		pvrvk::Buffer stagingBuffer;
+		std::vector<pvrvk::ImageView> views;
+	};
+
+	void releaseRetiredResources(bool waitForAll);
+
+	pvrvk::Device _device;
+	pvrvk::CommandPool _commandPool;
+	vma::Allocator _bufferAllocator;
+	vma::Allocator _imageAllocator;
+	uint32_t _numFramesInFlight;
+	uint64_t _updateIndex;
+	TextureResidencyManager _residency;
+	std::vector<StreamedTexture> _textures;
+	std::deque<RetiredResources> _retired;
+	std::vector<uint32_t> _changedTextures;
+
+	TextureStreamer(const TextureStreamer&) = delete;
+	TextureStreamer& operator=(const TextureStreamer&) = delete;
+};
+} // namespace utils
+} // namespace pvr